@@ -100,6 +100,7 @@ UIntMap *ExportMap::GetUIntMapVar(const string &name, const string &label) {
  */
 vector<BaseVariable*> ExportMap::AllVariables() const {
   vector<BaseVariable*> variables;
+  ola::thread::MutexLocker locker(&m_mutex);
   STLValues(m_bool_variables, &variables);
   STLValues(m_counter_variables, &variables);
   STLValues(m_int_map_variables, &variables);
@@ -115,6 +116,7 @@ vector<BaseVariable*> ExportMap::AllVariables() const {
 
 template<typename Type>
 Type *ExportMap::GetVar(map<string, Type*> *var_map, const string &name) {
+  ola::thread::MutexLocker locker(&m_mutex);
   typename map<string, Type*>::iterator iter;
   iter = var_map->find(name);
 
@@ -131,6 +133,7 @@ template<typename Type>
 Type *ExportMap::GetMapVar(map<string, Type*> *var_map,
                            const string &name,
                            const string &label) {
+  ola::thread::MutexLocker locker(&m_mutex);
   typename map<string, Type*>::iterator iter;
   iter = var_map->find(name);
 
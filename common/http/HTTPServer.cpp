@@ -23,7 +23,12 @@
 #endif  // HAVE_CONFIG_H
 
 #include <stdio.h>
+#include <string.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif  // HAVE_ZLIB
 #include <ola/Logging.h>
+#include <ola/StringUtils.h>
 #include <ola/base/Macro.h>
 #include <ola/file/Util.h>
 #include <ola/http/HTTPServer.h>
@@ -35,6 +40,7 @@
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -81,6 +87,9 @@ const char HTTPServer::CONTENT_TYPE_JS[] = "text/javascript";
 const char HTTPServer::CONTENT_TYPE_OCT[] = "application/octet-stream";
 const char HTTPServer::CONTENT_TYPE_JSON[] = "application/json";
 const char HTTPServer::CONTENT_TYPE_XML[] = "application/xml";
+const char HTTPServer::CONTENT_TYPE_EVENT_STREAM[] = "text/event-stream";
+const char HTTPServer::ENCODING_BROTLI[] = "br";
+const char HTTPServer::ENCODING_GZIP[] = "gzip";
 
 /**
  * @brief Called by MHD_get_connection_values to add headers to a request
@@ -201,6 +210,30 @@ void RequestCompleted(void*,
 }
 
 
+/**
+ * @brief Called by MHD when it's ready to send more of an event stream.
+ *
+ * Returning 0 means there is no data yet. MHD stops watching the socket and
+ * calls this again on the next MHD_run(), which happens on every iteration of
+ * the select loop.
+ */
+static ssize_t ReadEventStream(void *cls,
+                               OLA_UNUSED uint64_t pos,
+                               char *buffer,
+                               size_t max_size) {
+  HTTPEventStream *stream = static_cast<HTTPEventStream*>(cls);
+  return static_cast<ssize_t>(stream->Read(buffer, max_size));
+}
+
+
+/**
+ * @brief Called by MHD once an event stream response is no longer required.
+ */
+static void FreeEventStream(void *cls) {
+  delete static_cast<HTTPEventStream*>(cls);
+}
+
+
 /*
  * @brief HTTPRequest object
  *
@@ -356,6 +389,86 @@ const string HTTPRequest::GetPostParameter(const string &key) const {
 }
 
 
+HTTPEventStream::HTTPEventStream(unsigned int max_buffer_size)
+    : m_offset(0),
+      m_max_buffer_size(max_buffer_size),
+      m_close_callback(NULL) {
+}
+
+
+HTTPEventStream::~HTTPEventStream() {
+  if (m_close_callback) {
+    m_close_callback->Run();
+  }
+}
+
+
+void HTTPEventStream::SetCloseHandler(CloseCallback *callback) {
+  if (m_close_callback) {
+    delete m_close_callback;
+  }
+  m_close_callback = callback;
+}
+
+
+/**
+ * @brief Format an event, multi-line data is split into multiple data fields.
+ */
+bool HTTPEventStream::SendEvent(const string &event, const string &data) {
+  string output;
+  output.reserve(event.size() + data.size() + 16);
+  if (!event.empty()) {
+    output.append("event: ");
+    output.append(event);
+    output.push_back('\n');
+  }
+
+  size_t start = 0;
+  size_t end;
+  while ((end = data.find('\n', start)) != string::npos) {
+    output.append("data: ");
+    output.append(data, start, end - start);
+    output.push_back('\n');
+    start = end + 1;
+  }
+  output.append("data: ");
+  output.append(data, start, string::npos);
+  output.append("\n\n");
+  return Append(output);
+}
+
+
+bool HTTPEventStream::SendComment(const string &comment) {
+  return Append(": " + comment + "\n\n");
+}
+
+
+size_t HTTPEventStream::Read(char *output, size_t max_size) {
+  size_t size = std::min(max_size, m_buffer.size() - m_offset);
+  memcpy(output, m_buffer.data() + m_offset, size);
+  m_offset += size;
+  if (m_offset == m_buffer.size()) {
+    m_buffer.clear();
+    m_offset = 0;
+  }
+  return size;
+}
+
+
+bool HTTPEventStream::Append(const string &data) {
+  if (BufferedBytes() + data.size() > m_max_buffer_size) {
+    return false;
+  }
+  if (m_offset && m_offset >= m_buffer.size() / 2) {
+    // reclaim the space used by data that's already been sent
+    m_buffer.erase(0, m_offset);
+    m_offset = 0;
+  }
+  m_buffer.append(data);
+  return true;
+}
+
+
 /**
  * @brief Set the content-type header
  * @param type the content type
@@ -407,6 +520,38 @@ int HTTPResponse::SendJson(const JsonValue &json) {
 }
 
 
+/**
+ * @brief Start a Server-Sent Events stream.
+ * @param stream the HTTPEventStream to send. Ownership is transferred, and
+ *   the stream will be deleted when the client disconnects or on error.
+ * @return true on success, false on error
+ */
+int HTTPResponse::SendEventStream(HTTPEventStream *stream) {
+  struct MHD_Response *response = MHD_create_response_from_callback(
+      MHD_SIZE_UNKNOWN,
+      K_EVENT_STREAM_BLOCK_SIZE,
+      &ReadEventStream,
+      stream,
+      &FreeEventStream);
+  if (!response) {
+    delete stream;
+    return MHD_NO;
+  }
+
+  SetContentType(HTTPServer::CONTENT_TYPE_EVENT_STREAM);
+  SetNoCache();
+  HeadersMultiMap::const_iterator iter;
+  for (iter = m_headers.begin(); iter != m_headers.end(); ++iter) {
+    MHD_add_response_header(response,
+                            iter->first.c_str(),
+                            iter->second.c_str());
+  }
+  int ret = MHD_queue_response(m_connection, m_status_code, response);
+  MHD_destroy_response(response);
+  return ret;
+}
+
+
 /**
  * @brief Send the HTTP response
  * @return true on success, false on error
@@ -436,7 +581,8 @@ HTTPServer::HTTPServer(const HTTPServerOptions &options)
       m_httpd(NULL),
       m_default_handler(NULL),
       m_port(options.port),
-      m_data_dir(options.data_dir) {
+      m_data_dir(options.data_dir),
+      m_preload_static_content(options.preload_static_content) {
   ola::io::SelectServer::Options ss_options;
   // See issue #761. epoll/kqueue can't be used with the current
   // implementation.
@@ -455,6 +601,12 @@ HTTPServer::~HTTPServer() {
     MHD_stop_daemon(m_httpd);
   }
 
+  map<string, static_file_info>::iterator file_iter;
+  for (file_iter = m_static_content.begin();
+       file_iter != m_static_content.end(); ++file_iter) {
+    FreePreloadedFile(&file_iter->second);
+  }
+
   map<string, BaseHTTPCallback*>::const_iterator iter;
   for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
     delete iter->second;
@@ -479,6 +631,19 @@ bool HTTPServer::Init() {
     return false;
   }
 
+  if (m_preload_static_content) {
+    map<string, static_file_info>::iterator iter;
+    unsigned int file_count = 0;
+    for (iter = m_static_content.begin(); iter != m_static_content.end();
+         ++iter) {
+      if (PreloadFile(&iter->second)) {
+        file_count++;
+      }
+    }
+    OLA_INFO << "Preloaded " << file_count << " of "
+             << m_static_content.size() << " static files";
+  }
+
   m_httpd = MHD_start_daemon(MHD_NO_FLAG,
                              m_port,
                              NULL,
@@ -639,6 +804,9 @@ int HTTPServer::DispatchRequest(const HTTPRequest *request,
       m_static_content.find(request->Url());
 
   if (file_iter != m_static_content.end()) {
+    if (file_iter->second.identity_response) {
+      return ServePreloadedContent(request, file_iter->second, response);
+    }
     return ServeStaticContent(&(file_iter->second), response);
   }
 
@@ -705,7 +873,12 @@ bool HTTPServer::RegisterFile(const std::string &path,
   file_info.content_type = content_type;
 
   pair<string, static_file_info> pair(path, file_info);
-  m_static_content.insert(pair);
+  map<string, static_file_info>::iterator new_iter =
+      m_static_content.insert(pair).first;
+  // Files registered after Init() are loaded straight away.
+  if (m_preload_static_content && m_httpd) {
+    PreloadFile(&new_iter->second);
+  }
   return true;
 }
 
@@ -803,29 +976,14 @@ int HTTPServer::ServeStaticContent(const std::string &path,
  */
 int HTTPServer::ServeStaticContent(static_file_info *file_info,
                                    HTTPResponse *response) {
-  char *data;
-  unsigned int length;
-  string file_path = m_data_dir;
-  file_path.push_back(ola::file::PATH_SEPARATOR);
-  file_path.append(file_info->file_path);
-  ifstream i_stream(file_path.c_str(), ifstream::binary);
-
-  if (!i_stream.is_open()) {
-    OLA_WARN << "Missing file: " << file_path;
+  string data;
+  if (!ReadFile(file_info->file_path, &data)) {
+    OLA_WARN << "Missing file: " << file_info->file_path;
     return ServeNotFound(response);
   }
 
-  i_stream.seekg(0, std::ios::end);
-  length = i_stream.tellg();
-  i_stream.seekg(0, std::ios::beg);
-
-  data = static_cast<char*>(malloc(length));
-
-  i_stream.read(data, length);
-  i_stream.close();
-
-  struct MHD_Response *mhd_response = BuildResponse(static_cast<void*>(data),
-                                                    length);
+  struct MHD_Response *mhd_response = BuildResponse(
+      static_cast<void*>(const_cast<char*>(data.data())), data.size());
 
   if (!file_info->content_type.empty()) {
     MHD_add_response_header(mhd_response,
@@ -841,6 +999,325 @@ int HTTPServer::ServeStaticContent(static_file_info *file_info,
   return ret;
 }
 
+
+/**
+ * @brief Serve a file from memory.
+ *
+ * The smallest encoding the client accepts is used, and if the client already
+ * has the current version we send a 304.
+ * @param request the request, used for the Accept-Encoding and If-None-Match
+ *   headers.
+ * @param file_info the preloaded file.
+ * @param response the response to use
+ */
+int HTTPServer::ServePreloadedContent(const HTTPRequest *request,
+                                      const static_file_info &file_info,
+                                      HTTPResponse *response) {
+  string etag;
+  struct MHD_Response *mhd_response = SelectPreloadedResponse(
+      file_info, request->GetHeader(MHD_HTTP_HEADER_ACCEPT_ENCODING), &etag);
+
+  if (MatchesETag(request->GetHeader(MHD_HTTP_HEADER_IF_NONE_MATCH), etag)) {
+    struct MHD_Response *not_modified = BuildResponse(NULL, 0);
+    MHD_add_response_header(not_modified, MHD_HTTP_HEADER_ETAG, etag.c_str());
+    MHD_add_response_header(not_modified, MHD_HTTP_HEADER_CACHE_CONTROL,
+                            "no-cache");
+    int ret = MHD_queue_response(response->Connection(),
+                                 MHD_HTTP_NOT_MODIFIED,
+                                 not_modified);
+    MHD_destroy_response(not_modified);
+    delete response;
+    return ret;
+  }
+
+  // The MHD_Response is reference counted, so it can be queued on many
+  // connections at once.
+  int ret = MHD_queue_response(response->Connection(),
+                               MHD_HTTP_OK,
+                               mhd_response);
+  delete response;
+  return ret;
+}
+
+
+/**
+ * @brief Pick the smallest version of a preloaded file the client accepts.
+ * @param file_info the preloaded file.
+ * @param accept_encoding the value of the Accept-Encoding header.
+ * @param etag set to the entity tag of the chosen version.
+ * @returns the response for the chosen version.
+ */
+struct MHD_Response *HTTPServer::SelectPreloadedResponse(
+    const static_file_info &file_info,
+    const string &accept_encoding,
+    string *etag) {
+  if (!accept_encoding.empty()) {
+    if (file_info.brotli_response &&
+        AcceptsEncoding(accept_encoding, ENCODING_BROTLI)) {
+      *etag = file_info.brotli_etag;
+      return file_info.brotli_response;
+    } else if (file_info.gzip_response &&
+               AcceptsEncoding(accept_encoding, ENCODING_GZIP)) {
+      *etag = file_info.gzip_etag;
+      return file_info.gzip_response;
+    }
+  }
+  *etag = file_info.etag;
+  return file_info.identity_response;
+}
+
+
+/**
+ * @brief Load a file, and any precompressed versions of it, into memory.
+ *
+ * Precompressed versions are files with the same name and a .br or .gz
+ * suffix, e.g. ola.js.gz. If there isn't a .gz file, the file is compressed
+ * with zlib, if we have it.
+ * @param file_info the file to load.
+ * @returns true if the file was loaded, false otherwise.
+ */
+bool HTTPServer::PreloadFile(static_file_info *file_info) {
+  FreePreloadedFile(file_info);
+
+  if (!ReadFile(file_info->file_path, &file_info->data)) {
+    OLA_WARN << "Missing file: " << file_info->file_path;
+    return false;
+  }
+  file_info->etag = ContentETag(file_info->data);
+  file_info->identity_response = BuildPersistentResponse(
+      *file_info, file_info->data, file_info->etag, "");
+
+  // The precompressed files are optional.
+  if (ReadFile(file_info->file_path + ".br", &file_info->brotli_data)) {
+    file_info->brotli_etag = ContentETag(file_info->brotli_data);
+    file_info->brotli_response = BuildPersistentResponse(
+        *file_info, file_info->brotli_data, file_info->brotli_etag,
+        ENCODING_BROTLI);
+  }
+  if (ReadFile(file_info->file_path + ".gz", &file_info->gzip_data) ||
+      GzipCompress(file_info->data, &file_info->gzip_data)) {
+    file_info->gzip_etag = ContentETag(file_info->gzip_data);
+    file_info->gzip_response = BuildPersistentResponse(
+        *file_info, file_info->gzip_data, file_info->gzip_etag,
+        ENCODING_GZIP);
+  }
+  return true;
+}
+
+
+/**
+ * @brief Release the memory used by a preloaded file.
+ */
+void HTTPServer::FreePreloadedFile(static_file_info *file_info) {
+  if (file_info->identity_response) {
+    MHD_destroy_response(file_info->identity_response);
+    file_info->identity_response = NULL;
+  }
+  if (file_info->gzip_response) {
+    MHD_destroy_response(file_info->gzip_response);
+    file_info->gzip_response = NULL;
+  }
+  if (file_info->brotli_response) {
+    MHD_destroy_response(file_info->brotli_response);
+    file_info->brotli_response = NULL;
+  }
+  file_info->data.clear();
+  file_info->gzip_data.clear();
+  file_info->brotli_data.clear();
+  file_info->etag.clear();
+  file_info->gzip_etag.clear();
+  file_info->brotli_etag.clear();
+}
+
+
+/**
+ * @brief Read a file from the data dir.
+ * @param file the path relative to the data dir.
+ * @param data the string to store the contents in.
+ * @returns true if the file was read, false otherwise.
+ */
+bool HTTPServer::ReadFile(const string &file, string *data) const {
+  string file_path = m_data_dir;
+  file_path.push_back(ola::file::PATH_SEPARATOR);
+  file_path.append(file);
+  ifstream i_stream(file_path.c_str(), ifstream::binary);
+
+  if (!i_stream.is_open()) {
+    return false;
+  }
+
+  i_stream.seekg(0, std::ios::end);
+  const std::streamoff length = i_stream.tellg();
+  i_stream.seekg(0, std::ios::beg);
+
+  data->resize(length);
+  if (length) {
+    i_stream.read(&(*data)[0], length);
+  }
+  i_stream.close();
+  return true;
+}
+
+
+/**
+ * @brief Build a response that refers to data rather than copying it.
+ * @param file_info the file the response is for.
+ * @param data the body of the response, this must outlive the response.
+ * @param etag the entity tag for the body.
+ * @param encoding the content encoding, or the empty string if the data isn't
+ *   compressed.
+ */
+struct MHD_Response *HTTPServer::BuildPersistentResponse(
+    const static_file_info &file_info,
+    const string &data,
+    const string &etag,
+    const string &encoding) {
+  void *buffer = static_cast<void*>(const_cast<char*>(data.data()));
+#ifdef HAVE_MHD_CREATE_RESPONSE_FROM_BUFFER
+  struct MHD_Response *response = MHD_create_response_from_buffer(
+      data.size(), buffer, MHD_RESPMEM_PERSISTENT);
+#else
+  struct MHD_Response *response = MHD_create_response_from_data(
+      data.size(), buffer, MHD_NO, MHD_NO);
+#endif  // HAVE_MHD_CREATE_RESPONSE_FROM_BUFFER
+
+  if (!file_info.content_type.empty()) {
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE,
+                            file_info.content_type.c_str());
+  }
+  if (!encoding.empty()) {
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING,
+                            encoding.c_str());
+  }
+  MHD_add_response_header(response, MHD_HTTP_HEADER_ETAG, etag.c_str());
+  // Clients can cache the file but must check with us before using it.
+  MHD_add_response_header(response, MHD_HTTP_HEADER_CACHE_CONTROL,
+                          "no-cache");
+  MHD_add_response_header(response, MHD_HTTP_HEADER_VARY,
+                          MHD_HTTP_HEADER_ACCEPT_ENCODING);
+  return response;
+}
+
+
+/**
+ * @brief Check if an Accept-Encoding header allows an encoding.
+ * @param accept_encoding the value of the Accept-Encoding header, e.g.
+ *   "gzip, deflate, br;q=0.5".
+ * @param encoding the encoding to check for.
+ * @returns true if the encoding is listed and doesn't have a q value of 0.
+ */
+bool HTTPServer::AcceptsEncoding(const string &accept_encoding,
+                                 const string &encoding) {
+  vector<string> codings;
+  StringSplit(accept_encoding, &codings, ",");
+  vector<string>::iterator iter = codings.begin();
+  for (; iter != codings.end(); ++iter) {
+    vector<string> params;
+    StringSplit(*iter, &params, ";");
+    if (params.empty()) {
+      continue;
+    }
+    string coding = params[0];
+    StringTrim(&coding);
+    ToLower(&coding);
+    if (coding != encoding && coding != "*") {
+      continue;
+    }
+
+    // check for q=0
+    bool acceptable = true;
+    for (unsigned int i = 1; i < params.size(); i++) {
+      string param = params[i];
+      StringTrim(&param);
+      if (param.size() > 2 && param[0] == 'q' && param[1] == '=') {
+        acceptable = param.find_first_not_of("0.", 2) != string::npos;
+      }
+    }
+    return acceptable;
+  }
+  return false;
+}
+
+
+/**
+ * @brief Check if an If-None-Match header matches an entity tag.
+ * @param if_none_match the value of the If-None-Match header, e.g.
+ *   "\"abc\", \"def\"".
+ * @param etag the entity tag of the content we'd send.
+ * @returns true if the client already has the content.
+ */
+bool HTTPServer::MatchesETag(const string &if_none_match,
+                             const string &etag) {
+  if (if_none_match.empty() || etag.empty()) {
+    return false;
+  }
+  return if_none_match == "*" || if_none_match.find(etag) != string::npos;
+}
+
+
+/**
+ * @brief Compress data with gzip.
+ * @param data the data to compress.
+ * @param output the string to store the compressed data in.
+ * @returns true if the compressed data is smaller than the original, false
+ *   if it isn't or zlib isn't available.
+ */
+bool HTTPServer::GzipCompress(const string &data, string *output) {
+  output->clear();
+#ifdef HAVE_ZLIB
+  if (data.empty()) {
+    return false;
+  }
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // 16 + MAX_WBITS writes a gzip header and trailer rather than a zlib one.
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS,
+                   8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    OLA_WARN << "deflateInit2 failed: " << (stream.msg ? stream.msg : "");
+    return false;
+  }
+
+  output->resize(deflateBound(&stream, data.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*output)[0]);
+  stream.avail_out = output->size();
+  int ret = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+
+  if (ret != Z_STREAM_END || stream.total_out >= data.size()) {
+    output->clear();
+    return false;
+  }
+  output->resize(stream.total_out);
+  return true;
+#else
+  return false;
+#endif  // HAVE_ZLIB
+}
+
+
+/**
+ * @brief Generate a strong entity tag for some content.
+ *
+ * This uses the 64 bit FNV-1a hash of the content.
+ */
+string HTTPServer::ContentETag(const string &data) {
+  uint64_t hash = 14695981039346656037ULL;
+  string::const_iterator iter = data.begin();
+  for (; iter != data.end(); ++iter) {
+    hash ^= static_cast<uint8_t>(*iter);
+    hash *= 1099511628211ULL;
+  }
+
+  char etag[20];
+  snprintf(etag, sizeof(etag), "\"%08x%08x\"",
+           static_cast<unsigned int>(hash >> 32),
+           static_cast<unsigned int>(hash & 0xffffffff));
+  return etag;
+}
+
 void HTTPServer::InsertSocket(bool is_readable, bool is_writeable, int fd) {
 #ifdef _WIN32
   UnmanagedSocketDescriptor *socket = new UnmanagedSocketDescriptor(fd);
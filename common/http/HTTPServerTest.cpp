@@ -0,0 +1,375 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTTPServerTest.cpp
+ * Test fixture for the HTTPServer classes.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::NewSingleCallback;
+using ola::http::HTTPEventStream;
+using ola::http::HTTPServer;
+using std::string;
+
+class HTTPServerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HTTPServerTest);
+  CPPUNIT_TEST(testSendEvent);
+  CPPUNIT_TEST(testBufferLimit);
+  CPPUNIT_TEST(testReadOffset);
+  CPPUNIT_TEST(testCloseHandler);
+  CPPUNIT_TEST(testAcceptsEncoding);
+  CPPUNIT_TEST(testContentETag);
+  CPPUNIT_TEST(testMatchesETag);
+  CPPUNIT_TEST(testPreload);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() { m_closed = 0; }
+
+  void testSendEvent();
+  void testBufferLimit();
+  void testReadOffset();
+  void testCloseHandler();
+  void testAcceptsEncoding();
+  void testContentETag();
+  void testMatchesETag();
+  void testPreload();
+
+ private:
+  unsigned int m_closed;
+
+  void Closed() { m_closed++; }
+
+  string Read(HTTPEventStream *stream, size_t max_size);
+  string ReadAll(HTTPEventStream *stream);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTTPServerTest);
+
+
+/*
+ * Read up to max_size bytes from a stream.
+ */
+string HTTPServerTest::Read(HTTPEventStream *stream, size_t max_size) {
+  char buffer[100];
+  OLA_ASSERT_TRUE(max_size <= sizeof(buffer));
+  size_t size = stream->Read(buffer, max_size);
+  OLA_ASSERT_TRUE(size <= max_size);
+  return string(buffer, size);
+}
+
+
+/*
+ * Read everything from a stream, in small blocks like MHD does.
+ */
+string HTTPServerTest::ReadAll(HTTPEventStream *stream) {
+  string output;
+  string block;
+  while (!(block = Read(stream, 7)).empty()) {
+    output.append(block);
+  }
+  OLA_ASSERT_EQ(0u, stream->BufferedBytes());
+  return output;
+}
+
+
+/*
+ * Check events and comments are formatted correctly.
+ */
+void HTTPServerTest::testSendEvent() {
+  HTTPEventStream stream;
+  OLA_ASSERT_EQ(0u, stream.BufferedBytes());
+  OLA_ASSERT_EQ(string(""), Read(&stream, 10));
+
+  OLA_ASSERT_TRUE(stream.SendEvent("dmx", "{\"universe\": 1}"));
+  OLA_ASSERT_EQ(string("event: dmx\ndata: {\"universe\": 1}\n\n"),
+                ReadAll(&stream));
+
+  // no event type
+  OLA_ASSERT_TRUE(stream.SendEvent("", "foo"));
+  OLA_ASSERT_EQ(string("data: foo\n\n"), ReadAll(&stream));
+
+  // each line is sent as a data field, so a newline can't end the event
+  OLA_ASSERT_TRUE(stream.SendEvent("stats", "foo\nbar\n\nbaz"));
+  OLA_ASSERT_EQ(
+      string("event: stats\ndata: foo\ndata: bar\ndata: \ndata: baz\n\n"),
+      ReadAll(&stream));
+
+  OLA_ASSERT_TRUE(stream.SendEvent("", "foo\n"));
+  OLA_ASSERT_EQ(string("data: foo\ndata: \n\n"), ReadAll(&stream));
+
+  OLA_ASSERT_TRUE(stream.SendEvent("", ""));
+  OLA_ASSERT_EQ(string("data: \n\n"), ReadAll(&stream));
+
+  OLA_ASSERT_TRUE(stream.SendComment("keepalive"));
+  OLA_ASSERT_EQ(string(": keepalive\n\n"), ReadAll(&stream));
+
+  // events are sent in order
+  OLA_ASSERT_TRUE(stream.SendEvent("a", "1"));
+  OLA_ASSERT_TRUE(stream.SendComment("x"));
+  OLA_ASSERT_TRUE(stream.SendEvent("b", "2"));
+  OLA_ASSERT_EQ(string("event: a\ndata: 1\n\n: x\n\nevent: b\ndata: 2\n\n"),
+                ReadAll(&stream));
+}
+
+
+/*
+ * Check events are dropped, rather than truncated, once the buffer is full.
+ */
+void HTTPServerTest::testBufferLimit() {
+  const string event = "data: 0123456789\n\n";
+  HTTPEventStream stream(2 * event.size() + 5);
+
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(2 * event.size()),
+                stream.BufferedBytes());
+  OLA_ASSERT_FALSE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_FALSE(stream.SendComment("keepalive"));
+  OLA_ASSERT_TRUE(stream.SendComment("a"));
+  OLA_ASSERT_EQ(stream.BufferedBytes(),
+                static_cast<unsigned int>(2 * event.size() + 5));
+  OLA_ASSERT_FALSE(stream.SendEvent("", ""));
+
+  // once the client reads some of the data, there's room again
+  OLA_ASSERT_EQ(event, Read(&stream, event.size()));
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_FALSE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_EQ(event + ": a\n\n" + event, ReadAll(&stream));
+
+  // an event larger than the buffer is never sent
+  OLA_ASSERT_FALSE(stream.SendEvent("", string(2 * event.size(), 'x')));
+  OLA_ASSERT_EQ(0u, stream.BufferedBytes());
+}
+
+
+/*
+ * Check that partial reads work and that the space used by data that's been
+ * read is reclaimed.
+ */
+void HTTPServerTest::testReadOffset() {
+  const string event = "data: 0123456789\n\n";
+  HTTPEventStream stream;
+
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_EQ(event.substr(0, 4), Read(&stream, 4));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(event.size() - 4),
+                stream.BufferedBytes());
+  OLA_ASSERT_EQ(static_cast<size_t>(4), stream.m_offset);
+
+  // less than half the buffer has been read, so it's appended as is
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), stream.m_offset);
+  OLA_ASSERT_EQ(2 * event.size(), stream.m_buffer.size());
+
+  // once at least half has been read, the next event reclaims the space
+  OLA_ASSERT_EQ(event.substr(4) + event.substr(0, 2),
+                Read(&stream, event.size() - 2));
+  OLA_ASSERT_EQ(event.size() + 2, stream.m_offset);
+  OLA_ASSERT_TRUE(stream.SendEvent("", "0123456789"));
+  OLA_ASSERT_EQ(static_cast<size_t>(0), stream.m_offset);
+  OLA_ASSERT_EQ(2 * event.size() - 2, stream.m_buffer.size());
+  OLA_ASSERT_EQ(static_cast<unsigned int>(2 * event.size() - 2),
+                stream.BufferedBytes());
+  OLA_ASSERT_EQ(event.substr(2) + event, ReadAll(&stream));
+
+  // reading everything empties the buffer
+  OLA_ASSERT_EQ(static_cast<size_t>(0), stream.m_offset);
+  OLA_ASSERT_TRUE(stream.m_buffer.empty());
+  OLA_ASSERT_EQ(string(""), Read(&stream, 10));
+}
+
+
+/*
+ * Check the close handler runs when the stream is deleted.
+ */
+void HTTPServerTest::testCloseHandler() {
+  HTTPEventStream *stream = new HTTPEventStream();
+  stream->SetCloseHandler(NewSingleCallback(this, &HTTPServerTest::Closed));
+  delete stream;
+  OLA_ASSERT_EQ(1u, m_closed);
+
+  // replacing the handler deletes the old one without running it
+  stream = new HTTPEventStream();
+  stream->SetCloseHandler(NewSingleCallback(this, &HTTPServerTest::Closed));
+  stream->SetCloseHandler(NewSingleCallback(this, &HTTPServerTest::Closed));
+  delete stream;
+  OLA_ASSERT_EQ(2u, m_closed);
+
+  stream = new HTTPEventStream();
+  stream->SetCloseHandler(NewSingleCallback(this, &HTTPServerTest::Closed));
+  stream->SetCloseHandler(NULL);
+  delete stream;
+  OLA_ASSERT_EQ(2u, m_closed);
+}
+
+
+/*
+ * Check we parse the Accept-Encoding header correctly.
+ */
+void HTTPServerTest::testAcceptsEncoding() {
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("", "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("gzip", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("gzip", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("gzip, deflate, br", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("deflate,gzip", "gzip"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding(" GZip ", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("x-gzip", "gzip"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("identity", "gzip"));
+
+  // q values, only 0 means not acceptable
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br;q=0.5, gzip", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br; q=1", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br;q=0.001", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("br;q=0, gzip", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("br; q=0.000", "br"));
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("br;q=0, gzip", "gzip"));
+
+  // wildcards
+  OLA_ASSERT_TRUE(HTTPServer::AcceptsEncoding("*", "br"));
+  OLA_ASSERT_FALSE(HTTPServer::AcceptsEncoding("*;q=0", "gzip"));
+}
+
+
+/*
+ * Check the entity tags are the quoted FNV-1a hash of the content.
+ */
+void HTTPServerTest::testContentETag() {
+  OLA_ASSERT_EQ(string("\"cbf29ce484222325\""), HTTPServer::ContentETag(""));
+  OLA_ASSERT_EQ(string("\"af63dc4c8601ec8c\""),
+                HTTPServer::ContentETag("a"));
+  OLA_ASSERT_EQ(string("\"85944171f73967e8\""),
+                HTTPServer::ContentETag("foobar"));
+  OLA_ASSERT_EQ(HTTPServer::ContentETag("foobar"),
+                HTTPServer::ContentETag(string("foobar")));
+  OLA_ASSERT_NE(HTTPServer::ContentETag("foobar"),
+                HTTPServer::ContentETag("foobaz"));
+  OLA_ASSERT_NE(HTTPServer::ContentETag(string("\0", 1)),
+                HTTPServer::ContentETag(""));
+}
+
+
+/*
+ * Check when a request with If-None-Match gets a 304.
+ */
+void HTTPServerTest::testMatchesETag() {
+  const string etag = HTTPServer::ContentETag("foo");
+  OLA_ASSERT_FALSE(HTTPServer::MatchesETag("", etag));
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag(etag, etag));
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag("*", etag));
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag("\"abc\", " + etag, etag));
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag("W/" + etag, etag));
+  OLA_ASSERT_FALSE(HTTPServer::MatchesETag("\"abc\"", etag));
+  OLA_ASSERT_FALSE(HTTPServer::MatchesETag(HTTPServer::ContentETag("bar"),
+                                           etag));
+  OLA_ASSERT_FALSE(HTTPServer::MatchesETag("*", ""));
+}
+
+
+/*
+ * Check files are loaded, and compressed, and the right version is picked
+ * for each client.
+ */
+void HTTPServerTest::testPreload() {
+  HTTPServer::HTTPServerOptions options;
+  options.data_dir = TEST_SRC_DIR "/common/http/testdata";
+  options.preload_static_content = true;
+  HTTPServer server(options);
+  OLA_ASSERT_TRUE(server.RegisterFile("/index.html", "text/html"));
+  OLA_ASSERT_TRUE(server.RegisterFile("/style.css", "text/css"));
+  OLA_ASSERT_TRUE(server.RegisterFile("/tiny.txt", "text/plain"));
+  OLA_ASSERT_TRUE(server.RegisterFile("/missing.txt", "text/plain"));
+
+  HTTPServer::static_file_info &missing =
+      server.m_static_content["/missing.txt"];
+  OLA_ASSERT_FALSE(server.PreloadFile(&missing));
+  OLA_ASSERT_EQ(static_cast<struct MHD_Response*>(NULL),
+                missing.identity_response);
+
+  // html compresses well, so it's gzipped as it's loaded
+  HTTPServer::static_file_info &index = server.m_static_content["/index.html"];
+  OLA_ASSERT_TRUE(server.PreloadFile(&index));
+  OLA_ASSERT_FALSE(index.data.empty());
+  OLA_ASSERT_TRUE(index.identity_response);
+  OLA_ASSERT_EQ(HTTPServer::ContentETag(index.data), index.etag);
+  OLA_ASSERT_EQ(static_cast<struct MHD_Response*>(NULL),
+                index.brotli_response);
+
+  string etag;
+  OLA_ASSERT_EQ(index.identity_response,
+                HTTPServer::SelectPreloadedResponse(index, "", &etag));
+  OLA_ASSERT_EQ(index.etag, etag);
+  OLA_ASSERT_EQ(index.identity_response,
+                HTTPServer::SelectPreloadedResponse(index, "br", &etag));
+  OLA_ASSERT_EQ(index.etag, etag);
+
+#ifdef HAVE_ZLIB
+  OLA_ASSERT_TRUE(index.gzip_response);
+  OLA_ASSERT_TRUE(index.gzip_data.size() > 2);
+  OLA_ASSERT_TRUE(index.gzip_data.size() < index.data.size());
+  OLA_ASSERT_EQ(string("\x1f\x8b"), index.gzip_data.substr(0, 2));
+  OLA_ASSERT_EQ(HTTPServer::ContentETag(index.gzip_data), index.gzip_etag);
+  OLA_ASSERT_NE(index.etag, index.gzip_etag);
+  OLA_ASSERT_EQ(index.gzip_response,
+                HTTPServer::SelectPreloadedResponse(index, "gzip, br", &etag));
+  OLA_ASSERT_EQ(index.gzip_etag, etag);
+  OLA_ASSERT_EQ(index.identity_response,
+                HTTPServer::SelectPreloadedResponse(index, "gzip;q=0", &etag));
+#else
+  OLA_ASSERT_EQ(static_cast<struct MHD_Response*>(NULL), index.gzip_response);
+  OLA_ASSERT_EQ(index.identity_response,
+                HTTPServer::SelectPreloadedResponse(index, "gzip", &etag));
+#endif  // HAVE_ZLIB
+
+  // a cached copy of one encoding doesn't match another
+  HTTPServer::SelectPreloadedResponse(index, "gzip", &etag);
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag(etag, etag));
+  HTTPServer::SelectPreloadedResponse(index, "", &etag);
+  OLA_ASSERT_TRUE(HTTPServer::MatchesETag(index.etag, etag));
+#ifdef HAVE_ZLIB
+  OLA_ASSERT_FALSE(HTTPServer::MatchesETag(index.gzip_etag, etag));
+#endif  // HAVE_ZLIB
+
+  // brotli is only used if there's a precompressed file, and is preferred
+  HTTPServer::static_file_info &style = server.m_static_content["/style.css"];
+  OLA_ASSERT_TRUE(server.PreloadFile(&style));
+  OLA_ASSERT_EQ(string("precompressed style.css\n"), style.brotli_data);
+  OLA_ASSERT_EQ(HTTPServer::ContentETag(style.brotli_data), style.brotli_etag);
+  OLA_ASSERT_EQ(style.brotli_response,
+                HTTPServer::SelectPreloadedResponse(style, "gzip, br", &etag));
+  OLA_ASSERT_EQ(style.brotli_etag, etag);
+  OLA_ASSERT_EQ(style.identity_response,
+                HTTPServer::SelectPreloadedResponse(style, "identity", &etag));
+
+  // tiny files don't get smaller, so they're only sent as is
+  HTTPServer::static_file_info &tiny = server.m_static_content["/tiny.txt"];
+  OLA_ASSERT_TRUE(server.PreloadFile(&tiny));
+  OLA_ASSERT_EQ(string("ok\n"), tiny.data);
+  OLA_ASSERT_EQ(static_cast<struct MHD_Response*>(NULL), tiny.gzip_response);
+  OLA_ASSERT_TRUE(tiny.gzip_data.empty());
+  OLA_ASSERT_EQ(tiny.identity_response,
+                HTTPServer::SelectPreloadedResponse(tiny, "gzip", &etag));
+}
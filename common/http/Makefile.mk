@@ -1,3 +1,9 @@
+dist_noinst_DATA += \
+    common/http/testdata/index.html \
+    common/http/testdata/style.css \
+    common/http/testdata/style.css.br \
+    common/http/testdata/tiny.txt
+
 # LIBRARIES
 ##################################################
 if HAVE_LIBMICROHTTPD
@@ -5,5 +11,16 @@ noinst_LTLIBRARIES += common/http/libolahttp.la
 common_http_libolahttp_la_SOURCES = \
     common/http/HTTPServer.cpp \
     common/http/OlaHTTPServer.cpp
-common_http_libolahttp_la_LIBADD = $(libmicrohttpd_LIBS)
+common_http_libolahttp_la_CXXFLAGS = $(COMMON_CXXFLAGS) $(zlib_CFLAGS)
+common_http_libolahttp_la_LIBADD = $(libmicrohttpd_LIBS) $(zlib_LIBS)
+
+# TESTS
+##################################################
+test_programs += common/http/HTTPServerTester
+
+common_http_HTTPServerTester_SOURCES = common/http/HTTPServerTest.cpp
+common_http_HTTPServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_http_HTTPServerTester_LDADD = $(COMMON_TESTING_LIBS) \
+                                     common/http/libolahttp.la \
+                                     common/web/libolaweb.la
 endif
@@ -77,6 +77,14 @@ void DiscoveryAgent::StartIncrementalDiscovery(
   InitDiscovery(on_complete, true);
 }
 
+void DiscoveryAgent::SetKnownUIDs(const UIDSet &uids) {
+  if (m_on_complete) {
+    OLA_WARN << "Discovery procedure already running, ignoring known UIDs";
+    return;
+  }
+  m_uids = uids;
+}
+
 /*
  * Start the discovery process
  * @param on_complete the callback to run when discovery completes
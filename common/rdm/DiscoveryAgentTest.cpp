@@ -44,6 +44,7 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testSingleResponder);
   CPPUNIT_TEST(testResponderWithBroadcastUID);
   CPPUNIT_TEST(testMultipleResponders);
+  CPPUNIT_TEST(testKnownUIDs);
   CPPUNIT_TEST(testObnoxiousResponder);
   CPPUNIT_TEST(testRamblingResponder);
   CPPUNIT_TEST(testBipolarResponder);
@@ -62,6 +63,7 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
     void testSingleResponder();
     void testResponderWithBroadcastUID();
     void testMultipleResponders();
+    void testKnownUIDs();
     void testObnoxiousResponder();
     void testRamblingResponder();
     void testBriefResponder();
@@ -248,6 +250,49 @@ void DiscoveryAgentTest::testMultipleResponders() {
 }
 
 
+/**
+ * Test seeding the agent with UIDs from a previous run.
+ */
+void DiscoveryAgentTest::testKnownUIDs() {
+  UIDSet uids;
+  ResponderList responders;
+  for (unsigned int i = 0; i < 100; i++) {
+    uids.AddUID(UID(0x7a70, 0x00002000 + i * 7919));
+  }
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+
+  DiscoveryAgent agent(&target);
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  m_callback_run = false;
+  unsigned int full_branch_count = target.BranchCallCount();
+
+  // A new agent, seeded with the known UIDs, one of which has gone and
+  // another has been added.
+  UID removed_uid(0x7a70, 0x00002000);
+  UID added_uid(0x8080, 0x00103456);
+  UIDSet known_uids(uids);
+  uids.RemoveUID(removed_uid);
+  uids.AddUID(added_uid);
+  target.RemoveResponder(removed_uid);
+  target.AddResponder(new MockResponder(added_uid));
+  target.ResetCounters();
+
+  DiscoveryAgent seeded_agent(&target);
+  seeded_agent.SetKnownUIDs(known_uids);
+  seeded_agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  OLA_ASSERT_LT(target.BranchCallCount(), full_branch_count / 10);
+}
+
+
 /**
  * Test a responder that continues to responder when muted.
  */
@@ -340,7 +340,8 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
  public:
     explicit MockDiscoveryTarget(const ResponderList &responders)
         : m_responders(responders),
-          m_unmute_calls(0) {
+          m_unmute_calls(0),
+          m_branch_calls(0) {
     }
 
     ~MockDiscoveryTarget() {
@@ -351,12 +352,17 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
 
     void ResetCounters() {
       m_unmute_calls = 0;
+      m_branch_calls = 0;
     }
 
     unsigned int UnmuteCallCount() const {
       return m_unmute_calls;
     }
 
+    unsigned int BranchCallCount() const {
+      return m_branch_calls;
+    }
+
     // Mute a device
     void MuteDevice(const ola::rdm::UID &target,
                     MuteDeviceCallback *mute_complete) {
@@ -391,6 +397,7 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
       memset(data, 0, data_size);
       bool valid = false;
       unsigned int actual_size = 0;
+      m_branch_calls++;
       ResponderList::const_iterator iter = m_responders.begin();
       for (; iter != m_responders.end(); ++iter) {
         unsigned int data_used = data_size;
@@ -426,5 +433,6 @@ class MockDiscoveryTarget: public ola::rdm::DiscoveryTargetInterface {
  private:
     ResponderList m_responders;
     unsigned int m_unmute_calls;
+    unsigned int m_branch_calls;
 };
 #endif  // COMMON_RDM_DISCOVERYAGENTTESTHELPER_H_
@@ -27,12 +27,14 @@ common_libolacommon_la_SOURCES += \
     common/rdm/NetworkManager.h \
     common/rdm/NetworkResponder.cpp \
     common/rdm/OpenLightingEnums.cpp \
+    common/rdm/PidCodec.cpp \
     common/rdm/PidStore.cpp \
     common/rdm/PidStoreHelper.cpp \
     common/rdm/PidStoreLoader.cpp \
     common/rdm/PidStoreLoader.h \
     common/rdm/QueueingRDMController.cpp \
     common/rdm/RDMAPI.cpp \
+    common/rdm/RDMCollector.cpp \
     common/rdm/RDMCommand.cpp \
     common/rdm/RDMCommandSerializer.cpp \
     common/rdm/RDMFrame.cpp \
@@ -58,6 +60,13 @@ EXTRA_DIST += common/rdm/Pids.proto
 common/rdm/Pids.pb.cc common/rdm/Pids.pb.h: common/rdm/Makefile.mk common/rdm/Pids.proto
 	$(PROTOC) --cpp_out common/rdm --proto_path $(srcdir)/common/rdm $(srcdir)/common/rdm/Pids.proto
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/rdm/pid_codec_benchmark
+
+common_rdm_pid_codec_benchmark_SOURCES = common/rdm/pid_codec_benchmark.cpp
+common_rdm_pid_codec_benchmark_LDADD = common/libolacommon.la
+
 # TESTS_DATA
 ##################################################
 
@@ -79,6 +88,7 @@ test_programs += \
     common/rdm/PidStoreTester \
     common/rdm/QueueingRDMControllerTester \
     common/rdm/RDMAPITester \
+    common/rdm/RDMCollectorTester \
     common/rdm/RDMCommandSerializerTester \
     common/rdm/RDMCommandTester \
     common/rdm/RDMFrameTester \
@@ -106,6 +116,7 @@ common_rdm_RDMMessageTester_SOURCES = \
     common/rdm/GroupSizeCalculatorTest.cpp \
     common/rdm/MessageSerializerTest.cpp \
     common/rdm/MessageDeserializerTest.cpp \
+    common/rdm/PidCodecTest.cpp \
     common/rdm/RDMMessageInterationTest.cpp \
     common/rdm/StringMessageBuilderTest.cpp \
     common/rdm/VariableFieldSizeCalculatorTest.cpp
@@ -117,6 +128,11 @@ common_rdm_RDMAPITester_SOURCES = \
 common_rdm_RDMAPITester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMAPITester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_rdm_RDMCollectorTester_SOURCES = \
+    common/rdm/RDMCollectorTest.cpp
+common_rdm_RDMCollectorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_rdm_RDMCollectorTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_rdm_RDMCommandTester_SOURCES = \
     common/rdm/RDMCommandTest.cpp \
     common/rdm/TestHelper.h
@@ -0,0 +1,442 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PidCodec.cpp
+ * Decode RDM parameter data using a precompiled field layout.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Logging.h>
+#include <ola/messaging/Descriptor.h>
+#include <ola/messaging/DescriptorVisitor.h>
+#include <ola/network/NetworkUtils.h>
+#include <ola/rdm/PidCodec.h>
+#include <ola/rdm/PidStore.h>
+#include <ola/stl/STLUtils.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+using ola::messaging::BoolFieldDescriptor;
+using ola::messaging::Descriptor;
+using ola::messaging::FieldDescriptor;
+using ola::messaging::FieldDescriptorGroup;
+using ola::messaging::IPV4FieldDescriptor;
+using ola::messaging::IntegerFieldDescriptor;
+using ola::messaging::MACFieldDescriptor;
+using ola::messaging::StringFieldDescriptor;
+using ola::messaging::UIDFieldDescriptor;
+using std::vector;
+
+namespace {
+
+/*
+ * Read an integer, converting from the wire byte order.
+ */
+template <typename int_type>
+int_type ReadInteger(const uint8_t *data, bool little_endian) {
+  int_type value;
+  memcpy(reinterpret_cast<uint8_t*>(&value), data, sizeof(int_type));
+  if (little_endian) {
+    return ola::network::LittleEndianToHost(value);
+  } else {
+    return ola::network::NetworkToHost(value);
+  }
+}
+}  // namespace
+
+
+/**
+ * Converts the fields of a group into Operations.
+ */
+class PidCodec::CompileVisitor
+    : public ola::messaging::FieldDescriptorVisitor {
+ public:
+  CompileVisitor(PidCodec *codec, bool top_level)
+      : m_codec(codec),
+        m_top_level(top_level),
+        m_ok(true) {
+  }
+
+  bool Ok() const { return m_ok; }
+
+  bool Descend() const { return false; }
+
+  void Visit(const BoolFieldDescriptor *descriptor) {
+    AddOperation(BOOL_OP, descriptor, false);
+  }
+
+  void Visit(const IPV4FieldDescriptor *descriptor) {
+    AddOperation(IPV4_OP, descriptor, false);
+  }
+
+  void Visit(const MACFieldDescriptor *descriptor) {
+    AddOperation(MAC_OP, descriptor, false);
+  }
+
+  void Visit(const UIDFieldDescriptor *descriptor) {
+    AddOperation(UID_OP, descriptor, false);
+  }
+
+  void Visit(const StringFieldDescriptor *descriptor) {
+    if (descriptor->FixedSize()) {
+      AddOperation(STRING_OP, descriptor, false);
+    } else if (SetVariableField()) {
+      m_codec->m_variable_string = descriptor;
+      AddOperation(STRING_OP, descriptor, false, true);
+    }
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint8_t> *descriptor) {
+    AddOperation(UINT8_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint16_t> *descriptor) {
+    AddOperation(UINT16_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const IntegerFieldDescriptor<uint32_t> *descriptor) {
+    AddOperation(UINT32_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const IntegerFieldDescriptor<int8_t> *descriptor) {
+    AddOperation(INT8_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const IntegerFieldDescriptor<int16_t> *descriptor) {
+    AddOperation(INT16_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const IntegerFieldDescriptor<int32_t> *descriptor) {
+    AddOperation(INT32_OP, descriptor, descriptor->IsLittleEndian());
+  }
+
+  void Visit(const FieldDescriptorGroup *descriptor) {
+    bool variable = !descriptor->FixedSize();
+    if (variable) {
+      // Only a fixed block size is supported for the variable group.
+      if (!descriptor->FixedBlockSize()) {
+        m_ok = false;
+        return;
+      }
+      if (!SetVariableField()) {
+        return;
+      }
+      m_codec->m_variable_group = descriptor;
+    }
+
+    unsigned int index = m_codec->m_operations.size();
+    Operation operation;
+    operation.type = GROUP_OP;
+    operation.descriptor = descriptor;
+    operation.size = descriptor->MinBlocks();
+    operation.end = 0;
+    operation.variable = variable;
+    operation.little_endian = false;
+    m_codec->m_operations.push_back(operation);
+
+    if (!variable && m_top_level) {
+      m_codec->m_fixed_size += descriptor->MaxSize();
+    }
+
+    // The fields within a group are always fixed size, and are covered by
+    // the size of the group.
+    CompileVisitor visitor(m_codec, false);
+    for (unsigned int i = 0; i < descriptor->FieldCount(); ++i) {
+      descriptor->GetField(i)->Accept(&visitor);
+    }
+    m_ok &= visitor.Ok();
+    m_codec->m_operations[index].end = m_codec->m_operations.size();
+  }
+
+  void PostVisit(const FieldDescriptorGroup*) {}
+
+ private:
+  PidCodec *m_codec;
+  bool m_top_level;
+  bool m_ok;
+
+  void AddOperation(op_type type, const FieldDescriptor *descriptor,
+                    bool little_endian, bool variable = false) {
+    Operation operation;
+    operation.type = type;
+    operation.descriptor = descriptor;
+    operation.size = variable ? 0 : descriptor->MaxSize();
+    operation.end = 0;
+    operation.variable = variable;
+    operation.little_endian = little_endian;
+    m_codec->m_operations.push_back(operation);
+    if (m_top_level) {
+      m_codec->m_fixed_size += operation.size;
+    }
+  }
+
+  bool SetVariableField() {
+    if (!m_top_level || m_codec->m_variable_string ||
+        m_codec->m_variable_group) {
+      m_ok = false;
+      return false;
+    }
+    return true;
+  }
+};
+
+
+PidCodec::PidCodec(const Descriptor *descriptor)
+    : m_descriptor(descriptor),
+      m_fixed_size(0),
+      m_variable_string(NULL),
+      m_variable_group(NULL) {
+}
+
+
+PidCodec *PidCodec::Compile(const Descriptor *descriptor) {
+  std::auto_ptr<PidCodec> codec(new PidCodec(descriptor));
+  CompileVisitor visitor(codec.get(), true);
+  for (unsigned int i = 0; i < descriptor->FieldCount(); ++i) {
+    descriptor->GetField(i)->Accept(&visitor);
+  }
+  if (!visitor.Ok()) {
+    OLA_INFO << "Unable to compile a codec for " << descriptor->Name();
+    return NULL;
+  }
+  return codec.release();
+}
+
+
+bool PidCodec::Decode(const uint8_t *data,
+                      unsigned int length,
+                      PidCodecVisitor *visitor) const {
+  if (!data && length) {
+    return false;
+  }
+
+  unsigned int variable_size = 0;
+  if (!VariableFieldSize(length, &variable_size)) {
+    return false;
+  }
+
+  unsigned int offset = 0;
+  DecodeOperations(0, m_operations.size(), data, &offset, variable_size,
+                   visitor);
+  return true;
+}
+
+
+/*
+ * Check the length of the data, and work out the size of the variable field.
+ * For a string this is the length in bytes, for a group it's the number of
+ * blocks. This follows the same rules as VariableFieldSizeCalculator.
+ */
+bool PidCodec::VariableFieldSize(unsigned int length,
+                                 unsigned int *variable_size) const {
+  if (length < m_fixed_size) {
+    return false;
+  }
+
+  unsigned int bytes_remaining = length - m_fixed_size;
+  if (m_variable_string) {
+    if (bytes_remaining < m_variable_string->MinSize() ||
+        bytes_remaining > m_variable_string->MaxSize()) {
+      return false;
+    }
+    *variable_size = bytes_remaining;
+    return true;
+  } else if (m_variable_group) {
+    unsigned int block_size = m_variable_group->BlockSize();
+    if (block_size == 0 || bytes_remaining % block_size) {
+      return false;
+    }
+
+    unsigned int blocks = bytes_remaining / block_size;
+    if (blocks < m_variable_group->MinBlocks()) {
+      return false;
+    }
+    if (m_variable_group->MaxBlocks() !=
+          FieldDescriptorGroup::UNLIMITED_BLOCKS &&
+        blocks > static_cast<unsigned int>(m_variable_group->MaxBlocks())) {
+      return false;
+    }
+    *variable_size = blocks;
+    return true;
+  }
+  return bytes_remaining == 0;
+}
+
+
+/*
+ * Run the operations in the range [begin, end). The length of the data has
+ * already been checked, so there are no bounds checks here.
+ */
+void PidCodec::DecodeOperations(unsigned int begin,
+                                unsigned int end,
+                                const uint8_t *data,
+                                unsigned int *offset,
+                                unsigned int variable_size,
+                                PidCodecVisitor *visitor) const {
+  unsigned int i = begin;
+  while (i < end) {
+    const Operation &operation = m_operations[i];
+    const uint8_t *field_data = data + *offset;
+    switch (operation.type) {
+      case BOOL_OP:
+        visitor->Visit(
+            static_cast<const BoolFieldDescriptor*>(operation.descriptor),
+            *field_data != 0);
+        break;
+      case IPV4_OP:
+        {
+          uint32_t address;
+          memcpy(&address, field_data, sizeof(address));
+          visitor->Visit(
+              static_cast<const IPV4FieldDescriptor*>(operation.descriptor),
+              ola::network::IPV4Address(address));
+          break;
+        }
+      case MAC_OP:
+        visitor->Visit(
+            static_cast<const MACFieldDescriptor*>(operation.descriptor),
+            ola::network::MACAddress(field_data));
+        break;
+      case UID_OP:
+        visitor->Visit(
+            static_cast<const UIDFieldDescriptor*>(operation.descriptor),
+            UID(field_data));
+        break;
+      case STRING_OP:
+        {
+          unsigned int size = operation.variable ? variable_size :
+              operation.size;
+          const char *value = reinterpret_cast<const char*>(field_data);
+          const void *null_byte = memchr(value, 0, size);
+          unsigned int string_length = null_byte ?
+              static_cast<const char*>(null_byte) - value : size;
+          visitor->Visit(
+              static_cast<const StringFieldDescriptor*>(operation.descriptor),
+              value, string_length);
+          *offset += size;
+          i++;
+          continue;
+        }
+      case UINT8_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<uint8_t>*>(
+                operation.descriptor),
+            *field_data);
+        break;
+      case UINT16_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<uint16_t>*>(
+                operation.descriptor),
+            ReadInteger<uint16_t>(field_data, operation.little_endian));
+        break;
+      case UINT32_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<uint32_t>*>(
+                operation.descriptor),
+            ReadInteger<uint32_t>(field_data, operation.little_endian));
+        break;
+      case INT8_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<int8_t>*>(
+                operation.descriptor),
+            static_cast<int8_t>(*field_data));
+        break;
+      case INT16_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<int16_t>*>(
+                operation.descriptor),
+            ReadInteger<int16_t>(field_data, operation.little_endian));
+        break;
+      case INT32_OP:
+        visitor->Visit(
+            static_cast<const IntegerFieldDescriptor<int32_t>*>(
+                operation.descriptor),
+            ReadInteger<int32_t>(field_data, operation.little_endian));
+        break;
+      case GROUP_OP:
+        {
+          const FieldDescriptorGroup *group =
+              static_cast<const FieldDescriptorGroup*>(operation.descriptor);
+          unsigned int blocks = operation.variable ? variable_size :
+              operation.size;
+          for (unsigned int block = 0; block < blocks; block++) {
+            visitor->Visit(group, block);
+            DecodeOperations(i + 1, operation.end, data, offset,
+                             variable_size, visitor);
+            visitor->PostVisit(group);
+          }
+          i = operation.end;
+          continue;
+        }
+    }
+    *offset += operation.size;
+    i++;
+  }
+}
+
+
+PidCodecStore::~PidCodecStore() {
+  STLDeleteValues(&m_codecs);
+}
+
+
+void PidCodecStore::AddRootPidStore(const RootPidStore *root_store) {
+  if (root_store->EstaStore()) {
+    AddPidStore(root_store->EstaStore());
+  }
+
+  RootPidStore::ManufacturerMap::const_iterator iter =
+      root_store->ManufacturerStores().begin();
+  for (; iter != root_store->ManufacturerStores().end(); ++iter) {
+    AddPidStore(iter->second);
+  }
+}
+
+
+void PidCodecStore::AddPidStore(const PidStore *store) {
+  vector<const PidDescriptor*> pids;
+  store->AllPids(&pids);
+
+  vector<const PidDescriptor*>::const_iterator iter = pids.begin();
+  for (; iter != pids.end(); ++iter) {
+    AddDescriptor((*iter)->GetRequest());
+    AddDescriptor((*iter)->GetResponse());
+    AddDescriptor((*iter)->SetRequest());
+    AddDescriptor((*iter)->SetResponse());
+  }
+}
+
+
+const PidCodec *PidCodecStore::Lookup(const Descriptor *descriptor) const {
+  return STLFindOrNull(m_codecs, descriptor);
+}
+
+
+void PidCodecStore::AddDescriptor(const Descriptor *descriptor) {
+  if (!descriptor || STLContains(m_codecs, descriptor)) {
+    return;
+  }
+
+  const PidCodec *codec = PidCodec::Compile(descriptor);
+  if (codec) {
+    m_codecs[descriptor] = codec;
+  }
+}
+}  // namespace rdm
+}  // namespace ola
@@ -0,0 +1,458 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PidCodecTest.cpp
+ * Test fixture for the PidCodec class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/messaging/Descriptor.h"
+#include "ola/messaging/Message.h"
+#include "ola/messaging/MessagePrinter.h"
+#include "ola/rdm/MessageDeserializer.h"
+#include "ola/rdm/PidCodec.h"
+#include "ola/rdm/PidStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::messaging::BoolFieldDescriptor;
+using ola::messaging::Descriptor;
+using ola::messaging::FieldDescriptor;
+using ola::messaging::FieldDescriptorGroup;
+using ola::messaging::GenericMessagePrinter;
+using ola::messaging::IPV4FieldDescriptor;
+using ola::messaging::Int16FieldDescriptor;
+using ola::messaging::Int32FieldDescriptor;
+using ola::messaging::Int8FieldDescriptor;
+using ola::messaging::MACFieldDescriptor;
+using ola::messaging::Message;
+using ola::messaging::StringFieldDescriptor;
+using ola::messaging::UIDFieldDescriptor;
+using ola::messaging::UInt16FieldDescriptor;
+using ola::messaging::UInt32FieldDescriptor;
+using ola::messaging::UInt8FieldDescriptor;
+using ola::rdm::MessageDeserializer;
+using ola::rdm::PidCodec;
+using ola::rdm::PidCodecStore;
+using ola::rdm::PidCodecVisitor;
+using ola::rdm::PidDescriptor;
+using ola::rdm::PidStore;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+
+/**
+ * Prints the fields in the same format as the GenericMessagePrinter.
+ */
+class PrintingVisitor: public PidCodecVisitor {
+ public:
+  PrintingVisitor() : m_indent(0) {}
+
+  string AsString() const { return m_str.str(); }
+
+  void Visit(const BoolFieldDescriptor *descriptor, bool value) {
+    Print(descriptor) << (value ? "true" : "false") << "\n";
+  }
+
+  void Visit(const IPV4FieldDescriptor *descriptor,
+             const ola::network::IPV4Address &value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const MACFieldDescriptor *descriptor,
+             const ola::network::MACAddress &value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const UIDFieldDescriptor *descriptor,
+             const ola::rdm::UID &value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const StringFieldDescriptor *descriptor, const char *value,
+             unsigned int length) {
+    Print(descriptor) << string(value, length) << "\n";
+  }
+
+  void Visit(const UInt8FieldDescriptor *descriptor, uint8_t value) {
+    Print(descriptor) << static_cast<int>(value) << "\n";
+  }
+
+  void Visit(const UInt16FieldDescriptor *descriptor, uint16_t value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const UInt32FieldDescriptor *descriptor, uint32_t value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const Int8FieldDescriptor *descriptor, int8_t value) {
+    Print(descriptor) << static_cast<int>(value) << "\n";
+  }
+
+  void Visit(const Int16FieldDescriptor *descriptor, int16_t value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const Int32FieldDescriptor *descriptor, int32_t value) {
+    Print(descriptor) << value << "\n";
+  }
+
+  void Visit(const FieldDescriptorGroup *descriptor, unsigned int) {
+    m_str << string(m_indent, ' ') << descriptor->Name() << " {\n";
+    m_indent += 2;
+  }
+
+  void PostVisit(const FieldDescriptorGroup*) {
+    m_indent -= 2;
+    m_str << string(m_indent, ' ') << "}\n";
+  }
+
+ private:
+  std::ostringstream m_str;
+  unsigned int m_indent;
+
+  std::ostream &Print(const FieldDescriptor *descriptor) {
+    return m_str << string(m_indent, ' ') << descriptor->Name() << ": ";
+  }
+};
+
+
+class PidCodecTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PidCodecTest);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testSimpleBigEndian);
+  CPPUNIT_TEST(testSimpleLittleEndian);
+  CPPUNIT_TEST(testAddresses);
+  CPPUNIT_TEST(testString);
+  CPPUNIT_TEST(testWithGroups);
+  CPPUNIT_TEST(testWithNestedFixedGroups);
+  CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testCodecStore);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testEmpty();
+  void testSimpleBigEndian();
+  void testSimpleLittleEndian();
+  void testAddresses();
+  void testString();
+  void testWithGroups();
+  void testWithNestedFixedGroups();
+  void testUnsupported();
+  void testCodecStore();
+
+ private:
+  MessageDeserializer m_deserializer;
+  GenericMessagePrinter m_printer;
+
+  void CheckDecode(const PidCodec *codec, const uint8_t *data,
+                   unsigned int length, const string &expected);
+  void CheckInvalid(const PidCodec *codec, const uint8_t *data,
+                    unsigned int length);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PidCodecTest);
+
+
+/*
+ * Check the codec decodes the data, and that the result matches the
+ * MessageDeserializer.
+ */
+void PidCodecTest::CheckDecode(const PidCodec *codec,
+                               const uint8_t *data,
+                               unsigned int length,
+                               const string &expected) {
+  OLA_ASSERT_TRUE(codec->ValidLength(length));
+
+  PrintingVisitor visitor;
+  OLA_ASSERT_TRUE(codec->Decode(data, length, &visitor));
+  OLA_ASSERT_EQ(expected, visitor.AsString());
+
+  auto_ptr<const Message> message(m_deserializer.InflateMessage(
+      codec->GetDescriptor(), data, length));
+  OLA_ASSERT_NOT_NULL(message.get());
+  OLA_ASSERT_EQ(m_printer.AsString(message.get()), visitor.AsString());
+}
+
+
+/*
+ * Check the codec rejects the data, and that the MessageDeserializer does as
+ * well.
+ */
+void PidCodecTest::CheckInvalid(const PidCodec *codec,
+                                const uint8_t *data,
+                                unsigned int length) {
+  OLA_ASSERT_FALSE(codec->ValidLength(length));
+
+  PrintingVisitor visitor;
+  OLA_ASSERT_FALSE(codec->Decode(data, length, &visitor));
+  OLA_ASSERT_EQ(string(""), visitor.AsString());
+
+  OLA_ASSERT_NULL(m_deserializer.InflateMessage(
+      codec->GetDescriptor(), data, length));
+}
+
+
+/**
+ * Check that empty messages work.
+ */
+void PidCodecTest::testEmpty() {
+  vector<const FieldDescriptor*> fields;
+  Descriptor descriptor("Empty Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  CheckDecode(codec.get(), NULL, 0, "");
+
+  const uint8_t data[] = {0, 1, 2};
+  CheckInvalid(codec.get(), data, sizeof(data));
+}
+
+
+/**
+ * Test that simple (no variable sized fields) work big endian style.
+ */
+void PidCodecTest::testSimpleBigEndian() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new BoolFieldDescriptor("bool"));
+  fields.push_back(new UInt8FieldDescriptor("uint8"));
+  fields.push_back(new Int8FieldDescriptor("int8"));
+  fields.push_back(new UInt16FieldDescriptor("uint16"));
+  fields.push_back(new Int16FieldDescriptor("int16"));
+  fields.push_back(new UInt32FieldDescriptor("uint32"));
+  fields.push_back(new Int32FieldDescriptor("int32"));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = {
+    0, 10, 246, 1, 0x2c, 0xfe, 10,
+    1, 2, 3, 4, 0xfe, 6, 7, 8};
+
+  CheckInvalid(codec.get(), NULL, 0);
+  CheckInvalid(codec.get(), data, 1);
+  CheckInvalid(codec.get(), data, sizeof(data) - 1);
+
+  CheckDecode(codec.get(), data, sizeof(data),
+      "bool: false\nuint8: 10\nint8: -10\nuint16: 300\nint16: -502\n"
+      "uint32: 16909060\nint32: -33159416\n");
+}
+
+
+/**
+ * Test that simple (no variable sized fields) work little endian style.
+ */
+void PidCodecTest::testSimpleLittleEndian() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new BoolFieldDescriptor("bool"));
+  fields.push_back(new UInt8FieldDescriptor("uint8"));
+  fields.push_back(new Int8FieldDescriptor("int8"));
+  fields.push_back(new UInt16FieldDescriptor("uint16", true));
+  fields.push_back(new Int16FieldDescriptor("int16", true));
+  fields.push_back(new UInt32FieldDescriptor("uint32", true));
+  fields.push_back(new Int32FieldDescriptor("int32", true));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = {
+    1, 10, 246, 0x2c, 1, 10, 0xfe,
+    4, 3, 2, 1, 8, 7, 6, 0xfe};
+
+  CheckDecode(codec.get(), data, sizeof(data),
+      "bool: true\nuint8: 10\nint8: -10\nuint16: 300\nint16: -502\n"
+      "uint32: 16909060\nint32: -33159416\n");
+}
+
+
+/**
+ * Test IPV4, MAC & UID fields.
+ */
+void PidCodecTest::testAddresses() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new IPV4FieldDescriptor("ip"));
+  fields.push_back(new MACFieldDescriptor("mac"));
+  fields.push_back(new UIDFieldDescriptor("uid"));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = {
+    10, 0, 0, 1,
+    1, 35, 69, 103, 137, 171,
+    0x70, 0x7a, 0, 0, 0, 1};
+
+  CheckDecode(codec.get(), data, sizeof(data),
+      "ip: 10.0.0.1\nmac: 01:23:45:67:89:ab\nuid: 707a:00000001\n");
+}
+
+
+/**
+ * Check that fixed and variable sized strings work.
+ */
+void PidCodecTest::testString() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new StringFieldDescriptor("string", 10, 10));
+  fields.push_back(new StringFieldDescriptor("string", 0, 32));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = "0123456789this is a longer string";
+
+  CheckInvalid(codec.get(), data, 0);
+  CheckInvalid(codec.get(), data, 9);
+  CheckInvalid(codec.get(), data, 43);
+
+  // this includes the trailing NULL, which is stripped
+  CheckDecode(codec.get(), data, sizeof(data),
+      "string: 0123456789\nstring: this is a longer string\n");
+  CheckDecode(codec.get(), data, 19,
+      "string: 0123456789\nstring: this is a\n");
+  CheckDecode(codec.get(), data, 10, "string: 0123456789\nstring: \n");
+
+  // a NULL within the fixed string
+  const uint8_t short_data[] = {'f', 'o', 'o', 0, 0, 0, 0, 0, 0, 0, 'b'};
+  CheckDecode(codec.get(), short_data, sizeof(short_data),
+      "string: foo\nstring: b\n");
+}
+
+
+/*
+ * Check variable sized groups.
+ */
+void PidCodecTest::testWithGroups() {
+  vector<const FieldDescriptor*> group_fields;
+  group_fields.push_back(new BoolFieldDescriptor("bool"));
+  group_fields.push_back(new UInt8FieldDescriptor("uint8"));
+
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new UInt16FieldDescriptor("uint16"));
+  fields.push_back(new FieldDescriptorGroup("group", group_fields, 0, 3));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = {1, 2, 0, 10, 1, 3, 0, 20, 1, 40};
+
+  CheckInvalid(codec.get(), data, 1);
+  CheckDecode(codec.get(), data, 2, "uint16: 258\n");
+  CheckInvalid(codec.get(), data, 3);
+  CheckDecode(codec.get(), data, 4,
+      "uint16: 258\ngroup {\n  bool: false\n  uint8: 10\n}\n");
+  CheckInvalid(codec.get(), data, 5);
+  CheckDecode(codec.get(), data, 8,
+      "uint16: 258\n"
+      "group {\n  bool: false\n  uint8: 10\n}\n"
+      "group {\n  bool: true\n  uint8: 3\n}\n"
+      "group {\n  bool: false\n  uint8: 20\n}\n");
+  CheckInvalid(codec.get(), data, sizeof(data));
+}
+
+
+/*
+ * Check nested fixed groups within a variable group.
+ */
+void PidCodecTest::testWithNestedFixedGroups() {
+  vector<const FieldDescriptor*> fields, group_fields, group_fields2;
+  group_fields.push_back(new BoolFieldDescriptor("bool"));
+  group_fields2.push_back(new UInt8FieldDescriptor("uint8"));
+  group_fields2.push_back(new FieldDescriptorGroup("bar", group_fields, 2, 2));
+  fields.push_back(new FieldDescriptorGroup("", group_fields2, 0, 4));
+  Descriptor descriptor("Test Descriptor", fields);
+  auto_ptr<PidCodec> codec(PidCodec::Compile(&descriptor));
+  OLA_ASSERT_NOT_NULL(codec.get());
+
+  const uint8_t data[] = {0, 0, 0, 1, 0, 1, 2, 1, 0, 3, 1, 1};
+
+  CheckDecode(codec.get(), data, 0, "");
+  CheckInvalid(codec.get(), data, 2);
+  CheckDecode(codec.get(), data, 3,
+      " {\n  uint8: 0\n  bar {\n    bool: false\n  }\n  bar {\n"
+      "    bool: false\n  }\n}\n");
+  CheckDecode(codec.get(), data, sizeof(data),
+      " {\n  uint8: 0\n  bar {\n    bool: false\n  }\n  bar {\n"
+      "    bool: false\n  }\n}\n"
+      " {\n  uint8: 1\n  bar {\n    bool: false\n  }\n  bar {\n"
+      "    bool: true\n  }\n}\n"
+      " {\n  uint8: 2\n  bar {\n    bool: true\n  }\n  bar {\n"
+      "    bool: false\n  }\n}\n"
+      " {\n  uint8: 3\n  bar {\n    bool: true\n  }\n  bar {\n"
+      "    bool: true\n  }\n}\n");
+}
+
+
+/*
+ * Check that descriptors with more than one variable field can't be compiled.
+ */
+void PidCodecTest::testUnsupported() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new StringFieldDescriptor("string1", 0, 32));
+  fields.push_back(new StringFieldDescriptor("string2", 0, 32));
+  Descriptor descriptor("Test Descriptor", fields);
+  OLA_ASSERT_NULL(PidCodec::Compile(&descriptor));
+
+  vector<const FieldDescriptor*> group_fields, fields2;
+  group_fields.push_back(new StringFieldDescriptor("string", 0, 32));
+  fields2.push_back(new FieldDescriptorGroup("group", group_fields, 0, 2));
+  Descriptor descriptor2("Test Descriptor", fields2);
+  OLA_ASSERT_NULL(PidCodec::Compile(&descriptor2));
+}
+
+
+/*
+ * Check the PidCodecStore.
+ */
+void PidCodecTest::testCodecStore() {
+  vector<const FieldDescriptor*> fields;
+  fields.push_back(new UInt16FieldDescriptor("uint16"));
+  const Descriptor *response = new Descriptor("Response", fields);
+
+  vector<const FieldDescriptor*> fields2;
+  fields2.push_back(new StringFieldDescriptor("string1", 0, 32));
+  fields2.push_back(new StringFieldDescriptor("string2", 0, 32));
+  const Descriptor *invalid_response = new Descriptor("Response", fields2);
+
+  vector<const PidDescriptor*> pids;
+  pids.push_back(new PidDescriptor("FOO", 0x8000, NULL, response, NULL,
+                                   NULL, PidDescriptor::ROOT_DEVICE,
+                                   PidDescriptor::ROOT_DEVICE));
+  pids.push_back(new PidDescriptor("BAR", 0x8001, NULL, invalid_response,
+                                   NULL, NULL, PidDescriptor::ROOT_DEVICE,
+                                   PidDescriptor::ROOT_DEVICE));
+  PidStore store(pids);
+
+  PidCodecStore codec_store;
+  codec_store.AddPidStore(&store);
+  OLA_ASSERT_EQ(1u, codec_store.CodecCount());
+
+  const PidCodec *codec = codec_store.Lookup(response);
+  OLA_ASSERT_NOT_NULL(codec);
+  OLA_ASSERT_EQ(response, codec->GetDescriptor());
+  OLA_ASSERT_NULL(codec_store.Lookup(invalid_response));
+
+  // adding the store again doesn't compile the descriptors again.
+  codec_store.AddPidStore(&store);
+  OLA_ASSERT_EQ(1u, codec_store.CodecCount());
+  OLA_ASSERT_EQ(codec, codec_store.Lookup(response));
+}
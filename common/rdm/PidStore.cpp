@@ -23,6 +23,7 @@
 
 #include "common/rdm/PidStoreLoader.h"
 #include "ola/StringUtils.h"
+#include "ola/file/Util.h"
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/stl/STLUtils.h"
@@ -120,7 +121,9 @@ const RootPidStore *RootPidStore::LoadFromDirectory(
   if (directory.empty()) {
     data_source = DataLocation();
   }
-  return loader.LoadFromDirectory(data_source, validate);
+  return loader.LoadFromDirectory(
+      data_source, validate,
+      ola::file::JoinPaths(data_source, PidStoreLoader::CACHE_FILE_NAME));
 }
 
 const string RootPidStore::DataLocation() {
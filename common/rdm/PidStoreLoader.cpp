@@ -18,9 +18,22 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <errno.h>
+#include <fcntl.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif  // HAVE_SYS_MMAN_H
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include <sstream>
@@ -50,6 +63,8 @@ using std::string;
 using std::vector;
 
 const char PidStoreLoader::OVERRIDE_FILE_NAME[] = "overrides.proto";
+const char PidStoreLoader::CACHE_FILE_NAME[] = "pids.cache";
+const uint32_t PidStoreLoader::CACHE_VERSION = 1;
 const uint16_t PidStoreLoader::ESTA_MANUFACTURER_ID = 0;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MIN = 0x8000;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MAX = 0xffe0;
@@ -70,7 +85,8 @@ const RootPidStore *PidStoreLoader::LoadFromFile(const string &file,
 
 const RootPidStore *PidStoreLoader::LoadFromDirectory(
     const string &directory,
-    bool validate) {
+    bool validate,
+    const string &cache_file) {
   vector<string> files;
 
   string override_file;
@@ -84,10 +100,27 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
       files.push_back(*file_iter);
     }
   }
+  std::sort(files.begin(), files.end());
 
-  ola::rdm::pid::PidStore pid_store_pb;
+  ola::rdm::pid::PidStoreCache cache;
+  cache.set_cache_version(CACHE_VERSION);
+  bool use_cache = !cache_file.empty();
   vector<string>::const_iterator iter = files.begin();
-  for (; iter != files.end(); ++iter) {
+  for (; use_cache && iter != files.end(); ++iter) {
+    use_cache = AddSourceFile(*iter, &cache);
+  }
+  if (use_cache && !override_file.empty()) {
+    use_cache = AddSourceFile(override_file, &cache);
+  }
+
+  if (use_cache && ReadCache(cache_file, &cache)) {
+    OLA_DEBUG << "Loading PIDs from " << cache_file;
+    // The cache is only written once the data has been validated.
+    return BuildStore(cache.store(), cache.overrides(), false);
+  }
+
+  ola::rdm::pid::PidStore *pid_store_pb = cache.mutable_store();
+  for (iter = files.begin(); iter != files.end(); ++iter) {
     std::ifstream proto_file(iter->data());
     if (!proto_file.is_open()) {
       OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
@@ -96,7 +129,7 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
 
     google::protobuf::io::IstreamInputStream input_stream(&proto_file);
     bool ok = google::protobuf::TextFormat::Merge(&input_stream,
-                                                  &pid_store_pb);
+                                                  pid_store_pb);
     proto_file.close();
 
     if (!ok) {
@@ -105,14 +138,19 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
     }
   }
 
-  ola::rdm::pid::PidStore override_pb;
+  ola::rdm::pid::PidStore *override_pb = cache.mutable_overrides();
   if (!override_file.empty()) {
-    if (!ReadFile(override_file, &override_pb)) {
+    if (!ReadFile(override_file, override_pb)) {
       return NULL;
     }
   }
 
-  return BuildStore(pid_store_pb, override_pb, validate);
+  const RootPidStore *store = BuildStore(*pid_store_pb, *override_pb,
+                                         validate);
+  if (store && use_cache && validate) {
+    WriteCache(cache_file, cache);
+  }
+  return store;
 }
 
 const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
@@ -146,6 +184,126 @@ bool PidStoreLoader::ReadFile(const std::string &file_path,
   return ok;
 }
 
+/*
+ * Record the size and modification time of a source file in the cache.
+ */
+bool PidStoreLoader::AddSourceFile(const string &file_path,
+                                   ola::rdm::pid::PidStoreCache *cache) {
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat)) {
+    OLA_WARN << "Failed to stat " << file_path << ": " << strerror(errno);
+    return false;
+  }
+
+  ola::rdm::pid::SourceFile *source = cache->add_source();
+  source->set_path(file_path);
+  source->set_size(file_stat.st_size);
+  source->set_modified(file_stat.st_mtime);
+  return true;
+}
+
+/*
+ * Read the cache file. If the cache was built from the same source files as
+ * listed in the cache argument, the PidStores are copied to the cache
+ * argument.
+ * @returns true if the cache was valid, false otherwise.
+ */
+bool PidStoreLoader::ReadCache(const string &cache_file,
+                               ola::rdm::pid::PidStoreCache *cache) {
+  int fd = open(cache_file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    OLA_DEBUG << "Failed to open " << cache_file << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) || file_stat.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  ola::rdm::pid::PidStoreCache cached;
+  bool ok;
+#ifdef HAVE_SYS_MMAN_H
+  void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    OLA_WARN << "Failed to map " << cache_file << ": " << strerror(errno);
+    return false;
+  }
+  ok = cached.ParsePartialFromArray(data, file_stat.st_size);
+  munmap(data, file_stat.st_size);
+#else
+  close(fd);
+  std::ifstream cache_stream(cache_file.c_str(),
+                             std::ios::in | std::ios::binary);
+  ok = cached.ParsePartialFromIstream(&cache_stream);
+#endif  // HAVE_SYS_MMAN_H
+
+  if (!ok) {
+    OLA_WARN << "Failed to parse " << cache_file;
+    return false;
+  }
+
+  if (!cached.IsInitialized() ||
+      cached.cache_version() != cache->cache_version() ||
+      cached.source_size() != cache->source_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < cache->source_size(); ++i) {
+    const ola::rdm::pid::SourceFile &source = cache->source(i);
+    const ola::rdm::pid::SourceFile &cached_source = cached.source(i);
+    if (source.path() != cached_source.path() ||
+        source.size() != cached_source.size() ||
+        source.modified() != cached_source.modified()) {
+      OLA_INFO << cache_file << " is out of date";
+      return false;
+    }
+  }
+
+  cache->mutable_store()->Swap(cached.mutable_store());
+  cache->mutable_overrides()->Swap(cached.mutable_overrides());
+  return true;
+}
+
+/*
+ * Write the cache file. Failing to write the cache isn't an error, since the
+ * data directory may be read-only.
+ */
+void PidStoreLoader::WriteCache(const string &cache_file,
+                                const ola::rdm::pid::PidStoreCache &cache) {
+  // olad and the command line tools may write the cache at the same time, so
+  // each process uses its own temporary file.
+  const string temp_file = (cache_file + "." +
+                           ola::strings::IntToString(getpid()) + ".new");
+  std::ofstream cache_stream(temp_file.c_str(),
+                             std::ios::out | std::ios::trunc |
+                             std::ios::binary);
+  if (!cache_stream.is_open()) {
+    OLA_INFO << "Unable to write " << temp_file << ": " << strerror(errno);
+    return;
+  }
+
+  bool ok = cache.SerializePartialToOstream(&cache_stream);
+  cache_stream.close();
+  if (!ok || cache_stream.fail()) {
+    OLA_WARN << "Failed to write " << temp_file;
+    unlink(temp_file.c_str());
+    return;
+  }
+
+  // Replace the old cache in one step, so other processes never see a
+  // partial file.
+  if (rename(temp_file.c_str(), cache_file.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_file << " to " << cache_file
+             << ": " << strerror(errno);
+    unlink(temp_file.c_str());
+    return;
+  }
+  OLA_INFO << "Wrote PID cache to " << cache_file;
+}
+
 /*
  * Build the RootPidStore from a protocol buffer.
  */
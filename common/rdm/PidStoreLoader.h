@@ -57,12 +57,25 @@ class PidStoreLoader {
    * @param directory the directory to load files from.
    * @param validate set to true if we should perform validation of the
    *   contents.
+   * @param cache_file the path of the compiled cache, or the empty string to
+   *   not use a cache.
    * @returns A pointer to a new RootPidStore or NULL if loading failed.
    *
    * This is an all-or-nothing load. Any error with cause us to abort the load.
+   *
+   * If cache_file is provided, and was built from the same files (by path,
+   * size and modification time), the cache is loaded instead of parsing the
+   * text files. Otherwise the text files are loaded and, if validation was
+   * requested, the cache is rewritten.
    */
   const RootPidStore *LoadFromDirectory(const std::string &directory,
-                                        bool validate = true);
+                                        bool validate = true,
+                                        const std::string &cache_file = "");
+
+  /**
+   * @brief The name of the cache file written by RootPidStore.
+   */
+  static const char CACHE_FILE_NAME[];
 
   /**
    * @brief Load Pid information from a stream
@@ -83,6 +96,13 @@ class PidStoreLoader {
   bool ReadFile(const std::string &file_path,
                 ola::rdm::pid::PidStore *proto);
 
+  bool AddSourceFile(const std::string &file_path,
+                     ola::rdm::pid::PidStoreCache *cache);
+  bool ReadCache(const std::string &cache_file,
+                 ola::rdm::pid::PidStoreCache *cache);
+  void WriteCache(const std::string &cache_file,
+                  const ola::rdm::pid::PidStoreCache &cache);
+
   const RootPidStore *BuildStore(const ola::rdm::pid::PidStore &store_pb,
                                  const ola::rdm::pid::PidStore &override_pb,
                                  bool validate);
@@ -119,6 +139,7 @@ class PidStoreLoader {
   void FreeManufacturerMap(ManufacturerMap *data);
 
   static const char OVERRIDE_FILE_NAME[];
+  static const uint32_t CACHE_VERSION;
   static const uint16_t ESTA_MANUFACTURER_ID;
   static const uint16_t MANUFACTURER_PID_MIN;
   static const uint16_t MANUFACTURER_PID_MAX;
@@ -20,12 +20,15 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string.h>
+#include <unistd.h>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "common/rdm/PidStoreLoader.h"
+#include "common/rdm/Pids.pb.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/messaging/Descriptor.h"
@@ -56,6 +59,7 @@ class PidStoreTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testPidStoreLoad);
   CPPUNIT_TEST(testPidStoreFileLoad);
   CPPUNIT_TEST(testPidStoreDirectoryLoad);
+  CPPUNIT_TEST(testPidStoreCache);
   CPPUNIT_TEST(testPidStoreLoadMissingFile);
   CPPUNIT_TEST(testPidStoreLoadDuplicateManufacturer);
   CPPUNIT_TEST(testPidStoreLoadDuplicateValue);
@@ -70,6 +74,7 @@ class PidStoreTest: public CppUnit::TestFixture {
   void testPidStoreLoad();
   void testPidStoreFileLoad();
   void testPidStoreDirectoryLoad();
+  void testPidStoreCache();
   void testPidStoreLoadMissingFile();
   void testPidStoreLoadDuplicateManufacturer();
   void testPidStoreLoadDuplicateValue();
@@ -84,6 +89,20 @@ class PidStoreTest: public CppUnit::TestFixture {
     path.append(filename);
     return path;
   }
+
+  bool ReadCache(const string &cache_file,
+                 ola::rdm::pid::PidStoreCache *cache) {
+    std::ifstream cache_stream(cache_file.c_str(),
+                               std::ios::in | std::ios::binary);
+    return cache->ParsePartialFromIstream(&cache_stream);
+  }
+
+  bool WriteCache(const string &cache_file,
+                  const ola::rdm::pid::PidStoreCache &cache) {
+    std::ofstream cache_stream(cache_file.c_str(),
+                               std::ios::out | std::ios::binary);
+    return cache.SerializePartialToOstream(&cache_stream);
+  }
 };
 
 
@@ -443,6 +462,56 @@ void PidStoreTest::testPidStoreDirectoryLoad() {
 }
 
 
+/**
+ * Check that the compiled cache is written, used and rebuilt when the source
+ * files change.
+ */
+void PidStoreTest::testPidStoreCache() {
+  const string cache_file = "PidStoreTest.cache";
+  unlink(cache_file.c_str());
+
+  // The first load writes the cache.
+  PidStoreLoader loader;
+  auto_ptr<const RootPidStore> root_store(loader.LoadFromDirectory(
+      GetTestDataFile("pids"), true, cache_file));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), root_store->Version());
+
+  ola::rdm::pid::PidStoreCache cache;
+  OLA_ASSERT_TRUE(ReadCache(cache_file, &cache));
+  OLA_ASSERT_EQ(3, cache.source_size());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), cache.store().version());
+
+  // Change the version in the cache, so we can tell that it's used.
+  cache.mutable_store()->set_version(42);
+  OLA_ASSERT_TRUE(WriteCache(cache_file, cache));
+  root_store.reset(loader.LoadFromDirectory(GetTestDataFile("pids"), true,
+                                            cache_file));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(42), root_store->Version());
+
+  // The overrides are still applied.
+  const PidStore *open_lighting_store =
+    root_store->ManufacturerStore(ola::OPEN_LIGHTING_ESTA_CODE);
+  OLA_ASSERT_NOT_NULL(open_lighting_store);
+  OLA_ASSERT_NULL(open_lighting_store->LookupPID("SERIAL_NUMBER"));
+  OLA_ASSERT_NOT_NULL(open_lighting_store->LookupPID("FOO_BAR"));
+
+  // Now make the cache stale, the text files should be loaded and the cache
+  // rebuilt.
+  cache.mutable_source(0)->set_modified(0);
+  OLA_ASSERT_TRUE(WriteCache(cache_file, cache));
+  root_store.reset(loader.LoadFromDirectory(GetTestDataFile("pids"), true,
+                                            cache_file));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), root_store->Version());
+
+  OLA_ASSERT_TRUE(ReadCache(cache_file, &cache));
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), cache.store().version());
+  unlink(cache_file.c_str());
+}
+
+
 /**
  * Check that loading a missing file fails.
  */
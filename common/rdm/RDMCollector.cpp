@@ -0,0 +1,830 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMCollector.cpp
+ * Collects the parameters from a set of RDM devices.
+ * Copyright (C) 2026 agent
+ */
+
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMAPI.h"
+#include "ola/rdm/RDMCollector.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMHelper.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace rdm {
+
+using ola::network::HostToNetwork;
+using ola::network::NetworkToHost;
+using std::deque;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+const unsigned int PID_CLASS_COUNT = RDMCollector::PID_CLASS_STATUS + 1;
+
+/*
+ * PIDs that are never fetched, either because GET isn't supported, because
+ * they're handled by the collector itself, or because they require param data
+ * the collector can't determine.
+ */
+const uint16_t SKIPPED_PIDS[] = {
+  PID_DISC_UNIQUE_BRANCH,
+  PID_DISC_MUTE,
+  PID_DISC_UN_MUTE,
+  PID_QUEUED_MESSAGE,
+  PID_STATUS_MESSAGES,
+  PID_STATUS_ID_DESCRIPTION,
+  PID_CLEAR_STATUS_ID,
+  PID_RESET_DEVICE,
+  PID_CAPTURE_PRESET,
+  PID_SELF_TEST_DESCRIPTION,
+  PID_CURVE_DESCRIPTION,
+  PID_OUTPUT_RESPONSE_TIME_DESCRIPTION,
+  PID_MODULATION_FREQUENCY_DESCRIPTION,
+  PID_LOCK_STATE_DESCRIPTION,
+  PID_PRESET_STATUS,
+  // The following are fetched once per index by QueueIndexedPids().
+  PID_PARAMETER_DESCRIPTION,
+  PID_DMX_PERSONALITY_DESCRIPTION,
+  PID_SLOT_DESCRIPTION,
+  PID_SENSOR_DEFINITION,
+  PID_SENSOR_VALUE,
+};
+
+/*
+ * These failures are usually caused by noise on the line or a busy proxy, so
+ * the request is worth retrying.
+ */
+bool IsTransientStatus(RDMStatusCode status_code) {
+  switch (status_code) {
+    case RDM_FAILED_TO_SEND:
+    case RDM_TIMEOUT:
+    case RDM_INVALID_RESPONSE:
+    case RDM_CHECKSUM_INCORRECT:
+    case RDM_TRANSACTION_MISMATCH:
+    case RDM_SUB_DEVICE_MISMATCH:
+    case RDM_SRC_UID_MISMATCH:
+    case RDM_DEST_UID_MISMATCH:
+    case RDM_WRONG_SUB_START_CODE:
+    case RDM_PACKET_TOO_SHORT:
+    case RDM_PACKET_LENGTH_MISMATCH:
+    case RDM_PARAM_LENGTH_MISMATCH:
+    case RDM_INVALID_COMMAND_CLASS:
+    case RDM_COMMAND_CLASS_MISMATCH:
+    case RDM_INVALID_RESPONSE_TYPE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsTransientNack(uint16_t reason) {
+  switch (reason) {
+    case NR_HARDWARE_FAULT:
+    case NR_PROXY_REJECT:
+    case NR_BUFFER_FULL:
+    case NR_PROXY_BUFFER_FULL:
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+
+/*
+ * A device being collected.
+ */
+struct RDMCollector::Device {
+ public:
+  Device(unsigned int universe, const UID &uid)
+      : universe(universe),
+        uid(uid),
+        footprint(0),
+        personality_count(0),
+        sensor_count(0),
+        identity_pending(0) {
+  }
+
+  unsigned int universe;
+  UID uid;
+  uint16_t footprint;
+  uint8_t personality_count;
+  uint8_t sensor_count;
+  // The number of DEVICE_INFO & SUPPORTED_PARAMETERS requests outstanding.
+  unsigned int identity_pending;
+  set<uint16_t> supported_pids;
+  set<uint16_t> requested_pids;
+  // Requests that are waiting to be collected with QUEUED_MESSAGE.
+  vector<Request*> queued_requests;
+};
+
+
+/*
+ * A single GET request.
+ */
+struct RDMCollector::Request {
+ public:
+  Request(Device *device, uint16_t pid, const string &data)
+      : device(device),
+        pid(pid),
+        pid_class(ClassifyPid(pid)),
+        data(data),
+        attempts(0),
+        queued_message_fetches(0),
+        awaiting_queued_message(false),
+        timeout(ola::thread::INVALID_TIMEOUT) {
+  }
+
+  Device *device;
+  const uint16_t pid;
+  const PidClass pid_class;
+  const string data;
+  unsigned int attempts;
+  unsigned int queued_message_fetches;
+  // True if the next request should be a GET QUEUED_MESSAGE.
+  bool awaiting_queued_message;
+  ola::thread::timeout_id timeout;
+};
+
+
+/*
+ * The requests for a universe.
+ */
+struct RDMCollector::Line {
+ public:
+  explicit Line(unsigned int universe)
+      : universe(universe),
+        outstanding(NULL),
+        dispatching(false) {
+  }
+
+  unsigned int universe;
+  // One queue for each PidClass.
+  deque<Request*> queues[PID_CLASS_COUNT];
+  Request *outstanding;
+  // True while DispatchLine() is running, this prevents recursion if the
+  // RDMAPIImplInterface runs the callback before RDMGet() returns.
+  bool dispatching;
+  // Requests waiting for a retry or ACK_TIMER to expire.
+  set<Request*> delayed;
+};
+
+
+RDMCollector::RDMCollector(RDMAPIImplInterface *api,
+                           ola::thread::SchedulerInterface *scheduler,
+                           ResultCallback *result_callback,
+                           IdleCallback *idle_callback,
+                           const Options &options)
+    : m_api(api),
+      m_scheduler(scheduler),
+      m_result_callback(result_callback),
+      m_idle_callback(idle_callback),
+      m_options(options),
+      m_pending_requests(0) {
+}
+
+
+RDMCollector::~RDMCollector() {
+  LineMap::iterator line_iter = m_lines.begin();
+  for (; line_iter != m_lines.end(); ++line_iter) {
+    Line *line = line_iter->second;
+    if (line->outstanding) {
+      OLA_WARN << "RDMCollector deleted with an outstanding request on "
+               << "universe " << line->universe;
+    }
+
+    set<Request*>::iterator delayed_iter = line->delayed.begin();
+    for (; delayed_iter != line->delayed.end(); ++delayed_iter) {
+      m_scheduler->RemoveTimeout((*delayed_iter)->timeout);
+      delete *delayed_iter;
+    }
+
+    for (unsigned int i = 0; i < PID_CLASS_COUNT; i++) {
+      STLDeleteElements(&line->queues[i]);
+    }
+    delete line;
+  }
+  m_lines.clear();
+
+  STLDeleteValues(&m_devices);
+  delete m_result_callback;
+  delete m_idle_callback;
+}
+
+
+void RDMCollector::AddDevice(unsigned int universe, const UID &uid) {
+  std::pair<unsigned int, UID> key(universe, uid);
+  if (STLContains(m_devices, key)) {
+    return;
+  }
+
+  Device *device = new Device(universe, uid);
+  m_devices[key] = device;
+
+  // SOFTWARE_VERSION_LABEL is required, so it's not listed in
+  // SUPPORTED_PARAMETERS.
+  device->identity_pending = 2;
+  QueueGet(device, PID_DEVICE_INFO);
+  QueueGet(device, PID_SUPPORTED_PARAMETERS);
+  QueueGet(device, PID_SOFTWARE_VERSION_LABEL);
+  DispatchLine(GetLine(universe));
+}
+
+
+void RDMCollector::AddDevices(unsigned int universe, const UIDSet &uids) {
+  UIDSet::Iterator iter = uids.Begin();
+  for (; iter != uids.End(); ++iter) {
+    AddDevice(universe, *iter);
+  }
+}
+
+
+RDMCollector::PidClass RDMCollector::ClassifyPid(uint16_t pid) {
+  if (pid >= 0x8000) {
+    // Manufacturer PIDs are mostly status or diagnostic values.
+    return PID_CLASS_STATUS;
+  }
+
+  switch (pid) {
+    case PID_DEVICE_INFO:
+    case PID_SUPPORTED_PARAMETERS:
+      return PID_CLASS_IDENTITY;
+    case PID_PROXIED_DEVICES:
+    case PID_PROXIED_DEVICE_COUNT:
+    case PID_PARAMETER_DESCRIPTION:
+    case PID_PRODUCT_DETAIL_ID_LIST:
+    case PID_DEVICE_MODEL_DESCRIPTION:
+    case PID_MANUFACTURER_LABEL:
+    case PID_LANGUAGE_CAPABILITIES:
+    case PID_SOFTWARE_VERSION_LABEL:
+    case PID_BOOT_SOFTWARE_VERSION_ID:
+    case PID_BOOT_SOFTWARE_VERSION_LABEL:
+    case PID_DMX_PERSONALITY_DESCRIPTION:
+    case PID_SLOT_INFO:
+    case PID_SLOT_DESCRIPTION:
+    case PID_DEFAULT_SLOT_VALUE:
+    case PID_SENSOR_DEFINITION:
+    case PID_DIMMER_INFO:
+      return PID_CLASS_DESCRIPTION;
+    case PID_COMMS_STATUS:
+    case PID_SENSOR_VALUE:
+    case PID_DEVICE_HOURS:
+    case PID_LAMP_HOURS:
+    case PID_LAMP_STRIKES:
+    case PID_LAMP_STATE:
+    case PID_DEVICE_POWER_CYCLES:
+    case PID_REAL_TIME_CLOCK:
+      return PID_CLASS_STATUS;
+    default:
+      return PID_CLASS_CONFIGURATION;
+  }
+}
+
+
+string RDMCollector::PidClassToString(PidClass pid_class) {
+  switch (pid_class) {
+    case PID_CLASS_IDENTITY:
+      return "identity";
+    case PID_CLASS_DESCRIPTION:
+      return "description";
+    case PID_CLASS_CONFIGURATION:
+      return "configuration";
+    case PID_CLASS_STATUS:
+      return "status";
+    default:
+      return "unknown";
+  }
+}
+
+
+string RDMCollector::ResultTypeToString(ResultType type) {
+  switch (type) {
+    case RESULT_ACK:
+      return "ack";
+    case RESULT_NACK:
+      return "nack";
+    case RESULT_FAILED:
+      return "failed";
+    default:
+      return "unknown";
+  }
+}
+
+
+RDMCollector::Line *RDMCollector::GetLine(unsigned int universe) {
+  Line *line = STLFindOrNull(m_lines, universe);
+  if (!line) {
+    line = new Line(universe);
+    m_lines[universe] = line;
+  }
+  return line;
+}
+
+
+/*
+ * Queue a GET for a device. GETs without param data are only sent once per
+ * device.
+ */
+void RDMCollector::QueueGet(Device *device, uint16_t pid, const string &data) {
+  if (data.empty() && !device->requested_pids.insert(pid).second) {
+    return;
+  }
+  m_pending_requests++;
+  Enqueue(new Request(device, pid, data), false);
+}
+
+
+/*
+ * Queue a GET for each index of a PID. The index is either a uint8 or a
+ * uint16.
+ */
+void RDMCollector::QueueIndexedGets(Device *device, uint16_t pid,
+                                    unsigned int first, unsigned int count,
+                                    bool wide_index) {
+  if (!STLContains(device->supported_pids, pid)) {
+    return;
+  }
+
+  for (unsigned int i = first; i < first + count; i++) {
+    string data;
+    if (wide_index) {
+      uint16_t index = HostToNetwork(static_cast<uint16_t>(i));
+      data.assign(reinterpret_cast<const char*>(&index), sizeof(index));
+    } else {
+      data.push_back(static_cast<char>(i));
+    }
+    QueueGet(device, pid, data);
+  }
+}
+
+
+/*
+ * Add a request to the queue for its line. Requests that are being retried,
+ * or are collecting a queued message, go to the front of their queue.
+ */
+void RDMCollector::Enqueue(Request *request, bool front) {
+  Line *line = GetLine(request->device->universe);
+  deque<Request*> &queue = line->queues[
+      request->awaiting_queued_message ? PID_CLASS_IDENTITY :
+      request->pid_class];
+  if (front) {
+    queue.push_front(request);
+  } else {
+    queue.push_back(request);
+  }
+}
+
+
+/*
+ * Send the highest priority request for a line, if there isn't already a
+ * request outstanding.
+ */
+void RDMCollector::DispatchLine(Line *line) {
+  if (line->dispatching) {
+    return;
+  }
+
+  line->dispatching = true;
+  while (!line->outstanding) {
+    Request *request = NULL;
+    for (unsigned int i = 0; i < PID_CLASS_COUNT; i++) {
+      if (!line->queues[i].empty()) {
+        request = line->queues[i].front();
+        line->queues[i].pop_front();
+        break;
+      }
+    }
+
+    if (!request) {
+      break;
+    }
+    SendRequest(line, request);
+  }
+  line->dispatching = false;
+  RunIdleCallbackIfIdle();
+}
+
+
+void RDMCollector::SendRequest(Line *line, Request *request) {
+  const Device *device = request->device;
+  line->outstanding = request;
+  m_stats.request_count++;
+
+  RDMAPIImplInterface::rdm_pid_callback *callback = NewSingleCallback(
+      this, &RDMCollector::HandleResponse, request);
+
+  bool ok;
+  if (request->awaiting_queued_message) {
+    const uint8_t status_type = STATUS_ADVISORY;
+    m_stats.queued_message_count++;
+    ok = m_api->RDMGet(callback, device->universe, device->uid,
+                       ROOT_RDM_DEVICE, PID_QUEUED_MESSAGE, &status_type,
+                       sizeof(status_type));
+  } else {
+    request->attempts++;
+    ok = m_api->RDMGet(
+        callback, device->universe, device->uid, ROOT_RDM_DEVICE,
+        request->pid,
+        reinterpret_cast<const uint8_t*>(request->data.data()),
+        request->data.size());
+  }
+
+  if (!ok) {
+    // Like the RDMAPI, we assume the callback won't be run.
+    line->outstanding = NULL;
+    Complete(request, RESULT_FAILED, 0, "", "Failed to send request");
+  }
+}
+
+
+void RDMCollector::HandleResponse(Request *request,
+                                  const ResponseStatus &status,
+                                  uint16_t pid,
+                                  const string &data) {
+  Line *line = GetLine(request->device->universe);
+  line->outstanding = NULL;
+
+  if (request->awaiting_queued_message) {
+    HandleQueuedMessage(request, status, pid, data);
+  } else {
+    HandleRequestResponse(request, status, data);
+  }
+
+  DispatchLine(line);
+}
+
+
+void RDMCollector::HandleRequestResponse(Request *request,
+                                         const ResponseStatus &status,
+                                         const string &data) {
+  if (!CheckTransportStatus(request, status)) {
+    return;
+  }
+
+  switch (status.response_type) {
+    case RDM_ACK:
+      Complete(request, RESULT_ACK, 0, data, "");
+      break;
+    case RDM_ACK_TIMER:
+      m_stats.ack_timer_count++;
+      request->device->queued_requests.push_back(request);
+      FetchQueuedMessage(request, status.AckTimer());
+      break;
+    case RDM_NACK_REASON:
+      if (IsTransientNack(status.NackReason())) {
+        RetryOrFail(request, NackReasonToString(status.NackReason()));
+      } else {
+        Complete(request, RESULT_NACK, status.NackReason(), "", "");
+      }
+      break;
+    default:
+      RetryOrFail(request, "Invalid response type");
+  }
+}
+
+
+/*
+ * Handle the response to a GET QUEUED_MESSAGE. This may be the response we
+ * were waiting for, a response for another PID, or an empty STATUS_MESSAGES
+ * if the response isn't ready yet.
+ */
+void RDMCollector::HandleQueuedMessage(Request *request,
+                                       const ResponseStatus &status,
+                                       uint16_t pid,
+                                       const string &data) {
+  if (!CheckTransportStatus(request, status)) {
+    return;
+  }
+
+  if (status.response_type == RDM_ACK_TIMER) {
+    FetchQueuedMessage(request, status.AckTimer());
+    return;
+  }
+
+  if (status.response_type != RDM_ACK &&
+      status.response_type != RDM_NACK_REASON) {
+    FetchQueuedMessage(request, m_options.retry_delay);
+    return;
+  }
+
+  if (pid == PID_QUEUED_MESSAGE) {
+    if (status.response_type == RDM_NACK_REASON) {
+      Complete(request, RESULT_FAILED, 0, "",
+               "ACK_TIMER from a device that doesn't support QUEUED_MESSAGE");
+    } else {
+      OLA_INFO << request->device->uid << " responded to QUEUED_MESSAGE "
+               << "with QUEUED_MESSAGE";
+      FetchQueuedMessage(request, m_options.retry_delay);
+    }
+    return;
+  }
+
+  if (pid == PID_STATUS_MESSAGES) {
+    // The queue is empty, the response isn't ready yet.
+    FetchQueuedMessage(request, m_options.retry_delay);
+    return;
+  }
+
+  Request *target = TakeQueuedRequest(request, status, pid, data);
+  if (!target) {
+    OLA_INFO << "Unexpected queued message for PID 0x" << std::hex << pid
+             << " from " << request->device->uid;
+    FetchQueuedMessage(request, 0);
+    return;
+  }
+
+  if (target != request) {
+    // The response was for a different request, we need to ask again.
+    Unschedule(target);
+    FetchQueuedMessage(request, 0);
+  }
+  target->awaiting_queued_message = false;
+  HandleRequestResponse(target, status, data);
+}
+
+
+/*
+ * Find and remove the request a queued response belongs to. After an
+ * ACK_TIMER the line moves on, so a device can have several requests for an
+ * indexed PID such as SENSOR_VALUE queued at once, and the responses can come
+ * back in any order. The param data of an ACK starts with the index, so it
+ * has to match the param data of the request. NACKs don't carry the index, so
+ * they're credited to the request that fetched them if the PID matches,
+ * otherwise to the oldest request for the PID.
+ */
+RDMCollector::Request *RDMCollector::TakeQueuedRequest(
+    Request *request,
+    const ResponseStatus &status,
+    uint16_t pid,
+    const string &data) {
+  vector<Request*> &queued_requests = request->device->queued_requests;
+  vector<Request*>::iterator match = queued_requests.end();
+  vector<Request*>::iterator iter = queued_requests.begin();
+  for (; iter != queued_requests.end(); ++iter) {
+    Request *queued = *iter;
+    if (queued->pid != pid) {
+      continue;
+    }
+
+    if (status.response_type == RDM_ACK) {
+      if (data.compare(0, queued->data.size(), queued->data) == 0) {
+        match = iter;
+        break;
+      }
+    } else if (match == queued_requests.end() || queued == request) {
+      match = iter;
+    }
+  }
+
+  if (match == queued_requests.end()) {
+    return NULL;
+  }
+  Request *target = *match;
+  queued_requests.erase(match);
+  return target;
+}
+
+
+/*
+ * Check the request was delivered and a valid response was received. If not,
+ * the request is retried or failed.
+ * @returns true if the response is valid.
+ */
+bool RDMCollector::CheckTransportStatus(Request *request,
+                                        const ResponseStatus &status) {
+  if (!status.error.empty()) {
+    // A problem with the RPC layer, retrying won't help.
+    Complete(request, RESULT_FAILED, 0, "", status.error);
+    return false;
+  }
+
+  if (status.response_code != RDM_COMPLETED_OK) {
+    string error = StatusCodeToString(status.response_code);
+    if (IsTransientStatus(status.response_code)) {
+      RetryOrFail(request, error);
+    } else {
+      Complete(request, RESULT_FAILED, 0, "", error);
+    }
+    return false;
+  }
+  return true;
+}
+
+
+void RDMCollector::FetchQueuedMessage(Request *request, unsigned int delay) {
+  if (request->queued_message_fetches++ >=
+      m_options.max_queued_message_fetches) {
+    Complete(request, RESULT_FAILED, 0, "",
+             "Failed to collect the queued message");
+    return;
+  }
+  request->awaiting_queued_message = true;
+  Schedule(request, delay);
+}
+
+
+void RDMCollector::RetryOrFail(Request *request, const string &error) {
+  if (request->awaiting_queued_message) {
+    FetchQueuedMessage(request, m_options.retry_delay);
+  } else if (request->attempts < m_options.max_attempts) {
+    m_stats.retry_count++;
+    Schedule(request, m_options.retry_delay);
+  } else {
+    Complete(request, RESULT_FAILED, 0, "", error);
+  }
+}
+
+
+/*
+ * Put a request back on its line, after a delay.
+ */
+void RDMCollector::Schedule(Request *request, unsigned int delay) {
+  if (delay == 0) {
+    Enqueue(request, true);
+    return;
+  }
+
+  Line *line = GetLine(request->device->universe);
+  line->delayed.insert(request);
+  request->timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &RDMCollector::DelayComplete, request));
+}
+
+
+void RDMCollector::DelayComplete(Request *request) {
+  Line *line = GetLine(request->device->universe);
+  line->delayed.erase(request);
+  request->timeout = ola::thread::INVALID_TIMEOUT;
+  Enqueue(request, true);
+  DispatchLine(line);
+}
+
+
+/*
+ * Remove a request from its line, wherever it is.
+ */
+void RDMCollector::Unschedule(Request *request) {
+  Line *line = GetLine(request->device->universe);
+  if (line->delayed.erase(request)) {
+    m_scheduler->RemoveTimeout(request->timeout);
+    request->timeout = ola::thread::INVALID_TIMEOUT;
+    return;
+  }
+
+  for (unsigned int i = 0; i < PID_CLASS_COUNT; i++) {
+    deque<Request*>::iterator iter = std::find(
+        line->queues[i].begin(), line->queues[i].end(), request);
+    if (iter != line->queues[i].end()) {
+      line->queues[i].erase(iter);
+      return;
+    }
+  }
+}
+
+
+void RDMCollector::Complete(Request *request, ResultType type,
+                            uint16_t nack_reason, const string &data,
+                            const string &error) {
+  Device *device = request->device;
+
+  vector<Request*>::iterator iter = std::find(
+      device->queued_requests.begin(), device->queued_requests.end(),
+      request);
+  if (iter != device->queued_requests.end()) {
+    device->queued_requests.erase(iter);
+  }
+
+  switch (type) {
+    case RESULT_ACK:
+      m_stats.ack_count++;
+      break;
+    case RESULT_NACK:
+      m_stats.nack_count++;
+      break;
+    default:
+      m_stats.failure_count++;
+  }
+
+  Result result(device->uid);
+  result.universe = device->universe;
+  result.pid = request->pid;
+  result.pid_class = request->pid_class;
+  result.request_data = request->data;
+  result.type = type;
+  result.nack_reason = nack_reason;
+  result.data = data;
+  result.error = error;
+  result.attempts = request->attempts;
+
+  if (request->pid == PID_DEVICE_INFO ||
+      request->pid == PID_SUPPORTED_PARAMETERS) {
+    if (type == RESULT_ACK) {
+      if (request->pid == PID_DEVICE_INFO) {
+        HandleDeviceInfo(device, data);
+      } else {
+        HandleSupportedParameters(device, data);
+      }
+    }
+    if (--device->identity_pending == 0) {
+      QueueIndexedPids(device);
+    }
+  }
+
+  delete request;
+  m_pending_requests--;
+  m_result_callback->Run(result);
+}
+
+
+void RDMCollector::HandleDeviceInfo(Device *device, const string &data) {
+  DeviceDescriptor device_info;
+  if (data.size() != sizeof(device_info)) {
+    OLA_WARN << "Invalid DEVICE_INFO size " << data.size() << " from "
+             << device->uid;
+    return;
+  }
+
+  memcpy(&device_info, data.data(), sizeof(device_info));
+  device->footprint = NetworkToHost(device_info.dmx_footprint);
+  device->personality_count = device_info.personality_count;
+  device->sensor_count = device_info.sensor_count;
+}
+
+
+void RDMCollector::HandleSupportedParameters(Device *device,
+                                             const string &data) {
+  static const set<uint16_t> skipped_pids(
+      SKIPPED_PIDS,
+      SKIPPED_PIDS + sizeof(SKIPPED_PIDS) / sizeof(SKIPPED_PIDS[0]));
+
+  for (unsigned int i = 0; i + 1 < data.size(); i += sizeof(uint16_t)) {
+    uint16_t pid;
+    memcpy(&pid, data.data() + i, sizeof(pid));
+    pid = NetworkToHost(pid);
+    device->supported_pids.insert(pid);
+    if (!STLContains(skipped_pids, pid)) {
+      QueueGet(device, pid);
+    }
+  }
+}
+
+
+/*
+ * Queue the requests for PIDs that take an index. This needs both DEVICE_INFO
+ * and SUPPORTED_PARAMETERS.
+ */
+void RDMCollector::QueueIndexedPids(Device *device) {
+  QueueIndexedGets(device, PID_DMX_PERSONALITY_DESCRIPTION, 1,
+                   device->personality_count, false);
+  QueueIndexedGets(device, PID_SLOT_DESCRIPTION, 0, device->footprint, true);
+  QueueIndexedGets(device, PID_SENSOR_DEFINITION, 0, device->sensor_count,
+                   false);
+  QueueIndexedGets(device, PID_SENSOR_VALUE, 0, device->sensor_count, false);
+
+  if (STLContains(device->supported_pids, PID_PARAMETER_DESCRIPTION)) {
+    set<uint16_t>::const_iterator iter = device->supported_pids.begin();
+    for (; iter != device->supported_pids.end(); ++iter) {
+      if (*iter >= 0x8000) {
+        QueueIndexedGets(device, PID_PARAMETER_DESCRIPTION, *iter, 1, true);
+      }
+    }
+  }
+}
+
+
+void RDMCollector::RunIdleCallbackIfIdle() {
+  if (m_pending_requests == 0 && m_idle_callback) {
+    m_idle_callback->Run();
+  }
+}
+}  // namespace rdm
+}  // namespace ola
@@ -0,0 +1,523 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMCollectorTest.cpp
+ * Test fixture for the RDMCollector.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMAPI.h"
+#include "ola/rdm/RDMAPIImplInterface.h"
+#include "ola/rdm/RDMCollector.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::MockClock;
+using ola::TimeInterval;
+using ola::io::SelectServer;
+using ola::network::HostToNetwork;
+using ola::rdm::RDMAPIImplInterface;
+using ola::rdm::RDMCollector;
+using ola::rdm::ResponseStatus;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::deque;
+using std::string;
+using std::vector;
+
+
+/*
+ * An RDMAPIImplInterface that holds on to requests until the test responds
+ * to them.
+ */
+class MockRDMAPIImpl: public RDMAPIImplInterface {
+ public:
+  struct Request {
+    Request() : universe(0), uid(0, 0), pid(0), callback(NULL) {}
+
+    unsigned int universe;
+    UID uid;
+    uint16_t pid;
+    string data;
+    rdm_pid_callback *callback;
+  };
+
+  ~MockRDMAPIImpl() {
+    deque<Request>::iterator iter = m_requests.begin();
+    for (; iter != m_requests.end(); ++iter) {
+      delete iter->callback;
+    }
+  }
+
+  bool RDMGet(rdm_callback *callback, unsigned int, const UID&, uint16_t,
+              uint16_t, const uint8_t*, unsigned int) {
+    delete callback;
+    OLA_FAIL("Unexpected call to RDMGet");
+    return false;
+  }
+
+  bool RDMGet(rdm_pid_callback *callback,
+              unsigned int universe,
+              const UID &uid,
+              uint16_t sub_device,
+              uint16_t pid,
+              const uint8_t *data,
+              unsigned int data_length) {
+    // There should only ever be one request outstanding per universe.
+    OLA_ASSERT_FALSE(HasRequest(universe));
+    OLA_ASSERT_EQ(ola::rdm::ROOT_RDM_DEVICE, sub_device);
+
+    Request request;
+    request.universe = universe;
+    request.uid = uid;
+    request.pid = pid;
+    request.data.assign(reinterpret_cast<const char*>(data), data_length);
+    request.callback = callback;
+    m_requests.push_back(request);
+    return true;
+  }
+
+  bool RDMSet(rdm_callback *callback, unsigned int, const UID&, uint16_t,
+              uint16_t, const uint8_t*, unsigned int) {
+    delete callback;
+    OLA_FAIL("Unexpected call to RDMSet");
+    return false;
+  }
+
+  bool Empty() const { return m_requests.empty(); }
+  unsigned int Size() const { return m_requests.size(); }
+  const Request &Front() const { return m_requests.front(); }
+
+  bool HasRequest(unsigned int universe) const {
+    deque<Request>::const_iterator iter = m_requests.begin();
+    for (; iter != m_requests.end(); ++iter) {
+      if (iter->universe == universe) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * Respond to the oldest request.
+   */
+  void Respond(const ResponseStatus &status, const string &data = "") {
+    Request request = m_requests.front();
+    m_requests.pop_front();
+    request.callback->Run(status, status.pid_value ? status.pid_value :
+                          request.pid, data);
+  }
+
+ private:
+  deque<Request> m_requests;
+};
+
+
+class RDMCollectorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMCollectorTest);
+  CPPUNIT_TEST(testCollection);
+  CPPUNIT_TEST(testAckTimer);
+  CPPUNIT_TEST(testQueuedIndexedPids);
+  CPPUNIT_TEST(testRetries);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMCollectorTest()
+      : m_ss(NULL, &m_clock),
+        m_idle_count(0) {
+  }
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    m_results.clear();
+    m_idle_count = 0;
+  }
+
+  void testCollection();
+  void testAckTimer();
+  void testQueuedIndexedPids();
+  void testRetries();
+
+ private:
+  MockClock m_clock;
+  SelectServer m_ss;
+  MockRDMAPIImpl m_api;
+  vector<RDMCollector::Result> m_results;
+  unsigned int m_idle_count;
+
+  RDMCollector *NewCollector() {
+    RDMCollector::Options options;
+    options.retry_delay = 50;
+    return new RDMCollector(
+        &m_api, &m_ss,
+        ola::NewCallback(this, &RDMCollectorTest::NewResult),
+        ola::NewCallback(this, &RDMCollectorTest::Idle),
+        options);
+  }
+
+  void NewResult(const RDMCollector::Result &result) {
+    m_results.push_back(result);
+  }
+
+  void Idle() {
+    m_idle_count++;
+  }
+
+  void AdvanceTime(unsigned int ms) {
+    m_clock.AdvanceTime(0, ms * 1000);
+    m_ss.RunOnce(TimeInterval(0, 0));
+  }
+
+  const RDMCollector::Result *FindResult(uint16_t pid) const {
+    vector<RDMCollector::Result>::const_iterator iter = m_results.begin();
+    for (; iter != m_results.end(); ++iter) {
+      if (iter->pid == pid) {
+        return &(*iter);
+      }
+    }
+    return NULL;
+  }
+
+  void RespondLikeADevice();
+
+  static ResponseStatus Status(uint8_t response_type, uint16_t param = 0) {
+    ResponseStatus status;
+    status.response_code = ola::rdm::RDM_COMPLETED_OK;
+    status.response_type = response_type;
+    status.message_count = 0;
+    status.m_param = param;
+    status.set_command = false;
+    status.pid_value = 0;
+    return status;
+  }
+
+  static ResponseStatus FailedStatus(ola::rdm::RDMStatusCode status_code) {
+    ResponseStatus status = Status(ola::rdm::RDM_ACK);
+    status.response_code = status_code;
+    return status;
+  }
+
+  static ResponseStatus QueuedStatus(uint8_t response_type, uint16_t pid) {
+    ResponseStatus status = Status(response_type);
+    status.pid_value = pid;
+    return status;
+  }
+
+  static string DeviceInfo(uint16_t footprint, uint8_t personality_count,
+                           uint8_t sensor_count) {
+    ola::rdm::DeviceDescriptor device_info;
+    memset(&device_info, 0, sizeof(device_info));
+    device_info.dmx_footprint = HostToNetwork(footprint);
+    device_info.personality_count = personality_count;
+    device_info.sensor_count = sensor_count;
+    return string(reinterpret_cast<const char*>(&device_info),
+                  sizeof(device_info));
+  }
+
+  static string PidList(const uint16_t *pids, unsigned int count) {
+    string data;
+    for (unsigned int i = 0; i < count; i++) {
+      uint16_t pid = HostToNetwork(pids[i]);
+      data.append(reinterpret_cast<const char*>(&pid), sizeof(pid));
+    }
+    return data;
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMCollectorTest);
+
+
+/*
+ * Respond to requests until there are none left.
+ */
+void RDMCollectorTest::RespondLikeADevice() {
+  static const uint16_t supported_pids[] = {
+    ola::rdm::PID_DEVICE_LABEL,
+    ola::rdm::PID_MANUFACTURER_LABEL,
+    ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION,
+    ola::rdm::PID_PARAMETER_DESCRIPTION,
+    ola::rdm::PID_SENSOR_VALUE,
+    ola::rdm::PID_RESET_DEVICE,
+    0x8001,
+  };
+
+  while (!m_api.Empty()) {
+    uint16_t pid = m_api.Front().pid;
+    if (pid == ola::rdm::PID_DEVICE_INFO) {
+      m_api.Respond(Status(ola::rdm::RDM_ACK), DeviceInfo(0, 2, 1));
+    } else if (pid == ola::rdm::PID_SUPPORTED_PARAMETERS) {
+      m_api.Respond(Status(ola::rdm::RDM_ACK),
+                    PidList(supported_pids, arraysize(supported_pids)));
+    } else {
+      m_api.Respond(Status(ola::rdm::RDM_ACK), "foo");
+    }
+  }
+}
+
+
+/*
+ * Check that every parameter is collected, and that the requests on each
+ * universe are sent in priority order.
+ */
+void RDMCollectorTest::testCollection() {
+  std::auto_ptr<RDMCollector> collector(NewCollector());
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  uids.AddUID(UID(0x7a70, 2));
+  collector->AddDevices(1, uids);
+  collector->AddDevice(2, UID(0x7a70, 3));
+  // Adding a device twice has no effect.
+  collector->AddDevice(2, UID(0x7a70, 3));
+
+  // One request per universe
+  OLA_ASSERT_EQ(2u, m_api.Size());
+  OLA_ASSERT_FALSE(collector->Idle());
+
+  RespondLikeADevice();
+  OLA_ASSERT_TRUE(collector->Idle());
+  OLA_ASSERT_EQ(1u, m_idle_count);
+
+  // DEVICE_INFO, SUPPORTED_PARAMETERS, SOFTWARE_VERSION_LABEL, DEVICE_LABEL,
+  // MANUFACTURER_LABEL, 0x8001, 2 x DMX_PERSONALITY_DESCRIPTION,
+  // 1 x SENSOR_VALUE & PARAMETER_DESCRIPTION.
+  OLA_ASSERT_EQ(30u, static_cast<unsigned int>(m_results.size()));
+
+  std::map<unsigned int, RDMCollector::PidClass> last_class;
+  unsigned int personality_descriptions = 0;
+  vector<RDMCollector::Result>::const_iterator iter = m_results.begin();
+  for (; iter != m_results.end(); ++iter) {
+    OLA_ASSERT_EQ(RDMCollector::RESULT_ACK, iter->type);
+    OLA_ASSERT_EQ(1u, iter->attempts);
+    OLA_ASSERT_TRUE(iter->pid != ola::rdm::PID_RESET_DEVICE);
+
+    // The classes are non-decreasing on each universe.
+    if (last_class.find(iter->universe) != last_class.end()) {
+      OLA_ASSERT_TRUE(last_class[iter->universe] <= iter->pid_class);
+    }
+    last_class[iter->universe] = iter->pid_class;
+
+    if (iter->pid == ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION &&
+        iter->uid == UID(0x7a70, 3)) {
+      personality_descriptions++;
+      OLA_ASSERT_EQ(string(1, static_cast<char>(personality_descriptions)),
+                    iter->request_data);
+    }
+  }
+  OLA_ASSERT_EQ(2u, personality_descriptions);
+
+  const RDMCollector::Result *result = FindResult(
+      ola::rdm::PID_PARAMETER_DESCRIPTION);
+  OLA_ASSERT_NOT_NULL(result);
+  OLA_ASSERT_EQ(string("\x80\x01", 2), result->request_data);
+  OLA_ASSERT_EQ(30u, collector->GetStats().ack_count);
+}
+
+
+/*
+ * Check ACK_TIMER responses are collected with QUEUED_MESSAGE, and that other
+ * requests continue in the meantime.
+ */
+void RDMCollectorTest::testAckTimer() {
+  std::auto_ptr<RDMCollector> collector(NewCollector());
+  collector->AddDevice(1, UID(0x7a70, 1));
+
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_DEVICE_INFO),
+                m_api.Front().pid);
+  m_api.Respond(Status(ola::rdm::RDM_ACK_TIMER, 2));
+
+  // SUPPORTED_PARAMETERS is sent while we wait.
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_SUPPORTED_PARAMETERS),
+                m_api.Front().pid);
+  m_api.Respond(Status(ola::rdm::RDM_NACK_REASON, ola::rdm::NR_UNKNOWN_PID));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_SOFTWARE_VERSION_LABEL),
+                m_api.Front().pid);
+  m_api.Respond(Status(ola::rdm::RDM_ACK), "1.0");
+  OLA_ASSERT_TRUE(m_api.Empty());
+  OLA_ASSERT_EQ(2u, static_cast<unsigned int>(m_results.size()));
+
+  // The ack timer was 200ms
+  AdvanceTime(100);
+  OLA_ASSERT_TRUE(m_api.Empty());
+  AdvanceTime(100);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_QUEUED_MESSAGE),
+                m_api.Front().pid);
+  OLA_ASSERT_EQ(string(1, ola::rdm::STATUS_ADVISORY), m_api.Front().data);
+
+  // Not ready yet.
+  m_api.Respond(QueuedStatus(ola::rdm::RDM_ACK,
+                             ola::rdm::PID_STATUS_MESSAGES));
+  OLA_ASSERT_TRUE(m_api.Empty());
+  AdvanceTime(50);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_QUEUED_MESSAGE),
+                m_api.Front().pid);
+  m_api.Respond(QueuedStatus(ola::rdm::RDM_ACK, ola::rdm::PID_DEVICE_INFO),
+                DeviceInfo(0, 1, 0));
+
+  OLA_ASSERT_TRUE(collector->Idle());
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(m_results.size()));
+  const RDMCollector::Result *result = FindResult(ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_NOT_NULL(result);
+  OLA_ASSERT_EQ(RDMCollector::RESULT_ACK, result->type);
+  OLA_ASSERT_EQ(DeviceInfo(0, 1, 0), result->data);
+
+  result = FindResult(ola::rdm::PID_SUPPORTED_PARAMETERS);
+  OLA_ASSERT_NOT_NULL(result);
+  OLA_ASSERT_EQ(RDMCollector::RESULT_NACK, result->type);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::NR_UNKNOWN_PID),
+                result->nack_reason);
+
+  const RDMCollector::Stats &stats = collector->GetStats();
+  OLA_ASSERT_EQ(1u, stats.ack_timer_count);
+  OLA_ASSERT_EQ(2u, stats.queued_message_count);
+}
+
+
+/*
+ * Check queued responses for an indexed PID are matched to the request with
+ * the same index, even if they arrive in a different order.
+ */
+void RDMCollectorTest::testQueuedIndexedPids() {
+  static const uint16_t supported_pids[] = {ola::rdm::PID_SENSOR_VALUE};
+  std::auto_ptr<RDMCollector> collector(NewCollector());
+  collector->AddDevice(1, UID(0x7a70, 1));
+
+  m_api.Respond(Status(ola::rdm::RDM_ACK), DeviceInfo(0, 0, 2));
+  m_api.Respond(Status(ola::rdm::RDM_ACK),
+                PidList(supported_pids, arraysize(supported_pids)));
+  m_api.Respond(Status(ola::rdm::RDM_ACK), "1.0");
+
+  // Both SENSOR_VALUE requests are ACK_TIMER'ed.
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_SENSOR_VALUE),
+                m_api.Front().pid);
+  OLA_ASSERT_EQ(string(1, 0), m_api.Front().data);
+  m_api.Respond(Status(ola::rdm::RDM_ACK_TIMER, 1));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_SENSOR_VALUE),
+                m_api.Front().pid);
+  OLA_ASSERT_EQ(string(1, 1), m_api.Front().data);
+  m_api.Respond(Status(ola::rdm::RDM_ACK_TIMER, 1));
+  OLA_ASSERT_TRUE(m_api.Empty());
+
+  // The responses come back in the reverse order.
+  const string sensor0 = string(1, 0) + "sensor 0";
+  const string sensor1 = string(1, 1) + "sensor 1";
+  AdvanceTime(100);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_QUEUED_MESSAGE),
+                m_api.Front().pid);
+  m_api.Respond(QueuedStatus(ola::rdm::RDM_ACK, ola::rdm::PID_SENSOR_VALUE),
+                sensor1);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_QUEUED_MESSAGE),
+                m_api.Front().pid);
+  m_api.Respond(QueuedStatus(ola::rdm::RDM_ACK, ola::rdm::PID_SENSOR_VALUE),
+                sensor0);
+  OLA_ASSERT_TRUE(m_api.Empty());
+  OLA_ASSERT_TRUE(collector->Idle());
+
+  OLA_ASSERT_EQ(5u, static_cast<unsigned int>(m_results.size()));
+  unsigned int sensor_values = 0;
+  vector<RDMCollector::Result>::const_iterator iter = m_results.begin();
+  for (; iter != m_results.end(); ++iter) {
+    if (iter->pid != ola::rdm::PID_SENSOR_VALUE) {
+      continue;
+    }
+    sensor_values++;
+    OLA_ASSERT_EQ(RDMCollector::RESULT_ACK, iter->type);
+    OLA_ASSERT_EQ(iter->request_data == string(1, 0) ? sensor0 : sensor1,
+                  iter->data);
+  }
+  OLA_ASSERT_EQ(2u, sensor_values);
+  OLA_ASSERT_EQ(2u, collector->GetStats().ack_timer_count);
+  OLA_ASSERT_EQ(2u, collector->GetStats().queued_message_count);
+}
+
+
+/*
+ * Check failed requests and transient NACKs are retried.
+ */
+void RDMCollectorTest::testRetries() {
+  std::auto_ptr<RDMCollector> collector(NewCollector());
+  collector->AddDevice(1, UID(0x7a70, 1));
+
+  // DEVICE_INFO times out twice, then succeeds.
+  m_api.Respond(FailedStatus(ola::rdm::RDM_TIMEOUT));
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_SUPPORTED_PARAMETERS),
+                m_api.Front().pid);
+
+  // SUPPORTED_PARAMETERS times out three times and fails.
+  m_api.Respond(FailedStatus(ola::rdm::RDM_TIMEOUT));
+  // SOFTWARE_VERSION_LABEL is NACKed with a proxy buffer full.
+  m_api.Respond(Status(ola::rdm::RDM_NACK_REASON,
+                       ola::rdm::NR_PROXY_BUFFER_FULL));
+  OLA_ASSERT_TRUE(m_api.Empty());
+
+  AdvanceTime(50);
+  // The retries go out in priority order.
+  OLA_ASSERT_EQ(static_cast<uint16_t>(ola::rdm::PID_DEVICE_INFO),
+                m_api.Front().pid);
+  m_api.Respond(FailedStatus(ola::rdm::RDM_CHECKSUM_INCORRECT));
+  m_api.Respond(FailedStatus(ola::rdm::RDM_TIMEOUT));
+  m_api.Respond(Status(ola::rdm::RDM_ACK), "label");
+  OLA_ASSERT_TRUE(m_api.Empty());
+
+  AdvanceTime(50);
+  m_api.Respond(Status(ola::rdm::RDM_ACK), DeviceInfo(0, 1, 0));
+  m_api.Respond(FailedStatus(ola::rdm::RDM_TIMEOUT));
+  OLA_ASSERT_TRUE(m_api.Empty());
+  OLA_ASSERT_TRUE(collector->Idle());
+  OLA_ASSERT_EQ(1u, m_idle_count);
+
+  OLA_ASSERT_EQ(3u, static_cast<unsigned int>(m_results.size()));
+  const RDMCollector::Result *result = FindResult(ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_EQ(RDMCollector::RESULT_ACK, result->type);
+  OLA_ASSERT_EQ(3u, result->attempts);
+
+  result = FindResult(ola::rdm::PID_SUPPORTED_PARAMETERS);
+  OLA_ASSERT_EQ(RDMCollector::RESULT_FAILED, result->type);
+  OLA_ASSERT_EQ(3u, result->attempts);
+  OLA_ASSERT_FALSE(result->error.empty());
+
+  result = FindResult(ola::rdm::PID_SOFTWARE_VERSION_LABEL);
+  OLA_ASSERT_EQ(RDMCollector::RESULT_ACK, result->type);
+  OLA_ASSERT_EQ(string("label"), result->data);
+  OLA_ASSERT_EQ(2u, result->attempts);
+
+  // RPC errors aren't retried.
+  collector->AddDevice(1, UID(0x7a70, 2));
+  ResponseStatus status = Status(ola::rdm::RDM_ACK);
+  status.error = "Connection closed";
+  while (!m_api.Empty()) {
+    m_api.Respond(status);
+  }
+  OLA_ASSERT_TRUE(collector->Idle());
+  OLA_ASSERT_EQ(6u, static_cast<unsigned int>(m_results.size()));
+  OLA_ASSERT_EQ(string("Connection closed"), m_results.back().error);
+  OLA_ASSERT_EQ(5u, collector->GetStats().retry_count);
+}
@@ -38,6 +38,7 @@ class UIDTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUIDInequalities);
   CPPUNIT_TEST(testUIDSet);
   CPPUNIT_TEST(testUIDSetUnion);
+  CPPUNIT_TEST(testUIDSetOrdering);
   CPPUNIT_TEST(testUIDParse);
   CPPUNIT_TEST(testDirectedToUID);
   CPPUNIT_TEST_SUITE_END();
@@ -47,6 +48,7 @@ class UIDTest: public CppUnit::TestFixture {
     void testUIDInequalities();
     void testUIDSet();
     void testUIDSetUnion();
+    void testUIDSetOrdering();
     void testUIDParse();
     void testDirectedToUID();
 };
@@ -252,6 +254,47 @@ void UIDTest::testUIDSetUnion() {
 }
 
 
+/*
+ * Check the UIDSet stays sorted when UIDs are added out of order.
+ */
+void UIDTest::testUIDSetOrdering() {
+  UIDSet set1, set2;
+  UID uid1(1, 2);
+  UID uid2(1, 10);
+  UID uid3(2, 1);
+  UID uid4(0xffff, 0);
+
+  set1.AddUID(uid3);
+  set1.AddUID(uid1);
+  set1.AddUID(uid4);
+  set1.AddUID(uid2);
+  set1.AddUID(uid1);
+  OLA_ASSERT_EQ(4u, set1.Size());
+  OLA_ASSERT_EQ(string("0001:00000002,0001:0000000a,0002:00000001,"
+                       "ffff:00000000"),
+                set1.ToString());
+
+  set2.AddUID(uid4);
+  set2.AddUID(uid2);
+  set2.AddUID(uid3);
+  set2.AddUID(uid1);
+  OLA_ASSERT_EQ(set1, set2);
+
+  // removing a UID that isn't in the set is a no-op
+  set2.RemoveUID(uid3);
+  set2.RemoveUID(uid3);
+  set2.RemoveUID(UID(3, 3));
+  OLA_ASSERT_EQ(3u, set2.Size());
+  OLA_ASSERT_FALSE(set2.Contains(uid3));
+  OLA_ASSERT_TRUE(set1 != set2);
+
+  UIDSet difference = set1.SetDifference(set2);
+  OLA_ASSERT_EQ(string("0002:00000001"), difference.ToString());
+  OLA_ASSERT_EQ(set1, set2.Union(difference));
+  OLA_ASSERT_EQ(set1, difference.Union(set2));
+}
+
+
 /*
  * Test UID parsing
  */
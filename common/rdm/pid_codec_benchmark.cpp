@@ -0,0 +1,200 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * pid_codec_benchmark.cpp
+ * Compare the PidCodec with the MessageDeserializer.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/messaging/Descriptor.h"
+#include "ola/messaging/Message.h"
+#include "ola/rdm/MessageDeserializer.h"
+#include "ola/rdm/PidCodec.h"
+#include "ola/rdm/PidStore.h"
+#include "ola/rdm/RDMCommandSerializer.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::messaging::Message;
+using ola::rdm::MessageDeserializer;
+using ola::rdm::PidCodec;
+using ola::rdm::PidCodecStore;
+using ola::rdm::PidCodecVisitor;
+using ola::rdm::PidDescriptor;
+using ola::rdm::RootPidStore;
+using std::auto_ptr;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_string(pid_location, "",
+              "The directory containing the PID definitions.");
+DEFINE_s_uint32(iterations, i, 100000, "The number of times to decode each "
+                "response.");
+
+/**
+ * A visitor that sums the integer fields, so the decoding can't be optimized
+ * away.
+ */
+class SummingVisitor: public PidCodecVisitor {
+ public:
+  SummingVisitor() : m_sum(0) {}
+
+  uint64_t Sum() const { return m_sum; }
+
+  void Visit(const ola::messaging::StringFieldDescriptor*, const char*,
+             unsigned int length) {
+    m_sum += length;
+  }
+  void Visit(const ola::messaging::UInt8FieldDescriptor*, uint8_t value) {
+    m_sum += value;
+  }
+  void Visit(const ola::messaging::UInt16FieldDescriptor*, uint16_t value) {
+    m_sum += value;
+  }
+  void Visit(const ola::messaging::UInt32FieldDescriptor*, uint32_t value) {
+    m_sum += value;
+  }
+
+ private:
+  uint64_t m_sum;
+};
+
+/*
+ * Build some parameter data for a descriptor. This uses the longest data the
+ * descriptor accepts, which is the worst case for both decoders.
+ */
+bool BuildData(const PidCodec *codec, vector<uint8_t> *data) {
+  const int max_length = ola::rdm::RDMCommandSerializer::MAX_PARAM_DATA_LENGTH;
+  for (int length = max_length; length >= 0; length--) {
+    if (codec->ValidLength(length)) {
+      data->resize(length);
+      for (int i = 0; i < length; i++) {
+        (*data)[i] = 'a' + (i % 26);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void RunBenchmark(const PidDescriptor *pid, const PidCodec *codec) {
+  vector<uint8_t> data;
+  if (!BuildData(codec, &data)) {
+    return;
+  }
+  const uint8_t *param_data = data.empty() ? NULL : &data[0];
+
+  Clock clock;
+  TimeStamp start, end;
+  MessageDeserializer deserializer;
+
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    auto_ptr<const Message> message(deserializer.InflateMessage(
+        codec->GetDescriptor(), param_data, data.size()));
+  }
+  clock.CurrentTime(&end);
+  TimeInterval deserializer_time = end - start;
+
+  SummingVisitor visitor;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    codec->Decode(param_data, data.size(), &visitor);
+  }
+  clock.CurrentTime(&end);
+  TimeInterval codec_time = end - start;
+  OLA_DEBUG << pid->Name() << " checksum " << visitor.Sum();
+
+  double deserializer_ns = deserializer_time.AsInt() * 1000.0 /
+      FLAGS_iterations;
+  double codec_ns = codec_time.AsInt() * 1000.0 / FLAGS_iterations;
+  cout << std::left << std::setw(28) << pid->Name() << std::right
+       << std::setw(5) << data.size() << std::fixed << std::setprecision(1)
+       << std::setw(14) << deserializer_ns << std::setw(14) << codec_ns
+       << std::setw(9) << (codec_ns > 0 ? deserializer_ns / codec_ns : 0)
+       << "x" << endl;
+}
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Compare the time taken to decode RDM responses using the "
+               "MessageDeserializer and the PidCodec.");
+
+  if (FLAGS_iterations == 0) {
+    return -1;
+  }
+
+  auto_ptr<const RootPidStore> pid_store(
+      RootPidStore::LoadFromDirectory(FLAGS_pid_location.str()));
+  if (!pid_store.get()) {
+    OLA_WARN << "Failed to load the PID store";
+    return -1;
+  }
+
+  Clock clock;
+  TimeStamp start, end;
+  PidCodecStore codec_store;
+  clock.CurrentTime(&start);
+  codec_store.AddRootPidStore(pid_store.get());
+  clock.CurrentTime(&end);
+  cout << "Compiled " << codec_store.CodecCount() << " codecs in "
+       << (end - start) << endl;
+
+  const char *pid_names[] = {
+    "DEVICE_INFO",
+    "SUPPORTED_PARAMETERS",
+    "PARAMETER_DESCRIPTION",
+    "DEVICE_LABEL",
+    "SENSOR_DEFINITION",
+    "SENSOR_VALUE",
+    "SLOT_INFO",
+    "STATUS_MESSAGES",
+  };
+
+  cout << std::left << std::setw(28) << "PID" << std::right << std::setw(5)
+       << "size" << std::setw(14) << "deserializer" << std::setw(14)
+       << "codec" << std::setw(10) << "speedup" << endl;
+  cout << std::setw(28) << "" << std::setw(5) << "" << std::setw(14)
+       << "(ns/msg)" << std::setw(14) << "(ns/msg)" << endl;
+
+  for (unsigned int i = 0; i < sizeof(pid_names) / sizeof(pid_names[0]);
+       i++) {
+    const PidDescriptor *pid = pid_store->GetDescriptor(pid_names[i]);
+    if (!pid || !pid->GetResponse()) {
+      OLA_WARN << "Missing response descriptor for " << pid_names[i];
+      continue;
+    }
+    const PidCodec *codec = codec_store.Lookup(pid->GetResponse());
+    if (!codec) {
+      OLA_WARN << "No codec for " << pid_names[i];
+      continue;
+    }
+    RunBenchmark(pid, codec);
+  }
+  return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.cpp
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <string>
+#include "ola/web/JsonStreamWriter.h"
+
+namespace ola {
+namespace web {
+
+using std::string;
+
+const unsigned int JsonStreamWriter::K_DEFAULT_FLUSH_SIZE;
+
+JsonStreamWriter::JsonStreamWriter(string *output)
+    : m_output(NULL),
+      m_flush_size(0),
+      m_buffer(output),
+      m_after_key(false) {
+}
+
+JsonStreamWriter::JsonStreamWriter(ola::io::OutputBufferInterface *output,
+                                   unsigned int flush_size)
+    : m_output(output),
+      m_flush_size(flush_size),
+      m_buffer(&m_local_buffer),
+      m_after_key(false) {
+  // Leave room for the token that takes us over the flush size.
+  m_local_buffer.reserve(flush_size + 256);
+}
+
+JsonStreamWriter::~JsonStreamWriter() {
+  Flush();
+}
+
+void JsonStreamWriter::StartObject() {
+  BeforeValue();
+  m_buffer->push_back('{');
+  m_needs_comma.push_back(false);
+}
+
+void JsonStreamWriter::EndObject() {
+  m_buffer->push_back('}');
+  m_needs_comma.pop_back();
+  AfterValue();
+}
+
+void JsonStreamWriter::StartArray() {
+  BeforeValue();
+  m_buffer->push_back('[');
+  m_needs_comma.push_back(false);
+}
+
+void JsonStreamWriter::EndArray() {
+  m_buffer->push_back(']');
+  m_needs_comma.pop_back();
+  AfterValue();
+}
+
+void JsonStreamWriter::Key(const string &key) {
+  BeforeValue();
+  AppendQuotedString(key, m_buffer);
+  m_buffer->push_back(':');
+  m_after_key = true;
+}
+
+void JsonStreamWriter::String(const string &value) {
+  BeforeValue();
+  AppendQuotedString(value, m_buffer);
+  AfterValue();
+}
+
+void JsonStreamWriter::String(const char *value) {
+  String(string(value));
+}
+
+void JsonStreamWriter::Bool(bool value) {
+  BeforeValue();
+  m_buffer->append(value ? "true" : "false");
+  AfterValue();
+}
+
+void JsonStreamWriter::Null() {
+  BeforeValue();
+  m_buffer->append("null");
+  AfterValue();
+}
+
+void JsonStreamWriter::Int(int32_t value) {
+  Int64(value);
+}
+
+void JsonStreamWriter::UInt(uint32_t value) {
+  UInt64(value);
+}
+
+void JsonStreamWriter::Int64(int64_t value) {
+  BeforeValue();
+  if (value < 0) {
+    m_buffer->push_back('-');
+    // Negate as unsigned so INT64_MIN works.
+    AppendUInt64(-static_cast<uint64_t>(value));
+  } else {
+    AppendUInt64(value);
+  }
+  AfterValue();
+}
+
+void JsonStreamWriter::UInt64(uint64_t value) {
+  BeforeValue();
+  AppendUInt64(value);
+  AfterValue();
+}
+
+void JsonStreamWriter::Raw(const string &value) {
+  BeforeValue();
+  m_buffer->append(value);
+  AfterValue();
+}
+
+void JsonStreamWriter::StartObject(const string &key) {
+  Key(key);
+  StartObject();
+}
+
+void JsonStreamWriter::StartArray(const string &key) {
+  Key(key);
+  StartArray();
+}
+
+void JsonStreamWriter::Add(const string &key, const string &value) {
+  Key(key);
+  String(value);
+}
+
+void JsonStreamWriter::Add(const string &key, const char *value) {
+  Key(key);
+  String(value);
+}
+
+void JsonStreamWriter::Add(const string &key, bool value) {
+  Key(key);
+  Bool(value);
+}
+
+void JsonStreamWriter::Add(const string &key, int32_t value) {
+  Key(key);
+  Int64(value);
+}
+
+void JsonStreamWriter::Add(const string &key, uint32_t value) {
+  Key(key);
+  UInt64(value);
+}
+
+void JsonStreamWriter::Add(const string &key, int64_t value) {
+  Key(key);
+  Int64(value);
+}
+
+void JsonStreamWriter::Add(const string &key, uint64_t value) {
+  Key(key);
+  UInt64(value);
+}
+
+void JsonStreamWriter::Flush() {
+  if (!m_output || m_buffer->empty()) {
+    return;
+  }
+  m_output->Write(reinterpret_cast<const uint8_t*>(m_buffer->data()),
+                  m_buffer->size());
+  m_buffer->clear();
+}
+
+void JsonStreamWriter::AppendQuotedString(const string &input,
+                                          string *output) {
+  static const char HEX[] = "0123456789abcdef";
+
+  output->push_back('"');
+  string::const_iterator iter = input.begin();
+  for (; iter != input.end(); ++iter) {
+    const uint8_t c = static_cast<uint8_t>(*iter);
+    switch (c) {
+      case '"':
+        output->append("\\\"");
+        break;
+      case '\\':
+        output->append("\\\\");
+        break;
+      case '\b':
+        output->append("\\b");
+        break;
+      case '\f':
+        output->append("\\f");
+        break;
+      case '\n':
+        output->append("\\n");
+        break;
+      case '\r':
+        output->append("\\r");
+        break;
+      case '\t':
+        output->append("\\t");
+        break;
+      default:
+        if (c < 0x20) {
+          output->append("\\u00");
+          output->push_back(HEX[c >> 4]);
+          output->push_back(HEX[c & 0x0f]);
+        } else {
+          // UTF-8 sequences are copied as is.
+          output->push_back(c);
+        }
+    }
+  }
+  output->push_back('"');
+}
+
+void JsonStreamWriter::BeforeValue() {
+  if (m_after_key) {
+    m_after_key = false;
+    return;
+  }
+  if (!m_needs_comma.empty()) {
+    if (m_needs_comma.back()) {
+      m_buffer->push_back(',');
+    } else {
+      m_needs_comma.back() = true;
+    }
+  }
+}
+
+void JsonStreamWriter::AfterValue() {
+  if (m_output && m_buffer->size() >= m_flush_size) {
+    Flush();
+  }
+}
+
+void JsonStreamWriter::AppendUInt64(uint64_t value) {
+  char digits[20];
+  unsigned int i = sizeof(digits);
+  do {
+    digits[--i] = '0' + (value % 10);
+    value /= 10;
+  } while (value);
+  m_buffer->append(digits + i, sizeof(digits) - i);
+}
+}  // namespace web
+}  // namespace ola
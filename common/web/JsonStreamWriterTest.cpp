@@ -0,0 +1,255 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriterTest.cpp
+ * Unittest for the JsonStreamWriter.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/StringUtils.h"
+#include "ola/io/IOQueue.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonParser.h"
+#include "ola/web/JsonStreamWriter.h"
+
+using ola::io::IOQueue;
+using ola::web::JsonObject;
+using ola::web::JsonParser;
+using ola::web::JsonStreamWriter;
+using ola::web::JsonValue;
+using std::auto_ptr;
+using std::string;
+
+class JsonStreamWriterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(JsonStreamWriterTest);
+  CPPUNIT_TEST(testValues);
+  CPPUNIT_TEST(testIntegers);
+  CPPUNIT_TEST(testEscaping);
+  CPPUNIT_TEST(testObjectsAndArrays);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST(testFlush);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testValues();
+    void testIntegers();
+    void testEscaping();
+    void testObjectsAndArrays();
+    void testParse();
+    void testFlush();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(JsonStreamWriterTest);
+
+/*
+ * Test writing a single value.
+ */
+void JsonStreamWriterTest::testValues() {
+  string output;
+  {
+    JsonStreamWriter writer(&output);
+    writer.String("foo");
+  }
+  OLA_ASSERT_EQ(string("\"foo\""), output);
+
+  output.clear();
+  {
+    JsonStreamWriter writer(&output);
+    writer.StartArray();
+    writer.Bool(true);
+    writer.Bool(false);
+    writer.Null();
+    writer.Raw("1.5");
+    writer.String(string(""));
+    writer.EndArray();
+  }
+  OLA_ASSERT_EQ(string("[true,false,null,1.5,\"\"]"), output);
+}
+
+
+/*
+ * Test the integer types, including the limits.
+ */
+void JsonStreamWriterTest::testIntegers() {
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartArray();
+  writer.Int(0);
+  writer.Int(-10);
+  writer.UInt(4294967295u);
+  writer.Int(-2147483647 - 1);
+  writer.Int64(-9223372036854775807LL - 1);
+  writer.UInt64(18446744073709551615ULL);
+  writer.EndArray();
+  OLA_ASSERT_EQ(
+      string("[0,-10,4294967295,-2147483648,-9223372036854775808,"
+             "18446744073709551615]"),
+      output);
+}
+
+
+/*
+ * Check strings are escaped as required by RFC 7159.
+ */
+void JsonStreamWriterTest::testEscaping() {
+  string output;
+  JsonStreamWriter::AppendQuotedString("a\"b\\c/d", &output);
+  OLA_ASSERT_EQ(string("\"a\\\"b\\\\c/d\""), output);
+
+  output.clear();
+  JsonStreamWriter::AppendQuotedString("\b\f\n\r\t", &output);
+  OLA_ASSERT_EQ(string("\"\\b\\f\\n\\r\\t\""), output);
+
+  output.clear();
+  JsonStreamWriter::AppendQuotedString(string("\x01\x1f\x00", 3), &output);
+  OLA_ASSERT_EQ(string("\"\\u0001\\u001f\\u0000\""), output);
+
+  // UTF-8 is passed through
+  output.clear();
+  JsonStreamWriter::AppendQuotedString("caf\xc3\xa9", &output);
+  OLA_ASSERT_EQ(string("\"caf\xc3\xa9\""), output);
+
+  // keys are escaped as well
+  output.clear();
+  JsonStreamWriter writer(&output);
+  writer.StartObject();
+  writer.Add("a\nb", "\"");
+  writer.EndObject();
+  OLA_ASSERT_EQ(string("{\"a\\nb\":\"\\\"\"}"), output);
+}
+
+
+/*
+ * Test nesting.
+ */
+void JsonStreamWriterTest::testObjectsAndArrays() {
+  string output;
+  JsonStreamWriter writer(&output);
+  writer.StartObject();
+  OLA_ASSERT_EQ(1u, writer.Depth());
+  writer.Add("universe", 1u);
+  writer.StartArray("empty");
+  writer.EndArray();
+  writer.StartObject("empty_object");
+  writer.EndObject();
+  writer.StartArray("uids");
+  writer.StartObject();
+  writer.Add("uid", "7a70:00000001");
+  writer.Add("device_id", static_cast<uint32_t>(1));
+  writer.EndObject();
+  writer.StartObject();
+  writer.Add("uid", string("7a70:00000002"));
+  writer.Add("active", false);
+  writer.EndObject();
+  writer.StartArray();
+  writer.StartArray();
+  writer.EndArray();
+  writer.EndArray();
+  writer.EndArray();
+  writer.Add("error", "");
+  writer.EndObject();
+  OLA_ASSERT_EQ(0u, writer.Depth());
+
+  OLA_ASSERT_EQ(
+      string("{\"universe\":1,\"empty\":[],\"empty_object\":{},"
+             "\"uids\":[{\"uid\":\"7a70:00000001\",\"device_id\":1},"
+             "{\"uid\":\"7a70:00000002\",\"active\":false},[[]]],"
+             "\"error\":\"\"}"),
+      output);
+}
+
+
+/*
+ * Check the output can be read back by the JsonParser.
+ */
+void JsonStreamWriterTest::testParse() {
+  string output;
+  {
+    JsonStreamWriter writer(&output);
+    writer.StartObject();
+    writer.Add("name", "tab\there \"quoted\"");
+    writer.Add("id", -5);
+    writer.StartArray("list");
+    for (unsigned int i = 0; i < 10; i++) {
+      writer.UInt(i);
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+
+  string error;
+  auto_ptr<JsonValue> value(JsonParser::Parse(output, &error));
+  OLA_ASSERT_NOT_NULL(value.get());
+  OLA_ASSERT_EQ(string(""), error);
+
+  JsonObject expected;
+  expected.Add("name", "tab\there \"quoted\"");
+  expected.Add("id", -5);
+  ola::web::JsonArray *list = expected.AddArray("list");
+  for (unsigned int i = 0; i < 10; i++) {
+    list->Append(i);
+  }
+  OLA_ASSERT_TRUE(expected == *value.get());
+}
+
+
+/*
+ * Check the data is written to the output buffer as the size is reached.
+ */
+void JsonStreamWriterTest::testFlush() {
+  IOQueue queue;
+  string expected = "[";
+  {
+    JsonStreamWriter writer(&queue, 16);
+    writer.StartArray();
+    OLA_ASSERT_TRUE(queue.Empty());
+
+    for (unsigned int i = 0; i < 100; i++) {
+      writer.UInt(i);
+      if (i) {
+        expected.push_back(',');
+      }
+      expected.append(ola::strings::IntToString(i));
+      // the writer holds back less than the flush size
+      OLA_ASSERT_TRUE(expected.size() - queue.Size() < 16);
+    }
+    writer.EndArray();
+    expected.push_back(']');
+  }
+  OLA_ASSERT_EQ(static_cast<unsigned int>(expected.size()), queue.Size());
+
+  string output;
+  queue.Read(&output, queue.Size());
+  OLA_ASSERT_EQ(expected, output);
+
+  // Flush() writes everything
+  IOQueue queue2;
+  {
+    JsonStreamWriter writer(&queue2);
+    writer.StartObject();
+    writer.Add("a", true);
+    writer.EndObject();
+    OLA_ASSERT_TRUE(queue2.Empty());
+    writer.Flush();
+    OLA_ASSERT_EQ(10u, queue2.Size());
+  }
+  OLA_ASSERT_EQ(10u, queue2.Size());
+}
@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * json_writer_benchmark.cpp
+ * Compare the JsonWriter with the JsonStreamWriter.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/io/IOQueue.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
+#include "ola/web/JsonWriter.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::IOQueue;
+using ola::web::JsonArray;
+using ola::web::JsonObject;
+using ola::web::JsonStreamWriter;
+using ola::web::JsonWriter;
+using std::cout;
+using std::endl;
+using std::string;
+
+DEFINE_s_uint32(iterations, i, 1000, "The number of responses to build.");
+DEFINE_s_uint32(uids, u, 1000, "The number of UIDs in each response.");
+
+/*
+ * Count the allocations made while building the responses.
+ */
+static uint64_t allocation_count = 0;
+
+void *operator new(size_t size) {
+  allocation_count++;
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) throw() {
+  free(ptr);
+}
+
+/*
+ * Build a response in the same format as /json/rdm/uids.
+ */
+unsigned int DomResponse() {
+  JsonObject json;
+  json.Add("universe", 1);
+  JsonArray *json_uids = json.AddArray("uids");
+  for (unsigned int i = 0; i < FLAGS_uids; i++) {
+    JsonObject *json_uid = json_uids->AppendObject();
+    json_uid->Add("manufacturer_id", 0x7a70);
+    json_uid->Add("device_id", i);
+    json_uid->Add("device", "Dummy Device");
+    json_uid->Add("manufacturer", "Open Lighting");
+    json_uid->Add("uid", "7a70:00000000");
+  }
+  return JsonWriter::AsString(json).size();
+}
+
+void StreamResponse(JsonStreamWriter *json) {
+  json->StartObject();
+  json->Add("universe", 1);
+  json->StartArray("uids");
+  for (unsigned int i = 0; i < FLAGS_uids; i++) {
+    json->StartObject();
+    json->Add("manufacturer_id", 0x7a70);
+    json->Add("device_id", i);
+    json->Add("device", "Dummy Device");
+    json->Add("manufacturer", "Open Lighting");
+    json->Add("uid", "7a70:00000000");
+    json->EndObject();
+  }
+  json->EndArray();
+  json->EndObject();
+}
+
+unsigned int StringResponse() {
+  string output;
+  JsonStreamWriter json(&output);
+  StreamResponse(&json);
+  return output.size();
+}
+
+unsigned int IOQueueResponse() {
+  IOQueue queue;
+  {
+    JsonStreamWriter json(&queue);
+    StreamResponse(&json);
+  }
+  return queue.Size();
+}
+
+void RunBenchmark(const string &name, unsigned int (*build)()) {
+  Clock clock;
+  TimeStamp start, end;
+  uint64_t bytes = 0;
+
+  const uint64_t allocations_before = allocation_count;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < FLAGS_iterations; i++) {
+    bytes += build();
+  }
+  clock.CurrentTime(&end);
+  const uint64_t allocations = allocation_count - allocations_before;
+
+  const double seconds = (end - start).AsInt() / 1000000.0;
+  cout << std::left << std::setw(18) << name << std::right << std::fixed
+       << std::setprecision(1)
+       << std::setw(12) << static_cast<double>(bytes) / FLAGS_iterations
+       << std::setw(12)
+       << (seconds > 0 ? bytes / seconds / (1024 * 1024) : 0)
+       << std::setw(14)
+       << static_cast<double>(allocations) / FLAGS_iterations << endl;
+}
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Compare the cost of building a UID list response with the "
+               "JsonValue classes and with the JsonStreamWriter.");
+
+  if (FLAGS_iterations == 0) {
+    return -1;
+  }
+
+  cout << std::left << std::setw(18) << "writer" << std::right
+       << std::setw(12) << "bytes" << std::setw(12) << "MB/s"
+       << std::setw(14) << "allocs/resp" << endl;
+  RunBenchmark("JsonWriter", DomResponse);
+  RunBenchmark("Stream (string)", StringResponse);
+  RunBenchmark("Stream (IOQueue)", IOQueueResponse);
+  return 0;
+}
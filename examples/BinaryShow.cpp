@@ -0,0 +1,681 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShow.cpp
+ * Read and write the binary show file format.
+ * Copyright (C) 2026 agent
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif  // HAVE_SYS_MMAN_H
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/base/Array.h>
+#include <ola/stl/STLUtils.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShow.h"
+
+using ola::DmxBuffer;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+void PutUInt16(uint16_t value, string *output) {
+  output->push_back(static_cast<char>(value >> 8));
+  output->push_back(static_cast<char>(value & 0xff));
+}
+
+void PutUInt32(uint32_t value, string *output) {
+  PutUInt16(static_cast<uint16_t>(value >> 16), output);
+  PutUInt16(static_cast<uint16_t>(value & 0xffff), output);
+}
+
+void PutUInt64(uint64_t value, string *output) {
+  PutUInt32(static_cast<uint32_t>(value >> 32), output);
+  PutUInt32(static_cast<uint32_t>(value & 0xffffffff), output);
+}
+
+uint16_t GetUInt16(const uint8_t *data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t GetUInt32(const uint8_t *data) {
+  return (static_cast<uint32_t>(GetUInt16(data)) << 16) | GetUInt16(data + 2);
+}
+
+uint64_t GetUInt64(const uint8_t *data) {
+  return (static_cast<uint64_t>(GetUInt32(data)) << 32) | GetUInt32(data + 4);
+}
+
+// A run of unchanged slots shorter than this is cheaper to include in a delta
+// chunk than to start a new chunk, which has a 3 byte header.
+const unsigned int DELTA_MIN_GAP = 4;
+const unsigned int DELTA_MAX_CHUNK = 255;
+const unsigned int RLE_MIN_RUN = 3;
+const unsigned int RLE_MAX_RUN = 130;
+const unsigned int RLE_MAX_LITERAL = 128;
+}  // namespace
+
+
+const char BinaryShow::HEADER_MAGIC[] = "OLABShow";
+const char BinaryShow::INDEX_MAGIC[] = "OLABIndx";
+const char BinaryShow::FOOTER_MAGIC[] = "OLABFoot";
+const unsigned int BinaryShow::MAGIC_LENGTH;
+const uint16_t BinaryShow::FORMAT_VERSION;
+const unsigned int BinaryShow::HEADER_SIZE;
+const unsigned int BinaryShow::FRAME_HEADER_SIZE;
+const unsigned int BinaryShow::INDEX_ENTRY_SIZE;
+const unsigned int BinaryShow::FOOTER_SIZE;
+const uint64_t BinaryShow::KEY_FRAME_INTERVAL_US;
+const unsigned int BinaryShow::FILE_BUFFER_SIZE;
+
+
+bool BinaryShow::IsBinaryShow(const string &filename) {
+  std::ifstream show_file(filename.c_str(), std::ios::in | std::ios::binary);
+  char magic[MAGIC_LENGTH];
+  if (!show_file.read(magic, MAGIC_LENGTH)) {
+    return false;
+  }
+  return memcmp(magic, HEADER_MAGIC, MAGIC_LENGTH) == 0;
+}
+
+
+void BinaryShow::EncodeRLE(const uint8_t *data, unsigned int length,
+                           string *output) {
+  unsigned int i = 0;
+  unsigned int literal_start = 0;
+  while (i < length) {
+    unsigned int run = 1;
+    while (i + run < length && data[i + run] == data[i] &&
+           run < RLE_MAX_RUN) {
+      run++;
+    }
+
+    if (run < RLE_MIN_RUN) {
+      i += run;
+      if (i - literal_start >= RLE_MAX_LITERAL) {
+        output->push_back(static_cast<char>(RLE_MAX_LITERAL - 1));
+        output->append(reinterpret_cast<const char*>(data + literal_start),
+                       RLE_MAX_LITERAL);
+        literal_start += RLE_MAX_LITERAL;
+      }
+      continue;
+    }
+
+    // flush the literals before the run
+    while (literal_start < i) {
+      unsigned int count = std::min(i - literal_start, RLE_MAX_LITERAL);
+      output->push_back(static_cast<char>(count - 1));
+      output->append(reinterpret_cast<const char*>(data + literal_start),
+                     count);
+      literal_start += count;
+    }
+    output->push_back(static_cast<char>(run + 125));
+    output->push_back(static_cast<char>(data[i]));
+    i += run;
+    literal_start = i;
+  }
+
+  while (literal_start < length) {
+    unsigned int count = std::min(length - literal_start, RLE_MAX_LITERAL);
+    output->push_back(static_cast<char>(count - 1));
+    output->append(reinterpret_cast<const char*>(data + literal_start), count);
+    literal_start += count;
+  }
+}
+
+
+bool BinaryShow::DecodeRLE(const uint8_t *data, unsigned int length,
+                           uint8_t *output, unsigned int output_length) {
+  unsigned int i = 0;
+  unsigned int offset = 0;
+  while (i < length) {
+    const uint8_t control = data[i++];
+    if (control < RLE_MAX_LITERAL) {
+      const unsigned int count = control + 1;
+      if (i + count > length || offset + count > output_length) {
+        return false;
+      }
+      memcpy(output + offset, data + i, count);
+      i += count;
+      offset += count;
+    } else {
+      const unsigned int count = control - 125;
+      if (i >= length || offset + count > output_length) {
+        return false;
+      }
+      memset(output + offset, data[i++], count);
+      offset += count;
+    }
+  }
+  return offset == output_length;
+}
+
+
+void BinaryShow::EncodeDelta(const uint8_t *old_data, const uint8_t *new_data,
+                             unsigned int length, string *output) {
+  unsigned int position = 0;
+  unsigned int i = 0;
+  while (i < length) {
+    if (old_data[i] == new_data[i]) {
+      i++;
+      continue;
+    }
+
+    // extend the chunk until we see DELTA_MIN_GAP unchanged slots
+    unsigned int end = i + 1;
+    for (unsigned int j = end;
+         j < length && j - end < DELTA_MIN_GAP && j - i < DELTA_MAX_CHUNK;
+         j++) {
+      if (old_data[j] != new_data[j]) {
+        end = j + 1;
+      }
+    }
+
+    PutUInt16(static_cast<uint16_t>(i - position), output);
+    output->push_back(static_cast<char>(end - i));
+    output->append(reinterpret_cast<const char*>(new_data + i), end - i);
+    position = end;
+    i = end;
+  }
+}
+
+
+bool BinaryShow::DecodeDelta(const uint8_t *data, unsigned int length,
+                             uint8_t *output, unsigned int output_length) {
+  unsigned int i = 0;
+  unsigned int offset = 0;
+  while (i < length) {
+    if (i + 3 > length) {
+      return false;
+    }
+    offset += GetUInt16(data + i);
+    const unsigned int count = data[i + 2];
+    i += 3;
+    if (i + count > length || offset + count > output_length) {
+      return false;
+    }
+    memcpy(output + offset, data + i, count);
+    i += count;
+    offset += count;
+  }
+  return true;
+}
+
+
+BinaryShowWriter::BinaryShowWriter(const string &filename)
+    : m_filename(filename),
+      m_end_time(0),
+      m_offset(0),
+      m_frame_count(0) {
+}
+
+
+BinaryShowWriter::~BinaryShowWriter() {
+  Close();
+}
+
+
+bool BinaryShowWriter::Open() {
+  m_file_buffer.resize(BinaryShow::FILE_BUFFER_SIZE);
+  m_show_file.rdbuf()->pubsetbuf(&m_file_buffer[0], m_file_buffer.size());
+  m_show_file.open(m_filename.c_str(),
+                   std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_show_file.is_open()) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  string header(BinaryShow::HEADER_MAGIC, BinaryShow::MAGIC_LENGTH);
+  PutUInt16(BinaryShow::FORMAT_VERSION, &header);
+  PutUInt16(0, &header);
+  PutUInt32(0, &header);
+  Write(header);
+  return m_show_file.good();
+}
+
+
+bool BinaryShowWriter::Close() {
+  if (!m_show_file.is_open()) {
+    return true;
+  }
+
+  const uint64_t index_offset = m_offset;
+  string output;
+  output.reserve(BinaryShow::MAGIC_LENGTH +
+                 m_index.size() * BinaryShow::INDEX_ENTRY_SIZE +
+                 BinaryShow::FOOTER_SIZE);
+  output.append(BinaryShow::INDEX_MAGIC, BinaryShow::MAGIC_LENGTH);
+  vector<IndexEntry>::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    PutUInt32(iter->universe, &output);
+    PutUInt64(iter->time, &output);
+    PutUInt64(iter->offset, &output);
+  }
+
+  PutUInt64(index_offset, &output);
+  PutUInt32(m_index.size(), &output);
+  PutUInt32(m_frame_count, &output);
+  PutUInt64(m_end_time, &output);
+  output.append(BinaryShow::FOOTER_MAGIC, BinaryShow::MAGIC_LENGTH);
+  Write(output);
+
+  const bool ok = m_show_file.good();
+  m_show_file.close();
+  if (!ok) {
+    OLA_WARN << "Failed to write " << m_filename;
+  }
+  return ok;
+}
+
+
+bool BinaryShowWriter::NewFrame(const ola::TimeStamp &arrival_time,
+                                unsigned int universe,
+                                const DmxBuffer &data) {
+  if (!m_start_time.IsSet()) {
+    m_start_time = arrival_time;
+  }
+  const uint64_t time = RelativeTime(arrival_time);
+  m_end_time = std::max(m_end_time, time);
+
+  const uint8_t *slots = data.GetRaw();
+  const unsigned int length = data.Size();
+
+  // Pick the smallest encoding.
+  BinaryShow::FrameEncoding encoding = BinaryShow::RAW_FRAME;
+  m_encoded.assign(reinterpret_cast<const char*>(slots), length);
+
+  m_candidate.clear();
+  BinaryShow::EncodeRLE(slots, length, &m_candidate);
+  if (m_candidate.size() < m_encoded.size()) {
+    encoding = BinaryShow::RLE_FRAME;
+    m_encoded.swap(m_candidate);
+  }
+
+  UniverseMap::iterator iter = m_universes.find(universe);
+  const bool need_key_frame = (
+      iter == m_universes.end() ||
+      iter->second.last_frame.Size() != length ||
+      time - iter->second.last_key_frame >= BinaryShow::KEY_FRAME_INTERVAL_US);
+
+  if (!need_key_frame) {
+    m_candidate.clear();
+    BinaryShow::EncodeDelta(iter->second.last_frame.GetRaw(), slots, length,
+                            &m_candidate);
+    if (m_candidate.size() < m_encoded.size()) {
+      encoding = BinaryShow::DELTA_FRAME;
+      m_encoded.swap(m_candidate);
+    }
+  }
+
+  if (iter == m_universes.end()) {
+    iter = m_universes.insert(
+        std::make_pair(universe, UniverseState())).first;
+  }
+
+  if (encoding != BinaryShow::DELTA_FRAME) {
+    IndexEntry entry = {universe, time, m_offset};
+    m_index.push_back(entry);
+    iter->second.last_key_frame = time;
+  }
+  iter->second.last_frame = data;
+
+  string header;
+  header.reserve(BinaryShow::FRAME_HEADER_SIZE);
+  PutUInt64(time, &header);
+  PutUInt32(universe, &header);
+  header.push_back(static_cast<char>(encoding));
+  PutUInt16(length, &header);
+  PutUInt16(m_encoded.size(), &header);
+  Write(header);
+  Write(m_encoded);
+  m_frame_count++;
+  return m_show_file.good();
+}
+
+
+void BinaryShowWriter::SetEndTime(const ola::TimeStamp &end_time) {
+  if (m_start_time.IsSet()) {
+    m_end_time = std::max(m_end_time, RelativeTime(end_time));
+  }
+}
+
+
+uint64_t BinaryShowWriter::RelativeTime(const ola::TimeStamp &time) const {
+  if (time < m_start_time) {
+    return 0;
+  }
+  return (time - m_start_time).AsInt();
+}
+
+
+void BinaryShowWriter::Write(const string &data) {
+  m_show_file.write(data.data(), data.size());
+  m_offset += data.size();
+}
+
+
+BinaryShowReader::BinaryShowReader(const string &filename)
+    : m_filename(filename),
+      m_data(NULL),
+      m_size(0),
+      m_frames_end(0),
+      m_offset(BinaryShow::HEADER_SIZE),
+      m_end_time(0),
+      m_frame_count(0) {
+}
+
+
+BinaryShowReader::~BinaryShowReader() {
+  UnmapFile();
+}
+
+
+bool BinaryShowReader::Load() {
+  if (!MapFile()) {
+    return false;
+  }
+
+  if (m_size < BinaryShow::HEADER_SIZE ||
+      memcmp(m_data, BinaryShow::HEADER_MAGIC, BinaryShow::MAGIC_LENGTH)) {
+    OLA_WARN << m_filename << " isn't a binary show file";
+    return false;
+  }
+
+  const uint16_t version = GetUInt16(m_data + BinaryShow::MAGIC_LENGTH);
+  if (version != BinaryShow::FORMAT_VERSION) {
+    OLA_WARN << m_filename << " has unknown version " << version;
+    return false;
+  }
+
+  if (!ReadFooter()) {
+    OLA_WARN << m_filename << " has no index, it may be truncated. "
+             << "Scanning the frames instead";
+    if (!ScanFrames()) {
+      return false;
+    }
+  }
+  Reset();
+  return true;
+}
+
+
+void BinaryShowReader::Reset() {
+  m_offset = BinaryShow::HEADER_SIZE;
+  m_frames.clear();
+}
+
+
+void BinaryShowReader::Seek(uint64_t time) {
+  Reset();
+
+  // For each universe, find the last key frame at or before the time. We
+  // need to start reading from the earliest of these.
+  uint64_t offset = m_frames_end;
+  IndexMap::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    const vector<IndexEntry> &entries = iter->second;
+    IndexEntry target = {time, 0};
+    vector<IndexEntry>::const_iterator entry = std::upper_bound(
+        entries.begin(), entries.end(), target);
+    if (entry == entries.begin()) {
+      // The universe's first frame is after the time.
+      if (!entries.empty()) {
+        offset = std::min(offset, entries.front().offset);
+      }
+      continue;
+    }
+    --entry;
+    offset = std::min(offset, entry->offset);
+  }
+  m_offset = std::max(offset,
+                      static_cast<uint64_t>(BinaryShow::HEADER_SIZE));
+}
+
+
+BinaryShowReader::State BinaryShowReader::NextFrame(uint64_t *time,
+                                                    unsigned int *universe,
+                                                    DmxBuffer *data) {
+  if (m_offset >= m_frames_end) {
+    return END_OF_FILE;
+  }
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE > m_frames_end) {
+    OLA_WARN << "Truncated frame at offset " << m_offset;
+    return INVALID_FRAME;
+  }
+
+  const uint8_t *header = m_data + m_offset;
+  *time = GetUInt64(header);
+  *universe = GetUInt32(header + 8);
+  const uint8_t encoding = header[12];
+  const unsigned int slots = GetUInt16(header + 13);
+  const unsigned int length = GetUInt16(header + 15);
+  const uint8_t *payload = header + BinaryShow::FRAME_HEADER_SIZE;
+
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE + length > m_frames_end ||
+      slots > ola::DMX_UNIVERSE_SIZE) {
+    OLA_WARN << "Invalid frame at offset " << m_offset;
+    return INVALID_FRAME;
+  }
+
+  uint8_t decoded[ola::DMX_UNIVERSE_SIZE];
+  bool ok = false;
+  switch (encoding) {
+    case BinaryShow::RAW_FRAME:
+      ok = length == slots;
+      memcpy(decoded, payload, std::min(length, slots));
+      break;
+    case BinaryShow::RLE_FRAME:
+      ok = BinaryShow::DecodeRLE(payload, length, decoded, slots);
+      break;
+    case BinaryShow::DELTA_FRAME:
+      {
+        // If we've seeked, this may be a delta against a frame we haven't
+        // read. The result is discarded once we reach the universe's key
+        // frame, so start from zeros.
+        memset(decoded, 0, slots);
+        const DmxBuffer &last = m_frames[*universe];
+        memcpy(decoded, last.GetRaw(), std::min(last.Size(), slots));
+        ok = BinaryShow::DecodeDelta(payload, length, decoded, slots);
+      }
+      break;
+    default:
+      OLA_WARN << "Unknown frame encoding " << static_cast<int>(encoding);
+  }
+
+  if (!ok) {
+    OLA_WARN << "Failed to decode frame at offset " << m_offset;
+    return INVALID_FRAME;
+  }
+
+  data->Set(decoded, slots);
+  m_frames[*universe] = *data;
+  m_offset += BinaryShow::FRAME_HEADER_SIZE + length;
+  return OK;
+}
+
+
+bool BinaryShowReader::PeekTime(uint64_t *time) const {
+  if (m_offset + BinaryShow::FRAME_HEADER_SIZE > m_frames_end) {
+    return false;
+  }
+  *time = GetUInt64(m_data + m_offset);
+  return true;
+}
+
+
+void BinaryShowReader::Universes(vector<unsigned int> *universes) const {
+  ola::STLKeys(m_index, universes);
+}
+
+
+bool BinaryShowReader::MapFile() {
+  int fd = open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) || file_stat.st_size == 0) {
+    OLA_WARN << m_filename << " is empty";
+    close(fd);
+    return false;
+  }
+  m_size = file_stat.st_size;
+
+#ifdef HAVE_SYS_MMAN_H
+  void *data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    OLA_WARN << "Failed to map " << m_filename << ": " << strerror(errno);
+    m_size = 0;
+    return false;
+  }
+  // Playback reads the file from start to end.
+  madvise(data, m_size, MADV_SEQUENTIAL);
+  m_data = static_cast<const uint8_t*>(data);
+#else
+  close(fd);
+  std::ifstream show_file(m_filename.c_str(),
+                          std::ios::in | std::ios::binary);
+  m_file_data.resize(m_size);
+  if (!show_file.read(&m_file_data[0], m_size)) {
+    OLA_WARN << "Failed to read " << m_filename;
+    return false;
+  }
+  m_data = reinterpret_cast<const uint8_t*>(m_file_data.data());
+#endif  // HAVE_SYS_MMAN_H
+  return true;
+}
+
+
+void BinaryShowReader::UnmapFile() {
+#ifdef HAVE_SYS_MMAN_H
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+#endif  // HAVE_SYS_MMAN_H
+  m_file_data.clear();
+  m_data = NULL;
+  m_size = 0;
+}
+
+
+/*
+ * Read the footer and index.
+ * @returns false if they are missing or invalid.
+ */
+bool BinaryShowReader::ReadFooter() {
+  if (m_size < BinaryShow::HEADER_SIZE + BinaryShow::FOOTER_SIZE) {
+    return false;
+  }
+
+  const uint8_t *footer = m_data + m_size - BinaryShow::FOOTER_SIZE;
+  if (memcmp(footer + BinaryShow::FOOTER_SIZE - BinaryShow::MAGIC_LENGTH,
+             BinaryShow::FOOTER_MAGIC, BinaryShow::MAGIC_LENGTH)) {
+    return false;
+  }
+
+  const uint64_t index_offset = GetUInt64(footer);
+  const uint32_t index_size = GetUInt32(footer + 8);
+  if (index_offset < BinaryShow::HEADER_SIZE ||
+      index_offset + BinaryShow::MAGIC_LENGTH +
+        static_cast<uint64_t>(index_size) * BinaryShow::INDEX_ENTRY_SIZE !=
+        m_size - BinaryShow::FOOTER_SIZE ||
+      memcmp(m_data + index_offset, BinaryShow::INDEX_MAGIC,
+             BinaryShow::MAGIC_LENGTH)) {
+    return false;
+  }
+
+  m_frames_end = index_offset;
+  m_frame_count = GetUInt32(footer + 12);
+  m_end_time = GetUInt64(footer + 16);
+
+  m_index.clear();
+  const uint8_t *entry = m_data + index_offset + BinaryShow::MAGIC_LENGTH;
+  for (uint32_t i = 0; i < index_size; i++) {
+    IndexEntry index_entry = {GetUInt64(entry + 4), GetUInt64(entry + 12)};
+    if (index_entry.offset < BinaryShow::HEADER_SIZE ||
+        index_entry.offset >= m_frames_end) {
+      return false;
+    }
+    m_index[GetUInt32(entry)].push_back(index_entry);
+    entry += BinaryShow::INDEX_ENTRY_SIZE;
+  }
+  return true;
+}
+
+
+/*
+ * Build the index by reading the frame headers. This stops at the first
+ * incomplete or invalid frame.
+ */
+bool BinaryShowReader::ScanFrames() {
+  m_index.clear();
+  m_frame_count = 0;
+  m_end_time = 0;
+
+  uint64_t offset = BinaryShow::HEADER_SIZE;
+  while (offset + BinaryShow::FRAME_HEADER_SIZE <= m_size) {
+    const uint8_t *header = m_data + offset;
+    if (!memcmp(header, BinaryShow::INDEX_MAGIC, BinaryShow::MAGIC_LENGTH)) {
+      break;
+    }
+
+    const uint64_t time = GetUInt64(header);
+    const uint8_t encoding = header[12];
+    const uint16_t slots = GetUInt16(header + 13);
+    const uint16_t length = GetUInt16(header + 15);
+    // Stop at anything that doesn't look like a frame.
+    if (offset + BinaryShow::FRAME_HEADER_SIZE + length > m_size ||
+        encoding > BinaryShow::DELTA_FRAME ||
+        slots > ola::DMX_UNIVERSE_SIZE ||
+        time < m_end_time) {
+      break;
+    }
+
+    if (encoding != BinaryShow::DELTA_FRAME) {
+      IndexEntry entry = {time, offset};
+      m_index[GetUInt32(header + 8)].push_back(entry);
+    }
+    m_end_time = std::max(m_end_time, time);
+    m_frame_count++;
+    offset += BinaryShow::FRAME_HEADER_SIZE + length;
+  }
+  m_frames_end = offset;
+  return true;
+}
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * BinaryShow.h
+ * Read and write the binary show file format.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <stdint.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef EXAMPLES_BINARYSHOW_H_
+#define EXAMPLES_BINARYSHOW_H_
+
+/**
+ * The binary show format.
+ *
+ * All integers are big endian. The file starts with a 16 byte header:
+ *   char[8]  "OLABShow"
+ *   uint16   version
+ *   uint16   reserved
+ *   uint32   reserved
+ *
+ * This is followed by the frames, each of which has a 17 byte header:
+ *   uint64   time in microseconds since the start of the show
+ *   uint32   universe
+ *   uint8    encoding, one of the FrameEncoding values
+ *   uint16   number of slots
+ *   uint16   length of the encoded data
+ * and then the encoded data.
+ *
+ * Key frames (raw or RLE) don't depend on earlier frames. Delta frames contain
+ * the slots that changed since the previous frame for the universe. The writer
+ * emits a key frame for each universe at least once a second.
+ *
+ * After the frames is the index. This starts with the 8 byte marker "OLABIndx"
+ * followed by a 20 byte entry for each key frame:
+ *   uint32   universe
+ *   uint64   time
+ *   uint64   offset of the frame in the file
+ *
+ * The file ends with a 32 byte footer:
+ *   uint64   offset of the index
+ *   uint32   number of index entries
+ *   uint32   number of frames
+ *   uint64   the end time of the show, in microseconds
+ *   char[8]  "OLABFoot"
+ *
+ * If the footer is missing, for example because the recorder was killed, the
+ * reader rebuilds the index by scanning the frames.
+ */
+class BinaryShow {
+ public:
+  typedef enum {
+    RAW_FRAME = 0,
+    // PackBits style: a control byte c < 128 is followed by c + 1 literal
+    // slots, c >= 128 is followed by one value that is repeated c - 125 times.
+    RLE_FRAME = 1,
+    // A sequence of uint16 unchanged slot count, uint8 changed slot count and
+    // the changed slots.
+    DELTA_FRAME = 2,
+  } FrameEncoding;
+
+  static const char HEADER_MAGIC[];
+  static const char INDEX_MAGIC[];
+  static const char FOOTER_MAGIC[];
+  static const unsigned int MAGIC_LENGTH = 8;
+  static const uint16_t FORMAT_VERSION = 1;
+  static const unsigned int HEADER_SIZE = 16;
+  static const unsigned int FRAME_HEADER_SIZE = 17;
+  static const unsigned int INDEX_ENTRY_SIZE = 20;
+  static const unsigned int FOOTER_SIZE = 32;
+  // The maximum time between key frames for a universe.
+  static const uint64_t KEY_FRAME_INTERVAL_US = 1000000;
+  // The size of the buffer used when writing show files.
+  static const unsigned int FILE_BUFFER_SIZE = 1 << 20;
+
+  /**
+   * @brief Check if a file starts with the binary show header.
+   */
+  static bool IsBinaryShow(const std::string &filename);
+
+  static void EncodeRLE(const uint8_t *data, unsigned int length,
+                        std::string *output);
+  static bool DecodeRLE(const uint8_t *data, unsigned int length,
+                        uint8_t *output, unsigned int output_length);
+  static void EncodeDelta(const uint8_t *old_data, const uint8_t *new_data,
+                          unsigned int length, std::string *output);
+  static bool DecodeDelta(const uint8_t *data, unsigned int length,
+                          uint8_t *output, unsigned int output_length);
+};
+
+
+/**
+ * @brief Write a show in the binary format.
+ */
+class BinaryShowWriter {
+ public:
+  explicit BinaryShowWriter(const std::string &filename);
+  ~BinaryShowWriter();
+
+  bool Open();
+
+  /**
+   * @brief Write the index and footer, and close the file.
+   */
+  bool Close();
+
+  bool NewFrame(const ola::TimeStamp &arrival_time,
+                unsigned int universe,
+                const ola::DmxBuffer &data);
+
+  /**
+   * @brief Set the end of the show, this defaults to the last frame.
+   */
+  void SetEndTime(const ola::TimeStamp &end_time);
+
+ private:
+  struct UniverseState {
+    ola::DmxBuffer last_frame;
+    uint64_t last_key_frame;
+  };
+
+  struct IndexEntry {
+    unsigned int universe;
+    uint64_t time;
+    uint64_t offset;
+  };
+
+  typedef std::map<unsigned int, UniverseState> UniverseMap;
+
+  const std::string m_filename;
+  std::ofstream m_show_file;
+  std::vector<char> m_file_buffer;
+  ola::TimeStamp m_start_time;
+  uint64_t m_end_time;
+  uint64_t m_offset;
+  uint32_t m_frame_count;
+  UniverseMap m_universes;
+  std::vector<IndexEntry> m_index;
+  std::string m_encoded;
+  std::string m_candidate;
+
+  uint64_t RelativeTime(const ola::TimeStamp &time) const;
+  void Write(const std::string &data);
+};
+
+
+/**
+ * @brief Read a show in the binary format.
+ *
+ * The file is mapped into memory and frames are decoded as they are read.
+ */
+class BinaryShowReader {
+ public:
+  typedef enum {
+    OK,
+    INVALID_FRAME,
+    END_OF_FILE,
+  } State;
+
+  explicit BinaryShowReader(const std::string &filename);
+  ~BinaryShowReader();
+
+  bool Load();
+
+  /**
+   * @brief Go back to the first frame.
+   */
+  void Reset();
+
+  /**
+   * @brief Move to the earliest key frame needed to reconstruct the state of
+   * every universe at a time.
+   *
+   * Frames before the time will still be returned by NextFrame(), the caller
+   * should apply them without playing them.
+   * @param time the time in microseconds.
+   */
+  void Seek(uint64_t time);
+
+  State NextFrame(uint64_t *time, unsigned int *universe,
+                  ola::DmxBuffer *data);
+
+  /**
+   * @brief Get the time of the next frame without reading it.
+   * @returns false if there are no more frames.
+   */
+  bool PeekTime(uint64_t *time) const;
+
+  uint64_t EndTime() const { return m_end_time; }
+  uint32_t FrameCount() const { return m_frame_count; }
+  void Universes(std::vector<unsigned int> *universes) const;
+
+ private:
+  struct IndexEntry {
+    uint64_t time;
+    uint64_t offset;
+
+    bool operator<(const IndexEntry &other) const {
+      return time < other.time;
+    }
+  };
+
+  typedef std::map<unsigned int, std::vector<IndexEntry> > IndexMap;
+
+  const std::string m_filename;
+  const uint8_t *m_data;
+  uint64_t m_size;
+  std::string m_file_data;  // Used if mmap isn't available.
+  uint64_t m_frames_end;
+  uint64_t m_offset;
+  uint64_t m_end_time;
+  uint32_t m_frame_count;
+  IndexMap m_index;
+  std::map<unsigned int, ola::DmxBuffer> m_frames;
+
+  bool MapFile();
+  void UnmapFile();
+  bool ReadFooter();
+  bool ScanFrames();
+};
+#endif  // EXAMPLES_BINARYSHOW_H_
@@ -21,6 +21,7 @@ examples_libolaconfig_la_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
 ##################################################
 bin_PROGRAMS += \
     examples/ola_dev_info \
+    examples/ola_rdm_collector \
     examples/ola_rdm_discover \
     examples/ola_rdm_get \
     examples/ola_recorder \
@@ -67,11 +68,16 @@ examples_ola_streaming_client_LDADD = $(EXAMPLE_COMMON_LIBS)
 examples_ola_rdm_get_SOURCES = examples/ola-rdm.cpp
 examples_ola_rdm_get_LDADD = $(EXAMPLE_COMMON_LIBS)
 
+examples_ola_rdm_collector_SOURCES = examples/ola-rdm-collector.cpp
+examples_ola_rdm_collector_LDADD = $(EXAMPLE_COMMON_LIBS)
+
 examples_ola_rdm_discover_SOURCES = examples/ola-rdm-discover.cpp
 examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_recorder_SOURCES = \
     examples/ola-recorder.cpp \
+    examples/BinaryShow.h \
+    examples/BinaryShow.cpp \
     examples/ShowLoader.h \
     examples/ShowLoader.cpp \
     examples/ShowPlayer.h \
@@ -79,7 +85,9 @@ examples_ola_recorder_SOURCES = \
     examples/ShowRecorder.h \
     examples/ShowRecorder.cpp \
     examples/ShowSaver.h \
-    examples/ShowSaver.cpp
+    examples/ShowSaver.cpp \
+    examples/ShowWriterThread.h \
+    examples/ShowWriterThread.cpp
 examples_ola_recorder_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_timecode_SOURCES = examples/ola-timecode.cpp
@@ -127,6 +135,7 @@ INSTALL_EXEC_HOOKS += install-exec-hook-examples
 ##################################################
 
 EXTRA_DIST += \
+    examples/testdata/binary_show \
     examples/testdata/dos_line_endings \
     examples/testdata/multiple_unis \
     examples/testdata/partial_frames \
@@ -135,10 +144,23 @@ EXTRA_DIST += \
 
 # TESTS
 ##################################################
+test_programs += examples/ShowLoaderTester
+
+examples_ShowLoaderTester_SOURCES = \
+    examples/BinaryShow.h \
+    examples/BinaryShow.cpp \
+    examples/ShowLoader.h \
+    examples/ShowLoader.cpp \
+    examples/ShowLoaderTest.cpp \
+    examples/ShowSaver.h \
+    examples/ShowSaver.cpp
+examples_ShowLoaderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+examples_ShowLoaderTester_LDADD = $(COMMON_TESTING_LIBS)
+
 test_scripts += examples/RecorderVerifyTest.sh
 
 examples/RecorderVerifyTest.sh: examples/Makefile.mk
-	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
+	echo "for FILE in ${srcdir}/examples/testdata/binary_show ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
 	chmod +x examples/RecorderVerifyTest.sh
 
 CLEANFILES += examples/RecorderVerifyTest.sh
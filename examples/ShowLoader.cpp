@@ -17,10 +17,12 @@
  * A class that reads OLA show files
  * Copyright (C) 2011 Simon Newton
  *
- * The data file is in the form:
+ * The text data file is in the form:
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * See BinaryShow.h for the binary format.
  */
 
 #include <errno.h>
@@ -31,12 +33,15 @@
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "examples/BinaryShow.h"
 #include "examples/ShowLoader.h"
 
+using std::map;
 using std::vector;
 using std::string;
 using ola::DmxBuffer;
@@ -46,7 +51,10 @@ const char ShowLoader::OLA_SHOW_HEADER[] = "OLA Show";
 
 ShowLoader::ShowLoader(const string &filename)
     : m_filename(filename),
-      m_line(0) {
+      m_line(0),
+      m_start_time(0),
+      m_stop_time(0),
+      m_current_time(0) {
 }
 
 
@@ -62,6 +70,15 @@ ShowLoader::~ShowLoader() {
  * @returns true if we could open the file, false otherwise.
  */
 bool ShowLoader::Load() {
+  if (BinaryShow::IsBinaryShow(m_filename)) {
+    m_binary_reader.reset(new BinaryShowReader(m_filename));
+    if (!m_binary_reader->Load()) {
+      return false;
+    }
+    Reset();
+    return true;
+  }
+
   m_show_file.open(m_filename.data());
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
@@ -75,16 +92,90 @@ bool ShowLoader::Load() {
              << line;
     return false;
   }
+  if (m_start_time) {
+    Reset();
+  }
   return true;
 }
 
 
 /**
- * Reset to the start of the show
+ * Reset to the start of the show, or the start time if one was set.
  */
 void ShowLoader::Reset() {
+  Rewind();
+  if (m_start_time) {
+    SkipTo(m_start_time);
+  }
+}
+
+
+void ShowLoader::SetStartTime(unsigned int start_time) {
+  m_start_time = start_time;
+  if (m_binary_reader.get() || m_show_file.is_open()) {
+    Reset();
+  }
+}
+
+
+/**
+ * Get the next time offset
+ * @param timeout a pointer to the timeout in ms
+ */
+ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
+  if (!m_pending_frames.empty()) {
+    *timeout = m_pending_frames.front().time - m_current_time;
+    m_current_time = m_pending_frames.front().time;
+  } else {
+    State state = ReadTimeout(timeout);
+    if (state != OK) {
+      return state;
+    }
+  }
+
+  if (m_stop_time && m_current_time > m_stop_time) {
+    *timeout -= m_current_time - m_stop_time;
+    m_current_time = m_stop_time;
+  }
+  return OK;
+}
+
+
+/**
+ * Read the next DMX frame.
+ * @param universe the universe to send on
+ * @param data the DMX data
+ */
+ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
+                                        DmxBuffer *data) {
+  if (m_stop_time && m_current_time >= m_stop_time) {
+    return END_OF_FILE;
+  }
+
+  if (!m_pending_frames.empty()) {
+    *universe = m_pending_frames.front().universe;
+    data->Set(m_pending_frames.front().data);
+    m_pending_frames.pop_front();
+    return OK;
+  }
+  return ReadFrame(universe, data);
+}
+
+
+/**
+ * Go back to the first frame.
+ */
+void ShowLoader::Rewind() {
+  m_current_time = 0;
+  m_pending_frames.clear();
+  if (m_binary_reader.get()) {
+    m_binary_reader->Reset();
+    return;
+  }
+
   m_show_file.clear();
   m_show_file.seekg(0, std::ios::beg);
+  m_line = 0;
   // skip over the first line
   string line;
   ReadLine(&line);
@@ -92,10 +183,65 @@ void ShowLoader::Reset() {
 
 
 /**
- * Get the next time offset
- * @param timeout a pointer to the timeout in ms
+ * Move to a time in the show.
+ *
+ * This reads forward, recording the last frame for each universe. Binary shows
+ * use the index to start from the nearest key frames rather than the start of
+ * the file.
  */
-ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
+void ShowLoader::SkipTo(unsigned int start_time) {
+  if (m_binary_reader.get()) {
+    m_binary_reader->Seek(static_cast<uint64_t>(start_time) * 1000);
+  }
+
+  map<unsigned int, DmxBuffer> frames;
+  PendingFrame next_frame;
+  bool have_next_frame = false;
+  while (ReadFrame(&next_frame.universe, &next_frame.data) == OK) {
+    if (m_current_time > start_time) {
+      next_frame.time = m_current_time;
+      have_next_frame = true;
+      break;
+    }
+    frames[next_frame.universe] = next_frame.data;
+
+    unsigned int timeout;
+    if (ReadTimeout(&timeout) != OK) {
+      break;
+    }
+  }
+
+  map<unsigned int, DmxBuffer>::const_iterator iter = frames.begin();
+  for (; iter != frames.end(); ++iter) {
+    PendingFrame frame;
+    frame.universe = iter->first;
+    frame.data = iter->second;
+    frame.time = start_time;
+    m_pending_frames.push_back(frame);
+  }
+  if (have_next_frame) {
+    m_pending_frames.push_back(next_frame);
+  }
+  m_current_time = start_time;
+}
+
+
+ShowLoader::State ShowLoader::ReadTimeout(unsigned int *timeout) {
+  if (m_binary_reader.get()) {
+    uint64_t next_time;
+    if (m_binary_reader->PeekTime(&next_time)) {
+      next_time /= 1000;
+    } else {
+      next_time = m_binary_reader->EndTime() / 1000;
+      if (next_time <= m_current_time) {
+        return END_OF_FILE;
+      }
+    }
+    *timeout = next_time > m_current_time ? next_time - m_current_time : 0;
+    m_current_time += *timeout;
+    return OK;
+  }
+
   string line;
   ReadLine(&line);
   if (line.empty()) {
@@ -106,17 +252,26 @@ ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
     OLA_WARN << "Line " << m_line << ": Invalid timeout: " << line;
     return INVALID_LINE;
   }
+  m_current_time += *timeout;
   return OK;
 }
 
 
-/**
- * Read the next DMX frame.
- * @param universe the universe to send on
- * @param data the DMX data
- */
-ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
+ShowLoader::State ShowLoader::ReadFrame(unsigned int *universe,
                                         DmxBuffer *data) {
+  if (m_binary_reader.get()) {
+    uint64_t time;
+    switch (m_binary_reader->NextFrame(&time, universe, data)) {
+      case BinaryShowReader::OK:
+        m_current_time = time / 1000;
+        return OK;
+      case BinaryShowReader::END_OF_FILE:
+        return END_OF_FILE;
+      default:
+        return INVALID_LINE;
+    }
+  }
+
   string line;
   ReadLine(&line);
 
@@ -19,15 +19,21 @@
  */
 
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 
-#include <string>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <string>
+
+#include "examples/BinaryShow.h"
 
 #ifndef EXAMPLES_SHOWLOADER_H_
 #define EXAMPLES_SHOWLOADER_H_
 
 /**
- * Loads a show file and reads the DMX data.
+ * Loads a show file and reads the DMX data. Both the text and binary formats
+ * are supported, the format is detected when the file is loaded.
  */
 class ShowLoader {
  public:
@@ -43,16 +49,50 @@ class ShowLoader {
   bool Load();
   void Reset();
 
+  /**
+   * @brief Start the show part way through.
+   *
+   * The first frames returned are the state of each universe at the start
+   * time, followed by the frames after it.
+   * @param start_time the time in ms from the start of the show.
+   */
+  void SetStartTime(unsigned int start_time);
+
+  /**
+   * @brief End the show early.
+   * @param stop_time the time in ms from the start of the show, 0 means play
+   *   until the end.
+   */
+  void SetStopTime(unsigned int stop_time) { m_stop_time = stop_time; }
+
+  bool IsBinary() const { return m_binary_reader.get() != NULL; }
+
   State NextTimeout(unsigned int *timeout);
   State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
 
  private:
+  struct PendingFrame {
+    unsigned int universe;
+    ola::DmxBuffer data;
+    uint64_t time;
+  };
+
   const std::string m_filename;
   std::ifstream m_show_file;
+  std::auto_ptr<BinaryShowReader> m_binary_reader;
   unsigned int m_line;
+  unsigned int m_start_time;
+  unsigned int m_stop_time;
+  // The position in the show, in ms.
+  uint64_t m_current_time;
+  std::deque<PendingFrame> m_pending_frames;
 
   static const char OLA_SHOW_HEADER[];
 
+  void Rewind();
+  void SkipTo(unsigned int start_time);
+  State ReadTimeout(unsigned int *timeout);
+  State ReadFrame(unsigned int *universe, ola::DmxBuffer *data);
   void ReadLine(std::string *line);
 };
 #endif  // EXAMPLES_SHOWLOADER_H_
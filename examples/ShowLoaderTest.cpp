@@ -0,0 +1,240 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLoaderTest.cpp
+ * Write shows with the ShowSaver and read them back with the ShowLoader.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <unistd.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "examples/ShowLoader.h"
+#include "examples/ShowSaver.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using std::string;
+using std::vector;
+
+// All times are in ms.
+static const unsigned int FRAME_COUNT = 30;
+static const unsigned int FRAME_INTERVAL = 100;
+static const unsigned int END_TIME = 3500;
+
+class ShowLoaderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ShowLoaderTest);
+  CPPUNIT_TEST(testBinaryShow);
+  CPPUNIT_TEST(testTextShow);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ShowLoaderTest()
+      : m_filename(TEST_BUILD_DIR "/examples/ShowLoaderTest.show") {
+  }
+
+  void tearDown() {
+    unlink(m_filename.c_str());
+  }
+
+  void testBinaryShow();
+  void testTextShow();
+
+ private:
+  const string m_filename;
+
+  void WriteShow(ShowSaver::Format format, vector<string> *frames);
+  void PlayShow(unsigned int start_time, unsigned int stop_time,
+                vector<string> *frames);
+  void CheckShow(ShowSaver::Format format);
+  void CheckFrames(const vector<string> &expected,
+                   const vector<string> &played);
+
+  static string FrameString(unsigned int time, unsigned int universe,
+                            const DmxBuffer &data);
+  static DmxBuffer UniverseOneData(unsigned int frame);
+  static DmxBuffer UniverseTwoData(unsigned int frame);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ShowLoaderTest);
+
+
+/*
+ * Check a binary show, the start time needs the index and delta frames.
+ */
+void ShowLoaderTest::testBinaryShow() {
+  CheckShow(ShowSaver::BINARY_FORMAT);
+
+  ShowLoader loader(m_filename);
+  OLA_ASSERT_TRUE(loader.Load());
+  OLA_ASSERT_TRUE(loader.IsBinary());
+}
+
+
+/*
+ * Check a text show behaves the same way.
+ */
+void ShowLoaderTest::testTextShow() {
+  CheckShow(ShowSaver::TEXT_FORMAT);
+
+  ShowLoader loader(m_filename);
+  OLA_ASSERT_TRUE(loader.Load());
+  OLA_ASSERT_FALSE(loader.IsBinary());
+}
+
+
+void ShowLoaderTest::CheckShow(ShowSaver::Format format) {
+  vector<string> written;
+  WriteShow(format, &written);
+
+  // The whole show.
+  vector<string> played;
+  PlayShow(0, 0, &played);
+  CheckFrames(written, played);
+
+  // Start part way through. The first frames are the state of each universe
+  // at the start time.
+  vector<string> expected;
+  expected.push_back(FrameString(1250, 1, UniverseOneData(12)));
+  expected.push_back(FrameString(1250, 2, UniverseTwoData(12)));
+  for (unsigned int i = 13; i < FRAME_COUNT; i++) {
+    expected.push_back(FrameString(i * FRAME_INTERVAL, 1, UniverseOneData(i)));
+    expected.push_back(FrameString(i * FRAME_INTERVAL + FRAME_INTERVAL / 2, 2,
+                                   UniverseTwoData(i)));
+  }
+  played.clear();
+  PlayShow(1250, 0, &played);
+  CheckFrames(expected, played);
+
+  // And stop early, frames at or after the stop time aren't played.
+  expected.resize(2 + 2 * (20 - 13));
+  played.clear();
+  PlayShow(1250, 2000, &played);
+  CheckFrames(expected, played);
+
+  // Stop without a start time.
+  expected.clear();
+  for (unsigned int i = 0; i < 5; i++) {
+    expected.push_back(FrameString(i * FRAME_INTERVAL, 1, UniverseOneData(i)));
+    expected.push_back(FrameString(i * FRAME_INTERVAL + FRAME_INTERVAL / 2, 2,
+                                   UniverseTwoData(i)));
+  }
+  played.clear();
+  PlayShow(0, 500, &played);
+  CheckFrames(expected, played);
+}
+
+
+void ShowLoaderTest::CheckFrames(const vector<string> &expected,
+                                 const vector<string> &played) {
+  OLA_ASSERT_EQ(expected.size(), played.size());
+  for (unsigned int i = 0; i < expected.size(); i++) {
+    OLA_ASSERT_EQ(expected[i], played[i]);
+  }
+}
+
+
+/*
+ * Write a show with two universes, each sending a frame every 100ms.
+ */
+void ShowLoaderTest::WriteShow(ShowSaver::Format format,
+                               vector<string> *frames) {
+  ShowSaver saver(m_filename, format);
+  OLA_ASSERT_TRUE(saver.Open());
+
+  TimeStamp start;
+  ola::Clock clock;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < FRAME_COUNT; i++) {
+    const unsigned int time = i * FRAME_INTERVAL;
+    const DmxBuffer universe_one = UniverseOneData(i);
+    const DmxBuffer universe_two = UniverseTwoData(i);
+    OLA_ASSERT_TRUE(saver.NewFrame(start + TimeInterval(time * 1000), 1,
+                                   universe_one));
+    frames->push_back(FrameString(time, 1, universe_one));
+    OLA_ASSERT_TRUE(saver.NewFrame(
+        start + TimeInterval((time + FRAME_INTERVAL / 2) * 1000), 2,
+        universe_two));
+    frames->push_back(FrameString(time + FRAME_INTERVAL / 2, 2,
+                                  universe_two));
+  }
+  saver.SetEndTime(start + TimeInterval(END_TIME * 1000));
+  saver.Close();
+}
+
+
+/*
+ * Play a show in the same way as the ShowPlayer, recording each frame and the
+ * time it would be sent.
+ */
+void ShowLoaderTest::PlayShow(unsigned int start_time, unsigned int stop_time,
+                              vector<string> *frames) {
+  ShowLoader loader(m_filename);
+  OLA_ASSERT_TRUE(loader.Load());
+  loader.SetStopTime(stop_time);
+  if (start_time) {
+    loader.SetStartTime(start_time);
+  }
+
+  unsigned int time = start_time;
+  unsigned int universe;
+  DmxBuffer data;
+  unsigned int timeout;
+  while (loader.NextFrame(&universe, &data) == ShowLoader::OK) {
+    frames->push_back(FrameString(time, universe, data));
+    if (loader.NextTimeout(&timeout) != ShowLoader::OK) {
+      break;
+    }
+    time += timeout;
+  }
+  OLA_ASSERT_EQ(stop_time ? stop_time : END_TIME, time);
+}
+
+
+string ShowLoaderTest::FrameString(unsigned int time, unsigned int universe,
+                                   const DmxBuffer &data) {
+  std::ostringstream str;
+  str << time << " " << universe << " " << data.ToString();
+  return str.str();
+}
+
+
+/*
+ * Only the first slot changes, so the binary format uses delta frames between
+ * the key frames.
+ */
+DmxBuffer ShowLoaderTest::UniverseOneData(unsigned int frame) {
+  uint8_t slots[64];
+  slots[0] = frame;
+  for (unsigned int i = 1; i < sizeof(slots); i++) {
+    slots[i] = (i * 37 + 11) % 256;
+  }
+  return DmxBuffer(slots, sizeof(slots));
+}
+
+
+DmxBuffer ShowLoaderTest::UniverseTwoData(unsigned int frame) {
+  const uint8_t slots[] = {static_cast<uint8_t>(frame), 255, 0};
+  return DmxBuffer(slots, sizeof(slots));
+}
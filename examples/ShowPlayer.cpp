@@ -48,7 +48,11 @@ ShowPlayer::ShowPlayer(const string &filename)
     : m_loader(filename),
       m_infinite_loop(false),
       m_iteration_remaining(0),
-      m_loop_delay(0) {
+      m_loop_delay(0),
+      m_next_frame_time(0),
+      m_frame_count(0),
+      m_group_count(0),
+      m_total_lateness(0) {
 }
 
 ShowPlayer::~ShowPlayer() {}
@@ -68,10 +72,19 @@ int ShowPlayer::Init() {
 
 int ShowPlayer::Playback(unsigned int iterations,
                          unsigned int duration,
-                         unsigned int delay) {
+                         unsigned int delay,
+                         unsigned int start,
+                         unsigned int stop) {
   m_infinite_loop = iterations == 0 || duration != 0;
   m_iteration_remaining = iterations;
   m_loop_delay = delay;
+  m_loader.SetStopTime(stop);
+  if (start) {
+    m_loader.SetStartTime(start);
+  }
+
+  m_clock.CurrentTime(&m_iteration_start);
+  m_next_frame_time = 0;
   SendNextFrame();
 
   ola::io::SelectServer *ss = m_client.GetSelectServer();
@@ -85,55 +98,99 @@ int ShowPlayer::Playback(unsigned int iterations,
   return ola::EXIT_OK;
 }
 
-void ShowPlayer::SendNextFrame() {
-  DmxBuffer buffer;
-  unsigned int universe;
-  ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
-      m_client.GetSelectServer()->Terminate();
-      return;
-    default:
-      {}
+
+ola::TimeInterval ShowPlayer::MeanLateness() const {
+  if (!m_group_count) {
+    return ola::TimeInterval();
   }
+  return ola::TimeInterval(
+      m_total_lateness / static_cast<int64_t>(m_group_count));
+}
 
-  state = RegisterNextTimeout();
 
-  OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
-  ola::client::SendDMXArgs args;
-  m_client.GetClient()->SendDMX(universe, buffer, args);
+/**
+ * Send all frames up to the next non-zero timeout.
+ */
+void ShowPlayer::SendNextFrame() {
+  UpdateStats();
 
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
-      m_client.GetSelectServer()->Terminate();
+  DmxBuffer buffer;
+  unsigned int universe;
+  while (true) {
+    ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
+    switch (state) {
+      case ShowLoader::END_OF_FILE:
+        HandleEndOfFile();
+        return;
+      case ShowLoader::INVALID_LINE:
+        m_client.GetSelectServer()->Terminate();
+        return;
+      default:
+        {}
+    }
+
+    OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
+    ola::client::SendDMXArgs args;
+    m_client.GetClient()->SendDMX(universe, buffer, args);
+    m_frame_count++;
+
+    unsigned int timeout;
+    state = m_loader.NextTimeout(&timeout);
+    switch (state) {
+      case ShowLoader::END_OF_FILE:
+        HandleEndOfFile();
+        return;
+      case ShowLoader::INVALID_LINE:
+        m_client.GetSelectServer()->Terminate();
+        return;
+      default:
+        {}
+    }
+
+    if (timeout) {
+      m_next_frame_time += timeout;
+      ScheduleNextFrame();
       return;
-    default:
-      {}
+    }
   }
 }
 
 
 /**
- * Get the next time offset
+ * Register a timeout for the next group of frames, relative to the start of
+ * the show.
  */
-ShowLoader::State ShowPlayer::RegisterNextTimeout() {
-  unsigned int timeout;
-  ShowLoader::State state = m_loader.NextTimeout(&timeout);
-  if (state != ShowLoader::OK) {
-    return state;
+void ShowPlayer::ScheduleNextFrame() {
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+  ola::TimeStamp target = m_iteration_start + ola::TimeInterval(
+      static_cast<int64_t>(m_next_frame_time) * 1000);
+  ola::TimeInterval delay;
+  if (target > now) {
+    delay = target - now;
   }
 
-  OLA_INFO << "Registering timeout for " << timeout << "ms";
+  OLA_INFO << "Registering timeout for " << delay;
   m_client.GetSelectServer()->RegisterSingleTimeout(
-      timeout,
+      delay,
       ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
-  return state;
+}
+
+
+/**
+ * Record how late we are compared to when the frames should have been sent.
+ */
+void ShowPlayer::UpdateStats() {
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+  ola::TimeStamp target = m_iteration_start + ola::TimeInterval(
+      static_cast<int64_t>(m_next_frame_time) * 1000);
+  m_last_lateness = now > target ? now - target : ola::TimeInterval();
+  if (m_last_lateness > m_max_lateness) {
+    m_max_lateness = m_last_lateness;
+  }
+  m_total_lateness += m_last_lateness.AsInt();
+  m_group_count++;
 }
 
 
@@ -144,9 +201,11 @@ void ShowPlayer::HandleEndOfFile() {
   m_iteration_remaining--;
   if (m_infinite_loop || m_iteration_remaining > 0) {
     m_loader.Reset();
-    m_client.GetSelectServer()->RegisterSingleTimeout(
-        m_loop_delay,
-        ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
+    // The next iteration starts relative to the end of this one.
+    m_iteration_start += ola::TimeInterval(
+        static_cast<int64_t>(m_next_frame_time + m_loop_delay) * 1000);
+    m_next_frame_time = 0;
+    ScheduleNextFrame();
     return;
   } else {
     // stop the show
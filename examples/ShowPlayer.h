@@ -18,8 +18,10 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
+#include <stdint.h>
 
 #include <string>
 #include <fstream>
@@ -31,6 +33,11 @@
 
 /**
  * @brief A class which plays back recorded show files.
+ *
+ * Frames are scheduled against the time playback started, rather than the
+ * time the previous frame was sent, so timer latency doesn't accumulate over
+ * a long show. All frames with the same timestamp are sent from a single
+ * timer callback.
  */
 class ShowPlayer {
  public:
@@ -53,21 +60,54 @@ class ShowPlayer {
    * @param duration the duration in seconds after which playback is stopped.
    * @param delay the hold time at the end of a show before playback starts
    * from the beginning again.
+   * @param start the time in ms from the start of the show to begin playback.
+   * @param stop the time in ms from the start of the show to end playback, 0
+   * means play to the end.
    */
   int Playback(unsigned int iterations,
                unsigned int duration,
-               unsigned int delay);
+               unsigned int delay,
+               unsigned int start = 0,
+               unsigned int stop = 0);
+
+  /**
+   * @brief The number of DMX frames sent.
+   */
+  uint64_t FrameCount() const { return m_frame_count; }
+
+  /**
+   * @name Timing statistics
+   * @brief How late each group of frames was sent, compared to the show time.
+   * @{
+   */
+  ola::TimeInterval MaxLateness() const { return m_max_lateness; }
+  ola::TimeInterval MeanLateness() const;
+  ola::TimeInterval LastLateness() const { return m_last_lateness; }
+  /**
+   * @}
+   */
 
  private:
   ola::client::OlaClientWrapper m_client;
   ShowLoader m_loader;
+  ola::Clock m_clock;
   bool m_infinite_loop;
   unsigned int m_iteration_remaining;
   unsigned int m_loop_delay;
+  // The wall clock time the current iteration of the show started.
+  ola::TimeStamp m_iteration_start;
+  // The show time of the next group of frames, in ms.
+  uint64_t m_next_frame_time;
+
+  uint64_t m_frame_count;
+  uint64_t m_group_count;
+  int64_t m_total_lateness;
+  ola::TimeInterval m_max_lateness;
+  ola::TimeInterval m_last_lateness;
 
   void SendNextFrame();
-  ShowLoader::State RegisterNextTimeout();
-  bool ReadNextFrame(unsigned int *universe, ola::DmxBuffer *data);
+  void ScheduleNextFrame();
+  void UpdateStats();
   void HandleEndOfFile();
 };
 #endif  // EXAMPLES_SHOWPLAYER_H_
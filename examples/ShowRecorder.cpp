@@ -47,8 +47,11 @@ using std::vector;
 
 
 ShowRecorder::ShowRecorder(const string &filename,
-                           const vector<unsigned int> &universes)
-    : m_saver(filename),
+                           const vector<unsigned int> &universes,
+                           ShowSaver::Format format,
+                           unsigned int buffer_frames)
+    : m_saver(filename, format),
+      m_writer(&m_saver, buffer_frames),
       m_universes(universes),
       m_frame_count(0) {
 }
@@ -90,7 +93,15 @@ int ShowRecorder::Init() {
  * Record the show.
  */
 int ShowRecorder::Record() {
+  // This is started here rather than in Init() so that it inherits the signal
+  // mask set up by the caller.
+  if (!m_writer.Start()) {
+    OLA_FATAL << "Failed to start the writer thread";
+    return ola::EXIT_OSERR;
+  }
   m_client.GetSelectServer()->Run();
+  m_writer.Stop();
+  m_saver.Close();
   return ola::EXIT_OK;
 }
 
@@ -110,7 +121,7 @@ void ShowRecorder::NewFrame(const ola::client::DMXMetadata &meta,
                             const ola::DmxBuffer &data) {
   ola::TimeStamp now;
   m_clock.CurrentTime(&now);
-  m_saver.NewFrame(now, meta.universe, data);
+  m_writer.AddFrame(now, meta.universe, data);
   m_frame_count++;
 }
 
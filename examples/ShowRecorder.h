@@ -27,17 +27,24 @@
 #include <vector>
 
 #include "examples/ShowSaver.h"
+#include "examples/ShowWriterThread.h"
 
 #ifndef EXAMPLES_SHOWRECORDER_H_
 #define EXAMPLES_SHOWRECORDER_H_
 
 /**
- * The show player class
+ * The show recorder class.
+ *
+ * Frames are written to disk by a ShowWriterThread, so slow disk I/O doesn't
+ * hold up the client's event loop.
  */
 class ShowRecorder {
  public:
   ShowRecorder(const std::string &filename,
-               const std::vector<unsigned int> &universes);
+               const std::vector<unsigned int> &universes,
+               ShowSaver::Format format = ShowSaver::TEXT_FORMAT,
+               unsigned int buffer_frames =
+                   ShowWriterThread::DEFAULT_CAPACITY);
   ~ShowRecorder();
 
   int Init();
@@ -45,10 +52,12 @@ class ShowRecorder {
   void Stop();
 
   uint64_t FrameCount() const { return m_frame_count; }
+  uint64_t DroppedFrames() const { return m_writer.DroppedFrames(); }
 
  private:
   ola::client::OlaClientWrapper m_client;
   ShowSaver m_saver;
+  ShowWriterThread m_writer;
   std::vector<unsigned int> m_universes;
   ola::Clock m_clock;
   uint64_t m_frame_count;
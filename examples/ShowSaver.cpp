@@ -30,6 +30,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "examples/ShowSaver.h"
 
@@ -40,8 +41,11 @@ using std::endl;
 
 const char ShowSaver::OLA_SHOW_HEADER[] = "OLA Show";
 
-ShowSaver::ShowSaver(const string &filename)
+ShowSaver::ShowSaver(const string &filename, Format format)
     : m_filename(filename) {
+  if (format == BINARY_FORMAT) {
+    m_binary_writer.reset(new BinaryShowWriter(filename));
+  }
 }
 
 
@@ -55,6 +59,13 @@ ShowSaver::~ShowSaver() {
  * @returns true if we could open the file, false otherwise.
  */
 bool ShowSaver::Open() {
+  if (m_binary_writer.get()) {
+    return m_binary_writer->Open();
+  }
+
+  // Frames arrive at a high rate, so write in large blocks.
+  m_file_buffer.resize(BinaryShow::FILE_BUFFER_SIZE);
+  m_show_file.rdbuf()->pubsetbuf(&m_file_buffer[0], m_file_buffer.size());
   m_show_file.open(m_filename.data());
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
@@ -71,6 +82,11 @@ bool ShowSaver::Open() {
  * Close the show file
  */
 void ShowSaver::Close() {
+  if (m_binary_writer.get()) {
+    m_binary_writer->Close();
+    return;
+  }
+
   if (m_show_file.is_open()) {
     m_show_file.close();
   }
@@ -83,14 +99,34 @@ void ShowSaver::Close() {
 bool ShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
                          unsigned int universe,
                          const ola::DmxBuffer &data) {
+  if (m_binary_writer.get()) {
+    return m_binary_writer->NewFrame(arrival_time, universe, data);
+  }
+
   // TODO(simon): add much better error handling here
   if (m_last_frame.IsSet()) {
     // this is not the first frame so write the delay in ms
     const ola::TimeInterval delta = arrival_time - m_last_frame;
 
-    m_show_file << delta.InMilliSeconds() << endl;
+    m_show_file << delta.InMilliSeconds() << '\n';
   }
   m_last_frame = arrival_time;
-  m_show_file << universe << " " << data.ToString() << endl;
+  m_show_file << universe << " " << data.ToString() << '\n';
   return true;
 }
+
+
+/**
+ * Record the end of the show. For text files this is written as a trailing
+ * delay.
+ */
+void ShowSaver::SetEndTime(const ola::TimeStamp &end_time) {
+  if (m_binary_writer.get()) {
+    m_binary_writer->SetEndTime(end_time);
+    return;
+  }
+
+  if (m_last_frame.IsSet() && end_time > m_last_frame) {
+    m_show_file << (end_time - m_last_frame).InMilliSeconds() << '\n';
+  }
+}
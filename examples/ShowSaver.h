@@ -21,8 +21,12 @@
 #include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 
-#include <string>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "examples/BinaryShow.h"
 
 #ifndef EXAMPLES_SHOWSAVER_H_
 #define EXAMPLES_SHOWSAVER_H_
@@ -32,7 +36,13 @@
  */
 class ShowSaver {
  public:
-  explicit ShowSaver(const std::string &filename);
+  typedef enum {
+    TEXT_FORMAT,
+    BINARY_FORMAT,
+  } Format;
+
+  explicit ShowSaver(const std::string &filename,
+                     Format format = TEXT_FORMAT);
   ~ShowSaver();
 
   bool Open();
@@ -42,9 +52,18 @@ class ShowSaver {
                 unsigned int universe,
                 const ola::DmxBuffer &data);
 
+  /**
+   * @brief Record the end of the show, if it's later than the last frame.
+   *
+   * This must be called at most once, before Close().
+   */
+  void SetEndTime(const ola::TimeStamp &end_time);
+
  private:
   const std::string m_filename;
   std::ofstream m_show_file;
+  std::vector<char> m_file_buffer;
+  std::auto_ptr<BinaryShowWriter> m_binary_writer;
   ola::TimeStamp m_last_frame;
 
   static const char OLA_SHOW_HEADER[];
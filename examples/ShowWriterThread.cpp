@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowWriterThread.cpp
+ * Write show frames to disk from a separate thread.
+ * Copyright (C) 2026 agent
+ */
+
+#include <string.h>
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <algorithm>
+
+#include "examples/ShowWriterThread.h"
+
+using ola::DmxBuffer;
+using ola::thread::MutexLocker;
+
+const unsigned int ShowWriterThread::DEFAULT_CAPACITY;
+
+ShowWriterThread::ShowWriterThread(ShowSaver *saver, unsigned int capacity)
+    : ola::thread::Thread(Thread::Options("show-writer")),
+      m_saver(saver),
+      // One slot is always left empty, so we can tell full from empty.
+      m_frames(std::max(capacity, 1u) + 1),
+      m_head(0),
+      m_tail(0),
+      m_terminate(false),
+      m_dropped(0),
+      m_written(0),
+      m_write_error(false) {
+}
+
+
+ShowWriterThread::~ShowWriterThread() {
+  Stop();
+}
+
+
+bool ShowWriterThread::AddFrame(const ola::TimeStamp &arrival_time,
+                                unsigned int universe,
+                                const DmxBuffer &data) {
+  MutexLocker lock(&m_mutex);
+  const unsigned int next = (m_head + 1) % m_frames.size();
+  if (next == m_tail) {
+    m_dropped++;
+    return false;
+  }
+
+  // The writer doesn't touch slots between m_tail and m_head, so it's safe to
+  // fill this one while it's writing.
+  Frame &frame = m_frames[m_head];
+  frame.arrival_time = arrival_time;
+  frame.universe = universe;
+  frame.length = data.Size();
+  memcpy(frame.data, data.GetRaw(), frame.length);
+
+  const bool was_empty = m_head == m_tail;
+  m_head = next;
+  if (was_empty) {
+    m_condition.Signal();
+  }
+  return true;
+}
+
+
+void ShowWriterThread::Stop() {
+  {
+    MutexLocker lock(&m_mutex);
+    if (m_terminate) {
+      return;
+    }
+    m_terminate = true;
+    m_condition.Signal();
+  }
+  Join();
+}
+
+
+uint64_t ShowWriterThread::DroppedFrames() const {
+  MutexLocker lock(&m_mutex);
+  return m_dropped;
+}
+
+
+uint64_t ShowWriterThread::WrittenFrames() const {
+  MutexLocker lock(&m_mutex);
+  return m_written;
+}
+
+
+void *ShowWriterThread::Run() {
+  DmxBuffer buffer;
+  while (true) {
+    unsigned int head, tail;
+    {
+      MutexLocker lock(&m_mutex);
+      while (m_head == m_tail && !m_terminate) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (m_head == m_tail) {
+        return NULL;
+      }
+      head = m_head;
+      tail = m_tail;
+    }
+
+    // Write everything that was queued, without holding the lock.
+    unsigned int written = 0;
+    for (; tail != head; tail = (tail + 1) % m_frames.size()) {
+      const Frame &frame = m_frames[tail];
+      buffer.Set(frame.data, frame.length);
+      if (!m_saver->NewFrame(frame.arrival_time, frame.universe, buffer) &&
+          !m_write_error) {
+        OLA_WARN << "Failed to write to the show file";
+        m_write_error = true;
+      }
+      written++;
+    }
+
+    MutexLocker lock(&m_mutex);
+    m_tail = tail;
+    m_written += written;
+  }
+}
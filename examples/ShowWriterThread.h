@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowWriterThread.h
+ * Write show frames to disk from a separate thread.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "examples/ShowSaver.h"
+
+#ifndef EXAMPLES_SHOWWRITERTHREAD_H_
+#define EXAMPLES_SHOWWRITERTHREAD_H_
+
+/**
+ * @brief Queue frames for a ShowSaver and write them from a separate thread.
+ *
+ * Frames are copied into a fixed size ring so AddFrame() never allocates or
+ * blocks on disk I/O. If the writer thread falls far enough behind that the
+ * ring fills up, new frames are dropped and counted.
+ */
+class ShowWriterThread : public ola::thread::Thread {
+ public:
+  /**
+   * @brief Create a new ShowWriterThread.
+   * @param saver the ShowSaver to write to, ownership is not transferred. It
+   *   must be open, and shouldn't be used by the caller until Stop() returns.
+   * @param capacity the maximum number of frames to queue.
+   */
+  ShowWriterThread(ShowSaver *saver, unsigned int capacity);
+  ~ShowWriterThread();
+
+  /**
+   * @brief Queue a frame to be written.
+   * @returns false if the queue was full and the frame was dropped.
+   */
+  bool AddFrame(const ola::TimeStamp &arrival_time,
+                unsigned int universe,
+                const ola::DmxBuffer &data);
+
+  /**
+   * @brief Write the queued frames and stop the thread.
+   */
+  void Stop();
+
+  uint64_t DroppedFrames() const;
+  uint64_t WrittenFrames() const;
+
+  // About one second at 1000 universes of 44 frames per second.
+  static const unsigned int DEFAULT_CAPACITY = 44000;
+
+ protected:
+  void *Run();
+
+ private:
+  struct Frame {
+    ola::TimeStamp arrival_time;
+    unsigned int universe;
+    unsigned int length;
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  };
+
+  ShowSaver *m_saver;
+  std::vector<Frame> m_frames;
+  // m_head is the next slot AddFrame() will fill, m_tail is the next slot the
+  // writer will read. The ring is empty when they are equal.
+  unsigned int m_head;  // GUARDED_BY(m_mutex);
+  unsigned int m_tail;  // GUARDED_BY(m_mutex);
+  bool m_terminate;  // GUARDED_BY(m_mutex);
+  uint64_t m_dropped;  // GUARDED_BY(m_mutex);
+  uint64_t m_written;  // GUARDED_BY(m_mutex);
+  bool m_write_error;
+  mutable ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+
+  DISALLOW_COPY_AND_ASSIGN(ShowWriterThread);
+};
+#endif  // EXAMPLES_SHOWWRITERTHREAD_H_
@@ -0,0 +1,340 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ola-rdm-collector.cpp
+ * Fetch every parameter from every RDM device and print them as JSON lines.
+ * Copyright (C) 2026 agent
+ */
+
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/client/ClientRDMAPIShim.h>
+#include <ola/client/ClientWrapper.h>
+#include <ola/client/OlaClient.h>
+#include <ola/io/SelectServer.h>
+#include <ola/rdm/PidStoreHelper.h>
+#include <ola/rdm/RDMCollector.h>
+#include <ola/rdm/RDMHelper.h>
+#include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using ola::client::OlaClient;
+using ola::client::OlaClientWrapper;
+using ola::client::OlaUniverse;
+using ola::client::Result;
+using ola::io::SelectServer;
+using ola::rdm::PidStoreHelper;
+using ola::rdm::RDMCollector;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::cerr;
+using std::endl;
+using std::ostream;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(universe, u, 0,
+                "Only collect from this universe, rather than all universes");
+DEFINE_s_default_bool(full, f, false,
+                      "Run full RDM discovery before collecting");
+DEFINE_s_default_bool(incremental, i, false,
+                      "Run incremental RDM discovery before collecting");
+DEFINE_s_string(output, o, "",
+                "Write the results to this file rather than stdout");
+DEFINE_s_string(pid_location, p, "",
+                "The directory to read PID definitions from");
+DEFINE_uint8(attempts, 3, "The number of times to send each request");
+DEFINE_uint32(retry_delay, 100, "The delay in ms before retrying a request");
+
+/*
+ * Format binary data as a string of hex digits.
+ */
+string HexString(const string &data) {
+  std::ostringstream str;
+  str << std::hex << std::setfill('0');
+  string::const_iterator iter = data.begin();
+  for (; iter != data.end(); ++iter) {
+    str << std::setw(2) << static_cast<unsigned int>(
+        static_cast<uint8_t>(*iter));
+  }
+  return str.str();
+}
+
+
+/**
+ * Runs discovery on each universe and feeds the UIDs to an RDMCollector.
+ */
+class CollectorClient {
+ public:
+  CollectorClient(OlaClientWrapper *wrapper,
+                  PidStoreHelper *pid_helper,
+                  ostream *output,
+                  const RDMCollector::Options &options)
+      : m_ss(wrapper->GetSelectServer()),
+        m_client(wrapper->GetClient()),
+        m_pid_helper(pid_helper),
+        m_output(output),
+        m_shim(m_client),
+        m_collector(
+            &m_shim, m_ss,
+            ola::NewCallback(this, &CollectorClient::NewResult),
+            ola::NewCallback(this, &CollectorClient::CollectorIdle),
+            options),
+        m_pending_discoveries(0),
+        m_device_count(0) {
+  }
+
+  void Start();
+
+  unsigned int DeviceCount() const { return m_device_count; }
+  const RDMCollector::Stats &GetStats() const {
+    return m_collector.GetStats();
+  }
+
+ private:
+  SelectServer *m_ss;
+  OlaClient *m_client;
+  PidStoreHelper *m_pid_helper;
+  ostream *m_output;
+  ola::client::ClientRDMAPIShim m_shim;
+  RDMCollector m_collector;
+  unsigned int m_pending_discoveries;
+  unsigned int m_device_count;
+
+  void UniverseList(const Result &result,
+                    const vector<OlaUniverse> &universes);
+  void StartDiscovery(unsigned int universe);
+  void DiscoveryComplete(unsigned int universe,
+                         const Result &result,
+                         const UIDSet &uids);
+  void NewResult(const RDMCollector::Result &result);
+  void CollectorIdle();
+  void TerminateIfDone();
+  string DecodeResponse(const RDMCollector::Result &result);
+};
+
+
+void CollectorClient::Start() {
+  if (FLAGS_universe.present()) {
+    StartDiscovery(FLAGS_universe);
+  } else {
+    m_pending_discoveries++;
+    m_client->FetchUniverseList(
+        ola::NewSingleCallback(this, &CollectorClient::UniverseList));
+  }
+}
+
+
+void CollectorClient::UniverseList(const Result &result,
+                                   const vector<OlaUniverse> &universes) {
+  m_pending_discoveries--;
+  if (!result.Success()) {
+    cerr << "Failed to fetch the universe list: " << result.Error() << endl;
+  }
+
+  vector<OlaUniverse>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    StartDiscovery(iter->Id());
+  }
+  TerminateIfDone();
+}
+
+
+/*
+ * Discovery runs on all universes at once, collection starts on each universe
+ * as soon as its discovery completes.
+ */
+void CollectorClient::StartDiscovery(unsigned int universe) {
+  ola::client::DiscoveryType discovery_type = ola::client::DISCOVERY_CACHED;
+  if (FLAGS_full) {
+    discovery_type = ola::client::DISCOVERY_FULL;
+  } else if (FLAGS_incremental) {
+    discovery_type = ola::client::DISCOVERY_INCREMENTAL;
+  }
+
+  m_pending_discoveries++;
+  m_client->RunDiscovery(
+      universe, discovery_type,
+      ola::NewSingleCallback(this, &CollectorClient::DiscoveryComplete,
+                             universe));
+}
+
+
+void CollectorClient::DiscoveryComplete(unsigned int universe,
+                                        const Result &result,
+                                        const UIDSet &uids) {
+  m_pending_discoveries--;
+  if (result.Success()) {
+    OLA_INFO << "Found " << uids.Size() << " devices on universe "
+             << universe;
+    m_device_count += uids.Size();
+    m_collector.AddDevices(universe, uids);
+  } else {
+    OLA_WARN << "Discovery failed for universe " << universe << ": "
+             << result.Error();
+  }
+  TerminateIfDone();
+}
+
+
+/*
+ * Write a result as a single line of JSON.
+ */
+void CollectorClient::NewResult(const RDMCollector::Result &result) {
+  const ola::rdm::PidDescriptor *descriptor = m_pid_helper->GetDescriptor(
+      result.pid, result.uid.ManufacturerId());
+
+  std::ostringstream str;
+  str << "{\"universe\": " << result.universe
+      << ", \"uid\": \"" << result.uid << "\""
+      << ", \"sub_device\": " << result.sub_device
+      << ", \"pid\": " << result.pid;
+  if (descriptor) {
+    str << ", \"pid_name\": \"" << ola::EscapeString(descriptor->Name())
+        << "\"";
+  }
+  str << ", \"pid_class\": \""
+      << RDMCollector::PidClassToString(result.pid_class) << "\"";
+  if (!result.request_data.empty()) {
+    str << ", \"request_data\": \""
+        << HexString(result.request_data) << "\"";
+  }
+  str << ", \"result\": \""
+      << RDMCollector::ResultTypeToString(result.type) << "\""
+      << ", \"attempts\": " << result.attempts;
+
+  switch (result.type) {
+    case RDMCollector::RESULT_ACK:
+      str << ", \"data\": \"" << HexString(result.data) << "\"";
+      if (descriptor) {
+        string value = DecodeResponse(result);
+        if (!value.empty()) {
+          str << ", \"value\": \"" << ola::EscapeString(value) << "\"";
+        }
+      }
+      break;
+    case RDMCollector::RESULT_NACK:
+      str << ", \"nack_reason\": \""
+          << ola::EscapeString(
+                 ola::rdm::NackReasonToString(result.nack_reason))
+          << "\"";
+      break;
+    default:
+      str << ", \"error\": \"" << ola::EscapeString(result.error) << "\"";
+  }
+  str << "}";
+  *m_output << str.str() << endl;
+}
+
+
+string CollectorClient::DecodeResponse(const RDMCollector::Result &result) {
+  const ola::rdm::PidDescriptor *pid_descriptor =
+      m_pid_helper->GetDescriptor(result.pid, result.uid.ManufacturerId());
+  if (!pid_descriptor || !pid_descriptor->GetResponse()) {
+    return "";
+  }
+
+  auto_ptr<const ola::messaging::Message> message(
+      m_pid_helper->DeserializeMessage(
+          pid_descriptor->GetResponse(),
+          reinterpret_cast<const uint8_t*>(result.data.data()),
+          result.data.size()));
+  if (!message.get()) {
+    return "";
+  }
+  string value = m_pid_helper->MessageToString(message.get());
+  ola::StripSuffix(&value, "\n");
+  return value;
+}
+
+
+void CollectorClient::CollectorIdle() {
+  TerminateIfDone();
+}
+
+
+void CollectorClient::TerminateIfDone() {
+  if (m_pending_discoveries == 0 && m_collector.Idle()) {
+    m_ss->Terminate();
+  }
+}
+
+
+/*
+ * Main
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(
+      &argc,
+      argv,
+      "[--universe <universe>] [--full|--incremental] [--output <file>]",
+      "Fetch every parameter from the RDM devices on all universes, and "
+      "print the responses as JSON, one line per response.");
+
+  if (FLAGS_full && FLAGS_incremental) {
+    cerr << "Only one of -i and -f can be specified" << endl;
+    exit(ola::EXIT_USAGE);
+  }
+
+  PidStoreHelper pid_helper(FLAGS_pid_location.str());
+  if (!pid_helper.Init()) {
+    OLA_WARN << "Failed to load the PID store, names won't be available";
+  }
+
+  std::ofstream output_file;
+  if (!FLAGS_output.str().empty()) {
+    output_file.open(FLAGS_output.str().c_str());
+    if (!output_file.is_open()) {
+      cerr << "Failed to open " << FLAGS_output.str() << endl;
+      exit(ola::EXIT_CANTCREAT);
+    }
+  }
+
+  OlaClientWrapper ola_client;
+  if (!ola_client.Setup()) {
+    OLA_FATAL << "Setup failed";
+    exit(ola::EXIT_UNAVAILABLE);
+  }
+
+  RDMCollector::Options options;
+  options.max_attempts = FLAGS_attempts;
+  options.retry_delay = FLAGS_retry_delay;
+
+  CollectorClient collector(
+      &ola_client, &pid_helper,
+      output_file.is_open() ? &output_file : &std::cout, options);
+  collector.Start();
+  ola_client.GetSelectServer()->Run();
+
+  const RDMCollector::Stats &stats = collector.GetStats();
+  OLA_INFO << "Collected from " << collector.DeviceCount() << " devices: "
+           << stats.request_count << " requests, " << stats.ack_count
+           << " ACKs, " << stats.nack_count << " NACKs, "
+           << stats.failure_count << " failures, " << stats.retry_count
+           << " retries";
+  return ola::EXIT_OK;
+}
@@ -59,7 +59,7 @@ typedef struct {
   bool help;       // show the help
   string pid_location;  // alt pid store
   bool list_pids;  // show the pid list
-  int universe;         // universe id
+  int universe;         // universe id, -1 to look up the UID
   UID *uid;         // uid
   uint16_t sub_device;  // the sub device
   string pid;      // pid to get/set
@@ -90,7 +90,7 @@ void ParseOptions(int argc, char *argv[], options *opts) {
   opts->pid_location = "";
   opts->list_pids = false;
   opts->help = false;
-  opts->universe = 1;
+  opts->universe = -1;
   opts->uid = NULL;
   opts->sub_device = 0;
   opts->display_frames = false;
@@ -158,7 +158,7 @@ void ParseOptions(int argc, char *argv[], options *opts) {
  */
 void DisplayGetPidHelp(const options &opts) {
   cout << "Usage: " << opts.cmd <<
-  " --universe <universe> --uid <uid> <pid> <value>\n"
+  " [--universe <universe>] --uid <uid> <pid> <value>\n"
   "\n"
   "Get the value of a PID for a device.\n"
   "Use '" << opts.cmd << " --list-pids' to get a list of PIDs.\n"
@@ -169,7 +169,8 @@ void DisplayGetPidHelp(const options &opts) {
   "  -h, --help                display this help message and exit.\n"
   "  -l, --list-pids           display a list of PIDs\n"
   "  -p, --pid-location        the directory to read PID definitions from\n"
-  "  -u, --universe <universe> universe number.\n"
+  "  -u, --universe <universe> universe number, defaults to the universe the\n"
+  "                            UID was discovered on.\n"
   << endl;
 }
 
@@ -179,7 +180,7 @@ void DisplayGetPidHelp(const options &opts) {
  */
 void DisplaySetPidHelp(const options &opts) {
   cout << "Usage: " << opts.cmd <<
-  " --universe <universe> --uid <uid> <pid> <value>\n"
+  " [--universe <universe>] --uid <uid> <pid> <value>\n"
   "\n"
   "Set the value of a PID for a device.\n"
   "Use '" << opts.cmd << " --list-pids' to get a list of PIDs.\n"
@@ -190,7 +191,8 @@ void DisplaySetPidHelp(const options &opts) {
   "  -h, --help                display this help message and exit.\n"
   "  -l, --list-pids           display a list of PIDs\n"
   "  -p, --pid-location        the directory to read PID definitions from\n"
-  "  -u, --universe <universe> universe number.\n"
+  "  -u, --universe <universe> universe number, defaults to the universe the\n"
+  "                            UID was discovered on.\n"
   << endl;
 }
 
@@ -231,6 +233,7 @@ class RDMController {
 
   bool InitPidHelper();
   bool Setup();
+  unsigned int FindUniverse(const UID &uid);
   const PidStoreHelper& PidHelper() const { return m_pid_helper; }
 
   int PerformRequestAndWait(unsigned int universe,
@@ -247,6 +250,8 @@ class RDMController {
   void ShowFrames(const ola::client::RDMMetadata &metadata);
 
  private:
+  static const unsigned int DEFAULT_UNIVERSE = 1;
+
   struct PendingRequest {
    public:
     PendingRequest()
@@ -266,7 +271,10 @@ class RDMController {
   ola::client::OlaClientWrapper m_ola_client;
   PidStoreHelper m_pid_helper;
   PendingRequest m_pending_request;
+  unsigned int m_found_universe;
 
+  void HandleFindUID(const ola::client::Result &result,
+                     unsigned int universe);
   void FetchQueuedMessage();
   void PrintRemainingMessages(uint8_t message_count);
   void HandleAckResponse(uint16_t manufacturer_id,
@@ -279,7 +287,8 @@ class RDMController {
 
 RDMController::RDMController(string pid_location, bool show_frames)
     : m_show_frames(show_frames),
-      m_pid_helper(pid_location) {
+      m_pid_helper(pid_location),
+      m_found_universe(DEFAULT_UNIVERSE) {
 }
 
 
@@ -293,6 +302,30 @@ bool RDMController::Setup() {
 }
 
 
+/**
+ * Ask the daemon which universe a UID was discovered on. If the UID hasn't
+ * been discovered, fall back to the default universe.
+ */
+unsigned int RDMController::FindUniverse(const UID &uid) {
+  m_ola_client.GetClient()->FindUID(
+      uid, ola::NewSingleCallback(this, &RDMController::HandleFindUID));
+  m_ola_client.GetSelectServer()->Run();
+  return m_found_universe;
+}
+
+
+void RDMController::HandleFindUID(const ola::client::Result &result,
+                                  unsigned int universe) {
+  if (result.Success()) {
+    m_found_universe = universe;
+  } else {
+    OLA_INFO << "Couldn't find the universe for the UID: " << result.Error()
+             << ", using universe " << DEFAULT_UNIVERSE;
+  }
+  m_ola_client.GetSelectServer()->Terminate();
+}
+
+
 /**
  * Handle the RDM response
  */
@@ -630,7 +663,12 @@ int main(int argc, char *argv[]) {
   vector<string>::iterator args_iter = opts.args.begin();
   copy(++args_iter, opts.args.end(), inputs.begin());
 
-  return controller.PerformRequestAndWait(opts.universe,
+  unsigned int universe = opts.universe;
+  if (opts.universe < 0) {
+    universe = controller.FindUniverse(dest_uid);
+  }
+
+  return controller.PerformRequestAndWait(universe,
                                           dest_uid,
                                           opts.sub_device,
                                           opts.args[0],
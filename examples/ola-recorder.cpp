@@ -19,6 +19,7 @@
  */
 
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
@@ -36,6 +37,8 @@
 #include "examples/ShowPlayer.h"
 #include "examples/ShowLoader.h"
 #include "examples/ShowRecorder.h"
+#include "examples/ShowSaver.h"
+#include "examples/ShowWriterThread.h"
 
 using std::auto_ptr;
 using std::cout;
@@ -47,6 +50,15 @@ using std::string;
 DEFINE_s_string(playback, p, "", "The show file to playback.");
 DEFINE_s_string(record, r, "", "The show file to record data to.");
 DEFINE_string(verify, "", "The show file to verify.");
+DEFINE_string(convert, "", "The show file to convert, use with --output.");
+DEFINE_s_string(output, o, "", "The file to write the converted show to.");
+DEFINE_string(format, "text",
+              "The format to record or convert to, text or binary.");
+DEFINE_uint32(record_buffer, ShowWriterThread::DEFAULT_CAPACITY,
+              "The number of frames to buffer while recording.");
+DEFINE_uint32(start, 0, "The time (ms) in the show to start playback from.");
+DEFINE_uint32(stop, 0,
+              "The time (ms) in the show to stop playback at, 0 for the end.");
 DEFINE_s_string(universes, u, "",
                 "A comma separated list of universes to record");
 DEFINE_s_uint32(delay, d, 0, "The delay in ms between successive iterations.");
@@ -59,6 +71,20 @@ void TerminateRecorder(ShowRecorder *recorder) {
   recorder->Stop();
 }
 
+/**
+ * Get the show format from the --format flag
+ */
+ShowSaver::Format GetFormat() {
+  if (FLAGS_format.str() == "text") {
+    return ShowSaver::TEXT_FORMAT;
+  } else if (FLAGS_format.str() == "binary") {
+    return ShowSaver::BINARY_FORMAT;
+  }
+  OLA_FATAL << "Unknown format " << FLAGS_format.str()
+            << ", must be text or binary";
+  exit(ola::EXIT_USAGE);
+}
+
 /**
  * Record a show
  */
@@ -81,7 +107,8 @@ int RecordShow() {
     universes.push_back(universe);
   }
 
-  ShowRecorder show_recorder(FLAGS_record.str(), universes);
+  ShowRecorder show_recorder(FLAGS_record.str(), universes, GetFormat(),
+                             FLAGS_record_buffer);
   int status = show_recorder.Init();
   if (status)
     return status;
@@ -98,7 +125,8 @@ int RecordShow() {
     }
     show_recorder.Record();
   }
-  cout << "Saved " << show_recorder.FrameCount() << " frames" << endl;
+  cout << "Saved " << show_recorder.FrameCount() - show_recorder.DroppedFrames()
+       << " frames, dropped " << show_recorder.DroppedFrames() << endl;
   return ola::EXIT_OK;
 }
 
@@ -110,6 +138,8 @@ int VerifyShow(const string &filename) {
   ShowLoader loader(filename);
   if (!loader.Load())
     return ola::EXIT_NOINPUT;
+  loader.SetStartTime(FLAGS_start);
+  loader.SetStopTime(FLAGS_stop);
 
   map<unsigned int, unsigned int> frames_by_universe;
   uint64_t total_time = 0;
@@ -151,28 +181,98 @@ int VerifyShow(const string &filename) {
   }
 }
 
+
+/**
+ * Convert a show file between the text and binary formats
+ */
+int ConvertShow(const string &input, const string &output) {
+  if (output.empty()) {
+    OLA_FATAL << "No output file specified, use -o";
+    exit(ola::EXIT_USAGE);
+  }
+
+  ShowLoader loader(input);
+  if (!loader.Load())
+    return ola::EXIT_NOINPUT;
+  loader.SetStartTime(FLAGS_start);
+  loader.SetStopTime(FLAGS_stop);
+
+  ShowSaver saver(output, GetFormat());
+  if (!saver.Open())
+    return ola::EXIT_CANTCREAT;
+
+  // The saver only uses the time between frames, so any start time will do.
+  ola::Clock clock;
+  ola::TimeStamp show_time;
+  clock.CurrentTime(&show_time);
+  ola::TimeStamp last_frame_time = show_time;
+
+  unsigned int universe;
+  ola::DmxBuffer buffer;
+  unsigned int timeout;
+  unsigned int frames = 0;
+  ShowLoader::State state;
+  while (true) {
+    state = loader.NextFrame(&universe, &buffer);
+    if (state != ShowLoader::OK)
+      break;
+    if (!saver.NewFrame(show_time, universe, buffer)) {
+      OLA_FATAL << "Failed to write to " << output;
+      return ola::EXIT_IOERR;
+    }
+    last_frame_time = show_time;
+    frames++;
+
+    state = loader.NextTimeout(&timeout);
+    if (state != ShowLoader::OK)
+      break;
+    show_time += ola::TimeInterval(static_cast<int64_t>(timeout) * 1000);
+  }
+
+  if (state != ShowLoader::END_OF_FILE) {
+    OLA_FATAL << "Error loading show, got state " << state;
+    return ola::EXIT_DATAERR;
+  }
+
+  if (show_time > last_frame_time) {
+    saver.SetEndTime(show_time);
+  }
+  saver.Close();
+  cout << "Converted " << frames << " frames" << endl;
+  return ola::EXIT_OK;
+}
+
 /*
  * Main
  */
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv,
                "[--record <file> --universes <universe_list>] [--playback "
-               "<file>] [--verify <file>]",
+               "<file>] [--verify <file>] [--convert <file> --output <file>]",
                "Record a series of universes, or playback a previously "
-               "recorded show.");
+               "recorded show. Shows can be saved as text or in an indexed "
+               "binary format which allows fast seeking.");
 
   if (!FLAGS_playback.str().empty()) {
     ShowPlayer player(FLAGS_playback.str());
     int status = player.Init();
-    if (!status)
-      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay);
+    if (!status) {
+      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay,
+                               FLAGS_start, FLAGS_stop);
+      cout << "Sent " << player.FrameCount() << " frames, lateness: mean "
+           << player.MeanLateness() << ", max " << player.MaxLateness()
+           << ", last " << player.LastLateness() << endl;
+    }
     return status;
   } else if (!FLAGS_record.str().empty()) {
     return RecordShow();
   } else if (!FLAGS_verify.str().empty()) {
     return VerifyShow(FLAGS_verify.str());
+  } else if (!FLAGS_convert.str().empty()) {
+    return ConvertShow(FLAGS_convert.str(), FLAGS_output.str());
   } else {
-    OLA_FATAL << "One of --record or --playback or --verify must be provided";
+    OLA_FATAL << "One of --record, --playback, --verify or --convert must be "
+                 "provided";
     ola::DisplayUsage();
   }
   return ola::EXIT_OK;
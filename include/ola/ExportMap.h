@@ -32,6 +32,7 @@
 
 #include <ola/base/Macro.h>
 #include <ola/StringUtils.h>
+#include <ola/thread/Mutex.h>
 #include <stdlib.h>
 
 #include <functional>
@@ -320,6 +321,8 @@ inline const std::string MapVariable<std::string>::Value() const {
 /**
  * @brief A container for the exported variables.
  *
+ * Looking up and creating variables is thread safe, so it can be done while
+ * plugins are being started on worker threads. Updating a variable isn't.
  */
 class ExportMap {
  public:
@@ -397,6 +400,9 @@ class ExportMap {
   std::map<std::string, IntMap*> m_int_map_variables;
   std::map<std::string, UIntMap*> m_uint_map_variables;
 
+  // Protects the maps above.
+  mutable ola::thread::Mutex m_mutex;
+
   DISALLOW_COPY_AND_ASSIGN(ExportMap);
 };
 }  // namespace ola
@@ -114,6 +114,16 @@ typedef SingleUseCallback2<void, const Result&, const OlaUniverse&>
 typedef SingleUseCallback2<void, const Result&, const std::string&>
     ConfigureDeviceCallback;
 
+/**
+ * @brief Invoked when OlaClient::ConfigureUniverses() completes.
+ * @param result the Result of the API call. This is a failure if no changes
+ * were made.
+ * @param errors the changes that couldn't be applied.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::vector<UniverseConfigError>&>
+    UniverseConfigCallback;
+
 /**
  * @brief Invoked when OlaClient::RunDiscovery() completes.
  * @param result the Result of the API call.
@@ -123,6 +133,14 @@ typedef SingleUseCallback2<void, const Result&, const std::string&>
 typedef SingleUseCallback2<void, const Result&, const ola::rdm::UIDSet&>
     DiscoveryCallback;
 
+/**
+ * @brief Invoked when OlaClient::FindUID() completes.
+ * @param result the Result of the API call. This is a failure if the UID
+ * hasn't been discovered on any universe.
+ * @param universe the universe the UID was most recently discovered on.
+ */
+typedef SingleUseCallback2<void, const Result&, unsigned int> FindUIDCallback;
+
 
 /**
  * @brief Called once when OlaClient::FetchDMX() completes.
@@ -153,6 +171,14 @@ typedef SingleUseCallback3<void, const Result&,
                            const RDMMetadata&,
                            const ola::rdm::RDMResponse*> RDMCallback;
 
+/**
+ * @brief Called when frames start being held back because olad hasn't
+ * acknowledged the earlier frames, and again when olad catches up.
+ * Used with OlaClient::CommitFrame().
+ * @param held_back true if frames are being held back, false otherwise.
+ */
+typedef Callback1<void, bool> BackPressureCallback;
+
 
 }  // namespace client
 }  // namespace ola
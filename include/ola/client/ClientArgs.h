@@ -22,8 +22,12 @@
 #define INCLUDE_OLA_CLIENT_CLIENTARGS_H_
 
 #include <ola/client/CallbackTypes.h>
+#include <ola/client/ClientTypes.h>
 #include <ola/dmx/SourcePriorities.h>
 
+#include <string>
+#include <vector>
+
 /**
  * @file
  * @brief Types used as arguments for the OLA Client.
@@ -116,6 +120,99 @@ struct SendRDMArgs {
       include_raw_frames(false) {
   }
 };
+
+/**
+ * @brief A set of patch, priority, name and merge mode changes, used with
+ * OlaClient::ConfigureUniverses().
+ *
+ * Patches are applied first, so the other changes may refer to universes
+ * that are created by patching a port.
+ */
+struct UniverseConfig {
+  /**
+   * @brief Patch or unpatch a port.
+   */
+  struct PortPatch {
+    unsigned int device_alias;
+    unsigned int port;
+    PortDirection port_direction;
+    PatchAction action;
+    unsigned int universe;
+
+    PortPatch(unsigned int _device_alias, unsigned int _port,
+              PortDirection _port_direction, PatchAction _action,
+              unsigned int _universe)
+        : device_alias(_device_alias),
+          port(_port),
+          port_direction(_port_direction),
+          action(_action),
+          universe(_universe) {
+    }
+  };
+
+  /**
+   * @brief Set the priority of a port.
+   */
+  struct PortPriority {
+    unsigned int device_alias;
+    unsigned int port;
+    PortDirection port_direction;
+    port_priority_mode mode;
+    /**
+     * @brief The priority, only used with PRIORITY_MODE_STATIC.
+     */
+    uint8_t priority;
+
+    PortPriority(unsigned int _device_alias, unsigned int _port,
+                 PortDirection _port_direction, port_priority_mode _mode,
+                 uint8_t _priority)
+        : device_alias(_device_alias),
+          port(_port),
+          port_direction(_port_direction),
+          mode(_mode),
+          priority(_priority) {
+    }
+  };
+
+  /**
+   * @brief Set the name of a universe.
+   */
+  struct UniverseName {
+    unsigned int universe;
+    std::string name;
+
+    UniverseName(unsigned int _universe, const std::string &_name)
+        : universe(_universe),
+          name(_name) {
+    }
+  };
+
+  /**
+   * @brief Set the merge mode of a universe.
+   */
+  struct UniverseMergeMode {
+    unsigned int universe;
+    OlaUniverse::merge_mode mode;
+
+    UniverseMergeMode(unsigned int _universe, OlaUniverse::merge_mode _mode)
+        : universe(_universe),
+          mode(_mode) {
+    }
+  };
+
+  std::vector<PortPatch> patches;
+  std::vector<PortPriority> priorities;
+  std::vector<UniverseName> names;
+  std::vector<UniverseMergeMode> merge_modes;
+
+  /**
+   * @brief If true, no changes are made unless they all succeed. Defaults to
+   * true.
+   */
+  bool all_or_nothing;
+
+  UniverseConfig() : all_or_nothing(true) {}
+};
 }  // namespace client
 }  // namespace ola
 #endif  // INCLUDE_OLA_CLIENT_CLIENTARGS_H_
@@ -350,6 +350,41 @@ struct RDMMetadata {
       : response_code(_response_code) {
   }
 };
+
+/**
+ * @brief A change from a UniverseConfig that couldn't be applied.
+ */
+struct UniverseConfigError {
+  /**
+   * @brief The types of change in a UniverseConfig.
+   */
+  enum ConfigItem {
+    CONFIG_PATCH,  /**< An entry in UniverseConfig::patches */
+    CONFIG_NAME,  /**< An entry in UniverseConfig::names */
+    CONFIG_MERGE_MODE,  /**< An entry in UniverseConfig::merge_modes */
+    CONFIG_PRIORITY,  /**< An entry in UniverseConfig::priorities */
+  };
+
+  /**
+   * @brief The type of the change that failed.
+   */
+  ConfigItem item;
+  /**
+   * @brief The index of the change in the list for that type.
+   */
+  unsigned int index;
+  /**
+   * @brief Why the change failed.
+   */
+  std::string error;
+
+  UniverseConfigError(ConfigItem _item, unsigned int _index,
+                      const std::string &_error)
+      : item(_item),
+        index(_index),
+        error(_error) {
+  }
+};
 }  // namespace client
 }  // namespace ola
 #endif  // INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
@@ -26,6 +26,7 @@
 #include <ola/client/ClientArgs.h>
 #include <ola/client/ClientTypes.h>
 #include <ola/base/Macro.h>
+#include <ola/dmx/SourcePriorities.h>
 #include <ola/io/Descriptor.h>
 #include <ola/plugin_id.h>
 #include <ola/rdm/UID.h>
@@ -225,6 +226,17 @@ class OlaClient {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Apply a number of patch, priority, name and merge mode changes in
+   * a single request.
+   *
+   * olad saves the new configuration once, rather than after each change.
+   * @param config the UniverseConfig with the changes to make.
+   * @param callback the UniverseConfigCallback to invoke upon completion.
+   */
+  void ConfigureUniverses(const UniverseConfig &config,
+                          UniverseConfigCallback *callback);
+
   /**
    * @brief Register our interest in a universe.
    *
@@ -248,6 +260,58 @@ class OlaClient {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Start a new DMX frame.
+   *
+   * A frame groups the updates for a number of universes so they can be sent
+   * to olad in a single request. Any data set since the last CommitFrame()
+   * is discarded.
+   */
+  void BeginFrame();
+
+  /**
+   * @brief Set the data for a universe in the current frame.
+   *
+   * If a universe is set more than once in a frame, only the last data is
+   * sent.
+   * @param universe the universe to send to.
+   * @param data the DmxBuffer with the data.
+   * @param priority the priority of the data.
+   */
+  void SetFrameDMX(unsigned int universe,
+                   const DmxBuffer &data,
+                   uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT);
+
+  /**
+   * @brief Send the current frame to olad.
+   *
+   * If MaxFramesInFlight() frames are waiting to be acknowledged, the frame
+   * is held back and sent once olad catches up. Held back frames are merged,
+   * so only the latest data for each universe is sent, and the callbacks for
+   * the merged frames all receive the result of the combined request.
+   * @param callback the callback to run once olad has applied the frame, may
+   *   be NULL.
+   * @returns true if the frame was sent, false if it was held back.
+   */
+  bool CommitFrame(GeneralSetCallback *callback);
+
+  /**
+   * @brief Set the number of frames that can be waiting for an
+   * acknowledgement from olad before frames are held back.
+   */
+  void SetMaxFramesInFlight(unsigned int max_frames);
+
+  /**
+   * @brief Set the callback to run when frames start or stop being held back.
+   * @param callback the BackPressureCallback, ownership is transferred.
+   */
+  void SetBackPressureCallback(BackPressureCallback *callback);
+
+  /**
+   * @brief Check if a frame is being held back.
+   */
+  bool FrameHeldBack() const;
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -265,6 +329,16 @@ class OlaClient {
                     DiscoveryType discovery_type,
                     DiscoveryCallback *callback);
 
+  /**
+   * @brief Find the universe a UID was discovered on.
+   * @param uid the UID to look for.
+   * @param callback the FindUIDCallback to invoke upon completion.
+   *
+   * If the UID is present on more than one universe, the universe it was
+   * most recently discovered on is returned.
+   */
+  void FindUID(const ola::rdm::UID &uid, FindUIDCallback *callback);
+
   /**
    * @brief Set the source UID for this client.
    * @param uid the UID to use when sending RDM messages from this client.
@@ -25,6 +25,7 @@
 #include <ola/Callback.h>
 #include <ola/base/Macro.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/OutputBuffer.h>
 #include <ola/io/SelectServer.h>
 #include <ola/thread/Thread.h>
 #include <ola/web/Json.h>
@@ -45,6 +46,8 @@
 #include <string>
 #include <vector>
 
+class HTTPServerTest;
+
 namespace ola {
 namespace http {
 
@@ -92,21 +95,112 @@ class HTTPRequest {
 };
 
 
+/**
+ * @brief A long lived text/event-stream response.
+ *
+ * This implements the server side of Server-Sent Events. Events are buffered
+ * until MHD is ready to write them to the client. Once passed to
+ * HTTPResponse::SendEventStream(), the HTTPEventStream is owned by the server
+ * and is deleted when the client disconnects; the close handler is run at
+ * that point.
+ *
+ * All methods must be called from the HTTP server thread.
+ */
+class HTTPEventStream {
+ public:
+  typedef ola::SingleUseCallback0<void> CloseCallback;
+
+  /**
+   * @brief Create a new HTTPEventStream.
+   * @param max_buffer_size the maximum number of bytes to buffer for a slow
+   *   client. Events that would exceed this are dropped.
+   */
+  explicit HTTPEventStream(
+      unsigned int max_buffer_size = K_DEFAULT_MAX_BUFFER_SIZE);
+
+  /**
+   * @brief Destructor, this runs the close handler.
+   */
+  ~HTTPEventStream();
+
+  /**
+   * @brief Set the callback to run when the stream is closed.
+   * @param callback the callback to run, ownership is transferred. May be
+   *   NULL to remove the current handler.
+   */
+  void SetCloseHandler(CloseCallback *callback);
+
+  /**
+   * @brief Queue an event.
+   * @param event the event type, may be empty.
+   * @param data the event data.
+   * @returns false if the event was dropped because the client isn't keeping
+   *   up.
+   */
+  bool SendEvent(const std::string &event, const std::string &data);
+
+  /**
+   * @brief Queue a comment, this can be used to keep the connection alive.
+   */
+  bool SendComment(const std::string &comment);
+
+  /**
+   * @brief Return the number of bytes waiting to be sent.
+   */
+  unsigned int BufferedBytes() const { return m_buffer.size() - m_offset; }
+
+  /**
+   * @brief Copy buffered data to MHD.
+   * @param output the buffer to copy to.
+   * @param max_size the size of the buffer.
+   * @returns the number of bytes copied, which may be 0.
+   */
+  size_t Read(char *output, size_t max_size);
+
+  static const unsigned int K_DEFAULT_MAX_BUFFER_SIZE = 64 * 1024;
+
+ private:
+  std::string m_buffer;
+  size_t m_offset;
+  const unsigned int m_max_buffer_size;
+  CloseCallback *m_close_callback;
+
+  bool Append(const std::string &data);
+
+  friend class ::HTTPServerTest;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPEventStream);
+};
+
+
 /*
  * Represents the HTTP Response
+ *
+ * The body can be built with Append(), or by passing the response to anything
+ * that writes to an OutputBufferInterface, such as a JsonStreamWriter. Either
+ * way the whole body is buffered in memory and handed to libmicrohttpd by
+ * Send(), nothing is sent to the client until then.
  */
-class HTTPResponse {
+class HTTPResponse : public ola::io::OutputBufferInterface {
  public:
   explicit HTTPResponse(struct MHD_Connection *connection):
     m_connection(connection),
     m_status_code(MHD_HTTP_OK) {}
 
   void Append(const std::string &data) { m_data.append(data); }
+
+  bool Empty() const { return m_data.empty(); }
+  unsigned int Size() const { return m_data.size(); }
+  void Write(const uint8_t *data, unsigned int length) {
+    m_data.append(reinterpret_cast<const char*>(data), length);
+  }
+
   void SetContentType(const std::string &type);
   void SetHeader(const std::string &key, const std::string &value);
   void SetStatus(unsigned int status) { m_status_code = status; }
   void SetNoCache();
   int SendJson(const ola::web::JsonValue &json);
+  int SendEventStream(HTTPEventStream *stream);
   int Send();
   struct MHD_Connection *Connection() const { return m_connection; }
  private:
@@ -116,6 +210,8 @@ class HTTPResponse {
   HeadersMultiMap m_headers;
   unsigned int m_status_code;
 
+  static const size_t K_EVENT_STREAM_BLOCK_SIZE = 1024;
+
   DISALLOW_COPY_AND_ASSIGN(HTTPResponse);
 };
 
@@ -152,10 +248,14 @@ class HTTPServer: public ola::thread::Thread {
     uint16_t port;
     // The root for content served with ServeStaticContent();
     std::string data_dir;
+    // Load the registered files into memory when the server starts, rather
+    // than reading them from disk for each request.
+    bool preload_static_content;
 
     HTTPServerOptions()
       : port(0),
-        data_dir("") {
+        data_dir(""),
+        preload_static_content(false) {
     }
   };
 
@@ -209,6 +309,7 @@ class HTTPServer: public ola::thread::Thread {
   static const char CONTENT_TYPE_OCT[];
   static const char CONTENT_TYPE_XML[];
   static const char CONTENT_TYPE_JSON[];
+  static const char CONTENT_TYPE_EVENT_STREAM[];
 
   // Expose the SelectServer
   ola::io::SelectServer *SelectServer() { return m_select_server.get(); }
@@ -216,10 +317,28 @@ class HTTPServer: public ola::thread::Thread {
   static struct MHD_Response *BuildResponse(void *data, size_t size);
 
  private :
-  typedef struct {
+  struct static_file_info {
+   public:
+    static_file_info()
+        : identity_response(NULL),
+          gzip_response(NULL),
+          brotli_response(NULL) {
+    }
+
     std::string file_path;
     std::string content_type;
-  } static_file_info;
+
+    // The following are only set if the file has been preloaded.
+    std::string etag;
+    std::string gzip_etag;
+    std::string brotli_etag;
+    std::string data;
+    std::string gzip_data;
+    std::string brotli_data;
+    struct MHD_Response *identity_response;
+    struct MHD_Response *gzip_response;
+    struct MHD_Response *brotli_response;
+  };
 
   struct DescriptorState {
    public:
@@ -251,13 +370,41 @@ class HTTPServer: public ola::thread::Thread {
   BaseHTTPCallback *m_default_handler;
   unsigned int m_port;
   std::string m_data_dir;
+  bool m_preload_static_content;
 
   int ServeStaticContent(static_file_info *file_info,
                          HTTPResponse *response);
+  int ServePreloadedContent(const HTTPRequest *request,
+                            const static_file_info &file_info,
+                            HTTPResponse *response);
+  bool PreloadFile(static_file_info *file_info);
+  void FreePreloadedFile(static_file_info *file_info);
+  bool ReadFile(const std::string &file, std::string *data) const;
+
+  static struct MHD_Response *BuildPersistentResponse(
+      const static_file_info &file_info,
+      const std::string &data,
+      const std::string &etag,
+      const std::string &encoding);
+  static struct MHD_Response *SelectPreloadedResponse(
+      const static_file_info &file_info,
+      const std::string &accept_encoding,
+      std::string *etag);
+  static bool AcceptsEncoding(const std::string &accept_encoding,
+                              const std::string &encoding);
+  static bool MatchesETag(const std::string &if_none_match,
+                          const std::string &etag);
+  static bool GzipCompress(const std::string &data, std::string *output);
+  static std::string ContentETag(const std::string &data);
+
+  static const char ENCODING_BROTLI[];
+  static const char ENCODING_GZIP[];
 
   void InsertSocket(bool is_readable, bool is_writeable, int fd);
   void FreeSocket(DescriptorState *state);
 
+  friend class ::HTTPServerTest;
+
   DISALLOW_COPY_AND_ASSIGN(HTTPServer);
 };
 }  // namespace http
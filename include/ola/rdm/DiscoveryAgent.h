@@ -117,7 +117,8 @@ class DiscoveryTargetInterface {
  * the DiscoveryAgent.
  *
  * The discovery process goes something like this:
- *   - if incremental, copy all previously discovered UIDs to the mute list
+ *   - if incremental, copy all previously discovered UIDs (or those passed to
+ *     SetKnownUIDs()) to the mute list
  *   - push (0, 0xffffffffffff) onto the resolution stack
  *   - unmute all
  *   - mute all previously discovered UIDs, for any that fail to mute remove
@@ -167,6 +168,16 @@ class DiscoveryAgent {
    */
   void StartIncrementalDiscovery(DiscoveryCompleteCallback *on_complete);
 
+  /**
+   * @brief Seed the agent with UIDs found previously, e.g. before a restart.
+   * @param uids the UIDs that are expected to be present.
+   *
+   * The next incremental discovery will verify these UIDs by muting each of
+   * them directly, and then only needs to search for responders that weren't
+   * in the set. This has no effect if discovery is already running.
+   */
+  void SetKnownUIDs(const UIDSet &uids);
+
  private:
   /**
    * @brief Represents a range of UIDs (a branch of the UID tree)
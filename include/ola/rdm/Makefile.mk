@@ -17,11 +17,13 @@ olardminclude_HEADERS = \
     include/ola/rdm/NetworkManagerInterface.h \
     include/ola/rdm/NetworkResponder.h \
     include/ola/rdm/OpenLightingEnums.h \
+    include/ola/rdm/PidCodec.h \
     include/ola/rdm/PidStore.h \
     include/ola/rdm/PidStoreHelper.h \
     include/ola/rdm/QueueingRDMController.h \
     include/ola/rdm/RDMAPI.h \
     include/ola/rdm/RDMAPIImplInterface.h \
+    include/ola/rdm/RDMCollector.h \
     include/ola/rdm/RDMCommand.h \
     include/ola/rdm/RDMCommandSerializer.h \
     include/ola/rdm/RDMControllerAdaptor.h \
@@ -0,0 +1,260 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PidCodec.h
+ * Decode RDM parameter data using a precompiled field layout.
+ * Copyright (C) 2026 agent
+ */
+
+/**
+ * @addtogroup rdm_command
+ * @{
+ * @file PidCodec.h
+ * @brief Decode RDM parameter data using a precompiled field layout.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_PIDCODEC_H_
+#define INCLUDE_OLA_RDM_PIDCODEC_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/messaging/Descriptor.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/MACAddress.h>
+#include <ola/rdm/PidStore.h>
+#include <ola/rdm/UID.h>
+#include <map>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief Receives the fields decoded by a PidCodec.
+ *
+ * Fields are delivered in the order they appear in the descriptor. The values
+ * are passed directly, no Message objects are created, so an implementation
+ * can copy them straight into its own structures. Strings point into the
+ * parameter data and are only valid for the duration of the call.
+ *
+ * All methods have empty default implementations so a visitor only needs to
+ * override the fields it cares about.
+ */
+class PidCodecVisitor {
+ public:
+  virtual ~PidCodecVisitor() {}
+
+  virtual void Visit(const ola::messaging::BoolFieldDescriptor*, bool) {}
+  virtual void Visit(const ola::messaging::IPV4FieldDescriptor*,
+                     const ola::network::IPV4Address&) {}
+  virtual void Visit(const ola::messaging::MACFieldDescriptor*,
+                     const ola::network::MACAddress&) {}
+  virtual void Visit(const ola::messaging::UIDFieldDescriptor*,
+                     const UID&) {}
+
+  /**
+   * @brief Called for string fields with the string data and the length of
+   * the string up to the first NULL. The data isn't NULL terminated.
+   */
+  virtual void Visit(const ola::messaging::StringFieldDescriptor*,
+                     const char*, unsigned int) {}
+
+  virtual void Visit(const ola::messaging::UInt8FieldDescriptor*,
+                     uint8_t) {}
+  virtual void Visit(const ola::messaging::UInt16FieldDescriptor*,
+                     uint16_t) {}
+  virtual void Visit(const ola::messaging::UInt32FieldDescriptor*,
+                     uint32_t) {}
+  virtual void Visit(const ola::messaging::Int8FieldDescriptor*,
+                     int8_t) {}
+  virtual void Visit(const ola::messaging::Int16FieldDescriptor*,
+                     int16_t) {}
+  virtual void Visit(const ola::messaging::Int32FieldDescriptor*,
+                     int32_t) {}
+
+  /**
+   * @brief Called at the start of each block of a group, with the index of
+   * the block.
+   */
+  virtual void Visit(const ola::messaging::FieldDescriptorGroup*,
+                     unsigned int) {}
+
+  /**
+   * @brief Called at the end of each block of a group.
+   */
+  virtual void PostVisit(const ola::messaging::FieldDescriptorGroup*) {}
+};
+
+
+/**
+ * @brief Decodes parameter data for a single Descriptor.
+ *
+ * MessageDeserializer walks the Descriptor tree and builds a Message for every
+ * request. A PidCodec instead flattens the Descriptor into a list of
+ * operations once, and works out the fixed and variable parts of the layout
+ * up front. Decoding is then a single pass over the data with no memory
+ * allocation.
+ *
+ * The same data is accepted as MessageDeserializer: at most one variable
+ * sized field at the top level, which is either a string or a group with a
+ * fixed block size.
+ */
+class PidCodec {
+ public:
+  ~PidCodec() {}
+
+  /**
+   * @brief Compile a Descriptor into a PidCodec.
+   * @param descriptor the Descriptor to compile.
+   * @returns a new PidCodec, or NULL if the descriptor has more than one
+   *   variable sized field, or a variable sized field in a variable sized
+   *   group. Ownership is transferred to the caller.
+   */
+  static PidCodec *Compile(const ola::messaging::Descriptor *descriptor);
+
+  /**
+   * @brief The Descriptor this codec was compiled from.
+   */
+  const ola::messaging::Descriptor *GetDescriptor() const {
+    return m_descriptor;
+  }
+
+  /**
+   * @brief Decode parameter data.
+   * @param data the parameter data.
+   * @param length the length of the parameter data.
+   * @param visitor the PidCodecVisitor to pass the fields to.
+   * @returns true if the data matched the descriptor, false otherwise. If
+   *   false is returned the visitor won't have been called.
+   */
+  bool Decode(const uint8_t *data,
+              unsigned int length,
+              PidCodecVisitor *visitor) const;
+
+  /**
+   * @brief Check if parameter data matches the descriptor.
+   * @param length the length of the parameter data.
+   * @returns true if Decode() would accept data of this length.
+   */
+  bool ValidLength(unsigned int length) const {
+    unsigned int variable_size;
+    return VariableFieldSize(length, &variable_size);
+  }
+
+ private:
+  typedef enum {
+    BOOL_OP,
+    IPV4_OP,
+    MAC_OP,
+    UID_OP,
+    STRING_OP,
+    UINT8_OP,
+    UINT16_OP,
+    UINT32_OP,
+    INT8_OP,
+    INT16_OP,
+    INT32_OP,
+    GROUP_OP,
+  } op_type;
+
+  struct Operation {
+    op_type type;
+    const ola::messaging::FieldDescriptor *descriptor;
+    // The size in bytes of a fixed field, or the number of blocks for a
+    // fixed group.
+    unsigned int size;
+    // For groups, the index of the operation after the group.
+    unsigned int end;
+    bool variable;
+    bool little_endian;
+  };
+  typedef std::vector<Operation> Operations;
+
+  const ola::messaging::Descriptor *m_descriptor;
+  Operations m_operations;
+  unsigned int m_fixed_size;
+  // The variable field, either a string or a group, may be NULL.
+  const ola::messaging::StringFieldDescriptor *m_variable_string;
+  const ola::messaging::FieldDescriptorGroup *m_variable_group;
+
+  explicit PidCodec(const ola::messaging::Descriptor *descriptor);
+
+  bool AddFields(const ola::messaging::FieldDescriptorGroup *group,
+                 bool top_level);
+  bool VariableFieldSize(unsigned int length,
+                         unsigned int *variable_size) const;
+  void DecodeOperations(unsigned int begin,
+                        unsigned int end,
+                        const uint8_t *data,
+                        unsigned int *offset,
+                        unsigned int variable_size,
+                        PidCodecVisitor *visitor) const;
+
+  class CompileVisitor;
+
+  DISALLOW_COPY_AND_ASSIGN(PidCodec);
+};
+
+
+/**
+ * @brief Holds the PidCodecs for all the descriptors in a set of PidStores.
+ *
+ * The codecs are compiled when a PidStore is added, which is usually just
+ * after the RootPidStore is loaded. The PidStores must outlive the
+ * PidCodecStore.
+ */
+class PidCodecStore {
+ public:
+  PidCodecStore() {}
+  ~PidCodecStore();
+
+  /**
+   * @brief Compile the codecs for the ESTA and all manufacturer stores.
+   * @param root_store the RootPidStore to compile.
+   */
+  void AddRootPidStore(const RootPidStore *root_store);
+
+  /**
+   * @brief Compile the codecs for all the PIDs in a store.
+   * @param store the PidStore to compile.
+   */
+  void AddPidStore(const PidStore *store);
+
+  /**
+   * @brief Lookup the codec for a descriptor.
+   * @param descriptor the Descriptor to find the codec for.
+   * @returns the PidCodec, or NULL if the descriptor wasn't compiled.
+   */
+  const PidCodec *Lookup(const ola::messaging::Descriptor *descriptor) const;
+
+  /**
+   * @brief The number of codecs in the store.
+   */
+  unsigned int CodecCount() const { return m_codecs.size(); }
+
+ private:
+  typedef std::map<const ola::messaging::Descriptor*, const PidCodec*>
+      CodecMap;
+
+  CodecMap m_codecs;
+
+  void AddDescriptor(const ola::messaging::Descriptor *descriptor);
+
+  DISALLOW_COPY_AND_ASSIGN(PidCodecStore);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_PIDCODEC_H_
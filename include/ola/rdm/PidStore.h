@@ -109,6 +109,15 @@ class RootPidStore {
    */
   const PidStore *ManufacturerStore(uint16_t esta_id) const;
 
+  /**
+   * @brief Return the PidStores for all manufacturers.
+   * @returns a map of manufacturer id to PidStore. The pointers are valid for
+   * the lifetime of the RootPidStore.
+   */
+  const ManufacturerMap &ManufacturerStores() const {
+    return m_manufacturer_store;
+  }
+
   /**
    * @brief Lookup an ESTA-defined parameter by name.
    * @param pid_name the name of the parameter.
@@ -158,6 +167,10 @@ class RootPidStore {
    * empty, the installed location will be used.
    * @param validate whether to perform validation on the data. Validation can
    * be turned off for faster load times.
+   *
+   * A compiled copy of the data is kept in pids.cache within the directory,
+   * if the directory is writable. The cache is rebuilt whenever the files in
+   * the directory change.
    */
   static const RootPidStore *LoadFromDirectory(const std::string &directory,
                                                bool validate = true);
@@ -0,0 +1,293 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RDMCollector.h
+ * Collects the parameters from a set of RDM devices.
+ * Copyright (C) 2026 agent
+ */
+
+/**
+ * @addtogroup rdm_api
+ * @{
+ * @file RDMCollector.h
+ * @brief Fetch every parameter from a set of RDM devices.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_RDMCOLLECTOR_H_
+#define INCLUDE_OLA_RDM_RDMCOLLECTOR_H_
+
+#include <stdint.h>
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <ola/rdm/RDMAPIImplInterface.h>
+#include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief Collects the value of every supported parameter from RDM devices.
+ *
+ * Devices are added to the collector along with the universe they were
+ * discovered on. Each universe is treated as a separate RDM line, which has
+ * at most one request outstanding at any time, but requests for different
+ * universes are sent concurrently.
+ *
+ * Requests on a line are prioritised by the class of the PID, so that the
+ * DEVICE_INFO and SUPPORTED_PARAMETERS for every device on a line are fetched
+ * before the descriptions, and the descriptions before the configuration and
+ * status parameters. Once SUPPORTED_PARAMETERS is known, GETs are queued for
+ * each supported PID, along with one request per index for the PIDs that
+ * take an index such as DMX_PERSONALITY_DESCRIPTION and SENSOR_VALUE.
+ *
+ * Responses with an ACK_TIMER are collected with QUEUED_MESSAGE once the
+ * timer expires; other requests on the line continue in the meantime.
+ * Timeouts, invalid responses and transient NACKs such as
+ * NR_PROXY_BUFFER_FULL are retried. Each request produces exactly one Result.
+ *
+ * @examplepara
+ * @code
+ *   ola::client::ClientRDMAPIShim shim(client);
+ *   RDMCollector collector(
+ *       &shim, ss, ola::NewCallback(&NewResult), ola::NewCallback(&Idle));
+ *   collector.AddDevices(1, uids);
+ * @endcode
+ */
+class RDMCollector {
+ public:
+  /**
+   * @brief The classes of PIDs, in the order they are fetched.
+   */
+  enum PidClass {
+    PID_CLASS_IDENTITY,  /**< DEVICE_INFO & SUPPORTED_PARAMETERS */
+    PID_CLASS_DESCRIPTION,  /**< Labels & descriptions */
+    PID_CLASS_CONFIGURATION,  /**< Settings, e.g. DMX_START_ADDRESS */
+    PID_CLASS_STATUS,  /**< Changing values, e.g. SENSOR_VALUE, LAMP_HOURS */
+  };
+
+  /**
+   * @brief The outcome of a request.
+   */
+  enum ResultType {
+    RESULT_ACK,  /**< The device ACKed the request */
+    RESULT_NACK,  /**< The device NACKed the request */
+    RESULT_FAILED,  /**< No valid response was received */
+  };
+
+  /**
+   * @brief The result of a single GET request.
+   */
+  struct Result {
+   public:
+    explicit Result(const UID &uid)
+        : universe(0),
+          uid(uid),
+          sub_device(ROOT_RDM_DEVICE),
+          pid(0),
+          pid_class(PID_CLASS_CONFIGURATION),
+          type(RESULT_FAILED),
+          nack_reason(0),
+          attempts(0) {
+    }
+
+    unsigned int universe;
+    UID uid;
+    uint16_t sub_device;
+    uint16_t pid;
+    PidClass pid_class;
+    // The param data sent with the request, e.g. the personality index.
+    std::string request_data;
+    ResultType type;
+    // Only valid if type is RESULT_NACK.
+    uint16_t nack_reason;
+    // The param data of the response, if type is RESULT_ACK.
+    std::string data;
+    // A description of the failure, if type is RESULT_FAILED.
+    std::string error;
+    // The number of times the request was sent, not including QUEUED_MESSAGE
+    // requests.
+    unsigned int attempts;
+  };
+
+  struct Options {
+   public:
+    Options()
+        : max_attempts(3),
+          retry_delay(100),
+          max_queued_message_fetches(10) {
+    }
+
+    // The number of times a request is sent before giving up.
+    unsigned int max_attempts;
+    // The delay before a failed request is retried, in ms.
+    unsigned int retry_delay;
+    // The number of QUEUED_MESSAGE requests sent for an ACK_TIMER response
+    // before giving up.
+    unsigned int max_queued_message_fetches;
+  };
+
+  /**
+   * @brief Counters for the requests the collector has sent.
+   */
+  struct Stats {
+   public:
+    Stats()
+        : request_count(0),
+          ack_count(0),
+          nack_count(0),
+          failure_count(0),
+          retry_count(0),
+          ack_timer_count(0),
+          queued_message_count(0) {
+    }
+
+    unsigned int request_count;
+    unsigned int ack_count;
+    unsigned int nack_count;
+    unsigned int failure_count;
+    unsigned int retry_count;
+    unsigned int ack_timer_count;
+    unsigned int queued_message_count;
+  };
+
+  typedef ola::Callback1<void, const Result&> ResultCallback;
+  typedef ola::Callback0<void> IdleCallback;
+
+  /**
+   * @brief Create a new RDMCollector.
+   * @param api the RDMAPIImplInterface used to send requests, ownership is not
+   *   transferred.
+   * @param scheduler the scheduler used to delay retries, ownership is not
+   *   transferred.
+   * @param result_callback run for each Result. Ownership is transferred.
+   * @param idle_callback run when the last outstanding request completes, may
+   *   be NULL. Ownership is transferred.
+   * @param options the Options to use.
+   *
+   * The collector must not be deleted from within the callbacks, or while
+   * requests are outstanding.
+   */
+  RDMCollector(RDMAPIImplInterface *api,
+               ola::thread::SchedulerInterface *scheduler,
+               ResultCallback *result_callback,
+               IdleCallback *idle_callback,
+               const Options &options = Options());
+  ~RDMCollector();
+
+  /**
+   * @brief Collect the parameters for a device.
+   * @param universe the universe the device is connected to.
+   * @param uid the UID of the device.
+   *
+   * Devices that have already been added are ignored.
+   */
+  void AddDevice(unsigned int universe, const UID &uid);
+
+  /**
+   * @brief Collect the parameters for a set of devices.
+   * @param universe the universe the devices are connected to.
+   * @param uids the UIDs of the devices.
+   */
+  void AddDevices(unsigned int universe, const UIDSet &uids);
+
+  /**
+   * @brief Check if there are requests that haven't completed.
+   */
+  bool Idle() const { return m_pending_requests == 0; }
+
+  /**
+   * @brief The number of requests that haven't completed.
+   */
+  unsigned int PendingRequests() const { return m_pending_requests; }
+
+  const Stats& GetStats() const { return m_stats; }
+
+  /**
+   * @brief Return the PidClass used to prioritise a PID.
+   */
+  static PidClass ClassifyPid(uint16_t pid);
+
+  /**
+   * @brief Return the name of a PidClass.
+   */
+  static std::string PidClassToString(PidClass pid_class);
+
+  /**
+   * @brief Return the name of a ResultType.
+   */
+  static std::string ResultTypeToString(ResultType type);
+
+ private:
+  struct Device;
+  struct Line;
+  struct Request;
+
+  typedef std::map<std::pair<unsigned int, UID>, Device*> DeviceMap;
+  typedef std::map<unsigned int, Line*> LineMap;
+
+  RDMAPIImplInterface *m_api;
+  ola::thread::SchedulerInterface *m_scheduler;
+  ResultCallback *m_result_callback;
+  IdleCallback *m_idle_callback;
+  const Options m_options;
+  DeviceMap m_devices;
+  LineMap m_lines;
+  unsigned int m_pending_requests;
+  Stats m_stats;
+
+  Line *GetLine(unsigned int universe);
+  void QueueGet(Device *device, uint16_t pid,
+                const std::string &data = "");
+  void QueueIndexedGets(Device *device, uint16_t pid, unsigned int first,
+                        unsigned int count, bool wide_index);
+  void Enqueue(Request *request, bool front);
+  void DispatchLine(Line *line);
+  void SendRequest(Line *line, Request *request);
+
+  void HandleResponse(Request *request, const ResponseStatus &status,
+                      uint16_t pid, const std::string &data);
+  void HandleRequestResponse(Request *request, const ResponseStatus &status,
+                             const std::string &data);
+  void HandleQueuedMessage(Request *request, const ResponseStatus &status,
+                           uint16_t pid, const std::string &data);
+  Request *TakeQueuedRequest(Request *request, const ResponseStatus &status,
+                             uint16_t pid, const std::string &data);
+  bool CheckTransportStatus(Request *request, const ResponseStatus &status);
+
+  void FetchQueuedMessage(Request *request, unsigned int delay);
+  void RetryOrFail(Request *request, const std::string &error);
+  void Schedule(Request *request, unsigned int delay);
+  void DelayComplete(Request *request);
+  void Unschedule(Request *request);
+
+  void Complete(Request *request, ResultType type, uint16_t nack_reason,
+                const std::string &data, const std::string &error);
+  void HandleDeviceInfo(Device *device, const std::string &data);
+  void HandleSupportedParameters(Device *device, const std::string &data);
+  void QueueIndexedPids(Device *device);
+  void RunIdleCallbackIfIdle();
+
+  DISALLOW_COPY_AND_ASSIGN(RDMCollector);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_RDMCOLLECTOR_H_
@@ -0,0 +1,174 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * JsonStreamWriter.h
+ * Write JSON text without building a tree of JsonValues.
+ * Copyright (C) 2026 agent
+ */
+
+/**
+ * @addtogroup json
+ * @{
+ * @file JsonStreamWriter.h
+ * @brief Write JSON text without building a tree of JsonValues.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+#define INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/io/OutputBuffer.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace web {
+
+/**
+ * @addtogroup json
+ * @{
+ */
+
+/**
+ * @brief Emit JSON text one token at a time.
+ *
+ * The JsonValue classes need one heap allocation per value, which adds up for
+ * large responses such as UID lists. JsonStreamWriter appends the text
+ * directly to the output instead; the caller is responsible for producing a
+ * well formed document, i.e. matching each Start call with an End call and
+ * calling Key() before each value within an object.
+ *
+ * The output is compact, there is no whitespace between tokens.
+ *
+ * @examplepara
+ * @code
+ *   string output;
+ *   JsonStreamWriter writer(&output);
+ *   writer.StartObject();
+ *   writer.Add("universe", 1);
+ *   writer.StartArray("uids");
+ *   writer.String("7a70:00000001");
+ *   writer.EndArray();
+ *   writer.EndObject();
+ *   // output is {"universe":1,"uids":["7a70:00000001"]}
+ * @endcode
+ */
+class JsonStreamWriter {
+ public:
+  /**
+   * @brief Create a writer that appends to a string.
+   * @param output the string to append to.
+   */
+  explicit JsonStreamWriter(std::string *output);
+
+  /**
+   * @brief Create a writer that appends to an OutputBuffer.
+   * @param output the OutputBufferInterface to write to.
+   * @param flush_size the text is buffered until it reaches this size and
+   *   then written to the output.
+   */
+  explicit JsonStreamWriter(ola::io::OutputBufferInterface *output,
+                            unsigned int flush_size = K_DEFAULT_FLUSH_SIZE);
+
+  /**
+   * @brief Destructor, this writes any buffered data to the output.
+   */
+  ~JsonStreamWriter();
+
+  void StartObject();
+  void EndObject();
+  void StartArray();
+  void EndArray();
+
+  /**
+   * @brief Write the key for the next value in an object.
+   */
+  void Key(const std::string &key);
+
+  void String(const std::string &value);
+  void String(const char *value);
+  void Bool(bool value);
+  void Null();
+  void Int(int32_t value);
+  void UInt(uint32_t value);
+  void Int64(int64_t value);
+  void UInt64(uint64_t value);
+
+  /**
+   * @brief Write text that is already valid JSON.
+   */
+  void Raw(const std::string &value);
+
+  /**
+   * @name Object members
+   * @brief Write a key and value in a single call.
+   * @{
+   */
+  void StartObject(const std::string &key);
+  void StartArray(const std::string &key);
+  void Add(const std::string &key, const std::string &value);
+  void Add(const std::string &key, const char *value);
+  void Add(const std::string &key, bool value);
+  void Add(const std::string &key, int32_t value);
+  void Add(const std::string &key, uint32_t value);
+  void Add(const std::string &key, int64_t value);
+  void Add(const std::string &key, uint64_t value);
+  /**
+   * @}
+   */
+
+  /**
+   * @brief Write any buffered data to the output.
+   *
+   * This does nothing for writers that append to a string.
+   */
+  void Flush();
+
+  /**
+   * @brief The number of objects and arrays that haven't been ended.
+   */
+  unsigned int Depth() const { return m_needs_comma.size(); }
+
+  /**
+   * @brief Append a string to the output with JSON escaping.
+   * @param input the string to escape.
+   * @param output the string to append the quoted, escaped text to.
+   */
+  static void AppendQuotedString(const std::string &input,
+                                 std::string *output);
+
+  static const unsigned int K_DEFAULT_FLUSH_SIZE = 4096;
+
+ private:
+  ola::io::OutputBufferInterface *m_output;
+  const unsigned int m_flush_size;
+  std::string m_local_buffer;
+  std::string *m_buffer;
+  // One entry per open object or array, true once it has a member.
+  std::vector<bool> m_needs_comma;
+  bool m_after_key;
+
+  void BeforeValue();
+  void AfterValue();
+  void AppendUInt64(uint64_t value);
+
+  DISALLOW_COPY_AND_ASSIGN(JsonStreamWriter);
+};
+/**@}*/
+}  // namespace web
+}  // namespace ola
+#endif  // INCLUDE_OLA_WEB_JSONSTREAMWRITER_H_
@@ -102,6 +102,16 @@ class AbstractPlugin {
 
   virtual void ConflictsWith(std::set<ola_plugin_id> *conflict_set) const = 0;
 
+  /**
+   * @brief Check if this plugin can be started on a worker thread.
+   * @return true if Start() can run in parallel with other plugins.
+   *
+   * Plugins started in parallel must only use the PluginAdaptor to interact
+   * with the rest of olad, the SelectServer, device and preference calls made
+   * from the worker thread are run on the main thread.
+   */
+  virtual bool CanStartInParallel() const = 0;
+
   // used to sort plugins
   virtual bool operator<(const AbstractPlugin &other) const = 0;
 };
@@ -145,6 +155,9 @@ class Plugin: public AbstractPlugin {
   // by default we don't conflict with any other plugins
   virtual void ConflictsWith(std::set<ola_plugin_id>*) const {}
 
+  // by default plugins are started on the main thread
+  virtual bool CanStartInParallel() const { return false; }
+
   bool operator<(const AbstractPlugin &other) const {
     return Id() < other.Id();
   }
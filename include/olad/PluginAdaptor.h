@@ -32,9 +32,14 @@
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
 #include <ola/io/SelectServerInterface.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
 #include <olad/OlaServer.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace ola {
 
@@ -127,13 +132,35 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
 
   void DrainCallbacks();
 
+  /**
+   * @brief Run the calls made from a thread on an executor.
+   * @param thread_id the thread the calls are made from.
+   * @param executor the executor to run the calls on, or NULL to stop
+   *   forwarding the calls from this thread.
+   *
+   * The PluginManager starts some plugins on worker threads. The SelectServer,
+   * DeviceManager and PreferencesFactory aren't thread safe, so the calls
+   * from the worker are run on the main thread instead. The worker blocks
+   * until the call completes. Execute() and WakeUpTime() are never forwarded.
+   */
+  void ForwardCalls(ola::thread::ThreadId thread_id,
+                    ola::thread::ExecutorInterface *executor);
+
  private:
+  typedef std::vector<std::pair<ola::thread::ThreadId,
+                                ola::thread::ExecutorInterface*> >
+      ForwardingList;
+
   DeviceManager *m_device_manager;
   ola::io::SelectServerInterface *m_ss;
   ExportMap *m_export_map;
   class PreferencesFactory *m_preferences_factory;
   class PortBrokerInterface *m_port_broker;
   const std::string *m_instance_name;
+  mutable ola::thread::Mutex m_forwarding_mutex;
+  ForwardingList m_forwarding;
+
+  ola::thread::ExecutorInterface *ForwardingExecutor() const;
 
   DISALLOW_COPY_AND_ASSIGN(PluginAdaptor);
 };
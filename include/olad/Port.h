@@ -186,6 +186,13 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete) = 0;
 
+  /**
+   * @brief Provide the UIDs that were found on this port the last time olad
+   *   ran.
+   * @param uids the previously discovered UIDs.
+   */
+  virtual void SetKnownUIDs(const ola::rdm::UIDSet &uids) = 0;
+
   // timecode support
   virtual bool SupportsTimeCode() const = 0;
   virtual bool SendTimeCode(const ola::timecode::TimeCode &timecode) = 0;
@@ -324,6 +331,15 @@ class BasicOutputPort: public OutputPort {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete);
 
+  /**
+   * @brief Report the known UIDs to the universe as soon as the port is
+   *   patched, rather than waiting for discovery to complete.
+   *
+   * Subclasses that use a DiscoveryAgent should override this and also pass
+   * the UIDs to the agent, so they're verified before the binary search runs.
+   */
+  virtual void SetKnownUIDs(const ola::rdm::UIDSet &uids);
+
   // TimeCode
   virtual bool SupportsTimeCode() const { return false; }
 
@@ -358,6 +374,7 @@ class BasicOutputPort: public OutputPort {
   Universe *m_universe;  // the universe this port belongs to
   AbstractDevice *m_device;
   bool m_supports_rdm;
+  ola::rdm::UIDSet m_known_uids;
 
   DISALLOW_COPY_AND_ASSIGN(BasicOutputPort);
 };
@@ -23,7 +23,11 @@
 #define INCLUDE_OLAD_PREFERENCES_H_
 
 #include <ola/base/Macro.h>
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
 #include <ola/Logging.h>
+#include <ola/thread/ExecutorInterface.h>
+#include <ola/thread/Mutex.h>
 #include <ola/thread/Thread.h>
 #include <ola/io/SelectServer.h>
 
@@ -435,13 +439,46 @@ class MemoryPreferencesFactory: public PreferencesFactory {
 
 
 /**
- * The thread that saves preferences
+ * @brief The thread that saves preferences.
+ *
+ * Save requests are coalesced, once a file has been queued for saving, further
+ * requests within the save delay replace the pending copy. When the delay
+ * expires, all the pending files are written in one batch. Each file is
+ * written to a temporary file, synced to disk and then renamed over the
+ * original, so an interrupted write never leaves a truncated config file.
  */
 class FilePreferenceSaverThread: public ola::thread::Thread {
  public:
   typedef std::multimap<std::string, std::string> PreferencesMap;
+
+  /**
+   * @brief Statistics about the files that have been saved.
+   */
+  struct SaveStats {
+    unsigned int save_requests;  // the number of calls to SavePreferences()
+    unsigned int files_written;  // the number of files written to disk
+    unsigned int write_errors;  // the number of files that failed to write
+    unsigned int last_write_time;  // the time the last batch took, in us
+    unsigned int max_write_time;  // the longest time a batch took, in us
+  };
+
   FilePreferenceSaverThread();
 
+  /**
+   * @brief Create a new FilePreferenceSaverThread.
+   * @param save_delay the time to wait for further changes before writing
+   *   a batch of files.
+   * @param export_map if not NULL, the SaveStats are exported here after each
+   *   batch.
+   * @param executor the executor used to update the export_map. This should
+   *   run callbacks on the thread that uses the ExportMap.
+   */
+  FilePreferenceSaverThread(const TimeInterval &save_delay,
+                            ExportMap *export_map,
+                            ola::thread::ExecutorInterface *executor);
+
+  ~FilePreferenceSaverThread();
+
   void SavePreferences(const std::string &filename,
                        const PreferencesMap &preferences);
 
@@ -451,25 +488,59 @@ class FilePreferenceSaverThread: public ola::thread::Thread {
   void *Run();
 
   /**
-   * Stop the saving thread
+   * Stop the saving thread. Any pending files are written first.
    */
   bool Join(void *ptr = NULL);
 
   /**
    * This can be used to syncronize with the file saving thread. Useful if you
    * want to make sure the files have been written to disk before continuing.
-   * This blocks until all pending save requests are complete.
+   * This writes any pending files immediately and blocks until all pending
+   * save requests are complete.
    */
   void Syncronize();
 
+  /**
+   * @brief Return the statistics for this saver thread.
+   */
+  SaveStats Stats() const;
+
+  // The default time to wait for more changes before saving.
+  static const unsigned int DEFAULT_SAVE_DELAY_MS = 1000;
+
+  static const char K_SAVE_REQUESTS_VAR[];
+  static const char K_FILES_WRITTEN_VAR[];
+  static const char K_WRITE_ERRORS_VAR[];
+  static const char K_LAST_WRITE_TIME_VAR[];
+  static const char K_MAX_WRITE_TIME_VAR[];
+
  private:
+  typedef std::map<std::string, const PreferencesMap*> PendingFiles;
+
   ola::io::SelectServer m_ss;
+  const TimeInterval m_save_delay;
+  ExportMap *m_export_map;
+  ola::thread::ExecutorInterface *m_executor;
+  // Only accessed from the saver thread.
+  ola::thread::timeout_id m_save_timeout;
+
+  // These are protected by m_mutex.
+  mutable ola::thread::Mutex m_mutex;
+  PendingFiles m_pending_files;
+  bool m_save_scheduled;
+  SaveStats m_stats;
+
+  void ScheduleSave();
+  void SaveTimeout();
+  void SavePendingFiles();
 
   /**
    * Notify the blocked thread we're done
    */
   void CompleteSyncronization(ola::thread::ConditionVariable *condition,
                               ola::thread::Mutex *mutex);
+
+  DISALLOW_COPY_AND_ASSIGN(FilePreferenceSaverThread);
 };
 
 
@@ -513,8 +584,22 @@ class FileBackedPreferences: public MemoryPreferences {
 
 class FileBackedPreferencesFactory: public PreferencesFactory {
  public:
-  explicit FileBackedPreferencesFactory(const std::string &directory)
-      : m_directory(directory) {
+  /**
+   * @brief Create a new FileBackedPreferencesFactory.
+   * @param directory the directory to store the files in.
+   * @param export_map if not NULL, the file saving statistics are exported
+   *   here.
+   * @param executor the executor used to update the export_map.
+   */
+  explicit FileBackedPreferencesFactory(
+      const std::string &directory,
+      ExportMap *export_map = NULL,
+      ola::thread::ExecutorInterface *executor = NULL)
+      : m_directory(directory),
+        m_saver_thread(
+            TimeInterval(static_cast<int64_t>(
+                FilePreferenceSaverThread::DEFAULT_SAVE_DELAY_MS) * 1000),
+            export_map, executor) {
     m_saver_thread.Start();
   }
 
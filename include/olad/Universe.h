@@ -41,6 +41,7 @@ namespace ola {
 class Client;
 class InputPort;
 class OutputPort;
+class RDMResponseCache;
 
 class Universe: public ola::rdm::RDMControllerInterface {
  public:
@@ -51,7 +52,8 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
-             Clock *clock);
+             Clock *clock,
+             RDMResponseCache *rdm_cache = NULL);
     ~Universe();
 
     // Properties for this universe
@@ -131,6 +133,7 @@ class Universe: public ola::rdm::RDMControllerInterface {
                          bool full = true);
     void NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids);
     void GetUIDs(ola::rdm::UIDSet *uids) const;
+    void GetUIDs(const OutputPort *port, ola::rdm::UIDSet *uids) const;
     unsigned int UIDCount() const;
 
     bool operator==(const Universe &other) {
@@ -148,6 +151,7 @@ class Universe: public ola::rdm::RDMControllerInterface {
     static const char K_UNIVERSE_SINK_CLIENTS_VAR[];
     static const char K_UNIVERSE_SOURCE_CLIENTS_VAR[];
     static const char K_UNIVERSE_UID_COUNT_VAR[];
+    static const char K_UNIVERSE_UID_LIST_TIME_VAR[];
 
  private:
     typedef struct {
@@ -178,11 +182,17 @@ class Universe: public ola::rdm::RDMControllerInterface {
     ExportMap *m_export_map;
     std::map<ola::rdm::UID, OutputPort*> m_output_uids;
     Clock *m_clock;
+    RDMResponseCache *m_rdm_cache;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
+    TimeStamp m_creation_time;
+    bool m_first_uid_list_seen;
 
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
+    void HandleCachedRDMReply(ola::rdm::RDMRequest *request,
+                              ola::rdm::RDMCallback *callback,
+                              ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
     bool UpdateDependants();
@@ -152,6 +152,11 @@ void OlaClient::Patch(unsigned int device_alias,
   m_core->Patch(device_alias, port, port_direction, action, universe, callback);
 }
 
+void OlaClient::ConfigureUniverses(const UniverseConfig &config,
+                                   UniverseConfigCallback *callback) {
+  m_core->ConfigureUniverses(config, callback);
+}
+
 void OlaClient::RegisterUniverse(unsigned int universe,
                                  RegisterAction register_action,
                                  SetCallback *callback) {
@@ -164,6 +169,32 @@ void OlaClient::SendDMX(unsigned int universe,
   m_core->SendDMX(universe, data, args);
 }
 
+void OlaClient::BeginFrame() {
+  m_core->BeginFrame();
+}
+
+void OlaClient::SetFrameDMX(unsigned int universe,
+                            const DmxBuffer &data,
+                            uint8_t priority) {
+  m_core->SetFrameDMX(universe, data, priority);
+}
+
+bool OlaClient::CommitFrame(GeneralSetCallback *callback) {
+  return m_core->CommitFrame(callback);
+}
+
+void OlaClient::SetMaxFramesInFlight(unsigned int max_frames) {
+  m_core->SetMaxFramesInFlight(max_frames);
+}
+
+void OlaClient::SetBackPressureCallback(BackPressureCallback *callback) {
+  m_core->SetBackPressureCallback(callback);
+}
+
+bool OlaClient::FrameHeldBack() const {
+  return m_core->FrameHeldBack();
+}
+
 void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
@@ -174,6 +205,10 @@ void OlaClient::RunDiscovery(unsigned int universe,
   m_core->RunDiscovery(universe, discovery_type, callback);
 }
 
+void OlaClient::FindUID(const ola::rdm::UID &uid, FindUIDCallback *callback) {
+  m_core->FindUID(uid, callback);
+}
+
 void OlaClient::SetSourceUID(const ola::rdm::UID &uid,
                              SetCallback *callback) {
   m_core->SetSourceUID(uid, callback);
@@ -33,6 +33,7 @@
 #include "ola/ClientTypesFactory.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
 #include "ola/OlaClientCore.h"
 #include "ola/client/ClientTypes.h"
 #include "ola/network/NetworkUtils.h"
@@ -55,9 +56,14 @@ using std::vector;
 
 const char OlaClientCore::NOT_CONNECTED_ERROR[] = "Not connected";
 
+const unsigned int OlaClientCore::DEFAULT_MAX_FRAMES_IN_FLIGHT;
+
 OlaClientCore::OlaClientCore(ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
-      m_connected(false) {
+      m_connected(false),
+      m_frame_held_back(false),
+      m_frames_in_flight(0),
+      m_max_frames_in_flight(DEFAULT_MAX_FRAMES_IN_FLIGHT) {
 }
 
 
@@ -65,6 +71,7 @@ OlaClientCore::~OlaClientCore() {
   if (m_connected) {
     Stop();
   }
+  STLDeleteElements(&m_held_callbacks);
 }
 
 
@@ -89,6 +96,7 @@ bool OlaClientCore::Setup() {
     return false;
   }
   m_connected = true;
+  m_frames_in_flight = 0;
   return true;
 }
 
@@ -441,6 +449,69 @@ void OlaClientCore::Patch(unsigned int device_alias,
   }
 }
 
+void OlaClientCore::ConfigureUniverses(const UniverseConfig &config,
+                                       UniverseConfigCallback *callback) {
+  ola::proto::UniverseConfigRequest request;
+  RpcController *controller = new RpcController();
+  ola::proto::UniverseConfigReply *reply =
+      new ola::proto::UniverseConfigReply();
+
+  vector<UniverseConfig::PortPatch>::const_iterator patch_iter =
+      config.patches.begin();
+  for (; patch_iter != config.patches.end(); ++patch_iter) {
+    ola::proto::PatchPortRequest *patch = request.add_patch();
+    patch->set_universe(patch_iter->universe);
+    patch->set_device_alias(patch_iter->device_alias);
+    patch->set_port_id(patch_iter->port);
+    patch->set_is_output(patch_iter->port_direction == OUTPUT_PORT);
+    patch->set_action(patch_iter->action == PATCH ? ola::proto::PATCH :
+                      ola::proto::UNPATCH);
+  }
+
+  vector<UniverseConfig::PortPriority>::const_iterator priority_iter =
+      config.priorities.begin();
+  for (; priority_iter != config.priorities.end(); ++priority_iter) {
+    ola::proto::PortPriorityRequest *priority = request.add_priority();
+    priority->set_device_alias(priority_iter->device_alias);
+    priority->set_port_id(priority_iter->port);
+    priority->set_is_output(priority_iter->port_direction == OUTPUT_PORT);
+    priority->set_priority_mode(priority_iter->mode);
+    if (priority_iter->mode == ola::PRIORITY_MODE_STATIC) {
+      priority->set_priority(priority_iter->priority);
+    }
+  }
+
+  vector<UniverseConfig::UniverseName>::const_iterator name_iter =
+      config.names.begin();
+  for (; name_iter != config.names.end(); ++name_iter) {
+    ola::proto::UniverseNameRequest *name = request.add_name();
+    name->set_universe(name_iter->universe);
+    name->set_name(name_iter->name);
+  }
+
+  vector<UniverseConfig::UniverseMergeMode>::const_iterator merge_iter =
+      config.merge_modes.begin();
+  for (; merge_iter != config.merge_modes.end(); ++merge_iter) {
+    ola::proto::MergeModeRequest *merge_mode = request.add_merge_mode();
+    merge_mode->set_universe(merge_iter->universe);
+    merge_mode->set_merge_mode(merge_iter->mode == OlaUniverse::MERGE_HTP ?
+                               ola::proto::HTP : ola::proto::LTP);
+  }
+
+  request.set_all_or_nothing(config.all_or_nothing);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleUniverseConfig,
+        controller, reply, callback);
+    m_stub->ConfigureUniverses(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleUniverseConfig(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::RegisterUniverse(unsigned int universe,
                                      RegisterAction register_action,
                                      SetCallback *callback) {
@@ -495,6 +566,53 @@ void OlaClientCore::SendDMX(unsigned int universe,
   }
 }
 
+void OlaClientCore::BeginFrame() {
+  m_frame.clear();
+}
+
+void OlaClientCore::SetFrameDMX(unsigned int universe,
+                                const DmxBuffer &data,
+                                uint8_t priority) {
+  FrameData &frame_data = m_frame[universe];
+  frame_data.data = data;
+  frame_data.priority = priority;
+}
+
+bool OlaClientCore::CommitFrame(GeneralSetCallback *callback) {
+  // Merge the frame into any held back frame, later data replaces earlier
+  // data for the same universe.
+  FrameMap::const_iterator iter = m_frame.begin();
+  for (; iter != m_frame.end(); ++iter) {
+    m_held_frame[iter->first] = iter->second;
+  }
+  m_frame.clear();
+  if (callback) {
+    m_held_callbacks.push_back(callback);
+  }
+  if (m_held_frame.empty() && m_held_callbacks.empty()) {
+    return true;
+  }
+
+  if (m_frames_in_flight >= m_max_frames_in_flight) {
+    SetFrameHeldBack(true);
+    return false;
+  }
+  SendHeldFrame();
+  return true;
+}
+
+void OlaClientCore::SetMaxFramesInFlight(unsigned int max_frames) {
+  m_max_frames_in_flight = std::max(max_frames, 1u);
+}
+
+void OlaClientCore::SetBackPressureCallback(BackPressureCallback *callback) {
+  m_back_pressure_callback.reset(callback);
+}
+
+bool OlaClientCore::FrameHeldBack() const {
+  return m_frame_held_back;
+}
+
 void OlaClientCore::FetchDMX(unsigned int universe,
                              DMXCallback *callback) {
   ola::proto::UniverseRequest request;
@@ -545,6 +663,26 @@ void OlaClientCore::RunDiscovery(unsigned int universe,
   }
 }
 
+void OlaClientCore::FindUID(const UID &uid, FindUIDCallback *callback) {
+  ola::proto::UID request;
+  RpcController *controller = new RpcController();
+  ola::proto::UIDUniverseReply *reply = new ola::proto::UIDUniverseReply();
+
+  request.set_esta_id(uid.ManufacturerId());
+  request.set_device_id(uid.DeviceId());
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleFindUID,
+        controller, reply, callback);
+    m_stub->FindUID(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleFindUID(controller, reply, callback);
+  }
+}
+
 void OlaClientCore::SetSourceUID(const UID &uid,
                                  SetCallback *callback) {
   ola::proto::UID request;
@@ -792,6 +930,48 @@ void OlaClientCore::HandleAck(RpcController *controller_ptr,
   callback->Run(result);
 }
 
+void OlaClientCore::HandleUniverseConfig(
+    RpcController *controller_ptr,
+    ola::proto::UniverseConfigReply *reply_ptr,
+    UniverseConfigCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::UniverseConfigReply> reply(reply_ptr);
+
+  if (!callback) {
+    return;
+  }
+
+  string error;
+  vector<UniverseConfigError> errors;
+  if (controller->Failed()) {
+    error = controller->ErrorText();
+  } else {
+    if (!reply->applied()) {
+      error = "No changes were applied";
+    }
+    for (int i = 0; i < reply->error_size(); i++) {
+      const ola::proto::UniverseConfigError &config_error = reply->error(i);
+      UniverseConfigError::ConfigItem item;
+      switch (config_error.item()) {
+        case ola::proto::CONFIG_NAME:
+          item = UniverseConfigError::CONFIG_NAME;
+          break;
+        case ola::proto::CONFIG_MERGE_MODE:
+          item = UniverseConfigError::CONFIG_MERGE_MODE;
+          break;
+        case ola::proto::CONFIG_PRIORITY:
+          item = UniverseConfigError::CONFIG_PRIORITY;
+          break;
+        default:
+          item = UniverseConfigError::CONFIG_PATCH;
+      }
+      errors.push_back(UniverseConfigError(item, config_error.index(),
+                                           config_error.error()));
+    }
+  }
+  callback->Run(Result(error), errors);
+}
+
 void OlaClientCore::HandleGeneralAck(RpcController *controller_ptr,
                                      ola::proto::Ack *reply_ptr,
                                      GeneralSetCallback *callback) {
@@ -806,6 +986,68 @@ void OlaClientCore::HandleGeneralAck(RpcController *controller_ptr,
   callback->Run(result);
 }
 
+void OlaClientCore::SendHeldFrame() {
+  ola::proto::DmxBatch request;
+  FrameMap::const_iterator iter = m_held_frame.begin();
+  for (; iter != m_held_frame.end(); ++iter) {
+    ola::proto::DmxData *data = request.add_data();
+    data->set_universe(iter->first);
+    data->set_data(iter->second.data.Get());
+    data->set_priority(iter->second.priority);
+  }
+  m_held_frame.clear();
+
+  FrameCallbacks *callbacks = new FrameCallbacks();
+  callbacks->swap(m_held_callbacks);
+  SetFrameHeldBack(false);
+
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+  m_frames_in_flight++;
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleFrameAck,
+        controller, reply, callbacks);
+    m_stub->UpdateDmxBatch(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleFrameAck(controller, reply, callbacks);
+  }
+}
+
+void OlaClientCore::HandleFrameAck(RpcController *controller_ptr,
+                                   ola::proto::Ack *reply_ptr,
+                                   FrameCallbacks *callbacks_ptr) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::Ack> reply(reply_ptr);
+  auto_ptr<FrameCallbacks> callbacks(callbacks_ptr);
+
+  if (m_frames_in_flight) {
+    m_frames_in_flight--;
+  }
+  if (m_frame_held_back && m_frames_in_flight < m_max_frames_in_flight) {
+    SendHeldFrame();
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  FrameCallbacks::iterator iter = callbacks->begin();
+  for (; iter != callbacks->end(); ++iter) {
+    (*iter)->Run(result);
+  }
+}
+
+void OlaClientCore::SetFrameHeldBack(bool held_back) {
+  if (held_back == m_frame_held_back) {
+    return;
+  }
+  m_frame_held_back = held_back;
+  if (m_back_pressure_callback.get()) {
+    m_back_pressure_callback->Run(held_back);
+  }
+}
+
 void OlaClientCore::HandleUniverseList(RpcController *controller_ptr,
                                        ola::proto::UniverseInfoReply *reply_ptr,
                                        UniverseListCallback *callback) {
@@ -909,6 +1151,21 @@ void OlaClientCore::HandleUIDList(RpcController *controller_ptr,
   callback->Run(result, uids);
 }
 
+void OlaClientCore::HandleFindUID(RpcController *controller_ptr,
+                                  ola::proto::UIDUniverseReply *reply_ptr,
+                                  FindUIDCallback *callback) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::UIDUniverseReply> reply(reply_ptr);
+
+  if (!callback) {
+    return;
+  }
+
+  Result result(controller->Failed() ? controller->ErrorText() : "");
+  unsigned int universe = controller->Failed() ? 0 : reply->universe();
+  callback->Run(result, universe);
+}
+
 void OlaClientCore::HandleRDM(RpcController *controller_ptr,
                    ola::proto::RDMResponse *reply_ptr,
                    RDMCallback *callback) {
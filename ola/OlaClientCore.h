@@ -21,8 +21,10 @@
 #ifndef OLA_OLACLIENTCORE_H_
 #define OLA_OLACLIENTCORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -41,6 +43,8 @@
 #include "ola/rdm/UIDSet.h"
 #include "ola/timecode/TimeCode.h"
 
+class OlaClientCoreTest;
+
 namespace ola {
 
 namespace rpc {
@@ -225,6 +229,17 @@ class OlaClientCore: public ola::proto::OlaClientService {
              unsigned int universe,
              SetCallback *callback);
 
+  /**
+   * @brief Apply a number of patch, priority, name and merge mode changes in
+   * a single request.
+   *
+   * olad saves the new configuration once, rather than after each change.
+   * @param config the UniverseConfig with the changes to make.
+   * @param callback the UniverseConfigCallback to invoke upon completion.
+   */
+  void ConfigureUniverses(const UniverseConfig &config,
+                          UniverseConfigCallback *callback);
+
   /**
    * @brief Register our interest in a universe. The callback set by
    * SetDMXCallback() will be called when new DMX data arrives.
@@ -246,6 +261,58 @@ class OlaClientCore: public ola::proto::OlaClientService {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Start a new DMX frame.
+   *
+   * A frame groups the updates for a number of universes so they can be sent
+   * to olad in a single request. Any data set since the last CommitFrame()
+   * is discarded.
+   */
+  void BeginFrame();
+
+  /**
+   * @brief Set the data for a universe in the current frame.
+   *
+   * If a universe is set more than once in a frame, only the last data is
+   * sent.
+   * @param universe the universe to send to.
+   * @param data the DmxBuffer with the data.
+   * @param priority the priority of the data.
+   */
+  void SetFrameDMX(unsigned int universe,
+                   const DmxBuffer &data,
+                   uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT);
+
+  /**
+   * @brief Send the current frame to olad.
+   *
+   * If MaxFramesInFlight() frames are waiting to be acknowledged, the frame
+   * is held back and sent once olad catches up. Held back frames are merged,
+   * so only the latest data for each universe is sent, and the callbacks for
+   * the merged frames all receive the result of the combined request.
+   * @param callback the callback to run once olad has applied the frame, may
+   *   be NULL.
+   * @returns true if the frame was sent, false if it was held back.
+   */
+  bool CommitFrame(GeneralSetCallback *callback);
+
+  /**
+   * @brief Set the number of frames that can be waiting for an
+   * acknowledgement from olad before frames are held back.
+   */
+  void SetMaxFramesInFlight(unsigned int max_frames);
+
+  /**
+   * @brief Set the callback to run when frames start or stop being held back.
+   * @param callback the BackPressureCallback, ownership is transferred.
+   */
+  void SetBackPressureCallback(BackPressureCallback *callback);
+
+  /**
+   * @brief Check if a frame is being held back.
+   */
+  bool FrameHeldBack() const;
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -263,6 +330,16 @@ class OlaClientCore: public ola::proto::OlaClientService {
                     DiscoveryType discovery_type,
                     DiscoveryCallback *callback);
 
+  /**
+   * @brief Find the universe a UID was discovered on.
+   * @param uid the UID to look for.
+   * @param callback the FindUIDCallback to invoke upon completion.
+   *
+   * If the UID is present on more than one universe, the universe it was
+   * most recently discovered on is returned.
+   */
+  void FindUID(const ola::rdm::UID &uid, FindUIDCallback *callback);
+
   /**
    * @brief Set the source UID for this client.
    * @param uid the UID to use when sending RDM messages from this client.
@@ -329,6 +406,23 @@ class OlaClientCore: public ola::proto::OlaClientService {
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
 
+  struct FrameData {
+    DmxBuffer data;
+    uint8_t priority;
+  };
+  typedef std::map<unsigned int, FrameData> FrameMap;
+  typedef std::vector<GeneralSetCallback*> FrameCallbacks;
+
+  // The frame between BeginFrame() and CommitFrame().
+  FrameMap m_frame;
+  // Committed frames that are being held back, and their callbacks.
+  FrameMap m_held_frame;
+  FrameCallbacks m_held_callbacks;
+  bool m_frame_held_back;
+  unsigned int m_frames_in_flight;
+  unsigned int m_max_frames_in_flight;
+  std::auto_ptr<BackPressureCallback> m_back_pressure_callback;
+
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
 
   /**
@@ -380,6 +474,27 @@ class OlaClientCore: public ola::proto::OlaClientService {
                         ola::proto::Ack *reply,
                         GeneralSetCallback *callback);
 
+  /**
+   * @brief Called when a ConfigureUniverses() request completes.
+   */
+  void HandleUniverseConfig(ola::rpc::RpcController *controller,
+                            ola::proto::UniverseConfigReply *reply,
+                            UniverseConfigCallback *callback);
+
+  /**
+   * @brief Send the held back frame.
+   */
+  void SendHeldFrame();
+
+  /**
+   * @brief Called when an UpdateDmxBatch() request completes.
+   */
+  void HandleFrameAck(ola::rpc::RpcController *controller,
+                      ola::proto::Ack *reply,
+                      FrameCallbacks *callbacks);
+
+  void SetFrameHeldBack(bool held_back);
+
   /**
    * @brief Called when a GetUniverseInfo() request completes.
    */
@@ -408,6 +523,13 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::UIDListReply *reply_ptr,
                      DiscoveryCallback *callback);
 
+  /**
+   * @brief Called when a FindUID() request completes.
+   */
+  void HandleFindUID(ola::rpc::RpcController *controller_ptr,
+                     ola::proto::UIDUniverseReply *reply_ptr,
+                     FindUIDCallback *callback);
+
   /**
    * @brief Called when a RDM request completes.
    */
@@ -442,6 +564,9 @@ class OlaClientCore: public ola::proto::OlaClientService {
       ola::rdm::RDMStatusCode *status_code);
 
   static const char NOT_CONNECTED_ERROR[];
+  static const unsigned int DEFAULT_MAX_FRAMES_IN_FLIGHT = 2;
+
+  friend class ::OlaClientCoreTest;
 
   DISALLOW_COPY_AND_ASSIGN(OlaClientCore);
 };
@@ -0,0 +1,417 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OlaClientCoreTest.cpp
+ * Test fixture for the frame API in OlaClientCore.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/protocol/Ola.pb.h"
+#include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/OlaClientCore.h"
+#include "ola/client/ClientTypes.h"
+#include "ola/dmx/SourcePriorities.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::client::OlaClientCore;
+using ola::client::Result;
+using ola::io::LoopbackDescriptor;
+using ola::io::SelectServer;
+using ola::io::UnixSocket;
+using ola::proto::DmxBatch;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using std::auto_ptr;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * An OlaServerService that holds on to each UpdateDmxBatch request until the
+ * test acknowledges it.
+ */
+class FakeOlaServer : public ola::proto::OlaServerService {
+ public:
+  void UpdateDmxBatch(RpcController *controller,
+                      const DmxBatch *request,
+                      ola::proto::Ack*,
+                      CompletionCallback *done) {
+    PendingBatch batch;
+    batch.controller = controller;
+    batch.request.CopyFrom(*request);
+    batch.done = done;
+    m_batches.push_back(batch);
+  }
+
+  unsigned int PendingBatches() const { return m_batches.size(); }
+
+  const DmxBatch &Batch(unsigned int i) const { return m_batches[i].request; }
+
+  /*
+   * Respond to the oldest batch, or fail it if error isn't empty.
+   */
+  void AckBatch(const string &error) {
+    PendingBatch batch = m_batches.front();
+    m_batches.pop_front();
+    if (!error.empty()) {
+      batch.controller->SetFailed(error);
+    }
+    batch.done->Run();
+  }
+
+ private:
+  struct PendingBatch {
+    RpcController *controller;
+    DmxBatch request;
+    CompletionCallback *done;
+  };
+
+  std::deque<PendingBatch> m_batches;
+};
+}  // namespace
+
+
+class OlaClientCoreTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OlaClientCoreTest);
+  CPPUNIT_TEST(testCoalescing);
+  CPPUNIT_TEST(testHeldFrames);
+  CPPUNIT_TEST(testMaxFramesInFlight);
+  CPPUNIT_TEST(testNotConnected);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testCoalescing();
+  void testHeldFrames();
+  void testMaxFramesInFlight();
+  void testNotConnected();
+
+ private:
+  typedef pair<unsigned int, string> FrameResult;
+
+  SelectServer m_ss;
+  FakeOlaServer m_server;
+  auto_ptr<UnixSocket> m_socket;
+  auto_ptr<UnixSocket> m_server_socket;
+  auto_ptr<RpcChannel> m_server_channel;
+  auto_ptr<OlaClientCore> m_client;
+  vector<FrameResult> m_results;
+  vector<bool> m_back_pressure;
+
+  void FrameComplete(unsigned int frame, const Result &result) {
+    m_results.push_back(FrameResult(frame, result.Error()));
+  }
+
+  void BackPressure(bool held_back) {
+    m_back_pressure.push_back(held_back);
+  }
+
+  bool CommitFrame(unsigned int frame);
+  void CheckResult(unsigned int i, unsigned int frame, const string &error);
+  void WaitForBatches(unsigned int count);
+  void AckBatch(const string &error = "");
+  void CheckData(const ola::proto::DmxData &data, unsigned int universe,
+                 const DmxBuffer &buffer,
+                 uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT);
+
+  static DmxBuffer Frame(uint8_t value);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OlaClientCoreTest);
+
+
+void OlaClientCoreTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  m_results.clear();
+  m_back_pressure.clear();
+
+  m_socket.reset(new UnixSocket());
+  OLA_ASSERT_TRUE(m_socket->Init());
+  m_server_socket.reset(m_socket->OppositeEnd());
+  m_server_channel.reset(new RpcChannel(&m_server, m_server_socket.get()));
+  OLA_ASSERT_TRUE(m_ss.AddReadDescriptor(m_socket.get()));
+  OLA_ASSERT_TRUE(m_ss.AddReadDescriptor(m_server_socket.get()));
+
+  m_client.reset(new OlaClientCore(m_socket.get()));
+  OLA_ASSERT_TRUE(m_client->Setup());
+  m_client->SetBackPressureCallback(
+      NewCallback(this, &OlaClientCoreTest::BackPressure));
+}
+
+
+void OlaClientCoreTest::tearDown() {
+  while (m_server.PendingBatches()) {
+    m_server.AckBatch("");
+  }
+  m_ss.RemoveReadDescriptor(m_socket.get());
+  m_ss.RemoveReadDescriptor(m_server_socket.get());
+  m_client.reset();
+  m_server_channel.reset();
+  m_server_socket.reset();
+  m_socket.reset();
+}
+
+
+/*
+ * Check the updates in a frame are sent as a single batch, with only the
+ * last data for each universe.
+ */
+void OlaClientCoreTest::testCoalescing() {
+  // BeginFrame() discards anything that wasn't committed
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(3, Frame(3));
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(1));
+  m_client->SetFrameDMX(2, Frame(2), 150);
+  m_client->SetFrameDMX(1, Frame(10));
+  OLA_ASSERT_TRUE(CommitFrame(1));
+  OLA_ASSERT_EQ(1u, m_client->m_frames_in_flight);
+
+  WaitForBatches(1);
+  const DmxBatch &batch = m_server.Batch(0);
+  OLA_ASSERT_EQ(2, batch.data_size());
+  CheckData(batch.data(0), 1, Frame(10));
+  CheckData(batch.data(1), 2, Frame(2), 150);
+
+  // an empty frame without a callback isn't sent
+  m_client->BeginFrame();
+  OLA_ASSERT_TRUE(m_client->CommitFrame(NULL));
+  OLA_ASSERT_EQ(1u, m_client->m_frames_in_flight);
+
+  AckBatch();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  CheckResult(0, 1, "");
+  OLA_ASSERT_EQ(0u, m_client->m_frames_in_flight);
+  OLA_ASSERT_EQ(0u, m_server.PendingBatches());
+  OLA_ASSERT_TRUE(m_back_pressure.empty());
+}
+
+
+/*
+ * Check frames are held back and merged once MaxFramesInFlight() batches are
+ * waiting, and sent when a batch is acknowledged.
+ */
+void OlaClientCoreTest::testHeldFrames() {
+  m_client->SetMaxFramesInFlight(2);
+
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(1));
+  OLA_ASSERT_TRUE(CommitFrame(1));
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(2, Frame(2));
+  OLA_ASSERT_TRUE(CommitFrame(2));
+  OLA_ASSERT_EQ(2u, m_client->m_frames_in_flight);
+  OLA_ASSERT_FALSE(m_client->FrameHeldBack());
+  OLA_ASSERT_TRUE(m_back_pressure.empty());
+
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(3));
+  OLA_ASSERT_FALSE(CommitFrame(3));
+  OLA_ASSERT_TRUE(m_client->FrameHeldBack());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_back_pressure.size());
+  OLA_ASSERT_TRUE(m_back_pressure[0]);
+
+  // later frames are merged into the held frame
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(4));
+  m_client->SetFrameDMX(3, Frame(4));
+  OLA_ASSERT_FALSE(CommitFrame(4));
+  m_client->BeginFrame();
+  OLA_ASSERT_FALSE(m_client->CommitFrame(NULL));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_back_pressure.size());
+  OLA_ASSERT_EQ(2u, m_client->m_frames_in_flight);
+
+  WaitForBatches(2);
+  OLA_ASSERT_EQ(1, m_server.Batch(0).data_size());
+  CheckData(m_server.Batch(0).data(0), 1, Frame(1));
+  OLA_ASSERT_EQ(1, m_server.Batch(1).data_size());
+  CheckData(m_server.Batch(1).data(0), 2, Frame(2));
+
+  // the first ack sends the held frame
+  AckBatch();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_results.size());
+  CheckResult(0, 1, "");
+  OLA_ASSERT_FALSE(m_client->FrameHeldBack());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_back_pressure.size());
+  OLA_ASSERT_FALSE(m_back_pressure[1]);
+  OLA_ASSERT_EQ(2u, m_client->m_frames_in_flight);
+  OLA_ASSERT_TRUE(m_client->m_held_frame.empty());
+  OLA_ASSERT_TRUE(m_client->m_held_callbacks.empty());
+
+  WaitForBatches(2);
+  const DmxBatch &merged = m_server.Batch(1);
+  OLA_ASSERT_EQ(2, merged.data_size());
+  CheckData(merged.data(0), 1, Frame(4));
+  CheckData(merged.data(1), 3, Frame(4));
+
+  AckBatch();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+  CheckResult(1, 2, "");
+  OLA_ASSERT_EQ(1u, m_client->m_frames_in_flight);
+
+  // both merged frames get the result of the batch
+  const string error = "Universe 3 doesn't exist";
+  AckBatch(error);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_results.size());
+  CheckResult(2, 3, error);
+  CheckResult(3, 4, error);
+  OLA_ASSERT_EQ(0u, m_client->m_frames_in_flight);
+  OLA_ASSERT_EQ(0u, m_server.PendingBatches());
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_back_pressure.size());
+}
+
+
+/*
+ * Check at least one frame is always allowed in flight.
+ */
+void OlaClientCoreTest::testMaxFramesInFlight() {
+  m_client->SetMaxFramesInFlight(0);
+  OLA_ASSERT_EQ(1u, m_client->m_max_frames_in_flight);
+
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(1));
+  OLA_ASSERT_TRUE(CommitFrame(1));
+  m_client->BeginFrame();
+  m_client->SetFrameDMX(1, Frame(2));
+  OLA_ASSERT_FALSE(CommitFrame(2));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_back_pressure.size());
+
+  WaitForBatches(1);
+  AckBatch();
+  WaitForBatches(1);
+  CheckData(m_server.Batch(0).data(0), 1, Frame(2));
+  AckBatch();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_results.size());
+  OLA_ASSERT_EQ(0u, m_client->m_frames_in_flight);
+
+  // raising the limit lets more frames through
+  m_client->SetMaxFramesInFlight(3);
+  for (unsigned int i = 3; i < 6; i++) {
+    m_client->BeginFrame();
+    m_client->SetFrameDMX(1, Frame(i));
+    OLA_ASSERT_TRUE(CommitFrame(i));
+  }
+  OLA_ASSERT_EQ(3u, m_client->m_frames_in_flight);
+  WaitForBatches(3);
+  AckBatch();
+  AckBatch();
+  AckBatch();
+  OLA_ASSERT_EQ(static_cast<size_t>(5), m_results.size());
+  OLA_ASSERT_EQ(0u, m_client->m_frames_in_flight);
+}
+
+
+/*
+ * Check a client that isn't connected fails frames without counting them as
+ * in flight.
+ */
+void OlaClientCoreTest::testNotConnected() {
+  LoopbackDescriptor descriptor;
+  OlaClientCore client(&descriptor);
+  client.SetBackPressureCallback(
+      NewCallback(this, &OlaClientCoreTest::BackPressure));
+
+  for (unsigned int i = 0; i < 3; i++) {
+    client.BeginFrame();
+    client.SetFrameDMX(1, Frame(i));
+    OLA_ASSERT_TRUE(client.CommitFrame(
+        NewSingleCallback(this, &OlaClientCoreTest::FrameComplete, i)));
+    OLA_ASSERT_EQ(0u, client.m_frames_in_flight);
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_results.size());
+  CheckResult(2, 2, "Not connected");
+  OLA_ASSERT_TRUE(m_back_pressure.empty());
+}
+
+
+bool OlaClientCoreTest::CommitFrame(unsigned int frame) {
+  return m_client->CommitFrame(
+      NewSingleCallback(this, &OlaClientCoreTest::FrameComplete, frame));
+}
+
+
+/*
+ * Check the i-th callback to run was for frame, with the given error.
+ */
+void OlaClientCoreTest::CheckResult(unsigned int i, unsigned int frame,
+                                    const string &error) {
+  OLA_ASSERT_TRUE(i < m_results.size());
+  OLA_ASSERT_EQ(frame, m_results[i].first);
+  OLA_ASSERT_EQ(error, m_results[i].second);
+}
+
+
+/*
+ * Run the select server until the server has count batches waiting.
+ */
+void OlaClientCoreTest::WaitForBatches(unsigned int count) {
+  for (unsigned int i = 0; i < 100 && m_server.PendingBatches() < count;
+       i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_EQ(count, m_server.PendingBatches());
+}
+
+
+/*
+ * Acknowledge the oldest batch and wait for the client to process the
+ * response.
+ */
+void OlaClientCoreTest::AckBatch(const string &error) {
+  const size_t results = m_results.size();
+  m_server.AckBatch(error);
+  for (unsigned int i = 0; i < 100 && m_results.size() == results; i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_TRUE(m_results.size() > results);
+}
+
+
+void OlaClientCoreTest::CheckData(const ola::proto::DmxData &data,
+                                  unsigned int universe,
+                                  const DmxBuffer &buffer,
+                                  uint8_t priority) {
+  OLA_ASSERT_EQ(static_cast<int>(universe), data.universe());
+  OLA_ASSERT_EQ(buffer.Get(), data.data());
+  OLA_ASSERT_EQ(static_cast<int>(priority), data.priority());
+}
+
+
+DmxBuffer OlaClientCoreTest::Frame(uint8_t value) {
+  const uint8_t data[] = {value, 0, value};
+  return DmxBuffer(data, sizeof(data));
+}
@@ -22,7 +22,8 @@ ola_server_sources = \
     olad/PluginLoader.h \
     olad/PluginManager.cpp \
     olad/PluginManager.h \
-    olad/RDMHTTPModule.h
+    olad/RDMHTTPModule.h \
+    olad/StreamHTTPModule.h
 ola_server_additional_libs =
 
 if HAVE_DNSSD
@@ -38,7 +39,8 @@ endif
 if HAVE_LIBMICROHTTPD
 ola_server_sources += olad/HttpServerActions.cpp \
                       olad/OladHTTPServer.cpp \
-                      olad/RDMHTTPModule.cpp
+                      olad/RDMHTTPModule.cpp \
+                      olad/StreamHTTPModule.cpp
 ola_server_additional_libs += common/http/libolahttp.la
 endif
 
@@ -96,4 +98,14 @@ olad_OlaTester_SOURCES = \
 olad_OlaTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
 olad_OlaTester_LDADD = $(COMMON_OLAD_TEST_LDADD)
 
+if HAVE_LIBMICROHTTPD
+test_programs += olad/StreamHTTPModuleTester
+
+olad_StreamHTTPModuleTester_SOURCES = olad/StreamHTTPModuleTest.cpp
+olad_StreamHTTPModuleTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
+olad_StreamHTTPModuleTester_LDADD = $(COMMON_OLAD_TEST_LDADD) \
+                                    common/http/libolahttp.la \
+                                    ola/libola.la
+endif
+
 CLEANFILES += olad/ola-output.conf
@@ -123,7 +123,7 @@ bool OlaDaemon::Init() {
     m_export_map->GetStringVar(CONFIG_DIR_KEY)->Set(config_dir);
   }
   auto_ptr<PreferencesFactory> preferences_factory(
-      new FileBackedPreferencesFactory(config_dir));
+      new FileBackedPreferencesFactory(config_dir, m_export_map, &m_ss));
 
   // Order is important here as we won't load the same plugin twice.
   m_plugin_loaders.push_back(new DynamicPluginLoader());
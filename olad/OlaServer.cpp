@@ -57,6 +57,7 @@
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/RDMResponseCache.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 #ifdef HAVE_LIBMICROHTTPD
@@ -80,6 +81,8 @@ using std::pair;
 using std::vector;
 
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
+const char OlaServer::PERSIST_RDM_CACHE_KEY[] = "persist-rdm-cache";
+const char OlaServer::RDM_CACHE_PREFERENCES[] = "rdm-cache";
 const char OlaServer::K_INSTANCE_NAME_VAR[] = "server-instance-name";
 const char OlaServer::K_UID_VAR[] = "server-uid";
 const char OlaServer::SERVER_PREFERENCES[] = "server";
@@ -103,6 +106,7 @@ OlaServer::OlaServer(const vector<PluginLoader*> &plugin_loaders,
       m_default_uid(OPEN_LIGHTING_ESTA_CODE, 0),
       m_server_preferences(NULL),
       m_universe_preferences(NULL),
+      m_rdm_cache_preferences(NULL),
       m_housekeeping_timeout(ola::thread::INVALID_TIMEOUT) {
   if (!m_export_map) {
     m_our_export_map.reset(new ExportMap());
@@ -128,6 +132,9 @@ OlaServer::~OlaServer() {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
   }
 
+  // Stopping the plugins unpatches the ports, which removes the devices from
+  // the RDM cache, so save it first.
+  SaveRDMCache();
   StopPlugins();
 
   m_broker.reset();
@@ -138,6 +145,8 @@ OlaServer::~OlaServer() {
     m_universe_store.reset();
   }
 
+  m_rdm_cache.reset();
+
   if (m_server_preferences) {
     m_server_preferences->Save();
   }
@@ -205,12 +214,25 @@ bool OlaServer::Init() {
   m_export_map->GetStringVar(K_INSTANCE_NAME_VAR)->Set(m_instance_name);
   OLA_INFO << "Server instance name is " << m_instance_name;
 
+  if (m_server_preferences->SetDefaultValue(PERSIST_RDM_CACHE_KEY,
+                                            BoolValidator(), false)) {
+    m_server_preferences->Save();
+  }
+
+  auto_ptr<RDMResponseCache> rdm_cache(new RDMResponseCache(m_export_map));
+  if (m_server_preferences->GetValueAsBool(PERSIST_RDM_CACHE_KEY)) {
+    m_rdm_cache_preferences = m_preferences_factory->NewPreference(
+        RDM_CACHE_PREFERENCES);
+    m_rdm_cache_preferences->Load();
+    rdm_cache->Load(*m_rdm_cache_preferences);
+  }
+
   Preferences *universe_preferences = m_preferences_factory->NewPreference(
       UNIVERSE_PREFERENCES);
   universe_preferences->Load();
 
   auto_ptr<UniverseStore> universe_store(
-      new UniverseStore(universe_preferences, m_export_map));
+      new UniverseStore(universe_preferences, m_export_map, rdm_cache.get()));
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -305,6 +327,7 @@ bool OlaServer::Init() {
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
   m_universe_store.reset(universe_store.release());
+  m_rdm_cache.reset(rdm_cache.release());
 
   UpdatePidStore(pid_store.release());
 
@@ -400,9 +423,21 @@ bool OlaServer::RunHousekeeping() {
       (*iter)->RunRDMDiscovery(NULL, false);
     }
   }
+  SaveRDMCache();
   return true;
 }
 
+
+/*
+ * Write the RDM cache to disk if persistence is enabled and it has changed.
+ */
+void OlaServer::SaveRDMCache() {
+  if (m_rdm_cache.get() && m_rdm_cache_preferences &&
+      m_rdm_cache->Save(m_rdm_cache_preferences)) {
+    m_rdm_cache_preferences->Save();
+  }
+}
+
 #ifdef HAVE_LIBMICROHTTPD
 bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
                                 const ola::network::Interface &iface) {
@@ -424,6 +459,7 @@ bool OlaServer::StartHttpServer(ola::rpc::RpcServer *server,
   options.data_dir = (m_options.http_data_dir.empty() ? HTTP_DATA_DIR :
                       m_options.http_data_dir);
   options.enable_quit = m_options.http_enable_quit;
+  options.preload_static_content = m_options.http_preload_static;
 
   auto_ptr<OladHTTPServer> httpd(
       new OladHTTPServer(m_export_map, options,
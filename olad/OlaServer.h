@@ -70,6 +70,8 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
     unsigned int http_port;  /** @brief Port to run the HTTP server on */
     /** @brief Directory that contains the static content */
     std::string http_data_dir;
+    /** @brief Load the static content into memory at startup */
+    bool http_preload_static;
     std::string network_interface;
     std::string pid_data_dir;  /** @brief Directory with the PID definitions */
   };
@@ -185,6 +187,7 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<class DeviceManager> m_device_manager;
   std::auto_ptr<class PluginManager> m_plugin_manager;
   std::auto_ptr<class PluginAdaptor> m_plugin_adaptor;
+  std::auto_ptr<class RDMResponseCache> m_rdm_cache;
   std::auto_ptr<class UniverseStore> m_universe_store;
   std::auto_ptr<class PortManager> m_port_manager;
   std::auto_ptr<class OlaServerServiceImpl> m_service_impl;
@@ -195,12 +198,14 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<ola::rpc::RpcServer> m_rpc_server;
   class Preferences *m_server_preferences;
   class Preferences *m_universe_preferences;
+  class Preferences *m_rdm_cache_preferences;
   std::string m_instance_name;
 
   ola::thread::timeout_id m_housekeeping_timeout;
   std::auto_ptr<OladHTTPServer_t> m_httpd;
 
   bool RunHousekeeping();
+  void SaveRDMCache();
 
 #ifdef HAVE_LIBMICROHTTPD
   bool StartHttpServer(ola::rpc::RpcServer *server,
@@ -219,6 +224,8 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   void UpdatePidStore(const ola::rdm::RootPidStore *pid_store);
 
   static const char INSTANCE_NAME_KEY[];
+  static const char PERSIST_RDM_CACHE_KEY[];
+  static const char RDM_CACHE_PREFERENCES[];
   static const char K_INSTANCE_NAME_VAR[];
   static const char K_DISCOVERY_SERVICE_TYPE[];
   static const char K_UID_VAR[];
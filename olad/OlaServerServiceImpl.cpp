@@ -20,6 +20,7 @@
  */
 
 #include <algorithm>
+#include <set>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
@@ -28,8 +29,10 @@
 #include "ola/CallbackRunner.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/timecode/TimeCode.h"
 #include "ola/timecode/TimeCodeEnums.h"
@@ -59,6 +62,7 @@ using ola::proto::DmxData;
 using ola::proto::MergeModeRequest;
 using ola::proto::OptionalUniverseRequest;
 using ola::proto::PatchPortRequest;
+using ola::proto::PortPriorityRequest;
 using ola::proto::PluginDescriptionReply;
 using ola::proto::PluginDescriptionRequest;
 using ola::proto::PluginInfo;
@@ -67,6 +71,8 @@ using ola::proto::PluginListRequest;
 using ola::proto::PortInfo;
 using ola::proto::RegisterDmxRequest;
 using ola::proto::UniverseInfo;
+using ola::proto::UniverseConfigReply;
+using ola::proto::UniverseConfigRequest;
 using ola::proto::UniverseInfoReply;
 using ola::proto::UniverseNameRequest;
 using ola::proto::UniverseRequest;
@@ -75,6 +81,7 @@ using ola::rdm::RDMResponse;
 using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
+using std::set;
 using std::string;
 using std::vector;
 
@@ -106,8 +113,86 @@ RDMRequest::OverrideOptions RDMRequestOptionsFromProto(
   }
   return options;
 }
+
+const char MISSING_DEVICE_ERROR[] = "Device doesn't exist";
+const char MISSING_PORT_ERROR[] = "Port doesn't exist";
+const char MISSING_UNIVERSE_ERROR[] = "Universe doesn't exist";
+const char INVALID_PRIORITY_ERROR[] =
+    "Invalid SetPortPriority request, see logs for more info";
+
+/*
+ * Return a port to the universe it was patched to before a ConfigureUniverses
+ * request.
+ */
+template <class PortClass>
+void RestorePatch(PortManager *port_manager, PortClass *port, bool patched,
+                  unsigned int universe_id) {
+  if (patched) {
+    port_manager->PatchPort(port, universe_id);
+  } else {
+    port_manager->UnPatchPort(port);
+  }
+}
+
+/*
+ * Restore the priority settings of a port. The value is restored even in
+ * inherit mode, since it's used if the port is switched back to static mode.
+ */
+void RestorePriority(PortManager *port_manager, Port *port,
+                     port_priority_mode mode, uint8_t value) {
+  port_manager->SetPriorityStatic(port, value);
+  if (mode == PRIORITY_MODE_INHERIT) {
+    port_manager->SetPriorityInherit(port);
+  }
+}
+
+/*
+ * Restore the name of a universe. This takes a copy of the name, since the
+ * callback only stores a reference for const string& arguments.
+ */
+void RestoreName(Universe *universe, string name) {
+  universe->SetName(name);
+}
+
+void AddConfigError(UniverseConfigReply *response,
+                    ola::proto::UniverseConfigItem item,
+                    int index,
+                    const string &error) {
+  ola::proto::UniverseConfigError *config_error = response->add_error();
+  config_error->set_item(item);
+  config_error->set_index(index);
+  config_error->set_error(error);
+}
 }  // namespace
 
+/*
+ * The changes made by a ConfigureUniverses request, so they can be undone,
+ * and the devices and universes that need to be saved afterwards.
+ */
+struct OlaServerServiceImpl::ConfigTransaction {
+  vector<SingleUseCallback0<void>*> undo_callbacks;
+  set<const AbstractDevice*> devices;
+  set<unsigned int> universes;
+
+  ~ConfigTransaction() {
+    STLDeleteElements(&undo_callbacks);
+  }
+
+  void AddUndo(SingleUseCallback0<void> *callback) {
+    undo_callbacks.push_back(callback);
+  }
+
+  // Undo the changes, most recent first.
+  void Rollback() {
+    vector<SingleUseCallback0<void>*>::reverse_iterator iter =
+        undo_callbacks.rbegin();
+    for (; iter != undo_callbacks.rend(); ++iter) {
+      (*iter)->Run();
+    }
+    undo_callbacks.clear();
+  }
+};
+
 typedef CallbackRunner<ola::rpc::RpcService::CompletionCallback> ClosureRunner;
 
 OlaServerServiceImpl::OlaServerServiceImpl(
@@ -174,21 +259,7 @@ void OlaServerServiceImpl::UpdateDmxData(
     return MissingUniverseError(controller);
   }
 
-  Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
-
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
-  }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
+  ApplyDmxData(GetClient(controller), universe, *request);
 }
 
 void OlaServerServiceImpl::StreamDmxData(
@@ -202,21 +273,31 @@ void OlaServerServiceImpl::StreamDmxData(
     return;
   }
 
+  ApplyDmxData(GetClient(controller), universe, *request);
+}
+
+void OlaServerServiceImpl::UpdateDmxBatch(
+    RpcController* controller,
+    const ola::proto::DmxBatch* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
   Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
+  vector<int> missing_universes;
+  for (int i = 0; i < request->data_size(); i++) {
+    const DmxData &data = request->data(i);
+    Universe *universe = m_universe_store->GetUniverse(data.universe());
+    if (universe) {
+      ApplyDmxData(client, universe, data);
+    } else {
+      missing_universes.push_back(data.universe());
+    }
+  }
 
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
+  if (!missing_universes.empty()) {
+    controller->SetFailed("Missing universes: " +
+                          ola::StringJoin(", ", missing_universes));
   }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
 }
 
 void OlaServerServiceImpl::SetUniverseName(
@@ -225,12 +306,10 @@ void OlaServerServiceImpl::SetUniverseName(
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
-  Universe *universe = m_universe_store->GetUniverse(request->universe());
-  if (!universe) {
-    return MissingUniverseError(controller);
+  string error;
+  if (!ApplyUniverseName(*request, NULL, &error)) {
+    controller->SetFailed(error);
   }
-
-  universe->SetName(request->name());
 }
 
 void OlaServerServiceImpl::SetMergeMode(
@@ -239,14 +318,10 @@ void OlaServerServiceImpl::SetMergeMode(
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
-  Universe *universe = m_universe_store->GetUniverse(request->universe());
-  if (!universe) {
-    return MissingUniverseError(controller);
+  string error;
+  if (!ApplyMergeMode(*request, NULL, &error)) {
+    controller->SetFailed(error);
   }
-
-  Universe::merge_mode mode = request->merge_mode() == ola::proto::HTP ?
-    Universe::MERGE_HTP : Universe::MERGE_LTP;
-  universe->SetMergeMode(mode);
 }
 
 void OlaServerServiceImpl::PatchPort(
@@ -255,101 +330,77 @@ void OlaServerServiceImpl::PatchPort(
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
-  AbstractDevice *device =
-    m_device_manager->GetDevice(request->device_alias());
-
-  if (!device) {
-    return MissingDeviceError(controller);
-  }
-
-  bool result;
-  if (request->is_output()) {
-    OutputPort *port = device->GetOutputPort(request->port_id());
-    if (!port) {
-      return MissingPortError(controller);
-    }
-
-    if (request->action() == ola::proto::PATCH) {
-      result = m_port_manager->PatchPort(port, request->universe());
-    } else {
-      result = m_port_manager->UnPatchPort(port);
-    }
-  } else {
-    InputPort *port = device->GetInputPort(request->port_id());
-    if (!port) {
-      return MissingPortError(controller);
-    }
-
-    if (request->action() == ola::proto::PATCH) {
-      result = m_port_manager->PatchPort(port, request->universe());
-    } else {
-      result = m_port_manager->UnPatchPort(port);
-    }
-  }
-
-  if (!result) {
-    controller->SetFailed("Patch port request failed");
+  string error;
+  if (!ApplyPatch(*request, NULL, &error)) {
+    controller->SetFailed(error);
   }
 }
 
 void OlaServerServiceImpl::SetPortPriority(
     RpcController* controller,
-    const ola::proto::PortPriorityRequest* request,
+    const PortPriorityRequest* request,
     Ack*,
     ola::rpc::RpcService::CompletionCallback* done) {
   ClosureRunner runner(done);
-  AbstractDevice *device =
-      m_device_manager->GetDevice(request->device_alias());
-
-  if (!device) {
-    return MissingDeviceError(controller);
+  string error;
+  if (!ApplyPortPriority(*request, NULL, &error)) {
+    controller->SetFailed(error);
   }
+}
 
-  bool status;
-
-  bool inherit_mode = true;
-  uint8_t value = 0;
-  if (request->priority_mode() == PRIORITY_MODE_STATIC) {
-    if (request->has_priority()) {
-      inherit_mode = false;
-      value = request->priority();
-    } else {
-      OLA_INFO << "In Set Port Priority, override mode was set but the value "
-                  "wasn't specified";
-      controller->SetFailed(
-          "Invalid SetPortPriority request, see logs for more info");
-      return;
+void OlaServerServiceImpl::ConfigureUniverses(
+    RpcController*,
+    const UniverseConfigRequest* request,
+    UniverseConfigReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  ConfigTransaction transaction;
+  string error;
+
+  // Patching may create universes, so do that first to allow the other
+  // changes to refer to them.
+  for (int i = 0; i < request->patch_size(); i++) {
+    if (!ApplyPatch(request->patch(i), &transaction, &error)) {
+      AddConfigError(response, ola::proto::CONFIG_PATCH, i, error);
     }
   }
-
-  if (request->is_output()) {
-    OutputPort *port = device->GetOutputPort(request->port_id());
-    if (!port) {
-      return MissingPortError(controller);
+  for (int i = 0; i < request->priority_size(); i++) {
+    if (!ApplyPortPriority(request->priority(i), &transaction, &error)) {
+      AddConfigError(response, ola::proto::CONFIG_PRIORITY, i, error);
     }
-
-    if (inherit_mode) {
-      status = m_port_manager->SetPriorityInherit(port);
-    } else {
-      status = m_port_manager->SetPriorityStatic(port, value);
+  }
+  for (int i = 0; i < request->name_size(); i++) {
+    if (!ApplyUniverseName(request->name(i), &transaction, &error)) {
+      AddConfigError(response, ola::proto::CONFIG_NAME, i, error);
     }
-  } else {
-    InputPort *port = device->GetInputPort(request->port_id());
-    if (!port) {
-      return MissingPortError(controller);
+  }
+  for (int i = 0; i < request->merge_mode_size(); i++) {
+    if (!ApplyMergeMode(request->merge_mode(i), &transaction, &error)) {
+      AddConfigError(response, ola::proto::CONFIG_MERGE_MODE, i, error);
     }
+  }
 
-    if (inherit_mode) {
-      status = m_port_manager->SetPriorityInherit(port);
-    } else {
-      status = m_port_manager->SetPriorityStatic(port, value);
-    }
+  if (request->all_or_nothing() && response->error_size()) {
+    transaction.Rollback();
+    response->set_applied(false);
+    return;
   }
+  response->set_applied(true);
 
-  if (!status) {
-    controller->SetFailed(
-        "Invalid SetPortPriority request, see logs for more info");
+  // Save the new configuration once, rather than once per change.
+  vector<const AbstractDevice*> devices(transaction.devices.begin(),
+                                        transaction.devices.end());
+  m_device_manager->SaveDeviceSettings(devices);
+
+  vector<Universe*> universes;
+  set<unsigned int>::const_iterator iter = transaction.universes.begin();
+  for (; iter != transaction.universes.end(); ++iter) {
+    Universe *universe = m_universe_store->GetUniverse(*iter);
+    if (universe) {
+      universes.push_back(universe);
+    }
   }
+  m_universe_store->SaveUniverseSettings(universes);
 }
 
 void OlaServerServiceImpl::AddUniverse(
@@ -684,6 +735,21 @@ void OlaServerServiceImpl::GetUIDs(
   }
 }
 
+void OlaServerServiceImpl::FindUID(
+    RpcController* controller,
+    const ola::proto::UID* request,
+    ola::proto::UIDUniverseReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  UID uid(request->esta_id(), request->device_id());
+  Universe *universe = m_universe_store->GetUniverseForUID(uid);
+  if (!universe) {
+    controller->SetFailed("UID not found");
+    return;
+  }
+  response->set_universe(universe->UniverseId());
+}
+
 void OlaServerServiceImpl::ForceDiscovery(
     RpcController* controller,
     const ola::proto::DiscoveryRequest* request,
@@ -937,12 +1003,184 @@ void OlaServerServiceImpl::RDMDiscoveryComplete(
 }
 
 
+void OlaServerServiceImpl::ApplyDmxData(Client *client, Universe *universe,
+                                        const DmxData &data) {
+  DmxBuffer buffer;
+  buffer.Set(data.data());
+
+  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+  if (data.has_priority()) {
+    priority = data.priority();
+    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
+                        priority);
+    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                        priority);
+  }
+  DmxSource source(buffer, *m_wake_up_time, priority);
+  client->DMXReceived(data.universe(), source);
+  universe->SourceClientDataChanged(client);
+}
+
+bool OlaServerServiceImpl::ApplyPatch(const PatchPortRequest &request,
+                                      ConfigTransaction *transaction,
+                                      string *error) {
+  AbstractDevice *device = m_device_manager->GetDevice(request.device_alias());
+  if (!device) {
+    *error = MISSING_DEVICE_ERROR;
+    return false;
+  }
+
+  bool result;
+  if (request.is_output()) {
+    OutputPort *port = device->GetOutputPort(request.port_id());
+    if (!port) {
+      *error = MISSING_PORT_ERROR;
+      return false;
+    }
+    result = PatchOrUnPatch(port, request, transaction);
+  } else {
+    InputPort *port = device->GetInputPort(request.port_id());
+    if (!port) {
+      *error = MISSING_PORT_ERROR;
+      return false;
+    }
+    result = PatchOrUnPatch(port, request, transaction);
+  }
+
+  if (!result) {
+    *error = "Patch port request failed";
+    return false;
+  }
+  if (transaction) {
+    transaction->devices.insert(device);
+  }
+  return true;
+}
+
+template <class PortClass>
+bool OlaServerServiceImpl::PatchOrUnPatch(PortClass *port,
+                                          const PatchPortRequest &request,
+                                          ConfigTransaction *transaction) {
+  const Universe *old_universe = port->GetUniverse();
+  bool result;
+  if (request.action() == ola::proto::PATCH) {
+    result = m_port_manager->PatchPort(port, request.universe());
+  } else {
+    result = m_port_manager->UnPatchPort(port);
+  }
+
+  if (result && transaction) {
+    transaction->AddUndo(NewSingleCallback(
+        &RestorePatch<PortClass>, m_port_manager, port, old_universe != NULL,
+        old_universe ? old_universe->UniverseId() : 0));
+    if (port->GetUniverse()) {
+      transaction->universes.insert(port->GetUniverse()->UniverseId());
+    }
+  }
+  return result;
+}
+
+bool OlaServerServiceImpl::ApplyPortPriority(
+    const PortPriorityRequest &request,
+    ConfigTransaction *transaction,
+    string *error) {
+  AbstractDevice *device = m_device_manager->GetDevice(request.device_alias());
+  if (!device) {
+    *error = MISSING_DEVICE_ERROR;
+    return false;
+  }
+
+  bool inherit_mode = true;
+  uint8_t value = 0;
+  if (request.priority_mode() == PRIORITY_MODE_STATIC) {
+    if (request.has_priority()) {
+      inherit_mode = false;
+      value = request.priority();
+    } else {
+      OLA_INFO << "In Set Port Priority, override mode was set but the value "
+                  "wasn't specified";
+      *error = INVALID_PRIORITY_ERROR;
+      return false;
+    }
+  }
+
+  Port *port;
+  if (request.is_output()) {
+    port = device->GetOutputPort(request.port_id());
+  } else {
+    port = device->GetInputPort(request.port_id());
+  }
+  if (!port) {
+    *error = MISSING_PORT_ERROR;
+    return false;
+  }
+
+  const port_priority_mode old_mode = port->GetPriorityMode();
+  const uint8_t old_value = port->GetPriority();
+  bool status;
+  if (inherit_mode) {
+    status = m_port_manager->SetPriorityInherit(port);
+  } else {
+    status = m_port_manager->SetPriorityStatic(port, value);
+  }
+
+  if (!status) {
+    *error = INVALID_PRIORITY_ERROR;
+    return false;
+  }
+  if (transaction) {
+    transaction->AddUndo(NewSingleCallback(
+        &RestorePriority, m_port_manager, port, old_mode, old_value));
+    transaction->devices.insert(device);
+  }
+  return true;
+}
+
+bool OlaServerServiceImpl::ApplyUniverseName(
+    const UniverseNameRequest &request,
+    ConfigTransaction *transaction,
+    string *error) {
+  Universe *universe = m_universe_store->GetUniverse(request.universe());
+  if (!universe) {
+    *error = MISSING_UNIVERSE_ERROR;
+    return false;
+  }
+
+  if (transaction) {
+    transaction->AddUndo(NewSingleCallback(&RestoreName, universe,
+                                           universe->Name()));
+    transaction->universes.insert(universe->UniverseId());
+  }
+  universe->SetName(request.name());
+  return true;
+}
+
+bool OlaServerServiceImpl::ApplyMergeMode(const MergeModeRequest &request,
+                                          ConfigTransaction *transaction,
+                                          string *error) {
+  Universe *universe = m_universe_store->GetUniverse(request.universe());
+  if (!universe) {
+    *error = MISSING_UNIVERSE_ERROR;
+    return false;
+  }
+
+  if (transaction) {
+    transaction->AddUndo(NewSingleCallback(universe, &Universe::SetMergeMode,
+                                           universe->MergeMode()));
+    transaction->universes.insert(universe->UniverseId());
+  }
+  Universe::merge_mode mode = request.merge_mode() == ola::proto::HTP ?
+    Universe::MERGE_HTP : Universe::MERGE_LTP;
+  universe->SetMergeMode(mode);
+  return true;
+}
+
 void OlaServerServiceImpl::MissingUniverseError(RpcController* controller) {
-  controller->SetFailed("Universe doesn't exist");
+  controller->SetFailed(MISSING_UNIVERSE_ERROR);
 }
 
 void OlaServerServiceImpl::MissingDeviceError(RpcController* controller) {
-  controller->SetFailed("Device doesn't exist");
+  controller->SetFailed(MISSING_DEVICE_ERROR);
 }
 
 
@@ -952,7 +1190,7 @@ void OlaServerServiceImpl::MissingPluginError(RpcController* controller) {
 
 
 void OlaServerServiceImpl::MissingPortError(RpcController* controller) {
-  controller->SetFailed("Port doesn't exist");
+  controller->SetFailed(MISSING_PORT_ERROR);
 }
 
 
@@ -99,6 +99,17 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                      ::ola::proto::STREAMING_NO_RESPONSE* response,
                      ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Update the DMX values for a set of universes.
+   *
+   * Universes that exist are updated even if others in the batch don't, the
+   * missing universes are listed in the error.
+   */
+  void UpdateDmxBatch(ola::rpc::RpcController* controller,
+                      const ola::proto::DmxBatch* request,
+                      ola::proto::Ack* response,
+                      ola::rpc::RpcService::CompletionCallback* done);
+
 
   /**
    * @brief Sets the name of a universe.
@@ -132,6 +143,18 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        ola::proto::Ack* response,
                        ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Apply a set of patch, name, merge mode and priority changes.
+   *
+   * All changes are made in one pass and the configuration is saved once at
+   * the end. Failed items are listed in the reply, if all_or_nothing is set
+   * and any item fails, the changes that were made are rolled back.
+   */
+  void ConfigureUniverses(ola::rpc::RpcController* controller,
+                          const ola::proto::UniverseConfigRequest* request,
+                          ola::proto::UniverseConfigReply* response,
+                          ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Returns information on the active universes.
    */
@@ -215,6 +238,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                ola::proto::UIDListReply* response,
                ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Find the universe a UID was most recently discovered on.
+   */
+  void FindUID(ola::rpc::RpcController* controller,
+               const ola::proto::UID* request,
+               ola::proto::UIDUniverseReply* response,
+               ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Force RDM discovery for a universe.
    */
@@ -269,6 +300,29 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                             ola::proto::UIDListReply *response,
                             const ola::rdm::UIDSet &uids);
 
+  void ApplyDmxData(class Client *client, Universe *universe,
+                    const ola::proto::DmxData &data);
+
+  // Tracks the changes made by ConfigureUniverses().
+  struct ConfigTransaction;
+
+  bool ApplyPatch(const ola::proto::PatchPortRequest &request,
+                  ConfigTransaction *transaction,
+                  std::string *error);
+  template <class PortClass>
+  bool PatchOrUnPatch(PortClass *port,
+                      const ola::proto::PatchPortRequest &request,
+                      ConfigTransaction *transaction);
+  bool ApplyPortPriority(const ola::proto::PortPriorityRequest &request,
+                         ConfigTransaction *transaction,
+                         std::string *error);
+  bool ApplyUniverseName(const ola::proto::UniverseNameRequest &request,
+                         ConfigTransaction *transaction,
+                         std::string *error);
+  bool ApplyMergeMode(const ola::proto::MergeModeRequest &request,
+                      ConfigTransaction *transaction,
+                      std::string *error);
+
   void MissingUniverseError(ola::rpc::RpcController* controller);
   void MissingPluginError(ola::rpc::RpcController* controller);
   void MissingDeviceError(ola::rpc::RpcController* controller);
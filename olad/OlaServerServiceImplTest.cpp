@@ -34,12 +34,17 @@
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "ola/testing/TestUtils.h"
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/PluginLoader.h"
+#include "olad/PortBroker.h"
+#include "olad/Preferences.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 using ola::Client;
@@ -58,8 +63,11 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetDmx);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
+  CPPUNIT_TEST(testUpdateDmxBatch);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
+  CPPUNIT_TEST(testConfigureUniverses);
+  CPPUNIT_TEST(testFindUID);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -74,8 +82,11 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     void testGetDmx();
     void testRegisterForDmx();
     void testUpdateDmxData();
+    void testUpdateDmxBatch();
     void testSetUniverseName();
     void testSetMergeMode();
+    void testConfigureUniverses();
+    void testFindUID();
 
  private:
     ola::rdm::UID m_uid;
@@ -101,6 +112,13 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
                           int universe_id,
                           ola::proto::MergeMode merge_mode,
                           class SetMergeModeCheck *check);
+    void CallConfigureUniverses(
+        OlaServerServiceImpl *service,
+        const ola::proto::UniverseConfigRequest &request,
+        ola::proto::UniverseConfigReply *response);
+    bool CallFindUID(OlaServerServiceImpl *service,
+                     const ola::rdm::UID &uid,
+                     ola::proto::UIDUniverseReply *response);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OlaServerServiceImplTest);
@@ -167,6 +185,18 @@ class UpdateDmxDataCheck {
 };
 
 
+/*
+ * Assert that universes 3 & 5 were missing from a batch.
+ */
+class MissingUniversesCheck: public UpdateDmxDataCheck {
+ public:
+  void Check(RpcController *controller, OLA_UNUSED ola::proto::Ack *r) {
+    OLA_ASSERT(controller->Failed());
+    OLA_ASSERT_EQ(string("Missing universes: 3, 5"), controller->ErrorText());
+  }
+};
+
+
 /*
  * SetUniverseNameCheck
  */
@@ -212,6 +242,14 @@ class GenericAckCheck: public parent {
 };
 
 
+/*
+ * Run when an RPC completes.
+ */
+static void MarkDone(bool *done) {
+  *done = true;
+}
+
+
 /*
  * Check that the GetDmx method works
  */
@@ -422,6 +460,71 @@ void OlaServerServiceImplTest::CallUpdateDmxData(
   service->UpdateDmxData(&controller, &request, &response, closure);
 }
 
+/*
+ * Check the UpdateDmxBatch method works.
+ */
+void OlaServerServiceImplTest::testUpdateDmxBatch() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  m_clock.CurrentTime(&time1);
+
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  DmxBuffer dmx_data("this is a test");
+  DmxBuffer dmx_data2("different data hmm");
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  ola::proto::Ack response;
+
+  {
+    RpcController controller(&session);
+    ola::proto::DmxBatch request;
+    ola::proto::DmxData *data = request.add_data();
+    data->set_universe(1);
+    data->set_data(dmx_data.Get());
+    data = request.add_data();
+    data->set_universe(2);
+    data->set_data(dmx_data2.Get());
+
+    GenericAckCheck<UpdateDmxDataCheck> ack_check;
+    service.UpdateDmxBatch(
+        &controller, &request, &response,
+        NewSingleCallback(static_cast<UpdateDmxDataCheck*>(&ack_check),
+                          &UpdateDmxDataCheck::Check, &controller,
+                          &response));
+    OLA_ASSERT_EQ(dmx_data, universe1->GetDMX());
+    OLA_ASSERT_EQ(dmx_data2, universe2->GetDMX());
+  }
+
+  // Universes that exist are still updated if others in the batch don't.
+  {
+    RpcController controller(&session);
+    ola::proto::DmxBatch request;
+    ola::proto::DmxData *data = request.add_data();
+    data->set_universe(3);
+    data->set_data(dmx_data.Get());
+    data = request.add_data();
+    data->set_universe(1);
+    data->set_data(dmx_data2.Get());
+    data = request.add_data();
+    data->set_universe(5);
+    data->set_data(dmx_data.Get());
+
+    MissingUniversesCheck missing_universes_check;
+    service.UpdateDmxBatch(
+        &controller, &request, &response,
+        NewSingleCallback(
+            static_cast<UpdateDmxDataCheck*>(&missing_universes_check),
+            &UpdateDmxDataCheck::Check, &controller, &response));
+    OLA_ASSERT_EQ(dmx_data2, universe1->GetDMX());
+    OLA_ASSERT_FALSE(store.GetUniverse(3));
+  }
+}
+
 /*
  * Check the SetUniverseName method works
  */
@@ -535,3 +638,188 @@ void OlaServerServiceImplTest::CallSetMergeMode(
   request.set_merge_mode(merge_mode);
   service->SetMergeMode(&controller, &request, &response, closure);
 }
+
+/*
+ * Check the ConfigureUniverses method works.
+ */
+void OlaServerServiceImplTest::testConfigureUniverses() {
+  ola::MemoryPreferencesFactory prefs_factory;
+  ola::Preferences *universe_prefs = prefs_factory.NewPreference("universe");
+  ola::Preferences *port_prefs = prefs_factory.NewPreference("port");
+  UniverseStore store(universe_prefs, NULL);
+  ola::PortBroker broker;
+  ola::PortManager port_manager(&store, &broker);
+  ola::DeviceManager device_manager(&prefs_factory, &port_manager);
+  OlaServerServiceImpl service(&store, &device_manager, NULL, &port_manager,
+                               NULL, NULL, NULL);
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device(&plugin, "test-device-1");
+  TestMockOutputPort output_port(&device, 1);
+  TestMockPriorityInputPort input_port(&device, 1, NULL);
+  device.AddPort(&output_port);
+  device.AddPort(&input_port);
+  OLA_ASSERT(device_manager.RegisterDevice(&device));
+  unsigned int alias = device_manager.GetDevice(device.UniqueId()).alias;
+  const ola::port_priority_mode initial_mode = input_port.GetPriorityMode();
+  const uint8_t initial_priority = input_port.GetPriority();
+
+  ola::proto::UniverseConfigRequest request;
+  ola::proto::PatchPortRequest *patch = request.add_patch();
+  patch->set_universe(1);
+  patch->set_device_alias(alias);
+  patch->set_is_output(true);
+  patch->set_port_id(1);
+  patch->set_action(ola::proto::PATCH);
+  ola::proto::PortPriorityRequest *priority = request.add_priority();
+  priority->set_device_alias(alias);
+  priority->set_is_output(false);
+  priority->set_port_id(1);
+  priority->set_priority_mode(ola::PRIORITY_MODE_STATIC);
+  priority->set_priority(150);
+  OLA_ASSERT_NE(static_cast<uint8_t>(150), initial_priority);
+  // Universe 1 is created by the patch.
+  ola::proto::UniverseNameRequest *name = request.add_name();
+  name->set_universe(1);
+  name->set_name("Stage");
+  ola::proto::MergeModeRequest *merge_mode = request.add_merge_mode();
+  merge_mode->set_universe(1);
+  merge_mode->set_merge_mode(ola::proto::LTP);
+  // Universe 2 doesn't exist.
+  name = request.add_name();
+  name->set_universe(2);
+  name->set_name("Missing");
+
+  // The bad item means nothing is applied.
+  ola::proto::UniverseConfigReply response;
+  CallConfigureUniverses(&service, request, &response);
+  OLA_ASSERT_FALSE(response.applied());
+  OLA_ASSERT_EQ(1, response.error_size());
+  OLA_ASSERT_EQ(ola::proto::CONFIG_NAME, response.error(0).item());
+  OLA_ASSERT_EQ(1, response.error(0).index());
+  OLA_ASSERT_EQ(string("Universe doesn't exist"), response.error(0).error());
+  OLA_ASSERT_NULL(output_port.GetUniverse());
+  OLA_ASSERT_EQ(initial_mode, input_port.GetPriorityMode());
+  OLA_ASSERT_EQ(initial_priority, input_port.GetPriority());
+  OLA_ASSERT_EQ(string(""), port_prefs->GetValue("2-test-device-1-O-1"));
+
+  // Without all_or_nothing, the other items are applied and saved.
+  request.set_all_or_nothing(false);
+  response.Clear();
+  CallConfigureUniverses(&service, request, &response);
+  OLA_ASSERT(response.applied());
+  OLA_ASSERT_EQ(1, response.error_size());
+  OLA_ASSERT_EQ(ola::proto::CONFIG_NAME, response.error(0).item());
+
+  Universe *universe = output_port.GetUniverse();
+  OLA_ASSERT_NOT_NULL(universe);
+  OLA_ASSERT_EQ(1u, universe->UniverseId());
+  OLA_ASSERT_EQ(string("Stage"), universe->Name());
+  OLA_ASSERT_EQ(Universe::MERGE_LTP, universe->MergeMode());
+  OLA_ASSERT_EQ(ola::PRIORITY_MODE_STATIC, input_port.GetPriorityMode());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), input_port.GetPriority());
+
+  OLA_ASSERT_EQ(string("1"), port_prefs->GetValue("2-test-device-1-O-1"));
+  OLA_ASSERT_EQ(string("1"),
+                port_prefs->GetValue("2-test-device-1-I-1_priority_mode"));
+  OLA_ASSERT_EQ(string("150"),
+                port_prefs->GetValue("2-test-device-1-I-1_priority_value"));
+  OLA_ASSERT_EQ(string("Stage"), universe_prefs->GetValue("uni_1_name"));
+  OLA_ASSERT_EQ(string("LTP"), universe_prefs->GetValue("uni_1_merge"));
+
+  // Undoing an unpatch puts the port back on its old universe.
+  request.Clear();
+  patch = request.add_patch();
+  patch->set_universe(1);
+  patch->set_device_alias(alias);
+  patch->set_is_output(true);
+  patch->set_port_id(1);
+  patch->set_action(ola::proto::UNPATCH);
+  patch = request.add_patch();
+  patch->set_device_alias(alias);
+  patch->set_is_output(true);
+  patch->set_port_id(2);
+  patch->set_action(ola::proto::PATCH);
+  patch->set_universe(1);
+  response.Clear();
+  CallConfigureUniverses(&service, request, &response);
+  OLA_ASSERT_FALSE(response.applied());
+  OLA_ASSERT_EQ(1, response.error_size());
+  OLA_ASSERT_EQ(ola::proto::CONFIG_PATCH, response.error(0).item());
+  OLA_ASSERT_EQ(string("Port doesn't exist"), response.error(0).error());
+  OLA_ASSERT_EQ(universe, output_port.GetUniverse());
+
+  device_manager.UnregisterAllDevices();
+}
+
+/*
+ * Call the ConfigureUniverses method.
+ */
+void OlaServerServiceImplTest::CallConfigureUniverses(
+    OlaServerServiceImpl *service,
+    const ola::proto::UniverseConfigRequest &request,
+    ola::proto::UniverseConfigReply *response) {
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  bool done = false;
+  service->ConfigureUniverses(
+      &controller, &request, response,
+      NewSingleCallback(&MarkDone, &done));
+  OLA_ASSERT(done);
+  OLA_ASSERT_FALSE(controller.Failed());
+}
+
+/*
+ * Check the FindUID method works.
+ */
+void OlaServerServiceImplTest::testFindUID() {
+  UniverseStore store(NULL, NULL);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL, NULL, NULL);
+
+  ola::rdm::UID uid1(ola::OPEN_LIGHTING_ESTA_CODE, 1);
+  ola::rdm::UID uid2(ola::OPEN_LIGHTING_ESTA_CODE, 2);
+  ola::proto::UIDUniverseReply response;
+  OLA_ASSERT_FALSE(CallFindUID(&service, uid1, &response));
+
+  ola::rdm::UIDSet port1_uids, port2_uids;
+  port1_uids.AddUID(uid1);
+  port2_uids.AddUID(uid2);
+  TestMockRDMOutputPort port1(NULL, 1, &port1_uids, true);
+  TestMockRDMOutputPort port2(NULL, 2, &port2_uids, true);
+  Universe *universe1 = store.GetUniverseOrCreate(1);
+  Universe *universe2 = store.GetUniverseOrCreate(2);
+  universe1->AddPort(&port1);
+  port1.SetUniverse(universe1);
+  universe2->AddPort(&port2);
+  port2.SetUniverse(universe2);
+
+  OLA_ASSERT(CallFindUID(&service, uid1, &response));
+  OLA_ASSERT_EQ(1, response.universe());
+  OLA_ASSERT(CallFindUID(&service, uid2, &response));
+  OLA_ASSERT_EQ(2, response.universe());
+
+  universe2->RemovePort(&port2);
+  OLA_ASSERT_FALSE(CallFindUID(&service, uid2, &response));
+  universe1->RemovePort(&port1);
+}
+
+/*
+ * Call the FindUID method.
+ * @returns true if the RPC succeeded.
+ */
+bool OlaServerServiceImplTest::CallFindUID(
+    OlaServerServiceImpl *service,
+    const ola::rdm::UID &uid,
+    ola::proto::UIDUniverseReply *response) {
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  ola::proto::UID request;
+  request.set_esta_id(uid.ManufacturerId());
+  request.set_device_id(uid.DeviceId());
+  bool done = false;
+  response->Clear();
+  service->FindUID(&controller, &request, response,
+                   NewSingleCallback(&MarkDone, &done));
+  OLA_ASSERT(done);
+  return !controller.Failed();
+}
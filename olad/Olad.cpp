@@ -52,6 +52,9 @@ DEFINE_default_bool(http_quit, true, "Disable the HTTP /quit handler.");
 DEFINE_s_default_bool(daemon, f, false, "Fork and run in the background.");
 #endif  // _WIN32
 DEFINE_s_string(http_data_dir, d, "", "The path to the static www content.");
+DEFINE_default_bool(http_preload, true,
+                    "Read the static www content from disk for each request, "
+                    "rather than loading it into memory at startup.");
 DEFINE_s_string(interface, i, "",
                 "The interface name (e.g. eth0) or IP of the network interface "
                 "to use.");
@@ -130,6 +133,7 @@ int main(int argc, char *argv[]) {
   options.http_enable_quit = FLAGS_http_quit;
   options.http_port = FLAGS_http_port;
   options.http_data_dir = FLAGS_http_data_dir.str();
+  options.http_preload_static = FLAGS_http_preload;
   options.network_interface = FLAGS_interface.str();
   options.pid_data_dir = FLAGS_pid_location.str();
 
@@ -32,6 +32,7 @@
 #include "ola/dmx/SourcePriorities.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/web/Json.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/DmxSource.h"
 #include "olad/HttpServerActions.h"
 #include "olad/OladHTTPServer.h"
@@ -52,6 +53,7 @@ using ola::http::HTTPServer;
 using ola::io::ConnectedDescriptor;
 using ola::web::JsonArray;
 using ola::web::JsonObject;
+using ola::web::JsonStreamWriter;
 using std::cout;
 using std::endl;
 using std::ostringstream;
@@ -85,7 +87,10 @@ OladHTTPServer::OladHTTPServer(ExportMap *export_map,
       m_ola_server(ola_server),
       m_enable_quit(options.enable_quit),
       m_interface(iface),
-      m_rdm_module(&m_server, &m_client) {
+      m_rdm_module(&m_server, &m_client),
+      m_stream_module(
+          &m_server, &m_client,
+          NewCallback(this, &OladHTTPServer::ServerStatsToJson)) {
   // The main handlers
   RegisterHandler("/quit", &OladHTTPServer::DisplayQuit);
   RegisterHandler("/reload", &OladHTTPServer::ReloadPlugins);
@@ -431,6 +436,22 @@ void OladHTTPServer::SetPidStore(const ola::rdm::RootPidStore *pid_store) {
  */
 int OladHTTPServer::JsonServerStats(const HTTPRequest*,
                                     HTTPResponse *response) {
+  JsonObject json;
+  ServerStatsToJson(&json);
+
+  response->SetNoCache();
+  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
+  int r = response->SendJson(json);
+  delete response;
+  return r;
+}
+
+
+/**
+ * @brief Populate the server stats.
+ * @param json the JsonObject to add the stats to.
+ */
+void OladHTTPServer::ServerStatsToJson(JsonObject *json) {
   char start_time_str[50];
 #ifdef _WIN32
   strftime(start_time_str, sizeof(start_time_str), "%c",
@@ -441,24 +462,17 @@ int OladHTTPServer::JsonServerStats(const HTTPRequest*,
   strftime(start_time_str, sizeof(start_time_str), "%c", &start_time);
 #endif  // _WIN32
 
-  JsonObject json;
-  json.Add("hostname", ola::network::FQDN());
-  json.Add("instance_name", m_ola_server->InstanceName());
-  json.Add("config_dir",
-           m_ola_server->GetPreferencesFactory()->ConfigLocation());
-  json.Add("ip", m_interface.ip_address.ToString());
-  json.Add("broadcast", m_interface.bcast_address.ToString());
-  json.Add("subnet", m_interface.subnet_mask.ToString());
-  json.Add("hw_address", m_interface.hw_address.ToString());
-  json.Add("version", ola::base::Version::GetVersion());
-  json.Add("up_since", start_time_str);
-  json.Add("quit_enabled", m_enable_quit);
-
-  response->SetNoCache();
-  response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  int r = response->SendJson(json);
-  delete response;
-  return r;
+  json->Add("hostname", ola::network::FQDN());
+  json->Add("instance_name", m_ola_server->InstanceName());
+  json->Add("config_dir",
+            m_ola_server->GetPreferencesFactory()->ConfigLocation());
+  json->Add("ip", m_interface.ip_address.ToString());
+  json->Add("broadcast", m_interface.bcast_address.ToString());
+  json->Add("subnet", m_interface.subnet_mask.ToString());
+  json->Add("hw_address", m_interface.hw_address.ToString());
+  json->Add("version", ola::base::Version::GetVersion());
+  json->Add("up_since", start_time_str);
+  json->Add("quit_enabled", m_enable_quit);
 }
 
 
@@ -835,7 +849,21 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
     return;
   }
 
-  JsonObject *json = new JsonObject();
+  // The plugins are written straight into the response, the writer is
+  // finished off once the universe list arrives.
+  JsonStreamWriter *json = new JsonStreamWriter(response);
+  json->StartObject();
+  json->StartArray("plugins");
+  vector<OlaPlugin>::const_iterator iter;
+  for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
+    json->StartObject();
+    json->Add("name", iter->Name());
+    json->Add("id", iter->Id());
+    json->Add("active", iter->IsActive());
+    json->Add("enabled", iter->IsEnabled());
+    json->EndObject();
+  }
+  json->EndArray();
 
   // fire off the universe request now. the main server is running in a
   // separate thread.
@@ -844,16 +872,6 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
                         &OladHTTPServer::HandleUniverseList,
                         response,
                         json));
-
-  JsonArray *plugins_json = json->AddArray("plugins");
-  vector<OlaPlugin>::const_iterator iter;
-  for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-    JsonObject *plugin = plugins_json->AppendObject();
-    plugin->Add("name", iter->Name());
-    plugin->Add("id", iter->Id());
-    plugin->Add("active", iter->IsActive());
-    plugin->Add("enabled", iter->IsEnabled());
-  }
 }
 
 
@@ -865,28 +883,32 @@ void OladHTTPServer::HandlePluginList(HTTPResponse *response,
  * @param universes the vector of OlaUniverse
  */
 void OladHTTPServer::HandleUniverseList(HTTPResponse *response,
-                                        JsonObject *json,
+                                        JsonStreamWriter *json,
                                         const client::Result &result,
                                         const vector<OlaUniverse> &universes) {
   if (result.Success()) {
-    JsonArray *universe_json = json->AddArray("universes");
+    json->StartArray("universes");
 
     vector<OlaUniverse>::const_iterator iter;
     for (iter = universes.begin(); iter != universes.end(); ++iter) {
-      JsonObject *universe = universe_json->AppendObject();
-      universe->Add("id", iter->Id());
-      universe->Add("input_ports", iter->InputPortCount());
-      universe->Add("name", iter->Name());
-      universe->Add("output_ports", iter->OutputPortCount());
-      universe->Add("rdm_devices", iter->RDMDeviceCount());
+      json->StartObject();
+      json->Add("id", iter->Id());
+      json->Add("input_ports", iter->InputPortCount());
+      json->Add("name", iter->Name());
+      json->Add("output_ports", iter->OutputPortCount());
+      json->Add("rdm_devices", iter->RDMDeviceCount());
+      json->EndObject();
     }
+    json->EndArray();
   }
+  json->EndObject();
+  // flushes the remaining output to the response
+  delete json;
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(*json);
+  response->Send();
   delete response;
-  delete json;
 }
 
 
@@ -1181,16 +1203,20 @@ void OladHTTPServer::HandleGetDmx(HTTPResponse *response,
                                   const client::Result &result,
                                   const client::DMXMetadata &,
                                   const DmxBuffer &buffer) {
-  // rather than adding 512 JsonValue we cheat and use raw here
-  ostringstream str;
-  str << "[" << buffer.ToString() << "]";
-  JsonObject json;
-  json.AddRaw("dmx", str.str());
+  JsonStreamWriter json(response);
+  json.StartObject();
+  json.StartArray("dmx");
+  for (unsigned int i = 0; i < buffer.Size(); i++) {
+    json.UInt(buffer.Get(i));
+  }
+  json.EndArray();
   json.Add("error", result.Error());
+  json.EndObject();
+  json.Flush();
 
   response->SetNoCache();
   response->SetContentType(HTTPServer::CONTENT_TYPE_PLAIN);
-  response->SendJson(json);
+  response->Send();
   delete response;
 }
 
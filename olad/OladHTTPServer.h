@@ -31,7 +31,9 @@
 #include "ola/http/OlaHTTPServer.h"
 #include "ola/network/Interface.h"
 #include "ola/rdm/PidStore.h"
+#include "ola/web/JsonStreamWriter.h"
 #include "olad/RDMHTTPModule.h"
+#include "olad/StreamHTTPModule.h"
 
 namespace ola {
 
@@ -95,7 +97,7 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
                         const std::vector<client::OlaPlugin> &plugins);
 
   void HandleUniverseList(ola::http::HTTPResponse *response,
-                          ola::web::JsonObject *json,
+                          ola::web::JsonStreamWriter *json,
                           const client::Result &result,
                           const std::vector<client::OlaUniverse> &universes);
 
@@ -157,8 +159,11 @@ class OladHTTPServer: public ola::http::OlaHTTPServer {
   bool m_enable_quit;
   ola::network::Interface m_interface;
   RDMHTTPModule m_rdm_module;
+  StreamHTTPModule m_stream_module;
   time_t m_start_time_t;
 
+  void ServerStatsToJson(ola::web::JsonObject *json);
+
   void HandleGetDmx(ola::http::HTTPResponse *response,
                     const client::Result &result,
                     const client::DMXMetadata &metadata,
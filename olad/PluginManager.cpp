@@ -20,19 +20,103 @@
 
 #include "olad/PluginManager.h"
 
+#include <queue>
 #include <set>
 #include <vector>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/CallbackThread.h"
+#include "ola/thread/ExecutorInterface.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PluginLoader.h"
 
 namespace ola {
 
+using ola::thread::ConditionVariable;
+using ola::thread::ExecutorInterface;
+using ola::thread::MutexLocker;
+using ola::thread::Thread;
 using std::vector;
 using std::set;
 
+const char PluginManager::K_PLUGIN_START_TIME_VAR[] = "plugin-start-time-ms";
+
+namespace {
+/*
+ * Queues the callbacks from the plugin start threads, these are run on the
+ * thread that called LoadAll().
+ */
+class StartupExecutor : public ExecutorInterface {
+ public:
+  StartupExecutor() {}
+  ~StartupExecutor() { DrainCallbacks(); }
+
+  void Execute(BaseCallback0<void> *callback) {
+    {
+      MutexLocker locker(&m_mutex);
+      m_callbacks.push(callback);
+    }
+    m_condition.Signal();
+  }
+
+  void DrainCallbacks() {
+    while (true) {
+      BaseCallback0<void> *callback = NULL;
+      {
+        MutexLocker locker(&m_mutex);
+        if (m_callbacks.empty()) {
+          return;
+        }
+        callback = m_callbacks.front();
+        m_callbacks.pop();
+      }
+      callback->Run();
+    }
+  }
+
+  /*
+   * Block until there is at least one callback, then run all of them.
+   */
+  void WaitAndRun() {
+    {
+      MutexLocker locker(&m_mutex);
+      while (m_callbacks.empty()) {
+        m_condition.Wait(&m_mutex);
+      }
+    }
+    DrainCallbacks();
+  }
+
+ private:
+  ola::thread::Mutex m_mutex;
+  ConditionVariable m_condition;
+  std::queue<BaseCallback0<void>*> m_callbacks;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupExecutor);
+};
+
+/*
+ * Returns true if either plugin conflicts with the other.
+ */
+bool PluginsConflict(const AbstractPlugin *plugin1,
+                     const AbstractPlugin *plugin2) {
+  set<ola_plugin_id> conflict_list;
+  plugin1->ConflictsWith(&conflict_list);
+  if (STLContains(conflict_list, plugin2->Id())) {
+    return true;
+  }
+  conflict_list.clear();
+  plugin2->ConflictsWith(&conflict_list);
+  return STLContains(conflict_list, plugin1->Id());
+}
+}  // namespace
+
 PluginManager::PluginManager(const vector<PluginLoader*> &plugin_loaders,
                              class PluginAdaptor *plugin_adaptor)
     : m_plugin_loaders(plugin_loaders),
@@ -78,10 +162,9 @@ void PluginManager::LoadAll() {
   }
 
   // The second pass checks for conflicts and starts each plugin
-  PluginMap::iterator plugin_iter = m_enabled_plugins.begin();
-  for (; plugin_iter != m_enabled_plugins.end(); ++plugin_iter) {
-    StartIfSafe(plugin_iter->second);
-  }
+  vector<AbstractPlugin*> enabled_plugins;
+  STLValues(m_enabled_plugins, &enabled_plugins);
+  StartPlugins(enabled_plugins);
 }
 
 void PluginManager::UnloadAll() {
@@ -182,7 +265,115 @@ void PluginManager::GetConflictList(ola_plugin_id plugin_id,
   }
 }
 
+/*
+ * @brief Start a list of plugins, in order.
+ *
+ * Plugins that can start in parallel are started on a new thread, the rest
+ * are started on this thread. A plugin is held back while any plugin it
+ * conflicts with is earlier in the list or still starting.
+ */
+void PluginManager::StartPlugins(const vector<AbstractPlugin*> &plugins) {
+  StartupExecutor executor;
+  ThreadMap threads;
+  vector<AbstractPlugin*> pending(plugins);
+
+  while (!pending.empty() || !threads.empty()) {
+    vector<AbstractPlugin*>::iterator iter = pending.begin();
+    while (iter != pending.end()) {
+      AbstractPlugin *plugin = *iter;
+      bool blocked = false;
+      vector<AbstractPlugin*>::const_iterator earlier_iter = pending.begin();
+      for (; earlier_iter != iter && !blocked; ++earlier_iter) {
+        blocked = PluginsConflict(plugin, *earlier_iter);
+      }
+      ThreadMap::const_iterator thread_iter = threads.begin();
+      for (; thread_iter != threads.end() && !blocked; ++thread_iter) {
+        blocked = PluginsConflict(plugin, GetPlugin(thread_iter->first));
+      }
+      if (blocked) {
+        ++iter;
+        continue;
+      }
+
+      iter = pending.erase(iter);
+      if (!IsSafeToStart(plugin)) {
+        continue;
+      }
+      if (!(m_plugin_adaptor && plugin->CanStartInParallel() &&
+            StartInThread(&executor, &threads, plugin))) {
+        StartPlugin(plugin);
+      }
+    }
+
+    if (!threads.empty()) {
+      executor.WaitAndRun();
+    }
+  }
+}
+
+/*
+ * @brief Start a plugin on a new thread.
+ * @returns false if the thread couldn't be started.
+ */
+bool PluginManager::StartInThread(ExecutorInterface *executor,
+                                  ThreadMap *threads,
+                                  AbstractPlugin *plugin) {
+  OLA_INFO << "Trying to start " << plugin->Name() << " in parallel";
+  ola::thread::CallbackThread::VoidThreadCallback *callback =
+      NewSingleCallback(this, &PluginManager::RunStart, executor, threads,
+                        plugin);
+  Thread *thread = new ola::thread::CallbackThread(
+      callback, Thread::Options("plugin-start"));
+  // Add the thread first, since ThreadStartComplete() looks it up.
+  STLReplace(threads, plugin->Id(), thread);
+  if (!thread->FastStart()) {
+    OLA_WARN << "Failed to create a thread for " << plugin->Name();
+    threads->erase(plugin->Id());
+    delete thread;
+    delete callback;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * @brief Called in the plugin's thread to start it.
+ */
+void PluginManager::RunStart(ExecutorInterface *executor,
+                             ThreadMap *threads,
+                             AbstractPlugin *plugin) {
+  m_plugin_adaptor->ForwardCalls(Thread::Self(), executor);
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  bool ok = plugin->Start();
+  clock.CurrentTime(&end);
+  m_plugin_adaptor->ForwardCalls(Thread::Self(), NULL);
+
+  executor->Execute(
+      NewSingleCallback(this, &PluginManager::ThreadStartComplete, threads,
+                        plugin, ok,
+                        static_cast<unsigned int>(
+                            (end - start).InMilliSeconds())));
+}
+
+void PluginManager::ThreadStartComplete(ThreadMap *threads,
+                                        AbstractPlugin *plugin,
+                                        bool ok,
+                                        unsigned int start_time) {
+  Thread *thread = STLLookupAndRemovePtr(threads, plugin->Id());
+  if (thread) {
+    thread->Join();
+    delete thread;
+  }
+  PluginStarted(plugin, ok, start_time);
+}
+
 bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
+  return IsSafeToStart(plugin) && StartPlugin(plugin);
+}
+
+bool PluginManager::IsSafeToStart(const AbstractPlugin *plugin) const {
   AbstractPlugin *conflicting_plugin = CheckForRunningConflicts(plugin);
   if (conflicting_plugin) {
     OLA_WARN << "Not enabling " << plugin->Name()
@@ -191,16 +382,36 @@ bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
              << " which is already running";
     return false;
   }
+  return true;
+}
 
+bool PluginManager::StartPlugin(AbstractPlugin *plugin) {
   OLA_INFO << "Trying to start " << plugin->Name();
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
   bool ok = plugin->Start();
+  clock.CurrentTime(&end);
+  PluginStarted(plugin, ok,
+                static_cast<unsigned int>((end - start).InMilliSeconds()));
+  return ok;
+}
+
+void PluginManager::PluginStarted(AbstractPlugin *plugin, bool ok,
+                                  unsigned int start_time) {
   if (!ok) {
     OLA_WARN << "Failed to start " << plugin->Name();
   } else {
-    OLA_INFO << "Started " << plugin->Name();
+    OLA_INFO << "Started " << plugin->Name() << " in " << start_time << "ms";
     STLReplace(&m_active_plugins, plugin->Id(), plugin);
   }
-  return ok;
+
+  ExportMap *export_map =
+      m_plugin_adaptor ? m_plugin_adaptor->GetExportMap() : NULL;
+  if (export_map) {
+    (*export_map->GetUIntMapVar(K_PLUGIN_START_TIME_VAR, "plugin"))[
+        plugin->Name()] = start_time;
+  }
 }
 
 /*
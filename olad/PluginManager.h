@@ -29,6 +29,11 @@
 
 namespace ola {
 
+namespace thread {
+class ExecutorInterface;
+class Thread;
+}  // namespace thread
+
 class PluginLoader;
 class PluginAdaptor;
 class AbstractPlugin;
@@ -48,6 +53,16 @@ class AbstractPlugin;
  *
  * Plugins are active if they weren't disabled, there were no conflicts that
  * prevented them from loading, and the call to Start() was successfull.
+ *
+ * Plugins which return true from CanStartInParallel() are started on their
+ * own thread during LoadAll(). The calls they make through the PluginAdaptor
+ * are run on the calling thread, so the SelectServer, DeviceManager and
+ * PreferencesFactory are only ever used from one thread. A plugin isn't
+ * started until all the earlier plugins it conflicts with have finished
+ * starting, which means the result is the same as starting them in order.
+ *
+ * The time taken by each plugin's Start() method is recorded in the
+ * ExportMap.
  */
 class PluginManager {
  public:
@@ -142,8 +157,15 @@ class PluginManager {
   void GetConflictList(ola_plugin_id plugin_id,
                        std::vector<AbstractPlugin*> *plugins);
 
+  /**
+   * @brief The ExportMap variable holding the time in ms each plugin took to
+   *   start.
+   */
+  static const char K_PLUGIN_START_TIME_VAR[];
+
  private:
   typedef std::map<ola_plugin_id, AbstractPlugin*> PluginMap;
+  typedef std::map<ola_plugin_id, ola::thread::Thread*> ThreadMap;
 
   std::vector<PluginLoader*> m_plugin_loaders;
   PluginMap m_loaded_plugins;  // plugins that are loaded
@@ -151,7 +173,21 @@ class PluginManager {
   PluginMap m_enabled_plugins;  // enabled plugins
   PluginAdaptor *m_plugin_adaptor;
 
+  void StartPlugins(const std::vector<AbstractPlugin*> &plugins);
+  bool StartInThread(ola::thread::ExecutorInterface *executor,
+                     ThreadMap *threads,
+                     AbstractPlugin *plugin);
+  void RunStart(ola::thread::ExecutorInterface *executor,
+                ThreadMap *threads,
+                AbstractPlugin *plugin);
+  void ThreadStartComplete(ThreadMap *threads,
+                           AbstractPlugin *plugin,
+                           bool ok,
+                           unsigned int start_time);
   bool StartIfSafe(AbstractPlugin *plugin);
+  bool IsSafeToStart(const AbstractPlugin *plugin) const;
+  bool StartPlugin(AbstractPlugin *plugin);
+  void PluginStarted(AbstractPlugin *plugin, bool ok, unsigned int start_time);
   AbstractPlugin* CheckForRunningConflicts(const AbstractPlugin *plugin) const;
 
   DISALLOW_COPY_AND_ASSIGN(PluginManager);
@@ -29,12 +29,18 @@
 #include "olad/PluginManager.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/TestCommon.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
 
 
 using ola::AbstractPlugin;
 using ola::PluginLoader;
 using ola::PluginManager;
+using ola::thread::MutexLocker;
+using ola::thread::Thread;
 using std::set;
 using std::string;
 using std::vector;
@@ -44,11 +50,13 @@ class PluginManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PluginManagerTest);
   CPPUNIT_TEST(testPluginManager);
   CPPUNIT_TEST(testConflictingPlugins);
+  CPPUNIT_TEST(testParallelStart);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testPluginManager();
     void testConflictingPlugins();
+    void testParallelStart();
 
     void setUp() {
       ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -98,6 +106,107 @@ class MockLoader: public ola::PluginLoader {
 };
 
 
+/*
+ * Records the thread that preferences were created on.
+ */
+class ThreadCheckingPreferencesFactory: public ola::MemoryPreferencesFactory {
+ public:
+    ThreadCheckingPreferencesFactory()
+        : m_main_thread(Thread::Self()),
+          m_other_thread_calls(0) {
+    }
+
+    ola::Preferences *NewPreference(const string &name) {
+      if (!pthread_equal(m_main_thread, Thread::Self())) {
+        m_other_thread_calls++;
+      }
+      return MemoryPreferencesFactory::NewPreference(name);
+    }
+
+    unsigned int OtherThreadCalls() const { return m_other_thread_calls; }
+
+ private:
+    ola::thread::ThreadId m_main_thread;
+    unsigned int m_other_thread_calls;
+};
+
+
+/*
+ * Waits in Start() until the expected number of plugins are starting at the
+ * same time.
+ */
+class StartBarrier {
+ public:
+    explicit StartBarrier(unsigned int count)
+        : m_count(count),
+          m_waiting(0),
+          m_timed_out(false) {
+    }
+
+    void Wait() {
+      MutexLocker locker(&m_mutex);
+      m_waiting++;
+      m_condition.Broadcast();
+      ola::Clock clock;
+      ola::TimeStamp wake_up;
+      clock.CurrentTime(&wake_up);
+      wake_up += ola::TimeInterval(2, 0);
+      while (m_waiting < m_count) {
+        if (!m_condition.TimedWait(&m_mutex, wake_up)) {
+          m_timed_out = true;
+          return;
+        }
+      }
+    }
+
+    bool TimedOut() const { return m_timed_out; }
+
+ private:
+    const unsigned int m_count;
+    unsigned int m_waiting;
+    bool m_timed_out;
+    ola::thread::Mutex m_mutex;
+    ola::thread::ConditionVariable m_condition;
+};
+
+
+/*
+ * A plugin that can be started in parallel.
+ */
+class ParallelMockPlugin: public TestMockPlugin {
+ public:
+    ParallelMockPlugin(ola::PluginAdaptor *plugin_adaptor,
+                       ola::ola_plugin_id plugin_id,
+                       StartBarrier *barrier,
+                       bool start_ok = true)
+        : TestMockPlugin(plugin_adaptor, plugin_id),
+          m_barrier(barrier),
+          m_start_ok(start_ok),
+          m_main_thread(Thread::Self()),
+          m_started_on_main_thread(true) {
+    }
+
+    bool CanStartInParallel() const { return true; }
+
+    bool StartHook() {
+      m_started_on_main_thread = pthread_equal(m_main_thread, Thread::Self());
+      m_plugin_adaptor->NewPreference("parallel");
+      if (m_barrier) {
+        m_barrier->Wait();
+      }
+      return m_start_ok && TestMockPlugin::StartHook();
+    }
+
+    bool StartedOnMainThread() const { return m_started_on_main_thread; }
+
+ private:
+    StartBarrier *m_barrier;
+    bool m_start_ok;
+    ola::thread::ThreadId m_main_thread;
+    bool m_started_on_main_thread;
+};
+
+
 /*
  * Check that we can load & unload plugins correctly.
  */
@@ -181,3 +290,60 @@ void PluginManagerTest::testConflictingPlugins() {
   manager.UnloadAll();
   VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
 }
+
+
+/*
+ * Check that plugins can be started in parallel.
+ */
+void PluginManagerTest::testParallelStart() {
+  ThreadCheckingPreferencesFactory factory;
+  ola::ExportMap export_map;
+  ola::PluginAdaptor adaptor(NULL, NULL, &export_map, &factory, NULL, NULL);
+
+  // The first two plugins can only complete Start() if they're run at the
+  // same time.
+  StartBarrier barrier(2);
+  ParallelMockPlugin plugin1(&adaptor, ola::OLA_PLUGIN_ARTNET, &barrier);
+  ParallelMockPlugin plugin2(&adaptor, ola::OLA_PLUGIN_E131, &barrier);
+  // This fails to start, which means the conflicting plugin can start.
+  ParallelMockPlugin plugin3(&adaptor, ola::OLA_PLUGIN_ESPNET, NULL, false);
+  set<ola::ola_plugin_id> conflict_set;
+  conflict_set.insert(ola::OLA_PLUGIN_ESPNET);
+  TestMockPlugin plugin4(&adaptor, ola::OLA_PLUGIN_SANDNET, conflict_set);
+
+  vector<AbstractPlugin*> our_plugins;
+  our_plugins.push_back(&plugin1);
+  our_plugins.push_back(&plugin2);
+  our_plugins.push_back(&plugin3);
+  our_plugins.push_back(&plugin4);
+
+  MockLoader loader(our_plugins);
+  vector<PluginLoader*> loaders;
+  loaders.push_back(&loader);
+
+  PluginManager manager(loaders, &adaptor);
+  manager.LoadAll();
+
+  OLA_ASSERT_FALSE(barrier.TimedOut());
+  VerifyPluginCounts(&manager, 4, 3, OLA_SOURCELINE());
+  OLA_ASSERT_TRUE(plugin1.IsRunning());
+  OLA_ASSERT_TRUE(plugin2.IsRunning());
+  OLA_ASSERT_FALSE(plugin3.IsRunning());
+  OLA_ASSERT_TRUE(plugin4.IsRunning());
+  OLA_ASSERT_FALSE(plugin1.StartedOnMainThread());
+  OLA_ASSERT_FALSE(plugin2.StartedOnMainThread());
+
+  // The preferences were always created on this thread.
+  OLA_ASSERT_EQ(0u, factory.OtherThreadCalls());
+
+  const string start_times = export_map.GetUIntMapVar(
+      PluginManager::K_PLUGIN_START_TIME_VAR, "plugin")->Value();
+  for (vector<AbstractPlugin*>::const_iterator iter = our_plugins.begin();
+       iter != our_plugins.end(); ++iter) {
+    OLA_ASSERT_NE(string::npos,
+                  start_times.find(" " + (*iter)->Name() + ":"));
+  }
+
+  manager.UnloadAll();
+  VerifyPluginCounts(&manager, 0, 0, OLA_SOURCELINE());
+}
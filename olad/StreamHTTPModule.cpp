@@ -0,0 +1,465 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StreamHTTPModule.cpp
+ * Push DMX and server stats to HTTP clients with Server-Sent Events.
+ * Copyright (C) 2026 agent
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "ola/web/Json.h"
+#include "ola/web/JsonWriter.h"
+#include "olad/StreamHTTPModule.h"
+
+namespace ola {
+
+using ola::client::DMXMetadata;
+using ola::client::Result;
+using ola::http::HTTPEventStream;
+using ola::http::HTTPRequest;
+using ola::http::HTTPResponse;
+using ola::http::HTTPServer;
+using ola::web::JsonObject;
+using ola::web::JsonWriter;
+using std::string;
+using std::vector;
+
+const char StreamHTTPModule::DMX_EVENT[] = "dmx";
+const char StreamHTTPModule::DMX_DELTA_EVENT[] = "dmx_delta";
+const char StreamHTTPModule::STATS_EVENT[] = "server_stats";
+
+StreamHTTPModule::StreamHTTPModule(HTTPServer *http_server,
+                                   client::OlaClient *client,
+                                   StatsCallback *stats_callback)
+    : m_server(http_server),
+      m_client(client),
+      m_stats_callback(stats_callback),
+      m_stats_timeout(ola::thread::INVALID_TIMEOUT),
+      m_keepalive_timeout(ola::thread::INVALID_TIMEOUT) {
+  m_client->SetDMXCallback(NewCallback(this, &StreamHTTPModule::NewDmx));
+
+  m_server->RegisterHandler(
+      "/stream/dmx",
+      NewCallback(this, &StreamHTTPModule::StreamDmx));
+  m_server->RegisterHandler(
+      "/stream/server_stats",
+      NewCallback(this, &StreamHTTPModule::StreamServerStats));
+}
+
+
+/*
+ * The streams are owned by MHD, which outlives us, so detach from them.
+ */
+StreamHTTPModule::~StreamHTTPModule() {
+  StreamSet::iterator iter = m_streams.begin();
+  for (; iter != m_streams.end(); ++iter) {
+    (*iter)->SetCloseHandler(NULL);
+  }
+
+  ola::io::SelectServer *ss = m_server->SelectServer();
+  UniverseMap::iterator universe_iter = m_universes.begin();
+  for (; universe_iter != m_universes.end(); ++universe_iter) {
+    ss->RemoveTimeout(universe_iter->second->flush_timeout);
+  }
+  ss->RemoveTimeout(m_stats_timeout);
+  ss->RemoveTimeout(m_keepalive_timeout);
+
+  STLDeleteValues(&m_universes);
+  m_client->SetDMXCallback(NULL);
+  delete m_stats_callback;
+}
+
+
+/**
+ * @brief Stream the DMX data for one or more universes.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int StreamHTTPModule::StreamDmx(const HTTPRequest *request,
+                                HTTPResponse *response) {
+  vector<string> tokens;
+  StringSplit(request->GetParameter("u"), &tokens, ",");
+  vector<unsigned int> universes;
+  vector<string>::const_iterator token_iter = tokens.begin();
+  for (; token_iter != tokens.end(); ++token_iter) {
+    unsigned int universe_id;
+    if (!StringToInt(*token_iter, &universe_id)) {
+      return m_server->ServeError(response, "Invalid universe list");
+    }
+    universes.push_back(universe_id);
+  }
+  if (universes.empty()) {
+    return m_server->ServeError(response, "?u=[universe],[universe],...");
+  }
+
+  HTTPEventStream *stream = NewStream(response);
+  if (!stream) {
+    return MHD_NO;
+  }
+
+  vector<unsigned int>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    WatchUniverse(*iter, stream);
+  }
+  return MHD_YES;
+}
+
+
+/**
+ * @brief Stream the server stats.
+ * @param request the HTTPRequest
+ * @param response the HTTPResponse
+ * @returns MHD_NO or MHD_YES
+ */
+int StreamHTTPModule::StreamServerStats(const HTTPRequest*,
+                                        HTTPResponse *response) {
+  HTTPEventStream *stream = NewStream(response);
+  if (!stream) {
+    return MHD_NO;
+  }
+
+  if (m_stats_streams.empty()) {
+    UpdateStats();
+    m_stats_timeout = m_server->SelectServer()->RegisterRepeatingTimeout(
+        K_STATS_INTERVAL_MS,
+        NewCallback(this, &StreamHTTPModule::StatsTimeout));
+  }
+  m_stats_streams.insert(stream);
+  stream->SendEvent(STATS_EVENT, m_stats);
+  return MHD_YES;
+}
+
+
+/*
+ * Start a new event stream. This deletes the response.
+ * @returns the new stream, or NULL if it couldn't be sent.
+ */
+HTTPEventStream *StreamHTTPModule::NewStream(HTTPResponse *response) {
+  HTTPEventStream *stream = new HTTPEventStream();
+  AddStream(stream);
+
+  // if this fails, the stream has already been deleted
+  int ret = response->SendEventStream(stream);
+  delete response;
+  if (ret == MHD_NO) {
+    return NULL;
+  }
+  return stream;
+}
+
+
+/*
+ * Track a stream until it's closed.
+ */
+void StreamHTTPModule::AddStream(HTTPEventStream *stream) {
+  m_streams.insert(stream);
+  stream->SetCloseHandler(
+      NewSingleCallback(this, &StreamHTTPModule::StreamClosed, stream));
+
+  if (m_keepalive_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_keepalive_timeout = m_server->SelectServer()->RegisterRepeatingTimeout(
+        K_KEEPALIVE_INTERVAL_MS,
+        NewCallback(this, &StreamHTTPModule::SendKeepalive));
+  }
+}
+
+
+/*
+ * Called when the client disconnects.
+ */
+void StreamHTTPModule::StreamClosed(HTTPEventStream *stream) {
+  ola::io::SelectServer *ss = m_server->SelectServer();
+  m_streams.erase(stream);
+
+  if (m_stats_streams.erase(stream) && m_stats_streams.empty()) {
+    ss->RemoveTimeout(m_stats_timeout);
+    m_stats_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  UniverseMap::iterator iter = m_universes.begin();
+  while (iter != m_universes.end()) {
+    UniverseState *state = iter->second;
+    state->streams.erase(stream);
+    state->needs_full_frame.erase(stream);
+    if (state->streams.empty()) {
+      ss->RemoveTimeout(state->flush_timeout);
+      m_client->RegisterUniverse(state->universe_id, client::UNREGISTER, NULL);
+      delete state;
+      m_universes.erase(iter++);
+    } else {
+      ++iter;
+    }
+  }
+
+  if (m_streams.empty()) {
+    ss->RemoveTimeout(m_keepalive_timeout);
+    m_keepalive_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+}
+
+
+/*
+ * Add a stream to a universe, registering for the universe if this is the
+ * first stream.
+ */
+void StreamHTTPModule::WatchUniverse(unsigned int universe_id,
+                                     HTTPEventStream *stream) {
+  UniverseMap::iterator iter = STLLookupOrInsertNull(&m_universes,
+                                                     universe_id);
+  if (!iter->second) {
+    iter->second = new UniverseState(universe_id);
+    m_client->RegisterUniverse(universe_id, client::REGISTER, NULL);
+    // We only receive data once it changes, so fetch the current frame.
+    m_client->FetchDMX(
+        universe_id,
+        NewSingleCallback(this, &StreamHTTPModule::InitialDmx, universe_id));
+  }
+
+  UniverseState *state = iter->second;
+  state->streams.insert(stream);
+  // Deltas are relative to the last frame sent, so start from that.
+  if (!state->have_sent ||
+      !stream->SendEvent(DMX_EVENT, FullFrameEvent(universe_id,
+                                                   state->last_sent))) {
+    state->needs_full_frame.insert(stream);
+  }
+}
+
+
+void StreamHTTPModule::NewDmx(const DMXMetadata &metadata,
+                              const DmxBuffer &data) {
+  UniverseState *state = STLFindOrNull(m_universes, metadata.universe);
+  if (!state) {
+    return;
+  }
+  state->latest = data;
+  state->have_latest = true;
+  ScheduleFlush(state);
+}
+
+
+void StreamHTTPModule::InitialDmx(unsigned int universe_id,
+                                  const Result &result,
+                                  const DMXMetadata&,
+                                  const DmxBuffer &data) {
+  UniverseState *state = STLFindOrNull(m_universes, universe_id);
+  if (!state) {
+    return;
+  }
+
+  if (!result.Success()) {
+    OLA_INFO << "Failed to fetch DMX for universe " << universe_id << ": "
+             << result.Error();
+    return;
+  }
+
+  // don't replace a newer frame
+  if (!state->have_latest) {
+    state->latest = data;
+    state->have_latest = true;
+    ScheduleFlush(state);
+  }
+}
+
+
+/*
+ * Flush now, or if a flush happened recently, once K_DMX_INTERVAL_MS has
+ * passed. Frames that arrive in the meantime replace each other.
+ */
+void StreamHTTPModule::ScheduleFlush(UniverseState *state) {
+  if (state->flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+
+  ola::io::SelectServer *ss = m_server->SelectServer();
+  TimeInterval elapsed = *ss->WakeUpTime() - state->last_flush;
+  int64_t elapsed_ms = elapsed.InMilliSeconds();
+  if (elapsed_ms >= static_cast<int64_t>(K_DMX_INTERVAL_MS)) {
+    Flush(state);
+  } else {
+    state->flush_timeout = ss->RegisterSingleTimeout(
+        K_DMX_INTERVAL_MS - static_cast<unsigned int>(elapsed_ms),
+        NewSingleCallback(this, &StreamHTTPModule::FlushTimeout,
+                          state->universe_id));
+  }
+}
+
+
+void StreamHTTPModule::FlushTimeout(unsigned int universe_id) {
+  UniverseState *state = STLFindOrNull(m_universes, universe_id);
+  if (state) {
+    state->flush_timeout = ola::thread::INVALID_TIMEOUT;
+    Flush(state);
+  }
+}
+
+
+/*
+ * Send the latest frame to each stream. The events are built once and shared
+ * by all streams.
+ */
+void StreamHTTPModule::Flush(UniverseState *state) {
+  if (!state->have_latest) {
+    return;
+  }
+
+  const string full_frame = FullFrameEvent(state->universe_id, state->latest);
+  string delta;
+  bool send_full_frame = (!state->have_sent ||
+                          state->latest.Size() != state->last_sent.Size());
+  if (!send_full_frame) {
+    delta = DeltaEvent(*state);
+    send_full_frame = delta.size() >= full_frame.size();
+  }
+
+  StreamSet::iterator iter = state->streams.begin();
+  for (; iter != state->streams.end(); ++iter) {
+    HTTPEventStream *stream = *iter;
+    if (send_full_frame || STLContains(state->needs_full_frame, stream)) {
+      if (stream->SendEvent(DMX_EVENT, full_frame)) {
+        state->needs_full_frame.erase(stream);
+      }
+    } else if (!delta.empty() && !stream->SendEvent(DMX_DELTA_EVENT, delta)) {
+      // the client has missed a delta, so it needs a full frame next time
+      state->needs_full_frame.insert(stream);
+    }
+  }
+
+  state->last_sent = state->latest;
+  state->have_sent = true;
+  state->last_flush = *m_server->SelectServer()->WakeUpTime();
+}
+
+
+/*
+ * Rebuild the stats.
+ * @returns true if they've changed.
+ */
+bool StreamHTTPModule::UpdateStats() {
+  JsonObject json;
+  m_stats_callback->Run(&json);
+  json.Add("streams", static_cast<unsigned int>(m_streams.size()));
+  json.Add("streamed_universes",
+           static_cast<unsigned int>(m_universes.size()));
+
+  const string stats = JsonWriter::AsString(json);
+  if (stats == m_stats) {
+    return false;
+  }
+  m_stats = stats;
+  return true;
+}
+
+
+bool StreamHTTPModule::StatsTimeout() {
+  if (UpdateStats()) {
+    StreamSet::iterator iter = m_stats_streams.begin();
+    for (; iter != m_stats_streams.end(); ++iter) {
+      (*iter)->SendEvent(STATS_EVENT, m_stats);
+    }
+  }
+  return true;
+}
+
+
+/*
+ * Proxies drop idle connections, and we need to write to notice when a
+ * client has gone away.
+ */
+bool StreamHTTPModule::SendKeepalive() {
+  StreamSet::iterator iter = m_streams.begin();
+  for (; iter != m_streams.end(); ++iter) {
+    (*iter)->SendComment("keepalive");
+  }
+  return true;
+}
+
+
+void StreamHTTPModule::AppendHex(const uint8_t *data, unsigned int length,
+                                 string *output) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+  for (unsigned int i = 0; i < length; i++) {
+    output->push_back(HEX_DIGITS[data[i] >> 4]);
+    output->push_back(HEX_DIGITS[data[i] & 0x0f]);
+  }
+}
+
+
+string StreamHTTPModule::FullFrameEvent(unsigned int universe_id,
+                                        const DmxBuffer &buffer) {
+  string output;
+  output.reserve(buffer.Size() * 2 + 32);
+  output.append("{\"universe\": ");
+  output.append(strings::IntToString(universe_id));
+  output.append(", \"dmx\": \"");
+  AppendHex(buffer.GetRaw(), buffer.Size(), &output);
+  output.append("\"}");
+  return output;
+}
+
+
+/*
+ * Build a delta from last_sent to latest, which must be the same size.
+ * @returns the event data, or the empty string if nothing has changed.
+ */
+string StreamHTTPModule::DeltaEvent(const UniverseState &state) {
+  const uint8_t *old_data = state.last_sent.GetRaw();
+  const uint8_t *new_data = state.latest.GetRaw();
+  const unsigned int size = state.latest.Size();
+
+  string changes;
+  unsigned int i = 0;
+  while (i < size) {
+    if (old_data[i] == new_data[i]) {
+      i++;
+      continue;
+    }
+
+    // extend the change until we see K_MIN_GAP unchanged slots
+    unsigned int end = i + 1;
+    for (unsigned int j = end; j < size && j - end < K_MIN_GAP; j++) {
+      if (old_data[j] != new_data[j]) {
+        end = j + 1;
+      }
+    }
+
+    if (!changes.empty()) {
+      changes.append(", ");
+    }
+    changes.append("[");
+    changes.append(strings::IntToString(i));
+    changes.append(", \"");
+    AppendHex(new_data + i, end - i, &changes);
+    changes.append("\"]");
+    i = end;
+  }
+
+  if (changes.empty()) {
+    return changes;
+  }
+  return "{\"universe\": " + strings::IntToString(state.universe_id) +
+         ", \"changes\": [" + changes + "]}";
+}
+}  // namespace ola
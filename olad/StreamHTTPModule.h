@@ -0,0 +1,156 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StreamHTTPModule.h
+ * Push DMX and server stats to HTTP clients with Server-Sent Events.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef OLAD_STREAMHTTPMODULE_H_
+#define OLAD_STREAMHTTPMODULE_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/web/Json.h"
+
+class StreamHTTPModuleTest;
+
+namespace ola {
+
+/*
+ * The module that streams live data to HTTP clients.
+ *
+ * Rather than each browser polling /get_dmx, a client opens
+ * /stream/dmx?u=1,2 and receives events as the data changes. The module
+ * registers for each universe once, no matter how many streams are watching
+ * it, and sends at most one update per universe every K_DMX_INTERVAL_MS.
+ *
+ * The first event for a universe is a full frame, the following events only
+ * contain the slots that changed:
+ *   event: dmx
+ *   data: {"universe": 1, "dmx": "00ff..."}
+ *
+ *   event: dmx_delta
+ *   data: {"universe": 1, "changes": [[10, "ff00"], [100, "7f"]]}
+ * where each change is the first slot and the new values as hex.
+ */
+class StreamHTTPModule {
+ public:
+    typedef ola::Callback1<void, ola::web::JsonObject*> StatsCallback;
+
+    /**
+     * @param http_server the HTTPServer to register the handlers with.
+     * @param client the OlaClient to use, must be running in the HTTP server
+     *   thread.
+     * @param stats_callback populates the server stats, ownership is
+     *   transferred.
+     */
+    StreamHTTPModule(ola::http::HTTPServer *http_server,
+                     ola::client::OlaClient *client,
+                     StatsCallback *stats_callback);
+    ~StreamHTTPModule();
+
+    int StreamDmx(const ola::http::HTTPRequest *request,
+                  ola::http::HTTPResponse *response);
+    int StreamServerStats(const ola::http::HTTPRequest *request,
+                          ola::http::HTTPResponse *response);
+
+ private:
+    typedef std::set<ola::http::HTTPEventStream*> StreamSet;
+
+    struct UniverseState {
+     public:
+      explicit UniverseState(unsigned int universe_id)
+          : universe_id(universe_id),
+            have_latest(false),
+            have_sent(false),
+            flush_timeout(ola::thread::INVALID_TIMEOUT) {
+      }
+
+      unsigned int universe_id;
+      StreamSet streams;
+      // streams that need a full frame, rather than a delta
+      StreamSet needs_full_frame;
+      bool have_latest;
+      bool have_sent;
+      DmxBuffer latest;
+      DmxBuffer last_sent;
+      TimeStamp last_flush;
+      ola::thread::timeout_id flush_timeout;
+    };
+
+    typedef std::map<unsigned int, UniverseState*> UniverseMap;
+
+    ola::http::HTTPServer *m_server;
+    ola::client::OlaClient *m_client;
+    StatsCallback *m_stats_callback;
+    UniverseMap m_universes;
+    StreamSet m_stats_streams;
+    StreamSet m_streams;
+    std::string m_stats;
+    ola::thread::timeout_id m_stats_timeout;
+    ola::thread::timeout_id m_keepalive_timeout;
+
+    ola::http::HTTPEventStream *NewStream(ola::http::HTTPResponse *response);
+    void AddStream(ola::http::HTTPEventStream *stream);
+    void StreamClosed(ola::http::HTTPEventStream *stream);
+
+    void WatchUniverse(unsigned int universe_id,
+                       ola::http::HTTPEventStream *stream);
+    void NewDmx(const ola::client::DMXMetadata &metadata,
+                const DmxBuffer &data);
+    void InitialDmx(unsigned int universe_id,
+                    const ola::client::Result &result,
+                    const ola::client::DMXMetadata &metadata,
+                    const DmxBuffer &data);
+    void ScheduleFlush(UniverseState *state);
+    void FlushTimeout(unsigned int universe_id);
+    void Flush(UniverseState *state);
+
+    bool UpdateStats();
+    bool StatsTimeout();
+    bool SendKeepalive();
+
+    static void AppendHex(const uint8_t *data, unsigned int length,
+                          std::string *output);
+    static std::string FullFrameEvent(unsigned int universe_id,
+                                      const DmxBuffer &buffer);
+    static std::string DeltaEvent(const UniverseState &state);
+
+    static const char DMX_EVENT[];
+    static const char DMX_DELTA_EVENT[];
+    static const char STATS_EVENT[];
+    // The minimum time between updates for a universe.
+    static const unsigned int K_DMX_INTERVAL_MS = 100;
+    static const unsigned int K_STATS_INTERVAL_MS = 5000;
+    static const unsigned int K_KEEPALIVE_INTERVAL_MS = 15000;
+    // Unchanged runs shorter than this are included in a delta rather than
+    // starting a new change.
+    static const unsigned int K_MIN_GAP = 4;
+
+    friend class ::StreamHTTPModuleTest;
+
+    DISALLOW_COPY_AND_ASSIGN(StreamHTTPModule);
+};
+}  // namespace ola
+#endif  // OLAD_STREAMHTTPMODULE_H_
@@ -0,0 +1,328 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * StreamHTTPModuleTest.cpp
+ * Test fixture for the StreamHTTPModule class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/client/OlaClient.h"
+#include "ola/http/HTTPServer.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/web/Json.h"
+#include "olad/StreamHTTPModule.h"
+
+using ola::DmxBuffer;
+using ola::NewCallback;
+using ola::StreamHTTPModule;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::client::DMXMetadata;
+using ola::client::OlaClient;
+using ola::http::HTTPEventStream;
+using ola::http::HTTPServer;
+using ola::io::LoopbackDescriptor;
+using ola::io::SelectServer;
+using ola::web::JsonObject;
+using std::auto_ptr;
+using std::string;
+
+class StreamHTTPModuleTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(StreamHTTPModuleTest);
+  CPPUNIT_TEST(testFullFrameEvent);
+  CPPUNIT_TEST(testDeltaEvent);
+  CPPUNIT_TEST(testStreamDmx);
+  CPPUNIT_TEST(testMissedDelta);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testFullFrameEvent();
+  void testDeltaEvent();
+  void testStreamDmx();
+  void testMissedDelta();
+
+ private:
+  auto_ptr<HTTPServer> m_server;
+  auto_ptr<LoopbackDescriptor> m_descriptor;
+  auto_ptr<OlaClient> m_client;
+  auto_ptr<StreamHTTPModule> m_module;
+
+  void PopulateStats(JsonObject*) {}
+
+  HTTPEventStream *NewStream(unsigned int universe);
+  void NewDmx(unsigned int universe, const DmxBuffer &buffer);
+  void WaitForData(HTTPEventStream *stream);
+  string ReadAll(HTTPEventStream *stream);
+  bool Watching(unsigned int universe);
+
+  static string Event(const string &event, const string &data);
+  static DmxBuffer Frame(unsigned int changed_slot, uint8_t value);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StreamHTTPModuleTest);
+
+
+/*
+ * The client is never connected, so it fails each RPC straight away, which
+ * means the module only ever sees the frames we pass to NewDmx().
+ */
+void StreamHTTPModuleTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  HTTPServer::HTTPServerOptions options;
+  m_server.reset(new HTTPServer(options));
+  m_descriptor.reset(new LoopbackDescriptor());
+  m_client.reset(new OlaClient(m_descriptor.get()));
+  m_module.reset(new StreamHTTPModule(
+      m_server.get(), m_client.get(),
+      NewCallback(this, &StreamHTTPModuleTest::PopulateStats)));
+
+  // Set the select server's wake up time, which the module uses as now.
+  m_server->SelectServer()->RunOnce(TimeInterval(0, 0));
+}
+
+
+void StreamHTTPModuleTest::tearDown() {
+  m_module.reset();
+  m_client.reset();
+  m_descriptor.reset();
+  m_server.reset();
+}
+
+
+/*
+ * Check the full frame encoding.
+ */
+void StreamHTTPModuleTest::testFullFrameEvent() {
+  const uint8_t data[] = {0, 255, 16, 1, 0xab};
+  OLA_ASSERT_EQ(
+      string("{\"universe\": 1, \"dmx\": \"00ff1001ab\"}"),
+      StreamHTTPModule::FullFrameEvent(1, DmxBuffer(data, sizeof(data))));
+  OLA_ASSERT_EQ(string("{\"universe\": 65535, \"dmx\": \"\"}"),
+                StreamHTTPModule::FullFrameEvent(65535, DmxBuffer()));
+}
+
+
+/*
+ * Check the delta encoding, and that nearby changes are merged.
+ */
+void StreamHTTPModuleTest::testDeltaEvent() {
+  StreamHTTPModule::UniverseState state(2);
+  const uint8_t old_data[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  state.last_sent.Set(old_data, sizeof(old_data));
+  state.latest = state.last_sent;
+  OLA_ASSERT_EQ(string(""), StreamHTTPModule::DeltaEvent(state));
+
+  // a single slot
+  state.latest.SetChannel(11, 0xff);
+  OLA_ASSERT_EQ(string("{\"universe\": 2, \"changes\": [[11, \"ff\"]]}"),
+                StreamHTTPModule::DeltaEvent(state));
+
+  // fewer than K_MIN_GAP unchanged slots between changes are merged
+  const uint8_t merged[] = {1, 0, 0, 0, 2, 0, 0, 0, 0, 3, 4, 0};
+  state.latest.Set(merged, sizeof(merged));
+  OLA_ASSERT_EQ(
+      string("{\"universe\": 2, \"changes\": "
+             "[[0, \"0100000002\"], [9, \"0304\"]]}"),
+      StreamHTTPModule::DeltaEvent(state));
+
+  // the delta is relative to the last frame sent
+  state.last_sent.Set(merged, sizeof(merged));
+  state.latest.SetChannel(4, 0x7f);
+  OLA_ASSERT_EQ(string("{\"universe\": 2, \"changes\": [[4, \"7f\"]]}"),
+                StreamHTTPModule::DeltaEvent(state));
+}
+
+
+/*
+ * Check frames are sent to every stream watching a universe, with at most
+ * one update every K_DMX_INTERVAL_MS.
+ */
+void StreamHTTPModuleTest::testStreamDmx() {
+  SelectServer *ss = m_server->SelectServer();
+  HTTPEventStream *stream1 = NewStream(1);
+  OLA_ASSERT_TRUE(Watching(1));
+  OLA_ASSERT_EQ(0u, stream1->BufferedBytes());
+
+  // the first frame is sent straight away, as a full frame
+  const DmxBuffer frame1 = Frame(0, 0);
+  NewDmx(1, frame1);
+  OLA_ASSERT_EQ(
+      Event("dmx", StreamHTTPModule::FullFrameEvent(1, frame1)),
+      ReadAll(stream1));
+  const TimeStamp first_flush = *ss->WakeUpTime();
+
+  // frames within K_DMX_INTERVAL_MS are held back, and only the latest is
+  // sent
+  NewDmx(1, Frame(5, 0x10));
+  NewDmx(1, Frame(5, 0x20));
+  const DmxBuffer frame2 = Frame(6, 0x30);
+  NewDmx(1, frame2);
+  NewDmx(2, Frame(1, 1));
+  OLA_ASSERT_EQ(0u, stream1->BufferedBytes());
+  ss->RunOnce(TimeInterval(0, 0));
+  OLA_ASSERT_EQ(0u, stream1->BufferedBytes());
+
+  WaitForData(stream1);
+  OLA_ASSERT_TRUE(
+      (*ss->WakeUpTime() - first_flush).InMilliSeconds() >=
+      StreamHTTPModule::K_DMX_INTERVAL_MS);
+  OLA_ASSERT_EQ(
+      Event("dmx_delta", "{\"universe\": 1, \"changes\": [[6, \"30\"]]}"),
+      ReadAll(stream1));
+
+  // a new stream gets the last frame sent straight away, then shares the
+  // deltas
+  HTTPEventStream *stream2 = NewStream(1);
+  OLA_ASSERT_EQ(
+      Event("dmx", StreamHTTPModule::FullFrameEvent(1, frame2)),
+      ReadAll(stream2));
+
+  NewDmx(1, Frame(1, 0x40));
+  WaitForData(stream1);
+  const string delta = Event(
+      "dmx_delta", "{\"universe\": 1, \"changes\": [[1, \"40\"], [6, \"00\"]]}");
+  OLA_ASSERT_EQ(delta, ReadAll(stream1));
+  OLA_ASSERT_EQ(delta, ReadAll(stream2));
+
+  // a frame of a different size is sent in full
+  const uint8_t short_data[] = {1, 2};
+  const DmxBuffer short_frame(short_data, sizeof(short_data));
+  NewDmx(1, short_frame);
+  WaitForData(stream1);
+  OLA_ASSERT_EQ(
+      Event("dmx", StreamHTTPModule::FullFrameEvent(1, short_frame)),
+      ReadAll(stream1));
+
+  // the universe is kept until the last stream watching it closes
+  delete stream1;
+  OLA_ASSERT_TRUE(Watching(1));
+  delete stream2;
+  OLA_ASSERT_FALSE(Watching(1));
+  OLA_ASSERT_TRUE(m_module->m_streams.empty());
+}
+
+
+/*
+ * Check a stream that misses a delta is sent a full frame next time.
+ */
+void StreamHTTPModuleTest::testMissedDelta() {
+  HTTPEventStream *stream1 = NewStream(1);
+  HTTPEventStream *stream2 = NewStream(1);
+
+  NewDmx(1, Frame(0, 0));
+  ReadAll(stream1);
+  ReadAll(stream2);
+
+  // fill stream2's buffer so the next delta is dropped
+  OLA_ASSERT_TRUE(stream2->SendComment(
+      string(HTTPEventStream::K_DEFAULT_MAX_BUFFER_SIZE - 8, 'x')));
+  NewDmx(1, Frame(3, 0x30));
+  WaitForData(stream1);
+  const string delta = Event(
+      "dmx_delta", "{\"universe\": 1, \"changes\": [[3, \"30\"]]}");
+  OLA_ASSERT_EQ(delta, ReadAll(stream1));
+  OLA_ASSERT_TRUE(
+      m_module->m_universes[1]->needs_full_frame.count(stream2));
+  ReadAll(stream2);
+
+  const DmxBuffer frame = Frame(3, 0x31);
+  NewDmx(1, frame);
+  WaitForData(stream1);
+  OLA_ASSERT_EQ(
+      Event("dmx_delta", "{\"universe\": 1, \"changes\": [[3, \"31\"]]}"),
+      ReadAll(stream1));
+  OLA_ASSERT_EQ(
+      Event("dmx", StreamHTTPModule::FullFrameEvent(1, frame)),
+      ReadAll(stream2));
+  OLA_ASSERT_TRUE(m_module->m_universes[1]->needs_full_frame.empty());
+
+  delete stream1;
+  delete stream2;
+}
+
+
+/*
+ * Create a stream, as StreamDmx() would, and watch a universe.
+ */
+HTTPEventStream *StreamHTTPModuleTest::NewStream(unsigned int universe) {
+  HTTPEventStream *stream = new HTTPEventStream();
+  m_module->AddStream(stream);
+  m_module->WatchUniverse(universe, stream);
+  return stream;
+}
+
+
+void StreamHTTPModuleTest::NewDmx(unsigned int universe,
+                                  const DmxBuffer &buffer) {
+  m_module->NewDmx(DMXMetadata(universe), buffer);
+}
+
+
+/*
+ * Run the select server until there's data for the stream.
+ */
+void StreamHTTPModuleTest::WaitForData(HTTPEventStream *stream) {
+  for (unsigned int i = 0; i < 100 && !stream->BufferedBytes(); i++) {
+    m_server->SelectServer()->RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT_TRUE(stream->BufferedBytes());
+}
+
+
+string StreamHTTPModuleTest::ReadAll(HTTPEventStream *stream) {
+  string output;
+  char buffer[1024];
+  size_t size;
+  while ((size = stream->Read(buffer, sizeof(buffer)))) {
+    output.append(buffer, size);
+  }
+  return output;
+}
+
+
+bool StreamHTTPModuleTest::Watching(unsigned int universe) {
+  return m_module->m_universes.find(universe) != m_module->m_universes.end();
+}
+
+
+string StreamHTTPModuleTest::Event(const string &event, const string &data) {
+  return "event: " + event + "\ndata: " + data + "\n\n";
+}
+
+
+/*
+ * A 32 slot frame, which is large enough that a small delta is shorter than
+ * the full frame.
+ */
+DmxBuffer StreamHTTPModuleTest::Frame(unsigned int changed_slot,
+                                      uint8_t value) {
+  DmxBuffer buffer;
+  buffer.SetRangeToValue(0, 0, 32);
+  buffer.SetChannel(changed_slot, value);
+  return buffer;
+}
@@ -24,18 +24,24 @@
 #include <stdio.h>
 #include <errno.h>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Port.h"
 #include "olad/plugin_api/PortManager.h"
 
 namespace ola {
 
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
 using std::map;
 using std::set;
 using std::string;
@@ -45,6 +51,7 @@ const unsigned int DeviceManager::MISSING_DEVICE_ALIAS = 0;
 const char DeviceManager::PORT_PREFERENCES[] = "port";
 const char DeviceManager::PRIORITY_VALUE_SUFFIX[] = "_priority_value";
 const char DeviceManager::PRIORITY_MODE_SUFFIX[] = "_priority_mode";
+const char DeviceManager::UIDS_SUFFIX[] = "_uids";
 
 bool operator <(const device_alias_pair& left,
                 const device_alias_pair &right) {
@@ -111,6 +118,9 @@ bool DeviceManager::RegisterDevice(AbstractDevice *device) {
 
   vector<OutputPort*> output_ports;
   device->OutputPorts(&output_ports);
+  // This needs to happen before the ports are patched, since patching
+  // triggers discovery.
+  RestorePortUIDs(output_ports);
   RestorePortSettings(output_ports);
 
   // look for timecode ports and add them to the set
@@ -204,6 +214,37 @@ void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
     return;
   }
 
+  SaveDevicePortSettings(device);
+
+  vector<OutputPort*> output_ports;
+  device->OutputPorts(&output_ports);
+  vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
+  for (; output_iter != output_ports.end(); ++output_iter) {
+    // remove from the timecode port set
+    STLRemove(&m_timecode_ports, *output_iter);
+  }
+}
+
+
+void DeviceManager::SaveDeviceSettings(
+    const vector<const AbstractDevice*> &devices) {
+  if (!m_port_preferences || devices.empty()) {
+    return;
+  }
+
+  vector<const AbstractDevice*>::const_iterator iter = devices.begin();
+  for (; iter != devices.end(); ++iter) {
+    SaveDevicePortSettings(*iter);
+  }
+  m_port_preferences->Save();
+}
+
+
+/*
+ * Write the patchings, priorities and UIDs for a device's ports to the
+ * preferences.
+ */
+void DeviceManager::SaveDevicePortSettings(const AbstractDevice *device) {
   vector<InputPort*> input_ports;
   vector<OutputPort*> output_ports;
   device->InputPorts(&input_ports);
@@ -219,9 +260,7 @@ void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
     SavePortPriority(**output_iter);
-
-    // remove from the timecode port set
-    STLRemove(&m_timecode_ports, *output_iter);
+    SavePortUIDs(**output_iter);
   }
 }
 
@@ -310,6 +349,69 @@ void DeviceManager::RestorePortPriority(Port *port) const {
 }
 
 
+/*
+ * Save the UIDs discovered on a port, so discovery can start from them the
+ * next time the port is registered.
+ */
+void DeviceManager::SavePortUIDs(const OutputPort &port) const {
+  if (!port.SupportsRDM()) {
+    return;
+  }
+
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  UIDSet uids;
+  if (port.GetUniverse()) {
+    port.GetUniverse()->GetUIDs(&port, &uids);
+  }
+
+  if (uids.Empty()) {
+    m_port_preferences->RemoveValue(port_id + UIDS_SUFFIX);
+  } else {
+    m_port_preferences->SetValue(port_id + UIDS_SUFFIX, uids.ToString());
+  }
+}
+
+
+/*
+ * Pass the UIDs saved for each port back to the port.
+ */
+void DeviceManager::RestorePortUIDs(const vector<OutputPort*> &ports) const {
+  if (!m_port_preferences) {
+    return;
+  }
+
+  vector<OutputPort*>::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    OutputPort *port = *iter;
+    string port_id = port->UniqueId();
+    if (port_id.empty() || !port->SupportsRDM()) {
+      continue;
+    }
+
+    vector<string> tokens;
+    StringSplit(m_port_preferences->GetValue(port_id + UIDS_SUFFIX), &tokens,
+                ",");
+    UIDSet uids;
+    vector<string>::const_iterator token_iter = tokens.begin();
+    for (; token_iter != tokens.end(); ++token_iter) {
+      auto_ptr<UID> uid(UID::FromString(*token_iter));
+      if (uid.get()) {
+        uids.AddUID(*uid);
+      }
+    }
+
+    if (!uids.Empty()) {
+      OLA_INFO << "Restored " << uids.Size() << " UIDs for port " << port_id;
+      port->SetKnownUIDs(uids);
+    }
+  }
+}
+
+
 /*
  * Restore the patching information for a port.
  */
@@ -128,6 +128,14 @@ class DeviceManager {
    */
   void UnregisterAllDevices();
 
+  /**
+   * @brief Save the port patchings and priorities for a list of devices.
+   * @param devices the devices to save the settings for.
+   *
+   * The preferences are saved once, after all the devices have been updated.
+   */
+  void SaveDeviceSettings(const std::vector<const AbstractDevice*> &devices);
+
 
   /**
    * @brief Send timecode to all ports which support timecode.
@@ -151,6 +159,7 @@ class DeviceManager {
   std::set<class OutputPort*> m_timecode_ports;
 
   void ReleaseDevice(const AbstractDevice *device);
+  void SaveDevicePortSettings(const AbstractDevice *device);
   void RestoreDevicePortSettings(AbstractDevice *device);
 
   template <class PortClass>
@@ -159,6 +168,9 @@ class DeviceManager {
   void SavePortPriority(const Port &port) const;
   void RestorePortPriority(Port *port) const;
 
+  void SavePortUIDs(const OutputPort &port) const;
+  void RestorePortUIDs(const std::vector<OutputPort*> &ports) const;
+
   template <class PortClass>
   void RestorePortSettings(const std::vector<PortClass*> &ports) const;
 
@@ -166,6 +178,7 @@ class DeviceManager {
   static const unsigned int FIRST_DEVICE_ALIAS = 1;
   static const char PRIORITY_VALUE_SUFFIX[];
   static const char PRIORITY_MODE_SUFFIX[];
+  static const char UIDS_SUFFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(DeviceManager);
 };
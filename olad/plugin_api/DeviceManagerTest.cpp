@@ -24,6 +24,8 @@
 
 #include "ola/Logging.h"
 #include "ola/DmxBuffer.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "olad/Plugin.h"
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
@@ -43,6 +45,8 @@ using ola::Port;
 using ola::PortManager;
 using ola::Universe;
 using ola::UniverseStore;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
 using std::string;
 using std::vector;
 
@@ -52,12 +56,14 @@ class DeviceManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testDeviceManager);
   CPPUNIT_TEST(testRestorePatchings);
   CPPUNIT_TEST(testRestorePriorities);
+  CPPUNIT_TEST(testRestoreUIDs);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testDeviceManager();
     void testRestorePatchings();
     void testRestorePriorities();
+    void testRestoreUIDs();
 };
 
 
@@ -291,3 +297,51 @@ void DeviceManagerTest::testRestorePriorities() {
   OLA_ASSERT_EQ(string("60"),
                 prefs->GetValue("2-test_device_1-O-3_priority_value"));
 }
+
+
+/*
+ * Test that the UIDs discovered on a port are saved and restored.
+ */
+void DeviceManagerTest::testRestoreUIDs() {
+  ola::MemoryPreferencesFactory prefs_factory;
+  UniverseStore uni_store(NULL, NULL);
+  ola::PortBroker broker;
+  PortManager port_manager(&uni_store, &broker);
+  DeviceManager manager(&prefs_factory, &port_manager);
+
+  ola::Preferences *prefs = prefs_factory.NewPreference("port");
+  OLA_ASSERT(prefs);
+  prefs->SetValue("2-test-device-1-O-1", "3");
+
+  UID uid1(0x7a70, 1);
+  UID uid2(0x7a70, 2);
+  UIDSet uids;
+  uids.AddUID(uid1);
+  uids.AddUID(uid2);
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device1(&plugin, "test-device-1");
+  TestMockRDMOutputPort output_port(&device1, 1, &uids);
+  device1.AddPort(&output_port);
+
+  OLA_ASSERT(manager.RegisterDevice(&device1));
+  Universe *universe = output_port.GetUniverse();
+  OLA_ASSERT(universe);
+  OLA_ASSERT_EQ(0u, universe->UIDCount());
+
+  universe->NewUIDList(&output_port, uids);
+  manager.UnregisterAllDevices();
+  OLA_ASSERT_EQ(uids.ToString(), prefs->GetValue("2-test-device-1-O-1_uids"));
+
+  // Now re-register the device, the UIDs should be available immediately.
+  output_port.SetUniverse(NULL);
+  universe->RemovePort(&output_port);
+  OLA_ASSERT_EQ(0u, universe->UIDCount());
+
+  OLA_ASSERT(manager.RegisterDevice(&device1));
+  OLA_ASSERT_EQ(universe, output_port.GetUniverse());
+  UIDSet restored_uids;
+  universe->GetUIDs(&output_port, &restored_uids);
+  OLA_ASSERT_EQ(uids, restored_uids);
+  manager.UnregisterAllDevices();
+}
@@ -25,6 +25,8 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/PortManager.cpp \
     olad/plugin_api/PortManager.h \
     olad/plugin_api/Preferences.cpp \
+    olad/plugin_api/RDMResponseCache.cpp \
+    olad/plugin_api/RDMResponseCache.h \
     olad/plugin_api/Universe.cpp \
     olad/plugin_api/UniverseStore.cpp \
     olad/plugin_api/UniverseStore.h
@@ -43,6 +45,7 @@ test_programs += \
     olad/plugin_api/DmxSourceTester \
     olad/plugin_api/PortTester \
     olad/plugin_api/PreferencesTester \
+    olad/plugin_api/RDMResponseCacheTester \
     olad/plugin_api/UniverseTester
 
 COMMON_OLAD_PLUGIN_API_TEST_LDADD = \
@@ -73,6 +76,12 @@ olad_plugin_api_PreferencesTester_SOURCES = olad/plugin_api/PreferencesTest.cpp
 olad_plugin_api_PreferencesTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_PreferencesTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
+olad_plugin_api_RDMResponseCacheTester_SOURCES = \
+    olad/plugin_api/RDMResponseCacheTest.cpp
+olad_plugin_api_RDMResponseCacheTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+olad_plugin_api_RDMResponseCacheTester_LDADD = \
+    $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
 olad_plugin_api_UniverseTester_SOURCES = olad/plugin_api/UniverseTest.cpp
 olad_plugin_api_UniverseTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_UniverseTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
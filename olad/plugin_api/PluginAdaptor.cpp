@@ -20,7 +20,9 @@
  */
 
 #include <string>
+#include <utility>
 #include "ola/Callback.h"
+#include "ola/thread/Future.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
@@ -28,10 +30,46 @@
 
 namespace ola {
 
+using ola::io::ConnectedDescriptor;
+using ola::io::ReadFileDescriptor;
 using ola::io::SelectServerInterface;
+using ola::io::WriteFileDescriptor;
+using ola::thread::ExecutorInterface;
+using ola::thread::Future;
+using ola::thread::ThreadId;
 using ola::thread::timeout_id;
 using std::string;
 
+namespace {
+template <typename T>
+void RunAndSetFuture(SingleUseCallback0<T> *callback, Future<T> future) {
+  future.Set(callback->Run());
+}
+
+void RunAndSetVoidFuture(SingleUseCallback0<void> *callback,
+                         Future<void> future) {
+  callback->Run();
+  future.Set();
+}
+
+/*
+ * Run a callback on an executor and wait for the result.
+ */
+template <typename T>
+T RunAndWait(ExecutorInterface *executor, SingleUseCallback0<T> *callback) {
+  Future<T> future;
+  executor->Execute(NewSingleCallback(&RunAndSetFuture<T>, callback, future));
+  return future.Get();
+}
+
+void RunAndWait(ExecutorInterface *executor,
+                SingleUseCallback0<void> *callback) {
+  Future<void> future;
+  executor->Execute(NewSingleCallback(&RunAndSetVoidFuture, callback, future));
+  future.Get();
+}
+}  // namespace
+
 PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
                              SelectServerInterface *select_server,
                              ExportMap *export_map,
@@ -46,62 +84,141 @@ PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
   m_instance_name(instance_name) {
 }
 
-bool PluginAdaptor::AddReadDescriptor(
-    ola::io::ReadFileDescriptor *descriptor) {
+bool PluginAdaptor::AddReadDescriptor(ReadFileDescriptor *descriptor) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    bool (SelectServerInterface::*method)(ReadFileDescriptor*) =
+        &SelectServerInterface::AddReadDescriptor;
+    return RunAndWait(executor, NewSingleCallback(m_ss, method, descriptor));
+  }
   return m_ss->AddReadDescriptor(descriptor);
 }
 
-bool PluginAdaptor::AddReadDescriptor(
-    ola::io::ConnectedDescriptor *descriptor,
-    bool delete_on_close) {
+bool PluginAdaptor::AddReadDescriptor(ConnectedDescriptor *descriptor,
+                                      bool delete_on_close) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    bool (SelectServerInterface::*method)(ConnectedDescriptor*, bool) =
+        &SelectServerInterface::AddReadDescriptor;
+    return RunAndWait(executor, NewSingleCallback(m_ss, method, descriptor,
+                                                  delete_on_close));
+  }
   return m_ss->AddReadDescriptor(descriptor, delete_on_close);
 }
 
-void PluginAdaptor::RemoveReadDescriptor(
-    ola::io::ReadFileDescriptor *descriptor) {
+void PluginAdaptor::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    void (SelectServerInterface::*method)(ReadFileDescriptor*) =
+        &SelectServerInterface::RemoveReadDescriptor;
+    RunAndWait(executor, NewSingleCallback(m_ss, method, descriptor));
+    return;
+  }
   m_ss->RemoveReadDescriptor(descriptor);
 }
 
-void PluginAdaptor::RemoveReadDescriptor(
-    ola::io::ConnectedDescriptor *descriptor) {
+void PluginAdaptor::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    void (SelectServerInterface::*method)(ConnectedDescriptor*) =
+        &SelectServerInterface::RemoveReadDescriptor;
+    RunAndWait(executor, NewSingleCallback(m_ss, method, descriptor));
+    return;
+  }
   m_ss->RemoveReadDescriptor(descriptor);
 }
 
-bool PluginAdaptor::AddWriteDescriptor(
-    ola::io::WriteFileDescriptor *descriptor) {
+bool PluginAdaptor::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    return RunAndWait(
+        executor,
+        NewSingleCallback(m_ss, &SelectServerInterface::AddWriteDescriptor,
+                          descriptor));
+  }
   return m_ss->AddWriteDescriptor(descriptor);
 }
 
-void PluginAdaptor::RemoveWriteDescriptor(
-    ola::io::WriteFileDescriptor *descriptor) {
+void PluginAdaptor::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    RunAndWait(
+        executor,
+        NewSingleCallback(m_ss, &SelectServerInterface::RemoveWriteDescriptor,
+                          descriptor));
+    return;
+  }
   m_ss->RemoveWriteDescriptor(descriptor);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     unsigned int ms,
     Callback0<bool> *closure) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    timeout_id (SelectServerInterface::*method)(unsigned int,
+                                                Callback0<bool>*) =
+        &SelectServerInterface::RegisterRepeatingTimeout;
+    return RunAndWait(executor, NewSingleCallback(m_ss, method, ms, closure));
+  }
   return m_ss->RegisterRepeatingTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     const TimeInterval &interval,
     Callback0<bool> *closure) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    timeout_id (SelectServerInterface::*method)(const TimeInterval&,
+                                                Callback0<bool>*) =
+        &SelectServerInterface::RegisterRepeatingTimeout;
+    return RunAndWait(
+        executor,
+        NewSingleCallback<SelectServerInterface, timeout_id,
+                          const TimeInterval&, Callback0<bool>*>(
+            m_ss, method, interval, closure));
+  }
   return m_ss->RegisterRepeatingTimeout(interval, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     unsigned int ms,
     SingleUseCallback0<void> *closure) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    timeout_id (SelectServerInterface::*method)(unsigned int,
+                                                SingleUseCallback0<void>*) =
+        &SelectServerInterface::RegisterSingleTimeout;
+    return RunAndWait(executor, NewSingleCallback(m_ss, method, ms, closure));
+  }
   return m_ss->RegisterSingleTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     const TimeInterval &interval,
     SingleUseCallback0<void> *closure) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    timeout_id (SelectServerInterface::*method)(const TimeInterval&,
+                                                SingleUseCallback0<void>*) =
+        &SelectServerInterface::RegisterSingleTimeout;
+    return RunAndWait(
+        executor,
+        NewSingleCallback<SelectServerInterface, timeout_id,
+                          const TimeInterval&, SingleUseCallback0<void>*>(
+            m_ss, method, interval, closure));
+  }
   return m_ss->RegisterSingleTimeout(interval, closure);
 }
 
 void PluginAdaptor::RemoveTimeout(timeout_id id) {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    RunAndWait(executor,
+               NewSingleCallback(m_ss, &SelectServerInterface::RemoveTimeout,
+                                 id));
+    return;
+  }
   m_ss->RemoveTimeout(id);
 }
 
@@ -114,14 +231,37 @@ void PluginAdaptor::DrainCallbacks() {
 }
 
 bool PluginAdaptor::RegisterDevice(AbstractDevice *device) const {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    return RunAndWait(
+        executor,
+        NewSingleCallback(m_device_manager, &DeviceManager::RegisterDevice,
+                          device));
+  }
   return m_device_manager->RegisterDevice(device);
 }
 
 bool PluginAdaptor::UnregisterDevice(AbstractDevice *device) const {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    bool (DeviceManager::*method)(const AbstractDevice*) =
+        &DeviceManager::UnregisterDevice;
+    return RunAndWait(
+        executor,
+        NewSingleCallback(m_device_manager, method,
+                          static_cast<const AbstractDevice*>(device)));
+  }
   return m_device_manager->UnregisterDevice(device);
 }
 
 Preferences *PluginAdaptor::NewPreference(const string &name) const {
+  ExecutorInterface *executor = ForwardingExecutor();
+  if (executor) {
+    return RunAndWait(
+        executor,
+        NewSingleCallback<PreferencesFactory, Preferences*, const string&>(
+            m_preferences_factory, &PreferencesFactory::NewPreference, name));
+  }
   return m_preferences_factory->NewPreference(name);
 }
 
@@ -136,4 +276,44 @@ const std::string PluginAdaptor::InstanceName() {
     return "";
   }
 }
+
+void PluginAdaptor::ForwardCalls(ThreadId thread_id,
+                                 ExecutorInterface *executor) {
+  ola::thread::MutexLocker locker(&m_forwarding_mutex);
+  ForwardingList::iterator iter = m_forwarding.begin();
+  for (; iter != m_forwarding.end(); ++iter) {
+    if (pthread_equal(iter->first, thread_id)) {
+      break;
+    }
+  }
+
+  if (iter != m_forwarding.end()) {
+    if (executor) {
+      iter->second = executor;
+    } else {
+      m_forwarding.erase(iter);
+    }
+  } else if (executor) {
+    m_forwarding.push_back(std::make_pair(thread_id, executor));
+  }
+}
+
+/*
+ * Return the executor to run calls from this thread on, or NULL if the calls
+ * should be run directly.
+ */
+ExecutorInterface *PluginAdaptor::ForwardingExecutor() const {
+  ola::thread::MutexLocker locker(&m_forwarding_mutex);
+  if (m_forwarding.empty()) {
+    return NULL;
+  }
+  const ThreadId self = ola::thread::Thread::Self();
+  ForwardingList::const_iterator iter = m_forwarding.begin();
+  for (; iter != m_forwarding.end(); ++iter) {
+    if (pthread_equal(iter->first, self)) {
+      return iter->second;
+    }
+  }
+  return NULL;
+}
 }  // namespace ola
@@ -139,6 +139,11 @@ bool BasicOutputPort::SetUniverse(Universe *new_universe) {
   if (PreSetUniverse(old_universe, new_universe)) {
     m_universe = new_universe;
     PostSetUniverse(old_universe, new_universe);
+    if (new_universe && !m_known_uids.Empty()) {
+      // Publish the UIDs from last time while discovery verifies them.
+      new_universe->NewUIDList(this, m_known_uids);
+      m_known_uids.Clear();
+    }
     if (m_discover_on_patch)
       RunIncrementalDiscovery(
           NewSingleCallback(this, &BasicOutputPort::UpdateUIDs));
@@ -191,6 +196,12 @@ void BasicOutputPort::RunIncrementalDiscovery(
   on_complete->Run(uids);
 }
 
+void BasicOutputPort::SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+  if (m_supports_rdm) {
+    m_known_uids = uids;
+  }
+}
+
 void BasicOutputPort::UpdateUIDs(const ola::rdm::UIDSet &uids) {
   Universe *universe = GetUniverse();
   if (universe)
@@ -21,6 +21,7 @@
 #define __STDC_LIMIT_MACROS  // for UINT8_MAX & friends
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -28,10 +29,12 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <fstream>
 #include <list>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -47,6 +50,7 @@
 namespace ola {
 
 using ola::thread::Mutex;
+using ola::thread::MutexLocker;
 using ola::thread::ConditionVariable;
 using std::ifstream;
 using std::ofstream;
@@ -56,26 +60,100 @@ using std::string;
 using std::vector;
 
 namespace {
-void SavePreferencesToFile(
-    const string *filename_ptr,
-    const FilePreferenceSaverThread::PreferencesMap *pref_map_ptr) {
-  std::auto_ptr<const string> filename(filename_ptr);
-  std::auto_ptr<const FilePreferenceSaverThread::PreferencesMap> pref_map(
-      pref_map_ptr);
-
+/*
+ * Write the preferences to a temporary file, sync it to disk and then rename
+ * it over the original.
+ */
+bool WritePreferencesFile(
+    const string &filename,
+    const FilePreferenceSaverThread::PreferencesMap &pref_map) {
+  std::ostringstream output;
   FilePreferenceSaverThread::PreferencesMap::const_iterator iter;
-  ofstream pref_file(filename->data());
+  for (iter = pref_map.begin(); iter != pref_map.end(); ++iter) {
+    output << iter->first << " = " << iter->second << std::endl;
+  }
+  const string data = output.str();
+  const string temp_filename = filename + ".new";
 
-  if (!pref_file.is_open()) {
-    OLA_WARN << "Could not open " << *filename_ptr << ": " << strerror(errno);
-    return;
+  int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    OLA_WARN << "Could not open " << temp_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  const char *ptr = data.data();
+  size_t remaining = data.size();
+  while (remaining) {
+    ssize_t bytes_written = write(fd, ptr, remaining);
+    if (bytes_written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      OLA_WARN << "Failed to write " << temp_filename << ": "
+               << strerror(errno);
+      close(fd);
+      unlink(temp_filename.c_str());
+      return false;
+    }
+    ptr += bytes_written;
+    remaining -= bytes_written;
   }
 
-  for (iter = pref_map->begin(); iter != pref_map->end(); ++iter) {
-    pref_file << iter->first << " = " << iter->second << std::endl;
+#ifndef _WIN32
+  if (fsync(fd)) {
+    OLA_WARN << "Failed to sync " << temp_filename << ": " << strerror(errno);
+    close(fd);
+    unlink(temp_filename.c_str());
+    return false;
   }
-  pref_file.flush();
-  pref_file.close();
+#endif  // _WIN32
+  if (close(fd)) {
+    OLA_WARN << "Failed to close " << temp_filename << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return false;
+  }
+
+#ifdef _WIN32
+  // rename() won't replace an existing file on Windows.
+  unlink(filename.c_str());
+#endif  // _WIN32
+  if (rename(temp_filename.c_str(), filename.c_str())) {
+    OLA_WARN << "Failed to rename " << temp_filename << " to " << filename
+             << ": " << strerror(errno);
+    unlink(temp_filename.c_str());
+    return false;
+  }
+
+#ifndef _WIN32
+  // Sync the directory so the rename is on disk as well.
+  const string::size_type pos = filename.find_last_of(
+      ola::file::PATH_SEPARATOR);
+  const string directory = pos == string::npos ? "." : filename.substr(0, pos);
+  int dir_fd = open(directory.empty() ? "/" : directory.c_str(), O_RDONLY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+#endif  // _WIN32
+  return true;
+}
+
+void ExportSaveStats(ExportMap *export_map,
+                     FilePreferenceSaverThread::SaveStats stats) {
+  export_map->GetIntegerVar(
+      FilePreferenceSaverThread::K_SAVE_REQUESTS_VAR)->Set(
+          stats.save_requests);
+  export_map->GetIntegerVar(
+      FilePreferenceSaverThread::K_FILES_WRITTEN_VAR)->Set(
+          stats.files_written);
+  export_map->GetIntegerVar(
+      FilePreferenceSaverThread::K_WRITE_ERRORS_VAR)->Set(stats.write_errors);
+  export_map->GetIntegerVar(
+      FilePreferenceSaverThread::K_LAST_WRITE_TIME_VAR)->Set(
+          stats.last_write_time);
+  export_map->GetIntegerVar(
+      FilePreferenceSaverThread::K_MAX_WRITE_TIME_VAR)->Set(
+          stats.max_write_time);
 }
 }  // namespace
 
@@ -344,25 +422,75 @@ void MemoryPreferences::SetValueAsBool(const string &key, bool value) {
 // FilePreferenceSaverThread
 //-----------------------------------------------------------------------------
 
+const char FilePreferenceSaverThread::K_SAVE_REQUESTS_VAR[] =
+    "preferences-save-requests";
+const char FilePreferenceSaverThread::K_FILES_WRITTEN_VAR[] =
+    "preferences-files-written";
+const char FilePreferenceSaverThread::K_WRITE_ERRORS_VAR[] =
+    "preferences-write-errors";
+const char FilePreferenceSaverThread::K_LAST_WRITE_TIME_VAR[] =
+    "preferences-last-write-time-us";
+const char FilePreferenceSaverThread::K_MAX_WRITE_TIME_VAR[] =
+    "preferences-max-write-time-us";
+
 FilePreferenceSaverThread::FilePreferenceSaverThread()
-    : Thread(Thread::Options("pref-saver")) {
+    : Thread(Thread::Options("pref-saver")),
+      m_save_delay(static_cast<int64_t>(DEFAULT_SAVE_DELAY_MS) * 1000),
+      m_export_map(NULL),
+      m_executor(NULL),
+      m_save_timeout(ola::thread::INVALID_TIMEOUT),
+      m_save_scheduled(false) {
+  memset(&m_stats, 0, sizeof(m_stats));
   // set a long poll interval so we don't spin
   m_ss.SetDefaultInterval(TimeInterval(60, 0));
 }
 
+FilePreferenceSaverThread::FilePreferenceSaverThread(
+    const TimeInterval &save_delay,
+    ExportMap *export_map,
+    ola::thread::ExecutorInterface *executor)
+    : Thread(Thread::Options("pref-saver")),
+      m_save_delay(save_delay),
+      m_export_map(export_map),
+      m_executor(executor),
+      m_save_timeout(ola::thread::INVALID_TIMEOUT),
+      m_save_scheduled(false) {
+  memset(&m_stats, 0, sizeof(m_stats));
+  // set a long poll interval so we don't spin
+  m_ss.SetDefaultInterval(TimeInterval(60, 0));
+}
+
+FilePreferenceSaverThread::~FilePreferenceSaverThread() {
+  STLDeleteValues(&m_pending_files);
+}
+
 void FilePreferenceSaverThread::SavePreferences(
     const string &file_name,
     const PreferencesMap &preferences) {
-  const string *file_name_ptr = new string(file_name);
   const PreferencesMap *save_map = new PreferencesMap(preferences);
-  SingleUseCallback0<void> *cb =
-      NewSingleCallback(SavePreferencesToFile, file_name_ptr, save_map);
-  m_ss.Execute(cb);
+  bool schedule_save = false;
+  {
+    MutexLocker locker(&m_mutex);
+    m_stats.save_requests++;
+    // Replace any copy of this file that hasn't been written yet.
+    STLReplaceAndDelete(&m_pending_files, file_name, save_map);
+    if (!m_save_scheduled) {
+      m_save_scheduled = true;
+      schedule_save = true;
+    }
+  }
+
+  if (schedule_save) {
+    m_ss.Execute(
+        NewSingleCallback(this, &FilePreferenceSaverThread::ScheduleSave));
+  }
 }
 
 
 void *FilePreferenceSaverThread::Run() {
   m_ss.Run();
+  // Write anything that was saved after the last batch.
+  SavePendingFiles();
   return NULL;
 }
 
@@ -377,6 +505,8 @@ void FilePreferenceSaverThread::Syncronize() {
   Mutex syncronize_mutex;
   ConditionVariable condition_var;
   syncronize_mutex.Lock();
+  m_ss.Execute(NewSingleCallback(
+        this, &FilePreferenceSaverThread::SavePendingFiles));
   m_ss.Execute(NewSingleCallback(
         this,
         &FilePreferenceSaverThread::CompleteSyncronization,
@@ -386,6 +516,87 @@ void FilePreferenceSaverThread::Syncronize() {
 }
 
 
+FilePreferenceSaverThread::SaveStats FilePreferenceSaverThread::Stats() const {
+  MutexLocker locker(&m_mutex);
+  return m_stats;
+}
+
+
+/*
+ * Called in the saver thread to start the save delay.
+ */
+void FilePreferenceSaverThread::ScheduleSave() {
+  if (m_save_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_save_timeout = m_ss.RegisterSingleTimeout(
+        m_save_delay,
+        NewSingleCallback(this, &FilePreferenceSaverThread::SaveTimeout));
+  }
+}
+
+
+void FilePreferenceSaverThread::SaveTimeout() {
+  m_save_timeout = ola::thread::INVALID_TIMEOUT;
+  SavePendingFiles();
+}
+
+
+/*
+ * Write all the pending files, this runs in the saver thread.
+ */
+void FilePreferenceSaverThread::SavePendingFiles() {
+  if (m_save_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss.RemoveTimeout(m_save_timeout);
+    m_save_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  PendingFiles files;
+  {
+    MutexLocker locker(&m_mutex);
+    files.swap(m_pending_files);
+    m_save_scheduled = false;
+  }
+
+  if (files.empty()) {
+    return;
+  }
+
+  Clock clock;
+  TimeStamp start, end;
+  clock.CurrentTime(&start);
+  unsigned int files_written = 0;
+  unsigned int write_errors = 0;
+  PendingFiles::const_iterator iter = files.begin();
+  for (; iter != files.end(); ++iter) {
+    if (WritePreferencesFile(iter->first, *iter->second)) {
+      files_written++;
+    } else {
+      write_errors++;
+    }
+  }
+  clock.CurrentTime(&end);
+  STLDeleteValues(&files);
+
+  const unsigned int write_time =
+      static_cast<unsigned int>((end - start).AsInt());
+  SaveStats stats;
+  {
+    MutexLocker locker(&m_mutex);
+    m_stats.files_written += files_written;
+    m_stats.write_errors += write_errors;
+    m_stats.last_write_time = write_time;
+    m_stats.max_write_time = std::max(m_stats.max_write_time, write_time);
+    stats = m_stats;
+  }
+  OLA_DEBUG << "Wrote " << files_written << " preference files in "
+            << write_time << "us";
+
+  if (m_export_map && m_executor) {
+    m_executor->Execute(NewSingleCallback(ExportSaveStats, m_export_map,
+                                          stats));
+  }
+}
+
+
 void FilePreferenceSaverThread::CompleteSyncronization(
     ConditionVariable *condition,
     Mutex *mutex) {
@@ -19,12 +19,15 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/ExportMap.h"
 #include "ola/StringUtils.h"
+#include "ola/io/SelectServer.h"
 #include "olad/Preferences.h"
 #include "ola/testing/TestUtils.h"
 
@@ -32,6 +35,7 @@
 using ola::BoolValidator;
 using ola::FileBackedPreferences;
 using ola::FileBackedPreferencesFactory;
+using ola::FilePreferenceSaverThread;
 using ola::IntToString;
 using ola::IntValidator;
 using ola::UIntValidator;
@@ -52,6 +56,7 @@ class PreferencesTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testFactory);
   CPPUNIT_TEST(testLoad);
   CPPUNIT_TEST(testSave);
+  CPPUNIT_TEST(testCoalescedSave);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -64,6 +69,7 @@ class PreferencesTest: public CppUnit::TestFixture {
     void testFactory();
     void testLoad();
     void testSave();
+    void testCoalescedSave();
 };
 
 
@@ -377,3 +383,69 @@ void PreferencesTest::testSave() {
 
   saver_thread.Join();
 }
+
+
+/*
+ * Check that saves are coalesced and the stats are exported.
+ */
+void PreferencesTest::testCoalescedSave() {
+  const string data_path1 = TEST_BUILD_DIR "/olad/ola-coalesce1.conf";
+  const string data_path2 = TEST_BUILD_DIR "/olad/ola-coalesce2.conf";
+  unlink(data_path1.c_str());
+  unlink(data_path2.c_str());
+
+  ola::ExportMap export_map;
+  ola::io::SelectServer ss;
+  // Use a long delay so nothing is written until we call Syncronize().
+  FilePreferenceSaverThread saver_thread(ola::TimeInterval(60, 0),
+                                         &export_map, &ss);
+  saver_thread.Start();
+  FileBackedPreferences preferences1(TEST_BUILD_DIR "/olad", "coalesce1",
+                                     &saver_thread);
+  FileBackedPreferences preferences2(TEST_BUILD_DIR "/olad", "coalesce2",
+                                     &saver_thread);
+
+  for (unsigned int i = 0; i < 100; i++) {
+    preferences1.SetValue("universe", i);
+    preferences1.Save();
+    preferences2.SetValue("universe", i + 1000);
+    preferences2.Save();
+  }
+
+  FilePreferenceSaverThread::SaveStats stats = saver_thread.Stats();
+  OLA_ASSERT_EQ(200u, stats.save_requests);
+  OLA_ASSERT_EQ(0u, stats.files_written);
+
+  saver_thread.Syncronize();
+  stats = saver_thread.Stats();
+  OLA_ASSERT_EQ(2u, stats.files_written);
+  OLA_ASSERT_EQ(0u, stats.write_errors);
+
+  // The temporary files have been renamed.
+  OLA_ASSERT_NE(0, access((data_path1 + ".new").c_str(), F_OK));
+  OLA_ASSERT_NE(0, access((data_path2 + ".new").c_str(), F_OK));
+
+  FileBackedPreferences input_preferences("", "input", NULL);
+  input_preferences.LoadFromFile(data_path1);
+  OLA_ASSERT(preferences1 == input_preferences);
+  OLA_ASSERT_EQ(string("99"), input_preferences.GetValue("universe"));
+  input_preferences.LoadFromFile(data_path2);
+  OLA_ASSERT(preferences2 == input_preferences);
+
+  // The stats are exported using the executor.
+  OLA_ASSERT_EQ(0, export_map.GetIntegerVar(
+      FilePreferenceSaverThread::K_FILES_WRITTEN_VAR)->Get());
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  OLA_ASSERT_EQ(2, export_map.GetIntegerVar(
+      FilePreferenceSaverThread::K_FILES_WRITTEN_VAR)->Get());
+  OLA_ASSERT_EQ(200, export_map.GetIntegerVar(
+      FilePreferenceSaverThread::K_SAVE_REQUESTS_VAR)->Get());
+
+  // Pending files are written when the thread stops.
+  preferences1.SetValue("universe", 200);
+  preferences1.Save();
+  saver_thread.Join();
+  OLA_ASSERT_EQ(3u, saver_thread.Stats().files_written);
+  input_preferences.LoadFromFile(data_path1);
+  OLA_ASSERT_EQ(string("200"), input_preferences.GetValue("universe"));
+}
@@ -0,0 +1,505 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.cpp
+ * Caches RDM responses that don't change for a given device model.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/RDMResponseCache.h"
+
+namespace ola {
+
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+const char RDMResponseCache::K_RDM_CACHE_HITS_VAR[] = "rdm-cache-hits";
+const char RDMResponseCache::K_RDM_CACHE_MISSES_VAR[] = "rdm-cache-misses";
+const char RDMResponseCache::K_RDM_CACHE_RESPONSES_VAR[] =
+    "rdm-cache-responses";
+const char RDMResponseCache::DEVICE_KEY[] = "uid";
+const char RDMResponseCache::MODEL_SUFFIX[] = "-model";
+const char RDMResponseCache::SEEN_SUFFIX[] = "-seen";
+
+namespace {
+
+string HexEncode(const string &data) {
+  static const char HEX_DIGITS[] = "0123456789abcdef";
+  string output;
+  output.reserve(data.size() * 2);
+  for (unsigned int i = 0; i < data.size(); i++) {
+    uint8_t byte = data[i];
+    output.push_back(HEX_DIGITS[byte >> 4]);
+    output.push_back(HEX_DIGITS[byte & 0x0f]);
+  }
+  return output;
+}
+
+bool HexDecode(const string &input, string *data) {
+  if (input.size() % 2) {
+    return false;
+  }
+  data->clear();
+  for (unsigned int i = 0; i < input.size(); i += 2) {
+    uint8_t byte;
+    if (!HexStringToInt(input.substr(i, 2), &byte)) {
+      return false;
+    }
+    data->push_back(static_cast<char>(byte));
+  }
+  return true;
+}
+}  // namespace
+
+
+bool RDMResponseCache::ResponseKey::operator<(
+    const ResponseKey &other) const {
+  if (pid != other.pid) {
+    return pid < other.pid;
+  }
+  if (sub_device != other.sub_device) {
+    return sub_device < other.sub_device;
+  }
+  return param_data < other.param_data;
+}
+
+
+RDMResponseCache::RDMResponseCache(ExportMap *export_map,
+                                   const Clock *clock)
+    : m_export_map(export_map),
+      m_clock(clock ? clock : &m_system_clock),
+      m_dirty(false) {
+  if (m_export_map) {
+    m_export_map->GetCounterVar(K_RDM_CACHE_HITS_VAR);
+    m_export_map->GetCounterVar(K_RDM_CACHE_MISSES_VAR);
+    m_export_map->GetIntegerVar(K_RDM_CACHE_RESPONSES_VAR);
+  }
+}
+
+
+RDMResponse *RDMResponseCache::Lookup(const RDMRequest *request) {
+  if (request->CommandClass() != RDMCommand::GET_COMMAND) {
+    return NULL;
+  }
+
+  cache_type type = CacheType(request->ParamId());
+  if (type == NOT_CACHEABLE) {
+    return NULL;
+  }
+
+  Device *device = STLFind(&m_devices, request->DestinationUID());
+  const string *data = NULL;
+  if (device && device->verified) {
+    data = STLFind(&device->model_data, MakeKey(request));
+  }
+
+  if (!data) {
+    Increment(K_RDM_CACHE_MISSES_VAR);
+    return NULL;
+  }
+
+  Increment(K_RDM_CACHE_HITS_VAR);
+  return ola::rdm::GetResponseFromData(
+      request, reinterpret_cast<const uint8_t*>(data->data()), data->size());
+}
+
+
+bool RDMResponseCache::ShouldObserve(const RDMRequest *request) const {
+  if (request->CommandClass() == RDMCommand::SET_COMMAND) {
+    return true;
+  }
+  // DEVICE_INFO isn't cached, but it's used to verify the model.
+  return (request->CommandClass() == RDMCommand::GET_COMMAND &&
+          (request->ParamId() == ola::rdm::PID_QUEUED_MESSAGE ||
+           request->ParamId() == ola::rdm::PID_DEVICE_INFO ||
+           CacheType(request->ParamId()) != NOT_CACHEABLE));
+}
+
+
+void RDMResponseCache::RequestSent(const RDMRequest *request) {
+  if (request->CommandClass() != RDMCommand::SET_COMMAND) {
+    return;
+  }
+
+  const UID &uid = request->DestinationUID();
+  if (uid.IsBroadcast()) {
+    DeviceMap::iterator iter = m_devices.begin();
+    for (; iter != m_devices.end(); ++iter) {
+      if (uid.DirectedToUID(iter->first)) {
+        InvalidateDevice(request->ParamId(), &iter->second);
+      }
+    }
+  } else {
+    Device *device = STLFind(&m_devices, uid);
+    if (device) {
+      InvalidateDevice(request->ParamId(), device);
+    }
+  }
+  UpdateResponseCount();
+}
+
+
+void RDMResponseCache::ReplyReceived(const RDMRequest *request,
+                                     const RDMReply *reply) {
+  const UID &uid = request->DestinationUID();
+  if (request->CommandClass() == RDMCommand::SET_COMMAND) {
+    // A GET may have been in flight when the SET was sent.
+    RequestSent(request);
+    return;
+  }
+
+  const RDMResponse *response = reply->Response();
+  if (reply->StatusCode() != ola::rdm::RDM_COMPLETED_OK || !response ||
+      uid.IsBroadcast()) {
+    return;
+  }
+
+  if (response->ResponseType() != ola::rdm::RDM_ACK ||
+      response->CommandClass() != RDMCommand::GET_COMMAND_RESPONSE) {
+    return;
+  }
+
+  Device *device = &m_devices[uid];
+  if (request->ParamId() == ola::rdm::PID_QUEUED_MESSAGE) {
+    // The response contains the PID that changed.
+    if (CacheType(response->ParamId()) == MODEL_DATA) {
+      OLA_INFO << uid << " sent a queued message for PID "
+               << strings::ToHex(response->ParamId())
+               << ", removing cached responses";
+      device->model_data.clear();
+      device->verified = false;
+      m_dirty = true;
+    }
+    UpdateResponseCount();
+    return;
+  }
+
+  if (response->ParamId() != request->ParamId() ||
+      response->SubDevice() != request->SubDevice()) {
+    return;
+  }
+
+  if (response->ParamId() == ola::rdm::PID_DEVICE_INFO) {
+    if (response->SubDevice() == ola::rdm::ROOT_RDM_DEVICE) {
+      UpdateDeviceInfo(uid, device, response);
+      UpdateResponseCount();
+    }
+    return;
+  }
+
+  if (CacheType(response->ParamId()) == NOT_CACHEABLE) {
+    return;
+  }
+
+  if (device->verified) {
+    // Responses are only stored once we know which model they belong to.
+    string data(reinterpret_cast<const char*>(response->ParamData()),
+                response->ParamDataSize());
+    string &entry = device->model_data[MakeKey(request)];
+    if (entry != data) {
+      entry = data;
+      m_dirty = true;
+    }
+  }
+  UpdateResponseCount();
+}
+
+
+void RDMResponseCache::DeviceDiscovered(const UID &uid) {
+  Device *device = STLFind(&m_devices, uid);
+  if (device) {
+    device->verified = false;
+    Seen(device);
+  }
+}
+
+
+void RDMResponseCache::RemoveDevice(const UID &uid) {
+  if (m_devices.erase(uid)) {
+    m_dirty = true;
+    UpdateResponseCount();
+  }
+}
+
+
+unsigned int RDMResponseCache::ResponseCount() const {
+  unsigned int count = 0;
+  DeviceMap::const_iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    count += iter->second.model_data.size();
+  }
+  return count;
+}
+
+
+void RDMResponseCache::Load(const Preferences &preferences) {
+  const unsigned int now = Now();
+  bool expired = false;
+  const vector<string> uids = preferences.GetMultipleValue(DEVICE_KEY);
+  vector<string>::const_iterator uid_iter = uids.begin();
+  for (; uid_iter != uids.end(); ++uid_iter) {
+    auto_ptr<UID> uid(UID::FromString(*uid_iter));
+    if (!uid.get()) {
+      OLA_WARN << "Invalid UID in RDM cache: " << *uid_iter;
+      continue;
+    }
+
+    vector<string> model_info;
+    StringSplit(preferences.GetValue(*uid_iter + MODEL_SUFFIX), &model_info,
+                ",");
+    Device device;
+    if (model_info.size() != 2 ||
+        !HexStringToInt(model_info[0], &device.model) ||
+        !HexStringToInt(model_info[1], &device.software_version)) {
+      OLA_WARN << "Invalid model info in RDM cache for " << *uid;
+      continue;
+    }
+    device.model_known = true;
+
+    // Caches saved before the last seen time was recorded start from now.
+    if (!StringToInt(preferences.GetValue(*uid_iter + SEEN_SUFFIX),
+                     &device.last_seen)) {
+      device.last_seen = now;
+    }
+    if (now > device.last_seen && now - device.last_seen > K_MAX_DEVICE_AGE) {
+      OLA_INFO << *uid << " hasn't been seen for "
+               << (now - device.last_seen) / (24 * 60 * 60)
+               << " days, dropping its cached responses";
+      expired = true;
+      continue;
+    }
+
+    const vector<string> entries = preferences.GetMultipleValue(*uid_iter);
+    vector<string>::const_iterator iter = entries.begin();
+    for (; iter != entries.end(); ++iter) {
+      ResponseKey key;
+      string data;
+      if (ParseEntry(*iter, &key, &data)) {
+        device.model_data[key] = data;
+      } else {
+        OLA_WARN << "Invalid RDM cache entry for " << *uid << ": " << *iter;
+      }
+    }
+    m_devices[*uid] = device;
+  }
+  // Save again so the expired devices are removed from the file.
+  m_dirty = expired;
+  UpdateResponseCount();
+  OLA_INFO << "Loaded " << ResponseCount() << " cached RDM responses";
+}
+
+
+bool RDMResponseCache::Save(Preferences *preferences) {
+  if (!m_dirty) {
+    return false;
+  }
+
+  preferences->Clear();
+  DeviceMap::const_iterator iter = m_devices.begin();
+  for (; iter != m_devices.end(); ++iter) {
+    const Device &device = iter->second;
+    if (!device.model_known || device.model_data.empty()) {
+      continue;
+    }
+
+    const string uid = iter->first.ToString();
+    preferences->SetMultipleValue(DEVICE_KEY, uid);
+
+    std::ostringstream str;
+    str << strings::ToHex(device.model, false) << ","
+        << strings::ToHex(device.software_version, false);
+    preferences->SetValue(uid + MODEL_SUFFIX, str.str());
+    preferences->SetValue(uid + SEEN_SUFFIX,
+                          strings::IntToString(device.last_seen));
+
+    ResponseMap::const_iterator response_iter = device.model_data.begin();
+    for (; response_iter != device.model_data.end(); ++response_iter) {
+      preferences->SetMultipleValue(
+          uid, SerializeEntry(response_iter->first, response_iter->second));
+    }
+  }
+  m_dirty = false;
+  return true;
+}
+
+
+unsigned int RDMResponseCache::Now() const {
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  return now.Seconds();
+}
+
+
+/*
+ * Record that the device is still present.
+ */
+void RDMResponseCache::Seen(Device *device) {
+  const unsigned int now = Now();
+  const unsigned int age = now > device->last_seen ?
+      now - device->last_seen : device->last_seen - now;
+  if (device->model_known && age >= SEEN_RESOLUTION) {
+    m_dirty = true;
+  }
+  device->last_seen = now;
+}
+
+
+/*
+ * Called when a SET is sent to a device.
+ */
+void RDMResponseCache::InvalidateDevice(uint16_t pid, Device *device) {
+  if (pid == ola::rdm::PID_LANGUAGE && !device->model_data.empty()) {
+    // The labels & descriptions may be localized.
+    device->model_data.clear();
+    m_dirty = true;
+  }
+}
+
+
+/*
+ * Check the model & software version from a DEVICE_INFO response. If they
+ * have changed, the model data is no longer valid.
+ */
+void RDMResponseCache::UpdateDeviceInfo(const UID &uid,
+                                        Device *device,
+                                        const RDMResponse *response) {
+  if (response->ParamDataSize() < DEVICE_INFO_MIN_SIZE) {
+    return;
+  }
+
+  uint16_t model;
+  uint32_t software_version;
+  memcpy(&model, response->ParamData() + 2, sizeof(model));
+  memcpy(&software_version, response->ParamData() + 6,
+         sizeof(software_version));
+  model = ola::network::NetworkToHost(model);
+  software_version = ola::network::NetworkToHost(software_version);
+
+  if (device->model_known &&
+      (device->model != model ||
+       device->software_version != software_version)) {
+    OLA_INFO << uid << " changed from model " << strings::ToHex(device->model)
+             << ", version " << device->software_version << " to model "
+             << strings::ToHex(model) << ", version " << software_version
+             << ", removing cached responses";
+    device->model_data.clear();
+    m_dirty = true;
+  }
+  Seen(device);
+  device->model_known = true;
+  device->verified = true;
+  device->model = model;
+  device->software_version = software_version;
+}
+
+
+void RDMResponseCache::UpdateResponseCount() {
+  if (m_export_map) {
+    m_export_map->GetIntegerVar(K_RDM_CACHE_RESPONSES_VAR)->Set(
+        ResponseCount());
+  }
+}
+
+
+void RDMResponseCache::Increment(const char *var_name) {
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(var_name))++;
+  }
+}
+
+
+RDMResponseCache::cache_type RDMResponseCache::CacheType(uint16_t pid) {
+  switch (pid) {
+    case ola::rdm::PID_STATUS_ID_DESCRIPTION:
+    case ola::rdm::PID_SUPPORTED_PARAMETERS:
+    case ola::rdm::PID_PARAMETER_DESCRIPTION:
+    case ola::rdm::PID_PRODUCT_DETAIL_ID_LIST:
+    case ola::rdm::PID_DEVICE_MODEL_DESCRIPTION:
+    case ola::rdm::PID_MANUFACTURER_LABEL:
+    case ola::rdm::PID_LANGUAGE_CAPABILITIES:
+    case ola::rdm::PID_SOFTWARE_VERSION_LABEL:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_ID:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_LABEL:
+    case ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION:
+    case ola::rdm::PID_SENSOR_DEFINITION:
+    case ola::rdm::PID_SELF_TEST_DESCRIPTION:
+    case ola::rdm::PID_CURVE_DESCRIPTION:
+    case ola::rdm::PID_OUTPUT_RESPONSE_TIME_DESCRIPTION:
+    case ola::rdm::PID_MODULATION_FREQUENCY_DESCRIPTION:
+    case ola::rdm::PID_LOCK_STATE_DESCRIPTION:
+      return MODEL_DATA;
+    default:
+      return NOT_CACHEABLE;
+  }
+}
+
+
+RDMResponseCache::ResponseKey RDMResponseCache::MakeKey(
+    const RDMCommand *command) {
+  ResponseKey key;
+  key.sub_device = command->SubDevice();
+  key.pid = command->ParamId();
+  key.param_data.assign(reinterpret_cast<const char*>(command->ParamData()),
+                        command->ParamDataSize());
+  return key;
+}
+
+
+/*
+ * Entries are stored as sub_device,pid,param_data,response_data, the data is
+ * hex encoded.
+ */
+string RDMResponseCache::SerializeEntry(const ResponseKey &key,
+                                        const string &data) {
+  std::ostringstream str;
+  str << key.sub_device << "," << key.pid << "," << HexEncode(key.param_data)
+      << "," << HexEncode(data);
+  return str.str();
+}
+
+
+bool RDMResponseCache::ParseEntry(const string &input, ResponseKey *key,
+                                  string *data) {
+  vector<string> tokens;
+  StringSplit(input, &tokens, ",");
+  return (tokens.size() == 4 &&
+          StringToInt(tokens[0], &key->sub_device) &&
+          StringToInt(tokens[1], &key->pid) &&
+          CacheType(key->pid) == MODEL_DATA &&
+          HexDecode(tokens[2], &key->param_data) &&
+          HexDecode(tokens[3], data));
+}
+}  // namespace ola
@@ -0,0 +1,225 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCache.h
+ * Caches RDM responses that don't change for a given device model.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
+#define OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+
+namespace ola {
+
+class Preferences;
+
+/**
+ * @brief Caches the responses to RDM GETs that rarely change.
+ *
+ * Pages in the web UI fetch the same static data from each device over and
+ * over. For large rigs this can saturate slow RDM lines. The cache only holds
+ * responses which can't change unless the device model or software version
+ * changes, e.g. SUPPORTED_PARAMETERS, SENSOR_DEFINITION and the various
+ * labels and descriptions. Responses like DEVICE_INFO and SLOT_INFO can be
+ * changed from the front panel or by another controller, so they are never
+ * cached.
+ *
+ * The cached responses are tied to the device model and software version from
+ * the last DEVICE_INFO response. They are only served once a DEVICE_INFO
+ * response has been received since the device was last discovered, and are
+ * discarded if the model or software version changes.
+ *
+ * Optionally the cache can be saved to and restored from a Preferences
+ * object. Devices that haven't been discovered for K_MAX_DEVICE_AGE are
+ * dropped when the cache is loaded, so devices that have left the rig don't
+ * stay in the cache forever.
+ */
+class RDMResponseCache {
+ public:
+  /**
+   * @brief Create a new RDMResponseCache.
+   * @param export_map the ExportMap to use for stats, may be NULL.
+   * @param clock the Clock to use for the time devices were last seen. If
+   *   NULL the system clock is used.
+   */
+  explicit RDMResponseCache(ExportMap *export_map = NULL,
+                            const Clock *clock = NULL);
+
+  /**
+   * @brief Check the cache for a response.
+   * @param request the RDMRequest.
+   * @returns a new RDMResponse for the request, or NULL if there was no
+   *   cached response. Ownership of the response is transferred.
+   */
+  ola::rdm::RDMResponse *Lookup(const ola::rdm::RDMRequest *request);
+
+  /**
+   * @brief Check if the reply to a request should be passed to
+   *   ReplyReceived().
+   * @param request the RDMRequest.
+   * @returns true if the reply can update the cache.
+   */
+  bool ShouldObserve(const ola::rdm::RDMRequest *request) const;
+
+  /**
+   * @brief Called when a request is sent.
+   * @param request the RDMRequest.
+   *
+   * A SET of LANGUAGE invalidates the cached responses, since the labels and
+   * descriptions may be localized.
+   */
+  void RequestSent(const ola::rdm::RDMRequest *request);
+
+  /**
+   * @brief Called when the reply to a request is received.
+   * @param request the RDMRequest.
+   * @param reply the RDMReply.
+   */
+  void ReplyReceived(const ola::rdm::RDMRequest *request,
+                     const ola::rdm::RDMReply *reply);
+
+  /**
+   * @brief Called when a device is found during discovery.
+   * @param uid the UID of the device.
+   *
+   * This should be called each time the device is seen during discovery.
+   * The device may have been replaced or updated, so the cached responses
+   * won't be used until the next DEVICE_INFO. This also updates the time the
+   * device was last seen.
+   */
+  void DeviceDiscovered(const ola::rdm::UID &uid);
+
+  /**
+   * @brief Remove all cached responses for a device.
+   * @param uid the UID of the device.
+   */
+  void RemoveDevice(const ola::rdm::UID &uid);
+
+  /**
+   * @brief The number of cached responses.
+   */
+  unsigned int ResponseCount() const;
+
+  /**
+   * @brief Restore the cache from a Preferences object.
+   * @param preferences the Preferences to load from.
+   *
+   * Devices that were last seen more than K_MAX_DEVICE_AGE seconds ago are
+   * skipped.
+   */
+  void Load(const Preferences &preferences);
+
+  /**
+   * @brief Save the cache to a Preferences object.
+   * @param preferences the Preferences to save to.
+   * @returns true if the cache had changed since the last Save() and the
+   *   preferences were updated.
+   */
+  bool Save(Preferences *preferences);
+
+  static const char K_RDM_CACHE_HITS_VAR[];
+  static const char K_RDM_CACHE_MISSES_VAR[];
+  static const char K_RDM_CACHE_RESPONSES_VAR[];
+
+  /**
+   * @brief The time in seconds after which a device that hasn't been seen
+   *   is dropped, 30 days.
+   */
+  static const unsigned int K_MAX_DEVICE_AGE = 30 * 24 * 60 * 60;
+
+ private:
+  typedef enum {
+    NOT_CACHEABLE,
+    MODEL_DATA,
+  } cache_type;
+
+  struct ResponseKey {
+    uint16_t sub_device;
+    uint16_t pid;
+    std::string param_data;
+
+    bool operator<(const ResponseKey &other) const;
+  };
+
+  typedef std::map<ResponseKey, std::string> ResponseMap;
+
+  struct Device {
+    Device()
+        : model_known(false),
+          verified(false),
+          model(0),
+          software_version(0),
+          last_seen(0) {
+    }
+
+    // True if we know the model & software version.
+    bool model_known;
+    // True if the model & software version have been confirmed since the
+    // device was discovered.
+    bool verified;
+    uint16_t model;
+    uint32_t software_version;
+    // The last time the device was discovered or answered a DEVICE_INFO, in
+    // seconds since the epoch.
+    unsigned int last_seen;
+    ResponseMap model_data;
+  };
+
+  typedef std::map<ola::rdm::UID, Device> DeviceMap;
+
+  DeviceMap m_devices;
+  ExportMap *m_export_map;
+  Clock m_system_clock;
+  const Clock *m_clock;
+  bool m_dirty;
+
+  unsigned int Now() const;
+  void Seen(Device *device);
+  void InvalidateDevice(uint16_t pid, Device *device);
+  void UpdateDeviceInfo(const ola::rdm::UID &uid, Device *device,
+                        const ola::rdm::RDMResponse *response);
+  void UpdateResponseCount();
+  void Increment(const char *var_name);
+
+  static cache_type CacheType(uint16_t pid);
+  static ResponseKey MakeKey(const ola::rdm::RDMCommand *command);
+  static std::string SerializeEntry(const ResponseKey &key,
+                                    const std::string &data);
+  static bool ParseEntry(const std::string &input, ResponseKey *key,
+                         std::string *data);
+
+  static const char DEVICE_KEY[];
+  static const char MODEL_SUFFIX[];
+  static const char SEEN_SUFFIX[];
+  // Only save the last seen time when it has moved by more than this, so a
+  // rediscovery doesn't rewrite the file each time.
+  static const unsigned int SEEN_RESOLUTION = 24 * 60 * 60;
+  static const unsigned int DEVICE_INFO_MIN_SIZE = 19;
+
+  DISALLOW_COPY_AND_ASSIGN(RDMResponseCache);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_RDMRESPONSECACHE_H_
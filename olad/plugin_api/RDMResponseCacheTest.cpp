@@ -0,0 +1,416 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RDMResponseCacheTest.cpp
+ * Test fixture for the RDMResponseCache class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Array.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/Preferences.h"
+#include "olad/plugin_api/RDMResponseCache.h"
+
+using ola::ExportMap;
+using ola::MemoryPreferences;
+using ola::RDMResponseCache;
+using ola::network::HostToNetwork;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+
+class RDMResponseCacheTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RDMResponseCacheTest);
+  CPPUNIT_TEST(testUncachedPids);
+  CPPUNIT_TEST(testModelData);
+  CPPUNIT_TEST(testSoftwareVersionChange);
+  CPPUNIT_TEST(testQueuedMessages);
+  CPPUNIT_TEST(testPersistence);
+  CPPUNIT_TEST(testExpiry);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RDMResponseCacheTest()
+      : m_source(1, 2),
+        m_device(0x7a70, 1),
+        m_other_device(0x7a70, 2) {
+  }
+
+  void testUncachedPids();
+  void testModelData();
+  void testSoftwareVersionChange();
+  void testQueuedMessages();
+  void testPersistence();
+  void testExpiry();
+
+ private:
+  UID m_source;
+  UID m_device;
+  UID m_other_device;
+
+  RDMRequest *NewGet(const UID &uid, uint16_t pid,
+                     const string &param_data = "") {
+    return new RDMGetRequest(
+        m_source, uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE, pid,
+        reinterpret_cast<const uint8_t*>(param_data.data()),
+        param_data.size());
+  }
+
+  RDMRequest *NewSet(const UID &uid, uint16_t pid) {
+    uint8_t data = 1;
+    return new RDMSetRequest(m_source, uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                             pid, &data, sizeof(data));
+  }
+
+  /*
+   * Send a request through the cache, replying with data if it wasn't cached.
+   * Returns true if the response came from the cache.
+   */
+  bool SendRequest(RDMResponseCache *cache, RDMRequest *request_ptr,
+                   const string &data, uint8_t message_count = 0) {
+    auto_ptr<RDMRequest> request(request_ptr);
+    auto_ptr<RDMResponse> response(cache->Lookup(request.get()));
+    if (response.get()) {
+      OLA_ASSERT_EQ(request->ParamId(), response->ParamId());
+      OLA_ASSERT_DATA_EQUALS(
+          reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+          response->ParamData(), response->ParamDataSize());
+      return true;
+    }
+
+    cache->RequestSent(request.get());
+    if (cache->ShouldObserve(request.get())) {
+      RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                     ola::rdm::GetResponseFromData(
+                         request.get(),
+                         reinterpret_cast<const uint8_t*>(data.data()),
+                         data.size(), ola::rdm::RDM_ACK, message_count));
+      cache->ReplyReceived(request.get(), &reply);
+    }
+    return false;
+  }
+
+  string DeviceInfo(uint16_t model, uint32_t software_version) {
+    uint8_t data[19];
+    memset(data, 0, sizeof(data));
+    model = HostToNetwork(model);
+    software_version = HostToNetwork(software_version);
+    memcpy(data + 2, &model, sizeof(model));
+    memcpy(data + 6, &software_version, sizeof(software_version));
+    return string(reinterpret_cast<char*>(data), sizeof(data));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RDMResponseCacheTest);
+
+
+/*
+ * Check responses which can change while the device is running aren't cached.
+ */
+void RDMResponseCacheTest::testUncachedPids() {
+  ExportMap export_map;
+  RDMResponseCache cache(&export_map);
+  const string data("\x00\x00\x01\x00\x01", 5);
+
+  const uint16_t pids[] = {
+    ola::rdm::PID_DEVICE_INFO,
+    ola::rdm::PID_SLOT_INFO,
+    ola::rdm::PID_SLOT_DESCRIPTION,
+    ola::rdm::PID_DEFAULT_SLOT_VALUE,
+    ola::rdm::PID_DEVICE_LABEL,
+  };
+
+  SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+              DeviceInfo(1, 100));
+  for (unsigned int i = 0; i < arraysize(pids); i++) {
+    OLA_ASSERT_FALSE(SendRequest(&cache, NewGet(m_device, pids[i]), data));
+    OLA_ASSERT_FALSE(SendRequest(&cache, NewGet(m_device, pids[i]), data));
+  }
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+  OLA_ASSERT_EQ(
+      0u, export_map.GetCounterVar(RDMResponseCache::K_RDM_CACHE_HITS_VAR)
+      ->Get());
+
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_MANUFACTURER_LABEL), "foo"));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_MANUFACTURER_LABEL), "foo"));
+  OLA_ASSERT_EQ(
+      1u, export_map.GetCounterVar(RDMResponseCache::K_RDM_CACHE_HITS_VAR)
+      ->Get());
+  OLA_ASSERT_EQ(
+      1,
+      export_map.GetIntegerVar(RDMResponseCache::K_RDM_CACHE_RESPONSES_VAR)
+      ->Get());
+}
+
+
+/*
+ * Check model data is only used once DEVICE_INFO has been seen.
+ */
+void RDMResponseCacheTest::testModelData() {
+  RDMResponseCache cache;
+  const string label("Model 1");
+
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+      DeviceInfo(1, 100)));
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  // The parameter data is part of the key
+  const string description("\x00\x01\x02\x00", 4);
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache,
+      NewGet(m_device, ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION,
+             string(1, 1)),
+      description));
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache,
+      NewGet(m_device, ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION,
+             string(1, 2)),
+      description));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache,
+      NewGet(m_device, ola::rdm::PID_DMX_PERSONALITY_DESCRIPTION,
+             string(1, 1)),
+      description));
+
+  // SETs don't affect the model data, unless the language changes
+  SendRequest(&cache, NewSet(m_device, ola::rdm::PID_DMX_PERSONALITY), "");
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  SendRequest(&cache, NewSet(m_device, ola::rdm::PID_LANGUAGE), "");
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  // After discovery, model data isn't used until DEVICE_INFO is fetched.
+  cache.DeviceDiscovered(m_device);
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+      DeviceInfo(1, 100)));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  cache.RemoveDevice(m_device);
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+}
+
+
+/*
+ * Check a change in software version discards the model data.
+ */
+void RDMResponseCacheTest::testSoftwareVersionChange() {
+  RDMResponseCache cache;
+  const string label("Model 1");
+
+  SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+              DeviceInfo(1, 100));
+  SendRequest(&cache,
+              NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION), label);
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  cache.DeviceDiscovered(m_device);
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+      DeviceInfo(1, 101)));
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+}
+
+
+/*
+ * Check that queued messages invalidate the cache.
+ */
+void RDMResponseCacheTest::testQueuedMessages() {
+  RDMResponseCache cache;
+  const string label("Model 1");
+
+  SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+              DeviceInfo(1, 100));
+  SendRequest(&cache,
+              NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION), label);
+  OLA_ASSERT_EQ(1u, cache.ResponseCount());
+
+  // A response with a message count doesn't affect the cached responses.
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_SLOT_INFO), "", 1));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+
+  // A queued message for a cached PID clears everything.
+  auto_ptr<RDMRequest> request(
+      NewGet(m_device, ola::rdm::PID_QUEUED_MESSAGE, string(1, 2)));
+  OLA_ASSERT_TRUE(cache.ShouldObserve(request.get()));
+  RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                 ola::rdm::GetResponseWithPid(
+                     request.get(), ola::rdm::PID_DEVICE_MODEL_DESCRIPTION,
+                     reinterpret_cast<const uint8_t*>(label.data()),
+                     label.size()));
+  cache.ReplyReceived(request.get(), &reply);
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+}
+
+
+/*
+ * Check the model data can be saved and restored.
+ */
+void RDMResponseCacheTest::testPersistence() {
+  MemoryPreferences preferences("rdm-cache");
+  const string label("Model 1");
+  const string sensor("\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+                      "Temp", 17);
+
+  {
+    RDMResponseCache cache;
+    OLA_ASSERT_FALSE(cache.Save(&preferences));
+
+    SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+                DeviceInfo(1, 100));
+    SendRequest(&cache,
+                NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+                label);
+    SendRequest(&cache,
+                NewGet(m_device, ola::rdm::PID_SENSOR_DEFINITION,
+                       string(1, 0)),
+                sensor);
+    OLA_ASSERT_TRUE(cache.Save(&preferences));
+    OLA_ASSERT_FALSE(cache.Save(&preferences));
+  }
+
+  OLA_ASSERT_EQ(m_device.ToString(), preferences.GetValue("uid"));
+  OLA_ASSERT_EQ(string("0001,00000064"),
+                preferences.GetValue(m_device.ToString() + "-model"));
+  OLA_ASSERT_EQ(static_cast<size_t>(2),
+                preferences.GetMultipleValue(m_device.ToString()).size());
+
+  RDMResponseCache cache;
+  cache.Load(preferences);
+  // Only the model data is saved.
+  OLA_ASSERT_EQ(2u, cache.ResponseCount());
+
+  // It's not used until the device is verified.
+  cache.DeviceDiscovered(m_device);
+  OLA_ASSERT_FALSE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+              DeviceInfo(1, 100));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache, NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+      label));
+  OLA_ASSERT_TRUE(SendRequest(
+      &cache,
+      NewGet(m_device, ola::rdm::PID_SENSOR_DEFINITION, string(1, 0)),
+      sensor));
+}
+
+
+/*
+ * Check devices that haven't been seen for a long time are dropped when the
+ * cache is loaded.
+ */
+void RDMResponseCacheTest::testExpiry() {
+  const int32_t DAY = 24 * 60 * 60;
+  MemoryPreferences preferences("rdm-cache");
+  ola::MockClock clock;
+  const string label("Model 1");
+
+  {
+    RDMResponseCache cache(NULL, &clock);
+    SendRequest(&cache, NewGet(m_device, ola::rdm::PID_DEVICE_INFO),
+                DeviceInfo(1, 100));
+    SendRequest(&cache,
+                NewGet(m_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+                label);
+    SendRequest(&cache, NewGet(m_other_device, ola::rdm::PID_DEVICE_INFO),
+                DeviceInfo(2, 100));
+    SendRequest(&cache,
+                NewGet(m_other_device, ola::rdm::PID_DEVICE_MODEL_DESCRIPTION),
+                label);
+    OLA_ASSERT_TRUE(cache.Save(&preferences));
+
+    // m_device keeps being discovered, m_other_device has gone.
+    clock.AdvanceTime(20 * DAY, 0);
+    cache.DeviceDiscovered(m_device);
+    OLA_ASSERT_TRUE(cache.Save(&preferences));
+
+    // Small changes to the last seen time don't need a save.
+    clock.AdvanceTime(60 * 60, 0);
+    cache.DeviceDiscovered(m_device);
+    OLA_ASSERT_FALSE(cache.Save(&preferences));
+  }
+
+  clock.AdvanceTime(15 * DAY, 0);
+  {
+    RDMResponseCache cache(NULL, &clock);
+    cache.Load(preferences);
+    OLA_ASSERT_EQ(1u, cache.ResponseCount());
+
+    // The next save removes the expired device.
+    OLA_ASSERT_TRUE(cache.Save(&preferences));
+    OLA_ASSERT_EQ(static_cast<size_t>(1),
+                  preferences.GetMultipleValue("uid").size());
+    OLA_ASSERT_EQ(m_device.ToString(), preferences.GetValue("uid"));
+  }
+
+  // Caches saved without the last seen time keep their devices.
+  preferences.RemoveValue(m_device.ToString() + "-seen");
+  clock.AdvanceTime(100 * DAY, 0);
+  RDMResponseCache cache(NULL, &clock);
+  cache.Load(preferences);
+  OLA_ASSERT_EQ(1u, cache.ResponseCount());
+  OLA_ASSERT_FALSE(cache.Save(&preferences));
+}
@@ -49,6 +49,7 @@
 #include "olad/Port.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/RDMResponseCache.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
@@ -56,6 +57,7 @@ namespace ola {
 using ola::rdm::RDMDiscoveryCallback;
 using ola::rdm::RDMReply;
 using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
 using ola::rdm::RunRDMCallback;
 using ola::rdm::UID;
 using ola::strings::ToHex;
@@ -67,6 +69,8 @@ using std::string;
 using std::vector;
 
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
+const char Universe::K_UNIVERSE_UID_LIST_TIME_VAR[] =
+    "universe-first-uid-list-ms";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
 const char Universe::K_MERGE_LTP_STR[] = "ltp";
@@ -84,10 +88,13 @@ const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
  * @param uid  the universe id of this universe
  * @param store the store this universe came from
  * @param export_map the ExportMap that we update
+ * @param clock the Clock to use
+ * @param rdm_cache the cache of RDM responses, may be NULL
  */
 Universe::Universe(unsigned int universe_id, UniverseStore *store,
                    ExportMap *export_map,
-                   Clock *clock)
+                   Clock *clock,
+                   RDMResponseCache *rdm_cache)
     : m_universe_name(""),
       m_universe_id(universe_id),
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
@@ -95,8 +102,10 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
       m_universe_store(store),
       m_export_map(export_map),
       m_clock(clock),
+      m_rdm_cache(rdm_cache),
       m_rdm_discovery_interval(),
-      m_last_discovery_time() {
+      m_last_discovery_time(),
+      m_first_uid_list_seen(false) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -114,6 +123,7 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UID_LIST_TIME_VAR,
   };
 
   if (m_export_map) {
@@ -125,6 +135,7 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
   // We set the last discovery time to now, since most ports will trigger
   // discovery when they are patched.
   clock->CurrentTime(&m_last_discovery_time);
+  m_creation_time = m_last_discovery_time;
 }
 
 
@@ -145,6 +156,7 @@ Universe::~Universe() {
     K_UNIVERSE_SINK_CLIENTS_VAR,
     K_UNIVERSE_SOURCE_CLIENTS_VAR,
     K_UNIVERSE_UID_COUNT_VAR,
+    K_UNIVERSE_UID_LIST_TIME_VAR,
   };
 
   if (m_export_map) {
@@ -482,6 +494,9 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
         ola::rdm::RDM_PLUGIN_DISCOVERY_NOT_SUPPORTED :
         ola::rdm::RDM_WAS_BROADCAST);
     tracker->callback = callback;
+    if (m_rdm_cache) {
+      m_rdm_cache->RequestSent(request.get());
+    }
     vector<OutputPort*>::iterator port_iter;
 
     for (port_iter = m_output_ports.begin(); port_iter != m_output_ports.end();
@@ -506,7 +521,27 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
     if (iter == m_output_uids.end()) {
       OLA_WARN << "Can't find UID " << request->DestinationUID()
                << " in the output universe map, dropping request";
+      Universe *universe = m_universe_store->GetUniverseForUID(
+          request->DestinationUID());
+      if (universe) {
+        OLA_INFO << request->DestinationUID() << " was discovered on universe "
+                 << universe->UniverseId();
+      }
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
+    } else if (m_rdm_cache) {
+      RDMResponse *response = m_rdm_cache->Lookup(request.get());
+      if (response) {
+        RDMReply reply(ola::rdm::RDM_COMPLETED_OK, response);
+        callback->Run(&reply);
+        return;
+      }
+
+      m_rdm_cache->RequestSent(request.get());
+      if (m_rdm_cache->ShouldObserve(request.get())) {
+        callback = NewSingleCallback(this, &Universe::HandleCachedRDMReply,
+                                     request->Duplicate(), callback);
+      }
+      iter->second->SendRDMRequest(request.release(), callback);
     } else {
       iter->second->SendRDMRequest(request.release(), callback);
     }
@@ -563,22 +598,54 @@ void Universe::RunRDMDiscovery(RDMDiscoveryCallback *on_complete, bool full) {
  * Update the UID : port mapping with this new data
  */
 void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
+  // Both the map and the set are sorted, so walk them together.
   map<UID, OutputPort*>::iterator iter = m_output_uids.begin();
-  while (iter != m_output_uids.end()) {
-    if (iter->second == port && !uids.Contains(iter->first)) {
-      m_output_uids.erase(iter++);
+  ola::rdm::UIDSet::Iterator set_iter = uids.Begin();
+  while (iter != m_output_uids.end() || set_iter != uids.End()) {
+    if (set_iter == uids.End() ||
+        (iter != m_output_uids.end() && iter->first < *set_iter)) {
+      // not in the new list
+      if (iter->second == port) {
+        m_universe_store->UIDRemoved(this, iter->first);
+        if (m_rdm_cache) {
+          m_rdm_cache->RemoveDevice(iter->first);
+        }
+        m_output_uids.erase(iter++);
+      } else {
+        ++iter;
+      }
+    } else if (iter == m_output_uids.end() || *set_iter < iter->first) {
+      // a new UID
+      m_output_uids.insert(iter, std::make_pair(*set_iter, port));
+      m_universe_store->UIDAdded(this, *set_iter);
+      if (m_rdm_cache) {
+        m_rdm_cache->DeviceDiscovered(*set_iter);
+      }
+      ++set_iter;
     } else {
+      if (iter->second != port) {
+        OLA_WARN << "UID " << *set_iter << " seen on more than one port";
+      }
+      // The device may have changed since it was last seen.
+      if (m_rdm_cache) {
+        m_rdm_cache->DeviceDiscovered(*set_iter);
+      }
       ++iter;
+      ++set_iter;
     }
   }
 
-  ola::rdm::UIDSet::Iterator set_iter = uids.Begin();
-  for (; set_iter != uids.End(); ++set_iter) {
-    iter = m_output_uids.find(*set_iter);
-    if (iter == m_output_uids.end()) {
-      m_output_uids[*set_iter] = port;
-    } else if (iter->second != port) {
-      OLA_WARN << "UID " << *set_iter << " seen on more than one port";
+  if (!m_first_uid_list_seen && !uids.Empty()) {
+    // Track how long it takes for RDM devices to become available.
+    m_first_uid_list_seen = true;
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    TimeInterval delay = now - m_creation_time;
+    OLA_INFO << "Universe " << m_universe_id << " has its first UIDs after "
+             << delay;
+    if (m_export_map) {
+      (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_LIST_TIME_VAR))[
+          m_universe_id_str] = delay.InMilliSeconds();
     }
   }
 
@@ -600,6 +667,19 @@ void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
 }
 
 
+/*
+ * Returns the UIDs that were discovered on a particular port
+ */
+void Universe::GetUIDs(const OutputPort *port, ola::rdm::UIDSet *uids) const {
+  map<UID, OutputPort*>::const_iterator iter = m_output_uids.begin();
+  for (; iter != m_output_uids.end(); ++iter) {
+    if (iter->second == port) {
+      uids->AddUID(iter->first);
+    }
+  }
+}
+
+
 /**
  * Return the number of uids in the universe
  */
@@ -816,6 +896,19 @@ void Universe::DiscoveryComplete(RDMDiscoveryCallback *on_complete) {
 }
 
 
+/*
+ * Pass the reply to a unicast request to the RDM cache before running the
+ * original callback.
+ */
+void Universe::HandleCachedRDMReply(RDMRequest *request_ptr,
+                                    ola::rdm::RDMCallback *callback,
+                                    RDMReply *reply) {
+  auto_ptr<RDMRequest> request(request_ptr);
+  m_rdm_cache->ReplyReceived(request.get(), reply);
+  callback->Run(reply);
+}
+
+
 /**
  * Track fan-out responses for a broadcast request.
  * This increments the port counter until we reach the expected value, and
@@ -958,6 +1051,10 @@ bool Universe::GenericRemovePort(PortClass *port,
     typename map<UID, PortClass*>::iterator uid_iter = uid_map->begin();
     while (uid_iter != uid_map->end()) {
       if (uid_iter->second == port) {
+        m_universe_store->UIDRemoved(this, uid_iter->first);
+        if (m_rdm_cache) {
+          m_rdm_cache->RemoveDevice(uid_iter->first);
+        }
         uid_map->erase(uid_iter++);
       } else {
         ++uid_iter;
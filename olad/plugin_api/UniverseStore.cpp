@@ -21,6 +21,7 @@
 
 #include "olad/plugin_api/UniverseStore.h"
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <sstream>
@@ -45,9 +46,11 @@ using std::vector;
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
 
 UniverseStore::UniverseStore(Preferences *preferences,
-                             ExportMap *export_map)
+                             ExportMap *export_map,
+                             RDMResponseCache *rdm_cache)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_rdm_cache(rdm_cache) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
@@ -59,6 +62,7 @@ UniverseStore::UniverseStore(Preferences *preferences,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
       Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR,
       Universe::K_UNIVERSE_UID_COUNT_VAR,
+      Universe::K_UNIVERSE_UID_LIST_TIME_VAR,
     };
 
     for (unsigned int i = 0; i < sizeof(vars) / sizeof(vars[0]); ++i) {
@@ -80,7 +84,8 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
       &m_universe_map, universe_id);
 
   if (!iter->second) {
-    iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
+    iter->second = new Universe(universe_id, this, m_export_map, &m_clock,
+                                m_rdm_cache);
 
     if (iter->second) {
       if (m_preferences) {
@@ -93,6 +98,32 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
   return iter->second;
 }
 
+Universe *UniverseStore::GetUniverseForUID(const ola::rdm::UID &uid) const {
+  UIDIndex::const_iterator iter = m_uid_index.find(uid);
+  return iter == m_uid_index.end() ? NULL : iter->second.back();
+}
+
+void UniverseStore::UIDAdded(Universe *universe, const ola::rdm::UID &uid) {
+  vector<Universe*> &universes = m_uid_index[uid];
+  universes.erase(std::remove(universes.begin(), universes.end(), universe),
+                  universes.end());
+  universes.push_back(universe);
+}
+
+void UniverseStore::UIDRemoved(Universe *universe, const ola::rdm::UID &uid) {
+  UIDIndex::iterator iter = m_uid_index.find(uid);
+  if (iter == m_uid_index.end()) {
+    return;
+  }
+
+  vector<Universe*> &universes = iter->second;
+  universes.erase(std::remove(universes.begin(), universes.end(), universe),
+                  universes.end());
+  if (universes.empty()) {
+    m_uid_index.erase(iter);
+  }
+}
+
 void UniverseStore::GetList(vector<Universe*> *universes) const {
   STLValues(m_universe_map, universes);
 }
@@ -100,12 +131,15 @@ void UniverseStore::GetList(vector<Universe*> *universes) const {
 void UniverseStore::DeleteAll() {
   UniverseMap::iterator iter;
 
+  vector<Universe*> universes;
+  STLValues(m_universe_map, &universes);
+  SaveUniverseSettings(universes);
   for (iter = m_universe_map.begin(); iter != m_universe_map.end(); iter++) {
-    SaveUniverseSettings(iter->second);
     delete iter->second;
   }
   m_deletion_candiates.clear();
   m_universe_map.clear();
+  m_uid_index.clear();
 }
 
 void UniverseStore::AddUniverseGarbageCollection(Universe *universe) {
@@ -116,15 +150,25 @@ void UniverseStore::GarbageCollectUniverses() {
   set<Universe*>::iterator iter;
   UniverseMap::iterator map_iter;
 
+  vector<Universe*> inactive_universes;
   for (iter = m_deletion_candiates.begin();
        iter != m_deletion_candiates.end(); iter++) {
     if (!(*iter)->IsActive()) {
-      SaveUniverseSettings(*iter);
-      m_universe_map.erase((*iter)->UniverseId());
-      delete *iter;
+      inactive_universes.push_back(*iter);
     }
   }
   m_deletion_candiates.clear();
+
+  if (inactive_universes.empty()) {
+    return;
+  }
+
+  SaveUniverseSettings(inactive_universes);
+  vector<Universe*>::iterator universe_iter = inactive_universes.begin();
+  for (; universe_iter != inactive_universes.end(); ++universe_iter) {
+    m_universe_map.erase((*universe_iter)->UniverseId());
+    delete *universe_iter;
+  }
 }
 
 
@@ -185,16 +229,30 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
 }
 
 
+void UniverseStore::SaveUniverseSettings(
+    const vector<Universe*> &universes) const {
+  if (!m_preferences || universes.empty()) {
+    return;
+  }
+
+  vector<Universe*>::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    WriteUniverseSettings(*iter);
+  }
+  m_preferences->Save();
+}
+
+
 /*
- * Save this universe's settings.
+ * Write this universe's settings to the preferences.
  * @param universe, the universe to save
  */
-bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
+void UniverseStore::WriteUniverseSettings(Universe *universe) const {
   string key, mode;
   std::ostringstream oss;
 
-  if (!universe || !m_preferences)
-    return 0;
+  if (!universe)
+    return;
 
   oss << std::dec << universe->UniverseId();
 
@@ -209,9 +267,5 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
 
   // We don't save the RDM Discovery interval since it can only be set in the
   // config files for now.
-
-  m_preferences->Save();
-
-  return 0;
 }
 }  // namespace ola
@@ -21,13 +21,20 @@
 #ifndef OLAD_PLUGIN_API_UNIVERSESTORE_H_
 #define OLAD_PLUGIN_API_UNIVERSESTORE_H_
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <map>
 #include <set>
 #include <string>
 #include <vector>
 
+#include HASH_MAP_H
+
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/rdm/UID.h"
 
 namespace ola {
 
@@ -42,8 +49,11 @@ class UniverseStore {
    * @brief Create a new UniverseStore.
    * @param preferences The Preferences store.
    * @param export_map the ExportMap to use for stats, may be NULL.
+   * @param rdm_cache the RDMResponseCache to pass to new universes, may be
+   *   NULL.
    */
-  UniverseStore(class Preferences *preferences, class ExportMap *export_map);
+  UniverseStore(class Preferences *preferences, class ExportMap *export_map,
+                class RDMResponseCache *rdm_cache = NULL);
 
   /**
    * @brief Destructor.
@@ -64,6 +74,35 @@ class UniverseStore {
    */
   Universe *GetUniverseOrCreate(unsigned int universe_id);
 
+  /**
+   * @brief Lookup the universe a RDM device was discovered on.
+   * @param uid the UID of the device.
+   * @return the universe, or NULL if the UID hasn't been discovered.
+   *
+   * If a UID is present on more than one universe, the one it was most
+   * recently discovered on is returned.
+   */
+  Universe *GetUniverseForUID(const ola::rdm::UID &uid) const;
+
+  /**
+   * @brief Called by a Universe when a UID is discovered on one of its ports.
+   * @param universe the Universe the UID was discovered on.
+   * @param uid the UID of the device.
+   */
+  void UIDAdded(Universe *universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Called by a Universe when a UID is no longer present.
+   * @param universe the Universe the UID was removed from.
+   * @param uid the UID of the device.
+   */
+  void UIDRemoved(Universe *universe, const ola::rdm::UID &uid);
+
+  /**
+   * @brief Return the number of distinct UIDs across all universes.
+   */
+  unsigned int UIDCount() const { return m_uid_index.size(); }
+
   /**
    * @brief Return the number of universes.
    */
@@ -92,18 +131,40 @@ class UniverseStore {
    */
   void GarbageCollectUniverses();
 
+  /**
+   * @brief Save the settings for a list of universes.
+   * @param universes the universes to save.
+   *
+   * The preferences are saved once, after all the universes have been
+   * updated.
+   */
+  void SaveUniverseSettings(const std::vector<Universe*> &universes) const;
+
  private:
   typedef std::map<unsigned int, Universe*> UniverseMap;
+  struct UIDHash {
+    size_t operator()(const ola::rdm::UID &uid) const {
+      return (static_cast<size_t>(uid.ManufacturerId()) << 16) ^
+          uid.DeviceId();
+    }
+  };
+
+  // The universes each UID is present on, most recently discovered last.
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<ola::rdm::UID,
+                                         std::vector<Universe*>,
+                                         UIDHash> UIDIndex;
 
   Preferences *m_preferences;
   ExportMap *m_export_map;
+  class RDMResponseCache *m_rdm_cache;
   UniverseMap m_universe_map;
+  UIDIndex m_uid_index;
   std::set<Universe*> m_deletion_candiates;  // list of universes we may be
                                              // able to delete
   Clock m_clock;
 
   bool RestoreUniverseSettings(Universe *universe) const;
-  bool SaveUniverseSettings(Universe *universe) const;
+  void WriteUniverseSettings(Universe *universe) const;
 
   static const unsigned int MINIMUM_RDM_DISCOVERY_INTERVAL;
 
@@ -18,6 +18,7 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <iostream>
 #include <string>
@@ -39,6 +40,7 @@
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/RDMResponseCache.h"
 #include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
 #include "ola/testing/TestUtils.h"
@@ -64,6 +66,7 @@ using std::vector;
 
 static unsigned int TEST_UNIVERSE = 1;
 static const char TEST_DATA[] = "this is some test data";
+static const unsigned int RDM_DATA_SIZE = 19;
 
 
 class UniverseTest: public CppUnit::TestFixture {
@@ -77,7 +80,9 @@ class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testLtpMerging);
   CPPUNIT_TEST(testHtpMerging);
   CPPUNIT_TEST(testRDMDiscovery);
+  CPPUNIT_TEST(testUIDIndex);
   CPPUNIT_TEST(testRDMSend);
+  CPPUNIT_TEST(testRDMCache);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -92,13 +97,16 @@ class UniverseTest: public CppUnit::TestFixture {
   void testLtpMerging();
   void testHtpMerging();
   void testRDMDiscovery();
+  void testUIDIndex();
   void testRDMSend();
+  void testRDMCache();
 
  private:
   ola::MemoryPreferences *m_preferences;
   ola::UniverseStore *m_store;
   DmxBuffer m_buffer;
   ola::Clock m_clock;
+  unsigned int m_rdm_requests;
 
   void ConfirmUIDs(UIDSet *expected, const UIDSet &uids);
 
@@ -113,6 +121,37 @@ class UniverseTest: public CppUnit::TestFixture {
     delete request;
     RunRDMCallback(callback, status_code);
   }
+
+  void ReturnRDMData(const RDMRequest *request,
+                     RDMCallback *callback) {
+    // This is long enough to be a valid DEVICE_INFO response.
+    uint8_t data[RDM_DATA_SIZE];
+    memset(data, 0, sizeof(data));
+    m_rdm_requests++;
+    RDMReply reply(ola::rdm::RDM_COMPLETED_OK,
+                   ola::rdm::GetResponseFromData(request, data,
+                                                 sizeof(data)));
+    delete request;
+    callback->Run(&reply);
+  }
+
+  void SendCachedRequest(Universe *universe, const UID &source,
+                         const UID &destination, uint16_t pid) {
+    universe->SendRDMRequest(
+        new ola::rdm::RDMGetRequest(source, destination, 0, 1, 0, pid,
+                                    NULL, 0),
+        NewSingleCallback(this, &UniverseTest::ConfirmCachedRDM, pid));
+  }
+
+  void ConfirmCachedRDM(uint16_t pid, RDMReply *reply) {
+    std::ostringstream str;
+    str << "PID " << pid;
+    OLA_ASSERT_EQ_MSG(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode(),
+                      str.str());
+    OLA_ASSERT_NOT_NULL(reply->Response());
+    OLA_ASSERT_EQ_MSG(RDM_DATA_SIZE, reply->Response()->ParamDataSize(),
+                      str.str());
+  }
 };
 
 
@@ -553,6 +592,8 @@ void UniverseTest::testRDMDiscovery() {
   OLA_ASSERT_EQ(1u, universe_uids.Size());
   OLA_ASSERT(universe_uids.Contains(uid2));
   OLA_ASSERT(universe->IsActive());
+  OLA_ASSERT_EQ(universe, m_store->GetUniverseForUID(uid2));
+  OLA_ASSERT_NULL(m_store->GetUniverseForUID(uid1));
 
   // now trigger discovery
   UIDSet expected_uids;
@@ -574,6 +615,12 @@ void UniverseTest::testRDMDiscovery() {
     NewSingleCallback(this, &UniverseTest::ConfirmUIDs, &expected_uids),
     true);
 
+  // the server wide index follows the discovery results
+  OLA_ASSERT_EQ(2u, m_store->UIDCount());
+  OLA_ASSERT_EQ(universe, m_store->GetUniverseForUID(uid1));
+  OLA_ASSERT_NULL(m_store->GetUniverseForUID(uid2));
+  OLA_ASSERT_EQ(universe, m_store->GetUniverseForUID(uid3));
+
   // remove the first port from the universe and confirm there are no more UIDs
   universe->RemovePort(&port1);
   expected_uids.Clear();
@@ -585,6 +632,8 @@ void UniverseTest::testRDMDiscovery() {
   universe_uids.Clear();
   universe->GetUIDs(&universe_uids);
   OLA_ASSERT_EQ(0u, universe_uids.Size());
+  OLA_ASSERT_EQ(0u, m_store->UIDCount());
+  OLA_ASSERT_NULL(m_store->GetUniverseForUID(uid1));
 
   universe->RemovePort(&port2);
   OLA_ASSERT_EQ((unsigned int) 0, universe->InputPortCount());
@@ -593,6 +642,62 @@ void UniverseTest::testRDMDiscovery() {
 }
 
 
+/**
+ * Check the server wide UID index when a UID is present on more than one
+ * universe.
+ */
+void UniverseTest::testUIDIndex() {
+  Universe *universe1 = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  Universe *universe2 = m_store->GetUniverseOrCreate(TEST_UNIVERSE + 1);
+  OLA_ASSERT(universe1);
+  OLA_ASSERT(universe2);
+
+  UID uid1(0x7a70, 1);
+  UID uid2(0x7a70, 2);
+  UIDSet port1_uids, port2_uids;
+  port1_uids.AddUID(uid1);
+  port1_uids.AddUID(uid2);
+  port2_uids.AddUID(uid1);
+  TestMockRDMOutputPort port1(NULL, 1, &port1_uids, true);
+  TestMockRDMOutputPort port2(NULL, 2, &port2_uids, true);
+  universe1->AddPort(&port1);
+  port1.SetUniverse(universe1);
+  universe2->AddPort(&port2);
+  port2.SetUniverse(universe2);
+
+  // uid1 was most recently discovered on universe2.
+  OLA_ASSERT_EQ(2u, m_store->UIDCount());
+  OLA_ASSERT_EQ(universe2, m_store->GetUniverseForUID(uid1));
+  OLA_ASSERT_EQ(universe1, m_store->GetUniverseForUID(uid2));
+
+  // Removing uid1 from universe2 leaves it on universe1.
+  UIDSet expected_uids;
+  port2_uids.RemoveUID(uid1);
+  universe2->RunRDMDiscovery(
+    NewSingleCallback(this, &UniverseTest::ConfirmUIDs, &expected_uids),
+    true);
+  OLA_ASSERT_EQ(2u, m_store->UIDCount());
+  OLA_ASSERT_EQ(universe1, m_store->GetUniverseForUID(uid1));
+
+  // Put it back, then remove it from universe1.
+  port2_uids.AddUID(uid1);
+  expected_uids.AddUID(uid1);
+  universe2->RunRDMDiscovery(
+    NewSingleCallback(this, &UniverseTest::ConfirmUIDs, &expected_uids),
+    true);
+  OLA_ASSERT_EQ(universe2, m_store->GetUniverseForUID(uid1));
+
+  universe1->RemovePort(&port1);
+  OLA_ASSERT_EQ(1u, m_store->UIDCount());
+  OLA_ASSERT_EQ(universe2, m_store->GetUniverseForUID(uid1));
+  OLA_ASSERT_NULL(m_store->GetUniverseForUID(uid2));
+
+  universe2->RemovePort(&port2);
+  OLA_ASSERT_EQ(0u, m_store->UIDCount());
+  OLA_ASSERT_NULL(m_store->GetUniverseForUID(uid1));
+}
+
+
 /**
  * test Sending an RDM request
  */
@@ -800,6 +905,66 @@ void UniverseTest::testRDMSend() {
 }
 
 
+/*
+ * Check that cacheable responses are served by the RDMResponseCache.
+ */
+void UniverseTest::testRDMCache() {
+  ola::RDMResponseCache cache;
+  ola::UniverseStore store(NULL, NULL, &cache);
+  Universe *universe = store.GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  UID uid1(0x7a70, 1);
+  UIDSet port1_uids;
+  port1_uids.AddUID(uid1);
+  TestMockRDMOutputPort port1(NULL, 1, &port1_uids, true);
+  universe->AddPort(&port1);
+  port1.SetUniverse(universe);
+  port1.SetRDMHandler(NewCallback(this, &UniverseTest::ReturnRDMData));
+  m_rdm_requests = 0;
+
+  // DEVICE_INFO is never cached, but is needed before anything else is.
+  UID source_uid(0x7a70, 100);
+  SendCachedRequest(universe, source_uid, uid1, ola::rdm::PID_DEVICE_INFO);
+  SendCachedRequest(universe, source_uid, uid1, ola::rdm::PID_DEVICE_INFO);
+  OLA_ASSERT_EQ(2u, m_rdm_requests);
+  for (unsigned int i = 0; i < 3; i++) {
+    SendCachedRequest(universe, source_uid, uid1,
+                      ola::rdm::PID_MANUFACTURER_LABEL);
+  }
+  OLA_ASSERT_EQ(3u, m_rdm_requests);
+  OLA_ASSERT_EQ(1u, cache.ResponseCount());
+
+  // If the device is found again, the cached response isn't used until
+  // DEVICE_INFO is fetched.
+  universe->RunRDMDiscovery(NULL, true);
+  SendCachedRequest(universe, source_uid, uid1,
+                    ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(4u, m_rdm_requests);
+  SendCachedRequest(universe, source_uid, uid1, ola::rdm::PID_DEVICE_INFO);
+  SendCachedRequest(universe, source_uid, uid1,
+                    ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(5u, m_rdm_requests);
+
+  // Devices which are no longer present are removed.
+  port1_uids.RemoveUID(uid1);
+  universe->RunRDMDiscovery(NULL, true);
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+
+  // As are devices on ports which are unpatched.
+  port1_uids.AddUID(uid1);
+  universe->RunRDMDiscovery(NULL, true);
+  SendCachedRequest(universe, source_uid, uid1, ola::rdm::PID_DEVICE_INFO);
+  SendCachedRequest(universe, source_uid, uid1,
+                    ola::rdm::PID_MANUFACTURER_LABEL);
+  OLA_ASSERT_EQ(1u, cache.ResponseCount());
+
+  universe->RemovePort(&port1);
+  OLA_ASSERT_EQ(0u, cache.ResponseCount());
+  store.DeleteAll();
+}
+
+
 /**
  * Check we got the uids we expect
  */
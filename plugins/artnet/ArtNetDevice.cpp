@@ -58,6 +58,7 @@ using std::vector;
 
 const char ArtNetDevice::K_ALWAYS_BROADCAST_KEY[] = "always_broadcast";
 const char ArtNetDevice::K_DEVICE_NAME[] = "ArtNet";
+const char ArtNetDevice::K_INPUT_PORT_KEY[] = "input_ports";
 const char ArtNetDevice::K_IP_KEY[] = "ip";
 const char ArtNetDevice::K_LIMITED_BROADCAST_KEY[] = "use_limited_broadcast";
 const char ArtNetDevice::K_LONG_NAME_KEY[] = "long_name";
@@ -68,6 +69,7 @@ const char ArtNetDevice::K_SHORT_NAME_KEY[] = "short_name";
 const char ArtNetDevice::K_SUBNET_KEY[] = "subnet";
 const unsigned int ArtNetDevice::K_ARTNET_NET = 0;
 const unsigned int ArtNetDevice::K_ARTNET_SUBNET = 0;
+const unsigned int ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT = 4;
 const unsigned int ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT = 4;
 
 ArtNetDevice::ArtNetDevice(AbstractPlugin *owner,
@@ -108,6 +110,10 @@ bool ArtNetDevice::StartHook() {
   node_options.input_port_count = StringToIntOrDefault(
       m_preferences->GetValue(K_OUTPUT_PORT_KEY),
       K_DEFAULT_OUTPUT_PORT_COUNT);
+  // OLA Input ports are ArtNet output ports
+  node_options.output_port_count = StringToIntOrDefault(
+      m_preferences->GetValue(K_INPUT_PORT_KEY),
+      K_DEFAULT_INPUT_PORT_COUNT);
 
   m_node = new ArtNetNode(iface, m_plugin_adaptor, node_options);
   m_node->SetNetAddress(net);
@@ -119,7 +125,7 @@ bool ArtNetDevice::StartHook() {
     AddPort(new ArtNetOutputPort(this, i, m_node));
   }
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < node_options.output_port_count; i++) {
     AddPort(new ArtNetInputPort(this, i, m_plugin_adaptor, m_node));
   }
 
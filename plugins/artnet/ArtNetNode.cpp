@@ -203,6 +203,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_short_name(""),
       m_long_name(""),
       m_broadcast_threshold(options.broadcast_threshold),
+      m_max_merge_sources(std::max(1u, options.max_merge_sources)),
       m_unsolicited_replies(0),
       m_ss(ss),
       m_always_broadcast(options.always_broadcast),
@@ -221,19 +222,10 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
     m_input_ports.push_back(new InputPort());
   }
 
-  // reset all the port structures
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = 0;
-    m_output_ports[i].sequence_number = 0;
-    m_output_ports[i].enabled = false;
-    m_output_ports[i].is_merging = false;
-    m_output_ports[i].merge_mode = ARTNET_MERGE_HTP;
-    m_output_ports[i].buffer = NULL;
-    m_output_ports[i].on_data = NULL;
-    m_output_ports[i].on_discover = NULL;
-    m_output_ports[i].on_flush = NULL;
-    m_output_ports[i].on_rdm_request = NULL;
+  for (unsigned int i = 0; i < options.output_port_count; i++) {
+    m_output_ports.push_back(new OutputPort(i));
   }
+  m_output_port_index.resize(PORT_ADDRESS_COUNT);
 }
 
 ArtNetNodeImpl::~ArtNetNodeImpl() {
@@ -241,20 +233,23 @@ ArtNetNodeImpl::~ArtNetNodeImpl() {
 
   STLDeleteElements(&m_input_ports);
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    if (m_output_ports[i].on_data) {
-      delete m_output_ports[i].on_data;
+  OutputPorts::iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    OutputPort *port = *iter;
+    if (port->on_data) {
+      delete port->on_data;
     }
-    if (m_output_ports[i].on_discover) {
-      delete m_output_ports[i].on_discover;
+    if (port->on_discover) {
+      delete port->on_discover;
     }
-    if (m_output_ports[i].on_flush) {
-      delete m_output_ports[i].on_flush;
+    if (port->on_flush) {
+      delete port->on_flush;
     }
-    if (m_output_ports[i].on_rdm_request) {
-      delete m_output_ports[i].on_rdm_request;
+    if (port->on_rdm_request) {
+      delete port->on_rdm_request;
     }
   }
+  STLDeleteElements(&m_output_ports);
 }
 
 bool ArtNetNodeImpl::Start() {
@@ -390,18 +385,24 @@ bool ArtNetNodeImpl::SetSubnetAddress(uint8_t subnet_address) {
     SendPollIfAllowed();
   }
 
-  // set for all output ports.
-  uint8_t old_address = m_output_ports[0].universe_address >> 4;
-  if (old_address == subnet_address && !changed) {
-    return true;
+  // set for all output ports, other than those with their own sub-net.
+  subnet_address = subnet_address << 4;
+  OutputPorts::iterator port_iter = m_output_ports.begin();
+  for (; port_iter != m_output_ports.end(); ++port_iter) {
+    if ((*port_iter)->own_subnet) {
+      continue;
+    }
+    uint8_t new_address = (
+        subnet_address | ((*port_iter)->universe_address & 0x0f));
+    changed |= (new_address != (*port_iter)->universe_address);
+    (*port_iter)->universe_address = new_address;
   }
 
-  subnet_address = subnet_address << 4;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = subnet_address |
-        (m_output_ports[i].universe_address & 0x0f);
+  if (!changed) {
+    return true;
   }
 
+  UpdateOutputPortIndex();
   return SendPollReplyIfRequired();
 }
 
@@ -409,6 +410,10 @@ uint8_t ArtNetNodeImpl::InputPortCount() const {
   return m_input_ports.size();
 }
 
+uint8_t ArtNetNodeImpl::OutputPortCount() const {
+  return m_output_ports.size();
+}
+
 bool ArtNetNodeImpl::SetInputPortUniverse(uint8_t port_id,
                                           uint8_t universe_id) {
   InputPort *port = GetInputPort(port_id);
@@ -461,6 +466,25 @@ bool ArtNetNodeImpl::SetOutputPortUniverse(uint8_t port_id,
   port->universe_address = (
       (universe_id & 0x0f) | (port->universe_address & 0xf0));
   port->enabled = true;
+  UpdateOutputPortIndex();
+  return SendPollReplyIfRequired();
+}
+
+bool ArtNetNodeImpl::SetOutputPortAddress(uint8_t port_id,
+                                          uint8_t port_address) {
+  OutputPort *port = GetOutputPort(port_id);
+  if (!port) {
+    return false;
+  }
+
+  port->own_subnet = true;
+  if (port->enabled && port->universe_address == port_address) {
+    return true;
+  }
+
+  port->universe_address = port_address;
+  port->enabled = true;
+  UpdateOutputPortIndex();
   return SendPollReplyIfRequired();
 }
 
@@ -478,6 +502,7 @@ void ArtNetNodeImpl::DisableOutputPort(uint8_t port_id) {
   bool was_enabled = port->enabled;
   port->enabled = false;
   if (was_enabled) {
+    UpdateOutputPortIndex();
     SendPollReplyIfRequired();
   }
 }
@@ -748,7 +773,7 @@ bool ArtNetNodeImpl::SetDMXHandler(uint8_t port_id,
   }
 
   if (port->on_data) {
-    delete m_output_ports[port_id].on_data;
+    delete port->on_data;
   }
   port->buffer = buffer;
   port->on_data = on_data;
@@ -890,14 +915,85 @@ bool ArtNetNodeImpl::SendPollReplyIfRequired() {
 }
 
 bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
+  // Each ArtPollReply can describe up to ARTNET_MAX_PORTS input and output
+  // ports, which must all be on the same sub-net. If we have more ports than
+  // that, or they are on different sub-nets, send one reply per page of ports
+  // and use the BindIndex to tell them apart.
+  unsigned int port_count = std::max(m_input_ports.size(),
+                                     m_output_ports.size());
+  vector<PollReplyPage> pages;
+  for (unsigned int i = 0; i < port_count; i++) {
+    const InputPort *iport = GetInputPort(i, false);
+    const OutputPort *oport = GetOutputPort(i, false);
+    int input_subnet = iport && iport->enabled ? iport->PortAddress() >> 4 : -1;
+    int output_subnet = oport && oport->enabled ?
+        oport->universe_address >> 4 : -1;
+
+    if (input_subnet != -1 && output_subnet != -1 &&
+        input_subnet != output_subnet) {
+      AddToPollReplyPage(&pages, iport, NULL, input_subnet);
+      AddToPollReplyPage(&pages, NULL, oport, output_subnet);
+    } else {
+      AddToPollReplyPage(&pages, iport, oport,
+                         std::max(input_subnet, output_subnet));
+    }
+  }
+
+  if (pages.size() <= 1 && port_count <= ARTNET_MAX_PORTS) {
+    return SendPollReplyPage(destination, 0,
+                             pages.empty() ? PollReplyPage() : pages[0]);
+  }
+
+  bool ok = true;
+  uint8_t bind_index = 1;
+  vector<PollReplyPage>::const_iterator iter = pages.begin();
+  for (; iter != pages.end(); ++iter) {
+    ok &= SendPollReplyPage(destination, bind_index++, *iter);
+  }
+  return ok;
+}
+
+void ArtNetNodeImpl::AddToPollReplyPage(vector<PollReplyPage> *pages,
+                                        const InputPort *input_port,
+                                        const OutputPort *output_port,
+                                        int subnet) const {
+  vector<PollReplyPage>::iterator iter = pages->begin();
+  for (; iter != pages->end(); ++iter) {
+    if (iter->ports.size() < ARTNET_MAX_PORTS &&
+        (subnet == -1 || iter->subnet == -1 || iter->subnet == subnet)) {
+      break;
+    }
+  }
+  if (iter == pages->end()) {
+    iter = pages->insert(pages->end(), PollReplyPage());
+  }
+  if (subnet != -1) {
+    iter->subnet = subnet;
+  }
+  iter->ports.push_back(std::make_pair(input_port, output_port));
+}
+
+bool ArtNetNodeImpl::SendPollReplyPage(const IPV4Address &destination,
+                                       uint8_t bind_index,
+                                       const PollReplyPage &page) {
   artnet_packet packet;
   PopulatePacketHeader(&packet, ARTNET_REPLY);
   memset(&packet.data.reply, 0, sizeof(packet.data.reply));
 
+  // If none of the ports are enabled, use the sub-net of the first port.
+  uint8_t subnet_address = 0;
+  if (page.subnet != -1) {
+    subnet_address = page.subnet;
+  } else if (!page.ports.empty() && page.ports[0].second) {
+    subnet_address = page.ports[0].second->universe_address >> 4;
+  } else if (!page.ports.empty() && page.ports[0].first) {
+    subnet_address = page.ports[0].first->PortAddress() >> 4;
+  }
+
   m_interface.ip_address.Get(packet.data.reply.ip);
   packet.data.reply.port = HostToLittleEndian(ARTNET_PORT);
   packet.data.reply.net_address = m_net_address;
-  packet.data.reply.subnet_address = m_output_ports[0].universe_address >> 4;
+  packet.data.reply.subnet_address = subnet_address;
   packet.data.reply.oem = HostToNetwork(OEM_CODE);
   packet.data.reply.status1 = 0xd2;  // normal indicators, rdm enabled
   packet.data.reply.esta_id = HostToLittleEndian(OPEN_LIGHTING_ESTA_CODE);
@@ -912,20 +1008,29 @@ bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
                           arraysize(packet.data.reply.node_report));
   packet.data.reply.number_ports[1] = ARTNET_MAX_PORTS;
   for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    InputPort *iport = GetInputPort(i, false);
+    const InputPort *iport = NULL;
+    const OutputPort *oport = NULL;
+    if (i < page.ports.size()) {
+      iport = page.ports[i].first;
+      oport = page.ports[i].second;
+    }
     packet.data.reply.port_types[i] = iport ? 0xc0 : 0x80;
     packet.data.reply.good_input[i] = iport && iport->enabled ? 0x0 : 0x8;
     packet.data.reply.sw_in[i] = iport ? iport->PortAddress() : 0;
 
+    if (!oport) {
+      continue;
+    }
     packet.data.reply.good_output[i] = (
-        (m_output_ports[i].enabled ? 0x80 : 0x00) |
-        (m_output_ports[i].merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
-        (m_output_ports[i].is_merging ? 0x8 : 0x0));
-    packet.data.reply.sw_out[i] = m_output_ports[i].universe_address;
+        (oport->enabled ? 0x80 : 0x00) |
+        (oport->merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
+        (oport->is_merging ? 0x8 : 0x0));
+    packet.data.reply.sw_out[i] = oport->universe_address;
   }
   packet.data.reply.style = NODE_CODE;
   m_interface.hw_address.Get(packet.data.reply.mac);
   m_interface.ip_address.Get(packet.data.reply.bind_ip);
+  packet.data.reply.bind_index = bind_index;
   // maybe set status2 here if the web UI is enabled
   packet.data.reply.status2 = 0x08;  // node supports 15 bit port addresses
   if (!SendPacket(packet, sizeof(packet.data.reply), destination)) {
@@ -1109,17 +1214,17 @@ void ArtNetNodeImpl::HandleDataPacket(const IPV4Address &source_address,
       (unsigned int) ((packet.length[0] << 8) + packet.length[1]),
       packet_size - header_size);
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == universe_id &&
-        m_output_ports[port_id].on_data &&
-        m_output_ports[port_id].buffer) {
+  const OutputPorts &ports = m_output_port_index[universe_id & 0xff];
+  OutputPorts::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    OutputPort *port = *iter;
+    if (port->on_data && port->buffer) {
       // update this port, doing a merge if necessary
       DMXSource source;
       source.address = source_address;
       source.timestamp = *m_ss->WakeUpTime();
       source.buffer.Set(packet.data, data_size);
-      UpdatePortFromSource(&m_output_ports[port_id], source);
+      UpdatePortFromSource(port, source);
     }
   }
 }
@@ -1159,17 +1264,14 @@ void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
       static_cast<unsigned int>(ARTNET_MAX_RDM_ADDRESS_COUNT),
       addresses);
 
-  bool handler_called[ARTNET_MAX_PORTS];
-  memset(handler_called, 0, sizeof(handler_called));
+  set<OutputPort*> handler_called;
 
   for (unsigned int i = 0; i < addresses; i++) {
-    for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-      if (m_output_ports[port_id].enabled &&
-          m_output_ports[port_id].universe_address == packet.addresses[i] &&
-          m_output_ports[port_id].on_discover &&
-          !handler_called[port_id]) {
-        m_output_ports[port_id].on_discover->Run();
-        handler_called[port_id] = true;
+    const OutputPorts &ports = m_output_port_index[packet.addresses[i]];
+    OutputPorts::const_iterator iter = ports.begin();
+    for (; iter != ports.end(); ++iter) {
+      if ((*iter)->on_discover && handler_called.insert(*iter).second) {
+        (*iter)->on_discover->Run();
       }
     }
   }
@@ -1239,11 +1341,11 @@ void ArtNetNodeImpl::HandleTodControl(const IPV4Address &source_address,
     return;
   }
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_flush) {
-      m_output_ports[port_id].on_flush->Run();
+  const OutputPorts &ports = m_output_port_index[packet.address];
+  OutputPorts::const_iterator iter = ports.begin();
+  for (; iter != ports.end(); ++iter) {
+    if ((*iter)->on_flush) {
+      (*iter)->on_flush->Run();
     }
   }
 }
@@ -1283,23 +1385,24 @@ void ArtNetNodeImpl::HandleRdm(const IPV4Address &source_address,
     return;
   }
 
-  // look for the port that this was sent to, once we know the port we can try
-  // to parse the message
-  for (uint8_t port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_rdm_request) {
+  // The index only holds the enabled ports, once we know the port we can try
+  // to parse the message.
+  const OutputPorts &ports = m_output_port_index[packet.address];
+  OutputPorts::const_iterator port_iter = ports.begin();
+  for (; port_iter != ports.end(); ++port_iter) {
+    OutputPort *port = *port_iter;
+    if (port->on_rdm_request) {
       RDMRequest *request = RDMRequest::InflateFromData(packet.data,
                                                         rdm_length);
 
       if (request) {
-        m_output_ports[port_id].on_rdm_request->Run(
+        port->on_rdm_request->Run(
             request,
             NewSingleCallback(this,
                               &ArtNetNodeImpl::RDMRequestCompletion,
                               source_address,
-                              port_id,
-                              m_output_ports[port_id].universe_address));
+                              port->port_id,
+                              port->universe_address));
       }
     }
   }
@@ -1493,42 +1596,38 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
                                           const DMXSource &source) {
   TimeStamp merge_time_threshold = (
       *m_ss->WakeUpTime() - TimeInterval(MERGE_TIMEOUT, 0));
-  // the index of the first empty slot, of MAX_MERGE_SOURCES if we're already
-  // tracking MAX_MERGE_SOURCES sources.
-  unsigned int first_empty_slot = MAX_MERGE_SOURCES;
-  // the index for this source, or MAX_MERGE_SOURCES if it wasn't found
-  unsigned int source_slot = MAX_MERGE_SOURCES;
-  unsigned int active_sources = 0;
-
-  // locate the source within the list of tracked sources, also find the first
-  // empty source location in case this source is new, and timeout any sources
-  // we haven't heard from.
-  for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
-    if (port->sources[i].address == source.address) {
-      source_slot = i;
+  DMXSources &sources = port->sources;
+
+  // timeout any sources we haven't heard from, and locate this source within
+  // the list of tracked sources.
+  DMXSources::iterator source_iter = sources.end();
+  DMXSources::iterator iter = sources.begin();
+  while (iter != sources.end()) {
+    if (iter->address == source.address) {
+      source_iter = iter++;
       continue;
     }
 
-    // timeout old sources
-    if (port->sources[i].timestamp < merge_time_threshold) {
-      port->sources[i].address = IPV4Address();
-    }
-
-    if (!port->sources[i].address.IsWildcard()) {
-      active_sources++;
-    } else if (i < first_empty_slot) {
-      first_empty_slot = i;
+    if (iter->timestamp < merge_time_threshold) {
+      bool found = source_iter != sources.end();
+      size_t offset = found ? source_iter - sources.begin() : 0;
+      iter = sources.erase(iter);
+      if (found) {
+        source_iter = sources.begin() + offset;
+      }
+      continue;
     }
+    ++iter;
   }
 
-  if (source_slot == MAX_MERGE_SOURCES) {
+  if (source_iter == sources.end()) {
     // this is a new source
-    if (first_empty_slot == MAX_MERGE_SOURCES) {
+    if (sources.size() >= m_max_merge_sources) {
       // No room at the inn
       OLA_WARN << "Max merge sources reached, ignoring";
       return;
     }
-    if (active_sources == 0) {
+    if (sources.empty()) {
       port->is_merging = false;
     } else {
       OLA_INFO << "Entered merge mode for universe "
@@ -1536,29 +1635,24 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
       port->is_merging = true;
       SendPollReplyIfRequired();
     }
-    source_slot = first_empty_slot;
-  } else if (active_sources == 1) {
-    port->is_merging = false;
+    source_iter = sources.insert(sources.end(), source);
+  } else {
+    if (sources.size() == 1) {
+      port->is_merging = false;
+    }
+    *source_iter = source;
   }
 
-  port->sources[source_slot] = source;
-
   // Now we need to merge
   if (port->merge_mode == ARTNET_MERGE_LTP) {
     // the current source is the latest
     (*port->buffer) = source.buffer;
   } else {
     // HTP merge
-    bool first = true;
-    for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
-      if (!port->sources[i].address.IsWildcard()) {
-        if (first) {
-          (*port->buffer) = port->sources[i].buffer;
-          first = false;
-        } else {
-          port->buffer->HTPMerge(port->sources[i].buffer);
-        }
-      }
+    iter = sources.begin();
+    (*port->buffer) = iter->buffer;
+    for (++iter; iter != sources.end(); ++iter) {
+      port->buffer->HTPMerge(iter->buffer);
     }
   }
   port->on_data->Run();
@@ -1625,23 +1719,27 @@ ArtNetNodeImpl::InputPort *ArtNetNodeImpl::GetEnabledInputPort(
   return ok ? port : NULL;
 }
 
-ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
-  if (port_id >= ARTNET_MAX_PORTS) {
-    OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id,
+                                                          bool warn) {
+  if (port_id >= m_output_ports.size()) {
+    if (warn) {
+      OLA_WARN << "Port index of out bounds: "
+               << static_cast<int>(port_id) << " >= "
+               << m_output_ports.size();
+    }
     return NULL;
   }
-  return &m_output_ports[port_id];
+  return m_output_ports[port_id];
 }
 
 const ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(
     uint8_t port_id) const {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index of out bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
-  return &m_output_ports[port_id];
+  return m_output_ports[port_id];
 }
 
 ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetEnabledOutputPort(
@@ -1659,6 +1757,20 @@ ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetEnabledOutputPort(
   return ok ? port : NULL;
 }
 
+void ArtNetNodeImpl::UpdateOutputPortIndex() {
+  vector<OutputPorts>::iterator index_iter = m_output_port_index.begin();
+  for (; index_iter != m_output_port_index.end(); ++index_iter) {
+    index_iter->clear();
+  }
+
+  OutputPorts::iterator iter = m_output_ports.begin();
+  for (; iter != m_output_ports.end(); ++iter) {
+    if ((*iter)->enabled) {
+      m_output_port_index[(*iter)->universe_address].push_back(*iter);
+    }
+  }
+}
+
 bool ArtNetNodeImpl::InitNetwork() {
   if (!m_socket->Init()) {
     OLA_WARN << "Socket init failed";
@@ -69,7 +69,9 @@ class ArtNetNodeOptions {
         use_limited_broadcast_address(false),
         rdm_queue_size(20),
         broadcast_threshold(30),
-        input_port_count(4) {
+        input_port_count(4),
+        output_port_count(ARTNET_MAX_PORTS),
+        max_merge_sources(2) {
   }
 
   bool always_broadcast;
@@ -77,6 +79,19 @@ class ArtNetNodeOptions {
   unsigned int rdm_queue_size;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
+  /**
+   * @brief The number of output ports (those which receive ArtNet data).
+   *
+   * If this is more than ARTNET_MAX_PORTS, the ports are advertised across
+   * multiple ArtPollReply messages, each with a different BindIndex.
+   */
+  uint8_t output_port_count;
+  /**
+   * @brief The maximum number of sources to merge per output port.
+   *
+   * The ArtNet spec only requires two.
+   */
+  unsigned int max_merge_sources;
 };
 
 
@@ -163,7 +178,8 @@ class ArtNetNodeImpl {
    */
   bool SetSubnetAddress(uint8_t subnet_address);
   uint8_t SubnetAddress() const {
-    return m_output_ports[0].universe_address >> 4;
+    return m_output_ports.empty() ? 0 :
+        m_output_ports[0]->universe_address >> 4;
   }
 
   /**
@@ -172,6 +188,12 @@ class ArtNetNodeImpl {
    */
   uint8_t InputPortCount() const;
 
+  /**
+   * Get the number of output ports
+   * @returns the number of output ports
+   */
+  uint8_t OutputPortCount() const;
+
   /**
    * Set the universe address of an input port
    */
@@ -208,6 +230,18 @@ class ArtNetNodeImpl {
    */
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id);
 
+  /**
+   * @brief Set the 8 bit port address (sub-net and universe) of an output
+   * port.
+   *
+   * Unlike SetOutputPortUniverse(), this allows each port to use a different
+   * sub-net. Later calls to SetSubnetAddress() don't change the sub-net of
+   * the port.
+   * @param port_id a port id between 0 and OutputPortCount() - 1
+   * @param port_address the sub-net and universe address.
+   */
+  bool SetOutputPortAddress(uint8_t port_id, uint8_t port_address);
+
   /**
    * Return the current universe address for an output port
    * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
@@ -361,22 +395,38 @@ class ArtNetNodeImpl {
   typedef std::map<ola::rdm::UID,
                    std::pair<ola::network::IPV4Address, uint8_t> > uid_map;
 
-  enum { MAX_MERGE_SOURCES = 2 };
-
   struct DMXSource {
     DmxBuffer buffer;
     TimeStamp timestamp;
     ola::network::IPV4Address address;
   };
 
+  typedef std::vector<DMXSource> DMXSources;
+
   // Output Ports receive ArtNet data
   struct OutputPort {
+    explicit OutputPort(uint8_t id)
+        : port_id(id),
+          universe_address(0),
+          sequence_number(0),
+          enabled(false),
+          merge_mode(ARTNET_MERGE_HTP),
+          is_merging(false),
+          buffer(NULL),
+          on_data(NULL),
+          on_discover(NULL),
+          on_flush(NULL),
+          on_rdm_request(NULL),
+          own_subnet(false) {
+    }
+
+    const uint8_t port_id;
     uint8_t universe_address;
     uint8_t sequence_number;
     bool enabled;
     artnet_merge_mode merge_mode;
     bool is_merging;
-    DMXSource sources[MAX_MERGE_SOURCES];
+    DMXSources sources;
     DmxBuffer *buffer;
     std::map<ola::rdm::UID, ola::network::IPV4Address> uid_map;
     Callback0<void> *on_data;
@@ -385,6 +435,21 @@ class ArtNetNodeImpl {
     ola::Callback2<void,
                    ola::rdm::RDMRequest*,
                    ola::rdm::RDMCallback*> *on_rdm_request;
+    // True if the sub-net was set with SetOutputPortAddress().
+    bool own_subnet;
+  };
+
+  typedef std::vector<OutputPort*> OutputPorts;
+
+  // The ports described by a single ArtPollReply. A reply only has one
+  // sub-net field, so all the enabled ports in a page share a sub-net.
+  struct PollReplyPage {
+    PollReplyPage() : subnet(-1) {}
+
+    // -1 until an enabled port is added.
+    int subnet;
+    // Each entry is one of the four port slots, either port may be NULL.
+    std::vector<std::pair<const InputPort*, const OutputPort*> > ports;
   };
 
   bool m_running;
@@ -393,6 +458,7 @@ class ArtNetNodeImpl {
   std::string m_short_name;
   std::string m_long_name;
   unsigned int m_broadcast_threshold;
+  unsigned int m_max_merge_sources;
   unsigned int m_unsolicited_replies;
   ola::io::SelectServerInterface *m_ss;
   bool m_always_broadcast;
@@ -404,7 +470,10 @@ class ArtNetNodeImpl {
   bool m_artpollreply_required;
 
   InputPorts m_input_ports;
-  OutputPort m_output_ports[ARTNET_MAX_PORTS];
+  OutputPorts m_output_ports;
+  // The enabled output ports, indexed by the 8 bit port address. This avoids
+  // a scan of all the output ports for every ArtDmx packet.
+  std::vector<OutputPorts> m_output_port_index;
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
 
@@ -430,10 +499,35 @@ class ArtNetNodeImpl {
   bool SendPollReplyIfRequired();
 
   /**
-   * @brief Send an ArtPollReply message
+   * @brief Send an ArtPollReply message for each page of ports.
    */
   bool SendPollReply(const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Add an input and / or output port to the first page with a free
+   * slot and a matching sub-net, or start a new page.
+   * @param pages the pages so far.
+   * @param input_port the input port, may be NULL.
+   * @param output_port the output port, may be NULL.
+   * @param subnet the sub-net of the enabled ports, or -1 if neither is
+   *   enabled.
+   */
+  void AddToPollReplyPage(std::vector<PollReplyPage> *pages,
+                          const InputPort *input_port,
+                          const OutputPort *output_port,
+                          int subnet) const;
+
+  /**
+   * @brief Send the ArtPollReply message for a single page of ports.
+   * @param destination where to send the reply
+   * @param bind_index the BindIndex of the page, pages are numbered from 1,
+   *   unless there is only a single page in which case this is 0.
+   * @param page the ports in the page.
+   */
+  bool SendPollReplyPage(const ola::network::IPV4Address &destination,
+                         uint8_t bind_index,
+                         const PollReplyPage &page);
+
   /**
    * @brief Send an IPProgReply
    */
@@ -590,7 +684,7 @@ class ArtNetNodeImpl {
   /**
    * @brief Lookup an OutputPort by id, if the id is invalid, we return NULL.
    */
-  OutputPort *GetOutputPort(uint8_t port_id);
+  OutputPort *GetOutputPort(uint8_t port_id, bool warn = true);
 
   /**
    * @brief A const version of GetOutputPort();
@@ -602,6 +696,14 @@ class ArtNetNodeImpl {
    */
   OutputPort *GetEnabledOutputPort(uint8_t port_id, const std::string &action);
 
+  /**
+   * @brief Rebuild the port address to output port index.
+   *
+   * This must be called whenever an output port is enabled, disabled or has
+   * its address changed.
+   */
+  void UpdateOutputPortIndex();
+
   /**
    * @brief Update a port with a new TOD list
    */
@@ -633,6 +735,8 @@ class ArtNetNodeImpl {
   static const uint16_t ARTNET_PORT = 6454;
   static const uint16_t OEM_CODE = 0x0431;
   static const uint16_t ARTNET_VERSION = 14;
+  // The number of 8 bit port addresses (sub-net & universe) within a net.
+  static const unsigned int PORT_ADDRESS_COUNT = 256;
   // after not receiving a PollReply after this many seconds we declare the
   // node as dead. This is set to 3x the POLL_INTERVAL in ArtNetDevice.
   static const uint8_t NODE_CODE = 0x00;
@@ -751,9 +855,16 @@ class ArtNetNode {
     return m_impl.InputPortState(port_id);
   }
 
+  uint8_t OutputPortCount() const {
+    return m_impl.OutputPortCount();
+  }
+
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id) {
     return m_impl.SetOutputPortUniverse(port_id, universe_id);
   }
+  bool SetOutputPortAddress(uint8_t port_id, uint8_t port_address) {
+    return m_impl.SetOutputPortAddress(port_id, port_address);
+  }
   uint8_t GetOutputPortUniverse(uint8_t port_id) {
     return m_impl.GetOutputPortUniverse(port_id);
   }
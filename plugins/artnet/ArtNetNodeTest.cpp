@@ -73,6 +73,7 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBasicBehaviour);
   CPPUNIT_TEST(testConfigurationMode);
   CPPUNIT_TEST(testExtendedInputPorts);
+  CPPUNIT_TEST(testExtendedOutputPorts);
   CPPUNIT_TEST(testBroadcastSendDMX);
   CPPUNIT_TEST(testBroadcastSendDMXZeroUniverse);
   CPPUNIT_TEST(testLimitedBroadcastDMX);
@@ -114,6 +115,7 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   void testBasicBehaviour();
   void testConfigurationMode();
   void testExtendedInputPorts();
+  void testExtendedOutputPorts();
   void testBroadcastSendDMX();
   void testBroadcastSendDMXZeroUniverse();
   void testLimitedBroadcastDMX();
@@ -629,6 +631,184 @@ void ArtNetNodeTest::testExtendedInputPorts() {
 }
 
 
+/**
+ * Check that nodes with more than four output ports advertise them using
+ * multiple ArtPollReplies and that DMX is routed to the correct port.
+ */
+void ArtNetNodeTest::testExtendedOutputPorts() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  node_options.output_port_count = 8;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  node.SetNetAddress(4);
+
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(5,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  OLA_ASSERT_EQ((uint8_t) 4, node.InputPortCount());
+  OLA_ASSERT_EQ((uint8_t) 8, node.OutputPortCount());
+  OLA_ASSERT_FALSE(node.OutputPortState(5));
+  OLA_ASSERT_FALSE(node.OutputPortState(8));
+
+  // Enabling a port sends one ArtPollReply per page of 4 ports. The sub-net
+  // of each page is that of the enabled ports in it.
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t poll_reply_page1[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x21,
+      10, 0, 0, 1,
+      0x36, 0x19,
+      0, 0,
+      4, 0,  // subnet address
+      0x4, 0x31,  // oem
+      0,
+      0xd2,
+      0x70, 0x7a,  // esta
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // short name
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // long name
+      '#', '0', '0', '0', '1', ' ', '[', '1', ']', ' ', 'O', 'L', 'A',
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0,
+      0,  // node report
+      0, 4,  // num ports
+      0xc0, 0xc0, 0xc0, 0xc0,
+      8, 8, 8, 8,
+      0, 0, 0, 0,
+      0, 0, 0, 0,  // swin
+      0, 0, 0, 0,  // swout
+      0, 0, 0, 0, 0, 0, 0,  // video, macro, remote, spare, style
+      0xa, 0xb, 0xc, 0x12, 0x34, 0x56,  // mac address
+      0xa, 0x0, 0x0, 0x1,
+      1,  // bind index
+      8,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0  // filler
+    };
+    const uint8_t poll_reply_page2[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x21,
+      10, 0, 0, 1,
+      0x36, 0x19,
+      0, 0,
+      4, 5,  // subnet address
+      0x4, 0x31,  // oem
+      0,
+      0xd2,
+      0x70, 0x7a,  // esta
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // short name
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // long name
+      '#', '0', '0', '0', '1', ' ', '[', '1', ']', ' ', 'O', 'L', 'A',
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0,
+      0,  // node report
+      0, 4,  // num ports
+      0x80, 0x80, 0x80, 0x80,  // output only
+      8, 8, 8, 8,
+      0, 0x80, 0, 0,
+      0, 0, 0, 0,  // swin
+      0, 0x57, 0, 0,  // swout
+      0, 0, 0, 0, 0, 0, 0,  // video, macro, remote, spare, style
+      0xa, 0xb, 0xc, 0x12, 0x34, 0x56,  // mac address
+      0xa, 0x0, 0x0, 0x1,
+      2,  // bind index
+      8,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0  // filler
+    };
+
+    ExpectedBroadcast(poll_reply_page1, sizeof(poll_reply_page1));
+    ExpectedBroadcast(poll_reply_page2, sizeof(poll_reply_page2));
+    OLA_ASSERT(node.SetOutputPortAddress(5, 0x57));
+    OLA_ASSERT(node.OutputPortState(5));
+    OLA_ASSERT_EQ((uint8_t) 0x57, node.GetOutputPortUniverse(5));
+
+    // A port on another sub-net can't share a page with port 5, so it's
+    // described in a third page.
+    uint8_t page1[sizeof(poll_reply_page1)];
+    memcpy(page1, poll_reply_page1, sizeof(page1));
+    page1[115] = '2';  // node report
+    uint8_t page2[sizeof(poll_reply_page2)];
+    memcpy(page2, poll_reply_page2, sizeof(page2));
+    page2[115] = '2';
+    uint8_t page3[sizeof(poll_reply_page2)];
+    memcpy(page3, page2, sizeof(page3));
+    page3[19] = 2;  // subnet address
+    page3[182] = 0x80;  // good output
+    page3[183] = 0;
+    page3[190] = 0x21;  // swout
+    page3[191] = 0;
+    page3[211] = 3;  // bind index
+
+    ExpectedBroadcast(page1, sizeof(page1));
+    ExpectedBroadcast(page2, sizeof(page2));
+    ExpectedBroadcast(page3, sizeof(page3));
+    OLA_ASSERT(node.SetOutputPortAddress(6, 0x21));
+    OLA_ASSERT_EQ((uint8_t) 0x21, node.GetOutputPortUniverse(6));
+  }
+
+  // Setting the node's sub-net doesn't change ports with their own sub-net.
+  m_socket->SetDiscardMode(true);
+  OLA_ASSERT(node.SetSubnetAddress(3));
+  m_socket->SetDiscardMode(false);
+  OLA_ASSERT_EQ((uint8_t) 0x57, node.GetOutputPortUniverse(5));
+  OLA_ASSERT_EQ((uint8_t) 0x21, node.GetOutputPortUniverse(6));
+  OLA_ASSERT_EQ((uint8_t) 0x30, node.GetOutputPortUniverse(4));
+
+  // Data for a different port address is ignored.
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t dmx_message[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      0,  // seq #
+      1,  // physical port
+      0x07, 4,  // subnet & net address
+      0, 6,  // dmx length
+      0, 1, 2, 3, 4, 5
+    };
+
+    ReceiveFromPeer(dmx_message, sizeof(dmx_message), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+  }
+
+  // Data for the port address of port 5.
+  {
+    SocketVerifier verifer(m_socket);
+    const uint8_t dmx_message[] = {
+      'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+      0x00, 0x50,
+      0x0, 14,
+      1,  // seq #
+      1,  // physical port
+      0x57, 4,  // subnet & net address
+      0, 6,  // dmx length
+      5, 4, 3, 2, 1, 0
+    };
+
+    ReceiveFromPeer(dmx_message, sizeof(dmx_message), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("5,4,3,2,1,0"), input_buffer.ToString());
+  }
+}
+
+
 /**
  * Check sending DMX using broadcast works.
  */
@@ -101,6 +101,10 @@ bool ArtNetPlugin::SetDefaultPreferences() {
       ArtNetDevice::K_OUTPUT_PORT_KEY,
       UIntValidator(0, 16),
       ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_INPUT_PORT_KEY,
+      UIntValidator(0, 255),
+      ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_ALWAYS_BROADCAST_KEY,
                                          BoolValidator(),
                                          false);
@@ -120,6 +124,7 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   if (m_preferences->GetValue(ArtNetDevice::K_SHORT_NAME_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_LONG_NAME_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_SUBNET_KEY).empty() ||
+      m_preferences->GetValue(ArtNetDevice::K_INPUT_PORT_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_OUTPUT_PORT_KEY).empty() ||
       m_preferences->GetValue(ArtNetDevice::K_NET_KEY).empty()) {
     return false;
@@ -37,11 +37,16 @@ using std::vector;
 
 namespace {
 static const uint8_t ARTNET_UNIVERSE_COUNT = 16;
+static const unsigned int ARTNET_PORT_ADDRESS_COUNT = 256;
 };  // namespace
 
 void ArtNetInputPort::PostSetUniverse(Universe *old_universe,
                                       Universe *new_universe) {
-  if (new_universe) {
+  if (new_universe && m_node->OutputPortCount() > ARTNET_MAX_PORTS) {
+    // With more than one page of ports, each port gets its own sub-net.
+    m_node->SetOutputPortAddress(
+        PortId(), new_universe->UniverseId() % ARTNET_PORT_ADDRESS_COUNT);
+  } else if (new_universe) {
     m_node->SetOutputPortUniverse(
         PortId(), new_universe->UniverseId() % ARTNET_UNIVERSE_COUNT);
   } else {
@@ -91,11 +96,12 @@ string ArtNetInputPort::Description() const {
     return "";
   }
 
+  uint8_t port_address = m_node->GetOutputPortUniverse(PortId());
   std::ostringstream str;
   str << "ArtNet Universe "
       << static_cast<int>(m_node->NetAddress()) << ":"
-      << static_cast<int>(m_node->SubnetAddress()) << ":"
-      << static_cast<int>(m_node->GetOutputPortUniverse(PortId()));
+      << static_cast<int>(port_address >> 4) << ":"
+      << static_cast<int>(port_address & 0x0f);
   return str.str();
 }
 
@@ -42,10 +42,20 @@ const uint8_t DummyPlugin::DEFAULT_DEVICE_COUNT = 1;
 // 0 for now, since the web UI doesn't handle it.
 const uint8_t DummyPlugin::DEFAULT_ACK_TIMER_DEVICE_COUNT = 0;
 const uint16_t DummyPlugin::DEFAULT_SUBDEVICE_COUNT = 4;
+const uint8_t DummyPlugin::DEFAULT_FARM_DEVICES_PER_PROXY = 4;
 const char DummyPlugin::DEVICE_NAME[] = "Dummy Device";
 const char DummyPlugin::DIMMER_COUNT_KEY[] = "dimmer_count";
 const char DummyPlugin::DIMMER_SUBDEVICE_COUNT_KEY[] = "dimmer_subdevice_count";
 const char DummyPlugin::DUMMY_DEVICE_COUNT_KEY[] = "dummy_device_count";
+const char DummyPlugin::FARM_ACK_TIMER_PERCENT_KEY[] = "farm_ack_timer_percent";
+const char DummyPlugin::FARM_DEVICES_PER_PROXY_KEY[] =
+    "farm_devices_per_proxy";
+const char DummyPlugin::FARM_LOSS_PERCENT_KEY[] = "farm_loss_percent";
+const char DummyPlugin::FARM_PROXY_COUNT_KEY[] = "farm_proxy_count";
+const char DummyPlugin::FARM_RESPONDER_COUNT_KEY[] = "farm_responder_count";
+const char DummyPlugin::FARM_RESPONSE_DELAY_KEY[] = "farm_response_delay";
+const char DummyPlugin::FARM_SUBDEVICE_COUNT_KEY[] = "farm_subdevice_count";
+const unsigned int DummyPlugin::MAX_FARM_RESPONDER_COUNT = 10000;
 const char DummyPlugin::MOVING_LIGHT_COUNT_KEY[] = "moving_light_count";
 const char DummyPlugin::NETWORK_COUNT_KEY[] = "network_device_count";
 const char DummyPlugin::PLUGIN_NAME[] = "Dummy";
@@ -100,8 +110,45 @@ bool DummyPlugin::StartHook() {
     options.number_of_network_responders = DEFAULT_DEVICE_COUNT;
   }
 
+  ResponderFarm::Options &farm = options.farm;
+  if (!StringToInt(m_preferences->GetValue(FARM_RESPONDER_COUNT_KEY),
+                   &farm.responder_count) ||
+      farm.responder_count > MAX_FARM_RESPONDER_COUNT) {
+    farm.responder_count = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_SUBDEVICE_COUNT_KEY),
+                   &farm.sub_device_count)) {
+    farm.sub_device_count = DEFAULT_SUBDEVICE_COUNT;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_PROXY_COUNT_KEY),
+                   &farm.proxy_count)) {
+    farm.proxy_count = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_DEVICES_PER_PROXY_KEY),
+                   &farm.devices_per_proxy)) {
+    farm.devices_per_proxy = DEFAULT_FARM_DEVICES_PER_PROXY;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_ACK_TIMER_PERCENT_KEY),
+                   &farm.ack_timer_percent)) {
+    farm.ack_timer_percent = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_LOSS_PERCENT_KEY),
+                   &farm.loss_percent)) {
+    farm.loss_percent = 0;
+  }
+
+  if (!StringToInt(m_preferences->GetValue(FARM_RESPONSE_DELAY_KEY),
+                   &farm.response_delay)) {
+    farm.response_delay = 0;
+  }
+
   std::auto_ptr<DummyDevice> device(
-      new DummyDevice(this, DEVICE_NAME, options));
+      new DummyDevice(this, DEVICE_NAME, options, m_plugin_adaptor));
   if (!device->Start()) {
     return false;
   }
@@ -173,6 +220,35 @@ bool DummyPlugin::SetDefaultPreferences() {
                                          IntValidator(0, 254),
                                          DEFAULT_DEVICE_COUNT);
 
+  save |= m_preferences->SetDefaultValue(
+      FARM_RESPONDER_COUNT_KEY,
+      UIntValidator(0, MAX_FARM_RESPONDER_COUNT),
+      0);
+
+  save |= m_preferences->SetDefaultValue(FARM_SUBDEVICE_COUNT_KEY,
+                                         UIntValidator(0, 255),
+                                         DEFAULT_SUBDEVICE_COUNT);
+
+  save |= m_preferences->SetDefaultValue(FARM_PROXY_COUNT_KEY,
+                                         UIntValidator(0, 1000),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(FARM_DEVICES_PER_PROXY_KEY,
+                                         UIntValidator(1, 38),
+                                         DEFAULT_FARM_DEVICES_PER_PROXY);
+
+  save |= m_preferences->SetDefaultValue(FARM_ACK_TIMER_PERCENT_KEY,
+                                         UIntValidator(0, 100),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(FARM_LOSS_PERCENT_KEY,
+                                         UIntValidator(0, 100),
+                                         0);
+
+  save |= m_preferences->SetDefaultValue(FARM_RESPONSE_DELAY_KEY,
+                                         UIntValidator(0, 1000),
+                                         0);
+
   if (save) {
     m_preferences->Save();
   }
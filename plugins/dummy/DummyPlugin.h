@@ -54,10 +54,19 @@ class DummyPlugin: public Plugin {
     static const uint8_t DEFAULT_DEVICE_COUNT;
     static const uint8_t DEFAULT_ACK_TIMER_DEVICE_COUNT;
     static const uint16_t DEFAULT_SUBDEVICE_COUNT;
+    static const uint8_t DEFAULT_FARM_DEVICES_PER_PROXY;
     static const char DEVICE_NAME[];
     static const char DIMMER_COUNT_KEY[];
     static const char DIMMER_SUBDEVICE_COUNT_KEY[];
     static const char DUMMY_DEVICE_COUNT_KEY[];
+    static const char FARM_ACK_TIMER_PERCENT_KEY[];
+    static const char FARM_DEVICES_PER_PROXY_KEY[];
+    static const char FARM_LOSS_PERCENT_KEY[];
+    static const char FARM_PROXY_COUNT_KEY[];
+    static const char FARM_RESPONDER_COUNT_KEY[];
+    static const char FARM_RESPONSE_DELAY_KEY[];
+    static const char FARM_SUBDEVICE_COUNT_KEY[];
+    static const unsigned int MAX_FARM_RESPONDER_COUNT;
     static const char MOVING_LIGHT_COUNT_KEY[];
     static const char NETWORK_COUNT_KEY[];
     static const char PLUGIN_NAME[];
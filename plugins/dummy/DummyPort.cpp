@@ -72,7 +72,8 @@ void AddResponders(map<UID, ola::rdm::RDMControllerInterface*> *responders,
 
 DummyPort::DummyPort(DummyDevice *parent,
                      const Options &options,
-                     unsigned int id)
+                     unsigned int id,
+                     ola::thread::SchedulerInterface *scheduler)
     : BasicOutputPort(parent, id, true, true) {
   UID first_uid(OPEN_LIGHTING_ESTA_CODE, DummyPort::kStartAddress);
   ola::rdm::UIDAllocator allocator(first_uid);
@@ -103,6 +104,11 @@ DummyPort::DummyPort(DummyDevice *parent,
       &m_responders, &allocator, options.number_of_sensor_responders);
   AddResponders<ola::rdm::NetworkResponder>(
       &m_responders, &allocator, options.number_of_network_responders);
+
+  if (options.farm.responder_count) {
+    m_farm.reset(new ResponderFarm(options.farm, scheduler));
+    m_discovery_agent.reset(new ola::rdm::DiscoveryAgent(m_farm.get()));
+  }
 }
 
 
@@ -121,11 +127,18 @@ bool DummyPort::WriteDMX(const DmxBuffer &buffer,
 }
 
 void DummyPort::RunFullDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  RunDiscovery(callback, true);
 }
 
 void DummyPort::RunIncrementalDiscovery(RDMDiscoveryCallback *callback) {
-  RunDiscovery(callback);
+  RunDiscovery(callback, false);
+}
+
+void DummyPort::SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+  BasicOutputPort::SetKnownUIDs(uids);
+  if (m_discovery_agent.get()) {
+    m_discovery_agent->SetKnownUIDs(uids);
+  }
 }
 
 void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
@@ -138,7 +151,7 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
       RunRDMCallback(callback, ola::rdm::RDM_WAS_BROADCAST);
     } else {
       broadcast_request_tracker *tracker = new broadcast_request_tracker;
-      tracker->expected_count = m_responders.size();
+      tracker->expected_count = m_responders.size() + (m_farm.get() ? 1 : 0);
       tracker->current_count = 0;
       tracker->failed = false;
       tracker->callback = callback;
@@ -148,12 +161,19 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
           request->Duplicate(),
           NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
       }
+      if (m_farm.get()) {
+        m_farm->SendRDMRequest(
+          request->Duplicate(),
+          NewSingleCallback(this, &DummyPort::HandleBroadcastAck, tracker));
+      }
     }
   } else {
     ola::rdm::RDMControllerInterface *controller = STLFindOrNull(
         m_responders, dest);
     if (controller) {
       controller->SendRDMRequest(request.release(), callback);
+    } else if (m_farm.get()) {
+      m_farm->SendRDMRequest(request.release(), callback);
     } else {
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
     }
@@ -161,16 +181,48 @@ void DummyPort::SendRDMRequest(ola::rdm::RDMRequest *request_ptr,
 }
 
 
-void DummyPort::RunDiscovery(RDMDiscoveryCallback *callback) {
+void DummyPort::RunDiscovery(RDMDiscoveryCallback *callback, bool full) {
+  if (m_discovery_agent.get()) {
+    ola::rdm::DiscoveryAgent::DiscoveryCompleteCallback *on_complete =
+        NewSingleCallback(this, &DummyPort::FarmDiscoveryComplete, callback);
+    if (full) {
+      m_discovery_agent->StartFullDiscovery(on_complete);
+    } else {
+      m_discovery_agent->StartIncrementalDiscovery(on_complete);
+    }
+    return;
+  }
+
   ola::rdm::UIDSet uid_set;
-  for (ResponderMap::iterator i = m_responders.begin();
-    i != m_responders.end(); i++) {
-    uid_set.AddUID(i->first);
+  AddResponderUIDs(&uid_set);
+  callback->Run(uid_set);
+}
+
+
+void DummyPort::FarmDiscoveryComplete(RDMDiscoveryCallback *callback,
+                                      bool ok,
+                                      const ola::rdm::UIDSet &uids) {
+  // Discovery fails if it's already running, so keep the UIDs from the last
+  // successful run.
+  if (ok) {
+    m_farm_uids = uids;
+  } else {
+    m_farm_uids = m_farm_uids.Union(uids);
   }
+  ola::rdm::UIDSet uid_set(m_farm_uids);
+  AddResponderUIDs(&uid_set);
   callback->Run(uid_set);
 }
 
 
+void DummyPort::AddResponderUIDs(ola::rdm::UIDSet *uid_set) const {
+  for (ResponderMap::const_iterator i = m_responders.begin();
+    i != m_responders.end(); i++) {
+    uid_set->AddUID(i->first);
+  }
+}
+
+
 void DummyPort::HandleBroadcastAck(broadcast_request_tracker *tracker,
                                    ola::rdm::RDMReply *reply) {
   tracker->current_count++;
@@ -190,6 +242,8 @@ void DummyPort::HandleBroadcastAck(broadcast_request_tracker *tracker,
 
 
 DummyPort::~DummyPort() {
+  // Stop any discovery before the farm is deleted.
+  m_discovery_agent.reset();
   STLDeleteValues(&m_responders);
 }
 }  // namespace dummy
@@ -22,15 +22,20 @@
 #define PLUGINS_DUMMY_DUMMYPORT_H_
 
 #include <stdint.h>
+#include <memory>
 #include <string>
 #include <map>
 #include <vector>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/RDMControllerInterface.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
 #include "olad/Port.h"
+#include "plugins/dummy/ResponderFarm.h"
 
 namespace ola {
 namespace plugin {
@@ -59,6 +64,8 @@ class DummyPort: public BasicOutputPort {
     uint8_t number_of_advanced_dimmers;
     uint8_t number_of_sensor_responders;
     uint8_t number_of_network_responders;
+    // The simulated responders that are found with the DiscoveryAgent.
+    ResponderFarm::Options farm;
   };
 
 
@@ -68,15 +75,18 @@ class DummyPort: public BasicOutputPort {
    * @param options the config for the DummyPort such as the number of fake RDM
    * devices to create
    * @param id the ID of this port
+   * @param scheduler the scheduler used by the responder farm, may be NULL.
    */
   DummyPort(class DummyDevice *parent,
             const Options &options,
-            unsigned int id);
+            unsigned int id,
+            ola::thread::SchedulerInterface *scheduler = NULL);
   virtual ~DummyPort();
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
   std::string Description() const { return "Dummy Port"; }
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids);
 
   /*
    * Handle an RDM Request
@@ -97,8 +107,15 @@ class DummyPort: public BasicOutputPort {
 
   DmxBuffer m_buffer;
   ResponderMap m_responders;
+  std::auto_ptr<ResponderFarm> m_farm;
+  std::auto_ptr<ola::rdm::DiscoveryAgent> m_discovery_agent;
+  ola::rdm::UIDSet m_farm_uids;
 
-  void RunDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+  void RunDiscovery(ola::rdm::RDMDiscoveryCallback *callback, bool full);
+  void FarmDiscoveryComplete(ola::rdm::RDMDiscoveryCallback *callback,
+                             bool ok,
+                             const ola::rdm::UIDSet &uids);
+  void AddResponderUIDs(ola::rdm::UIDSet *uid_set) const;
   void HandleBroadcastAck(broadcast_request_tracker *tracker,
                           ola::rdm::RDMReply *reply);
 
@@ -80,6 +80,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testParamDescription);
   CPPUNIT_TEST(testOlaManufacturerPidCodeVersion);
   CPPUNIT_TEST(testSlotInfo);
+  CPPUNIT_TEST(testResponderFarm);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -109,6 +110,7 @@ class DummyPortTest: public CppUnit::TestFixture {
   void testParamDescription();
   void testOlaManufacturerPidCodeVersion();
   void testSlotInfo();
+  void testResponderFarm();
 
  private:
   UID m_expected_uid;
@@ -117,8 +119,16 @@ class DummyPortTest: public CppUnit::TestFixture {
   ola::rdm::RDMStatusCode m_expected_code;
   const RDMResponse *m_expected_response;
   bool m_got_uids;
+  UIDSet m_farm_uids;
+  bool m_got_farm_response;
 
   void VerifyUIDs(const UIDSet &uids);
+  void StoreUIDs(const UIDSet &uids) { m_farm_uids = uids; }
+  void HandleFarmResponse(RDMReply *reply) {
+    OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode());
+    OLA_ASSERT_NOT_NULL(reply->Response());
+    m_got_farm_response = true;
+  }
   void checkSubDeviceOutOfRange(uint16_t pid);
   void checkSubDeviceOutOfRange(ola::rdm::rdm_pid pid) {
     checkSubDeviceOutOfRange(static_cast<uint16_t>(pid));
@@ -790,6 +800,40 @@ void DummyPortTest::testSlotInfo() {
 }
 
 
+/*
+ * Check that the responder farm is discovered and responds to RDM requests.
+ */
+void DummyPortTest::testResponderFarm() {
+  DummyPort::Options options;
+  options.farm.responder_count = 50;
+  DummyPort port(NULL, options, 0);
+
+  port.RunFullDiscovery(NewSingleCallback(this, &DummyPortTest::StoreUIDs));
+  OLA_ASSERT_EQ(56u, m_farm_uids.Size());
+  for (unsigned int i = 0; i < 6; i++) {
+    OLA_ASSERT_TRUE(m_farm_uids.Contains(
+        UID(OPEN_LIGHTING_ESTA_CODE, 0xffffff00 + i)));
+  }
+
+  // The UIDs are sorted, so the first one belongs to the farm.
+  const UID farm_uid = *m_farm_uids.Begin();
+  OLA_ASSERT_TRUE(farm_uid.DeviceId() < 0xffffff00);
+
+  m_got_farm_response = false;
+  port.SendRDMRequest(
+      new RDMGetRequest(m_test_source, farm_uid, 0, 1, 0,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      NewSingleCallback(this, &DummyPortTest::HandleFarmResponse));
+  OLA_ASSERT_TRUE(m_got_farm_response);
+
+  // An incremental discovery should find the same devices.
+  UIDSet uids = m_farm_uids;
+  port.RunIncrementalDiscovery(
+      NewSingleCallback(this, &DummyPortTest::StoreUIDs));
+  OLA_ASSERT_EQ(uids, m_farm_uids);
+}
+
+
 void DummyPortTest::VerifyUIDs(const UIDSet &uids) {
   UIDSet expected_uids;
   for (unsigned int i = 0; i < 6; i++) {
@@ -16,7 +16,9 @@ plugins_dummy_liboladummy_la_SOURCES = \
     plugins/dummy/DummyPlugin.cpp \
     plugins/dummy/DummyPlugin.h \
     plugins/dummy/DummyPort.cpp \
-    plugins/dummy/DummyPort.h
+    plugins/dummy/DummyPort.h \
+    plugins/dummy/ResponderFarm.cpp \
+    plugins/dummy/ResponderFarm.h
 plugins_dummy_liboladummy_la_LIBADD = \
     common/libolacommon.la \
     olad/plugin_api/libolaserverplugininterface.la
@@ -25,7 +27,9 @@ plugins_dummy_liboladummy_la_LIBADD = \
 ##################################################
 test_programs += plugins/dummy/DummyPluginTester
 
-plugins_dummy_DummyPluginTester_SOURCES = plugins/dummy/DummyPortTest.cpp
+plugins_dummy_DummyPluginTester_SOURCES = \
+    plugins/dummy/DummyPortTest.cpp \
+    plugins/dummy/ResponderFarmTest.cpp
 plugins_dummy_DummyPluginTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 # it's unclear to me why liboladummyresponder has to be included here
 # but if it isn't, the test breaks with gcc 4.6.1
@@ -36,6 +40,16 @@ plugins_dummy_DummyPluginTester_LDADD = \
     plugins/dummy/liboladummy.la \
     common/libolacommon.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += plugins/dummy/responder_farm_benchmark
+
+plugins_dummy_responder_farm_benchmark_SOURCES = \
+    plugins/dummy/responder_farm_benchmark.cpp
+plugins_dummy_responder_farm_benchmark_LDADD = \
+    plugins/dummy/liboladummy.la \
+    common/libolacommon.la
+
 endif
 
 EXTRA_DIST += plugins/dummy/README.md
@@ -0,0 +1,470 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarm.cpp
+ * Simulates a large number of RDM responders on a single line.
+ * Copyright (C) 2026 agent
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/AckTimerResponder.h"
+#include "ola/rdm/DimmerResponder.h"
+#include "ola/rdm/DummyResponder.h"
+#include "ola/rdm/MovingLightResponder.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/SensorResponder.h"
+#include "ola/stl/STLUtils.h"
+#include "plugins/dummy/ResponderFarm.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+using ola::TimeInterval;
+using ola::network::HostToNetwork;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMCommand;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::vector;
+
+ResponderFarm::ResponderFarm(const Options &options,
+                             ola::thread::SchedulerInterface *scheduler)
+    : m_scheduler(scheduler),
+      m_response_delay(options.response_delay / 1000,
+                       (options.response_delay % 1000) * 1000),
+      m_loss_percent(std::min(options.loss_percent, static_cast<uint8_t>(100))),
+      m_wired_or_collisions(options.wired_or_collisions),
+      m_random_state(options.seed ? options.seed : 1) {
+  const unsigned int proxy_count = std::min(options.proxy_count,
+                                            options.responder_count);
+  const uint8_t devices_per_proxy = std::min(options.devices_per_proxy,
+                                             MAX_DEVICES_PER_PROXY);
+  unsigned int index = 0;
+
+  for (unsigned int i = 0; i < options.responder_count; i++) {
+    UID uid = NextUID();
+    if (i < proxy_count) {
+      SimulatedResponder *proxy = &m_responders[uid];
+      proxy->controller = new ola::rdm::DummyResponder(uid);
+      for (uint8_t j = 0; j < devices_per_proxy; j++) {
+        UID proxied_uid = NextUID();
+        AddResponder(proxied_uid, index++, options, proxy);
+        proxy->proxied_uids.push_back(proxied_uid);
+      }
+    } else {
+      AddResponder(uid, index++, options, NULL);
+    }
+  }
+  OLA_INFO << "Created responder farm with " << m_responders.size()
+           << " responders";
+}
+
+
+ResponderFarm::~ResponderFarm() {
+  std::deque<ola::thread::timeout_id>::iterator timeout_iter =
+      m_pending_timeouts.begin();
+  for (; timeout_iter != m_pending_timeouts.end(); ++timeout_iter) {
+    m_scheduler->RemoveTimeout(*timeout_iter);
+  }
+
+  // The discovery callbacks are owned by the caller, the RDM ones are ours.
+  std::deque<PendingResponse*>::iterator iter = m_pending_responses.begin();
+  for (; iter != m_pending_responses.end(); ++iter) {
+    delete (*iter)->rdm_callback;
+    delete (*iter)->reply;
+    delete *iter;
+  }
+
+  ResponderMap::iterator responder_iter = m_responders.begin();
+  for (; responder_iter != m_responders.end(); ++responder_iter) {
+    delete responder_iter->second.controller;
+  }
+}
+
+
+void ResponderFarm::GetUIDs(UIDSet *uids) const {
+  ResponderMap::const_iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    uids->AddUID(iter->first);
+  }
+}
+
+
+void ResponderFarm::MuteDevice(const UID &target,
+                               MuteDeviceCallback *mute_complete) {
+  m_stats.mute_count++;
+  SimulatedResponder *responder = STLFind(&m_responders, target);
+  if (!responder) {
+    DeliverMute(mute_complete, false);
+    return;
+  }
+
+  // The device mutes even if the response is lost.
+  responder->muted = true;
+  DeliverMute(mute_complete, !IsLost());
+}
+
+
+void ResponderFarm::UnMuteAll(UnMuteDeviceCallback *unmute_complete) {
+  m_stats.unmute_count++;
+  ResponderMap::iterator iter = m_responders.begin();
+  for (; iter != m_responders.end(); ++iter) {
+    iter->second.muted = false;
+  }
+  DeliverUnMute(unmute_complete);
+}
+
+
+void ResponderFarm::Branch(const UID &lower,
+                           const UID &upper,
+                           BranchCallback *callback) {
+  m_stats.branch_count++;
+
+  uint8_t data[DUB_RESPONSE_LENGTH];
+  memset(data, 0, sizeof(data));
+  unsigned int responses = 0;
+
+  ResponderMap::const_iterator iter = m_responders.lower_bound(lower);
+  for (; iter != m_responders.end() && !(upper < iter->first); ++iter) {
+    if (IsVisible(iter->second)) {
+      FormDUBResponse(iter->first, data);
+      responses++;
+    }
+  }
+
+  if (responses == 0 || (responses == 1 && IsLost())) {
+    DeliverBranch(callback, NULL, 0);
+    return;
+  }
+
+  if (responses > 1) {
+    m_stats.collision_count++;
+    if (!m_wired_or_collisions) {
+      // Corrupt the preamble separator, as if the frame had a framing error.
+      data[DUB_PREAMBLE_LENGTH] = 0;
+    }
+  }
+  DeliverBranch(callback, data, sizeof(data));
+}
+
+
+void ResponderFarm::SendRDMRequest(RDMRequest *request_ptr,
+                                   RDMCallback *callback) {
+  auto_ptr<RDMRequest> request(request_ptr);
+  m_stats.rdm_count++;
+
+  const UID &dest = request->DestinationUID();
+  if (dest.IsBroadcast()) {
+    ResponderMap::iterator iter = m_responders.begin();
+    for (; iter != m_responders.end(); ++iter) {
+      if (dest.DirectedToUID(iter->first)) {
+        iter->second.controller->SendRDMRequest(
+            request->Duplicate(), NewSingleCallback(&DiscardReply));
+      }
+    }
+    DeliverRDM(callback, new RDMReply(ola::rdm::RDM_WAS_BROADCAST));
+    return;
+  }
+
+  const SimulatedResponder *responder = STLFind(&m_responders, dest);
+  if (!responder) {
+    DeliverRDM(callback, new RDMReply(ola::rdm::RDM_UNKNOWN_UID));
+    return;
+  }
+
+  if (IsLost()) {
+    DeliverRDM(callback, new RDMReply(ola::rdm::RDM_TIMEOUT));
+    return;
+  }
+
+  if (!responder->proxied_uids.empty() &&
+      HandleProxyRequest(request.get(), *responder, callback)) {
+    return;
+  }
+
+  responder->controller->SendRDMRequest(
+      request.release(),
+      NewSingleCallback(this, &ResponderFarm::HandleResponderReply, callback));
+}
+
+
+ResponderFarm::SimulatedResponder *ResponderFarm::AddResponder(
+    const UID &uid,
+    unsigned int index,
+    const Options &options,
+    const SimulatedResponder *proxy) {
+  SimulatedResponder *responder = &m_responders[uid];
+  responder->proxy = proxy;
+
+  if (index % 100 < options.ack_timer_percent) {
+    responder->controller = new ola::rdm::AckTimerResponder(uid);
+    return responder;
+  }
+
+  switch (index % 4) {
+    case 0:
+      responder->controller = new ola::rdm::DummyResponder(uid);
+      break;
+    case 1:
+      responder->controller = new ola::rdm::DimmerResponder(
+          uid, options.sub_device_count);
+      break;
+    case 2:
+      responder->controller = new ola::rdm::MovingLightResponder(uid);
+      break;
+    default:
+      responder->controller = new ola::rdm::SensorResponder(uid);
+  }
+  return responder;
+}
+
+
+/*
+ * Pick a random UID in the Open Lighting range. This skips the range used by
+ * the DummyPort's own responders.
+ */
+UID ResponderFarm::NextUID() {
+  while (true) {
+    uint32_t device_id = NextRandom();
+    if (device_id >= DUMMY_PORT_START_ADDRESS) {
+      continue;
+    }
+    UID uid(OPEN_LIGHTING_ESTA_CODE, device_id);
+    if (!STLContains(m_responders, uid)) {
+      return uid;
+    }
+  }
+}
+
+
+/*
+ * A xorshift generator, so the farm is the same each time for a given seed.
+ */
+uint32_t ResponderFarm::NextRandom() {
+  m_random_state ^= m_random_state << 13;
+  m_random_state ^= m_random_state >> 17;
+  m_random_state ^= m_random_state << 5;
+  return m_random_state;
+}
+
+
+bool ResponderFarm::IsLost() {
+  if (m_loss_percent && NextRandom() % 100 < m_loss_percent) {
+    m_stats.lost_count++;
+    return true;
+  }
+  return false;
+}
+
+
+/*
+ * Devices behind a proxy are only visible once the proxy has been muted.
+ */
+bool ResponderFarm::IsVisible(const SimulatedResponder &responder) const {
+  return !responder.muted && (!responder.proxy || responder.proxy->muted);
+}
+
+
+/*
+ * Handle the proxy PIDs, which the model responders don't support.
+ */
+bool ResponderFarm::HandleProxyRequest(const RDMRequest *request,
+                                       const SimulatedResponder &responder,
+                                       RDMCallback *callback) {
+  if (request->CommandClass() != RDMCommand::GET_COMMAND ||
+      request->SubDevice() != ola::rdm::ROOT_RDM_DEVICE) {
+    return false;
+  }
+
+  if (request->ParamId() == ola::rdm::PID_PROXIED_DEVICE_COUNT) {
+    PACK(
+    struct proxied_device_count_s {
+      uint16_t device_count;
+      uint8_t list_change;
+    });
+    struct proxied_device_count_s count;
+    count.device_count = HostToNetwork(
+        static_cast<uint16_t>(responder.proxied_uids.size()));
+    count.list_change = 0;
+    DeliverRDM(callback, new RDMReply(
+        ola::rdm::RDM_COMPLETED_OK,
+        ola::rdm::GetResponseFromData(
+            request, reinterpret_cast<const uint8_t*>(&count),
+            sizeof(count))));
+    return true;
+  } else if (request->ParamId() == ola::rdm::PID_PROXIED_DEVICES) {
+    vector<uint8_t> data(responder.proxied_uids.size() * UID::LENGTH);
+    for (unsigned int i = 0; i < responder.proxied_uids.size(); i++) {
+      responder.proxied_uids[i].Pack(&data[i * UID::LENGTH], UID::LENGTH);
+    }
+    DeliverRDM(callback, new RDMReply(
+        ola::rdm::RDM_COMPLETED_OK,
+        ola::rdm::GetResponseFromData(
+            request, data.empty() ? NULL : &data[0], data.size())));
+    return true;
+  }
+  return false;
+}
+
+
+/*
+ * The model responders run the callback with a RDMReply on the stack, so
+ * take a copy before it's delivered.
+ */
+void ResponderFarm::HandleResponderReply(RDMCallback *callback,
+                                         RDMReply *reply) {
+  const RDMResponse *response = reply->Response();
+  DeliverRDM(callback, new RDMReply(reply->StatusCode(),
+                                    response ? response->Duplicate() : NULL,
+                                    reply->Frames()));
+}
+
+
+void ResponderFarm::DeliverMute(MuteDeviceCallback *callback, bool ok) {
+  if (!m_scheduler) {
+    callback->Run(ok);
+    return;
+  }
+  PendingResponse *response = new PendingResponse();
+  response->mute_callback = callback;
+  response->mute_ok = ok;
+  QueueResponse(response);
+}
+
+
+void ResponderFarm::DeliverUnMute(UnMuteDeviceCallback *callback) {
+  if (!m_scheduler) {
+    callback->Run();
+    return;
+  }
+  PendingResponse *response = new PendingResponse();
+  response->unmute_callback = callback;
+  QueueResponse(response);
+}
+
+
+void ResponderFarm::DeliverBranch(BranchCallback *callback,
+                                  const uint8_t *data,
+                                  unsigned int length) {
+  if (!m_scheduler) {
+    callback->Run(data, length);
+    return;
+  }
+  PendingResponse *response = new PendingResponse();
+  response->branch_callback = callback;
+  if (data) {
+    response->branch_data.assign(data, data + length);
+  }
+  QueueResponse(response);
+}
+
+
+void ResponderFarm::DeliverRDM(RDMCallback *callback, RDMReply *reply) {
+  if (!m_scheduler) {
+    callback->Run(reply);
+    delete reply;
+    return;
+  }
+  PendingResponse *response = new PendingResponse();
+  response->rdm_callback = callback;
+  response->reply = reply;
+  QueueResponse(response);
+}
+
+
+/*
+ * All responses have the same delay, so they're delivered in the order
+ * they're queued.
+ */
+void ResponderFarm::QueueResponse(PendingResponse *response) {
+  m_pending_responses.push_back(response);
+  m_pending_timeouts.push_back(m_scheduler->RegisterSingleTimeout(
+      m_response_delay,
+      NewSingleCallback(this, &ResponderFarm::DeliverNextResponse)));
+}
+
+
+void ResponderFarm::DeliverNextResponse() {
+  m_pending_timeouts.pop_front();
+  auto_ptr<PendingResponse> response(m_pending_responses.front());
+  m_pending_responses.pop_front();
+
+  if (response->mute_callback) {
+    response->mute_callback->Run(response->mute_ok);
+  } else if (response->unmute_callback) {
+    response->unmute_callback->Run();
+  } else if (response->branch_callback) {
+    if (response->branch_data.empty()) {
+      response->branch_callback->Run(NULL, 0);
+    } else {
+      response->branch_callback->Run(&response->branch_data[0],
+                                     response->branch_data.size());
+    }
+  } else if (response->rdm_callback) {
+    auto_ptr<RDMReply> reply(response->reply);
+    response->rdm_callback->Run(reply.get());
+  }
+}
+
+
+/*
+ * OR a DUB response into data, which is how overlapping responses collide on
+ * the line.
+ */
+void ResponderFarm::FormDUBResponse(const UID &uid, uint8_t *data) {
+  for (unsigned int i = 0; i < DUB_PREAMBLE_LENGTH; i++) {
+    data[i] |= 0xfe;
+  }
+  data[DUB_PREAMBLE_LENGTH] |= 0xaa;
+
+  uint8_t id[UID::LENGTH];
+  uid.Pack(id, sizeof(id));
+
+  uint16_t checksum = 0;
+  for (unsigned int i = 0; i < UID::LENGTH; i++) {
+    uint8_t high = id[i] | 0xaa;
+    uint8_t low = id[i] | 0x55;
+    data[DUB_PREAMBLE_LENGTH + 1 + 2 * i] |= high;
+    data[DUB_PREAMBLE_LENGTH + 2 + 2 * i] |= low;
+    checksum += high + low;
+  }
+
+  data[20] |= (checksum >> 8) | 0xaa;
+  data[21] |= (checksum >> 8) | 0x55;
+  data[22] |= checksum | 0xaa;
+  data[23] |= checksum | 0x55;
+}
+
+
+void ResponderFarm::DiscardReply(RDMReply*) {}
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
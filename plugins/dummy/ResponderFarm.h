@@ -0,0 +1,246 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarm.h
+ * Simulates a large number of RDM responders on a single line.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef PLUGINS_DUMMY_RESPONDERFARM_H_
+#define PLUGINS_DUMMY_RESPONDERFARM_H_
+
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Macro.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace plugin {
+namespace dummy {
+
+/**
+ * @brief A farm of simulated RDM responders.
+ *
+ * Unlike the responders attached directly to the DummyPort, the farm is
+ * discovered with the real DiscoveryAgent: it implements the
+ * DiscoveryTargetInterface, answering DUB, mute and un-mute requests the way
+ * a line of responders would. Overlapping DUB responses are reported as a
+ * framing error, which is what most controllers see. Alternatively they can
+ * be OR'ed together, which occasionally produces a valid checksum for a UID
+ * that doesn't exist.
+ *
+ * The farm contains a mix of the model responders, dimmers with sub-devices,
+ * ack timer responders and proxies. Devices behind a proxy only respond to
+ * DUB once the proxy itself has been muted, and the proxy answers
+ * PROXIED_DEVICE_COUNT and PROXIED_DEVICES.
+ *
+ * A lossy line is simulated by dropping a percentage of the responses, and a
+ * slow line by delaying each response. If a scheduler is provided every
+ * response is run from the scheduler, which avoids deep recursion when the
+ * DiscoveryAgent is used with thousands of responders.
+ */
+class ResponderFarm: public ola::rdm::DiscoveryTargetInterface,
+                     public ola::rdm::RDMControllerInterface {
+ public:
+  struct Options {
+   public:
+    Options()
+        : responder_count(0),
+          sub_device_count(4),
+          proxy_count(0),
+          devices_per_proxy(4),
+          ack_timer_percent(0),
+          loss_percent(0),
+          response_delay(0),
+          seed(1),
+          wired_or_collisions(false) {
+    }
+
+    // The number of responders, not including those behind proxies.
+    unsigned int responder_count;
+    // The number of sub-devices for each dimmer.
+    uint16_t sub_device_count;
+    // The number of the responders that are proxies.
+    unsigned int proxy_count;
+    // The number of devices behind each proxy.
+    uint8_t devices_per_proxy;
+    // The percentage of responders that use ack timers.
+    uint8_t ack_timer_percent;
+    // The percentage of responses that are lost.
+    uint8_t loss_percent;
+    // The delay before each response is delivered, in ms.
+    unsigned int response_delay;
+    // The seed used to generate UIDs and drop responses.
+    unsigned int seed;
+    // True if colliding DUB responses are OR'ed rather than corrupted.
+    bool wired_or_collisions;
+  };
+
+  /**
+   * @brief Counters for the operations the farm has handled.
+   */
+  struct Stats {
+   public:
+    Stats()
+        : branch_count(0),
+          collision_count(0),
+          mute_count(0),
+          unmute_count(0),
+          rdm_count(0),
+          lost_count(0) {
+    }
+
+    unsigned int branch_count;
+    unsigned int collision_count;
+    unsigned int mute_count;
+    unsigned int unmute_count;
+    unsigned int rdm_count;
+    unsigned int lost_count;
+  };
+
+  /**
+   * @brief Create a new ResponderFarm.
+   * @param options the Options for the farm.
+   * @param scheduler the scheduler used to deliver responses, may be NULL in
+   *   which case responses are delivered synchronously and the response delay
+   *   is ignored.
+   */
+  explicit ResponderFarm(const Options &options,
+                         ola::thread::SchedulerInterface *scheduler = NULL);
+  ~ResponderFarm();
+
+  /**
+   * @brief Get the UIDs of all the responders in the farm, including those
+   *   behind proxies.
+   */
+  void GetUIDs(ola::rdm::UIDSet *uids) const;
+
+  /**
+   * @brief The number of responders in the farm, including those behind
+   *   proxies.
+   */
+  unsigned int ResponderCount() const { return m_responders.size(); }
+
+  const Stats& GetStats() const { return m_stats; }
+  void ResetStats() { m_stats = Stats(); }
+
+  // DiscoveryTargetInterface methods.
+  void MuteDevice(const ola::rdm::UID &target,
+                  MuteDeviceCallback *mute_complete);
+  void UnMuteAll(UnMuteDeviceCallback *unmute_complete);
+  void Branch(const ola::rdm::UID &lower,
+              const ola::rdm::UID &upper,
+              BranchCallback *callback);
+
+  // RDMControllerInterface methods.
+  void SendRDMRequest(ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback);
+
+  enum { DUB_RESPONSE_LENGTH = 24 };
+
+ private:
+  struct SimulatedResponder {
+    SimulatedResponder()
+        : controller(NULL),
+          proxy(NULL),
+          muted(false) {
+    }
+
+    ola::rdm::RDMControllerInterface *controller;
+    // The proxy this responder sits behind, or NULL.
+    const SimulatedResponder *proxy;
+    // The devices behind this responder if it's a proxy.
+    std::vector<ola::rdm::UID> proxied_uids;
+    bool muted;
+  };
+
+  // A response waiting to be delivered by the scheduler.
+  struct PendingResponse {
+    PendingResponse()
+        : mute_callback(NULL),
+          unmute_callback(NULL),
+          branch_callback(NULL),
+          rdm_callback(NULL),
+          reply(NULL),
+          mute_ok(false) {
+    }
+
+    MuteDeviceCallback *mute_callback;
+    UnMuteDeviceCallback *unmute_callback;
+    BranchCallback *branch_callback;
+    ola::rdm::RDMCallback *rdm_callback;
+    ola::rdm::RDMReply *reply;
+    std::vector<uint8_t> branch_data;
+    bool mute_ok;
+  };
+
+  typedef std::map<ola::rdm::UID, SimulatedResponder> ResponderMap;
+
+  ResponderMap m_responders;
+  ola::thread::SchedulerInterface *m_scheduler;
+  const ola::TimeInterval m_response_delay;
+  const uint8_t m_loss_percent;
+  const bool m_wired_or_collisions;
+  uint32_t m_random_state;
+  Stats m_stats;
+  std::deque<PendingResponse*> m_pending_responses;
+  std::deque<ola::thread::timeout_id> m_pending_timeouts;
+
+  SimulatedResponder *AddResponder(const ola::rdm::UID &uid,
+                                   unsigned int index,
+                                   const Options &options,
+                                   const SimulatedResponder *proxy);
+  ola::rdm::UID NextUID();
+  uint32_t NextRandom();
+  bool IsLost();
+  bool IsVisible(const SimulatedResponder &responder) const;
+  bool HandleProxyRequest(const ola::rdm::RDMRequest *request,
+                          const SimulatedResponder &responder,
+                          ola::rdm::RDMCallback *callback);
+  void HandleResponderReply(ola::rdm::RDMCallback *callback,
+                            ola::rdm::RDMReply *reply);
+
+  void DeliverMute(MuteDeviceCallback *callback, bool ok);
+  void DeliverUnMute(UnMuteDeviceCallback *callback);
+  void DeliverBranch(BranchCallback *callback, const uint8_t *data,
+                     unsigned int length);
+  void DeliverRDM(ola::rdm::RDMCallback *callback, ola::rdm::RDMReply *reply);
+  void QueueResponse(PendingResponse *response);
+  void DeliverNextResponse();
+
+  static void FormDUBResponse(const ola::rdm::UID &uid, uint8_t *data);
+  static void DiscardReply(ola::rdm::RDMReply *reply);
+
+  // The number of preamble bytes before the separator.
+  static const unsigned int DUB_PREAMBLE_LENGTH = 7;
+  // The start of the range used by the DummyPort's own responders.
+  static const uint32_t DUMMY_PORT_START_ADDRESS = 0xffffff00;
+  // Proxies can report up to 38 devices without needing ACK_OVERFLOW
+  static const uint8_t MAX_DEVICES_PER_PROXY = 38;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponderFarm);
+};
+}  // namespace dummy
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_DUMMY_RESPONDERFARM_H_
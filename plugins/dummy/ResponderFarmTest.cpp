@@ -0,0 +1,245 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ResponderFarmTest.cpp
+ * Test fixture for the ResponderFarm.
+ * Copyright (C) 2026 agent
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/dummy/ResponderFarm.h"
+
+using ola::io::SelectServer;
+using ola::network::NetworkToHost;
+using ola::plugin::dummy::ResponderFarm;
+using ola::rdm::DiscoveryAgent;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+
+class ResponderFarmTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ResponderFarmTest);
+  CPPUNIT_TEST(testDiscovery);
+  CPPUNIT_TEST(testScheduledDiscovery);
+  CPPUNIT_TEST(testProxies);
+  CPPUNIT_TEST(testLoss);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    m_discovery_complete = false;
+    m_discovery_ok = false;
+    m_found_uids.Clear();
+    m_ss = NULL;
+  }
+
+  void testDiscovery();
+  void testScheduledDiscovery();
+  void testProxies();
+  void testLoss();
+
+ private:
+  bool m_discovery_complete;
+  bool m_discovery_ok;
+  UIDSet m_found_uids;
+  SelectServer *m_ss;
+  ola::rdm::RDMStatusCode m_status_code;
+  unsigned int m_ack_count;
+  unsigned int m_proxied_count;
+  bool m_mute_ok;
+
+  void DiscoveryComplete(bool ok, const UIDSet &uids) {
+    m_discovery_complete = true;
+    m_discovery_ok = ok;
+    m_found_uids = uids;
+    if (m_ss) {
+      m_ss->Terminate();
+    }
+  }
+
+  void HandleReply(RDMReply *reply) {
+    m_status_code = reply->StatusCode();
+  }
+
+  void HandleProxiedCount(RDMReply *reply) {
+    const ola::rdm::RDMResponse *response = reply->Response();
+    if (reply->StatusCode() != ola::rdm::RDM_COMPLETED_OK || !response ||
+        response->ResponseType() != ola::rdm::RDM_ACK) {
+      return;
+    }
+    OLA_ASSERT_EQ(3u, response->ParamDataSize());
+    uint16_t count;
+    memcpy(&count, response->ParamData(), sizeof(count));
+    m_ack_count++;
+    m_proxied_count += NetworkToHost(count);
+  }
+
+  void MuteComplete(bool ok) {
+    m_mute_ok = ok;
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponderFarmTest);
+
+
+/*
+ * Check the DiscoveryAgent finds every responder in the farm.
+ */
+void ResponderFarmTest::testDiscovery() {
+  ResponderFarm::Options options;
+  options.responder_count = 500;
+  options.proxy_count = 10;
+  options.devices_per_proxy = 4;
+  ResponderFarm farm(options);
+  OLA_ASSERT_EQ(540u, farm.ResponderCount());
+
+  UIDSet expected_uids;
+  farm.GetUIDs(&expected_uids);
+  OLA_ASSERT_EQ(540u, expected_uids.Size());
+
+  DiscoveryAgent agent(&farm);
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this, &ResponderFarmTest::DiscoveryComplete));
+  OLA_ASSERT_TRUE(m_discovery_complete);
+  OLA_ASSERT_TRUE(m_discovery_ok);
+  OLA_ASSERT_EQ(expected_uids, m_found_uids);
+
+  const ResponderFarm::Stats &stats = farm.GetStats();
+  OLA_ASSERT_EQ(540u, stats.mute_count);
+  OLA_ASSERT_TRUE(stats.collision_count > 0);
+
+  // An incremental discovery should only need to verify the responders.
+  farm.ResetStats();
+  m_discovery_complete = false;
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this, &ResponderFarmTest::DiscoveryComplete));
+  OLA_ASSERT_TRUE(m_discovery_complete);
+  OLA_ASSERT_EQ(expected_uids, m_found_uids);
+  OLA_ASSERT_EQ(0u, farm.GetStats().collision_count);
+}
+
+
+/*
+ * Check discovery with responses delivered by a scheduler.
+ */
+void ResponderFarmTest::testScheduledDiscovery() {
+  SelectServer ss;
+  m_ss = &ss;
+
+  ResponderFarm::Options options;
+  options.responder_count = 2000;
+  options.seed = 42;
+  ResponderFarm farm(options, &ss);
+
+  UIDSet expected_uids;
+  farm.GetUIDs(&expected_uids);
+
+  DiscoveryAgent agent(&farm);
+  agent.StartFullDiscovery(
+      ola::NewSingleCallback(this, &ResponderFarmTest::DiscoveryComplete));
+  OLA_ASSERT_FALSE(m_discovery_complete);
+  ss.Run();
+  OLA_ASSERT_TRUE(m_discovery_complete);
+  OLA_ASSERT_TRUE(m_discovery_ok);
+  OLA_ASSERT_EQ(expected_uids, m_found_uids);
+}
+
+
+/*
+ * Check the proxies respond to PROXIED_DEVICE_COUNT.
+ */
+void ResponderFarmTest::testProxies() {
+  ResponderFarm::Options options;
+  options.responder_count = 20;
+  options.proxy_count = 3;
+  options.devices_per_proxy = 5;
+  ResponderFarm farm(options);
+
+  UIDSet uids;
+  farm.GetUIDs(&uids);
+  OLA_ASSERT_EQ(35u, uids.Size());
+
+  m_ack_count = 0;
+  m_proxied_count = 0;
+  UID source(1, 2);
+  for (UIDSet::Iterator iter = uids.Begin(); iter != uids.End(); ++iter) {
+    farm.SendRDMRequest(
+        new RDMGetRequest(source, *iter, 0, 0, ola::rdm::ROOT_RDM_DEVICE,
+                          ola::rdm::PID_PROXIED_DEVICE_COUNT, NULL, 0),
+        ola::NewSingleCallback(this, &ResponderFarmTest::HandleProxiedCount));
+  }
+  OLA_ASSERT_EQ(3u, m_ack_count);
+  OLA_ASSERT_EQ(15u, m_proxied_count);
+}
+
+
+/*
+ * Check lost responses.
+ */
+void ResponderFarmTest::testLoss() {
+  ResponderFarm::Options options;
+  options.responder_count = 5;
+  options.loss_percent = 100;
+  ResponderFarm farm(options);
+
+  UIDSet uids;
+  farm.GetUIDs(&uids);
+  const UID uid = *uids.Begin();
+  UID source(1, 2);
+
+  farm.SendRDMRequest(
+      new RDMGetRequest(source, uid, 0, 0, ola::rdm::ROOT_RDM_DEVICE,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      ola::NewSingleCallback(this, &ResponderFarmTest::HandleReply));
+  OLA_ASSERT_EQ(ola::rdm::RDM_TIMEOUT, m_status_code);
+
+  farm.SendRDMRequest(
+      new RDMGetRequest(source, UID(1, 1), 0, 0, ola::rdm::ROOT_RDM_DEVICE,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      ola::NewSingleCallback(this, &ResponderFarmTest::HandleReply));
+  OLA_ASSERT_EQ(ola::rdm::RDM_UNKNOWN_UID, m_status_code);
+
+  m_mute_ok = true;
+  ola::rdm::DiscoveryTargetInterface::MuteDeviceCallback *mute_callback =
+      ola::NewCallback(this, &ResponderFarmTest::MuteComplete);
+  farm.MuteDevice(uid, mute_callback);
+  OLA_ASSERT_FALSE(m_mute_ok);
+  delete mute_callback;
+  OLA_ASSERT_EQ(2u, farm.GetStats().lost_count);
+
+  // Now without loss
+  options.loss_percent = 0;
+  ResponderFarm reliable_farm(options);
+  reliable_farm.SendRDMRequest(
+      new RDMGetRequest(source, uid, 0, 0, ola::rdm::ROOT_RDM_DEVICE,
+                        ola::rdm::PID_DEVICE_INFO, NULL, 0),
+      ola::NewSingleCallback(this, &ResponderFarmTest::HandleReply));
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_status_code);
+}
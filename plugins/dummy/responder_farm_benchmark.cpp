@@ -0,0 +1,276 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * responder_farm_benchmark.cpp
+ * Benchmark discovery and RDM requests against a simulated responder farm.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/DiscoveryAgent.h"
+#include "ola/rdm/QueueingRDMController.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "plugins/dummy/ResponderFarm.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::SelectServer;
+using ola::plugin::dummy::ResponderFarm;
+using ola::rdm::DiscoveryAgent;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(responders, r, 2000, "The number of responders in the farm.");
+DEFINE_uint32(proxies, 0, "The number of responders that are proxies.");
+DEFINE_uint8(devices_per_proxy, 4, "The number of devices behind each proxy.");
+DEFINE_uint8(ack_timer_percent, 0,
+             "The percentage of responders that use ack timers.");
+DEFINE_uint8(loss, 0, "The percentage of responses that are lost.");
+DEFINE_uint32(delay, 0, "The delay in ms before each response.");
+DEFINE_uint16(sub_devices, 4, "The number of sub-devices for each dimmer.");
+DEFINE_s_uint32(requests, n, 20000, "The number of RDM requests to send.");
+DEFINE_uint32(seed, 1, "The seed used to generate the farm.");
+DEFINE_default_bool(wired_or, false, "OR colliding DUB responses together "
+                    "rather than reporting a framing error.");
+
+/**
+ * Runs the discovery and RDM benchmarks against a ResponderFarm.
+ */
+class FarmBenchmark {
+ public:
+  explicit FarmBenchmark(const ResponderFarm::Options &options)
+      : m_farm(options, &m_ss),
+        m_agent(&m_farm),
+        m_controller(&m_farm, 1000),
+        m_source_uid(ola::OPEN_LIGHTING_ESTA_CODE, 1),
+        m_sent(0),
+        m_transaction_number(0) {
+    ResetCounters();
+  }
+
+  void RunDiscovery(bool full);
+  void RunRDM();
+
+ private:
+  SelectServer m_ss;
+  ResponderFarm m_farm;
+  DiscoveryAgent m_agent;
+  ola::rdm::QueueingRDMController m_controller;
+  Clock m_clock;
+  UIDSet m_uids;
+  UID m_source_uid;
+
+  vector<UID> m_targets;
+  vector<int64_t> m_latencies;
+  TimeStamp m_request_start;
+  unsigned int m_sent;
+  uint8_t m_transaction_number;
+  unsigned int m_acks;
+  unsigned int m_ack_timers;
+  unsigned int m_nacks;
+  unsigned int m_failures;
+
+  void ResetCounters() {
+    m_acks = m_ack_timers = m_nacks = m_failures = 0;
+  }
+
+  void DiscoveryComplete(bool ok, const UIDSet &uids);
+  void SendNextRequest();
+  void HandleReply(RDMReply *reply);
+  int64_t Percentile(unsigned int percentile) const;
+};
+
+
+void FarmBenchmark::RunDiscovery(bool full) {
+  m_farm.ResetStats();
+  TimeStamp start, end;
+  m_clock.CurrentTime(&start);
+  if (full) {
+    m_agent.StartFullDiscovery(
+        ola::NewSingleCallback(this, &FarmBenchmark::DiscoveryComplete));
+  } else {
+    m_agent.StartIncrementalDiscovery(
+        ola::NewSingleCallback(this, &FarmBenchmark::DiscoveryComplete));
+  }
+  m_ss.Run();
+  m_clock.CurrentTime(&end);
+
+  const ResponderFarm::Stats &stats = m_farm.GetStats();
+  cout << (full ? "Full" : "Incremental") << " discovery: found "
+       << m_uids.Size() << " / " << m_farm.ResponderCount()
+       << " responders in " << (end - start) << endl;
+  cout << "  DUB: " << stats.branch_count << " (" << stats.collision_count
+       << " collisions), mute: " << stats.mute_count << ", unmute: "
+       << stats.unmute_count << ", lost: " << stats.lost_count << endl;
+}
+
+
+void FarmBenchmark::RunRDM() {
+  if (m_uids.Empty() || FLAGS_requests == 0) {
+    return;
+  }
+
+  m_targets.assign(m_uids.Begin(), m_uids.End());
+  m_latencies.clear();
+  m_latencies.reserve(FLAGS_requests);
+  m_sent = 0;
+  ResetCounters();
+  m_farm.ResetStats();
+
+  TimeStamp start, end;
+  m_clock.CurrentTime(&start);
+  SendNextRequest();
+  m_ss.Run();
+  m_clock.CurrentTime(&end);
+
+  TimeInterval duration = end - start;
+  double seconds = duration.InMilliSeconds() / 1000.0;
+  std::sort(m_latencies.begin(), m_latencies.end());
+
+  cout << "RDM: " << m_latencies.size() << " requests in " << duration
+       << ", " << std::fixed << std::setprecision(0)
+       << (seconds > 0 ? m_latencies.size() / seconds : 0) << " req/s"
+       << endl;
+  cout << "  latency (us) p50: " << Percentile(50) << ", p90: "
+       << Percentile(90) << ", p99: " << Percentile(99) << ", max: "
+       << m_latencies.back() << endl;
+  cout << "  ack: " << m_acks << ", ack timer: " << m_ack_timers
+       << ", nack: " << m_nacks << ", failed: " << m_failures << endl;
+}
+
+
+void FarmBenchmark::DiscoveryComplete(bool ok, const UIDSet &uids) {
+  if (!ok) {
+    OLA_WARN << "Discovery failed";
+  }
+  m_uids = uids;
+  m_ss.Terminate();
+}
+
+
+/*
+ * Requests are sent one at a time, so the latency doesn't include time spent
+ * in the queue. Every tenth request is a SET, which the ack timer responders
+ * respond to with ACK_TIMER.
+ */
+void FarmBenchmark::SendNextRequest() {
+  static const uint16_t pids[] = {
+    ola::rdm::PID_DEVICE_INFO,
+    ola::rdm::PID_SUPPORTED_PARAMETERS,
+    ola::rdm::PID_SOFTWARE_VERSION_LABEL,
+    ola::rdm::PID_DMX_START_ADDRESS,
+    ola::rdm::PID_IDENTIFY_DEVICE,
+  };
+  static const uint8_t identify_off = 0;
+
+  if (m_sent == FLAGS_requests) {
+    m_ss.Terminate();
+    return;
+  }
+
+  const UID &target = m_targets[m_sent % m_targets.size()];
+  ola::rdm::RDMRequest *request;
+  if (m_sent % 10 == 9) {
+    request = new RDMSetRequest(m_source_uid, target, m_transaction_number++,
+                                1, ola::rdm::ROOT_RDM_DEVICE,
+                                ola::rdm::PID_IDENTIFY_DEVICE, &identify_off,
+                                sizeof(identify_off));
+  } else {
+    uint16_t pid = pids[m_sent % (sizeof(pids) / sizeof(pids[0]))];
+    request = new RDMGetRequest(m_source_uid, target, m_transaction_number++,
+                                1, ola::rdm::ROOT_RDM_DEVICE, pid, NULL, 0);
+  }
+  m_sent++;
+
+  m_clock.CurrentTime(&m_request_start);
+  m_controller.SendRDMRequest(
+      request, ola::NewSingleCallback(this, &FarmBenchmark::HandleReply));
+}
+
+
+void FarmBenchmark::HandleReply(RDMReply *reply) {
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  m_latencies.push_back((now - m_request_start).AsInt());
+
+  const ola::rdm::RDMResponse *response = reply->Response();
+  if (reply->StatusCode() != ola::rdm::RDM_COMPLETED_OK || !response) {
+    m_failures++;
+  } else if (response->ResponseType() == ola::rdm::RDM_ACK) {
+    m_acks++;
+  } else if (response->ResponseType() == ola::rdm::RDM_ACK_TIMER) {
+    m_ack_timers++;
+  } else {
+    m_nacks++;
+  }
+
+  // The farm delivers replies from the scheduler, so this doesn't recurse.
+  SendNextRequest();
+}
+
+
+int64_t FarmBenchmark::Percentile(unsigned int percentile) const {
+  unsigned int index = m_latencies.size() * percentile / 100;
+  return m_latencies[std::min(index,
+                              static_cast<unsigned int>(m_latencies.size()) -
+                              1)];
+}
+
+
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Benchmark RDM discovery and RDM requests against a simulated "
+               "farm of responders.");
+
+  ResponderFarm::Options options;
+  options.responder_count = FLAGS_responders;
+  options.proxy_count = FLAGS_proxies;
+  options.devices_per_proxy = FLAGS_devices_per_proxy;
+  options.ack_timer_percent = FLAGS_ack_timer_percent;
+  options.loss_percent = FLAGS_loss;
+  options.response_delay = FLAGS_delay;
+  options.sub_device_count = FLAGS_sub_devices;
+  options.seed = FLAGS_seed;
+  options.wired_or_collisions = FLAGS_wired_or;
+
+  FarmBenchmark benchmark(options);
+  benchmark.RunDiscovery(true);
+  benchmark.RunDiscovery(false);
+  benchmark.RunRDM();
+  return 0;
+}
@@ -20,6 +20,11 @@
 
 #include "plugins/openpixelcontrol/OPCClient.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
@@ -36,6 +41,8 @@ namespace openpixelcontrol {
 
 using ola::TimeInterval;
 using ola::network::TCPSocket;
+using std::set;
+using std::vector;
 
 OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
                      const ola::network::IPV4SocketAddress &target)
@@ -44,11 +51,15 @@ OPCClient::OPCClient(ola::io::SelectServerInterface *ss,
       m_backoff(TimeInterval(1, 0), TimeInterval(300, 0)),
       m_pool(OPC_FRAME_SIZE),
       m_socket_factory(NewCallback(this, &OPCClient::SocketConnected)),
-      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)) {
+      m_tcp_connector(ss, &m_socket_factory, TimeInterval(3, 0)),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT) {
   m_tcp_connector.AddEndpoint(target, &m_backoff);
 }
 
 OPCClient::~OPCClient() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_flush_timeout);
+  }
   if (m_client_socket.get()) {
     m_ss->RemoveReadDescriptor(m_client_socket.get());
     m_tcp_connector.Disconnect(m_target, true);
@@ -56,6 +67,37 @@ OPCClient::~OPCClient() {
 }
 
 bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer) {
+  return SendFrame(channel, buffer.GetRaw(), buffer.Size());
+}
+
+bool OPCClient::QueueDmx(uint8_t channel, unsigned int offset,
+                         const uint8_t *data, unsigned int length) {
+  if (!m_sender.get()) {
+    return false;  // not connected
+  }
+
+  if (offset >= OPC_MAX_DATA_SIZE) {
+    OLA_WARN << "OPC offset " << offset << " is out of range";
+    return false;
+  }
+
+  length = std::min(length, OPC_MAX_DATA_SIZE - offset);
+  vector<uint8_t> &frame = m_frames[channel];
+  if (frame.size() < offset + length) {
+    frame.resize(offset + length, 0);
+  }
+  std::copy(data, data + length, frame.begin() + offset);
+
+  m_dirty_channels.insert(channel);
+  if (m_flush_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_flush_timeout = m_ss->RegisterSingleTimeout(
+        0, NewSingleCallback(this, &OPCClient::FlushFrames));
+  }
+  return true;
+}
+
+bool OPCClient::SendFrame(uint8_t channel, const uint8_t *data,
+                          unsigned int length) {
   if (!m_sender.get()) {
     return false;  // not connected
   }
@@ -64,11 +106,24 @@ bool OPCClient::SendDmx(uint8_t channel, const DmxBuffer &buffer) {
   ola::io::BigEndianOutputStream stream(&queue);
   stream << channel;
   stream << SET_PIXEL_COMMAND;
-  stream << static_cast<uint16_t>(buffer.Size());
-  stream.Write(buffer.GetRaw(), buffer.Size());
+  stream << static_cast<uint16_t>(length);
+  stream.Write(data, length);
   return m_sender->SendMessage(&queue);
 }
 
+void OPCClient::FlushFrames() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+
+  set<uint8_t>::const_iterator iter = m_dirty_channels.begin();
+  for (; iter != m_dirty_channels.end(); ++iter) {
+    const vector<uint8_t> &frame = m_frames[*iter];
+    if (!frame.empty()) {
+      SendFrame(*iter, &frame[0], frame.size());
+    }
+  }
+  m_dirty_channels.clear();
+}
+
 void OPCClient::SetSocketCallback(SocketEventCallback *callback) {
   m_socket_callback.reset(callback);
 }
@@ -99,6 +154,7 @@ void OPCClient::NewData() {
 }
 
 void OPCClient::SocketClosed() {
+  m_dirty_channels.clear();
   m_sender.reset();
   m_client_socket.reset();
 
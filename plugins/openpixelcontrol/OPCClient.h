@@ -21,8 +21,11 @@
 #ifndef PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 #define PLUGINS_OPENPIXELCONTROL_OPCCLIENT_H_
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "ola/DmxBuffer.h"
 #include "ola/io/MemoryBlockPool.h"
@@ -79,6 +82,21 @@ class OPCClient {
    */
   bool SendDmx(uint8_t channel, const DmxBuffer &buffer);
 
+  /**
+   * @brief Update part of the frame for a channel.
+   * @param channel the OPC channel to use.
+   * @param offset the offset of the data within the channel's frame.
+   * @param data the pixel data.
+   * @param length the length of the pixel data.
+   * @returns true if the client is connected, false otherwise.
+   *
+   * Updates made to a channel during an iteration of the event loop are sent
+   * as a single OPC message once the iteration completes. This allows one
+   * channel to be fed from multiple universes.
+   */
+  bool QueueDmx(uint8_t channel, unsigned int offset, const uint8_t *data,
+                unsigned int length);
+
   /**
    * @brief Set the callback to be run when the socket state changes.
    * @param callback the callback to run when the socket state changes.
@@ -98,6 +116,12 @@ class OPCClient {
   std::auto_ptr<ola::io::NonBlockingSender> m_sender;
   std::auto_ptr<SocketEventCallback> m_socket_callback;
 
+  std::map<uint8_t, std::vector<uint8_t> > m_frames;
+  std::set<uint8_t> m_dirty_channels;
+  ola::thread::timeout_id m_flush_timeout;
+
+  bool SendFrame(uint8_t channel, const uint8_t *data, unsigned int length);
+  void FlushFrames();
   void SocketConnected(ola::network::TCPSocket *socket);
   void NewData();
   void SocketClosed();
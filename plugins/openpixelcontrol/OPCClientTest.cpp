@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <memory>
+#include <string>
 #include "ola/base/Array.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
@@ -44,26 +45,34 @@ using std::auto_ptr;
 class OPCClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OPCClientTest);
   CPPUNIT_TEST(testTransmit);
+  CPPUNIT_TEST(testQueuedTransmit);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCClientTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_command(0),
+        m_frame_count(0) {
   }
   void setUp();
 
   void testTransmit();
+  void testQueuedTransmit();
 
  private:
   ola::io::SelectServer m_ss;
   auto_ptr<OPCServer> m_server;
   DmxBuffer m_received_data;
   uint8_t m_command;
+  std::string m_received_frame;
+  unsigned int m_frame_count;
 
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
+    m_received_frame.assign(reinterpret_cast<const char*>(data), length);
     m_command = command;
+    m_frame_count++;
     m_ss.Terminate();
   }
 
@@ -75,6 +84,18 @@ class OPCClientTest: public CppUnit::TestFixture {
     }
   }
 
+  void QueueDMX(OPCClient *client, bool connected) {
+    if (connected) {
+      const uint8_t first[] = {1, 2, 3};
+      const uint8_t second[] = {4, 5};
+      OLA_ASSERT_TRUE(client->QueueDmx(CHANNEL, 0, first, arraysize(first)));
+      OLA_ASSERT_TRUE(client->QueueDmx(CHANNEL, 510, second,
+                                       arraysize(second)));
+    } else {
+      m_ss.Terminate();
+    }
+  }
+
   static const uint8_t CHANNEL = 1;
 };
 
@@ -111,3 +132,27 @@ void OPCClientTest::testTransmit() {
   // Now sends should fail since there is no connection
   OLA_ASSERT_FALSE(client.SendDmx(CHANNEL, buffer));
 }
+
+/*
+ * Check that data queued for a channel is sent as a single frame.
+ */
+void OPCClientTest::testQueuedTransmit() {
+  OPCClient client(&m_ss, m_server->ListenAddress());
+  client.SetSocketCallback(
+      ola::NewCallback(this, &OPCClientTest::QueueDMX, &client));
+
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_frame_count);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), m_command);
+  OLA_ASSERT_EQ(static_cast<size_t>(512), m_received_frame.size());
+  OLA_ASSERT_EQ('\x01', m_received_frame[0]);
+  OLA_ASSERT_EQ('\x03', m_received_frame[2]);
+  OLA_ASSERT_EQ('\x00', m_received_frame[3]);
+  OLA_ASSERT_EQ('\x04', m_received_frame[510]);
+  OLA_ASSERT_EQ('\x05', m_received_frame[511]);
+
+  // Queueing fails once the connection is closed.
+  m_server.reset();
+  m_ss.Run();
+  OLA_ASSERT_FALSE(client.QueueDmx(CHANNEL, 0, NULL, 0));
+}
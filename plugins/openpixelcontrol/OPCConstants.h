@@ -39,6 +39,30 @@ enum {
    * @brief The size of an OPC frame with DMX512 data.
    */
   OPC_FRAME_SIZE = DMX_UNIVERSE_SIZE + OPC_HEADER_SIZE,
+
+  /**
+   * @brief The largest amount of data an OPC frame can carry.
+   */
+  OPC_MAX_DATA_SIZE = 0xffff,
+
+  /**
+   * @brief The size of the largest possible OPC frame.
+   */
+  OPC_MAX_FRAME_SIZE = OPC_MAX_DATA_SIZE + OPC_HEADER_SIZE,
+
+  /**
+   * @brief The number of slots used per universe when a channel spans
+   * multiple universes.
+   *
+   * This is 170 RGB pixels, so that a pixel is never split across universes.
+   */
+  OPC_SPAN_UNIVERSE_SIZE = 510,
+
+  /**
+   * @brief The maximum number of universes a channel can span.
+   */
+  OPC_MAX_SPAN = (OPC_MAX_DATA_SIZE + OPC_SPAN_UNIVERSE_SIZE - 1) /
+                 OPC_SPAN_UNIVERSE_SIZE,
 };
 
 /**
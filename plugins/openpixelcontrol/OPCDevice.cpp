@@ -26,7 +26,10 @@
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/stl/STLUtils.h"
 #include "olad/Preferences.h"
+#include "plugins/openpixelcontrol/OPCConstants.h"
 #include "plugins/openpixelcontrol/OPCPort.h"
 
 namespace ola {
@@ -55,6 +58,26 @@ set<uint8_t> DeDupChannels(const vector<string> &channels) {
   }
   return output;
 }
+
+/*
+ * Return the number of universes a channel is spread across.
+ */
+unsigned int ChannelSpan(Preferences *preferences, const string &prefix,
+                         uint8_t channel) {
+  ostringstream str;
+  str << prefix << "_channel_" << static_cast<int>(channel) << "_universes";
+  const string value = preferences->GetValue(str.str());
+  if (value.empty()) {
+    return 1;
+  }
+
+  unsigned int span;
+  if (!StringToInt(value, &span) || span == 0 || span > OPC_MAX_SPAN) {
+    OLA_WARN << "Invalid value for " << str.str() << ": " << value;
+    return 1;
+  }
+  return span;
+}
 }  // namespace
 
 OPCServerDevice::OPCServerDevice(
@@ -79,18 +102,54 @@ bool OPCServerDevice::StartHook() {
   }
 
   ostringstream str;
-  str << "listen_" << m_listen_addr << "_channel";
+  str << "listen_" << m_listen_addr;
+  const string prefix = str.str();
   set<uint8_t> channels = DeDupChannels(
-      m_preferences->GetMultipleValue(str.str()));
+      m_preferences->GetMultipleValue(prefix + "_channel"));
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCInputPort *port = new OPCInputPort(this, *iter, m_plugin_adaptor,
-                                          m_server.get());
-    AddPort(port);
+    unsigned int span = ChannelSpan(m_preferences, prefix, *iter);
+    vector<OPCInputPort*> &ports = m_channel_ports[*iter];
+    for (unsigned int segment = 0; segment < span; segment++) {
+      OPCInputPort *port = new OPCInputPort(this, *iter, segment, span,
+                                            m_plugin_adaptor, m_server.get());
+      ports.push_back(port);
+      AddPort(port);
+    }
+    m_server->SetCallback(
+        *iter, NewCallback(this, &OPCServerDevice::ChannelData, *iter));
   }
   return true;
 }
 
+void OPCServerDevice::ChannelData(uint8_t channel, uint8_t command,
+                                  const uint8_t *data, unsigned int length) {
+  if (command != SET_PIXEL_COMMAND) {
+    OLA_DEBUG << "Received an unknown OPC command: "
+              << static_cast<int>(command);
+    return;
+  }
+
+  vector<OPCInputPort*> *ports = STLFind(&m_channel_ports, channel);
+  if (!ports) {
+    return;
+  }
+
+  // Update the data for all the ports before notifying any of the universes,
+  // so the frame is applied as a whole. The ports are ordered by offset, so
+  // once a port is past the end of the frame the remaining ones are too.
+  unsigned int updated = 0;
+  for (; updated < ports->size(); updated++) {
+    if (!(*ports)[updated]->UpdateData(data, length)) {
+      break;
+    }
+  }
+
+  for (unsigned int i = 0; i < updated; i++) {
+    (*ports)[i]->DmxChanged();
+  }
+}
+
 OPCClientDevice::OPCClientDevice(AbstractPlugin *owner,
                                  PluginAdaptor *plugin_adaptor,
                                  Preferences *preferences,
@@ -108,13 +167,16 @@ string OPCClientDevice::DeviceId() const {
 
 bool OPCClientDevice::StartHook() {
   ostringstream str;
-  str << "target_" << m_target << "_channel";
+  str << "target_" << m_target;
+  const string prefix = str.str();
   set<uint8_t> channels = DeDupChannels(
-      m_preferences->GetMultipleValue(str.str()));
+      m_preferences->GetMultipleValue(prefix + "_channel"));
   set<uint8_t>::const_iterator iter = channels.begin();
   for (; iter != channels.end(); ++iter) {
-    OPCOutputPort *port = new OPCOutputPort(this, *iter, m_client.get());
-    AddPort(port);
+    unsigned int span = ChannelSpan(m_preferences, prefix, *iter);
+    for (unsigned int segment = 0; segment < span; segment++) {
+      AddPort(new OPCOutputPort(this, *iter, segment, span, m_client.get()));
+    }
   }
   return true;
 }
@@ -21,8 +21,10 @@
 #ifndef PLUGINS_OPENPIXELCONTROL_OPCDEVICE_H_
 #define PLUGINS_OPENPIXELCONTROL_OPCDEVICE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ola/network/Socket.h"
 #include "olad/Device.h"
@@ -62,6 +64,10 @@ class OPCServerDevice: public ola::Device {
   Preferences* const m_preferences;
   const ola::network::IPV4SocketAddress m_listen_addr;
   std::auto_ptr<class OPCServer> m_server;
+  std::map<uint8_t, std::vector<class OPCInputPort*> > m_channel_ports;
+
+  void ChannelData(uint8_t channel, uint8_t command, const uint8_t *data,
+                   unsigned int length);
 
   DISALLOW_COPY_AND_ASSIGN(OPCServerDevice);
 };
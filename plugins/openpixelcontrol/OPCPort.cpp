@@ -20,7 +20,10 @@
 
 #include "plugins/openpixelcontrol/OPCPort.h"
 
+#include <algorithm>
+#include <sstream>
 #include <string>
+#include "ola/Constants.h"
 #include "ola/base/Macro.h"
 #include "plugins/openpixelcontrol/OPCClient.h"
 #include "plugins/openpixelcontrol/OPCConstants.h"
@@ -33,52 +36,89 @@ namespace openpixelcontrol {
 
 using std::string;
 
+namespace {
+
+/*
+ * The first port for a channel uses the channel number as the port id, so
+ * that existing patchings are preserved when a channel is spread over more
+ * ports.
+ */
+unsigned int SegmentPortId(uint8_t channel, unsigned int segment) {
+  return (segment << 8) + channel;
+}
+
+unsigned int SegmentSize(unsigned int span) {
+  if (span > 1) {
+    return OPC_SPAN_UNIVERSE_SIZE;
+  }
+  return DMX_UNIVERSE_SIZE;
+}
+
+void AppendSegment(std::ostream *out, uint8_t channel, unsigned int offset,
+                   unsigned int size, bool spanned) {
+  *out << ", Channel " << static_cast<int>(channel);
+  if (spanned) {
+    *out << ", slots " << offset + 1 << "-" << offset + size;
+  }
+}
+}  // namespace
+
 OPCInputPort::OPCInputPort(OPCServerDevice *parent,
                            uint8_t channel,
+                           unsigned int segment,
+                           unsigned int span,
                            class PluginAdaptor *plugin_adaptor,
                            class OPCServer *server)
-    : BasicInputPort(parent, channel, plugin_adaptor),
+    : BasicInputPort(parent, SegmentPortId(channel, segment), plugin_adaptor),
       m_channel(channel),
+      m_offset(segment * SegmentSize(span)),
+      m_size(SegmentSize(span)),
+      m_spanned(span > 1),
       m_server(server) {
-  m_server->SetCallback(channel, NewCallback(this, &OPCInputPort::NewData));
 }
 
-void OPCInputPort::NewData(uint8_t command,
-                           const uint8_t *data,
-                           unsigned int length) {
-  if (command != SET_PIXEL_COMMAND) {
-    OLA_DEBUG << "Received an unknown OPC command: "
-              << static_cast<int>(command);
-    return;
+bool OPCInputPort::UpdateData(const uint8_t *data, unsigned int length) {
+  if (m_offset && m_offset >= length) {
+    return false;
   }
-  m_buffer.Set(data, length);
-  DmxChanged();
+  m_buffer.Set(data + m_offset, std::min(length - m_offset, m_size));
+  return true;
 }
 
 string OPCInputPort::Description() const {
   std::ostringstream str;
-  str << m_server->ListenAddress() << ", Channel "
-      << static_cast<int>(m_channel);
+  str << m_server->ListenAddress();
+  AppendSegment(&str, m_channel, m_offset, m_size, m_spanned);
   return str.str();
 }
 
 OPCOutputPort::OPCOutputPort(OPCClientDevice *parent,
                              uint8_t channel,
+                             unsigned int segment,
+                             unsigned int span,
                              OPCClient *client)
-    : BasicOutputPort(parent, channel),
+    : BasicOutputPort(parent, SegmentPortId(channel, segment)),
       m_client(client),
-      m_channel(channel) {
+      m_channel(channel),
+      m_offset(segment * SegmentSize(span)),
+      m_size(SegmentSize(span)),
+      m_spanned(span > 1) {
 }
 
 bool OPCOutputPort::WriteDMX(const DmxBuffer &buffer,
                              OLA_UNUSED uint8_t priority) {
-  return m_client->SendDmx(m_channel, buffer);
+  if (!m_spanned) {
+    return m_client->SendDmx(m_channel, buffer);
+  }
+
+  return m_client->QueueDmx(m_channel, m_offset, buffer.GetRaw(),
+                            std::min(buffer.Size(), m_size));
 }
 
 string OPCOutputPort::Description() const {
   std::ostringstream str;
-  str << m_client->GetRemoteAddress() << ", Channel "
-      << static_cast<int>(m_channel);
+  str << m_client->GetRemoteAddress();
+  AppendSegment(&str, m_channel, m_offset, m_size, m_spanned);
   return str.str();
 }
 }  // namespace openpixelcontrol
@@ -41,11 +41,15 @@ class OPCInputPort: public BasicInputPort {
    * @brief Create a new OPC Input Port.
    * @param parent the OPCDevice this port belongs to
    * @param channel the OPC channel for the port.
+   * @param segment the index of this port within the channel.
+   * @param span the number of ports the channel is spread across.
    * @param plugin_adaptor the PluginAdaptor to use
    * @param server the OPCServer to use, ownership is not transferred.
    */
   OPCInputPort(OPCServerDevice *parent,
                uint8_t channel,
+               unsigned int segment,
+               unsigned int span,
                class PluginAdaptor *plugin_adaptor,
                class OPCServer *server);
 
@@ -55,13 +59,25 @@ class OPCInputPort: public BasicInputPort {
 
   std::string Description() const;
 
+  /**
+   * @brief Update this port from an OPC set-pixel frame.
+   * @param data the pixel data for the channel.
+   * @param length the length of the pixel data.
+   * @returns true if the frame contained data for this port, false otherwise.
+   *
+   * This doesn't call DmxChanged(), so that all the ports for a channel can
+   * be updated before any of the universes are notified.
+   */
+  bool UpdateData(const uint8_t *data, unsigned int length);
+
  private:
   const uint8_t m_channel;
+  const unsigned int m_offset;
+  const unsigned int m_size;
+  const bool m_spanned;
   class OPCServer* const m_server;
   DmxBuffer m_buffer;
 
-  void NewData(uint8_t command, const uint8_t *data, unsigned int length);
-
   DISALLOW_COPY_AND_ASSIGN(OPCInputPort);
 };
 
@@ -74,11 +90,15 @@ class OPCOutputPort: public BasicOutputPort {
    * @brief Create a new OPC Output Port.
    * @param parent the OPCDevice this port belongs to
    * @param channel the OPC channel for the port.
+   * @param segment the index of this port within the channel.
+   * @param span the number of ports the channel is spread across.
    * @param client the OPCClient to use for this port, ownership is not
    *   transferred.
    */
   OPCOutputPort(OPCClientDevice *parent,
                 uint8_t channel,
+                unsigned int segment,
+                unsigned int span,
                 class OPCClient *client);
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
@@ -88,6 +108,9 @@ class OPCOutputPort: public BasicOutputPort {
  private:
   class OPCClient* const m_client;
   const uint8_t m_channel;
+  const unsigned int m_offset;
+  const unsigned int m_size;
+  const bool m_spanned;
 
   DISALLOW_COPY_AND_ASSIGN(OPCOutputPort);
 };
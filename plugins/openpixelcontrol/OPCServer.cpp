@@ -20,6 +20,7 @@
 
 #include "plugins/openpixelcontrol/OPCServer.h"
 
+#include <string.h>
 #include <string>
 #include "ola/Callback.h"
 #include "ola/Logging.h"
@@ -45,24 +46,13 @@ void CleanupSocket(TCPSocket *socket) {
 }
 }  // namespace
 
-void OPCServer::RxState::CheckSize() {
-  expected_size = utils::JoinUInt8(data[2], data[3]);
-  if (static_cast<unsigned int>(expected_size) + OPC_HEADER_SIZE >
-      buffer_size) {
-    uint8_t *new_buffer = new uint8_t[expected_size + OPC_HEADER_SIZE];
-    memcpy(new_buffer, data, offset);
-    delete[] data;
-    data = new_buffer;
-    buffer_size = expected_size + OPC_HEADER_SIZE;
-  }
-}
-
 OPCServer::OPCServer(ola::io::SelectServerInterface *ss,
                      const ola::network::IPV4SocketAddress &listen_addr)
     : m_ss(ss),
       m_listen_addr(listen_addr),
       m_tcp_socket_factory(
-          ola::NewCallback(this, &OPCServer::NewTCPConnection)) {
+          ola::NewCallback(this, &OPCServer::NewTCPConnection)),
+      m_pool(OPC_MAX_FRAME_SIZE) {
 }
 
 OPCServer::~OPCServer() {
@@ -75,8 +65,9 @@ OPCServer::~OPCServer() {
   for (; iter != m_clients.end(); ++iter) {
     m_ss->RemoveReadDescriptor(iter->first);
     delete iter->first;
-    delete iter->second;
+    ReleaseRxState(iter->second);
   }
+  m_clients.clear();
 
   STLDeleteValues(&m_callbacks);
 }
@@ -110,7 +101,14 @@ void OPCServer::NewTCPConnection(TCPSocket *socket) {
   if (!socket)
     return;
 
-  RxState *rx_state = new RxState();
+  ola::io::MemoryBlock *block = m_pool.Allocate();
+  if (!block) {
+    OLA_WARN << "Failed to allocate a receive buffer for "
+             << socket->GetPeerAddress();
+    delete socket;
+    return;
+  }
+  RxState *rx_state = new RxState(block);
 
   socket->SetNoDelay();
   socket->SetOnData(
@@ -118,13 +116,17 @@ void OPCServer::NewTCPConnection(TCPSocket *socket) {
   socket->SetOnClose(
       NewSingleCallback(this, &OPCServer::SocketClosed, socket));
   m_ss->AddReadDescriptor(socket);
-  STLReplaceAndDelete(&m_clients, socket, rx_state);
+
+  RxState *old_state = STLReplacePtr(&m_clients, socket, rx_state);
+  if (old_state) {
+    ReleaseRxState(old_state);
+  }
 }
 
 void OPCServer::SocketReady(TCPSocket *socket, RxState *rx_state) {
   unsigned int data_received = 0;
-  if (socket->Receive(rx_state->data + rx_state->offset,
-                      rx_state->buffer_size - rx_state->offset,
+  if (socket->Receive(rx_state->Data() + rx_state->offset,
+                      rx_state->Remaining(),
                       data_received) < 0) {
     OLA_WARN << "Bad read from " << socket->GetPeerAddress();
     SocketClosed(socket);
@@ -132,36 +134,50 @@ void OPCServer::SocketReady(TCPSocket *socket, RxState *rx_state) {
   }
 
   rx_state->offset += data_received;
-  if (rx_state->offset < OPC_HEADER_SIZE) {
-    return;
-  }
 
-  rx_state->CheckSize();
-  if (rx_state->offset <
-      static_cast<unsigned int>(rx_state->expected_size) + OPC_HEADER_SIZE) {
-    return;
+  // A single read may contain more than one frame, dispatch all the complete
+  // frames and then move any partial frame to the start of the buffer.
+  const uint8_t *data = rx_state->Data();
+  unsigned int consumed = 0;
+  while (rx_state->offset - consumed >= OPC_HEADER_SIZE) {
+    const uint8_t *frame = data + consumed;
+    unsigned int frame_size = OPC_HEADER_SIZE +
+                              utils::JoinUInt8(frame[2], frame[3]);
+    if (rx_state->offset - consumed < frame_size) {
+      break;
+    }
+
+    ChannelCallback *cb = STLFindOrNull(m_callbacks, frame[0]);
+    if (cb) {
+      cb->Run(frame[1], frame + OPC_HEADER_SIZE,
+              frame_size - OPC_HEADER_SIZE);
+    }
+    consumed += frame_size;
   }
 
-  ChannelCallback *cb = STLFindOrNull(m_callbacks, rx_state->data[0]);
-  if (cb) {
-    DmxBuffer buffer(rx_state->data + OPC_HEADER_SIZE,
-                     rx_state->offset - OPC_HEADER_SIZE);
-    cb->Run(rx_state->data[1],
-            rx_state->data + OPC_HEADER_SIZE,
-            rx_state->expected_size);
+  if (consumed) {
+    rx_state->offset -= consumed;
+    memmove(rx_state->Data(), data + consumed, rx_state->offset);
   }
-  rx_state->offset = 0;
-  rx_state->expected_size = 0;
 }
 
 void OPCServer::SocketClosed(TCPSocket *socket) {
   m_ss->RemoveReadDescriptor(socket);
-  STLRemoveAndDelete(&m_clients, socket);
+
+  RxState *rx_state = STLLookupAndRemovePtr(&m_clients, socket);
+  if (rx_state) {
+    ReleaseRxState(rx_state);
+  }
 
   // Since we're in the call stack of the socket, we schedule deletion during
   // the next run of the event loop to break out of the stack.
   m_ss->Execute(NewSingleCallback(&CleanupSocket, socket));
 }
+
+void OPCServer::ReleaseRxState(RxState *rx_state) {
+  m_pool.Release(rx_state->block);
+  delete rx_state;
+}
 }  // namespace openpixelcontrol
 }  // namespace plugin
 }  // namespace ola
@@ -26,6 +26,8 @@
 #include <memory>
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/io/MemoryBlock.h"
+#include "ola/io/MemoryBlockPool.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/SocketAddress.h"
 #include "ola/network/TCPSocket.h"
@@ -85,25 +87,25 @@ class OPCServer {
   ola::network::IPV4SocketAddress ListenAddress() const;
 
  private:
+  /**
+   * @brief The receive state for a client connection.
+   *
+   * The receive buffer is taken from the server's MemoryBlockPool and is
+   * large enough to hold the largest possible OPC frame, so it never needs to
+   * grow.
+   */
   struct RxState {
    public:
+    ola::io::MemoryBlock *block;
     unsigned int offset;
-    uint16_t expected_size;
-    uint8_t *data;
-    unsigned int buffer_size;
-
-    RxState()
-        : offset(0),
-          expected_size(0) {
-      buffer_size = OPC_FRAME_SIZE,
-      data = new uint8_t[buffer_size];
-    }
 
-    ~RxState() {
-      delete[] data;
+    explicit RxState(ola::io::MemoryBlock *block)
+        : block(block),
+          offset(0) {
     }
 
-    void CheckSize();
+    uint8_t *Data() const { return block->Data(); }
+    unsigned int Remaining() const { return block->Capacity() - offset; }
   };
 
   typedef std::map<ola::network::TCPSocket*, RxState*> ClientMap;
@@ -112,6 +114,8 @@ class OPCServer {
   const ola::network::IPV4SocketAddress m_listen_addr;
   ola::network::TCPSocketFactory m_tcp_socket_factory;
 
+  ola::io::MemoryBlockPool m_pool;
+
   std::auto_ptr<ola::network::TCPAcceptingSocket> m_listening_socket;
   ClientMap m_clients;
   std::map<uint8_t, ChannelCallback*> m_callbacks;
@@ -119,6 +123,7 @@ class OPCServer {
   void NewTCPConnection(ola::network::TCPSocket *socket);
   void SocketReady(ola::network::TCPSocket *socket, RxState *rx_state);
   void SocketClosed(ola::network::TCPSocket *socket);
+  void ReleaseRxState(RxState *rx_state);
 
   DISALLOW_COPY_AND_ASSIGN(OPCServer);
 };
@@ -47,12 +47,15 @@ class OPCServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUnknownCommand);
   CPPUNIT_TEST(testLargeFrame);
   CPPUNIT_TEST(testHangingFrame);
+  CPPUNIT_TEST(testMultipleFrames);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   OPCServerTest()
       : CppUnit::TestFixture(),
-        m_ss(NULL) {
+        m_ss(NULL),
+        m_command(0),
+        m_frame_count(0) {
   }
   void setUp();
 
@@ -60,6 +63,7 @@ class OPCServerTest: public CppUnit::TestFixture {
   void testUnknownCommand();
   void testLargeFrame();
   void testHangingFrame();
+  void testMultipleFrames();
 
  private:
   ola::io::SelectServer m_ss;
@@ -67,6 +71,7 @@ class OPCServerTest: public CppUnit::TestFixture {
   auto_ptr<TCPSocket> m_client_socket;
   DmxBuffer m_received_data;
   uint8_t m_command;
+  unsigned int m_frame_count;
 
   void SendDataAndCheck(uint8_t channel,
                         const DmxBuffer &data);
@@ -74,6 +79,7 @@ class OPCServerTest: public CppUnit::TestFixture {
   void CaptureData(uint8_t command, const uint8_t *data, unsigned int length) {
     m_received_data.Set(data, length);
     m_command = command;
+    m_frame_count++;
     m_ss.Terminate();
   }
 
@@ -151,3 +157,30 @@ void OPCServerTest::testHangingFrame() {
   uint8_t data[] = {1, 0};
   m_client_socket->Send(data, arraysize(data));
 }
+
+/*
+ * Check that multiple frames arriving in a single read are all delivered.
+ */
+void OPCServerTest::testMultipleFrames() {
+  uint8_t data[] = {
+    1, 0, 0, 3, 1, 2, 3,
+    1, 0, 0, 2, 4, 5,
+    1, 0, 0, 4, 6, 7
+  };
+  m_client_socket->Send(data, arraysize(data));
+  m_ss.Run();
+
+  DmxBuffer buffer;
+  buffer.SetFromString("4,5");
+  OLA_ASSERT_EQ(2u, m_frame_count);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+
+  // Now complete the partial frame.
+  uint8_t remainder[] = {8, 9};
+  m_client_socket->Send(remainder, arraysize(remainder));
+  m_ss.Run();
+
+  buffer.SetFromString("6,7,8,9");
+  OLA_ASSERT_EQ(3u, m_frame_count);
+  OLA_ASSERT_EQ(m_received_data, buffer);
+}
@@ -43,6 +43,7 @@ class OSCPlugin: public ola::Plugin {
     std::string Description() const;
     ola_plugin_id Id() const { return OLA_PLUGIN_OSC; }
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+    bool CanStartInParallel() const { return true; }
 
  private:
     bool StartHook();
@@ -27,7 +27,7 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/util/Utils.h"
-#include "plugins/usbdmx/AsyncUsbSender.h"
+#include "plugins/usbdmx/PipelinedUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
 namespace ola {
@@ -190,15 +190,15 @@ bool SynchronousEurolitePro::SendDMX(const DmxBuffer &buffer) {
 
 // EuroliteProAsyncUsbSender
 // -----------------------------------------------------------------------------
-class EuroliteProAsyncUsbSender : public AsyncUsbSender {
+class EuroliteProAsyncUsbSender : public PipelinedUsbSender {
  public:
   EuroliteProAsyncUsbSender(LibUsbAdaptor *adaptor,
                             libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : PipelinedUsbSender(adaptor, usb_device, DEFAULT_DEPTH) {
   }
 
   ~EuroliteProAsyncUsbSender() {
-    CancelTransfer();
+    CancelTransfers();
   }
 
   libusb_device_handle* SetupHandle() {
@@ -213,15 +213,14 @@ class EuroliteProAsyncUsbSender : public AsyncUsbSender {
     return ok ? usb_handle : NULL;
   }
 
-  bool PerformTransfer(const DmxBuffer &buffer) {
-    CreateFrame(buffer, m_tx_frame);
-    FillBulkTransfer(ENDPOINT, m_tx_frame, EUROLITE_PRO_FRAME_SIZE,
-                     URB_TIMEOUT_MS);
-    return (SubmitTransfer() == 0);
+  void FillTransfer(const DmxBuffer &buffer, unsigned int slot) {
+    CreateFrame(buffer, m_tx_frames[slot]);
+    FillBulkTransfer(slot, ENDPOINT, m_tx_frames[slot],
+                     EUROLITE_PRO_FRAME_SIZE, URB_TIMEOUT_MS);
   }
 
  private:
-  uint8_t m_tx_frame[EUROLITE_PRO_FRAME_SIZE];
+  uint8_t m_tx_frames[DEFAULT_DEPTH][EUROLITE_PRO_FRAME_SIZE];
 
   DISALLOW_COPY_AND_ASSIGN(EuroliteProAsyncUsbSender);
 };
@@ -41,6 +41,8 @@ plugins_usbdmx_libolausbdmxwidget_la_SOURCES = \
     plugins/usbdmx/Flags.cpp \
     plugins/usbdmx/JaRuleFactory.cpp \
     plugins/usbdmx/JaRuleFactory.h \
+    plugins/usbdmx/PipelinedUsbSender.cpp \
+    plugins/usbdmx/PipelinedUsbSender.h \
     plugins/usbdmx/ScanlimeFadecandy.cpp \
     plugins/usbdmx/ScanlimeFadecandy.h \
     plugins/usbdmx/ScanlimeFadecandyFactory.cpp \
@@ -101,6 +103,19 @@ plugins_usbdmx_libolausbdmx_la_CXXFLAGS = $(COMMON_CXXFLAGS) $(libusb_CFLAGS)
 plugins_usbdmx_libolausbdmx_la_LIBADD = \
     olad/plugin_api/libolaserverplugininterface.la \
     plugins/usbdmx/libolausbdmxwidget.la
+
+# TESTS
+##################################################
+test_programs += plugins/usbdmx/PipelinedUsbSenderTester
+
+plugins_usbdmx_PipelinedUsbSenderTester_SOURCES = \
+    plugins/usbdmx/PipelinedUsbSenderTest.cpp
+plugins_usbdmx_PipelinedUsbSenderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) \
+                                                   $(libusb_CFLAGS)
+plugins_usbdmx_PipelinedUsbSenderTester_LDADD = \
+    $(COMMON_TESTING_LIBS) \
+    $(libusb_LIBS) \
+    plugins/usbdmx/libolausbdmxwidget.la
 endif
 
 EXTRA_DIST += \
@@ -0,0 +1,202 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PipelinedUsbSender.cpp
+ * An asynchronous DMX USB sender that keeps multiple transfers in flight.
+ * Copyright (C) 2026 agent
+ */
+
+#include "plugins/usbdmx/PipelinedUsbSender.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "libs/usb/LibUsbAdaptor.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+using ola::usb::LibUsbAdaptor;
+
+namespace {
+
+/*
+ * Called by libusb when a transfer completes.
+ */
+#ifdef _WIN32
+__attribute__((__stdcall__))
+#endif  // _WIN32
+void PipelinedCallback(struct libusb_transfer *transfer) {
+  PipelinedUsbSender *sender = reinterpret_cast<PipelinedUsbSender*>(
+      transfer->user_data);
+  sender->TransferComplete(transfer);
+}
+}  // namespace
+
+PipelinedUsbSender::PipelinedUsbSender(LibUsbAdaptor *adaptor,
+                                       libusb_device *usb_device,
+                                       unsigned int depth)
+    : m_adaptor(adaptor),
+      m_usb_device(usb_device),
+      m_usb_handle(NULL),
+      m_frame_held(false),
+      m_disconnected(false),
+      m_cancelling(false) {
+  depth = std::max(1u, depth);
+  for (unsigned int i = 0; i < depth; i++) {
+    m_transfers.push_back(m_adaptor->AllocTransfer(0));
+    m_free_slots.push_back(depth - i - 1);
+  }
+  m_adaptor->RefDevice(usb_device);
+}
+
+PipelinedUsbSender::~PipelinedUsbSender() {
+  CancelTransfers();
+  if (m_usb_handle) {
+    m_adaptor->Close(m_usb_handle);
+  }
+  m_adaptor->UnrefDevice(m_usb_device);
+
+  std::vector<struct libusb_transfer*>::iterator iter = m_transfers.begin();
+  for (; iter != m_transfers.end(); ++iter) {
+    m_adaptor->FreeTransfer(*iter);
+  }
+}
+
+bool PipelinedUsbSender::Init() {
+  m_usb_handle = SetupHandle();
+  return m_usb_handle != NULL;
+}
+
+bool PipelinedUsbSender::SendDMX(const DmxBuffer &buffer) {
+  if (!m_usb_handle) {
+    OLA_WARN << "PipelinedUsbSender hasn't been initialized";
+    return false;
+  }
+
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (m_disconnected || m_cancelling) {
+    return false;
+  }
+
+  if (m_free_slots.empty()) {
+    // All the transfers are in flight, hold the latest frame until one
+    // completes.
+    m_held_frame.Set(buffer);
+    m_frame_held = true;
+  } else {
+    SubmitFrame(buffer);
+  }
+  return true;
+}
+
+void PipelinedUsbSender::TransferComplete(struct libusb_transfer *transfer) {
+  std::vector<struct libusb_transfer*>::const_iterator iter = std::find(
+      m_transfers.begin(), m_transfers.end(), transfer);
+  if (iter == m_transfers.end()) {
+    OLA_WARN << "Unknown libusb transfer: " << transfer;
+    return;
+  }
+  unsigned int slot = iter - m_transfers.begin();
+
+  ola::thread::MutexLocker locker(&m_mutex);
+  if (transfer->status != LIBUSB_TRANSFER_COMPLETED && !m_cancelling) {
+    OLA_WARN << "Transfer returned "
+             << m_adaptor->ErrorCodeToString(transfer->status);
+  }
+
+  m_free_slots.push_back(slot);
+  if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+    m_disconnected = true;
+  }
+
+  if (m_cancelling) {
+    m_slot_freed.Signal();
+    return;
+  }
+
+  if (m_frame_held && !m_disconnected) {
+    m_frame_held = false;
+    SubmitFrame(m_held_frame);
+  }
+}
+
+void PipelinedUsbSender::FillBulkTransfer(unsigned int slot,
+                                          unsigned char endpoint,
+                                          unsigned char *buffer,
+                                          int length,
+                                          unsigned int timeout) {
+  m_adaptor->FillBulkTransfer(m_transfers[slot], m_usb_handle, endpoint,
+                              buffer, length, &PipelinedCallback, this,
+                              timeout);
+}
+
+void PipelinedUsbSender::FillInterruptTransfer(unsigned int slot,
+                                               unsigned char endpoint,
+                                               unsigned char *buffer,
+                                               int length,
+                                               unsigned int timeout) {
+  m_adaptor->FillInterruptTransfer(m_transfers[slot], m_usb_handle,
+                                   endpoint, buffer, length,
+                                   &PipelinedCallback, this, timeout);
+}
+
+void PipelinedUsbSender::CancelTransfers() {
+  ola::thread::MutexLocker locker(&m_mutex);
+  m_cancelling = true;
+  m_frame_held = false;
+  if (m_free_slots.size() == m_transfers.size()) {
+    return;
+  }
+
+  std::vector<bool> in_flight(m_transfers.size(), true);
+  std::vector<unsigned int>::const_iterator iter = m_free_slots.begin();
+  for (; iter != m_free_slots.end(); ++iter) {
+    in_flight[*iter] = false;
+  }
+
+  // libusb runs the callback for every submitted transfer, even if the
+  // cancel fails because the transfer has already completed.
+  for (unsigned int i = 0; i < m_transfers.size(); i++) {
+    if (in_flight[i]) {
+      m_adaptor->CancelTransfer(m_transfers[i]);
+    }
+  }
+
+  while (m_free_slots.size() != m_transfers.size()) {
+    m_slot_freed.Wait(&m_mutex);
+  }
+}
+
+void PipelinedUsbSender::SubmitFrame(const DmxBuffer &buffer) {
+  unsigned int slot = m_free_slots.back();
+  m_free_slots.pop_back();
+
+  FillTransfer(buffer, slot);
+  int ret = m_adaptor->SubmitTransfer(m_transfers[slot]);
+  if (ret) {
+    OLA_WARN << "libusb_submit_transfer returned "
+             << m_adaptor->ErrorCodeToString(ret);
+    if (ret == LIBUSB_ERROR_NO_DEVICE) {
+      m_disconnected = true;
+    }
+    m_free_slots.push_back(slot);
+  }
+}
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
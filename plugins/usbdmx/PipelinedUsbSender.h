@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PipelinedUsbSender.h
+ * An asynchronous DMX USB sender that keeps multiple transfers in flight.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef PLUGINS_USBDMX_PIPELINEDUSBSENDER_H_
+#define PLUGINS_USBDMX_PIPELINEDUSBSENDER_H_
+
+#include <libusb.h>
+#include <vector>
+
+#include "libs/usb/LibUsbAdaptor.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+namespace plugin {
+namespace usbdmx {
+
+/**
+ * @brief Send DMX data asynchronously using a ring of libusb transfers.
+ *
+ * Unlike AsyncUsbSender, which has a single transfer, this keeps up to
+ * depth transfers in flight. Each transfer slot has its own frame buffer, so
+ * the next frame can be built and submitted while the previous one is still
+ * on the bus and the endpoint never sits idle between frames.
+ *
+ * If all the slots are busy, the most recent frame is held and sent once a
+ * slot becomes free; older held frames are dropped.
+ *
+ * Subclasses implement SetupHandle() and FillTransfer(). Subclasses must call
+ * CancelTransfers() from their destructor.
+ */
+class PipelinedUsbSender {
+ public:
+  /**
+   * @brief Create a new PipelinedUsbSender.
+   * @param adaptor the LibUsbAdaptor to use.
+   * @param usb_device the libusb_device to use for the widget.
+   * @param depth the number of transfers to keep in flight.
+   */
+  PipelinedUsbSender(ola::usb::LibUsbAdaptor* const adaptor,
+                     libusb_device *usb_device,
+                     unsigned int depth);
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~PipelinedUsbSender();
+
+  /**
+   * @brief Initialize the sender.
+   * @returns true if SetupHandle() returned a valid handle, false otherwise.
+   */
+  bool Init();
+
+  /**
+   * @brief Send one frame of DMX data.
+   * @param buffer the DMX data to send.
+   * @returns false if the sender isn't initialized or the device has been
+   *   disconnected, true otherwise.
+   */
+  bool SendDMX(const DmxBuffer &buffer);
+
+  /**
+   * @brief Called from the libusb callback when a transfer completes.
+   * @param transfer the completed transfer.
+   */
+  void TransferComplete(struct libusb_transfer *transfer);
+
+  /**
+   * @brief The number of transfers this sender keeps in flight.
+   */
+  unsigned int Depth() const { return m_transfers.size(); }
+
+  /**
+   * @brief The default number of transfers to keep in flight.
+   */
+  static const unsigned int DEFAULT_DEPTH = 2;
+
+ protected:
+  /**
+   * @brief The LibUsbAdaptor passed in the constructor.
+   */
+  ola::usb::LibUsbAdaptor* const m_adaptor;
+
+  /**
+   * @brief The libusb_device passed in the constructor.
+   */
+  libusb_device* const m_usb_device;
+
+  /**
+   * @brief Open the device handle.
+   * @returns A valid libusb_device_handle or NULL if the device could not be
+   *   opened.
+   */
+  virtual libusb_device_handle* SetupHandle() = 0;
+
+  /**
+   * @brief Build the frame for a slot.
+   * @param buffer the DMX data.
+   * @param slot the slot to build the frame in, less than Depth().
+   *
+   * The subclass should build the frame in the buffer it keeps for this slot
+   * and then call FillBulkTransfer() or FillInterruptTransfer().
+   */
+  virtual void FillTransfer(const DmxBuffer &buffer, unsigned int slot) = 0;
+
+  /**
+   * @brief Fill the bulk transfer for a slot.
+   */
+  void FillBulkTransfer(unsigned int slot, unsigned char endpoint,
+                        unsigned char *buffer, int length,
+                        unsigned int timeout);
+
+  /**
+   * @brief Fill the interrupt transfer for a slot.
+   */
+  void FillInterruptTransfer(unsigned int slot, unsigned char endpoint,
+                             unsigned char *buffer, int length,
+                             unsigned int timeout);
+
+  /**
+   * @brief Cancel all transfers and wait for them to complete.
+   */
+  void CancelTransfers();
+
+ private:
+  libusb_device_handle *m_usb_handle;
+  std::vector<struct libusb_transfer*> m_transfers;
+
+  std::vector<unsigned int> m_free_slots;  // GUARDED_BY(m_mutex);
+  DmxBuffer m_held_frame;  // GUARDED_BY(m_mutex);
+  bool m_frame_held;  // GUARDED_BY(m_mutex);
+  bool m_disconnected;  // GUARDED_BY(m_mutex);
+  bool m_cancelling;  // GUARDED_BY(m_mutex);
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_slot_freed;
+
+  void SubmitFrame(const DmxBuffer &buffer);
+
+  DISALLOW_COPY_AND_ASSIGN(PipelinedUsbSender);
+};
+}  // namespace usbdmx
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBDMX_PIPELINEDUSBSENDER_H_
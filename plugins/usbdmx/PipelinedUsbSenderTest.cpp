@@ -0,0 +1,381 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PipelinedUsbSenderTest.cpp
+ * Test fixture for the PipelinedUsbSender class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <libusb.h>
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "libs/usb/LibUsbAdaptor.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Thread.h"
+#include "plugins/usbdmx/PipelinedUsbSender.h"
+
+using ola::DmxBuffer;
+using ola::plugin::usbdmx::PipelinedUsbSender;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+namespace {
+
+/*
+ * A LibUsbAdaptor that records the transfers instead of talking to a device.
+ * Transfers are completed by calling Complete().
+ */
+class FakeLibUsbAdaptor : public ola::usb::BaseLibUsbAdaptor {
+ public:
+  FakeLibUsbAdaptor() : m_submit_error(0) {}
+
+  bool OpenDevice(libusb_device*, libusb_device_handle**) { return false; }
+  bool OpenDeviceAndClaimInterface(libusb_device*, int,
+                                   libusb_device_handle**) {
+    return false;
+  }
+  void Close(libusb_device_handle*) {}
+
+  libusb_device* RefDevice(libusb_device *dev) { return dev; }
+  void UnrefDevice(libusb_device*) {}
+
+  struct libusb_transfer* AllocTransfer(int) {
+    struct libusb_transfer *transfer = new struct libusb_transfer;
+    memset(transfer, 0, sizeof(*transfer));
+    return transfer;
+  }
+
+  void FreeTransfer(struct libusb_transfer *transfer) {
+    delete transfer;
+  }
+
+  int SubmitTransfer(struct libusb_transfer *transfer) {
+    MutexLocker locker(&m_mutex);
+    if (m_submit_error) {
+      return m_submit_error;
+    }
+    m_in_flight.push_back(transfer);
+    m_frames.push_back(string(reinterpret_cast<char*>(transfer->buffer),
+                              transfer->length));
+    return 0;
+  }
+
+  int CancelTransfer(struct libusb_transfer *transfer) {
+    MutexLocker locker(&m_mutex);
+    m_cancelled.push_back(transfer);
+    m_cancel_called.Signal();
+    return 0;
+  }
+
+  /*
+   * Complete a transfer, as libusb would from the event thread.
+   */
+  void Complete(struct libusb_transfer *transfer,
+                libusb_transfer_status status = LIBUSB_TRANSFER_COMPLETED) {
+    {
+      MutexLocker locker(&m_mutex);
+      vector<struct libusb_transfer*>::iterator iter = std::find(
+          m_in_flight.begin(), m_in_flight.end(), transfer);
+      OLA_ASSERT_TRUE(iter != m_in_flight.end());
+      m_in_flight.erase(iter);
+    }
+    transfer->status = status;
+    transfer->callback(transfer);
+  }
+
+  /*
+   * Block until count transfers have been cancelled, then complete them.
+   */
+  void CompleteCancelled(unsigned int count) {
+    vector<struct libusb_transfer*> cancelled;
+    {
+      MutexLocker locker(&m_mutex);
+      while (m_cancelled.size() < count) {
+        m_cancel_called.Wait(&m_mutex);
+      }
+      cancelled = m_cancelled;
+    }
+    vector<struct libusb_transfer*>::iterator iter = cancelled.begin();
+    for (; iter != cancelled.end(); ++iter) {
+      Complete(*iter, LIBUSB_TRANSFER_CANCELLED);
+    }
+  }
+
+  void SetSubmitError(int error) { m_submit_error = error; }
+
+  vector<struct libusb_transfer*> InFlight() {
+    MutexLocker locker(&m_mutex);
+    return m_in_flight;
+  }
+
+  vector<string> Frames() {
+    MutexLocker locker(&m_mutex);
+    return m_frames;
+  }
+
+  vector<struct libusb_transfer*> Cancelled() {
+    MutexLocker locker(&m_mutex);
+    return m_cancelled;
+  }
+
+ private:
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cancel_called;
+  int m_submit_error;
+  vector<struct libusb_transfer*> m_in_flight;
+  vector<string> m_frames;
+  vector<struct libusb_transfer*> m_cancelled;
+};
+
+
+/*
+ * Completes the cancelled transfers from another thread, since the sender
+ * blocks in CancelTransfers() until they finish.
+ */
+class CancelCompleter : public ola::thread::Thread {
+ public:
+  CancelCompleter(FakeLibUsbAdaptor *adaptor, unsigned int count)
+      : m_adaptor(adaptor),
+        m_count(count) {
+  }
+
+  void *Run() {
+    m_adaptor->CompleteCancelled(m_count);
+    return NULL;
+  }
+
+ private:
+  FakeLibUsbAdaptor *m_adaptor;
+  const unsigned int m_count;
+};
+
+
+/*
+ * Each frame is sent as the raw slot data.
+ */
+class MockPipelinedSender : public PipelinedUsbSender {
+ public:
+  MockPipelinedSender(ola::usb::LibUsbAdaptor *adaptor, unsigned int depth)
+      : PipelinedUsbSender(adaptor, NULL, depth),
+        m_buffers(depth) {
+  }
+
+  ~MockPipelinedSender() {
+    CancelTransfers();
+  }
+
+ protected:
+  libusb_device_handle* SetupHandle() {
+    return reinterpret_cast<libusb_device_handle*>(&m_handle);
+  }
+
+  void FillTransfer(const DmxBuffer &buffer, unsigned int slot) {
+    unsigned int length = ola::DMX_UNIVERSE_SIZE;
+    buffer.Get(m_buffers[slot].data, &length);
+    FillBulkTransfer(slot, ENDPOINT, m_buffers[slot].data, length, TIMEOUT);
+  }
+
+ private:
+  struct SlotBuffer {
+    uint8_t data[ola::DMX_UNIVERSE_SIZE];
+  };
+
+  int m_handle;
+  vector<SlotBuffer> m_buffers;
+
+  static const uint8_t ENDPOINT = 2;
+  static const unsigned int TIMEOUT = 50;
+};
+
+DmxBuffer Frame(uint8_t value) {
+  const uint8_t data[] = {value, 0, 255};
+  return DmxBuffer(data, sizeof(data));
+}
+
+string FrameString(uint8_t value) {
+  return Frame(value).Get();
+}
+}  // namespace
+
+
+class PipelinedUsbSenderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PipelinedUsbSenderTest);
+  CPPUNIT_TEST(testSlotReuse);
+  CPPUNIT_TEST(testStaleFramesDropped);
+  CPPUNIT_TEST(testDisconnect);
+  CPPUNIT_TEST(testCancelOnShutdown);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+
+  void testSlotReuse();
+  void testStaleFramesDropped();
+  void testDisconnect();
+  void testCancelOnShutdown();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PipelinedUsbSenderTest);
+
+
+/*
+ * Check each frame is submitted while there's a free transfer, and that a
+ * transfer is reused once it completes.
+ */
+void PipelinedUsbSenderTest::testSlotReuse() {
+  FakeLibUsbAdaptor adaptor;
+  MockPipelinedSender sender(&adaptor, 2);
+  OLA_ASSERT_EQ(2u, sender.Depth());
+  OLA_ASSERT_FALSE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  vector<struct libusb_transfer*> in_flight = adaptor.InFlight();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), in_flight.size());
+  OLA_ASSERT_NE(in_flight[0], in_flight[1]);
+  OLA_ASSERT_EQ(static_cast<unsigned char>(2), in_flight[0]->endpoint);
+  OLA_ASSERT_EQ(FrameString(1), adaptor.Frames()[0]);
+  OLA_ASSERT_EQ(FrameString(2), adaptor.Frames()[1]);
+
+  // Once the first transfer completes, it's used for the next frame and the
+  // slot's buffer holds the new data.
+  struct libusb_transfer *first = in_flight[0];
+  adaptor.Complete(first);
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  in_flight = adaptor.InFlight();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), in_flight.size());
+  OLA_ASSERT_EQ(first, in_flight[1]);
+  OLA_ASSERT_EQ(FrameString(3), adaptor.Frames()[2]);
+  OLA_ASSERT_EQ(FrameString(3),
+                string(reinterpret_cast<char*>(first->buffer),
+                       first->length));
+
+  adaptor.Complete(in_flight[0]);
+  adaptor.Complete(in_flight[1]);
+  OLA_ASSERT_TRUE(adaptor.InFlight().empty());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), adaptor.Frames().size());
+}
+
+
+/*
+ * Check that when every transfer is busy only the latest frame is kept, and
+ * it's sent as soon as a transfer completes.
+ */
+void PipelinedUsbSenderTest::testStaleFramesDropped() {
+  FakeLibUsbAdaptor adaptor;
+  MockPipelinedSender sender(&adaptor, 2);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(4)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(5)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), adaptor.Frames().size());
+
+  vector<struct libusb_transfer*> in_flight = adaptor.InFlight();
+  adaptor.Complete(in_flight[0]);
+  vector<string> frames = adaptor.Frames();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), frames.size());
+  OLA_ASSERT_EQ(FrameString(5), frames[2]);
+
+  // Nothing is held now, so the next completion doesn't send anything.
+  adaptor.Complete(in_flight[1]);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), adaptor.Frames().size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), adaptor.InFlight().size());
+  adaptor.Complete(adaptor.InFlight()[0]);
+
+  // A transfer that fails to submit goes back on the free list.
+  adaptor.SetSubmitError(LIBUSB_ERROR_IO);
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(6)));
+  adaptor.SetSubmitError(0);
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(7)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(8)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), adaptor.InFlight().size());
+  adaptor.Complete(adaptor.InFlight()[0]);
+  adaptor.Complete(adaptor.InFlight()[0]);
+}
+
+
+/*
+ * Check the sender stops once the device has gone.
+ */
+void PipelinedUsbSenderTest::testDisconnect() {
+  FakeLibUsbAdaptor adaptor;
+  MockPipelinedSender sender(&adaptor, 2);
+  OLA_ASSERT_TRUE(sender.Init());
+
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+  OLA_ASSERT_TRUE(sender.SendDMX(Frame(3)));
+
+  // The held frame isn't sent to a device that has gone.
+  vector<struct libusb_transfer*> in_flight = adaptor.InFlight();
+  adaptor.Complete(in_flight[0], LIBUSB_TRANSFER_NO_DEVICE);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), adaptor.Frames().size());
+  OLA_ASSERT_FALSE(sender.SendDMX(Frame(4)));
+  adaptor.Complete(in_flight[1], LIBUSB_TRANSFER_NO_DEVICE);
+  OLA_ASSERT_FALSE(sender.SendDMX(Frame(5)));
+  OLA_ASSERT_EQ(static_cast<size_t>(2), adaptor.Frames().size());
+}
+
+
+/*
+ * Check the transfers in flight are cancelled, and the sender waits for them
+ * to complete, when it's destroyed.
+ */
+void PipelinedUsbSenderTest::testCancelOnShutdown() {
+  FakeLibUsbAdaptor adaptor;
+  CancelCompleter completer(&adaptor, 2);
+  vector<struct libusb_transfer*> in_flight;
+  {
+    MockPipelinedSender sender(&adaptor, 3);
+    OLA_ASSERT_TRUE(sender.Init());
+    OLA_ASSERT_TRUE(sender.SendDMX(Frame(1)));
+    OLA_ASSERT_TRUE(sender.SendDMX(Frame(2)));
+    in_flight = adaptor.InFlight();
+    OLA_ASSERT_EQ(static_cast<size_t>(2), in_flight.size());
+
+    // The destructor blocks until the completer has run the callbacks.
+    OLA_ASSERT_TRUE(completer.Start());
+  }
+  OLA_ASSERT_TRUE(completer.Join());
+
+  OLA_ASSERT_TRUE(adaptor.InFlight().empty());
+  vector<struct libusb_transfer*> cancelled = adaptor.Cancelled();
+  std::sort(in_flight.begin(), in_flight.end());
+  std::sort(cancelled.begin(), cancelled.end());
+  OLA_ASSERT_TRUE(in_flight == cancelled);
+
+  // With nothing in flight, there's nothing to cancel.
+  {
+    MockPipelinedSender sender(&adaptor, 2);
+    OLA_ASSERT_TRUE(sender.Init());
+  }
+  OLA_ASSERT_EQ(in_flight.size(), adaptor.Cancelled().size());
+}
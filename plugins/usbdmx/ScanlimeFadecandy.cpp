@@ -33,7 +33,7 @@
 #include "ola/StringUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/util/Utils.h"
-#include "plugins/usbdmx/AsyncUsbSender.h"
+#include "plugins/usbdmx/PipelinedUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
 namespace ola {
@@ -281,19 +281,25 @@ bool SynchronousScanlimeFadecandy::SendDMX(const DmxBuffer &buffer) {
 
 // FadecandyAsyncUsbSender
 // -----------------------------------------------------------------------------
-class FadecandyAsyncUsbSender : public AsyncUsbSender {
+class FadecandyAsyncUsbSender : public PipelinedUsbSender {
  public:
   FadecandyAsyncUsbSender(LibUsbAdaptor *adaptor,
                           libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : PipelinedUsbSender(adaptor, usb_device, DEFAULT_DEPTH) {
+  }
+
+  ~FadecandyAsyncUsbSender() {
+    CancelTransfers();
   }
 
   libusb_device_handle* SetupHandle();
 
-  bool PerformTransfer(const DmxBuffer &buffer);
+  void FillTransfer(const DmxBuffer &buffer, unsigned int slot);
 
  private:
-  fadecandy_packet m_data_packets[PACKETS_PER_UPDATE];
+  // One set of packets per transfer, so the next frame can be built while
+  // the previous one is still being sent.
+  fadecandy_packet m_data_packets[DEFAULT_DEPTH][PACKETS_PER_UPDATE];
 
   DISALLOW_COPY_AND_ASSIGN(FadecandyAsyncUsbSender);
 };
@@ -312,15 +318,15 @@ libusb_device_handle* FadecandyAsyncUsbSender::SetupHandle() {
   return usb_handle;
 }
 
-bool FadecandyAsyncUsbSender::PerformTransfer(const DmxBuffer &buffer) {
-  UpdatePacketsWithDMX(m_data_packets, buffer);
+void FadecandyAsyncUsbSender::FillTransfer(const DmxBuffer &buffer,
+                                           unsigned int slot) {
+  UpdatePacketsWithDMX(m_data_packets[slot], buffer);
   // We do a single bulk transfer of the entire data, rather than one transfer
   // for each 64 bytes.
-  FillBulkTransfer(ENDPOINT,
-                   reinterpret_cast<unsigned char*>(&m_data_packets),
-                   sizeof(m_data_packets),
+  FillBulkTransfer(slot, ENDPOINT,
+                   reinterpret_cast<unsigned char*>(m_data_packets[slot]),
+                   sizeof(m_data_packets[slot]),
                    URB_TIMEOUT_MS);
-  return (SubmitTransfer() == 0);
 }
 
 // AsynchronousScanlimeFadecandy
@@ -58,6 +58,7 @@ class UsbDmxPlugin: public ola::Plugin {
   std::string Description() const;
   ola_plugin_id Id() const { return OLA_PLUGIN_USBDMX; }
   std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+  bool CanStartInParallel() const { return true; }
 
  private:
   std::auto_ptr<class PluginImplInterface> m_impl;
@@ -18,6 +18,10 @@
  * Copyright (C) 2010 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
@@ -28,7 +32,13 @@
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
+#ifdef HAVE_LINUX_SERIAL_H
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#endif  // HAVE_LINUX_SERIAL_H
+#include <algorithm>
 #include <string>
+#include <vector>
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
@@ -41,6 +51,7 @@ namespace plugin {
 namespace usbpro {
 
 using std::string;
+using std::vector;
 
 
 const unsigned int BaseUsbProWidget::HEADER_SIZE =
@@ -48,18 +59,31 @@ const unsigned int BaseUsbProWidget::HEADER_SIZE =
 
 
 BaseUsbProWidget::BaseUsbProWidget(
-    ola::io::ConnectedDescriptor *descriptor)
+    ola::io::ConnectedDescriptor *descriptor,
+    ola::io::SelectServerInterface *ss)
     : m_descriptor(descriptor),
+      m_ss(ss),
       m_state(PRE_SOM),
-      m_bytes_received(0) {
+      m_bytes_received(0),
+      m_output_offset(0),
+      m_write_registered(false) {
   memset(&m_header, 0, sizeof(m_header));
   m_descriptor->SetOnData(
       NewCallback(this, &BaseUsbProWidget::DescriptorReady));
+  if (m_ss) {
+    m_descriptor->SetOnWritable(
+        NewCallback(this, &BaseUsbProWidget::PerformWrite));
+  }
+  AddDmxLabel(DMX_LABEL);
 }
 
 
 BaseUsbProWidget::~BaseUsbProWidget() {
+  StopOutput();
   m_descriptor->SetOnData(NULL);
+  if (m_ss) {
+    m_descriptor->SetOnWritable(NULL);
+  }
 }
 
 
@@ -98,30 +122,158 @@ bool BaseUsbProWidget::SendDMX(const DmxBuffer &buffer) {
  */
 bool BaseUsbProWidget::SendMessage(uint8_t label,
                                    const uint8_t *data,
-                                   unsigned int length) const {
+                                   unsigned int length) {
   if (length && !data)
     return false;
 
-  ssize_t frame_size = HEADER_SIZE + length + 1;
-  uint8_t frame[frame_size];
-  message_header *header = reinterpret_cast<message_header*>(frame);
+  if (!m_output_queue.empty())
+    return QueueFrame(label, data, length);
+
+  BuildFrame(label, data, length, &m_send_buffer);
+  ssize_t bytes_sent = m_descriptor->Send(&m_send_buffer[0],
+                                          m_send_buffer.size());
+  if (bytes_sent == static_cast<ssize_t>(m_send_buffer.size())) {
+    m_output_stats.frames_sent++;
+    return true;
+  }
+
+  bool would_block = bytes_sent > 0 ||
+      (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+  if (!m_ss || !would_block) {
+    // we've probably screwed framing at this point
+    m_output_stats.frames_dropped++;
+    return false;
+  }
+
+  // The descriptor is full, queue the rest of the frame and wait until we
+  // can write again.
+  m_output_stats.stalls++;
+  QueueFrame(label, data, length);
+  m_output_offset = std::max(bytes_sent, static_cast<ssize_t>(0));
+  return true;
+}
+
+
+/*
+ * Drop any queued frames and stop waiting for the descriptor to become
+ * writable.
+ */
+void BaseUsbProWidget::StopOutput() {
+  DropQueuedFrames();
+}
+
+
+/*
+ * Build a frame
+ */
+void BaseUsbProWidget::BuildFrame(uint8_t label,
+                                  const uint8_t *data,
+                                  unsigned int length,
+                                  vector<uint8_t> *frame) const {
+  frame->resize(HEADER_SIZE + length + 1);
+  message_header *header = reinterpret_cast<message_header*>(&(*frame)[0]);
   header->som = SOM;
   header->label = label;
   header->len = length & 0xFF;
   header->len_hi = (length & 0xFF00) >> 8;
+  if (length) {
+    memcpy(&(*frame)[HEADER_SIZE], data, length);
+  }
+  (*frame)[HEADER_SIZE + length] = EOM;
+}
 
-  memcpy(frame + sizeof(message_header), data, length);
-  frame[frame_size - 1] = EOM;
 
-  ssize_t bytes_sent = m_descriptor->Send(frame, frame_size);
-  if (bytes_sent != frame_size)
-    // we've probably screwed framing at this point
+/*
+ * Add a frame to the output queue. If this is a DMX frame, and there is
+ * already a DMX frame with the same label waiting to be sent, the queued frame
+ * is replaced.
+ * @return true if the frame was queued, false if the queue is full.
+ */
+bool BaseUsbProWidget::QueueFrame(uint8_t label,
+                                  const uint8_t *data,
+                                  unsigned int length) {
+  if (m_dmx_labels.find(label) != m_dmx_labels.end()) {
+    // We can't touch the first frame if we've started writing it.
+    std::deque<queued_frame>::iterator iter = m_output_queue.begin();
+    if (m_output_offset && iter != m_output_queue.end()) {
+      ++iter;
+    }
+    for (; iter != m_output_queue.end(); ++iter) {
+      if (iter->label == label) {
+        BuildFrame(label, data, length, &iter->frame);
+        m_output_stats.dmx_frames_replaced++;
+        return true;
+      }
+    }
+  }
+
+  if (m_output_queue.size() >= MAX_QUEUED_FRAMES) {
+    m_output_stats.frames_dropped++;
     return false;
+  }
 
+  m_output_queue.push_back(queued_frame());
+  m_output_queue.back().label = label;
+  BuildFrame(label, data, length, &m_output_queue.back().frame);
+  m_output_stats.max_queue_depth = std::max(
+      m_output_stats.max_queue_depth,
+      static_cast<unsigned int>(m_output_queue.size()));
+
+  if (!m_write_registered) {
+    m_write_registered = m_ss->AddWriteDescriptor(m_descriptor);
+  }
   return true;
 }
 
 
+/*
+ * Called when the descriptor is writable, this sends as many queued frames as
+ * we can.
+ */
+void BaseUsbProWidget::PerformWrite() {
+  while (!m_output_queue.empty()) {
+    const vector<uint8_t> &frame = m_output_queue.front().frame;
+    ssize_t bytes_sent = m_descriptor->Send(&frame[m_output_offset],
+                                            frame.size() - m_output_offset);
+    if (bytes_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    } else if (bytes_sent <= 0) {
+      OLA_WARN << "Failed to write to widget, dropping "
+               << m_output_queue.size() << " queued frames";
+      DropQueuedFrames();
+      return;
+    }
+
+    m_output_offset += bytes_sent;
+    if (m_output_offset < frame.size()) {
+      return;
+    }
+    m_output_offset = 0;
+    m_output_queue.pop_front();
+    m_output_stats.frames_sent++;
+  }
+
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+
+/*
+ * Drop all queued frames.
+ */
+void BaseUsbProWidget::DropQueuedFrames() {
+  m_output_stats.frames_dropped += m_output_queue.size();
+  m_output_queue.clear();
+  m_output_offset = 0;
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+
 /**
  * Open a path and apply the settings required for talking to widgets.
  */
@@ -141,6 +293,18 @@ ola::io::ConnectedDescriptor *BaseUsbProWidget::OpenDevice(
   cfsetospeed(&newtio, B115200);
   tcsetattr(fd, TCSANOW, &newtio);
 
+#ifdef HAVE_LINUX_SERIAL_H
+  // Ask the driver to pass data through immediately rather than batching it.
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+    serial.flags |= ASYNC_LOW_LATENCY;
+    if (ioctl(fd, TIOCSSERIAL, &serial) < 0) {
+      OLA_INFO << "Failed to set low latency mode on " << path << ": "
+               << strerror(errno);
+    }
+  }
+#endif  // HAVE_LINUX_SERIAL_H
+
   return new ola::io::DeviceDescriptor(fd);
 }
 
@@ -23,10 +23,14 @@
 #define PLUGINS_USBPRO_BASEUSBPROWIDGET_H_
 
 #include <stdint.h>
+#include <deque>
+#include <set>
 #include <string>
+#include <vector>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/Descriptor.h"
+#include "ola/io/SelectServerInterface.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
 
 namespace ola {
@@ -36,10 +40,40 @@ namespace usbpro {
 
 /*
  * A widget that implements the Usb Pro frame format.
+ *
+ * If a SelectServer is provided, writes never block. Frames that can't be
+ * written immediately are queued and sent once the descriptor is writable.
+ * While queued, a DMX frame is replaced by newer DMX frames with the same
+ * label, all other frames are sent in order.
  */
 class BaseUsbProWidget: public SerialWidgetInterface {
  public:
-  explicit BaseUsbProWidget(ola::io::ConnectedDescriptor *descriptor);
+  /*
+   * Counters for the output queue.
+   */
+  struct OutputStats {
+    // frames written to the descriptor
+    unsigned int frames_sent;
+    // queued DMX frames that were replaced by a newer frame
+    unsigned int dmx_frames_replaced;
+    // frames dropped because the queue was full or the write failed
+    unsigned int frames_dropped;
+    // the number of times a write would have blocked
+    unsigned int stalls;
+    // the largest number of frames queued at once
+    unsigned int max_queue_depth;
+
+    OutputStats()
+        : frames_sent(0),
+          dmx_frames_replaced(0),
+          frames_dropped(0),
+          stalls(0),
+          max_queue_depth(0) {
+    }
+  };
+
+  explicit BaseUsbProWidget(ola::io::ConnectedDescriptor *descriptor,
+                            ola::io::SelectServerInterface *ss = NULL);
   virtual ~BaseUsbProWidget();
 
   ola::io::ConnectedDescriptor *GetDescriptor() const {
@@ -52,7 +86,10 @@ class BaseUsbProWidget: public SerialWidgetInterface {
 
   bool SendMessage(uint8_t label,
                    const uint8_t *data,
-                   unsigned int length) const;
+                   unsigned int length);
+
+  const OutputStats &GetOutputStats() const { return m_output_stats; }
+  unsigned int QueuedFrames() const { return m_output_queue.size(); }
 
   static ola::io::ConnectedDescriptor *OpenDevice(const std::string &path);
 
@@ -63,6 +100,13 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t MANUFACTURER_LABEL = 77;
   static const uint8_t SERIAL_LABEL = 10;
 
+ protected:
+  // Frames with this label replace any queued frame with the same label.
+  void AddDmxLabel(uint8_t label) { m_dmx_labels.insert(label); }
+  // Drop any queued frames, this must be called from the SelectServer's
+  // thread before the descriptor is closed.
+  void StopOutput();
+
  private:
   typedef enum {
     PRE_SOM,
@@ -82,13 +126,33 @@ class BaseUsbProWidget: public SerialWidgetInterface {
     uint8_t len_hi;
   } message_header;
 
+  typedef struct {
+    uint8_t label;
+    std::vector<uint8_t> frame;
+  } queued_frame;
+
   ola::io::ConnectedDescriptor *m_descriptor;
+  ola::io::SelectServerInterface *m_ss;
   receive_state m_state;
   unsigned int m_bytes_received;
   message_header m_header;
   uint8_t m_recv_buffer[MAX_DATA_SIZE];
 
+  std::vector<uint8_t> m_send_buffer;
+  // output queue
+  std::deque<queued_frame> m_output_queue;
+  // bytes of the first queued frame that have been written
+  unsigned int m_output_offset;
+  bool m_write_registered;
+  std::set<uint8_t> m_dmx_labels;
+  OutputStats m_output_stats;
+
   void ReceiveMessage();
+  void BuildFrame(uint8_t label, const uint8_t *data, unsigned int length,
+                  std::vector<uint8_t> *frame) const;
+  bool QueueFrame(uint8_t label, const uint8_t *data, unsigned int length);
+  void PerformWrite();
+  void DropQueuedFrames();
   virtual void HandleMessage(uint8_t label,
                              const uint8_t *data,
                              unsigned int length) = 0;
@@ -96,6 +160,8 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t EOM = 0xe7;
   static const uint8_t SOM = 0x7e;
   static const unsigned int HEADER_SIZE;
+  // The maximum number of frames to queue
+  static const unsigned int MAX_QUEUED_FRAMES = 32;
 };
 
 
@@ -110,8 +176,9 @@ class DispatchingUsbProWidget: public BaseUsbProWidget {
                          const uint8_t*,
                          unsigned int> MessageCallback;
   DispatchingUsbProWidget(ola::io::ConnectedDescriptor *descriptor,
-                          MessageCallback *callback)
-      : BaseUsbProWidget(descriptor),
+                          MessageCallback *callback,
+                          ola::io::SelectServerInterface *ss = NULL)
+      : BaseUsbProWidget(descriptor, ss),
         m_callback(callback) {
   }
 
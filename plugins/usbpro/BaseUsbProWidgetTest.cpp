@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include <queue>
+#include <string>
 
 #include "ola/testing/TestUtils.h"
 
@@ -28,14 +29,18 @@
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
+#include "ola/io/Descriptor.h"
 #include "ola/network/NetworkUtils.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
 #include "plugins/usbpro/CommonWidgetTest.h"
 
 
 using ola::DmxBuffer;
+using ola::io::UnixSocket;
+using ola::plugin::usbpro::DispatchingUsbProWidget;
 using std::auto_ptr;
 using std::queue;
+using std::string;
 
 
 class BaseUsbProWidgetTest: public CommonWidgetTest {
@@ -44,6 +49,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST(testSendDMX);
   CPPUNIT_TEST(testReceive);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testOutputQueue);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -53,6 +59,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
     void testSendDMX();
     void testReceive();
     void testRemove();
+    void testOutputQueue();
 
  private:
     auto_ptr<ola::plugin::usbpro::DispatchingUsbProWidget> m_widget;
@@ -78,7 +85,10 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
       m_ss.Terminate();
     }
 
+    string BuildFrame(uint8_t label, const uint8_t *data, unsigned int size);
+
     static const uint8_t DMX_FRAME_LABEL = 0x06;
+    static const uint8_t RDM_FRAME_LABEL = 0x07;
 };
 
 
@@ -111,6 +121,20 @@ void BaseUsbProWidgetTest::AddExpectedMessage(uint8_t label,
 }
 
 
+/**
+ * Build the frame we expect to see on the wire.
+ */
+string BaseUsbProWidgetTest::BuildFrame(uint8_t label,
+                                        const uint8_t *data,
+                                        unsigned int size) {
+  unsigned int frame_size;
+  uint8_t *frame = BuildUsbProMessage(label, data, size, &frame_size);
+  string output(reinterpret_cast<char*>(frame), frame_size);
+  delete[] frame;
+  return output;
+}
+
+
 /**
  * Called when a new message arrives
  */
@@ -247,3 +271,72 @@ void BaseUsbProWidgetTest::testRemove() {
 
   OLA_ASSERT(m_removed);
 }
+
+
+/**
+ * Check that frames are queued rather than blocking when the descriptor is
+ * full.
+ */
+void BaseUsbProWidgetTest::testOutputQueue() {
+  UnixSocket socket;
+  socket.Init();
+  auto_ptr<UnixSocket> other_end(socket.OppositeEnd());
+  DispatchingUsbProWidget widget(
+      &socket,
+      ola::NewCallback(this, &BaseUsbProWidgetTest::ReceiveMessage),
+      &m_ss);
+
+  // Nothing is reading from the other end, so eventually a write will stall.
+  DmxBuffer buffer;
+  buffer.SetRangeToValue(0, 1, ola::DMX_UNIVERSE_SIZE);
+  for (unsigned int i = 0; i < 10000 && !widget.GetOutputStats().stalls;
+       i++) {
+    OLA_ASSERT(widget.SendDMX(buffer));
+  }
+  OLA_ASSERT_EQ(1u, widget.GetOutputStats().stalls);
+  OLA_ASSERT_EQ(1u, widget.QueuedFrames());
+
+  // Further DMX frames replace the queued frame.
+  for (uint8_t i = 2; i < 5; i++) {
+    buffer.SetRangeToValue(0, i, ola::DMX_UNIVERSE_SIZE);
+    OLA_ASSERT(widget.SendDMX(buffer));
+  }
+  OLA_ASSERT(widget.QueuedFrames() <= 2);
+
+  // Other frames are sent in order.
+  uint8_t rdm1[] = {1, 2};
+  uint8_t rdm2[] = {3, 4};
+  OLA_ASSERT(widget.SendMessage(RDM_FRAME_LABEL, rdm1, sizeof(rdm1)));
+  OLA_ASSERT(widget.SendMessage(RDM_FRAME_LABEL, rdm2, sizeof(rdm2)));
+  unsigned int queued = widget.QueuedFrames();
+
+  // This replaces the queued DMX frame, which is ahead of the RDM frames.
+  buffer.SetRangeToValue(0, 5, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT(widget.SendDMX(buffer));
+  OLA_ASSERT_EQ(queued, widget.QueuedFrames());
+  OLA_ASSERT(widget.GetOutputStats().dmx_frames_replaced >= 3);
+
+  // Now drain the other end.
+  string received;
+  uint8_t data[4096];
+  for (unsigned int i = 0; i < 10000; i++) {
+    unsigned int size = 0;
+    other_end->Receive(data, sizeof(data), size);
+    received.append(reinterpret_cast<char*>(data), size);
+    if (!widget.QueuedFrames() && !size) {
+      break;
+    }
+    m_ss.RunOnce(ola::TimeInterval(0, 1000));
+  }
+  OLA_ASSERT_EQ(0u, widget.QueuedFrames());
+  OLA_ASSERT_EQ(0u, widget.GetOutputStats().frames_dropped);
+
+  uint8_t dmx[ola::DMX_UNIVERSE_SIZE + 1];
+  dmx[0] = ola::DMX512_START_CODE;
+  memset(dmx + 1, 5, ola::DMX_UNIVERSE_SIZE);
+  const string expected = BuildFrame(DMX_FRAME_LABEL, dmx, sizeof(dmx)) +
+                          BuildFrame(RDM_FRAME_LABEL, rdm1, sizeof(rdm1)) +
+                          BuildFrame(RDM_FRAME_LABEL, rdm2, sizeof(rdm2));
+  OLA_ASSERT(received.size() >= expected.size());
+  OLA_ASSERT(expected == received.substr(received.size() - expected.size()));
+}
@@ -63,11 +63,11 @@ using std::vector;
  * New DMX TRI Widget
  */
 DmxTriWidgetImpl::DmxTriWidgetImpl(
-    ola::thread::SchedulerInterface *scheduler,
+    ola::io::SelectServerInterface *ss,
     ola::io::ConnectedDescriptor *descriptor,
     bool use_raw_rdm)
-    : BaseUsbProWidget(descriptor),
-      m_scheduler(scheduler),
+    : BaseUsbProWidget(descriptor, ss),
+      m_scheduler(ss),
       m_uid_count(0),
       m_last_esta_id(UID::ALL_MANUFACTURERS),
       m_use_raw_rdm(use_raw_rdm),
@@ -109,6 +109,7 @@ void DmxTriWidgetImpl::Stop() {
     m_discovery_callback = NULL;
     RunDiscoveryCallback(callback);
   }
+  StopOutput();
 }
 
 
@@ -998,11 +999,11 @@ bool DmxTriWidgetImpl::ReturnCodeToNackReason(
 /**
  * DmxTriWidget Constructor
  */
-DmxTriWidget::DmxTriWidget(ola::thread::SchedulerInterface *scheduler,
+DmxTriWidget::DmxTriWidget(ola::io::SelectServerInterface *ss,
                            ola::io::ConnectedDescriptor *descriptor,
                            unsigned int queue_size,
                            bool use_raw_rdm) {
-  m_impl = new DmxTriWidgetImpl(scheduler, descriptor, use_raw_rdm);
+  m_impl = new DmxTriWidgetImpl(ss, descriptor, use_raw_rdm);
   m_controller = new ola::rdm::DiscoverableQueueingRDMController(m_impl,
                                                                  queue_size);
 }
@@ -706,6 +706,12 @@ void EnttecPort::RunIncrementalDiscovery(
   }
 }
 
+void EnttecPort::SetKnownUIDs(const UIDSet &uids) {
+  if (m_enable_rdm) {
+    m_impl->SetKnownUIDs(uids);
+  }
+}
+
 
 // EnttecUsbProWidgetImpl
 // ----------------------------------------------------------------------------
@@ -717,7 +723,7 @@ void EnttecPort::RunIncrementalDiscovery(
 class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
  public:
     EnttecUsbProWidgetImpl(
-        ola::thread::SchedulerInterface *scheduler,
+        ola::io::SelectServerInterface *ss,
         ola::io::ConnectedDescriptor *descriptor,
         const EnttecUsbProWidget::EnttecUsbProWidgetOptions &options);
     ~EnttecUsbProWidgetImpl();
@@ -766,11 +772,11 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
  * This also works for the RDM Pro with the standard firmware loaded.
  */
 EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
-  ola::thread::SchedulerInterface *scheduler,
+  ola::io::SelectServerInterface *ss,
   ola::io::ConnectedDescriptor *descriptor,
   const EnttecUsbProWidget::EnttecUsbProWidgetOptions &options)
-    : BaseUsbProWidget(descriptor),
-      m_scheduler(scheduler),
+    : BaseUsbProWidget(descriptor, ss),
+      m_scheduler(ss),
       m_watchdog_timer_id(ola::thread::INVALID_TIMEOUT),
       m_send_cb(NewCallback(this, &EnttecUsbProWidgetImpl::SendCommand)),
       m_uid(options.esta_id ? options.esta_id :
@@ -782,6 +788,7 @@ EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
   if (options.dual_ports) {
     AddPort(OperationLabels::Port2Operations(), options.queue_size,
             options.enable_rdm);
+    AddDmxLabel(SEND_DMX_2);
     EnableSecondPort();
   }
   m_watchdog_timer_id = m_scheduler->RegisterRepeatingTimeout(
@@ -820,6 +827,7 @@ void EnttecUsbProWidgetImpl::Stop() {
     m_scheduler->RemoveTimeout(m_watchdog_timer_id);
     m_watchdog_timer_id = ola::thread::INVALID_TIMEOUT;
   }
+  StopOutput();
 
   vector<EnttecPortImpl*>::iterator iter = m_port_impls.begin();
   for (; iter != m_port_impls.end(); ++iter) {
@@ -951,10 +959,10 @@ bool EnttecUsbProWidgetImpl::Watchdog() {
  * EnttecUsbProWidget Constructor
  */
 EnttecUsbProWidget::EnttecUsbProWidget(
-    ola::thread::SchedulerInterface *scheduler,
+    ola::io::SelectServerInterface *ss,
     ola::io::ConnectedDescriptor *descriptor,
     const EnttecUsbProWidgetOptions &options) {
-  m_impl = new EnttecUsbProWidgetImpl(scheduler, descriptor, options);
+  m_impl = new EnttecUsbProWidgetImpl(ss, descriptor, options);
 }
 
 
@@ -985,6 +993,11 @@ EnttecPort *EnttecUsbProWidget::GetPort(unsigned int i) {
 ola::io::ConnectedDescriptor *EnttecUsbProWidget::GetDescriptor() const {
   return m_impl->GetDescriptor();
 }
+
+const BaseUsbProWidget::OutputStats &EnttecUsbProWidget::GetOutputStats()
+    const {
+  return m_impl->GetOutputStats();
+}
 }  // namespace usbpro
 }  // namespace plugin
 }  // namespace ola
@@ -26,7 +26,7 @@
 #include <string>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
-#include "ola/thread/SchedulerInterface.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMControllerInterface.h"
@@ -67,6 +67,11 @@ class EnttecPort
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
 
+    /**
+     * @brief Seed discovery with the UIDs found previously.
+     */
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids);
+
     // the tests access the implementation directly.
     friend class ::EnttecUsbProWidgetTest;
 
@@ -115,7 +120,7 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
       }
     };
 
-    EnttecUsbProWidget(ola::thread::SchedulerInterface *ss,
+    EnttecUsbProWidget(ola::io::SelectServerInterface *ss,
                        ola::io::ConnectedDescriptor *descriptor,
                        const EnttecUsbProWidgetOptions &options);
     ~EnttecUsbProWidget();
@@ -126,6 +131,7 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
     unsigned int PortCount() const;
     EnttecPort *GetPort(unsigned int i);
     ola::io::ConnectedDescriptor *GetDescriptor() const;
+    const BaseUsbProWidget::OutputStats &GetOutputStats() const;
 
     static const uint16_t ENTTEC_ESTA_ID;
 
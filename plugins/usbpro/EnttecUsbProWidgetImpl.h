@@ -103,6 +103,9 @@ class EnttecPortImpl
                         ola::rdm::RDMCallback *on_complete);
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+      m_discovery_agent.SetKnownUIDs(uids);
+    }
 
     // The following are the implementation of DiscoveryTargetInterface
     void MuteDevice(const ola::rdm::UID &target,
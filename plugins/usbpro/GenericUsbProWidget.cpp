@@ -35,8 +35,9 @@ namespace usbpro {
  * This also works for the RDM Pro with the standard firmware loaded.
  */
 GenericUsbProWidget::GenericUsbProWidget(
-  ola::io::ConnectedDescriptor *descriptor)
-    : BaseUsbProWidget(descriptor),
+  ola::io::ConnectedDescriptor *descriptor,
+  ola::io::SelectServerInterface *ss)
+    : BaseUsbProWidget(descriptor, ss),
       m_active(true),
       m_dmx_callback(NULL) {
 }
@@ -79,6 +80,7 @@ void GenericUsbProWidget::GenericStop() {
     m_outstanding_param_callbacks.pop_front();
     callback->Run(false, params);
   }
+  StopOutput();
 }
 
 
@@ -52,7 +52,8 @@ typedef ola::SingleUseCallback2<void, bool, const usb_pro_parameters&>
  */
 class GenericUsbProWidget: public BaseUsbProWidget {
  public:
-    explicit GenericUsbProWidget(ola::io::ConnectedDescriptor *descriptor);
+    explicit GenericUsbProWidget(ola::io::ConnectedDescriptor *descriptor,
+                                 ola::io::SelectServerInterface *ss = NULL);
     ~GenericUsbProWidget();
 
     void SetDMXCallback(ola::Callback0<void> *callback);
@@ -106,6 +106,11 @@ class RobeOutputPort: public BasicOutputPort {
       m_widget->RunIncrementalDiscovery(callback);
     }
 
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+      BasicOutputPort::SetKnownUIDs(uids);
+      m_widget->SetKnownUIDs(uids);
+    }
+
  private:
     RobeWidget *m_widget;
 };
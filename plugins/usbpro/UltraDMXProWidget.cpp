@@ -29,8 +29,11 @@ namespace usbpro {
  * UltraDMXProWidget Constructor
  */
 UltraDMXProWidget::UltraDMXProWidget(
-  ola::io::ConnectedDescriptor *descriptor)
-    : GenericUsbProWidget(descriptor) {
+  ola::io::ConnectedDescriptor *descriptor,
+  ola::io::SelectServerInterface *ss)
+    : GenericUsbProWidget(descriptor, ss) {
+  AddDmxLabel(DMX_PRIMARY_PORT);
+  AddDmxLabel(DMX_SECONDARY_PORT);
 }
 
 
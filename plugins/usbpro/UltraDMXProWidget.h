@@ -37,7 +37,8 @@ namespace usbpro {
  */
 class UltraDMXProWidget: public GenericUsbProWidget {
  public:
-    explicit UltraDMXProWidget(ola::io::ConnectedDescriptor *descriptor);
+    explicit UltraDMXProWidget(ola::io::ConnectedDescriptor *descriptor,
+                               ola::io::SelectServerInterface *ss = NULL);
     ~UltraDMXProWidget() {}
     void Stop() { GenericStop(); }
 
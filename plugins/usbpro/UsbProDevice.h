@@ -183,6 +183,11 @@ class UsbProOutputPort: public BasicOutputPort {
     m_port->RunIncrementalDiscovery(callback);
   }
 
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+    BasicOutputPort::SetKnownUIDs(uids);
+    m_port->SetKnownUIDs(uids);
+  }
+
   std::string Description() const { return m_description; }
 
  private:
@@ -62,6 +62,7 @@ const char UsbSerialPlugin::PLUGIN_NAME[] = "Serial USB";
 const char UsbSerialPlugin::PLUGIN_PREFIX[] = "usbserial";
 const char UsbSerialPlugin::ROBE_DEVICE_NAME[] = "Robe Universal Interface";
 const char UsbSerialPlugin::TRI_USE_RAW_RDM_KEY[] = "tri_use_raw_rdm";
+const char UsbSerialPlugin::PROBE_CACHE_KEY[] = "probe_cache";
 const char UsbSerialPlugin::USBPRO_DEVICE_NAME[] = "Enttec Usb Pro Device";
 const char UsbSerialPlugin::USB_PRO_FPS_LIMIT_KEY[] = "pro_fps_limit";
 const char UsbSerialPlugin::ULTRA_FPS_LIMIT_KEY[] = "ultra_fps_limit";
@@ -232,6 +233,22 @@ bool UsbSerialPlugin::StartHook() {
       m_preferences->GetValue(DEVICE_DIR_KEY));
   m_detector_thread.SetDevicePrefixes(
       m_preferences->GetMultipleValue(DEVICE_PREFIX_KEY));
+
+  // Each entry is <usb serial>:<detector>
+  WidgetDetectorThread::ProbeCache probe_cache;
+  const vector<string> cache_entries =
+      m_preferences->GetMultipleValue(PROBE_CACHE_KEY);
+  vector<string>::const_iterator iter = cache_entries.begin();
+  for (; iter != cache_entries.end(); ++iter) {
+    string::size_type pos = iter->find_last_of(':');
+    if (pos == string::npos || pos == 0) {
+      OLA_WARN << "Invalid " << PROBE_CACHE_KEY << " entry: " << *iter;
+      continue;
+    }
+    probe_cache[iter->substr(0, pos)] = iter->substr(pos + 1);
+  }
+  m_detector_thread.SetProbeCache(probe_cache);
+
   if (!m_detector_thread.Start()) {
     OLA_FATAL << "Failed to start the widget discovery thread";
     return false;
@@ -252,6 +269,19 @@ bool UsbSerialPlugin::StopHook() {
   }
   m_detector_thread.Join(NULL);
   m_devices.clear();
+
+  // Save the probe cache so known widgets are detected quickly next time.
+  const WidgetDetectorThread::ProbeCache &probe_cache =
+      m_detector_thread.GetProbeCache();
+  m_preferences->RemoveValue(PROBE_CACHE_KEY);
+  WidgetDetectorThread::ProbeCache::const_iterator cache_iter =
+      probe_cache.begin();
+  for (; cache_iter != probe_cache.end(); ++cache_iter) {
+    m_preferences->SetMultipleValue(PROBE_CACHE_KEY,
+                                    cache_iter->first + ":" +
+                                    cache_iter->second);
+  }
+  m_preferences->Save();
   return true;
 }
 
@@ -42,6 +42,7 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     ola_plugin_id Id() const { return OLA_PLUGIN_USBPRO; }
     void DeviceRemoved(UsbSerialDevice *device);
     std::string PluginPrefix() const { return PLUGIN_PREFIX; }
+    bool CanStartInParallel() const { return true; }
 
     void NewWidget(ArduinoWidget *widget,
                    const UsbProWidgetInformation &information);
@@ -79,6 +80,7 @@ class UsbSerialPlugin: public ola::Plugin, public NewWidgetHandler {
     static const char MAC_DEVICE_PREFIX[];
     static const char PLUGIN_NAME[];
     static const char PLUGIN_PREFIX[];
+    static const char PROBE_CACHE_KEY[];
     static const char ROBE_DEVICE_NAME[];
     static const char TRI_USE_RAW_RDM_KEY[];
     static const char USBPRO_DEVICE_NAME[];
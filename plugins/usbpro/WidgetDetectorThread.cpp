@@ -19,8 +19,22 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
 
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif  // HAVE_SYS_INOTIFY_H
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -51,6 +65,9 @@ using ola::io::ConnectedDescriptor;
 using std::string;
 using std::vector;
 
+const char WidgetDetectorThread::USB_PRO_DETECTOR[] = "usbpro";
+const char WidgetDetectorThread::ROBE_DETECTOR[] = "robe";
+
 
 /**
  * Constructor
@@ -71,7 +88,9 @@ WidgetDetectorThread::WidgetDetectorThread(
       m_handler(handler),
       m_is_running(false),
       m_usb_pro_timeout(usb_pro_timeout),
-      m_robe_timeout(robe_timeout) {
+      m_robe_timeout(robe_timeout),
+      m_hotplug_fd(-1),
+      m_hotplug_scan_timeout(ola::thread::INVALID_TIMEOUT) {
   if (!m_handler)
     OLA_FATAL << "No new widget handler registered.";
 }
@@ -109,6 +128,18 @@ void WidgetDetectorThread::SetIgnoredDevices(const vector<string> &devices) {
   }
 }
 
+
+/**
+ * Set the detectors that previously found widgets. Widgets that match an entry
+ * in the cache will try the cached detector first, which avoids waiting for
+ * the other detectors to time out.
+ * @param cache a map of USB serial number to detector name.
+ */
+void WidgetDetectorThread::SetProbeCache(const ProbeCache &cache) {
+  m_probe_cache = cache;
+}
+
+
 /**
  * Run the discovery thread.
  */
@@ -121,20 +152,31 @@ void *WidgetDetectorThread::Run() {
         ola::NewCallback(this, &WidgetDetectorThread::UsbProWidgetReady),
         ola::NewCallback(this, &WidgetDetectorThread::DescriptorFailed),
         m_usb_pro_timeout));
+    m_detector_names.push_back(USB_PRO_DETECTOR);
     m_widget_detectors.push_back(new RobeWidgetDetector(
         &m_ss,
         ola::NewCallback(this, &WidgetDetectorThread::RobeWidgetReady),
         ola::NewCallback(this, &WidgetDetectorThread::DescriptorFailed),
         m_robe_timeout));
+    m_detector_names.push_back(ROBE_DETECTOR);
   }
   RunScan();
-  m_ss.RegisterRepeatingTimeout(
-      SCAN_INTERVAL_MS,
-      ola::NewCallback(this, &WidgetDetectorThread::RunScan));
+  // If we can be notified when new devices appear, we only need to keep
+  // retrying the devices that failed, e.g. because they were busy.
+  if (StartHotplugWatch()) {
+    m_ss.RegisterRepeatingTimeout(
+        SCAN_INTERVAL_MS,
+        ola::NewCallback(this, &WidgetDetectorThread::RetryFailedPaths));
+  } else {
+    m_ss.RegisterRepeatingTimeout(
+        SCAN_INTERVAL_MS,
+        ola::NewCallback(this, &WidgetDetectorThread::RunScan));
+  }
   m_ss.Execute(
       ola::NewSingleCallback(this, &WidgetDetectorThread::MarkAsRunning));
   m_ss.Run();
   m_ss.DrainCallbacks();
+  StopHotplugWatch();
 
   // This will trigger a call to InternalFreeWidget for any remaining widgets
   STLDeleteElements(&m_widget_detectors);
@@ -147,6 +189,7 @@ void *WidgetDetectorThread::Run() {
     OLA_INFO  << iter->first;
   }
   m_widget_detectors.clear();
+  m_detector_names.clear();
   return NULL;
 }
 
@@ -197,6 +240,10 @@ bool WidgetDetectorThread::RunScan() {
     return true;
   }
 
+  // Every path that isn't active is tried again, so anything that fails
+  // this time will be re-added.
+  m_failed_paths.clear();
+
   vector<string>::iterator it;
   for (it = device_paths.begin(); it != device_paths.end(); ++it) {
     if (m_active_paths.find(*it) != m_active_paths.end()) {
@@ -215,6 +262,7 @@ bool WidgetDetectorThread::RunScan() {
     OLA_INFO << "Found potential USB Serial device at " << *it;
     ConnectedDescriptor *descriptor = BaseUsbProWidget::OpenDevice(*it);
     if (!descriptor) {
+      m_failed_paths.insert(*it);
       continue;
     }
 
@@ -224,16 +272,95 @@ bool WidgetDetectorThread::RunScan() {
   return true;
 }
 
+/**
+ * Scan again if any devices failed to open or probe. This is only used when
+ * hotplug notifications are available, since a device that failed won't
+ * generate another event.
+ */
+bool WidgetDetectorThread::RetryFailedPaths() {
+  if (!m_failed_paths.empty()) {
+    OLA_DEBUG << "Retrying " << m_failed_paths.size()
+              << " USB Serial devices";
+    RunScan();
+  }
+  return true;
+}
+
+
 /**
  * Start the discovery sequence for a widget.
  */
 void WidgetDetectorThread::PerformDiscovery(const string &path,
                                             ConnectedDescriptor *descriptor) {
-  m_active_descriptors[descriptor] = DescriptorInfo(path, -1);
+  DescriptorInfo &info = m_active_descriptors[descriptor];
+  info.path = path;
+  info.usb_serial = UsbSerialNumber(path);
+  info.first_detector = 0;
+  info.attempts = 0;
+
+  const string *detector = STLFind(&m_probe_cache, info.usb_serial);
+  if (detector) {
+    vector<string>::const_iterator iter = std::find(
+        m_detector_names.begin(), m_detector_names.end(), *detector);
+    if (iter != m_detector_names.end()) {
+      info.first_detector = iter - m_detector_names.begin();
+      OLA_INFO << "Trying the " << *detector << " detector first for "
+               << info.usb_serial;
+    }
+  }
+
   m_active_paths.insert(path);
   PerformNextDiscoveryStep(descriptor);
 }
 
+
+/**
+ * Look up the USB serial number for a device.
+ * @param path the path to the device, e.g. /dev/ttyUSB0
+ * @returns the USB serial number, or the empty string if it isn't known.
+ *
+ * On Linux this walks up the sysfs tree for the tty device until it finds
+ * the USB device's serial attribute.
+ */
+string WidgetDetectorThread::UsbSerialNumber(const string &path) const {
+#ifdef _WIN32
+  (void) path;
+  return "";
+#else
+  char resolved_path[PATH_MAX];
+  if (!realpath(path.c_str(), resolved_path)) {
+    return "";
+  }
+
+  const string sysfs_path = "/sys/class/tty/" +
+      ola::file::FilenameFromPath(resolved_path) + "/device";
+  char device_path[PATH_MAX];
+  if (!realpath(sysfs_path.c_str(), device_path)) {
+    return "";
+  }
+
+  // The serial attribute lives on the USB device, which is at most a couple
+  // of levels above the tty. The USB device is the first directory with an
+  // idVendor attribute. We have to stop there, since a device without an
+  // iSerial has no serial attribute, and the one on the hub above it would
+  // be shared by every widget on that hub.
+  string directory(device_path);
+  for (unsigned int i = 0; i < 3 && !directory.empty(); i++) {
+    if (access((directory + "/idVendor").c_str(), F_OK) == 0) {
+      std::ifstream serial_file((directory + "/serial").c_str());
+      string serial;
+      if (serial_file.is_open() && std::getline(serial_file, serial)) {
+        StringTrim(&serial);
+        return serial;
+      }
+      return "";
+    }
+    directory = directory.substr(0, directory.find_last_of('/'));
+  }
+  return "";
+#endif  // _WIN32
+}
+
 /**
  * Called when a new widget becomes ready. Ownership of both objects transferrs
  * to use.
@@ -243,6 +370,7 @@ void WidgetDetectorThread::UsbProWidgetReady(
     const UsbProWidgetInformation *information) {
   // we're no longer interested in events from this widget
   m_ss.RemoveReadDescriptor(descriptor);
+  UpdateProbeCache(descriptor, USB_PRO_DETECTOR);
 
   if (!m_handler) {
     OLA_WARN << "No callback defined for new Usb Pro Widgets.";
@@ -256,7 +384,7 @@ void WidgetDetectorThread::UsbProWidgetReady(
       if (information->device_id == DMX_KING_ULTRA_PRO_ID) {
         // The Ultra device has two outputs
         DispatchWidget(
-            new UltraDMXProWidget(descriptor),
+            new UltraDMXProWidget(descriptor, m_other_ss),
             information);
         return;
       } else {
@@ -340,6 +468,7 @@ void WidgetDetectorThread::RobeWidgetReady(
     const RobeWidgetInformation *info) {
   // we're no longer interested in events from this descriptor
   m_ss.RemoveReadDescriptor(descriptor);
+  UpdateProbeCache(descriptor, ROBE_DETECTOR);
   RobeWidget *widget = new RobeWidget(descriptor, info->uid);
 
   if (m_handler) {
@@ -374,25 +503,149 @@ void WidgetDetectorThread::PerformNextDiscoveryStep(
     ConnectedDescriptor *descriptor) {
 
   DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
-  descriptor_info.second++;
 
-  if (static_cast<unsigned int>(descriptor_info.second) ==
-      m_widget_detectors.size()) {
+  if (descriptor_info.attempts == m_widget_detectors.size()) {
     OLA_INFO << "no more detectors to try for  " << descriptor;
+    m_failed_paths.insert(descriptor_info.path);
     FreeDescriptor(descriptor);
   } else {
-    OLA_INFO << "trying stage " << descriptor_info.second << " for " <<
-      descriptor;
+    unsigned int detector = (descriptor_info.first_detector +
+                             descriptor_info.attempts) %
+                            m_widget_detectors.size();
+    descriptor_info.attempts++;
+    OLA_INFO << "trying stage " << detector << " for " << descriptor;
     m_ss.AddReadDescriptor(descriptor);
-    bool ok = m_widget_detectors[descriptor_info.second]->Discover(descriptor);
+    bool ok = m_widget_detectors[detector]->Discover(descriptor);
     if (!ok) {
       m_ss.RemoveReadDescriptor(descriptor);
+      m_failed_paths.insert(descriptor_info.path);
       FreeDescriptor(descriptor);
     }
   }
 }
 
 
+/**
+ * Record which detector found the widget, so next time it's tried first.
+ */
+void WidgetDetectorThread::UpdateProbeCache(ConnectedDescriptor *descriptor,
+                                            const string &detector) {
+  const DescriptorInfo *info = STLFind(&m_active_descriptors, descriptor);
+  if (info && !info->usb_serial.empty()) {
+    m_probe_cache[info->usb_serial] = detector;
+  }
+}
+
+
+/**
+ * Start watching the device directory for new devices.
+ * @returns true if hotplug notifications are available, false otherwise.
+ */
+bool WidgetDetectorThread::StartHotplugWatch() {
+#ifdef HAVE_SYS_INOTIFY_H
+  if (m_directory.empty()) {
+    return false;
+  }
+
+  m_hotplug_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_hotplug_fd < 0) {
+    OLA_WARN << "inotify_init1 failed: " << strerror(errno);
+    return false;
+  }
+
+  // udev creates the device node and then sets the permissions, so we watch
+  // for both.
+  if (inotify_add_watch(m_hotplug_fd, m_directory.c_str(),
+                        IN_CREATE | IN_ATTRIB | IN_MOVED_TO) < 0) {
+    OLA_WARN << "Failed to watch " << m_directory << ": " << strerror(errno);
+    close(m_hotplug_fd);
+    m_hotplug_fd = -1;
+    return false;
+  }
+
+  m_hotplug_descriptor.reset(
+      new ola::io::UnmanagedFileDescriptor(m_hotplug_fd));
+  m_hotplug_descriptor->SetOnData(
+      ola::NewCallback(this, &WidgetDetectorThread::HotplugEvent));
+  m_ss.AddReadDescriptor(m_hotplug_descriptor.get());
+  OLA_INFO << "Watching " << m_directory << " for new USB Serial devices";
+  return true;
+#else
+  return false;
+#endif  // HAVE_SYS_INOTIFY_H
+}
+
+
+/**
+ * Stop watching the device directory.
+ */
+void WidgetDetectorThread::StopHotplugWatch() {
+  if (m_hotplug_scan_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss.RemoveTimeout(m_hotplug_scan_timeout);
+    m_hotplug_scan_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_hotplug_descriptor.get()) {
+    m_ss.RemoveReadDescriptor(m_hotplug_descriptor.get());
+    m_hotplug_descriptor.reset();
+  }
+
+  if (m_hotplug_fd >= 0) {
+    close(m_hotplug_fd);
+    m_hotplug_fd = -1;
+  }
+}
+
+
+/**
+ * Called when the device directory changes. If one of the changes matches
+ * our prefixes, schedule a scan.
+ */
+void WidgetDetectorThread::HotplugEvent() {
+#ifdef HAVE_SYS_INOTIFY_H
+  char buffer[4096]
+    __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool matched = false;
+
+  while (true) {
+    ssize_t length = read(m_hotplug_fd, buffer, sizeof(buffer));
+    if (length <= 0) {
+      break;
+    }
+
+    const char *ptr = buffer;
+    while (ptr < buffer + length) {
+      const struct inotify_event *event =
+          reinterpret_cast<const struct inotify_event*>(ptr);
+      if (event->len) {
+        const string name(event->name);
+        vector<string>::const_iterator iter = m_prefixes.begin();
+        for (; iter != m_prefixes.end() && !matched; ++iter) {
+          matched = StringBeginsWith(name, *iter);
+        }
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+
+  if (matched && m_hotplug_scan_timeout == ola::thread::INVALID_TIMEOUT) {
+    m_hotplug_scan_timeout = m_ss.RegisterSingleTimeout(
+        HOTPLUG_SCAN_DELAY_MS,
+        ola::NewSingleCallback(this, &WidgetDetectorThread::HotplugScan));
+  }
+#endif  // HAVE_SYS_INOTIFY_H
+}
+
+
+/**
+ * Run a scan after a hotplug event.
+ */
+void WidgetDetectorThread::HotplugScan() {
+  m_hotplug_scan_timeout = ola::thread::INVALID_TIMEOUT;
+  RunScan();
+}
+
+
 /**
  * Free the widget and the associated descriptor.
  */
@@ -414,8 +667,8 @@ void WidgetDetectorThread::InternalFreeWidget(SerialWidgetInterface *widget) {
 void WidgetDetectorThread::FreeDescriptor(ConnectedDescriptor *descriptor) {
   DescriptorInfo &descriptor_info = m_active_descriptors[descriptor];
 
-  m_active_paths.erase(descriptor_info.first);
-  io::ReleaseUUCPLock(descriptor_info.first);
+  m_active_paths.erase(descriptor_info.path);
+  io::ReleaseUUCPLock(descriptor_info.path);
   m_active_descriptors.erase(descriptor);
   delete descriptor;
 }
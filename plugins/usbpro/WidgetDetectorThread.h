@@ -23,6 +23,7 @@
 #define PLUGINS_USBPRO_WIDGETDETECTORTHREAD_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -73,6 +74,12 @@ class NewWidgetHandler {
  */
 class WidgetDetectorThread: public ola::thread::Thread {
  public:
+    /**
+     * Maps a USB serial number to the name of the detector that found a
+     * widget with that serial number.
+     */
+    typedef std::map<std::string, std::string> ProbeCache;
+
     explicit WidgetDetectorThread(NewWidgetHandler *widget_handler,
                                   ola::io::SelectServerInterface *ss,
                                   unsigned int usb_pro_timeout = 200,
@@ -85,6 +92,10 @@ class WidgetDetectorThread: public ola::thread::Thread {
     void SetDevicePrefixes(const std::vector<std::string> &prefixes);
     // Must be called before Run()
     void SetIgnoredDevices(const std::vector<std::string> &devices);
+    // Must be called before Run()
+    void SetProbeCache(const ProbeCache &cache);
+    // Must be called after Join()
+    const ProbeCache& GetProbeCache() const { return m_probe_cache; }
 
     // Start the thread, this will call the SuccessHandler whenever a new
     // Widget is located.
@@ -102,13 +113,18 @@ class WidgetDetectorThread: public ola::thread::Thread {
 
  protected:
     virtual bool RunScan();
+    virtual std::string UsbSerialNumber(const std::string &path) const;
     void PerformDiscovery(const std::string &path,
                           ola::io::ConnectedDescriptor *descriptor);
 
+    static const char USB_PRO_DETECTOR[];
+    static const char ROBE_DETECTOR[];
+
  private:
     ola::io::SelectServerInterface *m_other_ss;
     ola::io::SelectServer m_ss;  // ss for this thread
     std::vector<WidgetDetectorInterface*> m_widget_detectors;
+    std::vector<std::string> m_detector_names;
     std::string m_directory;  // directory to look for widgets in
     std::vector<std::string> m_prefixes;  // prefixes to try
     std::set<std::string> m_ignored_devices;  // devices to ignore
@@ -119,10 +135,26 @@ class WidgetDetectorThread: public ola::thread::Thread {
     ola::thread::Mutex m_mutex;
     ola::thread::ConditionVariable m_condition;
 
+    // the detector that last found a widget, keyed by USB serial number
+    ProbeCache m_probe_cache;
+    // watches m_directory for new devices, if hotplug is supported.
+    int m_hotplug_fd;
+    std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_hotplug_descriptor;
+    ola::thread::timeout_id m_hotplug_scan_timeout;
+
     // those paths that are either in discovery, or in use
     std::set<std::string> m_active_paths;
-    // holds the path and current widget detector offset
-    typedef std::pair<std::string, int> DescriptorInfo;
+    // those paths that couldn't be opened or didn't match a detector
+    std::set<std::string> m_failed_paths;
+
+    struct DescriptorInfo {
+      std::string path;
+      std::string usb_serial;
+      // the detector to try first
+      unsigned int first_detector;
+      // the number of detectors tried so far
+      unsigned int attempts;
+    };
     // map of descriptor to DescriptorInfo
     typedef std::map<ola::io::ConnectedDescriptor*, DescriptorInfo>
       ActiveDescriptors;
@@ -136,6 +168,13 @@ class WidgetDetectorThread: public ola::thread::Thread {
                          const RobeWidgetInformation *info);
 
     void DescriptorFailed(ola::io::ConnectedDescriptor *descriptor);
+    void UpdateProbeCache(ola::io::ConnectedDescriptor *descriptor,
+                          const std::string &detector);
+    bool StartHotplugWatch();
+    void StopHotplugWatch();
+    void HotplugEvent();
+    void HotplugScan();
+    bool RetryFailedPaths();
     void PerformNextDiscoveryStep(ola::io::ConnectedDescriptor *descriptor);
     void InternalFreeWidget(SerialWidgetInterface *widget);
     void FreeDescriptor(ola::io::ConnectedDescriptor *descriptor);
@@ -150,6 +189,9 @@ class WidgetDetectorThread: public ola::thread::Thread {
     void MarkAsRunning();
 
     static const unsigned int SCAN_INTERVAL_MS = 20000;
+    // How long to wait after a hotplug event before scanning, this gives udev
+    // time to set the permissions on the new device.
+    static const unsigned int HOTPLUG_SCAN_DELAY_MS = 500;
 
     // This is how device identification is done, see
     // https://wiki.openlighting.org/index.php/USB_Protocol_Extensions
@@ -73,6 +73,7 @@ class MockWidgetDetectorThread: public WidgetDetectorThread {
     }
 
     UnixSocket* GetOtherEnd() { return m_descriptor->OppositeEnd(); }
+    void SetUsbSerial(const string &serial) { m_usb_serial = serial; }
 
  protected:
     bool RunScan() {
@@ -80,8 +81,13 @@ class MockWidgetDetectorThread: public WidgetDetectorThread {
       return true;
     }
 
+    string UsbSerialNumber(const string&) const {
+      return m_usb_serial;
+    }
+
  private:
     UnixSocket *m_descriptor;
+    string m_usb_serial;
 };
 
 
@@ -96,6 +102,8 @@ class WidgetDetectorThreadTest: public CppUnit::TestFixture,
   CPPUNIT_TEST(testUsbProMkIIBWidget);
   CPPUNIT_TEST(testRobeWidget);
   CPPUNIT_TEST(testUltraDmxWidget);
+  CPPUNIT_TEST(testProbeCache);
+  CPPUNIT_TEST(testStaleProbeCache);
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testClose);
   CPPUNIT_TEST_SUITE_END();
@@ -112,6 +120,8 @@ class WidgetDetectorThreadTest: public CppUnit::TestFixture,
     void testUsbProMkIIBWidget();
     void testRobeWidget();
     void testUltraDmxWidget();
+    void testProbeCache();
+    void testStaleProbeCache();
     void testTimeout();
     void testClose();
 
@@ -520,6 +530,72 @@ void WidgetDetectorThreadTest::testUltraDmxWidget() {
 }
 
 
+/**
+ * Check that the probe cache is used to pick the first detector, and that it's
+ * updated once a widget is found.
+ */
+void WidgetDetectorThreadTest::testProbeCache() {
+  WidgetDetectorThread::ProbeCache cache;
+  cache["EN123456"] = "robe";
+  cache["EN654321"] = "usbpro";
+  m_thread->SetProbeCache(cache);
+  m_thread->SetUsbSerial("EN123456");
+
+  // no usb pro messages are sent since we try the robe detector first
+  uint8_t info_data[] = {1, 11, 3, 0, 0};
+  uint8_t uid_data[] = {0x52, 0x53, 2, 0, 0, 10};
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::INFO_REQUEST, NULL, 0,
+      BaseRobeWidget::INFO_RESPONSE, info_data, sizeof(info_data));
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::UID_REQUEST, NULL, 0,
+      BaseRobeWidget::UID_RESPONSE, uid_data, sizeof(uid_data));
+
+  m_thread->Start();
+  m_thread->WaitUntilRunning();
+  m_ss.Run();
+  OLA_ASSERT_EQ(ROBE, m_received_widget_type);
+
+  m_thread->Join(NULL);
+  OLA_ASSERT(cache == m_thread->GetProbeCache());
+}
+
+
+/**
+ * Check that a stale cache entry is replaced.
+ */
+void WidgetDetectorThreadTest::testStaleProbeCache() {
+  WidgetDetectorThread::ProbeCache cache;
+  cache["EN123456"] = "usbpro";
+  m_thread->SetProbeCache(cache);
+  m_thread->SetUsbSerial("EN123456");
+
+  m_endpoint->AddExpectedUsbProMessage(BaseUsbProWidget::MANUFACTURER_LABEL,
+                                       NULL,
+                                       0);
+  m_endpoint->AddExpectedUsbProMessage(BaseUsbProWidget::DEVICE_LABEL, NULL, 0);
+  m_endpoint->AddExpectedUsbProMessage(BaseUsbProWidget::SERIAL_LABEL, NULL, 0);
+
+  uint8_t info_data[] = {1, 11, 3, 0, 0};
+  uint8_t uid_data[] = {0x52, 0x53, 2, 0, 0, 10};
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::INFO_REQUEST, NULL, 0,
+      BaseRobeWidget::INFO_RESPONSE, info_data, sizeof(info_data));
+  m_endpoint->AddExpectedRobeDataAndReturn(
+      BaseRobeWidget::UID_REQUEST, NULL, 0,
+      BaseRobeWidget::UID_RESPONSE, uid_data, sizeof(uid_data));
+
+  m_thread->Start();
+  m_thread->WaitUntilRunning();
+  m_ss.Run();
+  OLA_ASSERT_EQ(ROBE, m_received_widget_type);
+
+  m_thread->Join(NULL);
+  cache["EN123456"] = "robe";
+  OLA_ASSERT(cache == m_thread->GetProbeCache());
+}
+
+
 /**
  * Check a widget that fails to respond
  */
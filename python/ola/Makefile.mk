@@ -37,6 +37,23 @@ pkgpython_PYTHON = \
     python/ola/__init__.py
 endif
 
+# The optional C extension, see OlaFastModule.cpp.
+##################################################
+if BUILD_PYTHON_EXTENSION
+olafastdir = $(pkgpythondir)
+olafast_LTLIBRARIES = python/ola/_olafast.la
+python_ola__olafast_la_SOURCES = python/ola/OlaFastModule.cpp
+python_ola__olafast_la_CXXFLAGS = $(COMMON_CXXFLAGS) $(PYTHON_CPPFLAGS)
+python_ola__olafast_la_LDFLAGS = -module -avoid-version -shared
+
+# Put the module next to the generated Python files, so the tests use it.
+noinst_DATA += python/ola/_olafast.so
+CLEANFILES += python/ola/_olafast.so
+
+python/ola/_olafast.so: python/ola/_olafast.la
+	cp python/ola/.libs/_olafast.so $@
+endif
+
 python/ola/ArtNetConfigMessages_pb2.py: $(artnet_proto)
 	$(PROTOC) --python_out python/ola/ -I $(artnet_path) $(artnet_proto)
 
@@ -61,13 +78,21 @@ python/ola/Version.py: python/ola/Makefile.mk configure.ac config/ola_version.m4
 dist_check_SCRIPTS += \
     python/ola/DUBDecoderTest.py \
     python/ola/MACAddressTest.py \
+    python/ola/OlaClientTest.py \
     python/ola/UIDTest.py
 
 if BUILD_PYTHON_LIBS
 test_scripts += \
     python/ola/DUBDecoderTest.py \
     python/ola/MACAddressTest.py \
+    python/ola/OlaClientTest.sh \
     python/ola/UIDTest.py
 endif
 
-CLEANFILES += python/ola/*.pyc
+python/ola/OlaClientTest.sh: python/ola/Makefile.mk
+	mkdir -p python/ola
+	echo "export PYTHONPATH=${top_builddir}/python:${top_srcdir}/python; $(PYTHON) ${srcdir}/python/ola/OlaClientTest.py; exit \$$?" > python/ola/OlaClientTest.sh
+	chmod +x python/ola/OlaClientTest.sh
+
+CLEANFILES += python/ola/OlaClientTest.sh \
+              python/ola/*.pyc
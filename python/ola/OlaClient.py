@@ -16,6 +16,7 @@
 # Copyright (C) 2005 Simon Newton
 
 import array
+import logging
 import socket
 import struct
 from ola.rpc.StreamRpcChannel import StreamRpcChannel
@@ -23,6 +24,11 @@ from ola.rpc.SimpleRpcController import SimpleRpcController
 from ola import Ola_pb2
 from ola.UID import UID
 
+try:
+  from ola import _olafast
+except ImportError:
+  _olafast = None
+
 """The client used to communicate with the Ola Server."""
 
 __author__ = 'nomis52@gmail.com (Simon Newton)'
@@ -720,6 +726,9 @@ class OlaClient(Ola_pb2.OlaClientService):
     self._channel = StreamRpcChannel(self._socket, self, self._SocketClosed)
     self._stub = Ola_pb2.OlaServerService_Stub(self._channel)
     self._universe_callbacks = {}
+    if _olafast:
+      self._channel.SetRawRequestHandler('UpdateDmxData',
+                                         self._RawUpdateDmxData)
 
   def GetSocket(self):
     """Returns the socket used to communicate with the server."""
@@ -866,7 +875,8 @@ class OlaClient(Ola_pb2.OlaClientService):
 
     Args:
       universe: the universe to send the data for
-      data: An array object with the DMX data
+      data: The DMX data, either an array, bytes or any other object that
+        supports the buffer protocol.
       callback: The function to call once complete, takes one argument, a
         RequestStatus object.
 
@@ -877,13 +887,21 @@ class OlaClient(Ola_pb2.OlaClientService):
       return False
 
     controller = SimpleRpcController()
-    request = Ola_pb2.DmxData()
-    request.universe = universe
-    request.data = data.tostring()
     try:
-      self._stub.UpdateDmxData(
-          controller, request,
-          lambda x, y: self._AckMessageComplete(callback, x, y))
+      if _olafast:
+        # Skip the protobuf classes, the data is copied straight from the
+        # buffer into the request.
+        self._channel.CallMethodWithData(
+            'UpdateDmxData', controller,
+            _olafast.encode_dmx_data(universe, data), Ola_pb2.Ack,
+            lambda x, y: self._AckMessageComplete(callback, x, y))
+      else:
+        request = Ola_pb2.DmxData()
+        request.universe = universe
+        request.data = self._DataToBytes(data)
+        self._stub.UpdateDmxData(
+            controller, request,
+            lambda x, y: self._AckMessageComplete(callback, x, y))
     except socket.error:
       raise OLADNotRunningException()
     return True
@@ -1091,13 +1109,51 @@ class OlaClient(Ola_pb2.OlaClientService):
       return False
 
     if request.universe in self._universe_callbacks:
-      data = array.array('B')
-      data.fromstring(request.data)
+      data = array.array('B', request.data)
       self._universe_callbacks[request.universe](data)
     response = Ola_pb2.Ack()
     callback(response)
     return True
 
+  def _RawUpdateDmxData(self, request_data):
+    """Called with the serialized request when we receive new DMX data.
+
+    This is used instead of UpdateDmxData if the _olafast module is available.
+
+    Args:
+      request_data: A serialized DmxData message
+
+    Returns:
+      The serialized Ack.
+    """
+    try:
+      universe, data, priority = _olafast.decode_dmx_data(request_data)
+    except ValueError:
+      logging.warning('Received invalid DMX data')
+      return b''
+
+    data_callback = self._universe_callbacks.get(universe)
+    if data_callback:
+      data_callback(array.array('B', data))
+    # An Ack has no fields, so it serializes to nothing.
+    return b''
+
+  @staticmethod
+  def _DataToBytes(data):
+    """Convert DMX data passed to SendDmx to bytes.
+
+    Args:
+      data: an array, bytes or any other object which supports the buffer
+        protocol.
+    """
+    if isinstance(data, bytes):
+      return data
+    try:
+      return memoryview(data).tobytes()
+    except TypeError:
+      # Python 2 arrays don't support memoryview
+      return data.tostring()
+
   def FetchUIDList(self, universe, callback):
     """Used to get a list of UIDs for a particular universe.
 
@@ -0,0 +1,211 @@
+#!/usr/bin/env python
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+#
+# OlaClientTest.py
+# Copyright (C) 2026 agent
+
+import array
+import struct
+import unittest
+from ola import Ola_pb2
+from ola import OlaClient as OlaClientModule
+from ola.OlaClient import OlaClient
+from ola.rpc import Rpc_pb2
+from ola.rpc import StreamRpcChannel
+
+"""Test cases for sending and receiving DMX with the OlaClient.
+
+The tests are run with the pure Python implementation, and with the _olafast
+module if it's available.
+"""
+
+__author__ = 'nomis52@gmail.com (Simon Newton)'
+
+
+class MockSocket(object):
+  """A socket that records what was sent."""
+  def __init__(self):
+    self.sent = []
+    self.pending = []
+
+  def send(self, data):
+    self.sent.append(bytes(data))
+    return len(data)
+
+  def recv(self, size):
+    return self.pending.pop(0)
+
+
+def SetFastModule(module):
+  OlaClientModule._olafast = module
+  StreamRpcChannel._olafast = module
+
+
+def Frame(message, version=1):
+  data = message.SerializeToString()
+  return struct.pack('=L', (version << 28) | len(data)) + data
+
+
+def DmxRequest(message_id, universe, data):
+  dmx = Ola_pb2.DmxData()
+  dmx.universe = universe
+  dmx.data = data
+  message = Rpc_pb2.RpcMessage()
+  message.type = Rpc_pb2.REQUEST
+  message.id = message_id
+  message.name = 'UpdateDmxData'
+  message.buffer = dmx.SerializeToString()
+  return Frame(message)
+
+
+class OlaClientTest(unittest.TestCase):
+  def setUp(self):
+    self.fast_module = OlaClientModule._olafast
+
+  def tearDown(self):
+    SetFastModule(self.fast_module)
+
+  def Implementations(self):
+    """The values of _olafast to test with."""
+    implementations = [None]
+    if self.fast_module:
+      implementations.append(self.fast_module)
+    return implementations
+
+  def ParseSent(self, data):
+    header = struct.unpack('=L', data[:4])[0]
+    self.assertEqual(1, header >> 28)
+    self.assertEqual(len(data) - 4, header & 0x0fffffff)
+    message = Rpc_pb2.RpcMessage()
+    message.ParseFromString(data[4:])
+    return message
+
+  def testSendDmx(self):
+    for implementation in self.Implementations():
+      SetFastModule(implementation)
+      for data in [array.array('B', [1, 2, 3]), b'\x01\x02\x03',
+                   bytearray(b'\x01\x02\x03')]:
+        socket = MockSocket()
+        client = OlaClient(socket)
+        acks = []
+        self.assertTrue(client.SendDmx(5, data, acks.append))
+
+        message = self.ParseSent(socket.sent[-1])
+        self.assertEqual(Rpc_pb2.REQUEST, message.type)
+        self.assertEqual('UpdateDmxData', message.name)
+        request = Ola_pb2.DmxData()
+        request.ParseFromString(message.buffer)
+        self.assertEqual(5, request.universe)
+        self.assertEqual(b'\x01\x02\x03', request.data)
+        self.assertFalse(request.HasField('priority'))
+
+        response = Rpc_pb2.RpcMessage()
+        response.type = Rpc_pb2.RESPONSE
+        response.id = message.id
+        response.buffer = Ola_pb2.Ack().SerializeToString()
+        socket.pending.append(Frame(response))
+        client.SocketReady()
+        self.assertEqual(1, len(acks))
+        self.assertTrue(acks[0].Succeeded())
+
+  def testReceiveDmx(self):
+    for implementation in self.Implementations():
+      SetFastModule(implementation)
+      socket = MockSocket()
+      client = OlaClient(socket)
+      received = []
+      self.assertTrue(client.RegisterUniverse(5, client.PATCH,
+                                              received.append))
+
+      # A message split over two reads
+      data = DmxRequest(10, 5, b'\x00\xff')
+      socket.pending.extend([data[:3], data[3:]])
+      client.SocketReady()
+      self.assertEqual([], received)
+      client.SocketReady()
+      self.assertEqual([array.array('B', [0, 255])], received)
+
+      response = self.ParseSent(socket.sent[-1])
+      self.assertEqual(Rpc_pb2.RESPONSE, response.type)
+      self.assertEqual(10, response.id)
+
+      # Two messages in one read, the first is for a universe we haven't
+      # registered for.
+      socket.pending.append(DmxRequest(11, 6, b'\x01') +
+                            DmxRequest(12, 5, b'\x02\x03'))
+      client.SocketReady()
+      self.assertEqual(array.array('B', [2, 3]), received[-1])
+      self.assertEqual(2, len(received))
+      self.assertEqual(11, self.ParseSent(socket.sent[-2]).id)
+      self.assertEqual(12, self.ParseSent(socket.sent[-1]).id)
+
+  def testProtocolMismatch(self):
+    for implementation in self.Implementations():
+      SetFastModule(implementation)
+      socket = MockSocket()
+      client = OlaClient(socket)
+      received = []
+      client.RegisterUniverse(5, client.PATCH, received.append)
+
+      message = Rpc_pb2.RpcMessage()
+      message.type = Rpc_pb2.REQUEST
+      message.id = 1
+      message.name = 'UpdateDmxData'
+      sent = len(socket.sent)
+      socket.pending.append(Frame(message, version=2) +
+                            DmxRequest(2, 5, b'\x04'))
+      client.SocketReady()
+      self.assertEqual([array.array('B', [4])], received)
+      self.assertEqual(sent + 1, len(socket.sent))
+      self.assertEqual(2, self.ParseSent(socket.sent[-1]).id)
+
+  def testFastModule(self):
+    fast = self.fast_module
+    if fast is None:
+      return
+
+    message = Rpc_pb2.RpcMessage()
+    message.type = Rpc_pb2.RESPONSE_FAILED
+    message.id = 300
+    message.buffer = b'error'
+    self.assertEqual(Frame(message),
+                     fast.pack_rpc_message(message.type, 300, None, b'error'))
+
+    messages, consumed, skipped = fast.unpack_rpc_messages(
+        bytearray(Frame(message) + b'\x01\x00'))
+    self.assertEqual(len(Frame(message)), consumed)
+    self.assertEqual(0, skipped)
+    self.assertEqual(1, len(messages))
+    self.assertEqual((Rpc_pb2.RESPONSE_FAILED, 300, '', b'error'),
+                     tuple(messages[0]))
+
+    dmx = Ola_pb2.DmxData()
+    dmx.universe = -1
+    dmx.data = b'\x01' * 512
+    dmx.priority = 200
+    self.assertEqual(dmx.SerializeToString(),
+                     fast.encode_dmx_data(-1, memoryview(dmx.data), 200))
+    self.assertEqual((-1, dmx.data, 200),
+                     fast.decode_dmx_data(dmx.SerializeToString()))
+
+    dmx.ClearField('priority')
+    self.assertEqual((-1, dmx.data, None),
+                     fast.decode_dmx_data(dmx.SerializeToString()))
+    self.assertRaises(ValueError, fast.decode_dmx_data, b'\x08')
+    self.assertRaises(TypeError, fast.encode_dmx_data, 1, [1, 2])
+
+
+if __name__ == '__main__':
+  unittest.main()
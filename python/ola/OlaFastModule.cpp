@@ -0,0 +1,675 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OlaFastModule.cpp
+ * The ola._olafast extension, which speeds up the Python client.
+ * Copyright (C) 2026 agent
+ *
+ * Most of the time spent sending and receiving DMX from Python goes on
+ * building protobuf objects and splitting up the RPC stream. This module
+ * encodes and decodes the RpcMessage (common/rpc/Rpc.proto) and DmxData
+ * (common/protocol/Ola.proto) messages directly, so any changes to those
+ * messages need to be reflected here.
+ *
+ * DMX data can be passed as bytes, an array or anything else that supports
+ * the buffer protocol, it's copied straight into the output message.
+ *
+ * The module is optional, StreamRpcChannel.py and OlaClient.py fall back to
+ * the pure Python implementation if it can't be imported.
+ */
+
+// Python.h must come first.
+#include <Python.h>
+#if PY_MAJOR_VERSION < 3
+#include <structseq.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+// From StreamRpcChannel.py
+const uint32_t PROTOCOL_VERSION = 1;
+const uint32_t VERSION_MASK = 0xf0000000;
+const uint32_t SIZE_MASK = 0x0fffffff;
+const unsigned int HEADER_SIZE = sizeof(uint32_t);
+
+enum WireType {
+  WIRE_TYPE_VARINT = 0,
+  WIRE_TYPE_FIXED64 = 1,
+  WIRE_TYPE_LENGTH_DELIMITED = 2,
+  WIRE_TYPE_FIXED32 = 5,
+};
+
+// RpcMessage fields
+const unsigned int RPC_TYPE_FIELD = 1;
+const unsigned int RPC_ID_FIELD = 2;
+const unsigned int RPC_NAME_FIELD = 3;
+const unsigned int RPC_BUFFER_FIELD = 4;
+
+// DmxData fields
+const unsigned int DMX_UNIVERSE_FIELD = 1;
+const unsigned int DMX_DATA_FIELD = 2;
+const unsigned int DMX_PRIORITY_FIELD = 3;
+
+/**
+ * @brief A read only view of an object which supports the buffer protocol.
+ */
+class BufferView {
+ public:
+  BufferView() : m_data(NULL), m_size(0), m_have_view(false) {}
+
+  ~BufferView() {
+    if (m_have_view) {
+      PyBuffer_Release(&m_view);
+    }
+  }
+
+  /**
+   * @brief Get a view of an object.
+   * @returns false if the object doesn't support the buffer protocol, in
+   *   which case the Python exception has been set.
+   */
+  bool Get(PyObject *object) {
+    if (PyObject_CheckBuffer(object)) {
+      if (PyObject_GetBuffer(object, &m_view, PyBUF_SIMPLE) < 0) {
+        return false;
+      }
+      m_have_view = true;
+      m_data = static_cast<const uint8_t*>(m_view.buf);
+      m_size = m_view.len;
+      return true;
+    }
+#if PY_MAJOR_VERSION < 3
+    // Python 2 arrays only support the old buffer protocol.
+    const void *data;
+    Py_ssize_t size;
+    if (PyObject_AsReadBuffer(object, &data, &size) == 0) {
+      m_data = static_cast<const uint8_t*>(data);
+      m_size = size;
+      return true;
+    }
+    return false;
+#else
+    PyErr_Format(PyExc_TypeError,
+                 "a bytes-like object is required, not '%.100s'",
+                 Py_TYPE(object)->tp_name);
+    return false;
+#endif
+  }
+
+  const uint8_t *Data() const { return m_data; }
+  Py_ssize_t Size() const { return m_size; }
+
+ private:
+  Py_buffer m_view;
+  const uint8_t *m_data;
+  Py_ssize_t m_size;
+  bool m_have_view;
+};
+
+unsigned int VarintSize(uint64_t value) {
+  unsigned int size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    size++;
+  }
+  return size;
+}
+
+/*
+ * int32 fields are sign extended to 64 bits, so negative values always take
+ * 10 bytes.
+ */
+uint64_t Int32ToVarint(int32_t value) {
+  return static_cast<uint64_t>(static_cast<int64_t>(value));
+}
+
+unsigned int BytesFieldSize(Py_ssize_t size) {
+  return 1 + VarintSize(size) + size;
+}
+
+uint8_t *WriteVarint(uint8_t *ptr, uint64_t value) {
+  while (value >= 0x80) {
+    *ptr++ = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  *ptr++ = static_cast<uint8_t>(value);
+  return ptr;
+}
+
+uint8_t *WriteTag(uint8_t *ptr, unsigned int field, WireType wire_type) {
+  // All our field numbers fit in a single byte tag.
+  *ptr++ = static_cast<uint8_t>((field << 3) | wire_type);
+  return ptr;
+}
+
+uint8_t *WriteVarintField(uint8_t *ptr, unsigned int field, uint64_t value) {
+  return WriteVarint(WriteTag(ptr, field, WIRE_TYPE_VARINT), value);
+}
+
+uint8_t *WriteBytesField(uint8_t *ptr, unsigned int field,
+                         const uint8_t *data, Py_ssize_t size) {
+  ptr = WriteVarint(WriteTag(ptr, field, WIRE_TYPE_LENGTH_DELIMITED), size);
+  if (size) {
+    memcpy(ptr, data, size);
+  }
+  return ptr + size;
+}
+
+/**
+ * @brief Walks the fields of a serialized protobuf.
+ */
+class ProtoReader {
+ public:
+  ProtoReader(const uint8_t *data, size_t size)
+      : m_ptr(data),
+        m_end(data + size) {
+  }
+
+  bool AtEnd() const { return m_ptr == m_end; }
+
+  bool ReadTag(unsigned int *field, unsigned int *wire_type) {
+    uint64_t tag;
+    if (!ReadVarint(&tag)) {
+      return false;
+    }
+    *field = static_cast<unsigned int>(tag >> 3);
+    *wire_type = static_cast<unsigned int>(tag & 0x07);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t *value) {
+    *value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+      if (m_ptr == m_end) {
+        return false;
+      }
+      const uint8_t byte = *m_ptr++;
+      *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadBytes(const uint8_t **data, size_t *size) {
+    uint64_t length;
+    if (!ReadVarint(&length) ||
+        length > static_cast<uint64_t>(m_end - m_ptr)) {
+      return false;
+    }
+    *data = m_ptr;
+    *size = static_cast<size_t>(length);
+    m_ptr += length;
+    return true;
+  }
+
+  /**
+   * @brief Skip over a field we don't know about.
+   */
+  bool Skip(unsigned int wire_type) {
+    uint64_t value;
+    const uint8_t *data;
+    size_t size;
+    switch (wire_type) {
+      case WIRE_TYPE_VARINT:
+        return ReadVarint(&value);
+      case WIRE_TYPE_FIXED64:
+        return Advance(8);
+      case WIRE_TYPE_LENGTH_DELIMITED:
+        return ReadBytes(&data, &size);
+      case WIRE_TYPE_FIXED32:
+        return Advance(4);
+      default:
+        return false;
+    }
+  }
+
+ private:
+  const uint8_t *m_ptr;
+  const uint8_t *m_end;
+
+  bool Advance(size_t size) {
+    if (size > static_cast<size_t>(m_end - m_ptr)) {
+      return false;
+    }
+    m_ptr += size;
+    return true;
+  }
+};
+
+/*
+ * The decoded form of an RpcMessage, this has the same attributes as the
+ * Rpc_pb2.RpcMessage class, so it can be passed to the existing handlers in
+ * StreamRpcChannel.
+ */
+PyStructSequence_Field rpc_message_fields[] = {
+  {const_cast<char*>("type"), const_cast<char*>("The message type")},
+  {const_cast<char*>("id"), const_cast<char*>("The sequence number")},
+  {const_cast<char*>("name"), const_cast<char*>("The method name")},
+  {const_cast<char*>("buffer"),
+   const_cast<char*>("The serialized request or response")},
+  {NULL, NULL}
+};
+
+PyStructSequence_Desc rpc_message_desc = {
+  const_cast<char*>("ola._olafast.RpcMessage"),
+  const_cast<char*>("A RPC message received from the stream."),
+  rpc_message_fields,
+  4
+};
+
+PyTypeObject RpcMessageType;
+
+PyObject *NewString(const uint8_t *data, size_t size) {
+  const char *str = reinterpret_cast<const char*>(data);
+#if PY_MAJOR_VERSION >= 3
+  return PyUnicode_DecodeUTF8(str, size, "replace");
+#else
+  return PyString_FromStringAndSize(str, size);
+#endif
+}
+
+PyObject *NewBytes(const uint8_t *data, size_t size) {
+  return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(data), size);
+}
+
+/**
+ * @brief Parse a RpcMessage into a RpcMessageType object.
+ * @returns a new reference, or NULL if the message was invalid. The Python
+ *   exception is only set if we ran out of memory.
+ */
+PyObject *ParseRpcMessage(const uint8_t *data, size_t size) {
+  ProtoReader reader(data, size);
+  bool have_type = false;
+  uint64_t type = 0;
+  uint64_t id = 0;
+  const uint8_t *name = NULL;
+  size_t name_size = 0;
+  const uint8_t *buffer = NULL;
+  size_t buffer_size = 0;
+
+  while (!reader.AtEnd()) {
+    unsigned int field, wire_type;
+    if (!reader.ReadTag(&field, &wire_type)) {
+      return NULL;
+    }
+
+    bool ok;
+    if (field == RPC_TYPE_FIELD && wire_type == WIRE_TYPE_VARINT) {
+      ok = reader.ReadVarint(&type);
+      have_type = true;
+    } else if (field == RPC_ID_FIELD && wire_type == WIRE_TYPE_VARINT) {
+      ok = reader.ReadVarint(&id);
+    } else if (field == RPC_NAME_FIELD &&
+               wire_type == WIRE_TYPE_LENGTH_DELIMITED) {
+      ok = reader.ReadBytes(&name, &name_size);
+    } else if (field == RPC_BUFFER_FIELD &&
+               wire_type == WIRE_TYPE_LENGTH_DELIMITED) {
+      ok = reader.ReadBytes(&buffer, &buffer_size);
+    } else {
+      ok = reader.Skip(wire_type);
+    }
+    if (!ok) {
+      return NULL;
+    }
+  }
+
+  if (!have_type) {
+    return NULL;
+  }
+
+  PyObject *message = PyStructSequence_New(&RpcMessageType);
+  if (!message) {
+    return NULL;
+  }
+  PyObject *values[] = {
+    PyLong_FromUnsignedLongLong(type),
+    PyLong_FromUnsignedLong(static_cast<uint32_t>(id)),
+    NewString(name, name_size),
+    NewBytes(buffer, buffer_size),
+  };
+  bool ok = true;
+  for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    if (!values[i]) {
+      ok = false;
+    }
+    // This steals the reference.
+    PyStructSequence_SET_ITEM(message, i, values[i]);
+  }
+  if (!ok) {
+    Py_DECREF(message);
+    return NULL;
+  }
+  return message;
+}
+
+/**
+ * @brief Get a string argument as UTF-8 bytes.
+ * @returns a new reference, None is returned as an empty string.
+ */
+PyObject *StringToBytes(PyObject *object) {
+  if (object == Py_None) {
+    return PyBytes_FromStringAndSize("", 0);
+  } else if (PyUnicode_Check(object)) {
+    return PyUnicode_AsUTF8String(object);
+  }
+  Py_INCREF(object);
+  return object;
+}
+
+const char pack_rpc_message_doc[] =
+  "pack_rpc_message(type, id, name, buffer) -> bytes\n\n"
+  "Serialize a RpcMessage and prepend the stream header. name and buffer may "
+  "be None, in which case they are omitted.";
+
+PyObject *PackRpcMessage(PyObject *, PyObject *args) {
+  unsigned int type, id;
+  PyObject *name_arg = Py_None;
+  PyObject *buffer_arg = Py_None;
+  if (!PyArg_ParseTuple(args, "II|OO:pack_rpc_message", &type, &id,
+                        &name_arg, &buffer_arg)) {
+    return NULL;
+  }
+
+  PyObject *name_bytes = StringToBytes(name_arg);
+  if (!name_bytes) {
+    return NULL;
+  }
+
+  BufferView name;
+  BufferView buffer;
+  if ((name_arg != Py_None && !name.Get(name_bytes)) ||
+      (buffer_arg != Py_None && !buffer.Get(buffer_arg))) {
+    Py_DECREF(name_bytes);
+    return NULL;
+  }
+
+  Py_ssize_t size = 1 + VarintSize(type) + 1 + VarintSize(id);
+  if (name_arg != Py_None) {
+    size += BytesFieldSize(name.Size());
+  }
+  if (buffer_arg != Py_None) {
+    size += BytesFieldSize(buffer.Size());
+  }
+  if (size > static_cast<Py_ssize_t>(SIZE_MASK)) {
+    Py_DECREF(name_bytes);
+    PyErr_SetString(PyExc_ValueError, "RPC message too large");
+    return NULL;
+  }
+
+  PyObject *output = PyBytes_FromStringAndSize(NULL, HEADER_SIZE + size);
+  if (!output) {
+    Py_DECREF(name_bytes);
+    return NULL;
+  }
+
+  uint8_t *ptr = reinterpret_cast<uint8_t*>(PyBytes_AS_STRING(output));
+  const uint32_t header = ((PROTOCOL_VERSION << 28) & VERSION_MASK) |
+                          (static_cast<uint32_t>(size) & SIZE_MASK);
+  // The header is in host byte order.
+  memcpy(ptr, &header, HEADER_SIZE);
+  ptr += HEADER_SIZE;
+  ptr = WriteVarintField(ptr, RPC_TYPE_FIELD, type);
+  ptr = WriteVarintField(ptr, RPC_ID_FIELD, id);
+  if (name_arg != Py_None) {
+    ptr = WriteBytesField(ptr, RPC_NAME_FIELD, name.Data(), name.Size());
+  }
+  if (buffer_arg != Py_None) {
+    ptr = WriteBytesField(ptr, RPC_BUFFER_FIELD, buffer.Data(), buffer.Size());
+  }
+  Py_DECREF(name_bytes);
+  return output;
+}
+
+const char unpack_rpc_messages_doc[] =
+  "unpack_rpc_messages(data) -> (messages, consumed, skipped)\n\n"
+  "Split the complete messages from the start of a stream. messages is a list "
+  "of RpcMessage objects, consumed is the number of bytes used and skipped is "
+  "the number of messages which were dropped because of a protocol version "
+  "mismatch or because they couldn't be parsed.";
+
+PyObject *UnpackRpcMessages(PyObject *, PyObject *args) {
+  PyObject *data_arg;
+  if (!PyArg_ParseTuple(args, "O:unpack_rpc_messages", &data_arg)) {
+    return NULL;
+  }
+
+  BufferView data;
+  if (!data.Get(data_arg)) {
+    return NULL;
+  }
+
+  PyObject *messages = PyList_New(0);
+  if (!messages) {
+    return NULL;
+  }
+
+  const uint8_t *ptr = data.Data();
+  size_t remaining = data.Size();
+  unsigned int skipped = 0;
+  while (remaining >= HEADER_SIZE) {
+    uint32_t header;
+    memcpy(&header, ptr, HEADER_SIZE);
+    const uint32_t version = (header & VERSION_MASK) >> 28;
+    const uint32_t size = header & SIZE_MASK;
+    if (remaining - HEADER_SIZE < size) {
+      break;
+    }
+    const uint8_t *message_data = ptr + HEADER_SIZE;
+    ptr += HEADER_SIZE + size;
+    remaining -= HEADER_SIZE + size;
+
+    if (version != PROTOCOL_VERSION) {
+      skipped++;
+      continue;
+    }
+
+    PyObject *message = ParseRpcMessage(message_data, size);
+    if (!message) {
+      if (PyErr_Occurred()) {
+        Py_DECREF(messages);
+        return NULL;
+      }
+      skipped++;
+      continue;
+    }
+    const int r = PyList_Append(messages, message);
+    Py_DECREF(message);
+    if (r < 0) {
+      Py_DECREF(messages);
+      return NULL;
+    }
+  }
+
+  return Py_BuildValue("(NnI)", messages,
+                       static_cast<Py_ssize_t>(ptr - data.Data()), skipped);
+}
+
+const char encode_dmx_data_doc[] =
+  "encode_dmx_data(universe, data, priority=None) -> bytes\n\n"
+  "Serialize a DmxData message. data may be any object which supports the "
+  "buffer protocol, e.g. bytes, bytearray or array('B').";
+
+PyObject *EncodeDmxData(PyObject *, PyObject *args) {
+  int universe;
+  PyObject *data_arg;
+  PyObject *priority_arg = Py_None;
+  if (!PyArg_ParseTuple(args, "iO|O:encode_dmx_data", &universe, &data_arg,
+                        &priority_arg)) {
+    return NULL;
+  }
+
+  int priority = 0;
+  const bool have_priority = priority_arg != Py_None;
+  if (have_priority) {
+    priority = static_cast<int>(PyLong_AsLong(priority_arg));
+    if (priority == -1 && PyErr_Occurred()) {
+      return NULL;
+    }
+  }
+
+  BufferView data;
+  if (!data.Get(data_arg)) {
+    return NULL;
+  }
+
+  Py_ssize_t size = 1 + VarintSize(Int32ToVarint(universe)) +
+                    BytesFieldSize(data.Size());
+  if (have_priority) {
+    size += 1 + VarintSize(Int32ToVarint(priority));
+  }
+
+  PyObject *output = PyBytes_FromStringAndSize(NULL, size);
+  if (!output) {
+    return NULL;
+  }
+  uint8_t *ptr = reinterpret_cast<uint8_t*>(PyBytes_AS_STRING(output));
+  ptr = WriteVarintField(ptr, DMX_UNIVERSE_FIELD, Int32ToVarint(universe));
+  ptr = WriteBytesField(ptr, DMX_DATA_FIELD, data.Data(), data.Size());
+  if (have_priority) {
+    ptr = WriteVarintField(ptr, DMX_PRIORITY_FIELD, Int32ToVarint(priority));
+  }
+  return output;
+}
+
+const char decode_dmx_data_doc[] =
+  "decode_dmx_data(buffer) -> (universe, data, priority)\n\n"
+  "Parse a DmxData message. priority is None if it wasn't set. Raises "
+  "ValueError if the message is invalid.";
+
+PyObject *DecodeDmxData(PyObject *, PyObject *args) {
+  PyObject *buffer_arg;
+  if (!PyArg_ParseTuple(args, "O:decode_dmx_data", &buffer_arg)) {
+    return NULL;
+  }
+
+  BufferView buffer;
+  if (!buffer.Get(buffer_arg)) {
+    return NULL;
+  }
+
+  ProtoReader reader(buffer.Data(), buffer.Size());
+  bool have_universe = false;
+  bool have_priority = false;
+  uint64_t universe = 0;
+  uint64_t priority = 0;
+  const uint8_t *data = NULL;
+  size_t data_size = 0;
+
+  while (!reader.AtEnd()) {
+    unsigned int field, wire_type;
+    if (!reader.ReadTag(&field, &wire_type)) {
+      break;
+    }
+
+    bool ok;
+    if (field == DMX_UNIVERSE_FIELD && wire_type == WIRE_TYPE_VARINT) {
+      ok = reader.ReadVarint(&universe);
+      have_universe = true;
+    } else if (field == DMX_DATA_FIELD &&
+               wire_type == WIRE_TYPE_LENGTH_DELIMITED) {
+      ok = reader.ReadBytes(&data, &data_size);
+    } else if (field == DMX_PRIORITY_FIELD && wire_type == WIRE_TYPE_VARINT) {
+      ok = reader.ReadVarint(&priority);
+      have_priority = true;
+    } else {
+      ok = reader.Skip(wire_type);
+    }
+    if (!ok) {
+      PyErr_SetString(PyExc_ValueError, "Invalid DmxData message");
+      return NULL;
+    }
+  }
+
+  if (!reader.AtEnd() || !have_universe || !data) {
+    PyErr_SetString(PyExc_ValueError, "Invalid DmxData message");
+    return NULL;
+  }
+
+  PyObject *priority_value;
+  if (have_priority) {
+    priority_value = PyLong_FromLong(static_cast<int32_t>(priority));
+  } else {
+    Py_INCREF(Py_None);
+    priority_value = Py_None;
+  }
+  return Py_BuildValue("(iNN)", static_cast<int32_t>(universe),
+                       NewBytes(data, data_size), priority_value);
+}
+
+PyMethodDef olafast_methods[] = {
+  {"pack_rpc_message", PackRpcMessage, METH_VARARGS, pack_rpc_message_doc},
+  {"unpack_rpc_messages", UnpackRpcMessages, METH_VARARGS,
+   unpack_rpc_messages_doc},
+  {"encode_dmx_data", EncodeDmxData, METH_VARARGS, encode_dmx_data_doc},
+  {"decode_dmx_data", DecodeDmxData, METH_VARARGS, decode_dmx_data_doc},
+  {NULL, NULL, 0, NULL}
+};
+
+const char olafast_doc[] =
+  "Fast paths for the OLA Python client.";
+
+/**
+ * @brief Add the types to the module.
+ * @returns false if there was an error.
+ */
+bool InitModule(PyObject *module) {
+  if (!module) {
+    return false;
+  }
+  if (!RpcMessageType.tp_name) {
+#if PY_MAJOR_VERSION >= 3
+    if (PyStructSequence_InitType2(&RpcMessageType, &rpc_message_desc) < 0) {
+      return false;
+    }
+#else
+    PyStructSequence_InitType(&RpcMessageType, &rpc_message_desc);
+#endif
+  }
+  PyObject *type = reinterpret_cast<PyObject*>(&RpcMessageType);
+  Py_INCREF(type);
+  return PyModule_AddObject(module, "RpcMessage", type) == 0;
+}
+}  // namespace
+
+#if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef olafast_module = {
+  PyModuleDef_HEAD_INIT,
+  "_olafast",
+  olafast_doc,
+  -1,
+  olafast_methods,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+PyMODINIT_FUNC PyInit__olafast(void) {
+  PyObject *module = PyModule_Create(&olafast_module);
+  if (!InitModule(module)) {
+    Py_XDECREF(module);
+    return NULL;
+  }
+  return module;
+}
+#else
+PyMODINIT_FUNC init_olafast(void) {
+  InitModule(Py_InitModule3("_olafast", olafast_methods, olafast_doc));
+}
+#endif
@@ -21,6 +21,11 @@ from google.protobuf import service
 from ola.rpc import Rpc_pb2
 from ola.rpc.SimpleRpcController import SimpleRpcController
 
+try:
+  from ola import _olafast
+except ImportError:
+  _olafast = None
+
 """A RpcChannel that works over a TCP socket."""
 
 __author__ = 'nomis52@gmail.com (Simon Newton)'
@@ -62,7 +67,13 @@ class StreamRpcChannel(service.RpcChannel):
     self._sequence = 0
     self._outstanding_requests = {}
     self._outstanding_responses = {}
-    self._buffer = []  # The received data
+    self._raw_request_handlers = {}
+    # The compiled fast path, None if it's not available.
+    self._fast = _olafast
+    if self._fast:
+      self._buffer = bytearray()
+    else:
+      self._buffer = []  # The received data
     self._expected_size = None  # The size of the message we're receiving
     self._skip_message = False  # Skip the current message
     self._close_callback = close_callback
@@ -80,10 +91,26 @@ class StreamRpcChannel(service.RpcChannel):
         self._close_callback()
       return False
 
-    self._buffer.append(data)
-    self._ProcessIncomingData()
+    if self._fast:
+      self._buffer.extend(data)
+      self._ProcessIncomingDataFast()
+    else:
+      self._buffer.append(data)
+      self._ProcessIncomingData()
     return True
 
+  def SetRawRequestHandler(self, method_name, handler):
+    """Handle requests for a method without parsing them.
+
+    This bypasses the protobuf classes for methods that are called often.
+
+    Args:
+      method_name: the name of the method.
+      handler: called with the serialized request, returns the serialized
+        response.
+    """
+    self._raw_request_handlers[method_name] = handler
+
   def CallMethod(self, method, controller, request, response_pb, done):
     """Call a method.
 
@@ -96,24 +123,35 @@ class StreamRpcChannel(service.RpcChannel):
       response: The response class
       done: A closure to call once complete.
     """
-    message = Rpc_pb2.RpcMessage()
-    message.type = Rpc_pb2.REQUEST
-    message.id = self._sequence
-    message.name = method.name
-    message.buffer = request.SerializeToString()
-    self._SendMessage(message)
+    self.CallMethodWithData(method.name, controller,
+                            request.SerializeToString(), response_pb, done)
+
+  def CallMethodWithData(self, method_name, controller, request_data,
+                         response_pb, done):
+    """Call a method with an already serialized request.
+
+    Args:
+      method_name: The name of the method to call
+      controller: An RpcController object
+      request_data: The serialized request message
+      response: The response class
+      done: A closure to call once complete.
+    """
+    message_id = self._sequence
+    self._SendRpcMessage(Rpc_pb2.REQUEST, message_id, method_name,
+                         request_data)
     self._sequence += 1
 
-    if message.id in self._outstanding_responses:
+    if message_id in self._outstanding_responses:
       # fail any outstanding response with the same id, not the best approach
       # but it'll do for now.
-      logging.warning('Response %d already pending, failing now', message.id)
-      response = self._outstanding_responses[message.id]
+      logging.warning('Response %d already pending, failing now', message_id)
+      response = self._outstanding_responses[message_id]
       response.controller.SetFailed('Duplicate request found')
       self._InvokeCallback(response)
 
-    response = OutstandingResponse(message.id, controller, done, response_pb)
-    self._outstanding_responses[message.id] = response
+    response = OutstandingResponse(message_id, controller, done, response_pb)
+    self._outstanding_responses[message_id] = response
 
   def RequestComplete(self, request, response):
     """This is called on the server side when a request has completed.
@@ -122,16 +160,12 @@ class StreamRpcChannel(service.RpcChannel):
       request: the OutstandingRequest object that has completed.
       response: the response to send to the client
     """
-    message = Rpc_pb2.RpcMessage()
-
     if request.controller.Failed():
       self._SendRequestFailed(request)
       return
 
-    message.type = Rpc_pb2.RESPONSE
-    message.id = request.id
-    message.buffer = response.SerializeToString()
-    self._SendMessage(message)
+    self._SendRpcMessage(Rpc_pb2.RESPONSE, request.id,
+                         buffer=response.SerializeToString())
     del self._outstanding_requests[request.id]
 
   def _EncodeHeader(self, size):
@@ -158,19 +192,42 @@ class StreamRpcChannel(service.RpcChannel):
     """
     return ((header & self.VERSION_MASK) >> 28, header & self.SIZE_MASK)
 
-  def _SendMessage(self, message):
-    """Send an RpcMessage.
+  def _SendRpcMessage(self, message_type, message_id, name=None, buffer=None):
+    """Build and send an RpcMessage.
 
     Args:
-      message: An RpcMessage object.
+      message_type: the type of message.
+      message_id: the id of the message.
+      name: the method name, if any.
+      buffer: the serialized request or response, if any.
 
     Returns:
       True if the send succeeded, False otherwise.
     """
+    if self._fast:
+      return self._SendData(self._fast.pack_rpc_message(
+          message_type, message_id, name, buffer))
+
+    message = Rpc_pb2.RpcMessage()
+    message.type = message_type
+    message.id = message_id
+    if name is not None:
+      message.name = name
+    if buffer is not None:
+      message.buffer = buffer
     data = message.SerializeToString()
     # combine into one buffer to send so we avoid sending two packets
-    data = self._EncodeHeader(len(data)) + data
+    return self._SendData(self._EncodeHeader(len(data)) + data)
+
+  def _SendData(self, data):
+    """Send a framed message.
+
+    Args:
+      data: the header and serialized RpcMessage.
 
+    Returns:
+      True if the send succeeded, False otherwise.
+    """
     sent_bytes = self._socket.send(data)
     if sent_bytes != len(data):
       logging.warning('Failed to send full datagram')
@@ -184,11 +241,8 @@ class StreamRpcChannel(service.RpcChannel):
       request: An OutstandingRequest object.
 
     """
-    message = Rpc_pb2.RpcMessage()
-    message.type = Rpc_pb2.RESPONSE_FAILED
-    message.id = request.id
-    message.buffer = request.controller.ErrorText()
-    self._SendMessage(message)
+    self._SendRpcMessage(Rpc_pb2.RESPONSE_FAILED, request.id,
+                         buffer=request.controller.ErrorText())
     del self._outstanding_requests[request.id]
 
   def _SendNotImplemented(self, message_id):
@@ -197,10 +251,7 @@ class StreamRpcChannel(service.RpcChannel):
     Args:
       message_id: The message number.
     """
-    message = Rpc_pb2.RpcMessage
-    message.type = Rpc_pb2.RESPONSE_NOT_IMPLEMENTED
-    message.id = message_id
-    self._SendMessage(message)
+    self._SendRpcMessage(Rpc_pb2.RESPONSE_NOT_IMPLEMENTED, message_id)
 
   def _GrabData(self, size):
     """Fetch the next N bytes of data from the buffer.
@@ -259,6 +310,16 @@ class StreamRpcChannel(service.RpcChannel):
       self._expected_size = 0
       self._skip_message = 0
 
+  def _ProcessIncomingDataFast(self):
+    """Process the received data using the compiled module."""
+    messages, consumed, skipped = self._fast.unpack_rpc_messages(self._buffer)
+    del self._buffer[:consumed]
+    if skipped:
+      logging.warning('Skipped %d invalid RPC messages', skipped)
+
+    for message in messages:
+      self._DispatchMessage(message)
+
   def _HandleNewMessage(self, data):
     """Handle a new Message.
 
@@ -267,11 +328,18 @@ class StreamRpcChannel(service.RpcChannel):
     """
     message = Rpc_pb2.RpcMessage()
     message.ParseFromString(data)
+    self._DispatchMessage(message)
 
+  def _DispatchMessage(self, message):
+    """Pass a message to the handler for its type.
+
+    Args:
+      message: The RpcMessage object.
+    """
     if message.type in self.MESSAGE_HANDLERS:
       self.MESSAGE_HANDLERS[message.type](self, message)
     else:
-      logging.warning('Not sure of message type %d', message.type())
+      logging.warning('Not sure of message type %d', message.type)
 
   def _HandleRequest(self, message):
     """Handle a Request message.
@@ -279,6 +347,12 @@ class StreamRpcChannel(service.RpcChannel):
     Args:
       message: The RpcMessage object.
     """
+    raw_handler = self._raw_request_handlers.get(message.name)
+    if raw_handler:
+      self._SendRpcMessage(Rpc_pb2.RESPONSE, message.id,
+                           buffer=raw_handler(message.buffer))
+      return
+
     if not self._service:
       logging.warning('No service registered')
       return
@@ -2,11 +2,32 @@ if HAVE_SALEAE_LOGIC
 bin_PROGRAMS += tools/logic/logic_rdm_sniffer
 endif
 
+noinst_PROGRAMS += tools/logic/logic_capture_replay
+
 tools_logic_logic_rdm_sniffer_SOURCES = \
-    tools/logic/DMXSignalProcessor.cpp \
-    tools/logic/DMXSignalProcessor.h \
+    tools/logic/MultiChannelDMXDecoder.cpp \
+    tools/logic/MultiChannelDMXDecoder.h \
     tools/logic/logic-rdm-sniffer.cpp
 tools_logic_logic_rdm_sniffer_LDADD = common/libolacommon.la \
                                       $(libSaleaeDevice_LIBS)
 
+tools_logic_logic_capture_replay_SOURCES = \
+    tools/logic/DMXSignalProcessor.cpp \
+    tools/logic/DMXSignalProcessor.h \
+    tools/logic/MultiChannelDMXDecoder.cpp \
+    tools/logic/MultiChannelDMXDecoder.h \
+    tools/logic/logic-capture-replay.cpp
+tools_logic_logic_capture_replay_LDADD = common/libolacommon.la
+
+# TESTS
+##################################################
+test_programs += tools/logic/MultiChannelDMXDecoderTester
+
+tools_logic_MultiChannelDMXDecoderTester_SOURCES = \
+    tools/logic/MultiChannelDMXDecoder.cpp \
+    tools/logic/MultiChannelDMXDecoder.h \
+    tools/logic/MultiChannelDMXDecoderTest.cpp
+tools_logic_MultiChannelDMXDecoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+tools_logic_MultiChannelDMXDecoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
 EXTRA_DIST += tools/logic/README.md
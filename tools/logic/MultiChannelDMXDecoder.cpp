@@ -0,0 +1,307 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MultiChannelDMXDecoder.cpp
+ * Decode DMX / RDM frames from all channels of a logic capture in one pass.
+ * Copyright (C) 2026 agent
+ *
+ * A DMX signal is made up of long runs of the same level, at 4MHz each bit is
+ * 16 samples and the mark between slots may be much longer. So instead of
+ * running a state machine for every sample, we look for edges and work with
+ * the length of the runs between them.
+ *
+ * The edge search loads 8 samples into a 64 bit word and compares them against
+ * the previous sample repeated 8 times, which lets us skip over runs without a
+ * transition on any of the channels we're interested in. When there is a
+ * transition, the changed bits tell us which channels had an edge.
+ *
+ * For each channel, a low run that's longer than the minimum break time is a
+ * break. Otherwise the length of the run is rounded to a number of bits and
+ * fed into a UART decoder. Since we resync on every edge, the bit time can
+ * drift by up to half a bit over a run.
+ */
+
+#include <ola/Logging.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "tools/logic/MultiChannelDMXDecoder.h"
+
+namespace {
+// Multiply a byte by this to repeat it in each byte of a uint64_t.
+const uint64_t BYTE_BROADCAST = 0x0101010101010101ULL;
+}  // namespace
+
+const unsigned int MultiChannelDMXDecoder::MAX_CHANNELS;
+
+MultiChannelDMXDecoder::MultiChannelDMXDecoder(FrameCallback *callback,
+                                               unsigned int sample_rate,
+                                               uint8_t channel_mask)
+    : m_callback(callback),
+      m_sample_rate(sample_rate),
+      m_channel_mask(channel_mask),
+      m_min_break_ticks(MicroSecondsToTicks(MIN_BREAK_TIME)),
+      m_min_mab_ticks(MicroSecondsToTicks(MIN_MAB_TIME)),
+      m_max_mark_ticks(MicroSecondsToTicks(MAX_MARK_TIME)),
+      m_tick(0),
+      m_last_sample(0),
+      m_have_sample(false) {
+  if (m_sample_rate % DMX_BITRATE) {
+    OLA_WARN << "Sample rate is not a multiple of " << DMX_BITRATE;
+  }
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    m_channels[i].framing_errors = 0;
+    m_channels[i].frame.reserve(MAX_FRAME_SIZE);
+  }
+  Reset();
+}
+
+MultiChannelDMXDecoder::~MultiChannelDMXDecoder() {}
+
+void MultiChannelDMXDecoder::Reset() {
+  m_have_sample = false;
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    Channel &channel = m_channels[i];
+    channel.state = WAIT_FOR_BREAK;
+    channel.seen_edge = false;
+    channel.last_edge = 0;
+    channel.bit_index = 0;
+    channel.current_byte = 0;
+    channel.frame.clear();
+  }
+}
+
+void MultiChannelDMXDecoder::Process(const uint8_t *samples,
+                                     unsigned int size) {
+  unsigned int i = 0;
+  if (!m_have_sample) {
+    if (!size) {
+      return;
+    }
+    m_last_sample = samples[0];
+    m_have_sample = true;
+    i = 1;
+  }
+
+  const uint64_t mask = BYTE_BROADCAST * m_channel_mask;
+  uint8_t last = m_last_sample;
+  uint64_t pattern = BYTE_BROADCAST * last;
+
+  while (i < size) {
+    if (i + sizeof(pattern) <= size) {
+      uint64_t word;
+      memcpy(&word, samples + i, sizeof(word));
+      if (((word ^ pattern) & mask) == 0) {
+        i += sizeof(word);
+        continue;
+      }
+    }
+
+    // There is an edge in the next 8 samples, or we're at the end of the
+    // buffer.
+    const unsigned int end = std::min(
+        i + static_cast<unsigned int>(sizeof(pattern)), size);
+    for (; i < end; i++) {
+      const uint8_t changed = (samples[i] ^ last) & m_channel_mask;
+      if (changed) {
+        HandleEdges(m_tick + i, samples[i], changed);
+        last = samples[i];
+        pattern = BYTE_BROADCAST * last;
+        i++;
+        break;
+      }
+    }
+  }
+  m_last_sample = last;
+  m_tick += size;
+}
+
+void MultiChannelDMXDecoder::Flush() {
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    if (m_channels[i].state == DATA) {
+      if (m_last_sample & (1 << i)) {
+        // The mark since the last edge may complete the last slot.
+        FinishSlot(i, m_tick - m_channels[i].last_edge);
+      }
+      EmitFrame(i);
+      m_channels[i].state = WAIT_FOR_BREAK;
+    }
+  }
+}
+
+unsigned int MultiChannelDMXDecoder::FramingErrors(
+    unsigned int channel) const {
+  return channel < MAX_CHANNELS ? m_channels[channel].framing_errors : 0;
+}
+
+/**
+ * Called when one or more channels change level.
+ * @param tick the tick of the first sample at the new level.
+ * @param sample the new sample.
+ * @param changed the channels which changed.
+ */
+void MultiChannelDMXDecoder::HandleEdges(uint64_t tick, uint8_t sample,
+                                         uint8_t changed) {
+  for (unsigned int i = 0; changed; i++, changed >>= 1) {
+    if (!(changed & 1)) {
+      continue;
+    }
+    Channel &channel = m_channels[i];
+    if (channel.seen_edge) {
+      // The run that just ended was at the opposite level.
+      const bool level = (sample & (1 << i)) == 0;
+      ProcessRun(i, level, tick - channel.last_edge);
+    }
+    channel.seen_edge = true;
+    channel.last_edge = tick;
+  }
+}
+
+/**
+ * Process a run of samples at the same level.
+ */
+void MultiChannelDMXDecoder::ProcessRun(unsigned int channel_id, bool level,
+                                        uint64_t ticks) {
+  Channel &channel = m_channels[channel_id];
+  switch (channel.state) {
+    case WAIT_FOR_BREAK:
+      if (!level && ticks >= m_min_break_ticks) {
+        channel.state = MAB;
+      }
+      break;
+    case MAB:
+      // This is always a high, since it follows the break.
+      if (ticks >= m_min_mab_ticks) {
+        channel.state = DATA;
+        channel.bit_index = 0;
+        channel.frame.clear();
+      } else {
+        OLA_INFO << "Channel " << channel_id << ": short MAB of " << ticks
+                 << " ticks";
+        channel.state = WAIT_FOR_BREAK;
+      }
+      break;
+    case DATA:
+      if (!level && ticks >= m_min_break_ticks) {
+        // The start of the next frame.
+        EmitFrame(channel_id);
+        channel.state = MAB;
+      } else if (level && ticks >= m_max_mark_ticks) {
+        // The start of the mark holds the stop bit of the last slot.
+        FinishSlot(channel_id, ticks);
+        EmitFrame(channel_id);
+        channel.state = WAIT_FOR_BREAK;
+      } else {
+        ProcessBits(channel_id, level, TicksToBits(ticks));
+      }
+      break;
+  }
+}
+
+/**
+ * Feed a number of bits at the same level into the UART decoder.
+ */
+void MultiChannelDMXDecoder::ProcessBits(unsigned int channel_id, bool level,
+                                         uint64_t bits) {
+  Channel &channel = m_channels[channel_id];
+  if (bits == 0) {
+    // A glitch, shorter than half a bit.
+    FramingError(channel_id);
+    return;
+  }
+
+  if (!level && channel.bit_index == 0 && bits > MAX_LOW_BITS) {
+    // Too long for a start bit and data, but too short for a break.
+    FramingError(channel_id);
+    return;
+  }
+
+  while (bits) {
+    if (channel.bit_index == 0) {
+      if (level) {
+        // The rest of the run is the mark between slots.
+        return;
+      }
+      // start bit
+      channel.current_byte = 0;
+      channel.bit_index++;
+    } else if (channel.bit_index <= 8) {
+      if (level) {
+        channel.current_byte |= 1 << (channel.bit_index - 1);
+      }
+      channel.bit_index++;
+    } else {
+      // The first stop bit, anything after this is either the second stop bit
+      // or the mark between slots.
+      if (!level || channel.frame.size() == MAX_FRAME_SIZE) {
+        FramingError(channel_id);
+        return;
+      }
+      channel.frame.push_back(channel.current_byte);
+      channel.bit_index = 0;
+    }
+    bits--;
+  }
+}
+
+/**
+ * Called with a mark that isn't followed by more data, either because it's
+ * longer than the maximum mark time or because the capture ended. Feed in
+ * enough of the mark to complete any slot in progress.
+ */
+void MultiChannelDMXDecoder::FinishSlot(unsigned int channel_id,
+                                        uint64_t ticks) {
+  const Channel &channel = m_channels[channel_id];
+  if (channel.bit_index == 0) {
+    return;
+  }
+  // The remaining data bits and the stop bit.
+  const uint64_t bits = std::min(
+      TicksToBits(ticks), static_cast<uint64_t>(10 - channel.bit_index));
+  if (bits) {
+    ProcessBits(channel_id, true, bits);
+  }
+}
+
+void MultiChannelDMXDecoder::FramingError(unsigned int channel_id) {
+  Channel &channel = m_channels[channel_id];
+  OLA_INFO << "Channel " << channel_id << ": framing error after "
+           << channel.frame.size() << " slots";
+  channel.framing_errors++;
+  channel.frame.clear();
+  channel.state = WAIT_FOR_BREAK;
+}
+
+void MultiChannelDMXDecoder::EmitFrame(unsigned int channel_id) {
+  std::vector<uint8_t> &frame = m_channels[channel_id].frame;
+  if (!frame.empty()) {
+    m_callback->Run(channel_id, &frame[0], frame.size());
+    frame.clear();
+  }
+}
+
+uint64_t MultiChannelDMXDecoder::TicksToBits(uint64_t ticks) const {
+  // Round to the nearest number of bits.
+  return (ticks * DMX_BITRATE + m_sample_rate / 2) / m_sample_rate;
+}
+
+uint64_t MultiChannelDMXDecoder::MicroSecondsToTicks(
+    unsigned int micro_seconds) const {
+  return (static_cast<uint64_t>(micro_seconds) * m_sample_rate + 999999) /
+      1000000;
+}
@@ -0,0 +1,141 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MultiChannelDMXDecoder.h
+ * Decode DMX / RDM frames from all channels of a logic capture in one pass.
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef TOOLS_LOGIC_MULTICHANNELDMXDECODER_H_
+#define TOOLS_LOGIC_MULTICHANNELDMXDECODER_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Decode DMX signals on up to 8 logic analyzer channels.
+ *
+ * Each sample is one byte, with bit N holding the level of channel N. Rather
+ * than running a state machine for every sample, the decoder scans the buffer
+ * for edges, 8 samples at a time, and passes the length of each high or low
+ * run to the state machine for that channel. All timing is done with integer
+ * tick counts which are calculated from the sample rate up front.
+ *
+ * Frames are delivered as they complete, including the start code, so the
+ * callback can split the stream into DMX, RDM and alternate start code frames.
+ */
+class MultiChannelDMXDecoder {
+ public:
+    static const unsigned int MAX_CHANNELS = 8;
+
+    // The arguments are the channel, the frame data and the frame length.
+    typedef ola::Callback3<void, unsigned int, const uint8_t*, unsigned int>
+        FrameCallback;
+
+    /**
+     * @brief Create a new decoder.
+     * @param callback run when a frame is received, ownership is transferred.
+     * @param sample_rate the sample rate in Hz, this should be at least 1MHz.
+     * @param channel_mask the channels to decode.
+     */
+    MultiChannelDMXDecoder(FrameCallback *callback,
+                           unsigned int sample_rate,
+                           uint8_t channel_mask = 0xff);
+    ~MultiChannelDMXDecoder();
+
+    /**
+     * @brief Reset the decoder. Used if there is a gap in the stream.
+     */
+    void Reset();
+
+    /**
+     * @brief Decode more samples.
+     */
+    void Process(const uint8_t *samples, unsigned int size);
+
+    /**
+     * @brief Deliver any partially received frames, e.g. at the end of a
+     * capture.
+     */
+    void Flush();
+
+    uint8_t ChannelMask() const { return m_channel_mask; }
+
+    /**
+     * @brief The number of framing errors seen on a channel.
+     */
+    unsigned int FramingErrors(unsigned int channel) const;
+
+ private:
+    enum State {
+      WAIT_FOR_BREAK,  // until we see a valid break.
+      MAB,  // after the break.
+      DATA,  // receiving slots.
+    };
+
+    struct Channel {
+      State state;
+      // false until we've seen the first edge, before that we don't know how
+      // long the line has been at its current level.
+      bool seen_edge;
+      uint64_t last_edge;
+      // 0 means we're waiting for a start bit, 1 - 8 are the data bits and 9
+      // is the first stop bit.
+      unsigned int bit_index;
+      uint8_t current_byte;
+      unsigned int framing_errors;
+      std::vector<uint8_t> frame;
+    };
+
+    std::auto_ptr<FrameCallback> m_callback;
+    const unsigned int m_sample_rate;
+    const uint8_t m_channel_mask;
+    // These are calculated from the sample rate.
+    const uint64_t m_min_break_ticks;
+    const uint64_t m_min_mab_ticks;
+    const uint64_t m_max_mark_ticks;
+
+    uint64_t m_tick;  // The number of samples seen so far.
+    uint8_t m_last_sample;
+    bool m_have_sample;
+    Channel m_channels[MAX_CHANNELS];
+
+    void HandleEdges(uint64_t tick, uint8_t sample, uint8_t changed);
+    void ProcessRun(unsigned int channel_id, bool level, uint64_t ticks);
+    void ProcessBits(unsigned int channel_id, bool level, uint64_t bits);
+    void FinishSlot(unsigned int channel_id, uint64_t ticks);
+    void FramingError(unsigned int channel_id);
+    void EmitFrame(unsigned int channel_id);
+    uint64_t TicksToBits(uint64_t ticks) const;
+    uint64_t MicroSecondsToTicks(unsigned int micro_seconds) const;
+
+    static const unsigned int DMX_BITRATE = 250000;
+    // These are in microseconds and are the receiver side limits.
+    static const unsigned int MIN_BREAK_TIME = 88;
+    static const unsigned int MIN_MAB_TIME = 8;
+    static const unsigned int MAX_MARK_TIME = 1000000;
+    // A low which is longer than the start bit + 8 data bits, but shorter than
+    // a break, is a framing error.
+    static const unsigned int MAX_LOW_BITS = 9;
+    // Start code + 512 slots.
+    static const unsigned int MAX_FRAME_SIZE = 513;
+
+    DISALLOW_COPY_AND_ASSIGN(MultiChannelDMXDecoder);
+};
+#endif  // TOOLS_LOGIC_MULTICHANNELDMXDECODER_H_
@@ -0,0 +1,280 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * MultiChannelDMXDecoderTest.cpp
+ * Test fixture for the MultiChannelDMXDecoder class.
+ * Copyright (C) 2026 agent
+ */
+
+#include <stdint.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/base/Array.h"
+#include "ola/testing/TestUtils.h"
+#include "tools/logic/MultiChannelDMXDecoder.h"
+
+using std::vector;
+
+namespace {
+// One sample per microsecond, so each bit is 4 samples.
+const unsigned int SAMPLE_RATE = 1000000;
+const unsigned int BIT_TIME = 4;
+
+/*
+ * Append a run of samples on channel 0.
+ */
+void AddRun(vector<uint8_t> *samples, bool level, unsigned int micro_seconds) {
+  samples->insert(samples->end(), micro_seconds, level ? 1 : 0);
+}
+
+/*
+ * Append a slot, with two stop bits.
+ */
+void AddSlot(vector<uint8_t> *samples, uint8_t value) {
+  AddRun(samples, false, BIT_TIME);
+  for (unsigned int i = 0; i < 8; i++) {
+    AddRun(samples, value & (1 << i), BIT_TIME);
+  }
+  AddRun(samples, true, 2 * BIT_TIME);
+}
+
+/*
+ * Append a break, mark after break and the slots.
+ */
+void AddFrame(vector<uint8_t> *samples, const uint8_t *slots,
+              unsigned int size) {
+  AddRun(samples, false, 100);
+  AddRun(samples, true, 12);
+  for (unsigned int i = 0; i < size; i++) {
+    AddSlot(samples, slots[i]);
+  }
+}
+}  // namespace
+
+
+class MultiChannelDMXDecoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(MultiChannelDMXDecoderTest);
+  CPPUNIT_TEST(testFrames);
+  CPPUNIT_TEST(testLongMark);
+  CPPUNIT_TEST(testFlush);
+  CPPUNIT_TEST(testMultipleChannels);
+  CPPUNIT_TEST(testFramingError);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() {
+    m_channels.clear();
+    m_frames.clear();
+  }
+
+  void testFrames();
+  void testLongMark();
+  void testFlush();
+  void testMultipleChannels();
+  void testFramingError();
+
+ private:
+  vector<unsigned int> m_channels;
+  vector<vector<uint8_t> > m_frames;
+
+  MultiChannelDMXDecoder *NewDecoder(uint8_t channel_mask = 0xff) {
+    return new MultiChannelDMXDecoder(
+        ola::NewCallback(this, &MultiChannelDMXDecoderTest::FrameReceived),
+        SAMPLE_RATE, channel_mask);
+  }
+
+  void FrameReceived(unsigned int channel, const uint8_t *data,
+                     unsigned int size) {
+    m_channels.push_back(channel);
+    m_frames.push_back(vector<uint8_t>(data, data + size));
+  }
+
+  /*
+   * Pass the samples to the decoder in small chunks, so runs span more than
+   * one call to Process().
+   */
+  void Decode(MultiChannelDMXDecoder *decoder,
+              const vector<uint8_t> &samples) {
+    const unsigned int CHUNK_SIZE = 13;
+    for (unsigned int i = 0; i < samples.size(); i += CHUNK_SIZE) {
+      decoder->Process(
+          &samples[i],
+          std::min(CHUNK_SIZE, static_cast<unsigned int>(samples.size() - i)));
+    }
+  }
+
+  void CheckFrame(unsigned int index, unsigned int channel,
+                  const uint8_t *data, unsigned int size) {
+    OLA_ASSERT_LT(index, static_cast<unsigned int>(m_frames.size()));
+    OLA_ASSERT_EQ(channel, m_channels[index]);
+    OLA_ASSERT_DATA_EQUALS(data, size, &m_frames[index][0],
+                           m_frames[index].size());
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MultiChannelDMXDecoderTest);
+
+
+/*
+ * Check frames are delivered when the next break is seen.
+ */
+void MultiChannelDMXDecoderTest::testFrames() {
+  const uint8_t frame1[] = {0xcc, 0x01, 0x80, 0x12};
+  const uint8_t frame2[] = {0x00, 0xff};
+  vector<uint8_t> samples;
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame1, arraysize(frame1));
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame2, arraysize(frame2));
+  AddRun(&samples, false, 100);
+  AddRun(&samples, true, 20);
+
+  std::auto_ptr<MultiChannelDMXDecoder> decoder(NewDecoder());
+  Decode(decoder.get(), samples);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  CheckFrame(0, 0, frame1, arraysize(frame1));
+  CheckFrame(1, 0, frame2, arraysize(frame2));
+  OLA_ASSERT_EQ(0u, decoder->FramingErrors(0));
+}
+
+
+/*
+ * Check the last slot isn't lost if the line idles for longer than the
+ * maximum mark time.
+ */
+void MultiChannelDMXDecoderTest::testLongMark() {
+  const uint8_t frame1[] = {0xcc, 0x01, 0x80, 0x12};
+  const uint8_t frame2[] = {0x00, 0xff};
+  vector<uint8_t> samples;
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame1, arraysize(frame1));
+  AddRun(&samples, true, 1500000);
+  AddFrame(&samples, frame2, arraysize(frame2));
+  AddRun(&samples, true, 1500000);
+  AddRun(&samples, false, 100);
+  AddRun(&samples, true, 20);
+
+  std::auto_ptr<MultiChannelDMXDecoder> decoder(NewDecoder());
+  Decode(decoder.get(), samples);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  CheckFrame(0, 0, frame1, arraysize(frame1));
+  CheckFrame(1, 0, frame2, arraysize(frame2));
+}
+
+
+/*
+ * Check Flush() delivers the frame in progress, including the last slot.
+ */
+void MultiChannelDMXDecoderTest::testFlush() {
+  const uint8_t frame[] = {0xcc};
+  vector<uint8_t> samples;
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame, arraysize(frame));
+  AddRun(&samples, true, 20);
+
+  std::auto_ptr<MultiChannelDMXDecoder> decoder(NewDecoder());
+  Decode(decoder.get(), samples);
+  OLA_ASSERT_TRUE(m_frames.empty());
+  decoder->Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  CheckFrame(0, 0, frame, arraysize(frame));
+
+  // The stop bit of 0xff runs into the mark, and the capture ends before
+  // the second stop bit.
+  const uint8_t frame2[] = {0x01, 0xff};
+  samples.clear();
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame2, arraysize(frame2));
+  samples.resize(samples.size() - BIT_TIME);
+  Decode(decoder.get(), samples);
+  decoder->Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  CheckFrame(1, 0, frame2, arraysize(frame2));
+
+  // A partial slot is dropped.
+  const uint8_t frame3[] = {0x02, 0x00};
+  samples.clear();
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame3, arraysize(frame3));
+  samples.resize(samples.size() - 4 * BIT_TIME);
+  Decode(decoder.get(), samples);
+  decoder->Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  CheckFrame(2, 0, frame3, 1);
+  OLA_ASSERT_EQ(0u, decoder->FramingErrors(0));
+}
+
+
+/*
+ * Check channels are decoded independently.
+ */
+void MultiChannelDMXDecoderTest::testMultipleChannels() {
+  const uint8_t frame1[] = {0xcc, 0x01, 0x80, 0x12};
+  const uint8_t frame2[] = {0x00, 0x01, 0x02};
+  vector<uint8_t> channel0, channel1;
+  AddRun(&channel0, true, 20);
+  AddFrame(&channel0, frame1, arraysize(frame1));
+  AddRun(&channel1, true, 33);
+  AddFrame(&channel1, frame2, arraysize(frame2));
+
+  // Pad both channels with a mark, then combine them.
+  const size_t size = std::max(channel0.size(), channel1.size()) + 20;
+  channel0.resize(size, 1);
+  channel1.resize(size, 1);
+  vector<uint8_t> samples(size);
+  for (unsigned int i = 0; i < size; i++) {
+    samples[i] = channel0[i] | (channel1[i] << 1);
+  }
+
+  std::auto_ptr<MultiChannelDMXDecoder> decoder(NewDecoder());
+  Decode(decoder.get(), samples);
+  decoder->Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  CheckFrame(0, 0, frame1, arraysize(frame1));
+  CheckFrame(1, 1, frame2, arraysize(frame2));
+
+  // Channels outside the mask are ignored.
+  setUp();
+  decoder.reset(NewDecoder(0x02));
+  Decode(decoder.get(), samples);
+  decoder->Flush();
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  CheckFrame(0, 1, frame2, arraysize(frame2));
+}
+
+
+/*
+ * Check a low that's too long for a slot, but too short for a break, is a
+ * framing error.
+ */
+void MultiChannelDMXDecoderTest::testFramingError() {
+  const uint8_t frame[] = {0xcc, 0x01};
+  vector<uint8_t> samples;
+  AddRun(&samples, true, 20);
+  AddFrame(&samples, frame, arraysize(frame));
+  AddRun(&samples, false, 50);
+  AddRun(&samples, true, 20);
+
+  std::auto_ptr<MultiChannelDMXDecoder> decoder(NewDecoder());
+  Decode(decoder.get(), samples);
+  decoder->Flush();
+  OLA_ASSERT_TRUE(m_frames.empty());
+  OLA_ASSERT_EQ(1u, decoder->FramingErrors(0));
+}
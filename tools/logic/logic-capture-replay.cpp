@@ -0,0 +1,322 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * logic-capture-replay.cpp
+ * Decode a raw logic analyzer capture, so the decoders can be tested and
+ * benchmarked without a device.
+ * Copyright (C) 2026 agent
+ *
+ * The capture file contains one byte per sample, with bit N holding the level
+ * of channel N. This is the format the Saleae SDK delivers data in.
+ */
+
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/StringUtils.h>
+#include <ola/rdm/RDMCommand.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tools/logic/DMXSignalProcessor.h"
+#include "tools/logic/MultiChannelDMXDecoder.h"
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_uint32(sample_rate, 4000000, "Sample rate in HZ.");
+DEFINE_uint8(channel_mask, 0xff, "A bit mask of the channels to decode.");
+DEFINE_uint32(chunk_size, 1 << 16,
+              "The number of samples to pass to the decoder at once.");
+DEFINE_s_uint32(iterations, i, 1, "The number of times to decode the capture.");
+DEFINE_default_bool(legacy, false,
+                    "Use the per-sample DMXSignalProcessor, for comparison.");
+DEFINE_s_default_bool(display_frames, d, false, "Display each frame.");
+DEFINE_default_bool(generate, false,
+                    "Write a synthetic capture to the file rather than "
+                    "decoding it.");
+DEFINE_uint32(frames, 100,
+              "The number of frames per channel in a synthetic capture.");
+
+/**
+ * Count and optionally display the frames from the decoders.
+ */
+class FrameCounter {
+ public:
+    FrameCounter()
+        : m_dmx_frames(MultiChannelDMXDecoder::MAX_CHANNELS, 0),
+          m_rdm_frames(MultiChannelDMXDecoder::MAX_CHANNELS, 0),
+          m_other_frames(MultiChannelDMXDecoder::MAX_CHANNELS, 0) {
+    }
+
+    void FrameReceived(unsigned int channel, const uint8_t *data,
+                       unsigned int length) {
+      string type = "SC";
+      if (data[0] == 0) {
+        m_dmx_frames[channel]++;
+        type = "DMX";
+      } else if (data[0] == ola::rdm::RDMCommand::START_CODE) {
+        m_rdm_frames[channel]++;
+        type = "RDM";
+      } else {
+        m_other_frames[channel]++;
+      }
+
+      if (FLAGS_display_frames) {
+        cout << channel << " " << type << " ";
+        if (m_other_frames[channel] && type == "SC") {
+          cout << ola::strings::ToHex(static_cast<int>(data[0])) << " ";
+        }
+        cout << std::dec << length - 1 << ":" << std::hex;
+        for (unsigned int i = 1; i < length; i++) {
+          cout << " " << std::setw(2) << std::setfill('0')
+               << static_cast<int>(data[i]);
+        }
+        cout << std::dec << endl;
+      }
+    }
+
+    void LegacyFrameReceived(unsigned int channel, const uint8_t *data,
+                             unsigned int length) {
+      if (length) {
+        FrameReceived(channel, data, length);
+      }
+    }
+
+    void Print(uint8_t channel_mask) const {
+      for (unsigned int i = 0; i < MultiChannelDMXDecoder::MAX_CHANNELS; i++) {
+        if (channel_mask & (1 << i)) {
+          cout << "Channel " << i << ": " << m_dmx_frames[i] << " DMX, "
+               << m_rdm_frames[i] << " RDM, " << m_other_frames[i]
+               << " other frames" << endl;
+        }
+      }
+    }
+
+ private:
+    vector<unsigned int> m_dmx_frames;
+    vector<unsigned int> m_rdm_frames;
+    vector<unsigned int> m_other_frames;
+};
+
+
+/**
+ * Draw the signal for one channel into a capture.
+ */
+class SignalGenerator {
+ public:
+    SignalGenerator(vector<uint8_t> *samples, unsigned int channel,
+                    unsigned int sample_rate)
+        : m_samples(samples),
+          m_mask(1 << channel),
+          m_sample_rate(sample_rate),
+          m_offset(0) {
+    }
+
+    void Level(bool level, unsigned int ticks) {
+      if (m_samples->size() < m_offset + ticks) {
+        // Channels idle high.
+        m_samples->resize(m_offset + ticks, 0xff);
+      }
+      if (!level) {
+        for (unsigned int i = 0; i < ticks; i++) {
+          (*m_samples)[m_offset + i] &= ~m_mask;
+        }
+      }
+      m_offset += ticks;
+    }
+
+    void Mark(unsigned int micro_seconds) {
+      Level(true, Ticks(micro_seconds));
+    }
+
+    void Frame(const vector<uint8_t> &frame, unsigned int break_time,
+               unsigned int mark_between_slots) {
+      Level(false, Ticks(break_time));
+      Mark(12);
+      const unsigned int bit = m_sample_rate / BITRATE;
+      vector<uint8_t>::const_iterator iter = frame.begin();
+      for (; iter != frame.end(); ++iter) {
+        Level(false, bit);
+        for (unsigned int i = 0; i < 8; i++) {
+          Level(*iter & (1 << i), bit);
+        }
+        Level(true, 2 * bit);
+        Level(true, Ticks(mark_between_slots));
+      }
+    }
+
+ private:
+    vector<uint8_t> *m_samples;
+    const uint8_t m_mask;
+    const unsigned int m_sample_rate;
+    unsigned int m_offset;
+
+    static const unsigned int BITRATE = 250000;
+
+    unsigned int Ticks(unsigned int micro_seconds) const {
+      return static_cast<uint64_t>(micro_seconds) * m_sample_rate / 1000000;
+    }
+};
+
+
+/**
+ * Write a capture with DMX and RDM traffic on each channel.
+ */
+int Generate(const string &filename) {
+  vector<uint8_t> samples;
+  for (unsigned int channel = 0; channel < MultiChannelDMXDecoder::MAX_CHANNELS;
+       channel++) {
+    if (!(FLAGS_channel_mask & (1 << channel))) {
+      continue;
+    }
+    SignalGenerator generator(&samples, channel, FLAGS_sample_rate);
+    // Stagger the channels so the edges don't line up.
+    generator.Mark(10 + 7 * channel);
+    for (unsigned int i = 0; i < FLAGS_frames; i++) {
+      vector<uint8_t> frame;
+      if (i % 4 == 3) {
+        // Something that looks like an RDM request.
+        frame.push_back(
+            static_cast<uint8_t>(ola::rdm::RDMCommand::START_CODE));
+        frame.push_back(0x01);
+        for (unsigned int j = 0; j < 24; j++) {
+          frame.push_back(i + j);
+        }
+      } else {
+        frame.push_back(0);
+        const unsigned int slots = 24 + (channel * 61 + i * 13) % 489;
+        for (unsigned int j = 0; j < slots; j++) {
+          frame.push_back(rand() % 256);  // NOLINT(runtime/threadsafe_fn)
+        }
+      }
+      generator.Frame(frame, 88 + (i + channel) % 100, (i + channel) % 3 * 4);
+      generator.Mark(20 + i % 50);
+    }
+  }
+
+  std::ofstream output(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!output.is_open()) {
+    OLA_FATAL << "Can't open " << filename;
+    return ola::EXIT_CANTCREAT;
+  }
+  output.write(reinterpret_cast<const char*>(&samples[0]), samples.size());
+  cout << "Wrote " << samples.size() << " samples to " << filename << endl;
+  return ola::EXIT_OK;
+}
+
+
+/**
+ * Decode a capture, once per iteration.
+ */
+int Replay(const string &filename) {
+  std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    OLA_FATAL << "Can't open " << filename;
+    return ola::EXIT_NOINPUT;
+  }
+  vector<uint8_t> samples((std::istreambuf_iterator<char>(input)),
+                          std::istreambuf_iterator<char>());
+  if (samples.empty()) {
+    OLA_FATAL << filename << " is empty";
+    return ola::EXIT_DATAERR;
+  }
+
+  const unsigned int chunk_size = std::max(static_cast<unsigned int>(FLAGS_chunk_size), 1u);
+  FrameCounter counter;
+  ola::Clock clock;
+  ola::TimeStamp start, end;
+  clock.CurrentTime(&start);
+
+  for (unsigned int iteration = 0; iteration < FLAGS_iterations; iteration++) {
+    if (FLAGS_legacy) {
+      // One decoder per channel, each of which looks at every sample.
+      for (unsigned int channel = 0;
+           channel < MultiChannelDMXDecoder::MAX_CHANNELS; channel++) {
+        if (!(FLAGS_channel_mask & (1 << channel))) {
+          continue;
+        }
+        DMXSignalProcessor processor(
+            ola::NewCallback(&counter, &FrameCounter::LegacyFrameReceived,
+                             channel),
+            FLAGS_sample_rate);
+        for (unsigned int i = 0; i < samples.size(); i += chunk_size) {
+          processor.Process(
+              &samples[i],
+              std::min(chunk_size, static_cast<unsigned int>(samples.size() - i)),
+              1 << channel);
+        }
+      }
+    } else {
+      MultiChannelDMXDecoder decoder(
+          ola::NewCallback(&counter, &FrameCounter::FrameReceived),
+          FLAGS_sample_rate, FLAGS_channel_mask);
+      for (unsigned int i = 0; i < samples.size(); i += chunk_size) {
+        decoder.Process(
+            &samples[i],
+            std::min(chunk_size, static_cast<unsigned int>(samples.size() - i)));
+      }
+      decoder.Flush();
+    }
+  }
+
+  clock.CurrentTime(&end);
+  const int64_t elapsed = std::max((end - start).AsInt(),
+                                   static_cast<int64_t>(1));
+  const uint64_t total = static_cast<uint64_t>(samples.size()) *
+                         FLAGS_iterations;
+  counter.Print(FLAGS_channel_mask);
+  cout << "Decoded " << total << " samples in " << elapsed / 1000 << "ms, "
+       << total / elapsed << "M samples/s, "
+       << (total * 1000000 / FLAGS_sample_rate) / elapsed
+       << "x real time" << endl;
+  return ola::EXIT_OK;
+}
+
+
+/*
+ * Main.
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[ options ] <capture_file>",
+               "Decode DMX/RDM data from a raw logic analyzer capture.");
+
+  if (argc != 2) {
+    ola::DisplayUsageAndExit();
+  }
+
+  if (FLAGS_sample_rate < 1000000) {
+    OLA_FATAL << "The sample rate must be at least 1MHz";
+    exit(ola::EXIT_USAGE);
+  }
+
+  if (FLAGS_generate) {
+    return Generate(argv[1]);
+  }
+  return Replay(argv[1]);
+}
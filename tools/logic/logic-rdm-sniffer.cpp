@@ -55,7 +55,7 @@
 #include <vector>
 #include <queue>
 
-#include "tools/logic/DMXSignalProcessor.h"
+#include "tools/logic/MultiChannelDMXDecoder.h"
 
 using std::auto_ptr;
 using std::cerr;
@@ -87,6 +87,7 @@ DEFINE_s_default_bool(display_dmx, d, false,
 DEFINE_uint16(dmx_slot_limit, ola::DMX_UNIVERSE_SIZE,
               "Only display the first N slots of DMX data.");
 DEFINE_uint32(sample_rate, 4000000, "Sample rate in HZ.");
+DEFINE_uint8(channel_mask, 0x01, "A bit mask of the channels to decode.");
 DEFINE_string(pid_location, "",
               "The directory containing the PID definitions.");
 
@@ -102,8 +103,10 @@ class LogicReader {
         m_device_id(0),
         m_logic(NULL),
         m_ss(ss),
-        m_signal_processor(ola::NewCallback(this, &LogicReader::FrameReceived),
-                           sample_rate),
+        m_decoder(ola::NewCallback(this, &LogicReader::FrameReceived),
+                  sample_rate, FLAGS_channel_mask),
+        m_multiple_channels(FLAGS_channel_mask & (FLAGS_channel_mask - 1)),
+        m_frame_channel(0),
         m_pid_helper(FLAGS_pid_location.str(), 4),
         m_command_printer(&cout, &m_pid_helper) {
       m_pid_helper.Init();
@@ -113,7 +116,8 @@ class LogicReader {
     void DeviceConnected(U64 device, GenericInterface *interface);
     void DeviceDisconnected(U64 device);
     void DataReceived(U64 device, U8 *data, uint32_t data_length);
-    void FrameReceived(const uint8_t *data, unsigned int length);
+    void FrameReceived(unsigned int channel, const uint8_t *data,
+                       unsigned int length);
 
     void Stop();
 
@@ -128,7 +132,9 @@ class LogicReader {
     LogicInterface *m_logic;  // GUARDED_BY(mu_);
     mutable Mutex m_mu;
     SelectServer *m_ss;
-    DMXSignalProcessor m_signal_processor;
+    MultiChannelDMXDecoder m_decoder;
+    const bool m_multiple_channels;
+    unsigned int m_frame_channel;
     PidStoreHelper m_pid_helper;
     CommandPrinter m_command_printer;
     Mutex m_data_mu;
@@ -139,6 +145,7 @@ class LogicReader {
     void DisplayRDMFrame(const uint8_t *data, unsigned int length);
     void DisplayAlternateFrame(const uint8_t *data, unsigned int length);
     void DisplayRawData(const uint8_t *data, unsigned int length);
+    void DisplayChannel();
 };
 
 LogicReader::~LogicReader() {
@@ -215,10 +222,12 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
 }
 
 
-void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
+void LogicReader::FrameReceived(unsigned int channel, const uint8_t *data,
+                                unsigned int length) {
   if (!length) {
     return;
   }
+  m_frame_channel = channel;
 
   switch (data[0]) {
     case 0:
@@ -250,7 +259,7 @@ void LogicReader::Stop() {
  * @param data_length the size of the data
  */
 void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
-  m_signal_processor.Process(data, data_length, 0x01);
+  m_decoder.Process(data, data_length);
   DevicesManagerInterface::DeleteU8ArrayPtr(data);
 
   /*
@@ -270,12 +279,14 @@ void LogicReader::DisplayDMXFrame(const uint8_t *data, unsigned int length) {
   if (!FLAGS_display_dmx)
     return;
 
+  DisplayChannel();
   cout << "DMX " << std::dec;
   cout << length << ":" << std::hex;
   DisplayRawData(data, length);
 }
 
 void LogicReader::DisplayRDMFrame(const uint8_t *data, unsigned int length) {
+  DisplayChannel();
   auto_ptr<RDMCommand> command(RDMCommand::Inflate(data, length));
   if (command.get()) {
     if (FLAGS_full_rdm) {
@@ -293,6 +304,7 @@ void LogicReader::DisplayAlternateFrame(const uint8_t *data,
   if (!FLAGS_display_asc || length == 0)
     return;
 
+  DisplayChannel();
   unsigned int slot_count = length - 1;
   cout << "SC " << ToHex(static_cast<int>(data[0]))
        << " " << slot_count << ":";
@@ -310,6 +322,16 @@ void LogicReader::DisplayRawData(const uint8_t *data, unsigned int length) {
   cout << endl;
 }
 
+/**
+ * If we're decoding more than one channel, display the channel the frame was
+ * received on.
+ */
+void LogicReader::DisplayChannel() {
+  if (m_multiple_channels) {
+    cout << std::dec << "Channel " << m_frame_channel << ": ";
+  }
+}
+
 // SaleaeDeviceApi callbacks
 void OnConnect(U64 device_id, GenericInterface* device_interface,
                void* user_data) {
@@ -17,9 +17,17 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <ola/Logging.h>
+#include <signal.h>
 #include <string.h>
 #include <unistd.h>
+#ifdef HAVE_SPAWN_H
+#include <spawn.h>
+#endif  // HAVE_SPAWN_H
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -37,6 +45,18 @@
 using std::string;
 using std::vector;
 
+#ifdef HAVE_SPAWN_H
+extern char **environ;
+#endif  // HAVE_SPAWN_H
+
+namespace {
+// Each counter has a single writer, so the number of running commands can be
+// computed without locking against the signal handler.
+unsigned int max_running_commands = 0;
+volatile sig_atomic_t commands_started = 0;
+volatile sig_atomic_t commands_exited = 0;
+}  // namespace
+
 
 /**
  * @brief Assign the value to the variable.
@@ -61,7 +81,20 @@ void VariableAssignmentAction::Execute(Context *context, uint8_t) {
  * @brief Execute the command
  */
 void CommandAction::Execute(Context *context, uint8_t) {
+#ifndef _WIN32
+  if (max_running_commands &&
+      static_cast<unsigned int>(commands_started - commands_exited) >=
+        max_running_commands) {
+    OLA_WARN << "Too many commands running, skipping " << m_command;
+    return;
+  }
+#endif  // _WIN32
+
   char **args = BuildArgList(context);
+  if (!args) {
+    OLA_WARN << "Failed to expand the arguments for " << m_command;
+    return;
+  }
 
   if (ola::LogLevel() >= ola::OLA_LOG_INFO) {
     std::ostringstream str;
@@ -121,6 +154,19 @@ void CommandAction::Execute(Context *context, uint8_t) {
   }
 
   free(cmd_line);
+#elif defined(HAVE_SPAWN_H)
+  // posix_spawn avoids copying our page tables, which makes it much cheaper
+  // than fork() when commands are run at a high rate.
+  pid_t pid;
+  int error = posix_spawnp(&pid, m_command.c_str(), NULL, NULL, args,
+                           environ);
+  if (error) {
+    OLA_WARN << "Could not run " << m_command << ": " << strerror(error);
+  } else {
+    commands_started = commands_started + 1;
+    OLA_DEBUG << "Child for " << m_command << " is " << pid;
+  }
+  FreeArgList(args);
 #else
   pid_t pid;
   if ((pid = fork()) < 0) {
@@ -129,6 +175,7 @@ void CommandAction::Execute(Context *context, uint8_t) {
     return;
   } else if (pid) {
     // parent
+    commands_started = commands_started + 1;
     OLA_DEBUG << "Child for " << m_command << " is " << pid;
     FreeArgList(args);
     return;
@@ -139,6 +186,16 @@ void CommandAction::Execute(Context *context, uint8_t) {
 }
 
 
+void CommandAction::SetMaxRunningCommands(unsigned int limit) {
+  max_running_commands = limit;
+}
+
+
+void CommandAction::CommandExited() {
+  commands_exited = commands_exited + 1;
+}
+
+
 /**
  * Interpolate all the arguments, and return a pointer to an array of char*
  * pointers which can be passed to exec()
@@ -92,6 +92,22 @@ class CommandAction: public Action {
 
   virtual void Execute(Context *context, uint8_t slot_value);
 
+  /**
+   * @brief Limit the number of commands that can run at once.
+   * @param limit the maximum number of running commands, 0 means no limit.
+   *
+   * Commands that would exceed the limit are skipped.
+   */
+  static void SetMaxRunningCommands(unsigned int limit);
+
+  /**
+   * @brief Record that a command has exited.
+   *
+   * This is async signal safe, and should be called from the SIGCHLD handler
+   * for each child that is reaped.
+   */
+  static void CommandExited();
+
  protected:
   const std::string m_command;
   std::vector<std::string> m_arguments;
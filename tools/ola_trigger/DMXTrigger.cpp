@@ -17,8 +17,10 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <string.h>
 #include <algorithm>
 #include <vector>
 
@@ -33,22 +35,62 @@ using ola::DmxBuffer;
 DMXTrigger::DMXTrigger(Context *context,
                        const SlotVector &actions)
     : m_context(context),
-      m_slots(actions) {
-  sort(m_slots.begin(), m_slots.end());
+      m_slots(ola::DMX_UNIVERSE_SIZE, NULL),
+      m_last_size(0) {
+  SlotVector::const_iterator iter = actions.begin();
+  for (; iter != actions.end(); ++iter) {
+    uint16_t slot_number = (*iter)->SlotOffset();
+    if (slot_number >= ola::DMX_UNIVERSE_SIZE) {
+      OLA_WARN << "Slot " << slot_number << " is out of range";
+      continue;
+    }
+    m_slots[slot_number] = *iter;
+  }
 }
 
 
 /**
  * @brief Called when new DMX arrives.
+ *
+ * Only the slots which differ from the last frame are checked.
  */
-void DMXTrigger::NewDMX(const DmxBuffer &data) {
-  SlotVector::iterator iter = m_slots.begin();
-  for (; iter != m_slots.end(); iter++) {
-    uint16_t slot_number = (*iter)->SlotOffset();
-    if (slot_number >= data.Size()) {
-      // the DMX frame was too small
-      break;
+void DMXTrigger::NewDMX(const DmxBuffer &buffer) {
+  const uint8_t *data = buffer.GetRaw();
+  const unsigned int size = buffer.Size();
+  const unsigned int common_size = std::min(size, m_last_size);
+
+  // Compare a word at a time, usually only a few slots change between frames.
+  unsigned int i = 0;
+  for (; i + sizeof(uint64_t) <= common_size; i += sizeof(uint64_t)) {
+    uint64_t new_word, old_word;
+    memcpy(&new_word, data + i, sizeof(new_word));
+    memcpy(&old_word, m_last_frame + i, sizeof(old_word));
+    if (new_word != old_word) {
+      CheckSlots(data, i, i + sizeof(uint64_t));
+    }
+  }
+  CheckSlots(data, i, common_size);
+
+  // Anything past the end of the last frame hasn't been seen yet.
+  for (i = common_size; i < size; i++) {
+    if (m_slots[i]) {
+      m_slots[i]->TakeAction(m_context, data[i]);
+    }
+  }
+
+  memcpy(m_last_frame, data, size);
+  m_last_size = size;
+}
+
+
+/**
+ * @brief Run the actions for slots in the range [start, end) that changed.
+ */
+void DMXTrigger::CheckSlots(const uint8_t *data, unsigned int start,
+                            unsigned int end) {
+  for (unsigned int i = start; i < end; i++) {
+    if (data[i] != m_last_frame[i] && m_slots[i]) {
+      m_slots[i]->TakeAction(m_context, data[i]);
     }
-    (*iter)->TakeAction(m_context, data.Get(slot_number));
   }
 }
@@ -21,13 +21,15 @@
 #ifndef TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
 #define TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
 
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
 
-/*
- * @brief The class which manages the triggering.
+/**
+ * @brief Run the actions for the slots that changed in each DMX frame.
  */
 class DMXTrigger {
  public:
@@ -40,6 +42,10 @@ class DMXTrigger {
 
  private:
   Context *m_context;
-  SlotVector m_slots;  // kept sorted
+  SlotVector m_slots;  // indexed by slot offset, NULL if there isn't a Slot
+  uint8_t m_last_frame[ola::DMX_UNIVERSE_SIZE];
+  unsigned int m_last_size;
+
+  void CheckSlots(const uint8_t *data, unsigned int start, unsigned int end);
 };
 #endif  // TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
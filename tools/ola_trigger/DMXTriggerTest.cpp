@@ -21,6 +21,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <ola/Logging.h>
 #include <ola/DmxBuffer.h>
+#include <ola/stl/STLUtils.h>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
@@ -37,11 +38,13 @@ class DMXTriggerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DMXTriggerTest);
   CPPUNIT_TEST(testRisingEdgeTrigger);
   CPPUNIT_TEST(testFallingEdgeTrigger);
+  CPPUNIT_TEST(testMultipleSlots);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testRisingEdgeTrigger();
   void testFallingEdgeTrigger();
+  void testMultipleSlots();
 
   void setUp() {
     ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -159,3 +162,74 @@ void DMXTriggerTest::testFallingEdgeTrigger() {
   rising_action->CheckForValue(OLA_SOURCELINE(), 20);
   OLA_ASSERT(falling_action->NoCalls());
 }
+
+
+/**
+ * Check that only the slots which changed are triggered, regardless of where
+ * they are in the frame.
+ */
+void DMXTriggerTest::testMultipleSlots() {
+  // Slots on either side of a word boundary, and the last slot. They're
+  // deliberately not in order.
+  const uint16_t offsets[] = {511, 8, 0, 7, 20};
+  const unsigned int slot_count = sizeof(offsets) / sizeof(offsets[0]);
+
+  vector<Slot*> slots;
+  vector<MockAction*> actions;
+  for (unsigned int i = 0; i < slot_count; i++) {
+    Slot *slot = new Slot(offsets[i]);
+    MockAction *action = new MockAction();
+    slot->SetDefaultRisingAction(action);
+    slot->SetDefaultFallingAction(action);
+    slots.push_back(slot);
+    actions.push_back(action);
+  }
+
+  Context context;
+  DMXTrigger trigger(&context, slots);
+
+  // The first frame runs the actions for all slots within the frame.
+  DmxBuffer buffer;
+  buffer.Blackout();
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    actions[i]->CheckForValue(OLA_SOURCELINE(), 0);
+  }
+
+  // change slots with and without actions
+  buffer.SetChannel(7, 100);
+  buffer.SetChannel(9, 50);
+  buffer.SetChannel(511, 255);
+  trigger.NewDMX(buffer);
+  actions[3]->CheckForValue(OLA_SOURCELINE(), 100);
+  actions[0]->CheckForValue(OLA_SOURCELINE(), 255);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  // a frame that differs only in slots without actions
+  buffer.SetChannel(9, 60);
+  buffer.SetChannel(300, 1);
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  // shorten the frame, then change slot 20 while it's out of range
+  DmxBuffer short_buffer(buffer.GetRaw(), 10);
+  trigger.NewDMX(short_buffer);
+  buffer.SetChannel(20, 5);
+  trigger.NewDMX(short_buffer);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  // the change is picked up when the frame is lengthened again
+  trigger.NewDMX(buffer);
+  actions[4]->CheckForValue(OLA_SOURCELINE(), 5);
+  for (unsigned int i = 0; i < slot_count; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  ola::STLDeleteElements(&slots);
+}
@@ -57,6 +57,9 @@ DEFINE_s_uint16(offset, o, 0,
                 "Apply an offset to the slot numbers. Valid offsets are 0 to "
                 "512, default is 0.");
 DEFINE_s_uint32(universe, u, 0, "The universe to use, defaults to 0.");
+DEFINE_uint32(max_commands, 0,
+              "The maximum number of commands that can run at once, 0 means "
+              "no limit. Commands over the limit are skipped.");
 DEFINE_default_bool(validate, false,
                     "Validate the config file, rather than running it.");
 
@@ -81,6 +84,9 @@ static void CatchSIGCHLD(OLA_UNUSED int signo) {
   int old_errno = errno;
   do {
     pid = waitpid(-1, NULL, WNOHANG);
+    if (pid > 0) {
+      CommandAction::CommandExited();
+    }
   } while (pid > 0);
   errno = old_errno;
 }
@@ -218,6 +224,7 @@ int main(int argc, char *argv[]) {
 
   ss = wrapper.GetSelectServer();
 
+  CommandAction::SetMaxRunningCommands(FLAGS_max_commands);
   if (!InstallSignals()) {
     exit(ola::EXIT_OSERR);
   }